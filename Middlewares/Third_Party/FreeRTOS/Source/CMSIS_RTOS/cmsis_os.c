@@ -507,12 +507,12 @@ int32_t osSignalSet (osThreadId thread_id, int32_t signal)
   
   if (inHandlerMode())
   {
-    if(xTaskGenericNotifyFromISR( thread_id , (uint32_t)signal, eSetBits, &ulPreviousNotificationValue, &xHigherPriorityTaskWoken ) != pdPASS )
+    if(xTaskGenericNotifyFromISR( thread_id , tskDEFAULT_INDEX_TO_NOTIFY, (uint32_t)signal, eSetBits, &ulPreviousNotificationValue, &xHigherPriorityTaskWoken ) != pdPASS )
       return 0x80000000;
     
     portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
   }  
-  else if(xTaskGenericNotify( thread_id , (uint32_t)signal, eSetBits, &ulPreviousNotificationValue) != pdPASS )
+  else if(xTaskGenericNotify( thread_id , tskDEFAULT_INDEX_TO_NOTIFY, (uint32_t)signal, eSetBits, &ulPreviousNotificationValue) != pdPASS )
     return 0x80000000;
   
   return ulPreviousNotificationValue;
@@ -860,17 +860,18 @@ osStatus osSemaphoreDelete (osSemaphoreId semaphore_id)
 
 #if (defined (osFeature_Pool)  &&  (osFeature_Pool != 0)) 
 
-//TODO
-//This is a primitive and inefficient wrapper around the existing FreeRTOS memory management.
-//A better implementation will have to modify heap_x.c!
-
-
+/* Each pool is a single array of equally sized blocks.  The free blocks are
+kept on a singly linked list that is threaded through the blocks themselves,
+so allocating and freeing a block only pops or pushes the head of the list and
+takes the same time whatever the size of the pool.  The markers record which
+blocks are allocated so that a block that is freed twice is rejected instead of
+being linked into the free list a second time. */
 typedef struct os_pool_cb {
   void *pool;
   uint8_t *markers;
+  void *freeList;
   uint32_t pool_sz;
   uint32_t item_sz;
-  uint32_t currentIndex;
 } os_pool_cb_t;
 
 
@@ -884,29 +885,42 @@ osPoolId osPoolCreate (const osPoolDef_t *pool_def)
 {
 #if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
   osPoolId thePool;
-  int itemSize = 4 * ((pool_def->item_sz + 3) / 4);
+  /* Each free block holds the link to the next free block, so blocks are
+  rounded up to a whole number of pointers. */
+  uint32_t itemSize = sizeof(void *) * ((pool_def->item_sz + sizeof(void *) - 1) / sizeof(void *));
+  uint8_t *block;
   uint32_t i;
   
+  if ((pool_def->pool_sz == 0) || (itemSize == 0)) {
+    return NULL;
+  }
+  
   /* First have to allocate memory for the pool control block. */
- thePool = pvPortMalloc(sizeof(os_pool_cb_t));
-
+  thePool = pvPortMalloc(sizeof(os_pool_cb_t));
   
   if (thePool) {
     thePool->pool_sz = pool_def->pool_sz;
     thePool->item_sz = itemSize;
-    thePool->currentIndex = 0;
     
     /* Memory for markers */
     thePool->markers = pvPortMalloc(pool_def->pool_sz);
-   
+    
     if (thePool->markers) {
       /* Now allocate the pool itself. */
-     thePool->pool = pvPortMalloc(pool_def->pool_sz * itemSize);
+      thePool->pool = pvPortMalloc(pool_def->pool_sz * itemSize);
       
       if (thePool->pool) {
-        for (i = 0; i < pool_def->pool_sz; i++) {
+        /* Link every block into the free list in address order, so the
+        blocks are handed out from the start of the pool. */
+        block = (uint8_t *)thePool->pool;
+        for (i = 0; i < pool_def->pool_sz - 1; i++) {
           thePool->markers[i] = 0;
+          *(void **)block = block + itemSize;
+          block += itemSize;
         }
+        thePool->markers[i] = 0;
+        *(void **)block = NULL;
+        thePool->freeList = thePool->pool;
       }
       else {
         vPortFree(thePool->markers);
@@ -936,9 +950,11 @@ osPoolId osPoolCreate (const osPoolDef_t *pool_def)
 void *osPoolAlloc (osPoolId pool_id)
 {
   int dummy = 0;
-  void *p = NULL;
-  uint32_t i;
-  uint32_t index;
+  void *p;
+  
+  if (pool_id == NULL) {
+    return NULL;
+  }
   
   if (inHandlerMode()) {
     dummy = portSET_INTERRUPT_MASK_FROM_ISR();
@@ -947,15 +963,11 @@ void *osPoolAlloc (osPoolId pool_id)
     vPortEnterCritical();
   }
   
-  for (i = 0; i < pool_id->pool_sz; i++) {
-    index = (pool_id->currentIndex + i) % pool_id->pool_sz;
-    
-    if (pool_id->markers[index] == 0) {
-      pool_id->markers[index] = 1;
-      p = (void *)((uint32_t)(pool_id->pool) + (index * pool_id->item_sz));
-      pool_id->currentIndex = index;
-      break;
-    }
+  /* Take the block at the head of the free list. */
+  p = pool_id->freeList;
+  if (p != NULL) {
+    pool_id->freeList = *(void **)p;
+    pool_id->markers[((uint8_t *)p - (uint8_t *)pool_id->pool) / pool_id->item_sz] = 1;
   }
   
   if (inHandlerMode()) {
@@ -980,7 +992,7 @@ void *osPoolCAlloc (osPoolId pool_id)
   
   if (p != NULL)
   {
-    memset(p, 0, sizeof(pool_id->pool_sz));
+    memset(p, 0, pool_id->item_sz);
   }
   
   return p;
@@ -995,7 +1007,9 @@ void *osPoolCAlloc (osPoolId pool_id)
 */
 osStatus osPoolFree (osPoolId pool_id, void *block)
 {
+  int dummy = 0;
   uint32_t index;
+  osStatus result = osOK;
   
   if (pool_id == NULL) {
     return osErrorParameter;
@@ -1005,11 +1019,11 @@ osStatus osPoolFree (osPoolId pool_id, void *block)
     return osErrorParameter;
   }
   
-  if (block < pool_id->pool) {
+  if ((uint8_t *)block < (uint8_t *)pool_id->pool) {
     return osErrorParameter;
   }
   
-  index = (uint32_t)block - (uint32_t)(pool_id->pool);
+  index = (uint32_t)((uint8_t *)block - (uint8_t *)pool_id->pool);
   if (index % pool_id->item_sz) {
     return osErrorParameter;
   }
@@ -1018,9 +1032,32 @@ osStatus osPoolFree (osPoolId pool_id, void *block)
     return osErrorParameter;
   }
   
-  pool_id->markers[index] = 0;
+  if (inHandlerMode()) {
+    dummy = portSET_INTERRUPT_MASK_FROM_ISR();
+  }
+  else {
+    vPortEnterCritical();
+  }
   
-  return osOK;
+  if (pool_id->markers[index] == 0) {
+    /* The block is already free. */
+    result = osErrorParameter;
+  }
+  else {
+    /* Return the block to the head of the free list. */
+    pool_id->markers[index] = 0;
+    *(void **)block = pool_id->freeList;
+    pool_id->freeList = block;
+  }
+  
+  if (inHandlerMode()) {
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(dummy);
+  }
+  else {
+    vPortExitCritical();
+  }
+  
+  return result;
 }
 
 
@@ -29,6 +29,7 @@
 #include "task.h"                       // ARM.FreeRTOS::RTOS:Core
 #include "event_groups.h"               // ARM.FreeRTOS::RTOS:Event Groups
 #include "semphr.h"                     // ARM.FreeRTOS::RTOS:Core
+#include "atomic.h"                     // ARM.FreeRTOS::RTOS:Core
 
 #include "freertos_mpool.h"             // osMemoryPool definitions
 #include "freertos_os2.h"               // Configuration check and setup
@@ -157,8 +158,11 @@ extern void xPortSysTickHandler (void);
 */
 #if (USE_CUSTOM_SYSTICK_HANDLER_IMPLEMENTATION == 0)
 void SysTick_Handler (void) {
-  /* Clear overflow flag */
+#if (configUSE_DYNAMIC_TICK == 0)
+  /* Clear overflow flag (with a dynamic tick the port reads it to measure
+     the time that has passed) */
   SysTick->CTRL;
+#endif
 
   if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) {
     /* Call tick handler */
@@ -187,12 +191,14 @@ __STATIC_INLINE void SVC_Setup (void) {
 #define uxSemaphoreGetCountFromISR( xSemaphore ) uxQueueMessagesWaitingFromISR( ( QueueHandle_t ) ( xSemaphore ) )
 #endif
 
+#if (configUSE_DYNAMIC_TICK == 0)
 /* Get OS Tick count value */
 static uint32_t OS_Tick_GetCount (void);
 /* Get OS Tick overflow status */
 static uint32_t OS_Tick_GetOverflow (void);
 /* Get OS Tick interval */
 static uint32_t OS_Tick_GetInterval (void);
+#endif
 /*---------------------------------------------------------------------------*/
 
 osStatus_t osKernelInitialize (void) {
@@ -396,6 +402,7 @@ uint32_t osKernelGetTickFreq (void) {
   return (configTICK_RATE_HZ);
 }
 
+#if (configUSE_DYNAMIC_TICK == 0)
 /* Get OS Tick count value */
 static uint32_t OS_Tick_GetCount (void) {
   uint32_t load = SysTick->LOAD;
@@ -411,8 +418,14 @@ static uint32_t OS_Tick_GetOverflow (void) {
 static uint32_t OS_Tick_GetInterval (void) {
   return (SysTick->LOAD + 1U);
 }
+#endif
 
 uint32_t osKernelGetSysTimerCount (void) {
+#if (configUSE_DYNAMIC_TICK == 1)
+  /* SysTick is used as a one-shot timer whose reload value varies, and its
+     overflow flag must not be cleared, so only tick resolution is available */
+  return (osKernelGetTickCount() * (configCPU_CLOCK_HZ / configTICK_RATE_HZ));
+#else
   uint32_t irqmask = IS_IRQ_MASKED();
   TickType_t ticks;
   uint32_t val;
@@ -433,6 +446,7 @@ uint32_t osKernelGetSysTimerCount (void) {
   }
 
   return (val);
+#endif
 }
 
 uint32_t osKernelGetSysTimerFreq (void) {
@@ -1948,6 +1962,7 @@ osStatus_t osMessageQueueDelete (osMessageQueueId_t mq_id) {
 static void  FreeBlock   (MemPool_t *mp, void *block);
 static void *AllocBlock  (MemPool_t *mp);
 static void *CreateBlock (MemPool_t *mp);
+static void  AtomicAdd   (volatile uint32_t *var, uint32_t val);
 
 osMemoryPoolId_t osMemoryPoolNew (uint32_t block_count, uint32_t block_size, const osMemoryPoolAttr_t *attr) {
   MemPool_t *mp;
@@ -2013,11 +2028,11 @@ osMemoryPoolId_t osMemoryPoolNew (uint32_t block_count, uint32_t block_size, con
     }
 
     if (mp != NULL) {
-      /* Create a semaphore (max count == initial count == block_count) */
+      /* Create a semaphore used to wait for free blocks (max count == block_count, initial count == 0) */
       #if (configSUPPORT_STATIC_ALLOCATION == 1)
-        mp->sem = xSemaphoreCreateCountingStatic (block_count, block_count, &mp->mem_sem);
+        mp->sem = xSemaphoreCreateCountingStatic (block_count, 0U, &mp->mem_sem);
       #elif (configSUPPORT_DYNAMIC_ALLOCATION == 1)
-        mp->sem = xSemaphoreCreateCounting (block_count, block_count);
+        mp->sem = xSemaphoreCreateCounting (block_count, 0U);
       #else
         mp->sem == NULL;
       #endif
@@ -2034,12 +2049,22 @@ osMemoryPoolId_t osMemoryPoolNew (uint32_t block_count, uint32_t block_size, con
 
     if ((mp != NULL) && (mp->mem_arr != NULL)) {
       /* Memory pool can be created */
-      mp->head    = NULL;
-      mp->mem_sz  = sz;
-      mp->name    = name;
-      mp->bl_sz   = block_size;
-      mp->bl_cnt  = block_count;
-      mp->n       = 0U;
+      mp->head     = 0U;
+      mp->avail    = block_count;
+      mp->waiting  = 0U;
+      mp->mem_sz   = sz;
+      mp->name     = name;
+      mp->bl_sz    = MEMPOOL_ARR_SIZE (1U, block_size);
+      mp->bl_cnt   = block_count;
+      mp->n        = 0U;
+      mp->max_used = 0U;
+      mp->fail_cnt = 0U;
+
+      /* Block index + 1 is stored in the lowest bits of the list head */
+      mp->idx_mask = 1U;
+      while (mp->idx_mask < block_count) {
+        mp->idx_mask = (mp->idx_mask << 1U) | 1U;
+      }
 
       /* Set heap allocated memory flags */
       mp->status = MPOOL_STATUS;
@@ -2086,7 +2111,8 @@ const char *osMemoryPoolGetName (osMemoryPoolId_t mp_id) {
 void *osMemoryPoolAlloc (osMemoryPoolId_t mp_id, uint32_t timeout) {
   MemPool_t *mp;
   void *block;
-  uint32_t isrm;
+  TimeOut_t tout;
+  TickType_t ticks;
 
   if (mp_id == NULL) {
     /* Invalid input parameters */
@@ -2100,40 +2126,45 @@ void *osMemoryPoolAlloc (osMemoryPoolId_t mp_id, uint32_t timeout) {
     if ((mp->status & MPOOL_STATUS) == MPOOL_STATUS) {
       if (IS_IRQ()) {
         if (timeout == 0U) {
-          if (xSemaphoreTakeFromISR (mp->sem, NULL) == pdTRUE) {
-            if ((mp->status & MPOOL_STATUS) == MPOOL_STATUS) {
-              isrm  = taskENTER_CRITICAL_FROM_ISR();
-
-              /* Get a block from the free-list */
-              block = AllocBlock(mp);
-
-              if (block == NULL) {
-                /* List of free blocks is empty, 'create' new block */
-                block = CreateBlock(mp);
-              }
-
-              taskEXIT_CRITICAL_FROM_ISR(isrm);
-            }
-          }
+          /* Get a free block */
+          block = AllocBlock(mp);
         }
       }
       else {
-        if (xSemaphoreTake (mp->sem, (TickType_t)timeout) == pdTRUE) {
-          if ((mp->status & MPOOL_STATUS) == MPOOL_STATUS) {
-            taskENTER_CRITICAL();
+        /* Get a free block */
+        block = AllocBlock(mp);
+
+        if ((block == NULL) && (timeout != 0U)) {
+          /* Pool is empty, wait on the pool semaphore until a block is freed */
+          vTaskSetTimeOutState (&tout);
+          ticks = (TickType_t)timeout;
+
+          do {
+            /* Register as waiting before retrying, so that a block freed
+               from now on also gives the semaphore */
+            AtomicAdd (&mp->waiting, 1U);
 
-            /* Get a block from the free-list */
             block = AllocBlock(mp);
 
             if (block == NULL) {
-              /* List of free blocks is empty, 'create' new block */
-              block = CreateBlock(mp);
+              (void)xSemaphoreTake (mp->sem, ticks);
             }
 
-            taskEXIT_CRITICAL();
+            AtomicAdd (&mp->waiting, (uint32_t)-1);
+
+            if ((mp->status & MPOOL_STATUS) != MPOOL_STATUS) {
+              /* Memory pool was deleted */
+              break;
+            }
           }
+          while ((block == NULL) && (xTaskCheckForTimeOut (&tout, &ticks) == pdFALSE));
         }
       }
+
+      if ((block == NULL) && ((mp->status & MPOOL_STATUS) == MPOOL_STATUS)) {
+        /* Count failed allocation */
+        AtomicAdd (&mp->fail_cnt, 1U);
+      }
     }
   }
 
@@ -2143,7 +2174,6 @@ void *osMemoryPoolAlloc (osMemoryPoolId_t mp_id, uint32_t timeout) {
 osStatus_t osMemoryPoolFree (osMemoryPoolId_t mp_id, void *block) {
   MemPool_t *mp;
   osStatus_t stat;
-  uint32_t isrm;
   BaseType_t yield;
 
   if ((mp_id == NULL) || (block == NULL)) {
@@ -2161,38 +2191,30 @@ osStatus_t osMemoryPoolFree (osMemoryPoolId_t mp_id, void *block) {
       /* Block pointer outside of memory array area */
       stat = osErrorParameter;
     }
+    else if ((((uint8_t *)block - mp->mem_arr) % mp->bl_sz) != 0U) {
+      /* Block pointer not at the start of a block */
+      stat = osErrorParameter;
+    }
+    else if (mp->avail == mp->bl_cnt) {
+      /* All blocks are already free */
+      stat = osErrorResource;
+    }
     else {
       stat = osOK;
 
-      if (IS_IRQ()) {
-        if (uxSemaphoreGetCountFromISR (mp->sem) == mp->bl_cnt) {
-          stat = osErrorResource;
-        }
-        else {
-          isrm = taskENTER_CRITICAL_FROM_ISR();
-
-          /* Add block to the list of free blocks */
-          FreeBlock(mp, block);
-
-          taskEXIT_CRITICAL_FROM_ISR(isrm);
+      /* Add block to the list of free blocks, then make it available */
+      FreeBlock(mp, block);
+      AtomicAdd (&mp->avail, 1U);
 
+      /* Wake-up a task waiting for a free block, unless the semaphore
+         already holds a wake-up for every waiting task */
+      if (mp->waiting > uxSemaphoreGetCountFromISR (mp->sem)) {
+        if (IS_IRQ()) {
           yield = pdFALSE;
           xSemaphoreGiveFromISR (mp->sem, &yield);
           portYIELD_FROM_ISR (yield);
         }
-      }
-      else {
-        if (uxSemaphoreGetCount (mp->sem) == mp->bl_cnt) {
-          stat = osErrorResource;
-        }
         else {
-          taskENTER_CRITICAL();
-
-          /* Add block to the list of free blocks */
-          FreeBlock(mp, block);
-
-          taskEXIT_CRITICAL();
-
           xSemaphoreGive (mp->sem);
         }
       }
@@ -2266,13 +2288,7 @@ uint32_t osMemoryPoolGetCount (osMemoryPoolId_t mp_id) {
       n = 0U;
     }
     else {
-      if (IS_IRQ()) {
-        n = uxSemaphoreGetCountFromISR (mp->sem);
-      } else {
-        n = uxSemaphoreGetCount        (mp->sem);
-      }
-
-      n = mp->bl_cnt - n;
+      n = mp->bl_cnt - mp->avail;
     }
   }
 
@@ -2296,11 +2312,7 @@ uint32_t osMemoryPoolGetSpace (osMemoryPoolId_t mp_id) {
       n = 0U;
     }
     else {
-      if (IS_IRQ()) {
-        n = uxSemaphoreGetCountFromISR (mp->sem);
-      } else {
-        n = uxSemaphoreGetCount        (mp->sem);
-      }
+      n = mp->avail;
     }
   }
 
@@ -2308,6 +2320,54 @@ uint32_t osMemoryPoolGetSpace (osMemoryPoolId_t mp_id) {
   return (n);
 }
 
+uint32_t osMemoryPoolGetMaxCount (osMemoryPoolId_t mp_id) {
+  MemPool_t *mp;
+  uint32_t  n;
+
+  if (mp_id == NULL) {
+    /* Invalid input parameters */
+    n = 0U;
+  }
+  else {
+    mp = (MemPool_t *)mp_id;
+
+    if ((mp->status & MPOOL_STATUS) != MPOOL_STATUS) {
+      /* Invalid object status */
+      n = 0U;
+    }
+    else {
+      n = mp->max_used;
+    }
+  }
+
+  /* Return maximum number of memory blocks used at the same time */
+  return (n);
+}
+
+uint32_t osMemoryPoolGetFailCount (osMemoryPoolId_t mp_id) {
+  MemPool_t *mp;
+  uint32_t  n;
+
+  if (mp_id == NULL) {
+    /* Invalid input parameters */
+    n = 0U;
+  }
+  else {
+    mp = (MemPool_t *)mp_id;
+
+    if ((mp->status & MPOOL_STATUS) != MPOOL_STATUS) {
+      /* Invalid object status */
+      n = 0U;
+    }
+    else {
+      n = mp->fail_cnt;
+    }
+  }
+
+  /* Return number of allocations that returned no memory block */
+  return (n);
+}
+
 osStatus_t osMemoryPoolDelete (osMemoryPoolId_t mp_id) {
   MemPool_t *mp;
   osStatus_t stat;
@@ -2330,7 +2390,8 @@ osStatus_t osMemoryPoolDelete (osMemoryPoolId_t mp_id) {
     /* Wake-up tasks waiting for pool semaphore */
     while (xSemaphoreGive (mp->sem) == pdTRUE);
 
-    mp->head    = NULL;
+    mp->head    = 0U;
+    mp->avail   = 0U;
     mp->bl_sz   = 0U;
     mp->bl_cnt  = 0U;
 
@@ -2351,35 +2412,333 @@ osStatus_t osMemoryPoolDelete (osMemoryPoolId_t mp_id) {
   return (stat);
 }
 
+osMailQueueId_t osMailQueueNew (uint32_t msg_count, uint32_t msg_size, const osMessageQueueAttr_t *attr) {
+  MailQueue_t *mq;
+  osMemoryPoolAttr_t mp_attr;
+  int32_t mem_cb, mem_mq;
+  uint32_t sz;
+
+  mq = NULL;
+
+  if (!IS_IRQ() && (msg_count > 0U) && (msg_size > 0U)) {
+    sz = MEMPOOL_ARR_SIZE (msg_count, msg_size);
+
+    memset (&mp_attr, 0, sizeof(mp_attr));
+    mem_cb = -1;
+    mem_mq = -1;
+
+    if (attr != NULL) {
+      mp_attr.name = attr->name;
+
+      if ((attr->cb_mem != NULL) && (attr->cb_size >= sizeof(MailQueue_t))) {
+        /* Static control block is provided */
+        mem_cb = 1;
+      }
+      else if ((attr->cb_mem == NULL) && (attr->cb_size == 0U)) {
+        /* Allocate control block memory on heap */
+        mem_cb = 0;
+      }
+
+      if ((attr->mq_mem == NULL) && (attr->mq_size == 0U)) {
+        /* Allocate message and pointer arrays on heap */
+        mem_mq = 0;
+      }
+      else if ((attr->mq_mem != NULL) && (attr->mq_size >= MAILQUEUE_ARR_SIZE (msg_count, msg_size))) {
+        /* Static array is provided, messages first and pointers after them */
+        mem_mq = 1;
+      }
+    }
+    else {
+      /* Attributes not provided, allocate memory on heap */
+      mem_cb = 0;
+      mem_mq = 0;
+    }
+
+    if ((mem_cb == 0) && (mem_mq != -1)) {
+      mq = pvPortMalloc (sizeof(MailQueue_t));
+    }
+    else if ((mem_cb == 1) && (mem_mq != -1)) {
+      mq = attr->cb_mem;
+    }
+
+    if (mq != NULL) {
+      mq->queue = NULL;
+
+      /* Create the memory pool of messages inside the control block */
+      mp_attr.cb_mem  = &mq->pool;
+      mp_attr.cb_size = sizeof(MemPool_t);
+
+      if (mem_mq == 1) {
+        mp_attr.mp_mem  = attr->mq_mem;
+        mp_attr.mp_size = sz;
+      }
+
+      if (osMemoryPoolNew (msg_count, msg_size, &mp_attr) != NULL) {
+        /* Create a queue of message pointers, one for every message */
+        if (mem_mq == 1) {
+          #if (configSUPPORT_STATIC_ALLOCATION == 1)
+            mq->queue = xQueueCreateStatic (msg_count, sizeof(void *), (uint8_t *)attr->mq_mem + sz, &mq->mem_queue);
+          #endif
+        }
+        else {
+          #if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+            mq->queue = xQueueCreate (msg_count, sizeof(void *));
+          #endif
+        }
+
+        if (mq->queue == NULL) {
+          (void)osMemoryPoolDelete (&mq->pool);
+        }
+      }
+
+      if (mq->queue != NULL) {
+        #if (configQUEUE_REGISTRY_SIZE > 0)
+          vQueueAddToRegistry (mq->queue, mp_attr.name);
+        #endif
+
+        mq->status = MAILQUEUE_STATUS;
+
+        if (mem_cb == 0) {
+          /* Control block on heap */
+          mq->status |= 1U;
+        }
+      }
+      else {
+        /* Mail queue cannot be created, release allocated resources */
+        if (mem_cb == 0) {
+          /* Free control block memory */
+          vPortFree (mq);
+        }
+        mq = NULL;
+      }
+    }
+  }
+
+  return ((osMailQueueId_t)mq);
+}
+
+void *osMailQueueAlloc (osMailQueueId_t mq_id, uint32_t timeout) {
+  MailQueue_t *mq = (MailQueue_t *)mq_id;
+  void *mail;
+
+  if ((mq == NULL) || ((mq->status & MAILQUEUE_STATUS) != MAILQUEUE_STATUS)) {
+    /* Invalid input parameters or object status */
+    mail = NULL;
+  }
+  else {
+    /* Allocate a message from the memory pool */
+    mail = osMemoryPoolAlloc (&mq->pool, timeout);
+  }
+
+  return (mail);
+}
+
+osStatus_t osMailQueuePut (osMailQueueId_t mq_id, void *mail) {
+  MailQueue_t *mq = (MailQueue_t *)mq_id;
+  osStatus_t stat;
+  BaseType_t yield;
+
+  if ((mq == NULL) || (mail == NULL)) {
+    /* Invalid input parameters */
+    stat = osErrorParameter;
+  }
+  else if ((mq->status & MAILQUEUE_STATUS) != MAILQUEUE_STATUS) {
+    /* Invalid object status */
+    stat = osErrorResource;
+  }
+  else if ((mail < (void *)&mq->pool.mem_arr[0]) || (mail > (void*)&mq->pool.mem_arr[mq->pool.mem_sz-1])) {
+    /* Message pointer outside of memory pool array area */
+    stat = osErrorParameter;
+  }
+  else {
+    stat = osOK;
+
+    /* The queue has space for a pointer to every message of the pool, so
+       sending never has to wait */
+    if (IS_IRQ()) {
+      yield = pdFALSE;
+
+      if (xQueueSendToBackFromISR (mq->queue, &mail, &yield) != pdTRUE) {
+        stat = osErrorResource;
+      } else {
+        portYIELD_FROM_ISR (yield);
+      }
+    }
+    else {
+      if (xQueueSendToBack (mq->queue, &mail, 0U) != pdPASS) {
+        stat = osErrorResource;
+      }
+    }
+  }
+
+  return (stat);
+}
+
+void *osMailQueueGet (osMailQueueId_t mq_id, uint32_t timeout) {
+  MailQueue_t *mq = (MailQueue_t *)mq_id;
+  void *mail;
+  BaseType_t yield;
+
+  mail = NULL;
+
+  if ((mq != NULL) && ((mq->status & MAILQUEUE_STATUS) == MAILQUEUE_STATUS)) {
+    if (IS_IRQ()) {
+      if (timeout == 0U) {
+        yield = pdFALSE;
+
+        if (xQueueReceiveFromISR (mq->queue, &mail, &yield) != pdPASS) {
+          mail = NULL;
+        } else {
+          portYIELD_FROM_ISR (yield);
+        }
+      }
+    }
+    else {
+      if (xQueueReceive (mq->queue, &mail, (TickType_t)timeout) != pdPASS) {
+        mail = NULL;
+      }
+    }
+  }
+
+  /* Return pointer to the received message, which is read in place */
+  return (mail);
+}
+
+osStatus_t osMailQueueFree (osMailQueueId_t mq_id, void *mail) {
+  MailQueue_t *mq = (MailQueue_t *)mq_id;
+  osStatus_t stat;
+
+  if (mq == NULL) {
+    /* Invalid input parameters */
+    stat = osErrorParameter;
+  }
+  else if ((mq->status & MAILQUEUE_STATUS) != MAILQUEUE_STATUS) {
+    /* Invalid object status */
+    stat = osErrorResource;
+  }
+  else {
+    /* Return the message to the memory pool */
+    stat = osMemoryPoolFree (&mq->pool, mail);
+  }
+
+  return (stat);
+}
+
+uint32_t osMailQueueGetCount (osMailQueueId_t mq_id) {
+  MailQueue_t *mq = (MailQueue_t *)mq_id;
+  UBaseType_t count;
+
+  if ((mq == NULL) || ((mq->status & MAILQUEUE_STATUS) != MAILQUEUE_STATUS)) {
+    count = 0U;
+  }
+  else if (IS_IRQ()) {
+    count = uxQueueMessagesWaitingFromISR (mq->queue);
+  }
+  else {
+    count = uxQueueMessagesWaiting (mq->queue);
+  }
+
+  /* Return number of messages published and not yet received */
+  return ((uint32_t)count);
+}
+
+osStatus_t osMailQueueDelete (osMailQueueId_t mq_id) {
+  MailQueue_t *mq = (MailQueue_t *)mq_id;
+  osStatus_t stat;
+
+#ifndef USE_FreeRTOS_HEAP_1
+  if (IS_IRQ()) {
+    stat = osErrorISR;
+  }
+  else if ((mq == NULL) || ((mq->status & MAILQUEUE_STATUS) != MAILQUEUE_STATUS)) {
+    stat = osErrorParameter;
+  }
+  else {
+    /* Invalidate control block status */
+    mq->status = mq->status & 1U;
+
+    #if (configQUEUE_REGISTRY_SIZE > 0)
+    vQueueUnregisterQueue (mq->queue);
+    #endif
+
+    vQueueDelete (mq->queue);
+    (void)osMemoryPoolDelete (&mq->pool);
+
+    if ((mq->status & 1U) != 0U) {
+      /* Mail queue control block allocated on heap */
+      vPortFree (mq);
+    }
+
+    stat = osOK;
+  }
+#else
+  stat = osError;
+#endif
+
+  return (stat);
+}
+
 /*
   Create new block given according to the current block index.
 */
 static void *CreateBlock (MemPool_t *mp) {
   MemPoolBlock_t *p = NULL;
+  uint32_t n;
 
-  if (mp->n < mp->bl_cnt) {
-    /* Unallocated blocks exist, set pointer to new block */
-    p = (void *)(mp->mem_arr + (mp->bl_sz * mp->n));
+  n = mp->n;
 
-    /* Increment block index */
-    mp->n += 1U;
+  if (n < mp->bl_cnt) {
+    /* Unallocated blocks exist, increment block index */
+    if (Atomic_CompareAndSwap_u32_AcqRel (&mp->n, n + 1U, n) == ATOMIC_COMPARE_AND_SWAP_SUCCESS) {
+      /* Set pointer to new block */
+      p = (void *)(mp->mem_arr + (mp->bl_sz * n));
+    }
   }
 
   return (p);
 }
 
 /*
-  Allocate a block by reading the list of free blocks.
+  Allocate a block by reserving one of the available blocks, then reading the
+  list of free blocks or creating a new block.
 */
 static void *AllocBlock (MemPool_t *mp) {
   MemPoolBlock_t *p = NULL;
+  uint32_t avail, used, max;
+  uint32_t head, idx;
 
-  if (mp->head != NULL) {
-    /* List of free block exists, get head block */
-    p = mp->head;
+  do {
+    avail = mp->avail;
+  }
+  while ((avail != 0U) && (Atomic_CompareAndSwap_u32_AcqRel (&mp->avail, avail - 1U, avail) != ATOMIC_COMPARE_AND_SWAP_SUCCESS));
 
-    /* Head block is now next on the list */
-    mp->head = p->next;
+  if (avail != 0U) {
+    /* Update maximum number of used blocks */
+    used = mp->bl_cnt - (avail - 1U);
+    do {
+      max = mp->max_used;
+    }
+    while ((used > max) && (Atomic_CompareAndSwap_u32_AcqRel (&mp->max_used, used, max) != ATOMIC_COMPARE_AND_SWAP_SUCCESS));
+
+    /* A block is reserved, so it is either on the list or not created yet */
+    while (p == NULL) {
+      head = mp->head;
+      idx  = head & mp->idx_mask;
+
+      if (idx != 0U) {
+        /* List of free block exists, get head block */
+        p = (MemPoolBlock_t *)(mp->mem_arr + (mp->bl_sz * (idx - 1U)));
+
+        /* Head block is now next on the list, with an incremented tag */
+        if (Atomic_CompareAndSwap_u32_AcqRel (&mp->head, ((head | mp->idx_mask) + 1U) | p->next, head) != ATOMIC_COMPARE_AND_SWAP_SUCCESS) {
+          p = NULL;
+        }
+      }
+      else {
+        /* List of free blocks is empty, 'create' new block */
+        p = CreateBlock(mp);
+      }
+    }
   }
 
   return (p);
@@ -2390,12 +2749,30 @@ static void *AllocBlock (MemPool_t *mp) {
 */
 static void FreeBlock (MemPool_t *mp, void *block) {
   MemPoolBlock_t *p = block;
+  uint32_t head, idx;
 
-  /* Store current head into block memory space */
-  p->next = mp->head;
+  idx = (uint32_t)(((uint8_t *)block - mp->mem_arr) / mp->bl_sz) + 1U;
 
-  /* Store current block as new head */
-  mp->head = p;
+  /* Store current head into block memory space, then store current block
+     as new head with an incremented tag, until the head did not change */
+  do {
+    head = mp->head;
+
+    p->next = head & mp->idx_mask;
+  }
+  while (Atomic_CompareAndSwap_u32_AcqRel (&mp->head, ((head | mp->idx_mask) + 1U) | idx, head) != ATOMIC_COMPARE_AND_SWAP_SUCCESS);
+}
+
+/*
+  Atomically add a value to a memory pool counter.
+*/
+static void AtomicAdd (volatile uint32_t *var, uint32_t val) {
+  uint32_t n;
+
+  do {
+    n = *var;
+  }
+  while (Atomic_CompareAndSwap_u32_AcqRel (var, n + val, n) != ATOMIC_COMPARE_AND_SWAP_SUCCESS);
 }
 #endif /* FREERTOS_MPOOL_H_ */
 /*---------------------------------------------------------------------------*/
@@ -24,6 +24,7 @@
 #define FREERTOS_MPOOL_H_
 
 #include <stdint.h>
+#include "cmsis_os2.h"
 #include "FreeRTOS.h"
 #include "semphr.h"
 
@@ -32,19 +33,33 @@
 
 /* Memory Block header */
 typedef struct {
-  void *next;                   /* Pointer to next block  */
+  uint32_t next;                /* Index + 1 of next block */
 } MemPoolBlock_t;
 
-/* Memory Pool control block */
+/* Memory Pool control block
+
+   Blocks are allocated and freed without a kernel object. The free blocks
+   are kept on a list whose head holds the index + 1 of the head block in the
+   bits of idx_mask and a tag in the remaining bits. The tag is incremented on
+   every change of the head, so a compare-and-swap of the head fails if the
+   head block was taken and returned meanwhile. The number of blocks that can
+   be allocated is counted in avail, and the semaphore is only used by tasks
+   that wait for a block while the pool is empty.
+*/
 typedef struct MemPoolDef_t {
-  MemPoolBlock_t    *head;      /* Pointer to head block   */
+  volatile uint32_t  head;      /* Free list head and tag  */
+  volatile uint32_t  avail;     /* Available block count   */
+  volatile uint32_t  waiting;   /* Number of waiting tasks */
   SemaphoreHandle_t  sem;       /* Pool semaphore handle   */
   uint8_t           *mem_arr;   /* Pool memory array       */
   uint32_t           mem_sz;    /* Pool memory array size  */
   const char        *name;      /* Pointer to name string  */
   uint32_t           bl_sz;     /* Size of a single block  */
   uint32_t           bl_cnt;    /* Number of blocks        */
-  uint32_t           n;         /* Block allocation index  */
+  uint32_t           idx_mask;  /* Index mask of head      */
+  volatile uint32_t  n;         /* Block allocation index  */
+  volatile uint32_t  max_used;  /* Maximum blocks in use   */
+  volatile uint32_t  fail_cnt;  /* Failed allocations      */
   volatile uint32_t  status;    /* Object status flags     */
 #if (configSUPPORT_STATIC_ALLOCATION == 1)
   StaticSemaphore_t  mem_sem;   /* Semaphore object memory */
@@ -60,4 +75,48 @@ typedef struct MemPoolDef_t {
 /* Define size of the byte array required to create count of blocks of given size */
 #define MEMPOOL_ARR_SIZE(bl_count, bl_size) (((((bl_size) + (4 - 1)) / 4) * 4)*(bl_count))
 
+/* Memory pool statistics (extension to the CMSIS-RTOS2 API) */
+uint32_t osMemoryPoolGetMaxCount  (osMemoryPoolId_t mp_id);
+uint32_t osMemoryPoolGetFailCount (osMemoryPoolId_t mp_id);
+
+/* Mail queue (extension to the CMSIS-RTOS2 API)
+
+   Messages are held in the blocks of a memory pool, and only pointers to them
+   are passed through the queue, so a message is not copied. A message is
+   allocated with osMailQueueAlloc, filled in place and published with
+   osMailQueuePut. The receiver gets it with osMailQueueGet, and releases it
+   with osMailQueueFree after reading it in place.
+*/
+typedef void *osMailQueueId_t;
+
+/* Mail queue implementation definitions */
+#define MAILQUEUE_STATUS          0x5EEA0000U
+
+/* Mail queue control block */
+typedef struct MailQueueDef_t {
+  MemPool_t          pool;      /* Mail memory pool        */
+  QueueHandle_t      queue;     /* Mail pointer queue      */
+  volatile uint32_t  status;    /* Object status flags     */
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+  StaticQueue_t      mem_queue; /* Queue object memory     */
+#endif
+} MailQueue_t;
+
+/* No need to hide static object type, just align to coding style */
+#define StaticMailQueue_t       MailQueue_t
+
+/* Define mail queue control block size */
+#define MAILQUEUE_CB_SIZE       (sizeof(StaticMailQueue_t))
+
+/* Define size of the byte array required to create a mail queue of count messages of given size */
+#define MAILQUEUE_ARR_SIZE(msg_count, msg_size) (MEMPOOL_ARR_SIZE(msg_count, msg_size) + ((msg_count) * sizeof(void *)))
+
+osMailQueueId_t osMailQueueNew      (uint32_t msg_count, uint32_t msg_size, const osMessageQueueAttr_t *attr);
+void           *osMailQueueAlloc    (osMailQueueId_t mq_id, uint32_t timeout);
+osStatus_t      osMailQueuePut      (osMailQueueId_t mq_id, void *mail);
+void           *osMailQueueGet      (osMailQueueId_t mq_id, uint32_t timeout);
+osStatus_t      osMailQueueFree     (osMailQueueId_t mq_id, void *mail);
+uint32_t        osMailQueueGetCount (osMailQueueId_t mq_id);
+osStatus_t      osMailQueueDelete   (osMailQueueId_t mq_id);
+
 #endif /* FREERTOS_MPOOL_H_ */
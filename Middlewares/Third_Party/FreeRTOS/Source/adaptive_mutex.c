@@ -0,0 +1,473 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "atomic.h"
+#include "adaptive_mutex.h"
+
+/* Lint e961, e750 and e9021 are suppressed as a MISRA exception justified
+because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+for the header files above, but not in this file, in order to generate the
+correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021 See comment above. */
+
+/* This entire source file will be skipped if the application is not configured
+to include adaptive mutex functionality.  This #if is closed at the very bottom
+of this file.  If you want to include adaptive mutexes then ensure
+configUSE_ADAPTIVE_MUTEXES is set to 1 in FreeRTOSConfig.h. */
+#if( configUSE_ADAPTIVE_MUTEXES == 1 )
+
+#if( configUSE_PREEMPTION == 0 )
+	/* If the cooperative scheduler is being used then a yield should not be
+	performed just because a higher priority task has been woken. */
+	#define amutexYIELD_IF_USING_PREEMPTION()
+#else
+	#define amutexYIELD_IF_USING_PREEMPTION() portYIELD_WITHIN_API()
+#endif
+
+typedef struct AdaptiveMutexDef_t
+{
+	void * volatile pvMutexHolder;	/*< The handle of the task holding the mutex, or NULL if the mutex is free.  Only ever set from NULL by a compare-and-swap. */
+	List_t xTasksWaitingToTake;		/*< List of tasks blocked waiting for the mutex.  Stored in priority order. */
+
+	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+		uint8_t ucStaticallyAllocated; /*< Set to pdTRUE if the mutex is statically allocated to ensure no attempt is made to free the memory. */
+	#endif
+} AdaptiveMutex_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called after a task that caused the mutex holder to inherit its priority
+ * times out.  Returns the priority of the highest priority task still waiting
+ * for the mutex, or tskIDLE_PRIORITY if no tasks are waiting.
+ */
+static UBaseType_t prvGetDisinheritPriorityAfterTimeout( const AdaptiveMutex_t * const pxMutex ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+	AdaptiveMutexHandle_t xAdaptiveMutexCreateStatic( StaticAdaptiveMutex_t *pxMutexBuffer )
+	{
+	AdaptiveMutex_t *pxMutex;
+
+		/* A StaticAdaptiveMutex_t object must be provided. */
+		configASSERT( pxMutexBuffer );
+
+		#if( configASSERT_DEFINED == 1 )
+		{
+			/* Sanity check that the size of the structure used to declare a
+			variable of type StaticAdaptiveMutex_t equals the size of the real
+			mutex structure. */
+			volatile size_t xSize = sizeof( StaticAdaptiveMutex_t );
+			configASSERT( xSize == sizeof( AdaptiveMutex_t ) );
+		} /*lint !e529 xSize is referenced if configASSERT() is defined. */
+		#endif /* configASSERT_DEFINED */
+
+		/* The user has provided a statically allocated mutex - use it. */
+		pxMutex = ( AdaptiveMutex_t * ) pxMutexBuffer; /*lint !e740 !e9087 AdaptiveMutex_t and StaticAdaptiveMutex_t are deliberately aliased for data hiding purposes and guaranteed to have the same size and alignment requirement - checked by configASSERT(). */
+
+		if( pxMutex != NULL )
+		{
+			pxMutex->pvMutexHolder = NULL;
+			vListInitialise( &( pxMutex->xTasksWaitingToTake ) );
+
+			#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+			{
+				/* Both static and dynamic allocation can be used, so note that
+				this mutex was created statically in case the mutex is later
+				deleted. */
+				pxMutex->ucStaticallyAllocated = pdTRUE;
+			}
+			#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+
+			traceADAPTIVE_MUTEX_CREATE( pxMutex );
+		}
+		else
+		{
+			traceADAPTIVE_MUTEX_CREATE_FAILED();
+		}
+
+		return pxMutex;
+	}
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	AdaptiveMutexHandle_t xAdaptiveMutexCreate( void )
+	{
+	AdaptiveMutex_t *pxMutex;
+
+		/* pvPortMalloc() always returns memory aligned to the requirements of
+		the stack, which is sufficient for the pointer and list members of the
+		AdaptiveMutex_t structure. */
+		pxMutex = ( AdaptiveMutex_t * ) pvPortMalloc( sizeof( AdaptiveMutex_t ) ); /*lint !e9087 !e9079 see comment above. */
+
+		if( pxMutex != NULL )
+		{
+			pxMutex->pvMutexHolder = NULL;
+			vListInitialise( &( pxMutex->xTasksWaitingToTake ) );
+
+			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+			{
+				/* Both static and dynamic allocation can be used, so note this
+				mutex was allocated dynamically in case the mutex is later
+				deleted. */
+				pxMutex->ucStaticallyAllocated = pdFALSE;
+			}
+			#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+			traceADAPTIVE_MUTEX_CREATE( pxMutex );
+		}
+		else
+		{
+			traceADAPTIVE_MUTEX_CREATE_FAILED(); /*lint !e9063 Else branch only exists to allow tracing and does not generate code if trace macros are not defined. */
+		}
+
+		return pxMutex;
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+BaseType_t xAdaptiveMutexTake( AdaptiveMutexHandle_t xMutex, TickType_t xTicksToWait )
+{
+AdaptiveMutex_t * const pxMutex = xMutex;
+TaskHandle_t const xCurrentTask = xTaskGetCurrentTaskHandle();
+BaseType_t xReturn = pdFAIL, xEntryTimeSet = pdFALSE, xInheritanceOccurred = pdFALSE, xYieldToHolder;
+UBaseType_t uxYields = 0;
+TimeOut_t xTimeOut;
+
+	configASSERT( pxMutex );
+
+	/* Cannot block if the scheduler is suspended. */
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	for( ;; )
+	{
+		/* The mutex is free if it has no holder, in which case claiming it
+		needs nothing more than a single compare-and-swap. */
+		if( Atomic_CompareAndSwapPointers_AcqRel( &( pxMutex->pvMutexHolder ), xCurrentTask, NULL ) == ATOMIC_COMPARE_AND_SWAP_SUCCESS )
+		{
+			/* Record the mutex as held so any priority inherited while it is
+			held is disinherited again when it is given back. */
+			( void ) pvTaskIncrementMutexHeldCount();
+			traceADAPTIVE_MUTEX_TAKE( pxMutex );
+			xReturn = pdPASS;
+			break;
+		}
+
+		/* Adaptive mutexes cannot be taken recursively. */
+		configASSERT( pxMutex->pvMutexHolder != xCurrentTask );
+
+		if( xTicksToWait == ( TickType_t ) 0 )
+		{
+			/* The mutex is held and no block time is specified (or the block
+			time has expired) so exit now. */
+			break;
+		}
+		else if( xEntryTimeSet == pdFALSE )
+		{
+			/* The block time starts now, so any time spent yielding to the
+			mutex holder counts towards it. */
+			vTaskSetTimeOutState( &xTimeOut );
+			xEntryTimeSet = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* On a single core the holder cannot release the mutex while this
+		task spins, so instead of spinning yield to the holder if it is
+		ready to run and yielding would let it run.  The holder is read inside
+		the critical section so it cannot release the mutex, or be deleted,
+		while its state is inspected. */
+		xYieldToHolder = pdFALSE;
+
+		if( uxYields < ( UBaseType_t ) configADAPTIVE_MUTEX_YIELD_LIMIT )
+		{
+			taskENTER_CRITICAL();
+			{
+				if( pxMutex->pvMutexHolder != NULL )
+				{
+					xYieldToHolder = xTaskMutexHolderCanRun( pxMutex->pvMutexHolder );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( xYieldToHolder != pdFALSE )
+		{
+			uxYields++;
+			portYIELD_WITHIN_API();
+			continue;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* The holder is not going to run before this task blocks, so block.
+		Mutexes are only given by tasks, so the holder cannot change while the
+		scheduler is suspended. */
+		vTaskSuspendAll();
+
+		if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+		{
+			if( pxMutex->pvMutexHolder != NULL )
+			{
+				traceBLOCKING_ON_ADAPTIVE_MUTEX_TAKE( pxMutex );
+
+				taskENTER_CRITICAL();
+				{
+					if( xTaskPriorityInherit( pxMutex->pvMutexHolder ) != pdFALSE )
+					{
+						xInheritanceOccurred = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				taskEXIT_CRITICAL();
+
+				vTaskPlaceOnEventList( &( pxMutex->xTasksWaitingToTake ), xTicksToWait );
+
+				if( xTaskResumeAll() == pdFALSE )
+				{
+					portYIELD_WITHIN_API();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				/* The mutex was given since the last attempt, so try to take
+				it again. */
+				( void ) xTaskResumeAll();
+			}
+		}
+		else
+		{
+			/* Timed out.  xTicksToWait is now 0, so the loop exits after one
+			more attempt to take the mutex. */
+			( void ) xTaskResumeAll();
+		}
+	}
+
+	if( xReturn == pdFAIL )
+	{
+		if( xInheritanceOccurred != pdFALSE )
+		{
+			taskENTER_CRITICAL();
+			{
+				/* This task blocking on the mutex caused the holder to inherit
+				this task's priority.  Now this task has timed out the priority
+				should be disinherited again, but only as low as the next
+				highest priority task that is waiting for the same mutex. */
+				vTaskPriorityDisinheritAfterTimeout( pxMutex->pvMutexHolder, prvGetDisinheritPriorityAfterTimeout( pxMutex ) );
+			}
+			taskEXIT_CRITICAL();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		traceADAPTIVE_MUTEX_TAKE_FAILED( pxMutex );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAdaptiveMutexGive( AdaptiveMutexHandle_t xMutex )
+{
+AdaptiveMutex_t * const pxMutex = xMutex;
+TaskHandle_t const xCurrentTask = xTaskGetCurrentTaskHandle();
+BaseType_t xReturn, xYieldRequired = pdFALSE;
+
+	configASSERT( pxMutex );
+
+	taskENTER_CRITICAL();
+	{
+		if( pxMutex->pvMutexHolder == xCurrentTask )
+		{
+			traceADAPTIVE_MUTEX_GIVE( pxMutex );
+
+			/* Tasks taking the mutex without blocking only need to see the
+			holder cleared.  The critical section orders the accesses made
+			while the mutex was held before the store. */
+			pxMutex->pvMutexHolder = NULL;
+
+			/* Restore the priority of this task if it inherited a priority
+			while holding the mutex. */
+			xYieldRequired = xTaskPriorityDisinherit( xCurrentTask );
+
+			/* Unblock the highest priority waiting task.  It takes the mutex
+			when it runs, unless another task takes it first, in which case it
+			blocks again until that task gives it. */
+			if( listLIST_IS_EMPTY( &( pxMutex->xTasksWaitingToTake ) ) == pdFALSE )
+			{
+				if( xTaskRemoveFromEventList( &( pxMutex->xTasksWaitingToTake ) ) != pdFALSE )
+				{
+					xYieldRequired = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			xReturn = pdPASS;
+		}
+		else
+		{
+			/* Only the holder can give the mutex. */
+			xReturn = pdFAIL;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	if( xYieldRequired != pdFALSE )
+	{
+		amutexYIELD_IF_USING_PREEMPTION();
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+TaskHandle_t xAdaptiveMutexGetMutexHolder( AdaptiveMutexHandle_t xMutex )
+{
+AdaptiveMutex_t * const pxMutex = xMutex;
+
+	configASSERT( pxMutex );
+
+	return ( TaskHandle_t ) pxMutex->pvMutexHolder;
+}
+/*-----------------------------------------------------------*/
+
+void vAdaptiveMutexDelete( AdaptiveMutexHandle_t xMutex )
+{
+AdaptiveMutex_t * const pxMutex = xMutex;
+
+	configASSERT( pxMutex );
+
+	/* A mutex cannot be deleted while it is held or waited for. */
+	configASSERT( pxMutex->pvMutexHolder == NULL );
+	configASSERT( listLIST_IS_EMPTY( &( pxMutex->xTasksWaitingToTake ) ) != pdFALSE );
+
+	traceADAPTIVE_MUTEX_DELETE( pxMutex );
+
+	#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
+	{
+		/* The mutex can only have been allocated dynamically - free it
+		again. */
+		vPortFree( pxMutex );
+	}
+	#elif( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+	{
+		/* The mutex could have been allocated statically or dynamically, so
+		check before attempting to free the memory. */
+		if( pxMutex->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+		{
+			vPortFree( pxMutex );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvGetDisinheritPriorityAfterTimeout( const AdaptiveMutex_t * const pxMutex )
+{
+UBaseType_t uxHighestPriorityOfWaitingTasks;
+
+	/* As in queue.c, the waiting tasks are held in priority order, with the
+	event list item value of each set to configMAX_PRIORITIES minus the
+	task's priority. */
+	if( listCURRENT_LIST_LENGTH( &( pxMutex->xTasksWaitingToTake ) ) > 0U )
+	{
+		uxHighestPriorityOfWaitingTasks = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxMutex->xTasksWaitingToTake ) );
+	}
+	else
+	{
+		uxHighestPriorityOfWaitingTasks = tskIDLE_PRIORITY;
+	}
+
+	return uxHighestPriorityOfWaitingTasks;
+}
+/*-----------------------------------------------------------*/
+
+/* This entire source file will be skipped if the application is not configured
+to include adaptive mutex functionality.  If you want to include adaptive
+mutexes then ensure configUSE_ADAPTIVE_MUTEXES is set to 1 in FreeRTOSConfig.h. */
+#endif /* configUSE_ADAPTIVE_MUTEXES == 1 */
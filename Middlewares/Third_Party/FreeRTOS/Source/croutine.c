@@ -41,22 +41,73 @@
 #endif
 
 
+#if( configUSE_CO_ROUTINE_PRIORITY_BITMAP == 1 )
+
+	/* If configUSE_CO_ROUTINE_PRIORITY_BITMAP is 1 then the highest priority
+	ready co-routine is found using a two level bitmap of the priorities that
+	have ready co-routines, in the same way as tasks are selected when
+	configUSE_PRIORITY_BITMAP_TASK_SELECTION is 1, so the scheduler does not
+	scan down through empty priorities.  Bit n of ulReadyCoRoutineGroups is set
+	if any of the priorities ( n * 32 ) to ( ( n * 32 ) + 31 ) have ready
+	co-routines. */
+	#define corPRIORITY_GROUP_BITS		( 32U )
+	#define corPRIORITY_GROUPS			( ( configMAX_CO_ROUTINE_PRIORITIES + corPRIORITY_GROUP_BITS - 1U ) / corPRIORITY_GROUP_BITS )
+
+	#if defined( __GNUC__ )
+		#define corHIGHEST_SET_BIT( ulBits )	( ( UBaseType_t ) ( ( ( sizeof( unsigned long ) * 8U ) - 1U ) - ( UBaseType_t ) __builtin_clzl( ( unsigned long ) ( ulBits ) ) ) )
+	#else
+		#define corHIGHEST_SET_BIT( ulBits )	prvHighestSetBit( ulBits )
+	#endif
+
+#endif /* configUSE_CO_ROUTINE_PRIORITY_BITMAP */
+
+#if( configUSE_CO_ROUTINE_DELAY_WHEEL == 1 )
+
+	/* If configUSE_CO_ROUTINE_DELAY_WHEEL is 1 then delayed co-routines are
+	held in a wheel of configCO_ROUTINE_DELAY_WHEEL_SLOTS unsorted lists, in the
+	slot selected by the low bits of their wake time, rather than in a list
+	sorted by wake time.  Delaying a co-routine is then constant time however
+	many co-routines are delayed, and each tick only looks at the co-routines in
+	one slot.  A co-routine that is delayed for more than
+	configCO_ROUTINE_DELAY_WHEEL_SLOTS ticks stays in its slot while the wheel
+	goes round. */
+	#if( ( configCO_ROUTINE_DELAY_WHEEL_SLOTS & ( configCO_ROUTINE_DELAY_WHEEL_SLOTS - 1 ) ) != 0 )
+		#error configCO_ROUTINE_DELAY_WHEEL_SLOTS must be a power of 2
+	#endif
+
+	#define corDELAY_WHEEL_SLOT( xTime )	( ( UBaseType_t ) ( ( xTime ) & ( TickType_t ) ( configCO_ROUTINE_DELAY_WHEEL_SLOTS - 1 ) ) )
+
+#endif /* configUSE_CO_ROUTINE_DELAY_WHEEL */
+
 /* Lists for ready and blocked co-routines. --------------------*/
 static List_t pxReadyCoRoutineLists[ configMAX_CO_ROUTINE_PRIORITIES ];	/*< Prioritised ready co-routines. */
-static List_t xDelayedCoRoutineList1;									/*< Delayed co-routines. */
-static List_t xDelayedCoRoutineList2;									/*< Delayed co-routines (two lists are used - one for delays that have overflowed the current tick count. */
-static List_t * pxDelayedCoRoutineList;									/*< Points to the delayed co-routine list currently being used. */
-static List_t * pxOverflowDelayedCoRoutineList;							/*< Points to the delayed co-routine list currently being used to hold co-routines that have overflowed the current tick count. */
+#if( configUSE_CO_ROUTINE_DELAY_WHEEL == 1 )
+	static List_t xDelayedCoRoutineWheel[ configCO_ROUTINE_DELAY_WHEEL_SLOTS ];	/*< Delayed co-routines, in the slot of their wake time. */
+#else
+	static List_t xDelayedCoRoutineList1;								/*< Delayed co-routines. */
+	static List_t xDelayedCoRoutineList2;								/*< Delayed co-routines (two lists are used - one for delays that have overflowed the current tick count. */
+	static List_t * pxDelayedCoRoutineList;								/*< Points to the delayed co-routine list currently being used. */
+	static List_t * pxOverflowDelayedCoRoutineList;						/*< Points to the delayed co-routine list currently being used to hold co-routines that have overflowed the current tick count. */
+#endif
 static List_t xPendingReadyCoRoutineList;								/*< Holds co-routines that have been readied by an external event.  They cannot be added directly to the ready lists as the ready lists cannot be accessed by interrupts. */
 
 /* Other file private variables. --------------------------------*/
 CRCB_t * pxCurrentCoRoutine = NULL;
-static UBaseType_t uxTopCoRoutineReadyPriority = 0;
+#if( configUSE_CO_ROUTINE_PRIORITY_BITMAP == 1 )
+	static uint32_t ulReadyCoRoutineGroups = 0UL;
+	static uint32_t ulReadyCoRoutinePriorities[ corPRIORITY_GROUPS ] = { 0UL };
+#else
+	static UBaseType_t uxTopCoRoutineReadyPriority = 0;
+#endif
 static TickType_t xCoRoutineTickCount = 0, xLastTickCount = 0, xPassedTicks = 0;
 
 /* The initial state of the co-routine when it is created. */
 #define corINITIAL_STATE	( 0 )
 
+/* The value held in the event list item of a co-routine, which keeps event
+lists in priority order. */
+#define corEVENT_LIST_ITEM_VALUE( pxCRCB )	( ( TickType_t ) configMAX_CO_ROUTINE_PRIORITIES - ( TickType_t ) ( pxCRCB )->uxPriority )
+
 /*
  * Place the co-routine represented by pxCRCB into the appropriate ready queue
  * for the priority.  It is inserted at the end of the list.
@@ -64,14 +115,27 @@ static TickType_t xCoRoutineTickCount = 0, xLastTickCount = 0, xPassedTicks = 0;
  * This macro accesses the co-routine ready lists and therefore must not be
  * used from within an ISR.
  */
-#define prvAddCoRoutineToReadyQueue( pxCRCB )																		\
-{																													\
-	if( pxCRCB->uxPriority > uxTopCoRoutineReadyPriority )															\
-	{																												\
-		uxTopCoRoutineReadyPriority = pxCRCB->uxPriority;															\
-	}																												\
-	vListInsertEnd( ( List_t * ) &( pxReadyCoRoutineLists[ pxCRCB->uxPriority ] ), &( pxCRCB->xGenericListItem ) );	\
-}
+#if( configUSE_CO_ROUTINE_PRIORITY_BITMAP == 1 )
+
+	#define prvAddCoRoutineToReadyQueue( pxCRCB )																		\
+	{																													\
+		ulReadyCoRoutinePriorities[ pxCRCB->uxPriority / corPRIORITY_GROUP_BITS ] |= ( 1UL << ( pxCRCB->uxPriority % corPRIORITY_GROUP_BITS ) );	\
+		ulReadyCoRoutineGroups |= ( 1UL << ( pxCRCB->uxPriority / corPRIORITY_GROUP_BITS ) );							\
+		vListInsertEnd( ( List_t * ) &( pxReadyCoRoutineLists[ pxCRCB->uxPriority ] ), &( pxCRCB->xGenericListItem ) );	\
+	}
+
+#else
+
+	#define prvAddCoRoutineToReadyQueue( pxCRCB )																		\
+	{																													\
+		if( pxCRCB->uxPriority > uxTopCoRoutineReadyPriority )															\
+		{																												\
+			uxTopCoRoutineReadyPriority = pxCRCB->uxPriority;															\
+		}																												\
+		vListInsertEnd( ( List_t * ) &( pxReadyCoRoutineLists[ pxCRCB->uxPriority ] ), &( pxCRCB->xGenericListItem ) );	\
+	}
+
+#endif /* configUSE_CO_ROUTINE_PRIORITY_BITMAP */
 
 /*
  * Utility to ready all the lists used by the scheduler.  This is called
@@ -97,6 +161,16 @@ static void prvCheckPendingReadyList( void );
  */
 static void prvCheckDelayedList( void );
 
+#if( ( configUSE_CO_ROUTINE_PRIORITY_BITMAP == 1 ) && !defined( __GNUC__ ) )
+
+	/*
+	 * Return the position of the most significant set bit in ulBits, which
+	 * must not be zero.
+	 */
+	static UBaseType_t prvHighestSetBit( uint32_t ulBits );
+
+#endif
+
 /*-----------------------------------------------------------*/
 
 BaseType_t xCoRoutineCreate( crCOROUTINE_CODE pxCoRoutineCode, UBaseType_t uxPriority, UBaseType_t uxIndex )
@@ -139,7 +213,7 @@ CRCB_t *pxCoRoutine;
 		listSET_LIST_ITEM_OWNER( &( pxCoRoutine->xEventListItem ), pxCoRoutine );
 
 		/* Event lists are always in priority order. */
-		listSET_LIST_ITEM_VALUE( &( pxCoRoutine->xEventListItem ), ( ( TickType_t ) configMAX_CO_ROUTINE_PRIORITIES - ( TickType_t ) uxPriority ) );
+		listSET_LIST_ITEM_VALUE( &( pxCoRoutine->xEventListItem ), corEVENT_LIST_ITEM_VALUE( pxCoRoutine ) );
 
 		/* Now the co-routine has been initialised it can be added to the ready
 		list at the correct priority. */
@@ -169,21 +243,45 @@ TickType_t xTimeToWake;
 	both lists. */
 	( void ) uxListRemove( ( ListItem_t * ) &( pxCurrentCoRoutine->xGenericListItem ) );
 
-	/* The list item will be inserted in wake time order. */
-	listSET_LIST_ITEM_VALUE( &( pxCurrentCoRoutine->xGenericListItem ), xTimeToWake );
-
-	if( xTimeToWake < xCoRoutineTickCount )
+	#if( configUSE_CO_ROUTINE_DELAY_WHEEL == 1 )
 	{
-		/* Wake time has overflowed.  Place this item in the
-		overflow list. */
-		vListInsert( ( List_t * ) pxOverflowDelayedCoRoutineList, ( ListItem_t * ) &( pxCurrentCoRoutine->xGenericListItem ) );
+		/* The slot of the current tick count is not looked at again until the
+		wheel has gone round, so a delay of zero wakes on the next tick, as it
+		does when the delayed lists are used. */
+		if( xTimeToWake == xCoRoutineTickCount )
+		{
+			xTimeToWake++;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* The wake time is held in the list item so the co-routine is only
+		woken when the tick count reaches it, rather than each time the wheel
+		reaches its slot. */
+		listSET_LIST_ITEM_VALUE( &( pxCurrentCoRoutine->xGenericListItem ), xTimeToWake );
+		vListInsertEnd( &( xDelayedCoRoutineWheel[ corDELAY_WHEEL_SLOT( xTimeToWake ) ] ), &( pxCurrentCoRoutine->xGenericListItem ) );
 	}
-	else
+	#else
 	{
-		/* The wake time has not overflowed, so we can use the
-		current block list. */
-		vListInsert( ( List_t * ) pxDelayedCoRoutineList, ( ListItem_t * ) &( pxCurrentCoRoutine->xGenericListItem ) );
+		/* The list item will be inserted in wake time order. */
+		listSET_LIST_ITEM_VALUE( &( pxCurrentCoRoutine->xGenericListItem ), xTimeToWake );
+
+		if( xTimeToWake < xCoRoutineTickCount )
+		{
+			/* Wake time has overflowed.  Place this item in the
+			overflow list. */
+			vListInsert( ( List_t * ) pxOverflowDelayedCoRoutineList, ( ListItem_t * ) &( pxCurrentCoRoutine->xGenericListItem ) );
+		}
+		else
+		{
+			/* The wake time has not overflowed, so we can use the
+			current block list. */
+			vListInsert( ( List_t * ) pxDelayedCoRoutineList, ( ListItem_t * ) &( pxCurrentCoRoutine->xGenericListItem ) );
+		}
 	}
+	#endif /* configUSE_CO_ROUTINE_DELAY_WHEEL */
 
 	if( pxEventList )
 	{
@@ -194,6 +292,22 @@ TickType_t xTimeToWake;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_CO_ROUTINE_EVENT_GROUP_WAITS == 1 )
+
+	void vCoRoutineAddToUnorderedEventList( TickType_t xTicksToDelay, List_t *pxEventList, const TickType_t xItemValue )
+	{
+		/* Event group waits are not held in priority order as every co-routine
+		in the list is tested when bits are set.  The value is stored before
+		the co-routine is placed in the event list, which must be done with
+		interrupts disabled. */
+		vCoRoutineAddToDelayedList( xTicksToDelay, NULL );
+		listSET_LIST_ITEM_VALUE( &( pxCurrentCoRoutine->xEventListItem ), xItemValue );
+		vListInsertEnd( pxEventList, &( pxCurrentCoRoutine->xEventListItem ) );
+	}
+
+#endif /* configUSE_CO_ROUTINE_EVENT_GROUP_WAITS */
+/*-----------------------------------------------------------*/
+
 static void prvCheckPendingReadyList( void )
 {
 	/* Are there any co-routines waiting to get moved to the ready list?  These
@@ -217,6 +331,62 @@ static void prvCheckPendingReadyList( void )
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_CO_ROUTINE_DELAY_WHEEL == 1 )
+
+	static void prvCheckDelayedList( void )
+	{
+	CRCB_t *pxCRCB;
+	List_t *pxSlot;
+	ListItem_t const *pxSlotEnd;
+	ListItem_t *pxItem, *pxNext;
+
+		xPassedTicks = xTaskGetTickCount() - xLastTickCount;
+		while( xPassedTicks )
+		{
+			xCoRoutineTickCount++;
+			xPassedTicks--;
+
+			/* Only the co-routines in the slot of this tick can be due.  Those
+			whose wake time is on a later turn of the wheel are left where they
+			are.  Generic list items are only moved by the co-routine scheduler,
+			so the slot can be walked with interrupts enabled. */
+			pxSlot = &( xDelayedCoRoutineWheel[ corDELAY_WHEEL_SLOT( xCoRoutineTickCount ) ] );
+			pxSlotEnd = listGET_END_MARKER( pxSlot ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
+
+			for( pxItem = listGET_HEAD_ENTRY( pxSlot ); pxItem != pxSlotEnd; pxItem = pxNext )
+			{
+				pxNext = listGET_NEXT( pxItem );
+
+				if( listGET_LIST_ITEM_VALUE( pxItem ) == xCoRoutineTickCount )
+				{
+					pxCRCB = ( CRCB_t * ) listGET_LIST_ITEM_OWNER( pxItem );
+
+					portDISABLE_INTERRUPTS();
+					{
+						( void ) uxListRemove( &( pxCRCB->xGenericListItem ) );
+
+						/* Is the co-routine waiting on an event also? */
+						if( pxCRCB->xEventListItem.pxContainer )
+						{
+							( void ) uxListRemove( &( pxCRCB->xEventListItem ) );
+						}
+					}
+					portENABLE_INTERRUPTS();
+
+					prvAddCoRoutineToReadyQueue( pxCRCB );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+
+		xLastTickCount = xCoRoutineTickCount;
+	}
+
+#else /* configUSE_CO_ROUTINE_DELAY_WHEEL */
+
 static void prvCheckDelayedList( void )
 {
 CRCB_t *pxCRCB;
@@ -273,6 +443,8 @@ CRCB_t *pxCRCB;
 
 	xLastTickCount = xCoRoutineTickCount;
 }
+
+#endif /* configUSE_CO_ROUTINE_DELAY_WHEEL */
 /*-----------------------------------------------------------*/
 
 void vCoRoutineSchedule( void )
@@ -283,20 +455,61 @@ void vCoRoutineSchedule( void )
 	/* See if any delayed co-routines have timed out. */
 	prvCheckDelayedList();
 
-	/* Find the highest priority queue that contains ready co-routines. */
-	while( listLIST_IS_EMPTY( &( pxReadyCoRoutineLists[ uxTopCoRoutineReadyPriority ] ) ) )
+	#if( configUSE_CO_ROUTINE_PRIORITY_BITMAP == 1 )
 	{
-		if( uxTopCoRoutineReadyPriority == 0 )
+	UBaseType_t uxTopGroup, uxTopPriority;
+
+		/* Find the highest priority queue that contains ready co-routines.  A
+		co-routine leaves its ready list when it blocks, so the bit of a
+		priority is cleared here once its ready list is found to be empty. */
+		for( ;; )
 		{
-			/* No more co-routines to check. */
-			return;
+			if( ulReadyCoRoutineGroups == 0UL )
+			{
+				/* No more co-routines to check. */
+				return;
+			}
+
+			uxTopGroup = corHIGHEST_SET_BIT( ulReadyCoRoutineGroups );
+			uxTopPriority = ( uxTopGroup * corPRIORITY_GROUP_BITS ) + corHIGHEST_SET_BIT( ulReadyCoRoutinePriorities[ uxTopGroup ] );
+
+			if( listLIST_IS_EMPTY( &( pxReadyCoRoutineLists[ uxTopPriority ] ) ) == pdFALSE )
+			{
+				break;
+			}
+
+			ulReadyCoRoutinePriorities[ uxTopGroup ] &= ~( 1UL << ( uxTopPriority % corPRIORITY_GROUP_BITS ) );
+
+			if( ulReadyCoRoutinePriorities[ uxTopGroup ] == 0UL )
+			{
+				ulReadyCoRoutineGroups &= ~( 1UL << uxTopGroup );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
 		}
-		--uxTopCoRoutineReadyPriority;
+
+		listGET_OWNER_OF_NEXT_ENTRY( pxCurrentCoRoutine, &( pxReadyCoRoutineLists[ uxTopPriority ] ) );
 	}
+	#else
+	{
+		/* Find the highest priority queue that contains ready co-routines. */
+		while( listLIST_IS_EMPTY( &( pxReadyCoRoutineLists[ uxTopCoRoutineReadyPriority ] ) ) )
+		{
+			if( uxTopCoRoutineReadyPriority == 0 )
+			{
+				/* No more co-routines to check. */
+				return;
+			}
+			--uxTopCoRoutineReadyPriority;
+		}
 
-	/* listGET_OWNER_OF_NEXT_ENTRY walks through the list, so the co-routines
-	 of the	same priority get an equal share of the processor time. */
-	listGET_OWNER_OF_NEXT_ENTRY( pxCurrentCoRoutine, &( pxReadyCoRoutineLists[ uxTopCoRoutineReadyPriority ] ) );
+		/* listGET_OWNER_OF_NEXT_ENTRY walks through the list, so the co-routines
+		 of the	same priority get an equal share of the processor time. */
+		listGET_OWNER_OF_NEXT_ENTRY( pxCurrentCoRoutine, &( pxReadyCoRoutineLists[ uxTopCoRoutineReadyPriority ] ) );
+	}
+	#endif /* configUSE_CO_ROUTINE_PRIORITY_BITMAP */
 
 	/* Call the co-routine. */
 	( pxCurrentCoRoutine->pxCoRoutineFunction )( pxCurrentCoRoutine, pxCurrentCoRoutine->uxIndex );
@@ -314,14 +527,28 @@ UBaseType_t uxPriority;
 		vListInitialise( ( List_t * ) &( pxReadyCoRoutineLists[ uxPriority ] ) );
 	}
 
-	vListInitialise( ( List_t * ) &xDelayedCoRoutineList1 );
-	vListInitialise( ( List_t * ) &xDelayedCoRoutineList2 );
-	vListInitialise( ( List_t * ) &xPendingReadyCoRoutineList );
+	#if( configUSE_CO_ROUTINE_DELAY_WHEEL == 1 )
+	{
+	UBaseType_t uxSlot;
+
+		for( uxSlot = 0; uxSlot < ( UBaseType_t ) configCO_ROUTINE_DELAY_WHEEL_SLOTS; uxSlot++ )
+		{
+			vListInitialise( &( xDelayedCoRoutineWheel[ uxSlot ] ) );
+		}
+	}
+	#else
+	{
+		vListInitialise( ( List_t * ) &xDelayedCoRoutineList1 );
+		vListInitialise( ( List_t * ) &xDelayedCoRoutineList2 );
+
+		/* Start with pxDelayedCoRoutineList using list1 and the
+		pxOverflowDelayedCoRoutineList using list2. */
+		pxDelayedCoRoutineList = &xDelayedCoRoutineList1;
+		pxOverflowDelayedCoRoutineList = &xDelayedCoRoutineList2;
+	}
+	#endif /* configUSE_CO_ROUTINE_DELAY_WHEEL */
 
-	/* Start with pxDelayedCoRoutineList using list1 and the
-	pxOverflowDelayedCoRoutineList using list2. */
-	pxDelayedCoRoutineList = &xDelayedCoRoutineList1;
-	pxOverflowDelayedCoRoutineList = &xDelayedCoRoutineList2;
+	vListInitialise( ( List_t * ) &xPendingReadyCoRoutineList );
 }
 /*-----------------------------------------------------------*/
 
@@ -348,6 +575,97 @@ BaseType_t xReturn;
 
 	return xReturn;
 }
+/*-----------------------------------------------------------*/
+
+#if( configUSE_CO_ROUTINE_EVENT_GROUP_WAITS == 1 )
+
+	BaseType_t xCoRoutineRemoveFromUnorderedEventList( ListItem_t *pxEventListItem, const TickType_t xItemValue )
+	{
+	CRCB_t *pxUnblockedCRCB;
+	BaseType_t xReturn;
+
+		/* As xCoRoutineRemoveFromEventList(), this can be called from an
+		interrupt, or with interrupts masked, so it only accesses the event
+		list and the pending ready list.  The value is left in the event list
+		item for the co-routine to read with uxCoRoutineResetEventItemValue(). */
+		listSET_LIST_ITEM_VALUE( pxEventListItem, xItemValue );
+		pxUnblockedCRCB = ( CRCB_t * ) listGET_LIST_ITEM_OWNER( pxEventListItem );
+		( void ) uxListRemove( pxEventListItem );
+		vListInsertEnd( ( List_t * ) &( xPendingReadyCoRoutineList ), pxEventListItem );
+
+		if( pxUnblockedCRCB->uxPriority >= pxCurrentCoRoutine->uxPriority )
+		{
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			xReturn = pdFALSE;
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_CO_ROUTINE_EVENT_GROUP_WAITS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_CO_ROUTINE_EVENT_GROUP_WAITS == 1 )
+
+	TickType_t uxCoRoutineResetEventItemValue( void )
+	{
+	TickType_t uxReturn;
+
+		uxReturn = listGET_LIST_ITEM_VALUE( &( pxCurrentCoRoutine->xEventListItem ) );
+
+		/* Reset the event list item to its normal value - so it can be used
+		with queues again. */
+		listSET_LIST_ITEM_VALUE( &( pxCurrentCoRoutine->xEventListItem ), corEVENT_LIST_ITEM_VALUE( pxCurrentCoRoutine ) );
+
+		return uxReturn;
+	}
+
+#endif /* configUSE_CO_ROUTINE_EVENT_GROUP_WAITS */
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_CO_ROUTINE_PRIORITY_BITMAP == 1 ) && !defined( __GNUC__ ) )
+
+	static UBaseType_t prvHighestSetBit( uint32_t ulBits )
+	{
+	UBaseType_t uxBit = 0;
+
+		/* Binary search for the most significant set bit. */
+		if( ( ulBits & 0xFFFF0000UL ) != 0UL )
+		{
+			ulBits >>= 16U;
+			uxBit += 16U;
+		}
+
+		if( ( ulBits & 0x0000FF00UL ) != 0UL )
+		{
+			ulBits >>= 8U;
+			uxBit += 8U;
+		}
+
+		if( ( ulBits & 0x000000F0UL ) != 0UL )
+		{
+			ulBits >>= 4U;
+			uxBit += 4U;
+		}
+
+		if( ( ulBits & 0x0000000CUL ) != 0UL )
+		{
+			ulBits >>= 2U;
+			uxBit += 2U;
+		}
+
+		if( ( ulBits & 0x00000002UL ) != 0UL )
+		{
+			uxBit += 1U;
+		}
+
+		return uxBit;
+	}
+
+#endif /* ( configUSE_CO_ROUTINE_PRIORITY_BITMAP == 1 ) && !defined( __GNUC__ ) */
 
 #endif /* configUSE_CO_ROUTINES == 0 */
 
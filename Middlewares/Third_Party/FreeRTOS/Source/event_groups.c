@@ -39,6 +39,10 @@ task.h is included from an application file. */
 #include "timers.h"
 #include "event_groups.h"
 
+#if( configUSE_CO_ROUTINE_EVENT_GROUP_WAITS == 1 )
+	#include "croutine.h"
+#endif
+
 /* Lint e961, e750 and e9021 are suppressed as a MISRA exception justified
 because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
 for the header files above, but not in this file, in order to generate the
@@ -53,11 +57,13 @@ taskEVENT_LIST_ITEM_VALUE_IN_USE definition. */
 	#define eventUNBLOCKED_DUE_TO_BIT_SET	0x0200U
 	#define eventWAIT_FOR_ALL_BITS			0x0400U
 	#define eventEVENT_BITS_CONTROL_BYTES	0xff00U
+	#define eventNUMBER_OF_EVENT_BITS		8U
 #else
 	#define eventCLEAR_EVENTS_ON_EXIT_BIT	0x01000000UL
 	#define eventUNBLOCKED_DUE_TO_BIT_SET	0x02000000UL
 	#define eventWAIT_FOR_ALL_BITS			0x04000000UL
 	#define eventEVENT_BITS_CONTROL_BYTES	0xff000000UL
+	#define eventNUMBER_OF_EVENT_BITS		24U
 #endif
 
 typedef struct EventGroupDef_t
@@ -65,6 +71,20 @@ typedef struct EventGroupDef_t
 	EventBits_t uxEventBits;
 	List_t xTasksWaitingForBits;		/*< List of tasks waiting for a bit to be set. */
 
+	#if( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
+		List_t xTasksWaitingForBit[ eventNUMBER_OF_EVENT_BITS ];	/*< Lists of tasks that only need to be tested when a particular bit is set.  xTasksWaitingForBits then only holds tasks that wait for any one of several bits. */
+		EventBits_t uxBitsWaitedForInList;	/*< All the bits waited for by the tasks in xTasksWaitingForBits, and possibly bits that are no longer waited for. */
+	#endif
+
+	#if( configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR == 1 )
+		EventBits_t uxBitsSetFromISR;		/*< Bits set by interrupts while the scheduler was suspended, to be set when the scheduler is resumed.  Non-zero when the event group is in the pending list. */
+		struct EventGroupDef_t *pxNextPending;	/*< The next event group in the pending list. */
+	#endif
+
+	#if( configUSE_CO_ROUTINE_EVENT_GROUP_WAITS == 1 )
+		List_t xCoRoutinesWaitingForBits;	/*< List of co-routines waiting for a bit to be set. */
+	#endif
+
 	#if( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxEventGroupNumber;
 	#endif
@@ -74,6 +94,18 @@ typedef struct EventGroupDef_t
 	#endif
 } EventGroup_t;
 
+#if( configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR == 1 )
+
+	#if( ( INCLUDE_xTaskGetSchedulerState == 0 ) && ( configUSE_TIMERS == 0 ) )
+		#error configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR requires INCLUDE_xTaskGetSchedulerState or configUSE_TIMERS to be set to 1 in FreeRTOSConfig.h.
+	#endif
+
+	/* Event groups that had bits set from an interrupt while the scheduler was
+	suspended.  Only accessed with interrupts masked. */
+	PRIVILEGED_DATA static EventGroup_t * volatile pxPendingEventGroups = NULL;
+
+#endif /* configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR */
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -86,6 +118,65 @@ typedef struct EventGroupDef_t
  */
 static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, const EventBits_t uxBitsToWaitFor, const BaseType_t xWaitForAllBits ) PRIVILEGED_FUNCTION;
 
+/*
+ * Set uxBitsToSet in the event group, unblock the tasks whose wait condition is
+ * then met, and clear the bits the unblocked tasks asked to be cleared on exit.
+ * Must be called with the scheduler suspended, with pxHigherPriorityTaskWoken
+ * set to NULL, or from an interrupt (or with interrupts masked) while the
+ * scheduler is not suspended, in which case *pxHigherPriorityTaskWoken is set
+ * to pdTRUE if a task of higher priority than the running task was unblocked.
+ */
+static void prvSetBits( EventGroup_t *pxEventBits, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock the tasks in pxList whose wait condition is met by the current event
+ * bits, and return the bits that must be cleared because a task that was
+ * unblocked specified eventCLEAR_EVENTS_ON_EXIT_BIT.  Called from prvSetBits()
+ * with the same pxHigherPriorityTaskWoken.
+ */
+static EventBits_t prvUnblockWaitingTasks( EventGroup_t *pxEventBits, List_t *pxList, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock every task in pxList, returning 0 as the event group is being
+ * deleted.  Must be called with the scheduler suspended.
+ */
+static void prvUnblockAllTasks( const List_t *pxList ) PRIVILEGED_FUNCTION;
+
+#if( configUSE_CO_ROUTINE_EVENT_GROUP_WAITS == 1 )
+
+	/*
+	 * Unblock the co-routines whose wait condition is met by the current event
+	 * bits, and return the bits that must be cleared because a co-routine that
+	 * was unblocked asked for them to be cleared on exit.  Called from
+	 * prvSetBits() with the same pxHigherPriorityTaskWoken, which is only used
+	 * to tell whether interrupts are already masked.
+	 */
+	static EventBits_t prvUnblockWaitingCoRoutines( EventGroup_t *pxEventBits, const BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_CO_ROUTINE_EVENT_GROUP_WAITS */
+
+#if( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
+
+	/*
+	 * Return the list on which a task that waits for uxBitsWaitedFor, with the
+	 * behaviour set by uxControlBits, should block.  A task that waits for all
+	 * of its bits only needs testing when the lowest of its bits that is still
+	 * clear gets set, and a task that waits for a single bit only when that bit
+	 * gets set, so both are placed on the list for that bit.  A task that waits
+	 * for any one of several bits is placed in xTasksWaitingForBits, and its
+	 * bits are added to uxBitsWaitedForInList.  Must be called with the
+	 * scheduler suspended.
+	 */
+	static List_t *prvSelectWaitList( EventGroup_t *pxEventBits, const EventBits_t uxBitsWaitedFor, const EventBits_t uxControlBits ) PRIVILEGED_FUNCTION;
+
+	#define eventGET_WAIT_LIST( pxEventBits, uxBitsWaitedFor, uxControlBits ) prvSelectWaitList( ( pxEventBits ), ( uxBitsWaitedFor ), ( uxControlBits ) )
+
+#else
+
+	#define eventGET_WAIT_LIST( pxEventBits, uxBitsWaitedFor, uxControlBits ) ( &( ( pxEventBits )->xTasksWaitingForBits ) )
+
+#endif /* configUSE_EVENT_GROUP_WAITER_INDEX */
+
 /*-----------------------------------------------------------*/
 
 #if( configSUPPORT_STATIC_ALLOCATION == 1 )
@@ -115,6 +206,32 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, co
 			pxEventBits->uxEventBits = 0;
 			vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
 
+			#if( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
+			{
+			UBaseType_t uxBit;
+
+				for( uxBit = 0; uxBit < eventNUMBER_OF_EVENT_BITS; uxBit++ )
+				{
+					vListInitialise( &( pxEventBits->xTasksWaitingForBit[ uxBit ] ) );
+				}
+
+				pxEventBits->uxBitsWaitedForInList = 0;
+			}
+			#endif /* configUSE_EVENT_GROUP_WAITER_INDEX */
+
+			#if( configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR == 1 )
+			{
+				pxEventBits->uxBitsSetFromISR = 0;
+				pxEventBits->pxNextPending = NULL;
+			}
+			#endif /* configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR */
+
+			#if( configUSE_CO_ROUTINE_EVENT_GROUP_WAITS == 1 )
+			{
+				vListInitialise( &( pxEventBits->xCoRoutinesWaitingForBits ) );
+			}
+			#endif /* configUSE_CO_ROUTINE_EVENT_GROUP_WAITS */
+
 			#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
 			{
 				/* Both static and dynamic allocation can be used, so note that
@@ -166,6 +283,32 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, co
 			pxEventBits->uxEventBits = 0;
 			vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
 
+			#if( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
+			{
+			UBaseType_t uxBit;
+
+				for( uxBit = 0; uxBit < eventNUMBER_OF_EVENT_BITS; uxBit++ )
+				{
+					vListInitialise( &( pxEventBits->xTasksWaitingForBit[ uxBit ] ) );
+				}
+
+				pxEventBits->uxBitsWaitedForInList = 0;
+			}
+			#endif /* configUSE_EVENT_GROUP_WAITER_INDEX */
+
+			#if( configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR == 1 )
+			{
+				pxEventBits->uxBitsSetFromISR = 0;
+				pxEventBits->pxNextPending = NULL;
+			}
+			#endif /* configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR */
+
+			#if( configUSE_CO_ROUTINE_EVENT_GROUP_WAITS == 1 )
+			{
+				vListInitialise( &( pxEventBits->xCoRoutinesWaitingForBits ) );
+			}
+			#endif /* configUSE_CO_ROUTINE_EVENT_GROUP_WAITS */
+
 			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
 			{
 				/* Both static and dynamic allocation can be used, so note this
@@ -229,7 +372,7 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 				/* Store the bits that the calling task is waiting for in the
 				task's event list item so the kernel knows when a match is
 				found.  Then enter the blocked state. */
-				vTaskPlaceOnUnorderedEventList( &( pxEventBits->xTasksWaitingForBits ), ( uxBitsToWaitFor | eventCLEAR_EVENTS_ON_EXIT_BIT | eventWAIT_FOR_ALL_BITS ), xTicksToWait );
+				vTaskPlaceOnUnorderedEventList( eventGET_WAIT_LIST( pxEventBits, uxBitsToWaitFor, eventWAIT_FOR_ALL_BITS ), ( uxBitsToWaitFor | eventCLEAR_EVENTS_ON_EXIT_BIT | eventWAIT_FOR_ALL_BITS ), xTicksToWait );
 
 				/* This assignment is obsolete as uxReturn will get set after
 				the task unblocks, but some compilers mistakenly generate a
@@ -384,7 +527,7 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 			/* Store the bits that the calling task is waiting for in the
 			task's event list item so the kernel knows when a match is
 			found.  Then enter the blocked state. */
-			vTaskPlaceOnUnorderedEventList( &( pxEventBits->xTasksWaitingForBits ), ( uxBitsToWaitFor | uxControlBits ), xTicksToWait );
+			vTaskPlaceOnUnorderedEventList( eventGET_WAIT_LIST( pxEventBits, uxBitsToWaitFor, uxControlBits ), ( uxBitsToWaitFor | uxControlBits ), xTicksToWait );
 
 			/* This is obsolete as it will get set after the task unblocks, but
 			some compilers mistakenly generate a warning about the variable
@@ -518,114 +661,88 @@ EventBits_t uxReturn;
 
 EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet )
 {
-ListItem_t *pxListItem, *pxNext;
-ListItem_t const *pxListEnd;
-List_t const * pxList;
-EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits;
 EventGroup_t *pxEventBits = xEventGroup;
-BaseType_t xMatchFound = pdFALSE;
 
 	/* Check the user is not attempting to set the bits used by the kernel
 	itself. */
 	configASSERT( xEventGroup );
 	configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
 
-	pxList = &( pxEventBits->xTasksWaitingForBits );
-	pxListEnd = listGET_END_MARKER( pxList ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
 	vTaskSuspendAll();
 	{
 		traceEVENT_GROUP_SET_BITS( xEventGroup, uxBitsToSet );
+		prvSetBits( pxEventBits, uxBitsToSet, NULL );
+	}
+	( void ) xTaskResumeAll();
 
-		pxListItem = listGET_HEAD_ENTRY( pxList );
+	return pxEventBits->uxEventBits;
+}
+/*-----------------------------------------------------------*/
 
-		/* Set the bits. */
-		pxEventBits->uxEventBits |= uxBitsToSet;
+void vEventGroupDelete( EventGroupHandle_t xEventGroup )
+{
+EventGroup_t *pxEventBits = xEventGroup;
 
-		/* See if the new bit value should unblock any tasks. */
-		while( pxListItem != pxListEnd )
+	vTaskSuspendAll();
+	{
+		traceEVENT_GROUP_DELETE( xEventGroup );
+
+		prvUnblockAllTasks( &( pxEventBits->xTasksWaitingForBits ) );
+
+		#if( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
 		{
-			pxNext = listGET_NEXT( pxListItem );
-			uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
-			xMatchFound = pdFALSE;
+		UBaseType_t uxBit;
 
-			/* Split the bits waited for from the control bits. */
-			uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
-			uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+			for( uxBit = 0; uxBit < eventNUMBER_OF_EVENT_BITS; uxBit++ )
+			{
+				prvUnblockAllTasks( &( pxEventBits->xTasksWaitingForBit[ uxBit ] ) );
+			}
+		}
+		#endif /* configUSE_EVENT_GROUP_WAITER_INDEX */
 
-			if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
+		#if( configUSE_CO_ROUTINE_EVENT_GROUP_WAITS == 1 )
+		{
+			/* Co-routines are unblocked in the same way as tasks, with 0 as
+			the event group's value.  The pending ready list is also accessed
+			by interrupts. */
+			taskENTER_CRITICAL();
 			{
-				/* Just looking for single bit being set. */
-				if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
+				while( listLIST_IS_EMPTY( &( pxEventBits->xCoRoutinesWaitingForBits ) ) == pdFALSE )
 				{
-					xMatchFound = pdTRUE;
+					( void ) xCoRoutineRemoveFromUnorderedEventList( listGET_HEAD_ENTRY( &( pxEventBits->xCoRoutinesWaitingForBits ) ), eventUNBLOCKED_DUE_TO_BIT_SET );
 				}
-				else
-				{
-					mtCOVERAGE_TEST_MARKER();
-				}
-			}
-			else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
-			{
-				/* All bits are set. */
-				xMatchFound = pdTRUE;
-			}
-			else
-			{
-				/* Need all bits to be set, but not all the bits were set. */
 			}
+			taskEXIT_CRITICAL();
+		}
+		#endif /* configUSE_CO_ROUTINE_EVENT_GROUP_WAITS */
 
-			if( xMatchFound != pdFALSE )
+		#if( configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR == 1 )
+		{
+		EventGroup_t * volatile *ppxPending;
+
+			/* Bits set by an interrupt while the scheduler was suspended have
+			not been applied yet, so remove the event group from the pending
+			list. */
+			taskENTER_CRITICAL();
 			{
-				/* The bits match.  Should the bits be cleared on exit? */
-				if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+				if( pxEventBits->uxBitsSetFromISR != ( EventBits_t ) 0 )
 				{
-					uxBitsToClear |= uxBitsWaitedFor;
+					for( ppxPending = &pxPendingEventGroups; *ppxPending != pxEventBits; ppxPending = &( ( *ppxPending )->pxNextPending ) )
+					{
+						/* Nothing to do here, just iterate to the event group. */
+					}
+
+					*ppxPending = pxEventBits->pxNextPending;
+					pxEventBits->uxBitsSetFromISR = 0;
 				}
 				else
 				{
 					mtCOVERAGE_TEST_MARKER();
 				}
-
-				/* Store the actual event flag value in the task's event list
-				item before removing the task from the event list.  The
-				eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
-				that is was unblocked due to its required bits matching, rather
-				than because it timed out. */
-				vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
 			}
-
-			/* Move onto the next list item.  Note pxListItem->pxNext is not
-			used here as the list item may have been removed from the event list
-			and inserted into the ready/pending reading list. */
-			pxListItem = pxNext;
-		}
-
-		/* Clear any bits that matched when the eventCLEAR_EVENTS_ON_EXIT_BIT
-		bit was set in the control word. */
-		pxEventBits->uxEventBits &= ~uxBitsToClear;
-	}
-	( void ) xTaskResumeAll();
-
-	return pxEventBits->uxEventBits;
-}
-/*-----------------------------------------------------------*/
-
-void vEventGroupDelete( EventGroupHandle_t xEventGroup )
-{
-EventGroup_t *pxEventBits = xEventGroup;
-const List_t *pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
-
-	vTaskSuspendAll();
-	{
-		traceEVENT_GROUP_DELETE( xEventGroup );
-
-		while( listCURRENT_LIST_LENGTH( pxTasksWaitingForBits ) > ( UBaseType_t ) 0 )
-		{
-			/* Unblock the task, returning 0 as the event list is being deleted
-			and cannot therefore have any bits set. */
-			configASSERT( pxTasksWaitingForBits->xListEnd.pxNext != ( const ListItem_t * ) &( pxTasksWaitingForBits->xListEnd ) );
-			vTaskRemoveFromUnorderedEventList( pxTasksWaitingForBits->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
+			taskEXIT_CRITICAL();
 		}
+		#endif /* configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR */
 
 		#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
 		{
@@ -703,7 +820,484 @@ BaseType_t xWaitConditionMet = pdFALSE;
 }
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+static void prvSetBits( EventGroup_t *pxEventBits, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken )
+{
+EventBits_t uxBitsToClear;
+
+	/* Set the bits. */
+	pxEventBits->uxEventBits |= uxBitsToSet;
+
+	#if( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
+	{
+	EventBits_t uxBitsRemaining = uxBitsToSet;
+	UBaseType_t uxBit;
+
+		uxBitsToClear = 0;
+
+		/* Only the tasks placed on the lists of the bits being set can
+		have had their wait condition met. */
+		for( uxBit = 0; uxBitsRemaining != ( EventBits_t ) 0; uxBit++ )
+		{
+			if( ( uxBitsRemaining & ( ( EventBits_t ) 1 << uxBit ) ) != ( EventBits_t ) 0 )
+			{
+				uxBitsRemaining &= ~( ( EventBits_t ) 1 << uxBit );
+				uxBitsToClear |= prvUnblockWaitingTasks( pxEventBits, &( pxEventBits->xTasksWaitingForBit[ uxBit ] ), pxHigherPriorityTaskWoken );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		/* The tasks that wait for any one of several bits only need to be
+		tested if one of those bits is being set.  uxBitsWaitedForInList is
+		rebuilt from the tasks that remain blocked. */
+		if( ( uxBitsToSet & pxEventBits->uxBitsWaitedForInList ) != ( EventBits_t ) 0 )
+		{
+			pxEventBits->uxBitsWaitedForInList = 0;
+			uxBitsToClear |= prvUnblockWaitingTasks( pxEventBits, &( pxEventBits->xTasksWaitingForBits ), pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#else
+	{
+		/* See if the new bit value should unblock any tasks. */
+		uxBitsToClear = prvUnblockWaitingTasks( pxEventBits, &( pxEventBits->xTasksWaitingForBits ), pxHigherPriorityTaskWoken );
+	}
+	#endif /* configUSE_EVENT_GROUP_WAITER_INDEX */
+
+	#if( configUSE_CO_ROUTINE_EVENT_GROUP_WAITS == 1 )
+	{
+		/* Co-routines are tested against the same bits as tasks, as the bits
+		are only cleared below. */
+		uxBitsToClear |= prvUnblockWaitingCoRoutines( pxEventBits, pxHigherPriorityTaskWoken );
+	}
+	#endif /* configUSE_CO_ROUTINE_EVENT_GROUP_WAITS */
+
+	/* Clear any bits that matched when the eventCLEAR_EVENTS_ON_EXIT_BIT
+	bit was set in the control word. */
+	pxEventBits->uxEventBits &= ~uxBitsToClear;
+}
+/*-----------------------------------------------------------*/
+
+static EventBits_t prvUnblockWaitingTasks( EventGroup_t *pxEventBits, List_t *pxList, BaseType_t *pxHigherPriorityTaskWoken )
+{
+ListItem_t *pxListItem, *pxNext;
+ListItem_t const *pxListEnd = listGET_END_MARKER( pxList ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
+EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits;
+BaseType_t xMatchFound;
+
+	pxListItem = listGET_HEAD_ENTRY( pxList );
+
+	while( pxListItem != pxListEnd )
+	{
+		pxNext = listGET_NEXT( pxListItem );
+		uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
+		xMatchFound = pdFALSE;
+
+		/* Split the bits waited for from the control bits. */
+		uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
+		uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+
+		if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
+		{
+			/* Just looking for single bit being set. */
+			if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
+			{
+				xMatchFound = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
+		{
+			/* All bits are set. */
+			xMatchFound = pdTRUE;
+		}
+		else
+		{
+			/* Need all bits to be set, but not all the bits were set. */
+		}
+
+		if( xMatchFound != pdFALSE )
+		{
+			/* The bits match.  Should the bits be cleared on exit? */
+			if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+			{
+				uxBitsToClear |= uxBitsWaitedFor;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Store the actual event flag value in the task's event list
+			item before removing the task from the event list.  The
+			eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
+			that is was unblocked due to its required bits matching, rather
+			than because it timed out. */
+			#if( configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR == 1 )
+			{
+				if( pxHigherPriorityTaskWoken != NULL )
+				{
+					if( xTaskRemoveFromUnorderedEventListFromISR( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET ) != pdFALSE )
+					{
+						*pxHigherPriorityTaskWoken = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
+				}
+			}
+			#else
+			{
+				( void ) pxHigherPriorityTaskWoken;
+				vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
+			}
+			#endif /* configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR */
+		}
+		else
+		{
+			#if( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
+			{
+			List_t *pxWaitList;
+
+				/* The task remains blocked.  If it waits for all of its bits
+				then the bit it was placed under has just been set, so move it
+				to the list of a bit that is still clear.  If it waits for any
+				one of several bits then its bits are added back into
+				uxBitsWaitedForInList. */
+				pxWaitList = prvSelectWaitList( pxEventBits, uxBitsWaitedFor, uxControlBits );
+
+				if( pxWaitList != pxList )
+				{
+					( void ) uxListRemove( pxListItem );
+					vListInsertEnd( pxWaitList, pxListItem );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configUSE_EVENT_GROUP_WAITER_INDEX */
+		}
+
+		/* Move onto the next list item.  Note pxListItem->pxNext is not
+		used here as the list item may have been removed from the event list
+		and inserted into the ready/pending reading list. */
+		pxListItem = pxNext;
+	}
+
+	return uxBitsToClear;
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnblockAllTasks( const List_t *pxList )
+{
+	while( listCURRENT_LIST_LENGTH( pxList ) > ( UBaseType_t ) 0 )
+	{
+		/* Unblock the task, returning 0 as the event list is being deleted
+		and cannot therefore have any bits set. */
+		configASSERT( pxList->xListEnd.pxNext != ( const ListItem_t * ) &( pxList->xListEnd ) );
+		vTaskRemoveFromUnorderedEventList( pxList->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_CO_ROUTINE_EVENT_GROUP_WAITS == 1 )
+
+	static EventBits_t prvUnblockWaitingCoRoutines( EventGroup_t *pxEventBits, const BaseType_t *pxHigherPriorityTaskWoken )
+	{
+	List_t * const pxList = &( pxEventBits->xCoRoutinesWaitingForBits );
+	ListItem_t const *pxListEnd = listGET_END_MARKER( pxList ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
+	ListItem_t *pxListItem, *pxNext;
+	EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits;
+	BaseType_t xWaitForAllBits;
+
+		/* A co-routine is only placed in the list with interrupts disabled, and
+		only from a task, which cannot run while the scheduler is suspended or
+		interrupts are masked. */
+		if( listLIST_IS_EMPTY( pxList ) == pdFALSE )
+		{
+			/* When called from a task the list must still be protected from
+			interrupts, which can set bits directly and access the co-routine
+			pending ready list. */
+			if( pxHigherPriorityTaskWoken == NULL )
+			{
+				taskENTER_CRITICAL();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			for( pxListItem = listGET_HEAD_ENTRY( pxList ); pxListItem != pxListEnd; pxListItem = pxNext )
+			{
+				pxNext = listGET_NEXT( pxListItem );
+				uxBitsWaitedFor = ( EventBits_t ) listGET_LIST_ITEM_VALUE( pxListItem );
+
+				/* Split the bits waited for from the control bits. */
+				uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
+				uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+
+				if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) != ( EventBits_t ) 0 )
+				{
+					xWaitForAllBits = pdTRUE;
+				}
+				else
+				{
+					xWaitForAllBits = pdFALSE;
+				}
+
+				if( prvTestWaitCondition( pxEventBits->uxEventBits, uxBitsWaitedFor, xWaitForAllBits ) != pdFALSE )
+				{
+					if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+					{
+						uxBitsToClear |= uxBitsWaitedFor;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					/* As for tasks, the co-routine finds the event bits in its
+					event list item with eventUNBLOCKED_DUE_TO_BIT_SET set.  No
+					context switch is needed as co-routines run from a task. */
+					( void ) xCoRoutineRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+
+			if( pxHigherPriorityTaskWoken == NULL )
+			{
+				taskEXIT_CRITICAL();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return uxBitsToClear;
+	}
+
+#endif /* configUSE_CO_ROUTINE_EVENT_GROUP_WAITS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_CO_ROUTINE_EVENT_GROUP_WAITS == 1 )
+
+	BaseType_t xEventGroupCRWaitBits( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToWaitFor, const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits, EventBits_t *puxEventBits, TickType_t xTicksToWait )
+	{
+	EventGroup_t *pxEventBits = xEventGroup;
+	EventBits_t uxReturn, uxControlBits = 0;
+	BaseType_t xReturn;
+
+		configASSERT( xEventGroup );
+		configASSERT( ( uxBitsToWaitFor & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+		configASSERT( uxBitsToWaitFor != 0 );
+		configASSERT( puxEventBits );
+
+		/* If the co-routine is running again after blocking, and was unblocked
+		because its bits were set, then the event bits were stored in its event
+		list item, and any bits to clear on exit have already been cleared. */
+		uxReturn = ( EventBits_t ) uxCoRoutineResetEventItemValue();
+
+		/* Interrupts are disabled so the bits cannot be set between the test
+		and the co-routine being placed in the event list. */
+		portDISABLE_INTERRUPTS();
+		{
+			if( ( uxReturn & eventUNBLOCKED_DUE_TO_BIT_SET ) != ( EventBits_t ) 0 )
+			{
+				uxReturn &= ~eventEVENT_BITS_CONTROL_BYTES;
+				xReturn = pdPASS;
+			}
+			else
+			{
+				uxReturn = pxEventBits->uxEventBits;
+
+				if( prvTestWaitCondition( uxReturn, uxBitsToWaitFor, xWaitForAllBits ) != pdFALSE )
+				{
+					if( xClearOnExit != pdFALSE )
+					{
+						pxEventBits->uxEventBits &= ~uxBitsToWaitFor;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					xReturn = pdPASS;
+				}
+				else if( xTicksToWait > ( TickType_t ) 0 )
+				{
+					/* As this is a co-routine we cannot block directly, but
+					return indicating that we need to block.  The bits being
+					waited for and the control bits are stored in the event
+					list item, as they are for a task. */
+					if( xClearOnExit != pdFALSE )
+					{
+						uxControlBits |= eventCLEAR_EVENTS_ON_EXIT_BIT;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					if( xWaitForAllBits != pdFALSE )
+					{
+						uxControlBits |= eventWAIT_FOR_ALL_BITS;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					vCoRoutineAddToUnorderedEventList( xTicksToWait, &( pxEventBits->xCoRoutinesWaitingForBits ), ( TickType_t ) ( uxBitsToWaitFor | uxControlBits ) );
+					xReturn = errQUEUE_BLOCKED;
+				}
+				else
+				{
+					xReturn = pdFAIL;
+				}
+			}
+		}
+		portENABLE_INTERRUPTS();
+
+		*puxEventBits = uxReturn;
+
+		return xReturn;
+	}
+
+#endif /* configUSE_CO_ROUTINE_EVENT_GROUP_WAITS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
+
+	static List_t *prvSelectWaitList( EventGroup_t *pxEventBits, const EventBits_t uxBitsWaitedFor, const EventBits_t uxControlBits )
+	{
+	EventBits_t uxKeyBits;
+	UBaseType_t uxBit;
+	List_t *pxList;
+
+		if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) != ( EventBits_t ) 0 )
+		{
+			/* The task cannot unblock until all the bits it waits for that
+			are still clear have been set. */
+			uxKeyBits = uxBitsWaitedFor & ~( pxEventBits->uxEventBits );
+		}
+		else
+		{
+			uxKeyBits = uxBitsWaitedFor;
+		}
+
+		configASSERT( uxKeyBits != ( EventBits_t ) 0 );
+
+		if( ( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 ) && ( ( uxKeyBits & ( uxKeyBits - ( EventBits_t ) 1 ) ) != ( EventBits_t ) 0 ) )
+		{
+			/* Any one of several bits unblocks the task, so it has to be
+			tested whenever one of them is set. */
+			pxEventBits->uxBitsWaitedForInList |= uxBitsWaitedFor;
+			pxList = &( pxEventBits->xTasksWaitingForBits );
+		}
+		else
+		{
+			for( uxBit = 0; ( uxKeyBits & ( ( EventBits_t ) 1 << uxBit ) ) == ( EventBits_t ) 0; uxBit++ )
+			{
+				/* Nothing to do here, just iterate to the lowest key bit. */
+			}
+
+			pxList = &( pxEventBits->xTasksWaitingForBit[ uxBit ] );
+		}
+
+		return pxList;
+	}
+
+#endif /* configUSE_EVENT_GROUP_WAITER_INDEX */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR == 1 )
+
+	BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken )
+	{
+	EventGroup_t *pxEventBits = xEventGroup;
+	UBaseType_t uxSavedInterruptStatus;
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+		configASSERT( xEventGroup );
+		configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+
+		/* Only interrupts at or below the maximum system call interrupt
+		priority can call FreeRTOS API functions - see the comment in
+		xQueueGenericSendFromISR() in queue.c. */
+		portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			traceEVENT_GROUP_SET_BITS_FROM_ISR( xEventGroup, uxBitsToSet );
+
+			if( xTaskGetSchedulerState() != taskSCHEDULER_SUSPENDED )
+			{
+				/* No task can be accessing the event lists, so the bits can be
+				set and the waiting tasks unblocked now, as the tick interrupt
+				does for tasks that time out. */
+				prvSetBits( pxEventBits, uxBitsToSet, &xHigherPriorityTaskWoken );
+			}
+			else if( uxBitsToSet != ( EventBits_t ) 0 )
+			{
+				/* A task is accessing the event lists, so hold the bits until
+				the scheduler is resumed.  uxBitsSetFromISR being zero shows the
+				event group is not already in the pending list. */
+				if( pxEventBits->uxBitsSetFromISR == ( EventBits_t ) 0 )
+				{
+					pxEventBits->pxNextPending = pxPendingEventGroups;
+					pxPendingEventGroups = pxEventBits;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				pxEventBits->uxBitsSetFromISR |= uxBitsToSet;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		if( ( pxHigherPriorityTaskWoken != NULL ) && ( xHigherPriorityTaskWoken != pdFALSE ) )
+		{
+			*pxHigherPriorityTaskWoken = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* The bits are always either set or held, there is no queue that can
+		be full. */
+		return pdPASS;
+	}
+
+#elif ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
 
 	BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken )
 	{
@@ -718,6 +1312,35 @@ BaseType_t xWaitConditionMet = pdFALSE;
 #endif
 /*-----------------------------------------------------------*/
 
+#if( configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR == 1 )
+
+	/* For internal use only - called by xTaskResumeAll() with interrupts
+	masked once the scheduler is no longer suspended, to set the bits that were
+	set from interrupts while the scheduler was suspended. */
+	void vEventGroupSetBitsPendedFromISR( void )
+	{
+	EventGroup_t *pxEventBits;
+	EventBits_t uxBitsToSet;
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+		while( pxPendingEventGroups != NULL )
+		{
+			pxEventBits = pxPendingEventGroups;
+			pxPendingEventGroups = pxEventBits->pxNextPending;
+
+			uxBitsToSet = pxEventBits->uxBitsSetFromISR;
+			pxEventBits->uxBitsSetFromISR = 0;
+
+			/* The unblocked tasks are placed in the ready lists, and any of
+			higher priority than the running task sets the yield pending flag
+			that xTaskResumeAll() tests next. */
+			prvSetBits( pxEventBits, uxBitsToSet, &xHigherPriorityTaskWoken );
+		}
+	}
+
+#endif /* configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR */
+/*-----------------------------------------------------------*/
+
 #if (configUSE_TRACE_FACILITY == 1)
 
 	UBaseType_t uxEventGroupGetNumber( void* xEventGroup )
@@ -312,6 +312,16 @@ hold explicit before calling the code. */
 	#define portPOINTER_SIZE_TYPE uint32_t
 #endif
 
+#ifndef configUSE_TRACE_RECORDER
+	#define configUSE_TRACE_RECORDER 0
+#endif
+
+#if ( configUSE_TRACE_RECORDER == 1 )
+	/* The built in trace recorder defines the trace macros it uses, so must be
+	included before the unused trace macros are removed below. */
+	#include "trace_recorder.h"
+#endif
+
 /* Remove any unused trace macros. */
 #ifndef traceSTART
 	/* Used to perform any necessary initialisation - for example, open a file
@@ -524,6 +534,10 @@ hold explicit before calling the code. */
 	#define traceTASK_DELAY_UNTIL( x )
 #endif
 
+#ifndef traceTASK_DEADLINE_MISSED
+	#define traceTASK_DEADLINE_MISSED( pxTask )
+#endif
+
 #ifndef traceTASK_DELAY
 	#define traceTASK_DELAY()
 #endif
@@ -712,6 +726,82 @@ hold explicit before calling the code. */
 	#define traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength )
 #endif
 
+#ifndef traceADAPTIVE_MUTEX_CREATE
+	#define traceADAPTIVE_MUTEX_CREATE( pxMutex )
+#endif
+
+#ifndef traceADAPTIVE_MUTEX_CREATE_FAILED
+	#define traceADAPTIVE_MUTEX_CREATE_FAILED()
+#endif
+
+#ifndef traceADAPTIVE_MUTEX_TAKE
+	#define traceADAPTIVE_MUTEX_TAKE( pxMutex )
+#endif
+
+#ifndef traceADAPTIVE_MUTEX_TAKE_FAILED
+	#define traceADAPTIVE_MUTEX_TAKE_FAILED( pxMutex )
+#endif
+
+#ifndef traceBLOCKING_ON_ADAPTIVE_MUTEX_TAKE
+	#define traceBLOCKING_ON_ADAPTIVE_MUTEX_TAKE( pxMutex )
+#endif
+
+#ifndef traceADAPTIVE_MUTEX_GIVE
+	#define traceADAPTIVE_MUTEX_GIVE( pxMutex )
+#endif
+
+#ifndef traceADAPTIVE_MUTEX_DELETE
+	#define traceADAPTIVE_MUTEX_DELETE( pxMutex )
+#endif
+
+#ifndef traceRW_LOCK_CREATE
+	#define traceRW_LOCK_CREATE( pxLock )
+#endif
+
+#ifndef traceRW_LOCK_CREATE_FAILED
+	#define traceRW_LOCK_CREATE_FAILED()
+#endif
+
+#ifndef traceRW_LOCK_TAKE
+	#define traceRW_LOCK_TAKE( pxLock, xIsWrite )
+#endif
+
+#ifndef traceRW_LOCK_TAKE_FAILED
+	#define traceRW_LOCK_TAKE_FAILED( pxLock, xIsWrite )
+#endif
+
+#ifndef traceBLOCKING_ON_RW_LOCK_TAKE
+	#define traceBLOCKING_ON_RW_LOCK_TAKE( pxLock, xIsWrite )
+#endif
+
+#ifndef traceRW_LOCK_GIVE
+	#define traceRW_LOCK_GIVE( pxLock, xIsWrite )
+#endif
+
+#ifndef traceRW_LOCK_DELETE
+	#define traceRW_LOCK_DELETE( pxLock )
+#endif
+
+#ifndef traceQUEUE_WAIT_SET_CREATE
+	#define traceQUEUE_WAIT_SET_CREATE( pxWaitSet )
+#endif
+
+#ifndef traceQUEUE_WAIT_SET_CREATE_FAILED
+	#define traceQUEUE_WAIT_SET_CREATE_FAILED()
+#endif
+
+#ifndef traceQUEUE_WAIT_FOR_ANY
+	#define traceQUEUE_WAIT_FOR_ANY( pxWaitSet, ulReadyBits )
+#endif
+
+#ifndef traceBLOCKING_ON_QUEUE_WAIT_SET
+	#define traceBLOCKING_ON_QUEUE_WAIT_SET( pxWaitSet )
+#endif
+
+#ifndef traceQUEUE_WAIT_SET_DELETE
+	#define traceQUEUE_WAIT_SET_DELETE( pxWaitSet )
+#endif
+
 #ifndef configGENERATE_RUN_TIME_STATS
 	#define configGENERATE_RUN_TIME_STATS 0
 #endif
@@ -834,10 +924,131 @@ hold explicit before calling the code. */
 	#define configUSE_TASK_NOTIFICATIONS 1
 #endif
 
+#ifndef configTASK_NOTIFICATION_ARRAY_ENTRIES
+	#define configTASK_NOTIFICATION_ARRAY_ENTRIES 1
+#endif
+
+#if configTASK_NOTIFICATION_ARRAY_ENTRIES < 1
+	#error configTASK_NOTIFICATION_ARRAY_ENTRIES must be at least 1
+#endif
+
 #ifndef configUSE_POSIX_ERRNO
 	#define configUSE_POSIX_ERRNO 0
 #endif
 
+#ifndef configUSE_DELAYED_TASK_HEAP
+	#define configUSE_DELAYED_TASK_HEAP 0
+#endif
+
+#ifndef configUSE_TIMER_WHEEL
+	#define configUSE_TIMER_WHEEL 0
+#endif
+
+#ifndef configUSE_LOCK_FREE_STREAM_BUFFERS
+	#define configUSE_LOCK_FREE_STREAM_BUFFERS 0
+#endif
+
+#ifndef configUSE_HEAP_REGION_CAPABILITIES
+	#define configUSE_HEAP_REGION_CAPABILITIES 0
+#endif
+
+#ifndef configTASK_STACK_HEAP_CAPABILITIES
+	/* The portHEAP_CAPABILITY_... bits of the memory used for the stacks of
+	tasks created using xTaskCreate(). */
+	#define configTASK_STACK_HEAP_CAPABILITIES 0
+#endif
+
+#ifndef configQUEUE_STORAGE_HEAP_CAPABILITIES
+	/* The portHEAP_CAPABILITY_... bits of the memory used for queues created
+	using xQueueCreate() and the other dynamic queue and semaphore create
+	functions. */
+	#define configQUEUE_STORAGE_HEAP_CAPABILITIES 0
+#endif
+
+#ifndef configUSE_HEAP_TASK_CACHE
+	#define configUSE_HEAP_TASK_CACHE 0
+#endif
+
+#ifndef configHEAP_TASK_CACHE_TLS_INDEX
+	/* The thread local storage pointer used by heap_4.c to hold the cache of
+	each task.  Defaults to the last pointer. */
+	#define configHEAP_TASK_CACHE_TLS_INDEX ( configNUM_THREAD_LOCAL_STORAGE_POINTERS - 1 )
+#endif
+
+#ifndef configHEAP_TASK_CACHE_DEPTH
+	/* The maximum number of blocks of each size held in the cache of each
+	task. */
+	#define configHEAP_TASK_CACHE_DEPTH 8
+#endif
+
+#ifndef configUSE_EVENT_GROUP_WAITER_INDEX
+	#define configUSE_EVENT_GROUP_WAITER_INDEX 0
+#endif
+
+#ifndef configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR
+	#define configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR 0
+#endif
+
+#ifndef configUSE_DYNAMIC_TICK
+	#define configUSE_DYNAMIC_TICK 0
+#endif
+
+#ifndef configUSE_PRIORITY_BITMAP_TASK_SELECTION
+	#define configUSE_PRIORITY_BITMAP_TASK_SELECTION 0
+#endif
+
+#ifndef configUSE_EDF_SCHEDULING
+	#define configUSE_EDF_SCHEDULING 0
+#endif
+
+#ifndef configUSE_STACK_WATERMARK_TRACKING
+	#define configUSE_STACK_WATERMARK_TRACKING 0
+#endif
+
+#ifndef configSTACK_WATERMARK_GAP_WORDS
+	#define configSTACK_WATERMARK_GAP_WORDS 16
+#endif
+
+#ifndef configUSE_TASK_POOLS
+	#define configUSE_TASK_POOLS 0
+#endif
+
+#ifndef configUSE_ADAPTIVE_MUTEXES
+	#define configUSE_ADAPTIVE_MUTEXES 0
+#endif
+
+#ifndef configADAPTIVE_MUTEX_YIELD_LIMIT
+	#define configADAPTIVE_MUTEX_YIELD_LIMIT 2
+#endif
+
+#ifndef configUSE_RW_LOCKS
+	#define configUSE_RW_LOCKS 0
+#endif
+
+#ifndef configUSE_QUEUE_WAIT_SETS
+	#define configUSE_QUEUE_WAIT_SETS 0
+#endif
+
+#ifndef configUSE_CO_ROUTINE_PRIORITY_BITMAP
+	#define configUSE_CO_ROUTINE_PRIORITY_BITMAP 0
+#endif
+
+#ifndef configUSE_CO_ROUTINE_DELAY_WHEEL
+	#define configUSE_CO_ROUTINE_DELAY_WHEEL 0
+#endif
+
+#ifndef configCO_ROUTINE_DELAY_WHEEL_SLOTS
+	#define configCO_ROUTINE_DELAY_WHEEL_SLOTS 32
+#endif
+
+#ifndef configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS
+	#define configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS 0
+#endif
+
+#ifndef configUSE_CO_ROUTINE_EVENT_GROUP_WAITS
+	#define configUSE_CO_ROUTINE_EVENT_GROUP_WAITS 0
+#endif
+
 #ifndef portTICK_TYPE_IS_ATOMIC
 	#define portTICK_TYPE_IS_ATOMIC 0
 #endif
@@ -872,6 +1083,76 @@ hold explicit before calling the code. */
 	#endif /* INCLUDE_vTaskSuspend */
 #endif /* configUSE_TICKLESS_IDLE */
 
+#if( configUSE_DYNAMIC_TICK == 1 )
+	#if( configUSE_TICKLESS_IDLE != 0 )
+		#error configUSE_TICKLESS_IDLE must be set to 0 if configUSE_DYNAMIC_TICK is set to 1, as the tick interrupt is already only generated when it is needed
+	#endif
+
+	#ifndef portSET_TICK_DEADLINE
+		#error configUSE_DYNAMIC_TICK is set to 1 but the port does not provide a one-shot tick timer.  See portGET_UNANNOUNCED_TICKS(), portANNOUNCE_TICKS() and portSET_TICK_DEADLINE().
+	#endif
+#endif /* configUSE_DYNAMIC_TICK */
+
+#if( configUSE_PRIORITY_BITMAP_TASK_SELECTION == 1 )
+	#if( configUSE_PORT_OPTIMISED_TASK_SELECTION != 0 )
+		#error configUSE_PORT_OPTIMISED_TASK_SELECTION must be set to 0 in FreeRTOSConfig.h if configUSE_PRIORITY_BITMAP_TASK_SELECTION is set to 1
+	#endif
+
+	#if( configMAX_PRIORITIES > 1024 )
+		#error configMAX_PRIORITIES must not be greater than 1024 if configUSE_PRIORITY_BITMAP_TASK_SELECTION is set to 1
+	#endif
+#endif /* configUSE_PRIORITY_BITMAP_TASK_SELECTION */
+
+#if( configUSE_EDF_SCHEDULING == 1 )
+	#ifndef configEDF_TASK_PRIORITY
+		#error configEDF_TASK_PRIORITY must be defined in FreeRTOSConfig.h if configUSE_EDF_SCHEDULING is set to 1
+	#endif
+
+	#if( ( configEDF_TASK_PRIORITY < 1 ) || ( configEDF_TASK_PRIORITY >= configMAX_PRIORITIES ) )
+		#error configEDF_TASK_PRIORITY must be above the idle priority and less than configMAX_PRIORITIES
+	#endif
+#endif /* configUSE_EDF_SCHEDULING */
+
+#if( configUSE_TASK_POOLS == 1 )
+	#if( configSUPPORT_DYNAMIC_ALLOCATION != 1 )
+		#error configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 in FreeRTOSConfig.h if configUSE_TASK_POOLS is set to 1
+	#endif
+
+	#if( INCLUDE_vTaskDelete != 1 )
+		#error INCLUDE_vTaskDelete must be set to 1 in FreeRTOSConfig.h if configUSE_TASK_POOLS is set to 1
+	#endif
+#endif /* configUSE_TASK_POOLS */
+
+#if( ( configUSE_ADAPTIVE_MUTEXES == 1 ) && ( configUSE_MUTEXES != 1 ) )
+	#error configUSE_MUTEXES must be set to 1 in FreeRTOSConfig.h if configUSE_ADAPTIVE_MUTEXES is set to 1
+#endif
+
+#if( ( configUSE_RW_LOCKS == 1 ) && ( configUSE_MUTEXES != 1 ) )
+	#error configUSE_MUTEXES must be set to 1 in FreeRTOSConfig.h if configUSE_RW_LOCKS is set to 1
+#endif
+
+#if( ( configUSE_QUEUE_WAIT_SETS == 1 ) && ( configUSE_TASK_NOTIFICATIONS != 1 ) )
+	#error configUSE_TASK_NOTIFICATIONS must be set to 1 in FreeRTOSConfig.h if configUSE_QUEUE_WAIT_SETS is set to 1
+#endif
+
+#if( ( configUSE_QUEUE_WAIT_SETS == 1 ) && ( INCLUDE_xTaskGetCurrentTaskHandle != 1 ) && ( configUSE_MUTEXES != 1 ) )
+	#error Either INCLUDE_xTaskGetCurrentTaskHandle or configUSE_MUTEXES must be set to 1 in FreeRTOSConfig.h if configUSE_QUEUE_WAIT_SETS is set to 1
+#endif
+
+#if( ( configUSE_CO_ROUTINE_PRIORITY_BITMAP == 1 ) || ( configUSE_CO_ROUTINE_DELAY_WHEEL == 1 ) || ( configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS == 1 ) || ( configUSE_CO_ROUTINE_EVENT_GROUP_WAITS == 1 ) )
+	#if( configUSE_CO_ROUTINES != 1 )
+		#error configUSE_CO_ROUTINES must be set to 1 in FreeRTOSConfig.h if any of the configUSE_CO_ROUTINE_ options are set to 1
+	#endif
+#endif
+
+#if( ( configUSE_CO_ROUTINE_PRIORITY_BITMAP == 1 ) && ( configMAX_CO_ROUTINE_PRIORITIES > 1024 ) )
+	#error configMAX_CO_ROUTINE_PRIORITIES must not be greater than 1024 if configUSE_CO_ROUTINE_PRIORITY_BITMAP is set to 1
+#endif
+
+#if( ( configUSE_CO_ROUTINE_EVENT_GROUP_WAITS == 1 ) && ( configUSE_16_BIT_TICKS == 1 ) && ( configMAX_CO_ROUTINE_PRIORITIES > 255 ) )
+	#error configMAX_CO_ROUTINE_PRIORITIES must not be greater than 255 if configUSE_CO_ROUTINE_EVENT_GROUP_WAITS and configUSE_16_BIT_TICKS are set to 1
+#endif
+
 #if( ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 0 ) )
 	#error configSUPPORT_STATIC_ALLOCATION and configSUPPORT_DYNAMIC_ALLOCATION cannot both be 0, but can both be 1.
 #endif
@@ -1119,7 +1400,7 @@ typedef struct xSTATIC_TCB
 	UBaseType_t			uxDummy5;
 	void				*pxDummy6;
 	uint8_t				ucDummy7[ configMAX_TASK_NAME_LEN ];
-	#if ( ( portSTACK_GROWTH > 0 ) || ( configRECORD_STACK_HIGH_ADDRESS == 1 ) )
+	#if ( ( portSTACK_GROWTH > 0 ) || ( configRECORD_STACK_HIGH_ADDRESS == 1 ) || ( configUSE_STACK_WATERMARK_TRACKING == 1 ) )
 		void			*pxDummy8;
 	#endif
 	#if ( portCRITICAL_NESTING_IN_TCB == 1 )
@@ -1144,8 +1425,8 @@ typedef struct xSTATIC_TCB
 		struct	_reent	xDummy17;
 	#endif
 	#if ( configUSE_TASK_NOTIFICATIONS == 1 )
-		uint32_t 		ulDummy18;
-		uint8_t 		ucDummy19;
+		uint32_t 		ulDummy18[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
+		uint8_t 		ucDummy19[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
 	#endif
 	#if ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 )
 		uint8_t			uxDummy20;
@@ -1157,6 +1438,19 @@ typedef struct xSTATIC_TCB
 	#if ( configUSE_POSIX_ERRNO == 1 )
 		int				iDummy22;
 	#endif
+	#if ( configUSE_DELAYED_TASK_HEAP == 1 )
+		void			*pxDummy23[ 3 ];
+	#endif
+	#if ( configUSE_EDF_SCHEDULING == 1 )
+		TickType_t		xDummy24[ 2 ];
+		uint32_t		ulDummy25;
+	#endif
+	#if ( configUSE_STACK_WATERMARK_TRACKING == 1 )
+		void			*pxDummy26;
+	#endif
+	#if ( configUSE_TASK_POOLS == 1 )
+		void			*pxDummy27;
+	#endif
 } StaticTask_t;
 
 /*
@@ -1195,6 +1489,11 @@ typedef struct xSTATIC_QUEUE
 		void *pvDummy7;
 	#endif
 
+	#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+		void *pvDummy10;
+		uint32_t ulDummy11;
+	#endif
+
 	#if ( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxDummy8;
 		uint8_t ucDummy9;
@@ -1222,6 +1521,20 @@ typedef struct xSTATIC_EVENT_GROUP
 	TickType_t xDummy1;
 	StaticList_t xDummy2;
 
+	#if( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
+		StaticList_t xDummy5[ ( configUSE_16_BIT_TICKS == 1 ) ? 8 : 24 ];
+		TickType_t xDummy6;
+	#endif
+
+	#if( configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR == 1 )
+		TickType_t xDummy7;
+		void *pvDummy8;
+	#endif
+
+	#if( configUSE_CO_ROUTINE_EVENT_GROUP_WAITS == 1 )
+		StaticList_t xDummy9;
+	#endif
+
 	#if( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxDummy3;
 	#endif
@@ -1282,11 +1595,86 @@ typedef struct xSTATIC_STREAM_BUFFER
 	#if ( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxDummy4;
 	#endif
+	#if ( configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS == 1 )
+		StaticList_t xDummy5[ 2 ];
+	#endif
 } StaticStreamBuffer_t;
 
 /* Message buffers are built on stream buffers. */
 typedef StaticStreamBuffer_t StaticMessageBuffer_t;
 
+/*
+ * In line with software engineering best practice, especially when supplying a
+ * library that is likely to change in future versions, FreeRTOS implements a
+ * strict data hiding policy.  This means the adaptive mutex structure used
+ * internally by FreeRTOS is not accessible to application code.  However, if
+ * the application writer wants to statically allocate the memory required to
+ * create an adaptive mutex then the size of the mutex object needs to be known.
+ * The StaticAdaptiveMutex_t structure below is provided for this purpose.  Its
+ * sizes and alignment requirements are guaranteed to match those of the genuine
+ * structure, no matter which architecture is being used, and no matter how the
+ * values in FreeRTOSConfig.h are set.  Its contents are somewhat obfuscated in
+ * the hope users will recognise that it would be unwise to make direct use of
+ * the structure members.
+ */
+typedef struct xSTATIC_ADAPTIVE_MUTEX
+{
+	void *pvDummy1;
+	StaticList_t xDummy2;
+	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+		uint8_t ucDummy3;
+	#endif
+} StaticAdaptiveMutex_t;
+
+/*
+ * In line with software engineering best practice, especially when supplying a
+ * library that is likely to change in future versions, FreeRTOS implements a
+ * strict data hiding policy.  This means the reader-writer lock structure used
+ * internally by FreeRTOS is not accessible to application code.  However, if
+ * the application writer wants to statically allocate the memory required to
+ * create a reader-writer lock then the size of the lock object needs to be
+ * known.  The StaticRWLock_t structure below is provided for this purpose.  Its
+ * sizes and alignment requirements are guaranteed to match those of the genuine
+ * structure, no matter which architecture is being used, and no matter how the
+ * values in FreeRTOSConfig.h are set.  Its contents are somewhat obfuscated in
+ * the hope users will recognise that it would be unwise to make direct use of
+ * the structure members.
+ */
+typedef struct xSTATIC_RW_LOCK
+{
+	uint32_t ulDummy1;
+	void *pvDummy2;
+	UBaseType_t uxDummy3;
+	StaticList_t xDummy4[ 2 ];
+	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+		uint8_t ucDummy5;
+	#endif
+} StaticRWLock_t;
+
+/*
+ * In line with software engineering best practice, especially when supplying a
+ * library that is likely to change in future versions, FreeRTOS implements a
+ * strict data hiding policy.  This means the queue wait set structure used
+ * internally by FreeRTOS is not accessible to application code.  However, if
+ * the application writer wants to statically allocate the memory required to
+ * create a queue wait set then the size of the wait set object needs to be
+ * known.  The StaticQueueWaitSet_t structure below is provided for this
+ * purpose.  Its sizes and alignment requirements are guaranteed to match those
+ * of the genuine structure, no matter which architecture is being used, and no
+ * matter how the values in FreeRTOSConfig.h are set.  Its contents are somewhat
+ * obfuscated in the hope users will recognise that it would be unwise to make
+ * direct use of the structure members.
+ */
+typedef struct xSTATIC_QUEUE_WAIT_SET
+{
+	uint32_t ulDummy1[ 2 ];
+	void *pvDummy2;
+	UBaseType_t uxDummy3;
+	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+		uint8_t ucDummy4;
+	#endif
+} StaticQueueWaitSet_t;
+
 #ifdef __cplusplus
 }
 #endif
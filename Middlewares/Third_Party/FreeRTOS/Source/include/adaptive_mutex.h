@@ -0,0 +1,205 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef ADAPTIVE_MUTEX_H
+#define ADAPTIVE_MUTEX_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h" must appear in source files before "include adaptive_mutex.h"
+#endif
+
+/* FreeRTOS includes. */
+#include "task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * An adaptive mutex is a lighter weight alternative to the mutex type semaphore
+ * created by xSemaphoreCreateMutex(), intended for guarding short critical
+ * regions.  Taking a mutex that is not held is a single atomic compare-and-swap
+ * that does not mask interrupts on compilers and architectures that support
+ * lock free pointer exchanges.
+ *
+ * When the mutex is already held the calling task first looks at the state of
+ * the mutex holder.  If the holder is in the Ready state at a priority equal to
+ * or above that of the calling task then it is likely to release the mutex
+ * soon, so the calling task yields to it, up to configADAPTIVE_MUTEX_YIELD_LIMIT
+ * times.  Spinning cannot help on a single core, as the holder cannot run while
+ * the calling task spins.  Otherwise the calling task blocks, and the holder
+ * inherits the priority of the calling task as it would for a standard mutex.
+ *
+ * Adaptive mutexes cannot be taken recursively and must not be used from
+ * interrupts.  Set configUSE_ADAPTIVE_MUTEXES to 1 in FreeRTOSConfig.h, and
+ * build adaptive_mutex.c, to use them.
+ *
+ * \defgroup AdaptiveMutex
+ */
+
+/**
+ * adaptive_mutex.h
+ *
+ * Type by which adaptive mutexes are referenced.  For example, a call to
+ * xAdaptiveMutexCreate() returns an AdaptiveMutexHandle_t variable that can
+ * then be used as a parameter to other adaptive mutex functions.
+ *
+ * \defgroup AdaptiveMutexHandle_t AdaptiveMutexHandle_t
+ * \ingroup AdaptiveMutex
+ */
+struct AdaptiveMutexDef_t;
+typedef struct AdaptiveMutexDef_t * AdaptiveMutexHandle_t;
+
+/**
+ * adaptive_mutex.h
+ *<pre>
+ AdaptiveMutexHandle_t xAdaptiveMutexCreate( void );
+ </pre>
+ *
+ * Create a new adaptive mutex, using dynamically allocated memory to hold the
+ * mutex structure.
+ *
+ * @return If the mutex was created then a handle to the mutex is returned.  If
+ * there was insufficient FreeRTOS heap available to create the mutex then NULL
+ * is returned.
+ *
+ * \defgroup xAdaptiveMutexCreate xAdaptiveMutexCreate
+ * \ingroup AdaptiveMutex
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	AdaptiveMutexHandle_t xAdaptiveMutexCreate( void ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * adaptive_mutex.h
+ *<pre>
+ AdaptiveMutexHandle_t xAdaptiveMutexCreateStatic( StaticAdaptiveMutex_t *pxMutexBuffer );
+ </pre>
+ *
+ * Create a new adaptive mutex without using any dynamic memory allocation.
+ *
+ * @param pxMutexBuffer Must point to a variable of type StaticAdaptiveMutex_t,
+ * which will then be used to hold the mutex's data structures.
+ *
+ * @return If the mutex was created then a handle to the mutex is returned.  If
+ * pxMutexBuffer was NULL then NULL is returned.
+ *
+ * \defgroup xAdaptiveMutexCreateStatic xAdaptiveMutexCreateStatic
+ * \ingroup AdaptiveMutex
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	AdaptiveMutexHandle_t xAdaptiveMutexCreateStatic( StaticAdaptiveMutex_t *pxMutexBuffer ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * adaptive_mutex.h
+ *<pre>
+ BaseType_t xAdaptiveMutexTake( AdaptiveMutexHandle_t xMutex, TickType_t xTicksToWait );
+ </pre>
+ *
+ * Obtain an adaptive mutex.  The calling task must not already hold the mutex.
+ *
+ * @param xMutex The handle of the mutex being taken.
+ *
+ * @param xTicksToWait The maximum amount of time the calling task should wait
+ * for the mutex to become available, including the time spent yielding to the
+ * mutex holder.  Setting xTicksToWait to 0 makes the function return
+ * immediately if the mutex is held.
+ *
+ * @return pdPASS if the mutex was obtained, otherwise pdFAIL.
+ *
+ * Example usage:
+   <pre>
+	if( xAdaptiveMutexTake( xMutex, pdMS_TO_TICKS( 10 ) ) == pdPASS )
+	{
+		// Access the shared resource, then release the mutex.
+		xAdaptiveMutexGive( xMutex );
+	}
+   </pre>
+ * \defgroup xAdaptiveMutexTake xAdaptiveMutexTake
+ * \ingroup AdaptiveMutex
+ */
+BaseType_t xAdaptiveMutexTake( AdaptiveMutexHandle_t xMutex, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * adaptive_mutex.h
+ *<pre>
+ BaseType_t xAdaptiveMutexGive( AdaptiveMutexHandle_t xMutex );
+ </pre>
+ *
+ * Release an adaptive mutex previously obtained by xAdaptiveMutexTake().  If
+ * the calling task inherited a priority while it held the mutex then the
+ * priority is restored, and the highest priority task waiting for the mutex, if
+ * any, is unblocked to try to take it.
+ *
+ * @param xMutex The handle of the mutex being released.
+ *
+ * @return pdPASS if the mutex was released, or pdFAIL if the calling task was
+ * not the mutex holder.
+ *
+ * \defgroup xAdaptiveMutexGive xAdaptiveMutexGive
+ * \ingroup AdaptiveMutex
+ */
+BaseType_t xAdaptiveMutexGive( AdaptiveMutexHandle_t xMutex ) PRIVILEGED_FUNCTION;
+
+/**
+ * adaptive_mutex.h
+ *<pre>
+ TaskHandle_t xAdaptiveMutexGetMutexHolder( AdaptiveMutexHandle_t xMutex );
+ </pre>
+ *
+ * @return The handle of the task that holds the mutex, or NULL if the mutex is
+ * not held.  Only reliable when called by the mutex holder, as the holder can
+ * otherwise change before the function returns.
+ *
+ * \defgroup xAdaptiveMutexGetMutexHolder xAdaptiveMutexGetMutexHolder
+ * \ingroup AdaptiveMutex
+ */
+TaskHandle_t xAdaptiveMutexGetMutexHolder( AdaptiveMutexHandle_t xMutex ) PRIVILEGED_FUNCTION;
+
+/**
+ * adaptive_mutex.h
+ *<pre>
+ void vAdaptiveMutexDelete( AdaptiveMutexHandle_t xMutex );
+ </pre>
+ *
+ * Delete an adaptive mutex that was previously created by a call to
+ * xAdaptiveMutexCreate() or xAdaptiveMutexCreateStatic().  The mutex must not
+ * be held, and no tasks can be waiting for it, when it is deleted.
+ *
+ * @param xMutex The handle of the mutex being deleted.
+ *
+ * \defgroup vAdaptiveMutexDelete vAdaptiveMutexDelete
+ * \ingroup AdaptiveMutex
+ */
+void vAdaptiveMutexDelete( AdaptiveMutexHandle_t xMutex ) PRIVILEGED_FUNCTION;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ADAPTIVE_MUTEX_H */
@@ -128,6 +128,50 @@ uint32_t ulReturnValue;
 }
 /*-----------------------------------------------------------*/
 
+/**
+ * Atomic compare-and-swap with acquire/release ordering
+ *
+ * @brief Performs an atomic compare-and-swap operation on the specified values
+ *        without entering a critical section where the compiler can do so.
+ *
+ * @param[in, out] pulDestination  Pointer to memory location from where value is
+ *                               to be loaded and checked.
+ * @param[in] ulExchange         If condition meets, write this value to memory.
+ * @param[in] ulComparand        Swap condition.
+ *
+ * @return Unsigned integer of value 1 or 0. 1 for swapped, 0 for not swapped.
+ *
+ * @note GCC compatible compilers that can swap a 32-bit value without a lock use
+ *       the __atomic builtins, so interrupts are not masked.  Other compilers
+ *       fall back to Atomic_CompareAndSwap_u32().
+ */
+static portFORCE_INLINE uint32_t Atomic_CompareAndSwap_u32_AcqRel( uint32_t volatile * pulDestination,
+																   uint32_t ulExchange,
+																   uint32_t ulComparand )
+{
+uint32_t ulReturnValue;
+
+	#if defined( __GNUC__ ) && defined( __GCC_ATOMIC_INT_LOCK_FREE ) && ( __GCC_ATOMIC_INT_LOCK_FREE == 2 )
+	{
+		if( __atomic_compare_exchange_n( pulDestination, &ulComparand, ulExchange, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE ) )
+		{
+			ulReturnValue = ATOMIC_COMPARE_AND_SWAP_SUCCESS;
+		}
+		else
+		{
+			ulReturnValue = ATOMIC_COMPARE_AND_SWAP_FAILURE;
+		}
+	}
+	#else
+	{
+		ulReturnValue = Atomic_CompareAndSwap_u32( pulDestination, ulExchange, ulComparand );
+	}
+	#endif
+
+	return ulReturnValue;
+}
+/*-----------------------------------------------------------*/
+
 /**
  * Atomic swap (pointers)
  *
@@ -190,6 +234,51 @@ uint32_t ulReturnValue = ATOMIC_COMPARE_AND_SWAP_FAILURE;
 
 	return ulReturnValue;
 }
+/*-----------------------------------------------------------*/
+
+/**
+ * Atomic compare-and-swap (pointers) with acquire/release ordering
+ *
+ * @brief Performs an atomic compare-and-swap operation on the specified pointer
+ *        values without entering a critical section where the compiler can do
+ *        so.
+ *
+ * @param[in, out] ppvDestination  Pointer to memory location from where a pointer
+ *                                 value is to be loaded and checked.
+ * @param[in] pvExchange           If condition meets, write this value to memory.
+ * @param[in] pvComparand          Swap condition.
+ *
+ * @return Unsigned integer of value 1 or 0. 1 for swapped, 0 for not swapped.
+ *
+ * @note GCC compatible compilers that can swap a pointer without a lock use the
+ *       __atomic builtins, so interrupts are not masked.  Other compilers fall
+ *       back to Atomic_CompareAndSwapPointers_p32().
+ */
+static portFORCE_INLINE uint32_t Atomic_CompareAndSwapPointers_AcqRel( void * volatile * ppvDestination,
+																	   void * pvExchange,
+																	   void * pvComparand )
+{
+uint32_t ulReturnValue;
+
+	#if defined( __GNUC__ ) && defined( __GCC_ATOMIC_POINTER_LOCK_FREE ) && ( __GCC_ATOMIC_POINTER_LOCK_FREE == 2 )
+	{
+		if( __atomic_compare_exchange_n( ppvDestination, &pvComparand, pvExchange, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE ) )
+		{
+			ulReturnValue = ATOMIC_COMPARE_AND_SWAP_SUCCESS;
+		}
+		else
+		{
+			ulReturnValue = ATOMIC_COMPARE_AND_SWAP_FAILURE;
+		}
+	}
+	#else
+	{
+		ulReturnValue = Atomic_CompareAndSwapPointers_p32( ppvDestination, pvExchange, pvComparand );
+	}
+	#endif
+
+	return ulReturnValue;
+}
 
 
 /*----------------------------- Arithmetic ------------------------------*/
@@ -407,6 +496,75 @@ uint32_t ulCurrent;
 	return ulCurrent;
 }
 
+/*----------------------------- Load && Store ------------------------------*/
+
+/**
+ * Atomic load with acquire ordering
+ *
+ * @brief Reads *pxSource such that no memory access that follows the read can
+ *        be performed before it.
+ *
+ * @param[in] pxSource  Pointer to memory location from where value is to be
+ *                      loaded.
+ *
+ * @return The value of *pxSource.
+ *
+ * @note GCC compatible compilers use the __atomic builtins.  Other compilers
+ *       fall back to reading the value inside a critical section.
+ */
+static portFORCE_INLINE size_t Atomic_LoadAcquire_size( size_t const volatile * pxSource )
+{
+size_t xValue;
+
+	#if defined( __GNUC__ )
+	{
+		xValue = __atomic_load_n( pxSource, __ATOMIC_ACQUIRE );
+	}
+	#else
+	{
+		ATOMIC_ENTER_CRITICAL();
+		{
+			xValue = *pxSource;
+		}
+		ATOMIC_EXIT_CRITICAL();
+	}
+	#endif
+
+	return xValue;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * Atomic store with release ordering
+ *
+ * @brief Writes xValue to *pxDestination such that no memory access that
+ *        precedes the write can be performed after it.
+ *
+ * @param[out] pxDestination  Pointer to memory location to which value is to
+ *                            be stored.
+ * @param[in] xValue          Value to be stored.
+ *
+ * @note GCC compatible compilers use the __atomic builtins.  Other compilers
+ *       fall back to writing the value inside a critical section.
+ */
+static portFORCE_INLINE void Atomic_StoreRelease_size( size_t volatile * pxDestination,
+													   size_t xValue )
+{
+	#if defined( __GNUC__ )
+	{
+		__atomic_store_n( pxDestination, xValue, __ATOMIC_RELEASE );
+	}
+	#else
+	{
+		ATOMIC_ENTER_CRITICAL();
+		{
+			*pxDestination = xValue;
+		}
+		ATOMIC_EXIT_CRITICAL();
+	}
+	#endif
+}
+
 #ifdef __cplusplus
 }
 #endif
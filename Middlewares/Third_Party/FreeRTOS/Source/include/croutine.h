@@ -693,6 +693,212 @@ void vCoRoutineSchedule( void );
  */
 #define crQUEUE_RECEIVE_FROM_ISR( pxQueue, pvBuffer, pxCoRoutineWoken ) xQueueCRReceiveFromISR( ( pxQueue ), ( pvBuffer ), ( pxCoRoutineWoken ) )
 
+/**
+ * croutine. h
+ * <pre>
+  crSTREAM_BUFFER_SEND(
+                          CoRoutineHandle_t xHandle,
+                          StreamBufferHandle_t xStreamBuffer,
+                          const void *pvTxData,
+                          size_t xDataLengthBytes,
+                          TickType_t xTicksToWait,
+                          size_t *pxBytesSent,
+                          BaseType_t *pxResult
+                      )</pre>
+ *
+ * The macros crSTREAM_BUFFER_SEND() and crSTREAM_BUFFER_RECEIVE() are the
+ * co-routine equivalent to the xStreamBufferSend() and xStreamBufferReceive()
+ * functions used by tasks, and can be used on message buffers as well as
+ * stream buffers.  configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS must be set to 1
+ * in FreeRTOSConfig.h for them to be available.
+ *
+ * As with crQUEUE_SEND(), crSTREAM_BUFFER_SEND() can only be called from the
+ * co-routine function itself - not from within a function called by the
+ * co-routine function - and the variables pointed to by pxBytesSent and
+ * pxResult must be declared static as a co-routine does not maintain its own
+ * stack.
+ *
+ * A co-routine blocked on a stream buffer is unblocked by a task, an
+ * interrupt or another co-routine reading from (or, for
+ * crSTREAM_BUFFER_RECEIVE(), writing to) the stream buffer.  Only one
+ * co-routine or task should write to a stream buffer, and only one should read
+ * from it.
+ *
+ * @param xHandle The handle of the calling co-routine.  This is the xHandle
+ * parameter of the co-routine function.
+ *
+ * @param xStreamBuffer The handle of the stream buffer to which data is being
+ * sent.
+ *
+ * @param pvTxData A pointer to the data that is to be copied into the stream
+ * buffer.
+ *
+ * @param xDataLengthBytes The maximum number of bytes to copy from pvTxData.
+ *
+ * @param xTicksToWait The number of ticks the co-routine should block to wait
+ * for enough space to become available in the stream buffer.  If the space
+ * does not become available then as many bytes as fit are written to a stream
+ * buffer, and nothing is written to a message buffer, as when
+ * xStreamBufferSend() times out.
+ *
+ * @param pxBytesSent Set to the number of bytes written to the stream buffer.
+ *
+ * @param pxResult The variable pointed to by pxResult will be set to pdPASS if
+ * any bytes were written to the stream buffer, otherwise it will be set to
+ * errQUEUE_FULL.
+ *
+ * \defgroup crSTREAM_BUFFER_SEND crSTREAM_BUFFER_SEND
+ * \ingroup Tasks
+ */
+#define crSTREAM_BUFFER_SEND( xHandle, xStreamBuffer, pvTxData, xDataLengthBytes, xTicksToWait, pxBytesSent, pxResult )		\
+{																															\
+	*( pxResult ) = xStreamBufferCRSend( ( xStreamBuffer ), ( pvTxData ), ( xDataLengthBytes ), ( pxBytesSent ), ( xTicksToWait ) );	\
+	if( *( pxResult ) == errQUEUE_BLOCKED )																					\
+	{																														\
+		crSET_STATE0( ( xHandle ) );																						\
+		*( pxResult ) = xStreamBufferCRSend( ( xStreamBuffer ), ( pvTxData ), ( xDataLengthBytes ), ( pxBytesSent ), 0 );	\
+	}																														\
+	if( *( pxResult ) == errQUEUE_YIELD )																					\
+	{																														\
+		crSET_STATE1( ( xHandle ) );																						\
+		*( pxResult ) = pdPASS;																								\
+	}																														\
+}
+
+/**
+ * croutine. h
+ * <pre>
+  crSTREAM_BUFFER_RECEIVE(
+                             CoRoutineHandle_t xHandle,
+                             StreamBufferHandle_t xStreamBuffer,
+                             void *pvRxData,
+                             size_t xBufferLengthBytes,
+                             TickType_t xTicksToWait,
+                             size_t *pxBytesReceived,
+                             BaseType_t *pxResult
+                         )</pre>
+ *
+ * See crSTREAM_BUFFER_SEND().
+ *
+ * @param xHandle The handle of the calling co-routine.  This is the xHandle
+ * parameter of the co-routine function.
+ *
+ * @param xStreamBuffer The handle of the stream buffer from which data is
+ * being received.
+ *
+ * @param pvRxData A pointer to the buffer into which the received bytes, or
+ * the received message, will be copied.
+ *
+ * @param xBufferLengthBytes The length of the buffer pointed to by pvRxData.
+ *
+ * @param xTicksToWait The number of ticks the co-routine should block to wait
+ * for data to become available, should the stream buffer be empty.
+ *
+ * @param pxBytesReceived Set to the number of bytes read from the stream
+ * buffer.
+ *
+ * @param pxResult The variable pointed to by pxResult will be set to pdPASS if
+ * any bytes were read from the stream buffer, otherwise it will be set to
+ * errQUEUE_EMPTY.
+ *
+ * Example usage:
+ <pre>
+ // A protocol state machine that reads frames from a message buffer written
+ // by a UART interrupt.
+ static void prvFrameCoRoutine( CoRoutineHandle_t xHandle, UBaseType_t uxIndex )
+ {
+ // Variables in co-routines must be declared static if they must maintain value across a blocking call.
+ static BaseType_t xResult;
+ static size_t xReceived;
+ static uint8_t ucFrame[ 16 ];
+
+    crSTART( xHandle );
+
+    for( ;; )
+    {
+        crSTREAM_BUFFER_RECEIVE( xHandle, xFrameBuffer, ucFrame, sizeof( ucFrame ), portMAX_DELAY, &xReceived, &xResult );
+
+        if( xResult == pdPASS )
+        {
+            // Process the xReceived bytes of the frame here.
+        }
+    }
+
+    crEND();
+ }</pre>
+ * \defgroup crSTREAM_BUFFER_RECEIVE crSTREAM_BUFFER_RECEIVE
+ * \ingroup Tasks
+ */
+#define crSTREAM_BUFFER_RECEIVE( xHandle, xStreamBuffer, pvRxData, xBufferLengthBytes, xTicksToWait, pxBytesReceived, pxResult )	\
+{																																\
+	*( pxResult ) = xStreamBufferCRReceive( ( xStreamBuffer ), ( pvRxData ), ( xBufferLengthBytes ), ( pxBytesReceived ), ( xTicksToWait ) );	\
+	if( *( pxResult ) == errQUEUE_BLOCKED )																						\
+	{																															\
+		crSET_STATE0( ( xHandle ) );																							\
+		*( pxResult ) = xStreamBufferCRReceive( ( xStreamBuffer ), ( pvRxData ), ( xBufferLengthBytes ), ( pxBytesReceived ), 0 );	\
+	}																															\
+	if( *( pxResult ) == errQUEUE_YIELD )																						\
+	{																															\
+		crSET_STATE1( ( xHandle ) );																							\
+		*( pxResult ) = pdPASS;																									\
+	}																															\
+}
+
+/**
+ * croutine. h
+ * <pre>
+  crEVENT_GROUP_WAIT_BITS(
+                             CoRoutineHandle_t xHandle,
+                             EventGroupHandle_t xEventGroup,
+                             EventBits_t uxBitsToWaitFor,
+                             BaseType_t xClearOnExit,
+                             BaseType_t xWaitForAllBits,
+                             TickType_t xTicksToWait,
+                             EventBits_t *puxEventBits,
+                             BaseType_t *pxResult
+                         )</pre>
+ *
+ * The co-routine equivalent to the xEventGroupWaitBits() function used by
+ * tasks.  configUSE_CO_ROUTINE_EVENT_GROUP_WAITS must be set to 1 in
+ * FreeRTOSConfig.h for it to be available.
+ *
+ * As with crQUEUE_RECEIVE(), crEVENT_GROUP_WAIT_BITS() can only be called from
+ * the co-routine function itself, and the variables pointed to by puxEventBits
+ * and pxResult must be declared static.  Any number of tasks and co-routines
+ * can wait on the same event group.  Every co-routine whose wait condition is
+ * met when bits are set, by a task, an interrupt or a co-routine, is unblocked.
+ *
+ * @param xHandle The handle of the calling co-routine.  This is the xHandle
+ * parameter of the co-routine function.
+ *
+ * @param xEventGroup The event group in which the bits are being tested.
+ *
+ * @param uxBitsToWaitFor, xClearOnExit, xWaitForAllBits As the parameters of
+ * the same name of xEventGroupWaitBits().
+ *
+ * @param xTicksToWait The number of ticks the co-routine should block to wait
+ * for the condition to be met.
+ *
+ * @param puxEventBits Set to the value of the event group bits when the wait
+ * condition was met, or when the wait timed out, before any bits were
+ * cleared.
+ *
+ * @param pxResult The variable pointed to by pxResult will be set to pdPASS if
+ * the wait condition was met, otherwise it will be set to pdFAIL.
+ *
+ * \defgroup crEVENT_GROUP_WAIT_BITS crEVENT_GROUP_WAIT_BITS
+ * \ingroup Tasks
+ */
+#define crEVENT_GROUP_WAIT_BITS( xHandle, xEventGroup, uxBitsToWaitFor, xClearOnExit, xWaitForAllBits, xTicksToWait, puxEventBits, pxResult )	\
+{																																			\
+	*( pxResult ) = xEventGroupCRWaitBits( ( xEventGroup ), ( uxBitsToWaitFor ), ( xClearOnExit ), ( xWaitForAllBits ), ( puxEventBits ), ( xTicksToWait ) );	\
+	if( *( pxResult ) == errQUEUE_BLOCKED )																									\
+	{																																		\
+		crSET_STATE0( ( xHandle ) );																										\
+		*( pxResult ) = xEventGroupCRWaitBits( ( xEventGroup ), ( uxBitsToWaitFor ), ( xClearOnExit ), ( xWaitForAllBits ), ( puxEventBits ), 0 );	\
+	}																																		\
+}
+
 /*
  * This function is intended for internal use by the co-routine macros only.
  * The macro nature of the co-routine implementation requires that the
@@ -713,6 +919,22 @@ void vCoRoutineAddToDelayedList( TickType_t xTicksToDelay, List_t *pxEventList )
  */
 BaseType_t xCoRoutineRemoveFromEventList( const List_t *pxEventList );
 
+/*
+ * These functions are intended for internal use by the event group
+ * implementation only.  They should not be used by application writers.
+ *
+ * vCoRoutineAddToUnorderedEventList() places the current co-routine in its
+ * delayed list and at the end of pxEventList, with xItemValue stored in its
+ * event list item.  xCoRoutineRemoveFromUnorderedEventList() stores xItemValue
+ * in pxEventListItem and moves the co-routine that owns it to the pending
+ * ready list, and uxCoRoutineResetEventItemValue() returns the value stored in
+ * the event list item of the current co-routine before resetting it to the
+ * value used by queues.
+ */
+void vCoRoutineAddToUnorderedEventList( TickType_t xTicksToDelay, List_t *pxEventList, const TickType_t xItemValue );
+BaseType_t xCoRoutineRemoveFromUnorderedEventList( ListItem_t *pxEventListItem, const TickType_t xItemValue );
+TickType_t uxCoRoutineResetEventItemValue( void );
+
 #ifdef __cplusplus
 }
 #endif
@@ -500,6 +500,13 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_
  * context of the timer task - where a scheduler lock is used in place of a
  * critical section.
  *
+ * If configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR is set to 1 in FreeRTOSConfig.h
+ * then the timer task is not used.  If the scheduler is not suspended the bits
+ * are set, and the tasks waiting for them unblocked, within the interrupt -
+ * which is then only as deterministic as the number of tasks waiting for the
+ * bits being set.  If the scheduler is suspended the bits are held in the event
+ * group and set when the scheduler is resumed.
+ *
  * @param xEventGroup The event group in which the bits are to be set.
  *
  * @param uxBitsToSet A bitwise value that indicates the bit or bits to set.
@@ -514,11 +521,14 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_
  * xEventGroupSetBitsFromISR(), indicating that a context switch should be
  * requested before the interrupt exits.  For that reason
  * *pxHigherPriorityTaskWoken must be initialised to pdFALSE.  See the
- * example code below.
+ * example code below.  If configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR is 1 then
+ * *pxHigherPriorityTaskWoken is instead set to pdTRUE if setting the bits
+ * unblocked a task that has a priority above the running task.
  *
  * @return If the request to execute the function was posted successfully then
  * pdPASS is returned, otherwise pdFALSE is returned.  pdFALSE will be returned
- * if the timer service queue was full.
+ * if the timer service queue was full.  pdPASS is always returned if
+ * configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR is 1.
  *
  * Example usage:
    <pre>
@@ -556,7 +566,7 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_
  * \defgroup xEventGroupSetBitsFromISR xEventGroupSetBitsFromISR
  * \ingroup EventGroup
  */
-#if( configUSE_TRACE_FACILITY == 1 )
+#if( ( configUSE_TRACE_FACILITY == 1 ) || ( configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR == 1 ) )
 	BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 #else
 	#define xEventGroupSetBitsFromISR( xEventGroup, uxBitsToSet, pxHigherPriorityTaskWoken ) xTimerPendFunctionCallFromISR( vEventGroupSetBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToSet, pxHigherPriorityTaskWoken )
@@ -738,9 +748,22 @@ EventBits_t xEventGroupGetBitsFromISR( EventGroupHandle_t xEventGroup ) PRIVILEG
  */
 void vEventGroupDelete( EventGroupHandle_t xEventGroup ) PRIVILEGED_FUNCTION;
 
+/*
+ * The co-routine equivalent of xEventGroupWaitBits().  This function is called
+ * from the co-routine macro implementation and should not be called directly
+ * from application code.  Instead use crEVENT_GROUP_WAIT_BITS(), defined
+ * within croutine.h.
+ */
+#if( configUSE_CO_ROUTINE_EVENT_GROUP_WAITS == 1 )
+	BaseType_t xEventGroupCRWaitBits( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToWaitFor, const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits, EventBits_t *puxEventBits, TickType_t xTicksToWait );
+#endif
+
 /* For internal use only. */
 void vEventGroupSetBitsCallback( void *pvEventGroup, const uint32_t ulBitsToSet ) PRIVILEGED_FUNCTION;
 void vEventGroupClearBitsCallback( void *pvEventGroup, const uint32_t ulBitsToClear ) PRIVILEGED_FUNCTION;
+#if( configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR == 1 )
+	void vEventGroupSetBitsPendedFromISR( void ) PRIVILEGED_FUNCTION;
+#endif
 
 
 #if (configUSE_TRACE_FACILITY == 1)
@@ -599,6 +599,84 @@ BaseType_t xHigherPriorityTaskWoken = pdFALSE;  // Initialised to pdFALSE.
  */
 #define xMessageBufferReceiveFromISR( xMessageBuffer, pvRxData, xBufferLengthBytes, pxHigherPriorityTaskWoken ) xStreamBufferReceiveFromISR( ( StreamBufferHandle_t ) xMessageBuffer, pvRxData, xBufferLengthBytes, pxHigherPriorityTaskWoken )
 
+/**
+ * message_buffer.h
+ *
+<pre>
+size_t xMessageBufferSendReserve( MessageBufferHandle_t xMessageBuffer,
+                                  size_t xDataLengthBytes,
+                                  StreamBufferRegion_t * const pxRegion,
+                                  TickType_t xTicksToWait );
+
+size_t xMessageBufferSendReserveFromISR( MessageBufferHandle_t xMessageBuffer,
+                                         size_t xDataLengthBytes,
+                                         StreamBufferRegion_t * const pxRegion );
+
+size_t xMessageBufferSendCommit( MessageBufferHandle_t xMessageBuffer,
+                                 size_t xDataLengthBytes );
+
+size_t xMessageBufferSendCommitFromISR( MessageBufferHandle_t xMessageBuffer,
+                                        size_t xDataLengthBytes,
+                                        BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Writes a message directly into a message buffer's storage area, rather than
+ * copying it in using xMessageBufferSend().  xMessageBufferSendReserve()
+ * reserves space for a message of up to xDataLengthBytes bytes and returns it
+ * as up to two spans in *pxRegion, or reserves nothing if the whole message
+ * will not fit.  Once the message has been written, xMessageBufferSendCommit()
+ * stores its actual length (which must not be more than the length reserved)
+ * and makes it available to the reader.  Committing a length of 0 discards the
+ * message.
+ *
+ * See xStreamBufferSendReserve() and xStreamBufferSendCommit() for more
+ * information.
+ *
+ * \defgroup xMessageBufferSendReserve xMessageBufferSendReserve
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferSendReserve( xMessageBuffer, xDataLengthBytes, pxRegion, xTicksToWait ) xStreamBufferSendReserve( ( StreamBufferHandle_t ) xMessageBuffer, xDataLengthBytes, pxRegion, xTicksToWait )
+#define xMessageBufferSendReserveFromISR( xMessageBuffer, xDataLengthBytes, pxRegion ) xStreamBufferSendReserveFromISR( ( StreamBufferHandle_t ) xMessageBuffer, xDataLengthBytes, pxRegion )
+#define xMessageBufferSendCommit( xMessageBuffer, xDataLengthBytes ) xStreamBufferSendCommit( ( StreamBufferHandle_t ) xMessageBuffer, xDataLengthBytes )
+#define xMessageBufferSendCommitFromISR( xMessageBuffer, xDataLengthBytes, pxHigherPriorityTaskWoken ) xStreamBufferSendCommitFromISR( ( StreamBufferHandle_t ) xMessageBuffer, xDataLengthBytes, pxHigherPriorityTaskWoken )
+
+/**
+ * message_buffer.h
+ *
+<pre>
+size_t xMessageBufferReceiveAcquire( MessageBufferHandle_t xMessageBuffer,
+                                     StreamBufferRegion_t * const pxRegion,
+                                     TickType_t xTicksToWait );
+
+size_t xMessageBufferReceiveAcquireFromISR( MessageBufferHandle_t xMessageBuffer,
+                                            StreamBufferRegion_t * const pxRegion );
+
+size_t xMessageBufferReceiveRelease( MessageBufferHandle_t xMessageBuffer,
+                                     size_t xDataLengthBytes );
+
+size_t xMessageBufferReceiveReleaseFromISR( MessageBufferHandle_t xMessageBuffer,
+                                            size_t xDataLengthBytes,
+                                            BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Reads a message in place, rather than copying it out using
+ * xMessageBufferReceive().  xMessageBufferReceiveAcquire() returns the length
+ * of the next message and describes it as up to two spans in *pxRegion, so no
+ * receive buffer has to be sized for the largest possible message.  The
+ * message stays in the message buffer until xMessageBufferReceiveRelease() is
+ * called with the length returned by xMessageBufferReceiveAcquire().
+ *
+ * See xStreamBufferReceiveAcquire() and xStreamBufferReceiveRelease() for more
+ * information.
+ *
+ * \defgroup xMessageBufferReceiveAcquire xMessageBufferReceiveAcquire
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferReceiveAcquire( xMessageBuffer, pxRegion, xTicksToWait ) xStreamBufferReceiveAcquire( ( StreamBufferHandle_t ) xMessageBuffer, pxRegion, xTicksToWait )
+#define xMessageBufferReceiveAcquireFromISR( xMessageBuffer, pxRegion ) xStreamBufferReceiveAcquireFromISR( ( StreamBufferHandle_t ) xMessageBuffer, pxRegion )
+#define xMessageBufferReceiveRelease( xMessageBuffer, xDataLengthBytes ) xStreamBufferReceiveRelease( ( StreamBufferHandle_t ) xMessageBuffer, xDataLengthBytes )
+#define xMessageBufferReceiveReleaseFromISR( xMessageBuffer, xDataLengthBytes, pxHigherPriorityTaskWoken ) xStreamBufferReceiveReleaseFromISR( ( StreamBufferHandle_t ) xMessageBuffer, xDataLengthBytes, pxHigherPriorityTaskWoken )
+
 /**
  * message_buffer.h
  *
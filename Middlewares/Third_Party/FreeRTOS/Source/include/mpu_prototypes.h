@@ -44,9 +44,16 @@ BaseType_t MPU_xTaskCreateRestricted( const TaskParameters_t * const pxTaskDefin
 BaseType_t MPU_xTaskCreateRestrictedStatic( const TaskParameters_t * const pxTaskDefinition, TaskHandle_t *pxCreatedTask ) FREERTOS_SYSTEM_CALL;
 void MPU_vTaskAllocateMPURegions( TaskHandle_t xTask, const MemoryRegion_t * const pxRegions ) FREERTOS_SYSTEM_CALL;
 void MPU_vTaskDelete( TaskHandle_t xTaskToDelete ) FREERTOS_SYSTEM_CALL;
+TaskPoolHandle_t MPU_xTaskPoolCreate( UBaseType_t uxTaskCount, configSTACK_DEPTH_TYPE usStackDepth, BaseType_t xFillStackOnReuse ) FREERTOS_SYSTEM_CALL;
+BaseType_t MPU_xTaskCreateFromPool( TaskPoolHandle_t xTaskPool, TaskFunction_t pxTaskCode, const char * const pcName, void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask ) FREERTOS_SYSTEM_CALL;
+UBaseType_t MPU_uxTaskPoolGetFreeCount( TaskPoolHandle_t xTaskPool ) FREERTOS_SYSTEM_CALL;
 void MPU_vTaskDelay( const TickType_t xTicksToDelay ) FREERTOS_SYSTEM_CALL;
 void MPU_vTaskDelayUntil( TickType_t * const pxPreviousWakeTime, const TickType_t xTimeIncrement ) FREERTOS_SYSTEM_CALL;
 BaseType_t MPU_xTaskAbortDelay( TaskHandle_t xTask ) FREERTOS_SYSTEM_CALL;
+void MPU_vTaskSetDeadline( TaskHandle_t xTask, TickType_t xRelativeDeadline ) FREERTOS_SYSTEM_CALL;
+uint32_t MPU_ulTaskGetDeadlineMisses( TaskHandle_t xTask ) FREERTOS_SYSTEM_CALL;
+configSTACK_DEPTH_TYPE MPU_uxTaskGetTrackedStackHighWaterMark( TaskHandle_t xTask ) FREERTOS_SYSTEM_CALL;
+UBaseType_t MPU_uxTaskGetStackUsage( TaskStackUsage_t * const pxStackUsageArray, const UBaseType_t uxArraySize, const UBaseType_t uxMarginPercent ) FREERTOS_SYSTEM_CALL;
 UBaseType_t MPU_uxTaskPriorityGet( const TaskHandle_t xTask ) FREERTOS_SYSTEM_CALL;
 eTaskState MPU_eTaskGetState( TaskHandle_t xTask ) FREERTOS_SYSTEM_CALL;
 void MPU_vTaskGetInfo( TaskHandle_t xTask, TaskStatus_t *pxTaskStatus, BaseType_t xGetFreeStackSpace, eTaskState eState ) FREERTOS_SYSTEM_CALL;
@@ -72,11 +79,11 @@ UBaseType_t MPU_uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray, co
 uint32_t MPU_ulTaskGetIdleRunTimeCounter( void ) FREERTOS_SYSTEM_CALL;
 void MPU_vTaskList( char * pcWriteBuffer ) FREERTOS_SYSTEM_CALL;
 void MPU_vTaskGetRunTimeStats( char *pcWriteBuffer ) FREERTOS_SYSTEM_CALL;
-BaseType_t MPU_xTaskGenericNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue ) FREERTOS_SYSTEM_CALL;
-BaseType_t MPU_xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
-uint32_t MPU_ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
-BaseType_t MPU_xTaskNotifyStateClear( TaskHandle_t xTask ) FREERTOS_SYSTEM_CALL;
-uint32_t MPU_ulTaskNotifyValueClear( TaskHandle_t xTask, uint32_t ulBitsToClear ) FREERTOS_SYSTEM_CALL;
+BaseType_t MPU_xTaskGenericNotify( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue ) FREERTOS_SYSTEM_CALL;
+BaseType_t MPU_xTaskGenericNotifyWait( UBaseType_t uxIndexToWait, uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
+uint32_t MPU_ulTaskGenericNotifyTake( UBaseType_t uxIndexToWait, BaseType_t xClearCountOnExit, TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
+BaseType_t MPU_xTaskGenericNotifyStateClear( TaskHandle_t xTask, UBaseType_t uxIndexToClear ) FREERTOS_SYSTEM_CALL;
+uint32_t MPU_ulTaskGenericNotifyValueClear( TaskHandle_t xTask, UBaseType_t uxIndexToClear, uint32_t ulBitsToClear ) FREERTOS_SYSTEM_CALL;
 BaseType_t MPU_xTaskIncrementTick( void ) FREERTOS_SYSTEM_CALL;
 TaskHandle_t MPU_xTaskGetCurrentTaskHandle( void ) FREERTOS_SYSTEM_CALL;
 void MPU_vTaskSetTimeOutState( TimeOut_t * const pxTimeOut ) FREERTOS_SYSTEM_CALL;
@@ -88,6 +95,8 @@ BaseType_t MPU_xTaskCatchUpTicks( TickType_t xTicksToCatchUp ) FREERTOS_SYSTEM_C
 /* MPU versions of queue.h API functions. */
 BaseType_t MPU_xQueueGenericSend( QueueHandle_t xQueue, const void * const pvItemToQueue, TickType_t xTicksToWait, const BaseType_t xCopyPosition ) FREERTOS_SYSTEM_CALL;
 BaseType_t MPU_xQueueReceive( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
+UBaseType_t MPU_xQueueSendMultiple( QueueHandle_t xQueue, const void * const pvItemsToQueue, const UBaseType_t uxItemCount, TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
+UBaseType_t MPU_xQueueReceiveMultiple( QueueHandle_t xQueue, void * const pvBuffer, const UBaseType_t uxMaxItems, TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
 BaseType_t MPU_xQueuePeek( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
 BaseType_t MPU_xQueueSemaphoreTake( QueueHandle_t xQueue, TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
 UBaseType_t MPU_uxQueueMessagesWaiting( const QueueHandle_t xQueue ) FREERTOS_SYSTEM_CALL;
@@ -109,6 +118,12 @@ QueueSetHandle_t MPU_xQueueCreateSet( const UBaseType_t uxEventQueueLength ) FRE
 BaseType_t MPU_xQueueAddToSet( QueueSetMemberHandle_t xQueueOrSemaphore, QueueSetHandle_t xQueueSet ) FREERTOS_SYSTEM_CALL;
 BaseType_t MPU_xQueueRemoveFromSet( QueueSetMemberHandle_t xQueueOrSemaphore, QueueSetHandle_t xQueueSet ) FREERTOS_SYSTEM_CALL;
 QueueSetMemberHandle_t MPU_xQueueSelectFromSet( QueueSetHandle_t xQueueSet, const TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
+QueueWaitSetHandle_t MPU_xQueueCreateWaitSet( const UBaseType_t uxIndexToNotify ) FREERTOS_SYSTEM_CALL;
+QueueWaitSetHandle_t MPU_xQueueCreateWaitSetStatic( const UBaseType_t uxIndexToNotify, StaticQueueWaitSet_t *pxWaitSetBuffer ) FREERTOS_SYSTEM_CALL;
+BaseType_t MPU_xQueueAddToWaitSet( QueueSetMemberHandle_t xQueueOrSemaphore, QueueWaitSetHandle_t xWaitSet, const UBaseType_t uxBitNumber ) FREERTOS_SYSTEM_CALL;
+BaseType_t MPU_xQueueRemoveFromWaitSet( QueueSetMemberHandle_t xQueueOrSemaphore, QueueWaitSetHandle_t xWaitSet ) FREERTOS_SYSTEM_CALL;
+uint32_t MPU_ulQueueWaitForAny( QueueWaitSetHandle_t xWaitSet, TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
+void MPU_vQueueDeleteWaitSet( QueueWaitSetHandle_t xWaitSet ) FREERTOS_SYSTEM_CALL;
 BaseType_t MPU_xQueueGenericReset( QueueHandle_t xQueue, BaseType_t xNewQueue ) FREERTOS_SYSTEM_CALL;
 void MPU_vQueueSetQueueNumber( QueueHandle_t xQueue, UBaseType_t uxQueueNumber ) FREERTOS_SYSTEM_CALL;
 UBaseType_t MPU_uxQueueGetQueueNumber( QueueHandle_t xQueue ) FREERTOS_SYSTEM_CALL;
@@ -140,9 +155,30 @@ EventBits_t MPU_xEventGroupSync( EventGroupHandle_t xEventGroup, const EventBits
 void MPU_vEventGroupDelete( EventGroupHandle_t xEventGroup ) FREERTOS_SYSTEM_CALL;
 UBaseType_t MPU_uxEventGroupGetNumber( void* xEventGroup ) FREERTOS_SYSTEM_CALL;
 
+/* MPU versions of adaptive_mutex.h API functions. */
+AdaptiveMutexHandle_t MPU_xAdaptiveMutexCreate( void ) FREERTOS_SYSTEM_CALL;
+AdaptiveMutexHandle_t MPU_xAdaptiveMutexCreateStatic( StaticAdaptiveMutex_t *pxMutexBuffer ) FREERTOS_SYSTEM_CALL;
+BaseType_t MPU_xAdaptiveMutexTake( AdaptiveMutexHandle_t xMutex, TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
+BaseType_t MPU_xAdaptiveMutexGive( AdaptiveMutexHandle_t xMutex ) FREERTOS_SYSTEM_CALL;
+TaskHandle_t MPU_xAdaptiveMutexGetMutexHolder( AdaptiveMutexHandle_t xMutex ) FREERTOS_SYSTEM_CALL;
+void MPU_vAdaptiveMutexDelete( AdaptiveMutexHandle_t xMutex ) FREERTOS_SYSTEM_CALL;
+
+/* MPU versions of rw_lock.h API functions. */
+RWLockHandle_t MPU_xRWLockCreate( void ) FREERTOS_SYSTEM_CALL;
+RWLockHandle_t MPU_xRWLockCreateStatic( StaticRWLock_t *pxLockBuffer ) FREERTOS_SYSTEM_CALL;
+BaseType_t MPU_xRWLockTakeRead( RWLockHandle_t xLock, TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
+BaseType_t MPU_xRWLockGiveRead( RWLockHandle_t xLock ) FREERTOS_SYSTEM_CALL;
+BaseType_t MPU_xRWLockTakeWrite( RWLockHandle_t xLock, TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
+BaseType_t MPU_xRWLockGiveWrite( RWLockHandle_t xLock ) FREERTOS_SYSTEM_CALL;
+void MPU_vRWLockDelete( RWLockHandle_t xLock ) FREERTOS_SYSTEM_CALL;
+
 /* MPU versions of message/stream_buffer.h API functions. */
 size_t MPU_xStreamBufferSend( StreamBufferHandle_t xStreamBuffer, const void *pvTxData, size_t xDataLengthBytes, TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
 size_t MPU_xStreamBufferReceive( StreamBufferHandle_t xStreamBuffer, void *pvRxData, size_t xBufferLengthBytes, TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
+size_t MPU_xStreamBufferSendReserve( StreamBufferHandle_t xStreamBuffer, size_t xDataLengthBytes, StreamBufferRegion_t * const pxRegion, TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
+size_t MPU_xStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer, size_t xDataLengthBytes ) FREERTOS_SYSTEM_CALL;
+size_t MPU_xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer, StreamBufferRegion_t * const pxRegion, TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
+size_t MPU_xStreamBufferReceiveRelease( StreamBufferHandle_t xStreamBuffer, size_t xDataLengthBytes ) FREERTOS_SYSTEM_CALL;
 size_t MPU_xStreamBufferNextMessageLengthBytes( StreamBufferHandle_t xStreamBuffer ) FREERTOS_SYSTEM_CALL;
 void MPU_vStreamBufferDelete( StreamBufferHandle_t xStreamBuffer ) FREERTOS_SYSTEM_CALL;
 BaseType_t MPU_xStreamBufferIsFull( StreamBufferHandle_t xStreamBuffer ) FREERTOS_SYSTEM_CALL;
@@ -51,9 +51,16 @@ only for ports that are using the MPU. */
 		#define xTaskCreateRestricted					MPU_xTaskCreateRestricted
 		#define vTaskAllocateMPURegions					MPU_vTaskAllocateMPURegions
 		#define vTaskDelete								MPU_vTaskDelete
+		#define xTaskPoolCreate							MPU_xTaskPoolCreate
+		#define xTaskCreateFromPool						MPU_xTaskCreateFromPool
+		#define uxTaskPoolGetFreeCount					MPU_uxTaskPoolGetFreeCount
 		#define vTaskDelay								MPU_vTaskDelay
 		#define vTaskDelayUntil							MPU_vTaskDelayUntil
 		#define xTaskAbortDelay							MPU_xTaskAbortDelay
+		#define vTaskSetDeadline						MPU_vTaskSetDeadline
+		#define ulTaskGetDeadlineMisses					MPU_ulTaskGetDeadlineMisses
+		#define uxTaskGetTrackedStackHighWaterMark		MPU_uxTaskGetTrackedStackHighWaterMark
+		#define uxTaskGetStackUsage						MPU_uxTaskGetStackUsage
 		#define uxTaskPriorityGet						MPU_uxTaskPriorityGet
 		#define eTaskGetState							MPU_eTaskGetState
 		#define vTaskGetInfo							MPU_vTaskGetInfo
@@ -79,10 +86,10 @@ only for ports that are using the MPU. */
 		#define vTaskGetRunTimeStats					MPU_vTaskGetRunTimeStats
 		#define ulTaskGetIdleRunTimeCounter				MPU_ulTaskGetIdleRunTimeCounter
 		#define xTaskGenericNotify						MPU_xTaskGenericNotify
-		#define xTaskNotifyWait							MPU_xTaskNotifyWait
-		#define ulTaskNotifyTake						MPU_ulTaskNotifyTake
-		#define xTaskNotifyStateClear					MPU_xTaskNotifyStateClear
-		#define ulTaskNotifyValueClear					MPU_ulTaskNotifyValueClear
+		#define xTaskGenericNotifyWait					MPU_xTaskGenericNotifyWait
+		#define ulTaskGenericNotifyTake					MPU_ulTaskGenericNotifyTake
+		#define xTaskGenericNotifyStateClear			MPU_xTaskGenericNotifyStateClear
+		#define ulTaskGenericNotifyValueClear			MPU_ulTaskGenericNotifyValueClear
 		#define xTaskCatchUpTicks						MPU_xTaskCatchUpTicks
 
 		#define xTaskGetCurrentTaskHandle				MPU_xTaskGetCurrentTaskHandle
@@ -93,6 +100,8 @@ only for ports that are using the MPU. */
 		/* Map standard queue.h API functions to the MPU equivalents. */
 		#define xQueueGenericSend						MPU_xQueueGenericSend
 		#define xQueueReceive							MPU_xQueueReceive
+		#define xQueueSendMultiple						MPU_xQueueSendMultiple
+		#define xQueueReceiveMultiple					MPU_xQueueReceiveMultiple
 		#define xQueuePeek								MPU_xQueuePeek
 		#define xQueueSemaphoreTake						MPU_xQueueSemaphoreTake
 		#define uxQueueMessagesWaiting					MPU_uxQueueMessagesWaiting
@@ -111,6 +120,12 @@ only for ports that are using the MPU. */
 		#define xQueueAddToSet							MPU_xQueueAddToSet
 		#define xQueueRemoveFromSet						MPU_xQueueRemoveFromSet
 		#define xQueueSelectFromSet						MPU_xQueueSelectFromSet
+		#define xQueueCreateWaitSet						MPU_xQueueCreateWaitSet
+		#define xQueueCreateWaitSetStatic				MPU_xQueueCreateWaitSetStatic
+		#define xQueueAddToWaitSet						MPU_xQueueAddToWaitSet
+		#define xQueueRemoveFromWaitSet					MPU_xQueueRemoveFromWaitSet
+		#define ulQueueWaitForAny						MPU_ulQueueWaitForAny
+		#define vQueueDeleteWaitSet						MPU_vQueueDeleteWaitSet
 		#define xQueueGenericReset						MPU_xQueueGenericReset
 
 		#if( configQUEUE_REGISTRY_SIZE > 0 )
@@ -143,10 +158,32 @@ only for ports that are using the MPU. */
 		#define xEventGroupSync							MPU_xEventGroupSync
 		#define vEventGroupDelete						MPU_vEventGroupDelete
 
+		/* Map standard adaptive_mutex.h API functions to the MPU
+		equivalents. */
+		#define xAdaptiveMutexCreate					MPU_xAdaptiveMutexCreate
+		#define xAdaptiveMutexCreateStatic				MPU_xAdaptiveMutexCreateStatic
+		#define xAdaptiveMutexTake						MPU_xAdaptiveMutexTake
+		#define xAdaptiveMutexGive						MPU_xAdaptiveMutexGive
+		#define xAdaptiveMutexGetMutexHolder			MPU_xAdaptiveMutexGetMutexHolder
+		#define vAdaptiveMutexDelete					MPU_vAdaptiveMutexDelete
+
+		/* Map standard rw_lock.h API functions to the MPU equivalents. */
+		#define xRWLockCreate							MPU_xRWLockCreate
+		#define xRWLockCreateStatic						MPU_xRWLockCreateStatic
+		#define xRWLockTakeRead							MPU_xRWLockTakeRead
+		#define xRWLockGiveRead							MPU_xRWLockGiveRead
+		#define xRWLockTakeWrite						MPU_xRWLockTakeWrite
+		#define xRWLockGiveWrite						MPU_xRWLockGiveWrite
+		#define vRWLockDelete							MPU_vRWLockDelete
+
 		/* Map standard message/stream_buffer.h API functions to the MPU
 		equivalents. */
 		#define xStreamBufferSend						MPU_xStreamBufferSend
 		#define xStreamBufferReceive					MPU_xStreamBufferReceive
+		#define xStreamBufferSendReserve				MPU_xStreamBufferSendReserve
+		#define xStreamBufferSendCommit					MPU_xStreamBufferSendCommit
+		#define xStreamBufferReceiveAcquire				MPU_xStreamBufferReceiveAcquire
+		#define xStreamBufferReceiveRelease				MPU_xStreamBufferReceiveRelease
 		#define xStreamBufferNextMessageLengthBytes		MPU_xStreamBufferNextMessageLengthBytes
 		#define vStreamBufferDelete						MPU_vStreamBufferDelete
 		#define xStreamBufferIsFull						MPU_xStreamBufferIsFull
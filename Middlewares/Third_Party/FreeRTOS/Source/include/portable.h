@@ -118,12 +118,22 @@ extern "C" {
 	#endif
 #endif
 
+/* Capabilities of the memory in a heap_5.c region, used when
+configUSE_HEAP_REGION_CAPABILITIES is set to 1.  Applications can define
+further capabilities using the remaining bits. */
+#define portHEAP_CAPABILITY_FAST			( ( uint32_t ) 0x01UL )	/* Tightly coupled or otherwise zero wait state memory. */
+#define portHEAP_CAPABILITY_DMA				( ( uint32_t ) 0x02UL )	/* Memory that can be accessed by the DMA controllers. */
+#define portHEAP_CAPABILITY_NON_CACHEABLE	( ( uint32_t ) 0x04UL )	/* Memory that is not cached, so can be shared with DMA without cache maintenance. */
+
 /* Used by heap_5.c to define the start address and size of each memory region
 that together comprise the total FreeRTOS heap space. */
 typedef struct HeapRegion
 {
 	uint8_t *pucStartAddress;
 	size_t xSizeInBytes;
+	#if( configUSE_HEAP_REGION_CAPABILITIES == 1 )
+		uint32_t ulCapabilities;	/* The portHEAP_CAPABILITY_... bits that describe the memory in the region. */
+	#endif
 } HeapRegion_t;
 
 /* Used to pass information about the heap out of vPortGetHeapStats(). */
@@ -157,6 +167,34 @@ void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) PRIVILEG
  */
 void vPortGetHeapStats( HeapStats_t *pxHeapStats );
 
+/*
+ * Used by heap_5.c.  Fills a HeapStats_t structure with information about the
+ * current state of a single heap region, where xRegion is the index of the
+ * region in the array passed to vPortDefineHeapRegions().  Returns pdFAIL if
+ * there is no such region.
+ */
+BaseType_t xPortGetHeapRegionStats( BaseType_t xRegion, HeapStats_t *pxHeapStats );
+
+/*
+ * Used by heap_5.c when configUSE_HEAP_REGION_CAPABILITIES is set to 1.
+ * Allocates memory from a heap region that has all the portHEAP_CAPABILITY_...
+ * bits set in ulCapabilities, or returns NULL if no such region has enough
+ * free memory.  The memory is freed using vPortFree().
+ */
+#if( configUSE_HEAP_REGION_CAPABILITIES == 1 )
+	void *pvPortMallocCaps( size_t xSize, uint32_t ulCapabilities ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Used by heap_4.c when configUSE_HEAP_TASK_CACHE is set to 1.  Called by the
+ * kernel when a task is deleted to return the blocks held in the task's cache
+ * to the heap.  Only heap_4.c provides it, so the other heap implementations
+ * fail to build if configUSE_HEAP_TASK_CACHE is set to 1.
+ */
+#if( configUSE_HEAP_TASK_CACHE == 1 )
+	void vPortFreeTaskCache( void *pvTaskCache ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Map to the memory management routines required for the port.
  */
@@ -61,6 +61,14 @@ typedef struct QueueDefinition * QueueSetHandle_t;
  */
 typedef struct QueueDefinition * QueueSetMemberHandle_t;
 
+/**
+ * Type by which queue wait sets are referenced.  For example, a call to
+ * xQueueCreateWaitSet() returns a QueueWaitSetHandle_t variable that can then
+ * be used as a parameter to xQueueAddToWaitSet(), ulQueueWaitForAny(), etc.
+ */
+struct QueueWaitSetDefinition;
+typedef struct QueueWaitSetDefinition * QueueWaitSetHandle_t;
+
 /* For internal use only. */
 #define	queueSEND_TO_BACK		( ( BaseType_t ) 0 )
 #define	queueSEND_TO_FRONT		( ( BaseType_t ) 1 )
@@ -867,6 +875,104 @@ BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue, void * const pvBuffer ) PRIV
  */
 BaseType_t xQueueReceive( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * <pre>
+ UBaseType_t xQueueSendMultiple(
+									QueueHandle_t xQueue,
+									const void *pvItemsToQueue,
+									UBaseType_t uxItemCount,
+									TickType_t xTicksToWait
+								);
+ * </pre>
+ *
+ * Post a number of items to the back of a queue.  The items are queued by copy
+ * in the order they appear in pvItemsToQueue, and are copied using a single
+ * critical section (and at most two memcpy() calls) for as many as there is
+ * space for, rather than one critical section per item.
+ *
+ * A task waiting to receive from the queue is unblocked for each item posted,
+ * up to the number of tasks that are waiting - so posting a batch of items to
+ * a queue that has one reader unblocks that reader once.
+ *
+ * This function must not be called from an interrupt service routine, or used
+ * with a semaphore or mutex.  See xQueueSendMultipleFromISR() for an
+ * alternative which may be used in an ISR.
+ *
+ * @param xQueue The handle to the queue on which the items are to be posted.
+ *
+ * @param pvItemsToQueue A pointer to an array of uxItemCount items, each the
+ * size the queue was created to hold.
+ *
+ * @param uxItemCount The number of items to post.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block waiting
+ * for space to become available on the queue should there not be room for all
+ * the items.  Items that fit are posted before the task blocks.
+ *
+ * @return The number of items posted, which is uxItemCount unless the block
+ * time expired before there was space for them all.
+ *
+ * Example usage:
+   <pre>
+ CanFrame_t xFrames[ 32 ];
+ UBaseType_t uxFrameCount;
+
+	uxFrameCount = uxReadFramesFromFifo( xFrames, 32 );
+
+	// Post the whole burst, waiting up to 10 ticks for space.
+	if( xQueueSendMultiple( xCanQueue, xFrames, uxFrameCount, ( TickType_t ) 10 ) != uxFrameCount )
+	{
+		// Not all of the frames could be posted.
+	}
+ </pre>
+ * \defgroup xQueueSendMultiple xQueueSendMultiple
+ * \ingroup QueueManagement
+ */
+UBaseType_t xQueueSendMultiple( QueueHandle_t xQueue, const void * const pvItemsToQueue, const UBaseType_t uxItemCount, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>
+ UBaseType_t xQueueReceiveMultiple(
+									   QueueHandle_t xQueue,
+									   void *pvBuffer,
+									   UBaseType_t uxMaxItems,
+									   TickType_t xTicksToWait
+								   );
+ * </pre>
+ *
+ * Receive up to uxMaxItems items from a queue in one critical section.  If the
+ * queue is empty the calling task blocks until at least one item is available,
+ * then receives every available item up to uxMaxItems.
+ *
+ * A task waiting to send to the queue is unblocked for each item received, up
+ * to the number of tasks that are waiting.
+ *
+ * This function must not be called from an interrupt service routine, or used
+ * with a semaphore or mutex.  See xQueueReceiveMultipleFromISR() for an
+ * alternative which may be used in an ISR.
+ *
+ * @param xQueue The handle to the queue from which the items are to be
+ * received.
+ *
+ * @param pvBuffer Pointer to a buffer with space for uxMaxItems items, into
+ * which the received items will be copied in the order they were queued.
+ *
+ * @param uxMaxItems The maximum number of items to receive.  Must be greater
+ * than zero.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block waiting
+ * for an item to become available should the queue be empty.
+ *
+ * @return The number of items received, which is 0 if the block time expired
+ * before any items became available.
+ *
+ * \defgroup xQueueReceiveMultiple xQueueReceiveMultiple
+ * \ingroup QueueManagement
+ */
+UBaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue, void * const pvBuffer, const UBaseType_t uxMaxItems, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
 /**
  * queue. h
  * <pre>UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue );</pre>
@@ -1384,6 +1490,94 @@ BaseType_t xQueueGiveFromISR( QueueHandle_t xQueue, BaseType_t * const pxHigherP
  */
 BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue, void * const pvBuffer, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * <pre>
+ UBaseType_t xQueueSendMultipleFromISR(
+										   QueueHandle_t xQueue,
+										   const void *pvItemsToQueue,
+										   UBaseType_t uxItemCount,
+										   BaseType_t *pxHigherPriorityTaskWoken
+									   );
+ * </pre>
+ *
+ * A version of xQueueSendMultiple() that can be called from an interrupt
+ * service routine.  As many of the items as there is space for are posted in
+ * one critical section, and the call never blocks.
+ *
+ * @param xQueue The handle to the queue on which the items are to be posted.
+ *
+ * @param pvItemsToQueue A pointer to an array of uxItemCount items, each the
+ * size the queue was created to hold.
+ *
+ * @param uxItemCount The number of items to post.
+ *
+ * @param pxHigherPriorityTaskWoken xQueueSendMultipleFromISR() will set
+ * *pxHigherPriorityTaskWoken to pdTRUE if posting the items caused a task to
+ * unblock, and the unblocked task has a priority higher than the currently
+ * running task.  If xQueueSendMultipleFromISR() sets this value to pdTRUE then
+ * a context switch should be requested before the interrupt is exited.
+ *
+ * @return The number of items posted, which is less than uxItemCount if the
+ * queue did not have space for them all.
+ *
+ * Example usage for buffered IO (where the ISR can obtain a burst of frames
+ * each call):
+   <pre>
+ void vCanRxISR( void )
+ {
+ BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+ CanFrame_t xFrames[ 40 ];
+ UBaseType_t uxFrameCount;
+
+	uxFrameCount = uxReadFramesFromFifo( xFrames, 40 );
+
+	// Post the whole burst at once.  A task waiting for frames is only woken
+	// once however many frames are posted.
+	xQueueSendMultipleFromISR( xCanQueue, xFrames, uxFrameCount, &xHigherPriorityTaskWoken );
+
+	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+ }
+ </pre>
+ * \defgroup xQueueSendMultipleFromISR xQueueSendMultipleFromISR
+ * \ingroup QueueManagement
+ */
+UBaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue, const void * const pvItemsToQueue, const UBaseType_t uxItemCount, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>
+ UBaseType_t xQueueReceiveMultipleFromISR(
+											  QueueHandle_t xQueue,
+											  void *pvBuffer,
+											  UBaseType_t uxMaxItems,
+											  BaseType_t *pxHigherPriorityTaskWoken
+										  );
+ * </pre>
+ *
+ * A version of xQueueReceiveMultiple() that can be called from an interrupt
+ * service routine.  Every available item up to uxMaxItems is received in one
+ * critical section, and the call never blocks.
+ *
+ * @param xQueue The handle to the queue from which the items are to be
+ * received.
+ *
+ * @param pvBuffer Pointer to a buffer with space for uxMaxItems items.
+ *
+ * @param uxMaxItems The maximum number of items to receive.
+ *
+ * @param pxHigherPriorityTaskWoken xQueueReceiveMultipleFromISR() will set
+ * *pxHigherPriorityTaskWoken to pdTRUE if receiving the items caused a task
+ * to unblock, and the unblocked task has a priority higher than the currently
+ * running task.
+ *
+ * @return The number of items received, which is 0 if the queue was empty.
+ *
+ * \defgroup xQueueReceiveMultipleFromISR xQueueReceiveMultipleFromISR
+ * \ingroup QueueManagement
+ */
+UBaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue, void * const pvBuffer, const UBaseType_t uxMaxItems, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /*
  * Utilities to query queues that are safe to use from an ISR.  These utilities
  * should be used only from witin an ISR, or within a critical section.
@@ -1639,6 +1833,128 @@ QueueSetMemberHandle_t xQueueSelectFromSet( QueueSetHandle_t xQueueSet, const Ti
  */
 QueueSetMemberHandle_t xQueueSelectFromSetFromISR( QueueSetHandle_t xQueueSet ) PRIVILEGED_FUNCTION;
 
+/*
+ * Queue wait sets allow a task to block until any one of up to 32 queues or
+ * semaphores can be read or taken, without the extra queue used by a queue set.
+ * configUSE_QUEUE_WAIT_SETS must be set to 1 in FreeRTOSConfig.h for the wait
+ * set API functions to be available.
+ *
+ * Each member of a wait set is given a bit number when it is added.  The wait
+ * set holds a bitmap in which the bit of a member is set while the member
+ * holds at least one item (or, for a semaphore, while its count is above
+ * zero), and is cleared when the member is emptied.  Sending to a member only
+ * sets its bit, and notifies the waiting task if no other member was ready, so
+ * the cost of a send does not depend on the length of the members.  The task
+ * learns from the bitmap returned by ulQueueWaitForAny() which members are
+ * ready, then reads them with the usual queue and semaphore functions.
+ *
+ * Note 1:  Only one task can block on a wait set at a time.  The task is
+ * unblocked by a task notification at the index passed to
+ * xQueueCreateWaitSet(), so the task must not use that notification index for
+ * any other purpose.
+ *
+ * Note 2:  A queue or semaphore can be a member of one wait set, and cannot be
+ * a member of a wait set and a queue set at the same time.
+ *
+ * Note 3:  Blocking on a wait set that contains a mutex will not cause the
+ * mutex holder to inherit the priority of the blocked task.
+ *
+ * @param uxIndexToNotify The index within the waiting task's array of task
+ * notification values used to unblock the task.  Must be less than
+ * configTASK_NOTIFICATION_ARRAY_ENTRIES.
+ *
+ * @return If the wait set is created successfully then a handle to the created
+ * wait set is returned.  Otherwise NULL is returned.
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	QueueWaitSetHandle_t xQueueCreateWaitSet( const UBaseType_t uxIndexToNotify ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Creates a queue wait set, as xQueueCreateWaitSet(), using the memory
+ * pointed to by pxWaitSetBuffer.
+ *
+ * @param uxIndexToNotify See xQueueCreateWaitSet().
+ *
+ * @param pxWaitSetBuffer Must point to a variable of type StaticQueueWaitSet_t,
+ * which will be used to hold the wait set's data structure.
+ *
+ * @return If pxWaitSetBuffer is not NULL then a handle to the created wait set
+ * is returned.  Otherwise NULL is returned.
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	QueueWaitSetHandle_t xQueueCreateWaitSetStatic( const UBaseType_t uxIndexToNotify, StaticQueueWaitSet_t *pxWaitSetBuffer ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Adds a queue or semaphore to a queue wait set.  If the queue already holds
+ * an item (or the semaphore can already be taken) the bit of the member is
+ * set straight away.
+ *
+ * @param xQueueOrSemaphore The handle of the queue or semaphore being added to
+ * the wait set (cast to a QueueSetMemberHandle_t type).
+ *
+ * @param xWaitSet The handle of the wait set to which the queue or semaphore is
+ * being added.
+ *
+ * @param uxBitNumber The number, 0 to 31, of the bit that represents the queue
+ * or semaphore in the bitmap returned by ulQueueWaitForAny().
+ *
+ * @return pdPASS if the queue or semaphore was added to the wait set.  pdFAIL
+ * if it is already a member of a wait set or a queue set, or if another member
+ * of the wait set already uses bit uxBitNumber.
+ */
+BaseType_t xQueueAddToWaitSet( QueueSetMemberHandle_t xQueueOrSemaphore, QueueWaitSetHandle_t xWaitSet, const UBaseType_t uxBitNumber ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes a queue or semaphore from a queue wait set.  Unlike a queue set, a
+ * member does not have to be empty to be removed.
+ *
+ * @param xQueueOrSemaphore The handle of the queue or semaphore being removed
+ * from the wait set (cast to a QueueSetMemberHandle_t type).
+ *
+ * @param xWaitSet The handle of the wait set in which the queue or semaphore is
+ * included.
+ *
+ * @return pdPASS if the queue or semaphore was removed from the wait set, or
+ * pdFAIL if it was not a member of the wait set.
+ */
+BaseType_t xQueueRemoveFromWaitSet( QueueSetMemberHandle_t xQueueOrSemaphore, QueueWaitSetHandle_t xWaitSet ) PRIVILEGED_FUNCTION;
+
+/*
+ * Blocks the calling task until at least one member of a queue wait set holds
+ * an item or can be taken, then returns the bits of all the members that do.
+ * The bits are not cleared by ulQueueWaitForAny(), but by reading the members
+ * until they are empty, so a member that still holds items after the task has
+ * read one of them is reported again by the next call.  Because another task
+ * or an interrupt can read a member too, a read of a member reported as ready
+ * should use a block time of zero and must check that it succeeded.
+ *
+ * @param xWaitSet The wait set on which the task will (potentially) block.
+ *
+ * @param xTicksToWait The maximum time, in ticks, that the calling task will
+ * remain in the Blocked state waiting for a member of the wait set to become
+ * ready.
+ *
+ * @return The bits of the members that are ready, or 0 if no member became
+ * ready before the block time expired.
+ */
+uint32_t ulQueueWaitForAny( QueueWaitSetHandle_t xWaitSet, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * A version of ulQueueWaitForAny() that can be used from an ISR.  It returns
+ * the bits of the members that are ready without blocking.
+ */
+uint32_t ulQueueWaitSetGetReadyFromISR( QueueWaitSetHandle_t xWaitSet ) PRIVILEGED_FUNCTION;
+
+/*
+ * Deletes a queue wait set.  All the members must have been removed from the
+ * wait set, and no task may be blocked on it.
+ *
+ * @param xWaitSet The handle of the wait set to delete.
+ */
+void vQueueDeleteWaitSet( QueueWaitSetHandle_t xWaitSet ) PRIVILEGED_FUNCTION;
+
 /* Not public API functions. */
 void vQueueWaitForMessageRestricted( QueueHandle_t xQueue, TickType_t xTicksToWait, const BaseType_t xWaitIndefinitely ) PRIVILEGED_FUNCTION;
 BaseType_t xQueueGenericReset( QueueHandle_t xQueue, BaseType_t xNewQueue ) PRIVILEGED_FUNCTION;
@@ -0,0 +1,237 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef RW_LOCK_H
+#define RW_LOCK_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h" must appear in source files before "include rw_lock.h"
+#endif
+
+/* FreeRTOS includes. */
+#include "task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A reader-writer lock guards data that is read by many tasks but written by
+ * few.  Any number of tasks can hold the lock for reading at the same time,
+ * but a task holding the lock for writing excludes every other task.
+ *
+ * Writers take preference over readers.  Once a task is waiting to take the
+ * lock for writing, tasks that try to take it for reading wait until every
+ * waiting writer has taken and given the lock (or timed out), so a stream of
+ * readers cannot starve a writer.  Taking and giving the lock for reading is
+ * a single atomic compare-and-swap when no writer holds or waits for the lock.
+ *
+ * The task holding the lock for writing inherits the priority of the highest
+ * priority task that is blocked waiting for the lock, in the same way as the
+ * holder of a mutex type semaphore.  Tasks holding the lock for reading are
+ * not tracked, so do not inherit a priority.
+ *
+ * Reader-writer locks cannot be taken recursively and must not be used from
+ * interrupts.  Set configUSE_RW_LOCKS to 1 in FreeRTOSConfig.h, and build
+ * rw_lock.c, to use them.
+ *
+ * \defgroup RWLock
+ */
+
+/**
+ * rw_lock.h
+ *
+ * Type by which reader-writer locks are referenced.  For example, a call to
+ * xRWLockCreate() returns an RWLockHandle_t variable that can then be used as
+ * a parameter to other reader-writer lock functions.
+ *
+ * \defgroup RWLockHandle_t RWLockHandle_t
+ * \ingroup RWLock
+ */
+struct RWLockDef_t;
+typedef struct RWLockDef_t * RWLockHandle_t;
+
+/**
+ * rw_lock.h
+ *<pre>
+ RWLockHandle_t xRWLockCreate( void );
+ </pre>
+ *
+ * Create a new reader-writer lock, using dynamically allocated memory to hold
+ * the lock structure.
+ *
+ * @return If the lock was created then a handle to the lock is returned.  If
+ * there was insufficient FreeRTOS heap available to create the lock then NULL
+ * is returned.
+ *
+ * \defgroup xRWLockCreate xRWLockCreate
+ * \ingroup RWLock
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	RWLockHandle_t xRWLockCreate( void ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * rw_lock.h
+ *<pre>
+ RWLockHandle_t xRWLockCreateStatic( StaticRWLock_t *pxLockBuffer );
+ </pre>
+ *
+ * Create a new reader-writer lock without using any dynamic memory
+ * allocation.
+ *
+ * @param pxLockBuffer Must point to a variable of type StaticRWLock_t, which
+ * will then be used to hold the lock's data structures.
+ *
+ * @return If the lock was created then a handle to the lock is returned.  If
+ * pxLockBuffer was NULL then NULL is returned.
+ *
+ * \defgroup xRWLockCreateStatic xRWLockCreateStatic
+ * \ingroup RWLock
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	RWLockHandle_t xRWLockCreateStatic( StaticRWLock_t *pxLockBuffer ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * rw_lock.h
+ *<pre>
+ BaseType_t xRWLockTakeRead( RWLockHandle_t xLock, TickType_t xTicksToWait );
+ </pre>
+ *
+ * Take a reader-writer lock for reading.  The lock can be taken for reading
+ * while other tasks hold it for reading, but not while a task holds it for
+ * writing or is waiting to take it for writing.
+ *
+ * @param xLock The handle of the lock being taken.
+ *
+ * @param xTicksToWait The maximum amount of time the calling task should wait
+ * for the lock to become available.  Setting xTicksToWait to 0 makes the
+ * function return immediately if the lock cannot be taken.
+ *
+ * @return pdPASS if the lock was taken for reading, otherwise pdFAIL.
+ *
+ * Example usage:
+   <pre>
+	if( xRWLockTakeRead( xLock, pdMS_TO_TICKS( 10 ) ) == pdPASS )
+	{
+		// Read the shared data, then release the lock.
+		xRWLockGiveRead( xLock );
+	}
+   </pre>
+ * \defgroup xRWLockTakeRead xRWLockTakeRead
+ * \ingroup RWLock
+ */
+BaseType_t xRWLockTakeRead( RWLockHandle_t xLock, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * rw_lock.h
+ *<pre>
+ BaseType_t xRWLockGiveRead( RWLockHandle_t xLock );
+ </pre>
+ *
+ * Release a reader-writer lock previously taken for reading by
+ * xRWLockTakeRead().  When the last reader gives the lock, the highest
+ * priority task waiting to take it for writing, if any, is unblocked.
+ *
+ * @param xLock The handle of the lock being released.
+ *
+ * @return pdPASS if the lock was released, or pdFAIL if the lock was not held
+ * for reading.
+ *
+ * \defgroup xRWLockGiveRead xRWLockGiveRead
+ * \ingroup RWLock
+ */
+BaseType_t xRWLockGiveRead( RWLockHandle_t xLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rw_lock.h
+ *<pre>
+ BaseType_t xRWLockTakeWrite( RWLockHandle_t xLock, TickType_t xTicksToWait );
+ </pre>
+ *
+ * Take a reader-writer lock for writing.  The lock can only be taken for
+ * writing when no other task holds it.  The calling task must not already hold
+ * the lock.
+ *
+ * @param xLock The handle of the lock being taken.
+ *
+ * @param xTicksToWait The maximum amount of time the calling task should wait
+ * for the lock to become available.  Setting xTicksToWait to 0 makes the
+ * function return immediately if the lock cannot be taken.
+ *
+ * @return pdPASS if the lock was taken for writing, otherwise pdFAIL.
+ *
+ * \defgroup xRWLockTakeWrite xRWLockTakeWrite
+ * \ingroup RWLock
+ */
+BaseType_t xRWLockTakeWrite( RWLockHandle_t xLock, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * rw_lock.h
+ *<pre>
+ BaseType_t xRWLockGiveWrite( RWLockHandle_t xLock );
+ </pre>
+ *
+ * Release a reader-writer lock previously taken for writing by
+ * xRWLockTakeWrite().  If the calling task inherited a priority while it held
+ * the lock then the priority is restored.  If another task is waiting to take
+ * the lock for writing then the highest priority such task is unblocked,
+ * otherwise all the tasks waiting to take the lock for reading are unblocked.
+ *
+ * @param xLock The handle of the lock being released.
+ *
+ * @return pdPASS if the lock was released, or pdFAIL if the calling task did
+ * not hold the lock for writing.
+ *
+ * \defgroup xRWLockGiveWrite xRWLockGiveWrite
+ * \ingroup RWLock
+ */
+BaseType_t xRWLockGiveWrite( RWLockHandle_t xLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rw_lock.h
+ *<pre>
+ void vRWLockDelete( RWLockHandle_t xLock );
+ </pre>
+ *
+ * Delete a reader-writer lock that was previously created by a call to
+ * xRWLockCreate() or xRWLockCreateStatic().  The lock must not be held, and no
+ * tasks can be waiting for it, when it is deleted.
+ *
+ * @param xLock The handle of the lock being deleted.
+ *
+ * \defgroup vRWLockDelete vRWLockDelete
+ * \ingroup RWLock
+ */
+void vRWLockDelete( RWLockHandle_t xLock ) PRIVILEGED_FUNCTION;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RW_LOCK_H */
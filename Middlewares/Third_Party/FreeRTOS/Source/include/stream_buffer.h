@@ -68,6 +68,21 @@ extern "C" {
 struct StreamBufferDef_t;
 typedef struct StreamBufferDef_t * StreamBufferHandle_t;
 
+/**
+ * Type used to describe part of a stream buffer's storage area that is written
+ * or read in place by xStreamBufferSendReserve(), xStreamBufferReceiveAcquire(),
+ * etc.  The storage area is circular, so the bytes are described as up to two
+ * spans.  pucSecond is only used (and is otherwise NULL) if the bytes wrap
+ * around from the end of the storage area to its start.
+ */
+typedef struct StreamBufferRegion
+{
+	uint8_t *pucFirst;			/* Start of the first span. */
+	size_t xFirstLengthBytes;	/* Number of bytes in the first span. */
+	uint8_t *pucSecond;			/* Start of the second span, which is always the start of the storage area, or NULL if there is no second span. */
+	size_t xSecondLengthBytes;	/* Number of bytes in the second span, or 0. */
+} StreamBufferRegion_t;
+
 
 /**
  * message_buffer.h
@@ -833,6 +848,319 @@ BaseType_t xStreamBufferReceiveCompletedFromISR( StreamBufferHandle_t xStreamBuf
  */
 BaseType_t xStreamBufferReceiveCompletedFromISR( StreamBufferHandle_t xStreamBuffer, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferSendReserve( StreamBufferHandle_t xStreamBuffer,
+                                 size_t xDataLengthBytes,
+                                 StreamBufferRegion_t * const pxRegion,
+                                 TickType_t xTicksToWait );
+</pre>
+ *
+ * Reserves space in a stream buffer so data can be written directly into the
+ * buffer's storage area, rather than being copied in by xStreamBufferSend().
+ * The data becomes visible to the reader when xStreamBufferSendCommit() is
+ * called.  The storage area is circular, so the reserved space is returned as
+ * up to two spans in *pxRegion - the bytes written to the first span are
+ * followed by the bytes written to the second.
+ *
+ * The same single writer rules as xStreamBufferSend() apply.  Nothing else can
+ * write to the stream buffer between the call to xStreamBufferSendReserve()
+ * and the matching call to xStreamBufferSendCommit().
+ *
+ * Use xStreamBufferSendReserve() to reserve space from a task.  Use
+ * xStreamBufferSendReserveFromISR() to reserve space from an interrupt service
+ * routine (ISR).
+ *
+ * @param xStreamBuffer The handle of the stream buffer in which space is being
+ * reserved.
+ *
+ * @param xDataLengthBytes The maximum number of bytes to reserve.  As per
+ * xStreamBufferSend(), a stream buffer reserves as many bytes as possible up to
+ * this value, whereas a message buffer reserves space for the whole message or
+ * nothing at all.
+ *
+ * @param pxRegion Used to pass out the spans that make up the reserved space.
+ * Both spans are zero length if no space was reserved.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for xDataLengthBytes bytes of space to become
+ * available, as per xStreamBufferSend().
+ *
+ * @return The number of bytes reserved, which is the sum of the lengths of the
+ * two spans.
+ *
+ * Example use:
+<pre>
+void vAFunction( StreamBufferHandle_t xStreamBuffer )
+{
+StreamBufferRegion_t xRegion;
+size_t xReserved, xWritten;
+const TickType_t x100ms = pdMS_TO_TICKS( 100 );
+
+    // Reserve up to 64 bytes.
+    xReserved = xStreamBufferSendReserve( xStreamBuffer, 64, &xRegion, x100ms );
+
+    if( xReserved > 0 )
+    {
+        // Write directly into the stream buffer, for example by pointing DMA
+        // at xRegion.pucFirst then xRegion.pucSecond.
+        xWritten = prvFillFromPeripheral( xRegion.pucFirst, xRegion.xFirstLengthBytes );
+
+        if( ( xWritten == xRegion.xFirstLengthBytes ) && ( xRegion.pucSecond != NULL ) )
+        {
+            xWritten += prvFillFromPeripheral( xRegion.pucSecond, xRegion.xSecondLengthBytes );
+        }
+
+        // Make the bytes written visible to the reader.
+        xStreamBufferSendCommit( xStreamBuffer, xWritten );
+    }
+}
+</pre>
+ * \defgroup xStreamBufferSendReserve xStreamBufferSendReserve
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferSendReserve( StreamBufferHandle_t xStreamBuffer,
+								 size_t xDataLengthBytes,
+								 StreamBufferRegion_t * const pxRegion,
+								 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferSendReserveFromISR( StreamBufferHandle_t xStreamBuffer,
+                                        size_t xDataLengthBytes,
+                                        StreamBufferRegion_t * const pxRegion );
+</pre>
+ *
+ * An interrupt safe version of xStreamBufferSendReserve().  The parameters and
+ * return value are as per xStreamBufferSendReserve(), other than that
+ * xStreamBufferSendReserveFromISR() never blocks.
+ *
+ * \defgroup xStreamBufferSendReserveFromISR xStreamBufferSendReserveFromISR
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferSendReserveFromISR( StreamBufferHandle_t xStreamBuffer,
+										size_t xDataLengthBytes,
+										StreamBufferRegion_t * const pxRegion ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer,
+                                size_t xDataLengthBytes );
+</pre>
+ *
+ * Makes data written in place into space obtained from
+ * xStreamBufferSendReserve() available to the reader.  If this takes the
+ * number of bytes in the buffer to or above the trigger level then a task
+ * blocked waiting for data is unblocked, exactly as if the data had been sent
+ * using xStreamBufferSend().
+ *
+ * Use xStreamBufferSendCommit() from a task.  Use
+ * xStreamBufferSendCommitFromISR() from an interrupt service routine (ISR).
+ *
+ * @param xStreamBuffer The handle of the stream buffer in which space was
+ * reserved.
+ *
+ * @param xDataLengthBytes The number of bytes actually written, which must not
+ * be more than the number of bytes reserved.  Bytes are taken from the first
+ * span before the second.  If the stream buffer is being used as a message
+ * buffer then xDataLengthBytes is the length of the message, and committing 0
+ * bytes discards the message.
+ *
+ * @return The number of bytes committed.
+ *
+ * \defgroup xStreamBufferSendCommit xStreamBufferSendCommit
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer,
+								size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferSendCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+                                       size_t xDataLengthBytes,
+                                       BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * An interrupt safe version of xStreamBufferSendCommit().
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if committing the data
+ * unblocked a task that has a priority above the currently executing task, as
+ * per xStreamBufferSendFromISR().
+ *
+ * \defgroup xStreamBufferSendCommitFromISR xStreamBufferSendCommitFromISR
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferSendCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+									   size_t xDataLengthBytes,
+									   BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer,
+                                    StreamBufferRegion_t * const pxRegion,
+                                    TickType_t xTicksToWait );
+</pre>
+ *
+ * Obtains direct access to the data held in a stream buffer so it can be
+ * processed in place, rather than being copied out by xStreamBufferReceive().
+ * The data stays in the buffer until xStreamBufferReceiveRelease() is called.
+ * The storage area is circular, so the data is returned as up to two spans in
+ * *pxRegion - the bytes in the first span are followed by the bytes in the
+ * second.
+ *
+ * The same single reader rules as xStreamBufferReceive() apply.  Nothing else
+ * can read from the stream buffer between the call to
+ * xStreamBufferReceiveAcquire() and the matching call to
+ * xStreamBufferReceiveRelease().
+ *
+ * Use xStreamBufferReceiveAcquire() from a task.  Use
+ * xStreamBufferReceiveAcquireFromISR() from an interrupt service routine
+ * (ISR).
+ *
+ * @param xStreamBuffer The handle of the stream buffer from which data is
+ * being acquired.
+ *
+ * @param pxRegion Used to pass out the spans that hold the data.  If the
+ * stream buffer is being used as a stream buffer then the spans cover all the
+ * bytes in the buffer.  If the stream buffer is being used as a message buffer
+ * then the spans cover the next message, excluding its length.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for data to become available, as per
+ * xStreamBufferReceive().
+ *
+ * @return The number of bytes acquired, which is the sum of the lengths of the
+ * two spans.
+ *
+ * Example use:
+<pre>
+void vAFunction( StreamBufferHandle_t xStreamBuffer )
+{
+StreamBufferRegion_t xRegion;
+size_t xAcquired;
+
+    xAcquired = xStreamBufferReceiveAcquire( xStreamBuffer, &xRegion, portMAX_DELAY );
+
+    if( xAcquired > 0 )
+    {
+        // Process the data where it is.
+        prvProcess( xRegion.pucFirst, xRegion.xFirstLengthBytes );
+
+        if( xRegion.pucSecond != NULL )
+        {
+            prvProcess( xRegion.pucSecond, xRegion.xSecondLengthBytes );
+        }
+
+        // Free the space so the writer can use it again.
+        xStreamBufferReceiveRelease( xStreamBuffer, xAcquired );
+    }
+}
+</pre>
+ * \defgroup xStreamBufferReceiveAcquire xStreamBufferReceiveAcquire
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer,
+									StreamBufferRegion_t * const pxRegion,
+									TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferReceiveAcquireFromISR( StreamBufferHandle_t xStreamBuffer,
+                                           StreamBufferRegion_t * const pxRegion );
+</pre>
+ *
+ * An interrupt safe version of xStreamBufferReceiveAcquire().  The parameters
+ * and return value are as per xStreamBufferReceiveAcquire(), other than that
+ * xStreamBufferReceiveAcquireFromISR() never blocks.
+ *
+ * \defgroup xStreamBufferReceiveAcquireFromISR xStreamBufferReceiveAcquireFromISR
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferReceiveAcquireFromISR( StreamBufferHandle_t xStreamBuffer,
+										   StreamBufferRegion_t * const pxRegion ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferReceiveRelease( StreamBufferHandle_t xStreamBuffer,
+                                    size_t xDataLengthBytes );
+</pre>
+ *
+ * Removes data obtained from xStreamBufferReceiveAcquire() from the stream
+ * buffer, making the space available to the writer again.  A task blocked
+ * waiting for space is unblocked, exactly as if the data had been read using
+ * xStreamBufferReceive().
+ *
+ * Use xStreamBufferReceiveRelease() from a task.  Use
+ * xStreamBufferReceiveReleaseFromISR() from an interrupt service routine
+ * (ISR).
+ *
+ * @param xStreamBuffer The handle of the stream buffer from which data was
+ * acquired.
+ *
+ * @param xDataLengthBytes The number of bytes to remove.  A stream buffer can
+ * release fewer bytes than were acquired, in which case the bytes are taken
+ * from the first span before the second.  A message buffer must release the
+ * whole message, so xDataLengthBytes must equal the value returned by
+ * xStreamBufferReceiveAcquire().
+ *
+ * @return The number of bytes removed from the stream buffer.
+ *
+ * \defgroup xStreamBufferReceiveRelease xStreamBufferReceiveRelease
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferReceiveRelease( StreamBufferHandle_t xStreamBuffer,
+									size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferReceiveReleaseFromISR( StreamBufferHandle_t xStreamBuffer,
+                                           size_t xDataLengthBytes,
+                                           BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * An interrupt safe version of xStreamBufferReceiveRelease().
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if releasing the data
+ * unblocked a task that has a priority above the currently executing task, as
+ * per xStreamBufferReceiveFromISR().
+ *
+ * \defgroup xStreamBufferReceiveReleaseFromISR xStreamBufferReceiveReleaseFromISR
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferReceiveReleaseFromISR( StreamBufferHandle_t xStreamBuffer,
+										   size_t xDataLengthBytes,
+										   BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*
+ * The functions defined above are for passing data to and from tasks.  The
+ * functions below are the equivalents for passing data to and from
+ * co-routines.
+ *
+ * These functions are called from the co-routine macro implementation and
+ * should not be called directly from application code.  Instead use the macro
+ * wrappers defined within croutine.h.
+ */
+#if( configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS == 1 )
+	BaseType_t xStreamBufferCRSend( StreamBufferHandle_t xStreamBuffer, const void *pvTxData, size_t xDataLengthBytes, size_t *pxBytesSent, TickType_t xTicksToWait );
+	BaseType_t xStreamBufferCRReceive( StreamBufferHandle_t xStreamBuffer, void *pvRxData, size_t xBufferLengthBytes, size_t *pxBytesReceived, TickType_t xTicksToWait );
+#endif
+
 /* Functions below here are not part of the public API. */
 StreamBufferHandle_t xStreamBufferGenericCreate( size_t xBufferSizeBytes,
 												 size_t xTriggerLevelBytes,
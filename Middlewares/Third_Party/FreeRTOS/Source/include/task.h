@@ -69,6 +69,13 @@ extern "C" {
 struct tskTaskControlBlock; /* The old naming convention is used to prevent breaking kernel aware debuggers. */
 typedef struct tskTaskControlBlock* TaskHandle_t;
 
+/*
+ * Type by which task pools are referenced.  A call to xTaskPoolCreate()
+ * returns a TaskPoolHandle_t that can then be passed to xTaskCreateFromPool().
+ */
+struct tskTaskPool;
+typedef struct tskTaskPool* TaskPoolHandle_t;
+
 /*
  * Defines the prototype to which the application task hook function must
  * conform.
@@ -147,6 +154,17 @@ typedef struct xTASK_STATUS
 	configSTACK_DEPTH_TYPE usStackHighWaterMark;	/* The minimum amount of stack space that has remained for the task since the task was created.  The closer this value is to zero the closer the task has come to overflowing its stack. */
 } TaskStatus_t;
 
+/* Used with the uxTaskGetStackUsage() function to return the stack use of each
+task in the system.  All sizes are in words. */
+typedef struct xTASK_STACK_USAGE
+{
+	TaskHandle_t xHandle;			/* The handle of the task to which the rest of the information in the structure relates. */
+	const char *pcTaskName;			/* A pointer to the task's name.  This value will be invalid if the task was deleted since the structure was populated! */ /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+	configSTACK_DEPTH_TYPE usStackDepth;			/* The size of the task's stack. */
+	configSTACK_DEPTH_TYPE usStackHighWaterMark;	/* The minimum amount of stack space that has remained for the task, as tracked each time the task is switched out. */
+	configSTACK_DEPTH_TYPE usSuggestedStackDepth;	/* The most stack the task has used plus the requested margin, as a suggestion for the stack size to create the task with. */
+} TaskStackUsage_t;
+
 /* Possible return values for eTaskConfirmSleepModeStatus(). */
 typedef enum
 {
@@ -162,6 +180,15 @@ typedef enum
  */
 #define tskIDLE_PRIORITY			( ( UBaseType_t ) 0U )
 
+/**
+ * The index of the notification used by the task notification API functions
+ * that do not take an index parameter, and by the kernel itself (for example
+ * by stream buffers).
+ *
+ * \ingroup TaskNotifications
+ */
+#define tskDEFAULT_INDEX_TO_NOTIFY	( 0 )
+
 /**
  * task. h
  *
@@ -705,6 +732,119 @@ void vTaskAllocateMPURegions( TaskHandle_t xTask, const MemoryRegion_t * const p
  */
 void vTaskDelete( TaskHandle_t xTaskToDelete ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ * <pre>TaskPoolHandle_t xTaskPoolCreate( UBaseType_t uxTaskCount, configSTACK_DEPTH_TYPE usStackDepth, BaseType_t xFillStackOnReuse );</pre>
+ *
+ * configUSE_TASK_POOLS must be set to 1 in FreeRTOSConfig.h for this function
+ * to be available.
+ *
+ * Create a pool of uxTaskCount TCBs, each with a stack of usStackDepth words,
+ * from which tasks can then be created by xTaskCreateFromPool() without
+ * allocating any memory.  All the memory used by the pool is allocated by this
+ * function.  Pools cannot be deleted.
+ *
+ * When a task created from a pool is deleted its TCB and stack are returned to
+ * the pool.  A task deleted by another task is returned to the pool by
+ * vTaskDelete().  A task that deletes itself is still using its stack, so it is
+ * returned to the pool when the idle task cleans up deleted tasks, or sooner if
+ * xTaskCreateFromPool() finds the pool empty.
+ *
+ * @param uxTaskCount The number of tasks the pool can hold at once.
+ *
+ * @param usStackDepth The size of the stack of each task in the pool, in
+ * words, as the usStackDepth parameter of xTaskCreate().
+ *
+ * @param xFillStackOnReuse If the kernel is configured to fill new stacks with
+ * a known value (to find the stack high water mark or check for stack
+ * overflow) then the stacks in the pool are filled when the pool is created.
+ * Set xFillStackOnReuse to pdTRUE to fill a stack again each time it is reused,
+ * as xTaskCreate() does, or to pdFALSE to skip the fill and create tasks faster.
+ * When the fill is skipped the stack high water mark of a task reflects the
+ * most stack used by any task that has used the same stack.
+ *
+ * @return A handle to the pool, or NULL if the pool could not be created
+ * because there was insufficient heap memory.
+ *
+ * Example usage:
+   <pre>
+ TaskPoolHandle_t xWorkerPool;
+
+ void vStartWorkers( void )
+ {
+	// Create a pool that can hold 8 worker tasks, each with a 256 word
+	// stack, that does not refill the stacks when they are reused.
+	xWorkerPool = xTaskPoolCreate( 8, 256, pdFALSE );
+	configASSERT( xWorkerPool );
+ }
+
+ void vHandleRequest( void *pvRequest )
+ {
+	// Start a worker for the request.  The worker deletes itself by calling
+	// vTaskDelete( NULL ) when the request is complete.
+	if( xTaskCreateFromPool( xWorkerPool, vWorkerTask, "Worker", pvRequest, tskIDLE_PRIORITY + 1, NULL ) != pdPASS )
+	{
+		// All the tasks in the pool are in use.
+	}
+ }
+   </pre>
+ * \defgroup xTaskPoolCreate xTaskPoolCreate
+ * \ingroup Tasks
+ */
+#if( configUSE_TASK_POOLS == 1 )
+	TaskPoolHandle_t xTaskPoolCreate( UBaseType_t uxTaskCount, configSTACK_DEPTH_TYPE usStackDepth, BaseType_t xFillStackOnReuse ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * task. h
+ * <pre>BaseType_t xTaskCreateFromPool( TaskPoolHandle_t xTaskPool, TaskFunction_t pvTaskCode, const char * const pcName, void *pvParameters, UBaseType_t uxPriority, TaskHandle_t *pvCreatedTask );</pre>
+ *
+ * configUSE_TASK_POOLS must be set to 1 in FreeRTOSConfig.h for this function
+ * to be available.
+ *
+ * Create a new task using a TCB and stack taken from a pool created by
+ * xTaskPoolCreate(), rather than allocating them.  The parameters other than
+ * xTaskPool are the same as those of xTaskCreate(), except that the stack size
+ * is that given when the pool was created.
+ *
+ * @param xTaskPool The pool from which to take the TCB and stack.
+ *
+ * @return pdPASS if the task was successfully created and added to a ready
+ * list, otherwise errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY if every TCB in the
+ * pool is in use.
+ *
+ * \defgroup xTaskCreateFromPool xTaskCreateFromPool
+ * \ingroup Tasks
+ */
+#if( configUSE_TASK_POOLS == 1 )
+	BaseType_t xTaskCreateFromPool(	TaskPoolHandle_t xTaskPool,
+									TaskFunction_t pxTaskCode,
+									const char * const pcName,	/*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+									void * const pvParameters,
+									UBaseType_t uxPriority,
+									TaskHandle_t * const pxCreatedTask ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * task. h
+ * <pre>UBaseType_t uxTaskPoolGetFreeCount( TaskPoolHandle_t xTaskPool );</pre>
+ *
+ * configUSE_TASK_POOLS must be set to 1 in FreeRTOSConfig.h for this function
+ * to be available.
+ *
+ * @param xTaskPool The pool being queried.
+ *
+ * @return The number of TCBs in the pool that are ready to be used by
+ * xTaskCreateFromPool().  Tasks from the pool that have deleted themselves but
+ * have not yet been returned to the pool are not included.
+ *
+ * \defgroup uxTaskPoolGetFreeCount uxTaskPoolGetFreeCount
+ * \ingroup Tasks
+ */
+#if( configUSE_TASK_POOLS == 1 )
+	UBaseType_t uxTaskPoolGetFreeCount( TaskPoolHandle_t xTaskPool ) PRIVILEGED_FUNCTION;
+#endif
+
 /*-----------------------------------------------------------
  * TASK CONTROL API
  *----------------------------------------------------------*/
@@ -816,6 +956,80 @@ void vTaskDelay( const TickType_t xTicksToDelay ) PRIVILEGED_FUNCTION;
  */
 void vTaskDelayUntil( TickType_t * const pxPreviousWakeTime, const TickType_t xTimeIncrement ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ * <pre>void vTaskSetDeadline( TaskHandle_t xTask, TickType_t xRelativeDeadline );</pre>
+ *
+ * configUSE_EDF_SCHEDULING must be defined as 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * Tasks of priority configEDF_TASK_PRIORITY are scheduled earliest deadline
+ * first - of the Ready state tasks at that priority, the one whose current job
+ * has the earliest absolute deadline runs.  Tasks of a higher priority still
+ * preempt them, and tasks of a lower priority only run when none of them are
+ * ready, so configEDF_TASK_PRIORITY sets where the deadline scheduled tasks sit
+ * relative to the fixed priority tasks.
+ *
+ * A job of a task is released each time the task returns from
+ * vTaskDelayUntil(), and must complete, by the task calling vTaskDelayUntil()
+ * again, within xRelativeDeadline ticks of the time it was released.  Jobs that
+ * complete after their deadline are counted, see ulTaskGetDeadlineMisses().
+ * Calling vTaskSetDeadline() releases the current job of the task at the time
+ * of the call.
+ *
+ * @param xTask The handle of the task whose deadline is being set.  Passing a
+ * NULL handle results in the deadline of the calling task being set.
+ *
+ * @param xRelativeDeadline The time, in ticks, each job of the task has to
+ * complete in, which is normally the period passed to vTaskDelayUntil().
+ * Passing 0 removes the deadline, and a task at configEDF_TASK_PRIORITY without
+ * a deadline runs before the tasks that have one.  Tasks are only normally at
+ * that priority without a deadline because they have inherited it.
+ *
+ * Example usage:
+   <pre>
+ // Perform an action every 10 ticks, completing within 8 ticks.
+ void vTaskFunction( void * pvParameters )
+ {
+ TickType_t xLastWakeTime;
+ const TickType_t xPeriod = 10, xDeadline = 8;
+
+	 // The task was created with a priority of configEDF_TASK_PRIORITY.
+	 vTaskSetDeadline( NULL, xDeadline );
+	 xLastWakeTime = xTaskGetTickCount();
+
+	 for( ;; )
+	 {
+		 // Perform action here.
+
+		 // Wait for the next release.
+		 vTaskDelayUntil( &xLastWakeTime, xPeriod );
+	 }
+ }
+   </pre>
+ * \defgroup vTaskSetDeadline vTaskSetDeadline
+ * \ingroup TaskCtrl
+ */
+void vTaskSetDeadline( TaskHandle_t xTask, TickType_t xRelativeDeadline ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>uint32_t ulTaskGetDeadlineMisses( TaskHandle_t xTask );</pre>
+ *
+ * configUSE_EDF_SCHEDULING must be defined as 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * @param xTask The handle of the task being queried.  Passing a NULL handle
+ * results in the count of the calling task being returned.
+ *
+ * @return The number of jobs of the task that completed after their deadline
+ * since the task was created.  See vTaskSetDeadline().
+ *
+ * \defgroup ulTaskGetDeadlineMisses ulTaskGetDeadlineMisses
+ * \ingroup TaskCtrl
+ */
+uint32_t ulTaskGetDeadlineMisses( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
 /**
  * task. h
  * <pre>BaseType_t xTaskAbortDelay( TaskHandle_t xTask );</pre>
@@ -1468,6 +1682,64 @@ UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask ) PRIVILEGED_FUNCTIO
  */
 configSTACK_DEPTH_TYPE uxTaskGetStackHighWaterMark2( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
 
+/**
+ * task.h
+ * <PRE>configSTACK_DEPTH_TYPE uxTaskGetTrackedStackHighWaterMark( TaskHandle_t xTask );</PRE>
+ *
+ * configUSE_STACK_WATERMARK_TRACKING must be set to 1 in FreeRTOSConfig.h for
+ * this function to be available.
+ *
+ * Returns the same value as uxTaskGetStackHighWaterMark2(), but from a
+ * watermark the kernel moves each time the task is switched out rather than by
+ * searching the stack, so it takes constant time and can be used in production
+ * code.  When the task is switched out the watermark moves to its saved stack
+ * pointer, then on past any written word found before
+ * configSTACK_WATERMARK_GAP_WORDS unwritten words in a row (16 by default).
+ * A longer run of stack that is reserved but never written, such as the unused
+ * end of a large local array, can hide deeper use until the stack pointer is
+ * saved beyond it.  The value returned is then larger than that returned by
+ * uxTaskGetStackHighWaterMark2().
+ *
+ * @param xTask Handle of the task associated with the stack to be checked.
+ * Set xTask to NULL to check the stack of the calling task.
+ *
+ * @return The smallest amount of free stack space there has been (in words)
+ * since the task referenced by xTask was created.
+ */
+configSTACK_DEPTH_TYPE uxTaskGetTrackedStackHighWaterMark( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * task.h
+ * <PRE>UBaseType_t uxTaskGetStackUsage( TaskStackUsage_t * const pxStackUsageArray, const UBaseType_t uxArraySize, const UBaseType_t uxMarginPercent );</PRE>
+ *
+ * configUSE_STACK_WATERMARK_TRACKING must be set to 1 in FreeRTOSConfig.h for
+ * this function to be available.
+ *
+ * Populates a TaskStackUsage_t structure for each task in the system with the
+ * size of its stack, its tracked high water mark (see
+ * uxTaskGetTrackedStackHighWaterMark()) and a suggested stack size - the most
+ * stack the task has used plus uxMarginPercent percent.  The suggestion is only
+ * as good as the coverage of the run before the call, so run every path of
+ * each task, including error paths, before acting on it.
+ *
+ * NOTE: This function suspends the scheduler while the structures are
+ * populated, for a time proportional to the number of tasks.
+ *
+ * @param pxStackUsageArray A pointer to an array of TaskStackUsage_t
+ * structures.  The array must contain at least one structure for each task
+ * under the control of the RTOS, see uxTaskGetNumberOfTasks().
+ *
+ * @param uxArraySize The size of the array pointed to by pxStackUsageArray.
+ *
+ * @param uxMarginPercent The margin to add to the most stack each task has
+ * used to get the suggested stack size, as a percentage.
+ *
+ * @return The number of TaskStackUsage_t structures that were populated by
+ * the function.  This will be zero if the uxArraySize parameter was too
+ * small.
+ */
+UBaseType_t uxTaskGetStackUsage( TaskStackUsage_t * const pxStackUsageArray, const UBaseType_t uxArraySize, const UBaseType_t uxMarginPercent ) PRIVILEGED_FUNCTION;
+
 /* When using trace macros it is sometimes necessary to include task.h before
 FreeRTOS.h.  When this is done TaskHookFunction_t will not yet have been defined,
 so the following two prototypes will cause a compilation error.  This can be
@@ -1774,12 +2046,25 @@ uint32_t ulTaskGetIdleRunTimeCounter( void ) PRIVILEGED_FUNCTION;
 /**
  * task. h
  * <PRE>BaseType_t xTaskNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction );</PRE>
+ * <PRE>BaseType_t xTaskNotifyIndexed( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction );</PRE>
  *
- * configUSE_TASK_NOTIFICATIONS must be undefined or defined as 1 for this
- * function to be available.
+ * configUSE_TASK_NOTIFICATIONS must be undefined or defined as 1 for these
+ * functions to be available.
  *
  * When configUSE_TASK_NOTIFICATIONS is set to one each task has its own private
- * "notification value", which is a 32-bit unsigned integer (uint32_t).
+ * array of configTASK_NOTIFICATION_ARRAY_ENTRIES "notification values", each of
+ * which is a 32-bit unsigned integer (uint32_t), and each of which has its own
+ * notification state.  configTASK_NOTIFICATION_ARRAY_ENTRIES defaults to 1.
+ *
+ * Each index of the array can be used for a different purpose, for example one
+ * index as a binary semaphore used by a driver and another as an event flags
+ * word used by the application.  The functions with "Indexed" in their name
+ * take the index of the notification value to act on.  The functions without
+ * "Indexed" in their name always act on the notification value at index 0
+ * (tskDEFAULT_INDEX_TO_NOTIFY), so xTaskNotify( xTask, ulValue, eAction ) is
+ * equivalent to xTaskNotifyIndexed( xTask, 0, ulValue, eAction ).  Stream and
+ * message buffers also use index 0, so application code that uses stream or
+ * message buffers should use other indexes for its own notifications.
  *
  * Events can be sent to a task using an intermediary object.  Examples of such
  * objects are queues, semaphores, mutexes and event groups.  Task notifications
@@ -1809,6 +2094,11 @@ uint32_t ulTaskGetIdleRunTimeCounter( void ) PRIVILEGED_FUNCTION;
  * task, and the handle of the currently running task can be obtained by calling
  * xTaskGetCurrentTaskHandle().
  *
+ * @param uxIndexToNotify The index within the target task's array of
+ * notification values to which the notification is to be sent.  uxIndexToNotify
+ * must be less than configTASK_NOTIFICATION_ARRAY_ENTRIES.  xTaskNotify() does
+ * not have this parameter and always sends notifications to index 0.
+ *
  * @param ulValue Data that can be sent with the notification.  How the data is
  * used depends on the value of the eAction parameter.
  *
@@ -1850,13 +2140,16 @@ uint32_t ulTaskGetIdleRunTimeCounter( void ) PRIVILEGED_FUNCTION;
  * \defgroup xTaskNotify xTaskNotify
  * \ingroup TaskNotifications
  */
-BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue ) PRIVILEGED_FUNCTION;
-#define xTaskNotify( xTaskToNotify, ulValue, eAction ) xTaskGenericNotify( ( xTaskToNotify ), ( ulValue ), ( eAction ), NULL )
-#define xTaskNotifyAndQuery( xTaskToNotify, ulValue, eAction, pulPreviousNotifyValue ) xTaskGenericNotify( ( xTaskToNotify ), ( ulValue ), ( eAction ), ( pulPreviousNotifyValue ) )
+BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue ) PRIVILEGED_FUNCTION;
+#define xTaskNotify( xTaskToNotify, ulValue, eAction ) xTaskGenericNotify( ( xTaskToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( ulValue ), ( eAction ), NULL )
+#define xTaskNotifyIndexed( xTaskToNotify, uxIndexToNotify, ulValue, eAction ) xTaskGenericNotify( ( xTaskToNotify ), ( uxIndexToNotify ), ( ulValue ), ( eAction ), NULL )
+#define xTaskNotifyAndQuery( xTaskToNotify, ulValue, eAction, pulPreviousNotifyValue ) xTaskGenericNotify( ( xTaskToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( ulValue ), ( eAction ), ( pulPreviousNotifyValue ) )
+#define xTaskNotifyAndQueryIndexed( xTaskToNotify, uxIndexToNotify, ulValue, eAction, pulPreviousNotifyValue ) xTaskGenericNotify( ( xTaskToNotify ), ( uxIndexToNotify ), ( ulValue ), ( eAction ), ( pulPreviousNotifyValue ) )
 
 /**
  * task. h
  * <PRE>BaseType_t xTaskNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken );</PRE>
+ * <PRE>BaseType_t xTaskNotifyIndexedFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken );</PRE>
  *
  * configUSE_TASK_NOTIFICATIONS must be undefined or defined as 1 for this
  * function to be available.
@@ -1895,6 +2188,11 @@ BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNo
  * task, and the handle of the currently running task can be obtained by calling
  * xTaskGetCurrentTaskHandle().
  *
+ * @param uxIndexToNotify The index within the target task's array of
+ * notification values to which the notification is to be sent.  uxIndexToNotify
+ * must be less than configTASK_NOTIFICATION_ARRAY_ENTRIES.  xTaskNotifyFromISR()
+ * does not have this parameter and always sends notifications to index 0.
+ *
  * @param ulValue Data that can be sent with the notification.  How the data is
  * used depends on the value of the eAction parameter.
  *
@@ -1941,13 +2239,16 @@ BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNo
  * \defgroup xTaskNotify xTaskNotify
  * \ingroup TaskNotifications
  */
-BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
-#define xTaskNotifyFromISR( xTaskToNotify, ulValue, eAction, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( ulValue ), ( eAction ), NULL, ( pxHigherPriorityTaskWoken ) )
-#define xTaskNotifyAndQueryFromISR( xTaskToNotify, ulValue, eAction, pulPreviousNotificationValue, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( ulValue ), ( eAction ), ( pulPreviousNotificationValue ), ( pxHigherPriorityTaskWoken ) )
+BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#define xTaskNotifyFromISR( xTaskToNotify, ulValue, eAction, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( ulValue ), ( eAction ), NULL, ( pxHigherPriorityTaskWoken ) )
+#define xTaskNotifyIndexedFromISR( xTaskToNotify, uxIndexToNotify, ulValue, eAction, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( uxIndexToNotify ), ( ulValue ), ( eAction ), NULL, ( pxHigherPriorityTaskWoken ) )
+#define xTaskNotifyAndQueryFromISR( xTaskToNotify, ulValue, eAction, pulPreviousNotificationValue, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( ulValue ), ( eAction ), ( pulPreviousNotificationValue ), ( pxHigherPriorityTaskWoken ) )
+#define xTaskNotifyAndQueryIndexedFromISR( xTaskToNotify, uxIndexToNotify, ulValue, eAction, pulPreviousNotificationValue, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( uxIndexToNotify ), ( ulValue ), ( eAction ), ( pulPreviousNotificationValue ), ( pxHigherPriorityTaskWoken ) )
 
 /**
  * task. h
  * <PRE>BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait );</pre>
+ * <PRE>BaseType_t xTaskNotifyWaitIndexed( UBaseType_t uxIndexToWait, uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait );</pre>
  *
  * configUSE_TASK_NOTIFICATIONS must be undefined or defined as 1 for this
  * function to be available.
@@ -1978,6 +2279,12 @@ BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulVal
  *
  * See http://www.FreeRTOS.org/RTOS-task-notifications.html for details.
  *
+ * @param uxIndexToWait The index within the calling task's array of
+ * notification values on which the calling task will wait for a notification to
+ * be received.  uxIndexToWait must be less than
+ * configTASK_NOTIFICATION_ARRAY_ENTRIES.  xTaskNotifyWait() does not have this
+ * parameter and always waits for notifications on index 0.
+ *
  * @param ulBitsToClearOnEntry Bits that are set in ulBitsToClearOnEntry value
  * will be cleared in the calling task's notification value before the task
  * checks to see if any notifications are pending, and optionally blocks if no
@@ -2018,11 +2325,14 @@ BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulVal
  * \defgroup xTaskNotifyWait xTaskNotifyWait
  * \ingroup TaskNotifications
  */
-BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+BaseType_t xTaskGenericNotifyWait( UBaseType_t uxIndexToWait, uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#define xTaskNotifyWait( ulBitsToClearOnEntry, ulBitsToClearOnExit, pulNotificationValue, xTicksToWait ) xTaskGenericNotifyWait( ( tskDEFAULT_INDEX_TO_NOTIFY ), ( ulBitsToClearOnEntry ), ( ulBitsToClearOnExit ), ( pulNotificationValue ), ( xTicksToWait ) )
+#define xTaskNotifyWaitIndexed( uxIndexToWait, ulBitsToClearOnEntry, ulBitsToClearOnExit, pulNotificationValue, xTicksToWait ) xTaskGenericNotifyWait( ( uxIndexToWait ), ( ulBitsToClearOnEntry ), ( ulBitsToClearOnExit ), ( pulNotificationValue ), ( xTicksToWait ) )
 
 /**
  * task. h
  * <PRE>BaseType_t xTaskNotifyGive( TaskHandle_t xTaskToNotify );</PRE>
+ * <PRE>BaseType_t xTaskNotifyGiveIndexed( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify );</PRE>
  *
  * configUSE_TASK_NOTIFICATIONS must be undefined or defined as 1 for this macro
  * to be available.
@@ -2058,17 +2368,24 @@ BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClea
  * task, and the handle of the currently running task can be obtained by calling
  * xTaskGetCurrentTaskHandle().
  *
+ * @param uxIndexToNotify The index within the target task's array of
+ * notification values to which the notification is to be sent.  uxIndexToNotify
+ * must be less than configTASK_NOTIFICATION_ARRAY_ENTRIES.  xTaskNotifyGive()
+ * does not have this parameter and always sends notifications to index 0.
+ *
  * @return xTaskNotifyGive() is a macro that calls xTaskNotify() with the
  * eAction parameter set to eIncrement - so pdPASS is always returned.
  *
  * \defgroup xTaskNotifyGive xTaskNotifyGive
  * \ingroup TaskNotifications
  */
-#define xTaskNotifyGive( xTaskToNotify ) xTaskGenericNotify( ( xTaskToNotify ), ( 0 ), eIncrement, NULL )
+#define xTaskNotifyGive( xTaskToNotify ) xTaskGenericNotify( ( xTaskToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( 0 ), eIncrement, NULL )
+#define xTaskNotifyGiveIndexed( xTaskToNotify, uxIndexToNotify ) xTaskGenericNotify( ( xTaskToNotify ), ( uxIndexToNotify ), ( 0 ), eIncrement, NULL )
 
 /**
  * task. h
- * <PRE>void vTaskNotifyGiveFromISR( TaskHandle_t xTaskHandle, BaseType_t *pxHigherPriorityTaskWoken );
+ * <PRE>void vTaskNotifyGiveFromISR( TaskHandle_t xTaskHandle, BaseType_t *pxHigherPriorityTaskWoken );</PRE>
+ * <PRE>void vTaskNotifyGiveIndexedFromISR( TaskHandle_t xTaskHandle, UBaseType_t uxIndexToNotify, BaseType_t *pxHigherPriorityTaskWoken );</PRE>
  *
  * configUSE_TASK_NOTIFICATIONS must be undefined or defined as 1 for this macro
  * to be available.
@@ -2107,6 +2424,12 @@ BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClea
  * task, and the handle of the currently running task can be obtained by calling
  * xTaskGetCurrentTaskHandle().
  *
+ * @param uxIndexToNotify The index within the target task's array of
+ * notification values to which the notification is to be sent.  uxIndexToNotify
+ * must be less than
+ * configTASK_NOTIFICATION_ARRAY_ENTRIES.  vTaskNotifyGiveFromISR() does not have
+ * this parameter and always sends notifications to index 0.
+ *
  * @param pxHigherPriorityTaskWoken  vTaskNotifyGiveFromISR() will set
  * *pxHigherPriorityTaskWoken to pdTRUE if sending the notification caused the
  * task to which the notification was sent to leave the Blocked state, and the
@@ -2119,11 +2442,14 @@ BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClea
  * \defgroup xTaskNotifyWait xTaskNotifyWait
  * \ingroup TaskNotifications
  */
-void vTaskNotifyGiveFromISR( TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+void vTaskGenericNotifyGiveFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#define vTaskNotifyGiveFromISR( xTaskToNotify, pxHigherPriorityTaskWoken ) vTaskGenericNotifyGiveFromISR( ( xTaskToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( pxHigherPriorityTaskWoken ) )
+#define vTaskNotifyGiveIndexedFromISR( xTaskToNotify, uxIndexToNotify, pxHigherPriorityTaskWoken ) vTaskGenericNotifyGiveFromISR( ( xTaskToNotify ), ( uxIndexToNotify ), ( pxHigherPriorityTaskWoken ) )
 
 /**
  * task. h
  * <PRE>uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait );</pre>
+ * <PRE>uint32_t ulTaskNotifyTakeIndexed( UBaseType_t uxIndexToWait, BaseType_t xClearCountOnExit, TickType_t xTicksToWait );</pre>
  *
  * configUSE_TASK_NOTIFICATIONS must be undefined or defined as 1 for this
  * function to be available.
@@ -2167,6 +2493,12 @@ void vTaskNotifyGiveFromISR( TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPri
  *
  * See http://www.FreeRTOS.org/RTOS-task-notifications.html for details.
  *
+ * @param uxIndexToWait The index within the calling task's array of
+ * notification values on which the calling task will wait for a notification to
+ * be received.  uxIndexToWait must be less than
+ * configTASK_NOTIFICATION_ARRAY_ENTRIES.  ulTaskNotifyTake() does not have this
+ * parameter and always waits for notifications on index 0.
+ *
  * @param xClearCountOnExit if xClearCountOnExit is pdFALSE then the task's
  * notification value is decremented when the function exits.  In this way the
  * notification value acts like a counting semaphore.  If xClearCountOnExit is
@@ -2188,31 +2520,47 @@ void vTaskNotifyGiveFromISR( TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPri
  * \defgroup ulTaskNotifyTake ulTaskNotifyTake
  * \ingroup TaskNotifications
  */
-uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+uint32_t ulTaskGenericNotifyTake( UBaseType_t uxIndexToWait, BaseType_t xClearCountOnExit, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#define ulTaskNotifyTake( xClearCountOnExit, xTicksToWait ) ulTaskGenericNotifyTake( ( tskDEFAULT_INDEX_TO_NOTIFY ), ( xClearCountOnExit ), ( xTicksToWait ) )
+#define ulTaskNotifyTakeIndexed( uxIndexToWait, xClearCountOnExit, xTicksToWait ) ulTaskGenericNotifyTake( ( uxIndexToWait ), ( xClearCountOnExit ), ( xTicksToWait ) )
 
 /**
  * task. h
  * <PRE>BaseType_t xTaskNotifyStateClear( TaskHandle_t xTask );</pre>
+ * <PRE>BaseType_t xTaskNotifyStateClearIndexed( TaskHandle_t xTask, UBaseType_t uxIndexToClear );</pre>
  *
  * If the notification state of the task referenced by the handle xTask is
  * eNotified, then set the task's notification state to eNotWaitingNotification.
  * The task's notification value is not altered.  Set xTask to NULL to clear the
  * notification state of the calling task.
  *
+ * @param uxIndexToClear The index within the target task's array of
+ * notification values to act upon.  uxIndexToClear must be less than
+ * configTASK_NOTIFICATION_ARRAY_ENTRIES.  xTaskNotifyStateClear() does not have
+ * this parameter and always acts on the notification value at index 0.
+ *
  * @return pdTRUE if the task's notification state was set to
  * eNotWaitingNotification, otherwise pdFALSE.
  * \defgroup xTaskNotifyStateClear xTaskNotifyStateClear
  * \ingroup TaskNotifications
  */
-BaseType_t xTaskNotifyStateClear( TaskHandle_t xTask );
+BaseType_t xTaskGenericNotifyStateClear( TaskHandle_t xTask, UBaseType_t uxIndexToClear ) PRIVILEGED_FUNCTION;
+#define xTaskNotifyStateClear( xTask ) xTaskGenericNotifyStateClear( ( xTask ), ( tskDEFAULT_INDEX_TO_NOTIFY ) )
+#define xTaskNotifyStateClearIndexed( xTask, uxIndexToClear ) xTaskGenericNotifyStateClear( ( xTask ), ( uxIndexToClear ) )
 
 /**
 * task. h
 * <PRE>uint32_t ulTaskNotifyValueClear( TaskHandle_t xTask, uint32_t ulBitsToClear );</pre>
+* <PRE>uint32_t ulTaskNotifyValueClearIndexed( TaskHandle_t xTask, UBaseType_t uxIndexToClear, uint32_t ulBitsToClear );</pre>
 *
 * Clears the bits specified by the ulBitsToClear bit mask in the notification
 * value of the task referenced by xTask.
 *
+* @param uxIndexToClear The index within the target task's array of notification
+* values to act upon.  uxIndexToClear must be less than
+* configTASK_NOTIFICATION_ARRAY_ENTRIES.  ulTaskNotifyValueClear() does not have
+* this parameter and always acts on the notification value at index 0.
+*
 * Set ulBitsToClear to 0xffffffff (UINT_MAX on 32-bit architectures) to clear
 * the notification value to 0.  Set ulBitsToClear to 0 to query the task's
 * notification value without clearing any bits.
@@ -2222,7 +2570,9 @@ BaseType_t xTaskNotifyStateClear( TaskHandle_t xTask );
 * \defgroup ulTaskNotifyValueClear ulTaskNotifyValueClear
 * \ingroup TaskNotifications
 */
-uint32_t ulTaskNotifyValueClear( TaskHandle_t xTask, uint32_t ulBitsToClear ) PRIVILEGED_FUNCTION;
+uint32_t ulTaskGenericNotifyValueClear( TaskHandle_t xTask, UBaseType_t uxIndexToClear, uint32_t ulBitsToClear ) PRIVILEGED_FUNCTION;
+#define ulTaskNotifyValueClear( xTask, ulBitsToClear ) ulTaskGenericNotifyValueClear( ( xTask ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( ulBitsToClear ) )
+#define ulTaskNotifyValueClearIndexed( xTask, uxIndexToClear, ulBitsToClear ) ulTaskGenericNotifyValueClear( ( xTask ), ( uxIndexToClear ), ( ulBitsToClear ) )
 
 /**
  * task.h
@@ -2416,6 +2766,19 @@ void vTaskPlaceOnEventListRestricted( List_t * const pxEventList, TickType_t xTi
 BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList ) PRIVILEGED_FUNCTION;
 void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem, const TickType_t xItemValue ) PRIVILEGED_FUNCTION;
 
+/*
+ * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS AN
+ * INTERFACE WHICH IS FOR THE EXCLUSIVE USE OF THE SCHEDULER.
+ *
+ * As vTaskRemoveFromUnorderedEventList(), but called from an interrupt, or
+ * with interrupts masked, while the scheduler is not suspended, so the task is
+ * placed directly in its ready list.  Returns pdTRUE if the task has a higher
+ * priority than the calling task, in which case a yield is also held pending.
+ * Used by xEventGroupSetBitsFromISR() when
+ * configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR is 1.
+ */
+BaseType_t xTaskRemoveFromUnorderedEventListFromISR( ListItem_t * pxEventListItem, const TickType_t xItemValue ) PRIVILEGED_FUNCTION;
+
 /*
  * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS ONLY
  * INTENDED FOR USE WHEN IMPLEMENTING A PORT OF THE SCHEDULER AND IS
@@ -2471,6 +2834,15 @@ BaseType_t xTaskPriorityDisinherit( TaskHandle_t const pxMutexHolder ) PRIVILEGE
  */
 void vTaskPriorityDisinheritAfterTimeout( TaskHandle_t const pxMutexHolder, UBaseType_t uxHighestPriorityWaitingTask ) PRIVILEGED_FUNCTION;
 
+/*
+ * Returns pdTRUE if the mutex holder is in the Ready state at a priority equal
+ * to or higher than the calling task, so yielding would allow it to run and
+ * release the mutex, otherwise returns pdFALSE.  Used by the adaptive mutex to
+ * decide between yielding and blocking on a contended take.  Must be called
+ * from a critical section.
+ */
+BaseType_t xTaskMutexHolderCanRun( TaskHandle_t const pxMutexHolder ) PRIVILEGED_FUNCTION;
+
 /*
  * Get the uxTCBNumber assigned to the task referenced by the xTask parameter.
  */
@@ -2505,6 +2877,26 @@ tasks may have to be removed from the blocked state as the tick count is
 moved. */
 BaseType_t xTaskCatchUpTicks( TickType_t xTicksToCatchUp ) PRIVILEGED_FUNCTION;
 
+/*
+ * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS AN INTERFACE
+ * WHICH IS FOR THE EXCLUSIVE USE OF THE PORT LAYER.
+ *
+ * Only available when configUSE_DYNAMIC_TICK is set to 1.  Called by the
+ * port's one-shot tick timer interrupt, with interrupts masked, in place of
+ * xTaskIncrementTick().  Every whole tick period that has elapsed since the
+ * tick count was last brought up to date is announced to the kernel - the tick
+ * count is moved forward in one step as far as the next time a task is due to
+ * leave the Blocked state, and xTaskIncrementTick() is called for the tick
+ * that ends the elapsed period.  The timer is then re-armed for the next time
+ * the kernel needs to run.
+ *
+ * The tick hook and time slicing therefore run once per timer interrupt,
+ * rather than once per tick period.
+ *
+ * Returns pdTRUE if a context switch is required, otherwise pdFALSE.
+ */
+BaseType_t xTaskAnnounceElapsedTicks( void ) PRIVILEGED_FUNCTION;
+
 /*
  * Only available when configUSE_TICKLESS_IDLE is set to 1.
  * Provided for use within portSUPPRESS_TICKS_AND_SLEEP() to allow the port
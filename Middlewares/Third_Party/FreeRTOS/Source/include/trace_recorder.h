@@ -0,0 +1,230 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A low overhead trace recorder built on the trace macros.  Set
+ * configUSE_TRACE_RECORDER to 1 in FreeRTOSConfig.h, and build
+ * trace_recorder.c, to record context switches, the time at which tasks are
+ * made ready to run, and the time at which tasks block on queues, semaphores
+ * and mutexes, into a fixed size ring buffer of binary events.
+ *
+ * The recorder needs configUSE_TRACE_FACILITY to be 1, and a free running
+ * timestamp counter.  configTRACE_RECORDER_TIMESTAMP() defaults to
+ * portGET_RUN_TIME_COUNTER_VALUE() if the run time stats counter is available,
+ * but should normally be defined to read a cycle counter, for example the
+ * DWT_CYCCNT register on Cortex-M parts.
+ *
+ * The ring buffer is the global xTraceRecorderBuffer.  Copy it off the target,
+ * for example using a debugger command such as:
+ *
+ * dump binary value trace.bin xTraceRecorderBuffer
+ *
+ * then run the host side decoder in tools/trace_decode.c to obtain the per
+ * task CPU time, the latency between tasks being made ready and running, and
+ * the time tasks spend blocked.
+ *
+ * The recorder defines the trace macros it uses, so cannot be combined with
+ * other trace macro definitions for the same events.
+ */
+
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include trace_recorder.h"
+#endif
+
+#if( configUSE_TRACE_FACILITY != 1 )
+	#error configUSE_TRACE_FACILITY must be set to 1 in FreeRTOSConfig.h to use the trace recorder
+#endif
+
+#ifndef configTRACE_RECORDER_TIMESTAMP
+	#if defined( portGET_RUN_TIME_COUNTER_VALUE )
+		#define configTRACE_RECORDER_TIMESTAMP() portGET_RUN_TIME_COUNTER_VALUE()
+	#else
+		#error configTRACE_RECORDER_TIMESTAMP() must be defined in FreeRTOSConfig.h to return a free running counter value
+	#endif
+#endif
+
+/* The frequency of the timestamp counter, which is stored in the buffer so the
+decoder can convert timestamps to time.  Leave as 0 to report raw counts. */
+#ifndef configTRACE_RECORDER_TIMESTAMP_HZ
+	#define configTRACE_RECORDER_TIMESTAMP_HZ 0
+#endif
+
+/* The number of events held in the ring buffer.  Must be a power of 2. */
+#ifndef configTRACE_RECORDER_BUFFER_EVENTS
+	#define configTRACE_RECORDER_BUFFER_EVENTS 512
+#endif
+
+#if( ( configTRACE_RECORDER_BUFFER_EVENTS & ( configTRACE_RECORDER_BUFFER_EVENTS - 1 ) ) != 0 )
+	#error configTRACE_RECORDER_BUFFER_EVENTS must be a power of 2
+#endif
+
+/* The number of task names held by the recorder.  Tasks share a name slot if
+their task numbers are equal modulo this value. */
+#ifndef configTRACE_RECORDER_MAX_TASKS
+	#define configTRACE_RECORDER_MAX_TASKS 32
+#endif
+
+/* Optionally defined to return non-zero when called from an interrupt, so
+events generated by interrupts can be told apart.  xPortIsInsideInterrupt() can
+be used on Cortex-M ports. */
+#ifndef configTRACE_RECORDER_IS_INSIDE_INTERRUPT
+	#define configTRACE_RECORDER_IS_INSIDE_INTERRUPT() ( pdFALSE )
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Identifies a buffer that holds trace events, and the layout of the buffer.
+The version must be incremented if the layout changes. */
+#define trcBUFFER_MAGIC					( ( uint32_t ) 0x52545246UL ) /* "FRTR" */
+#define trcBUFFER_VERSION				( ( uint16_t ) 1U )
+#define trcTASK_NAME_LENGTH				( 12U )
+
+/* Event types. */
+#define trcEVENT_TASK_CREATE			( ( uint8_t ) 1U )	/* ulParameter1 holds the priority of the task. */
+#define trcEVENT_TASK_DELETE			( ( uint8_t ) 2U )
+#define trcEVENT_TASK_SWITCHED_IN		( ( uint8_t ) 3U )
+#define trcEVENT_TASK_READY				( ( uint8_t ) 4U )
+#define trcEVENT_QUEUE_BLOCK			( ( uint8_t ) 5U )	/* ulParameter1 holds the queue, ulParameter2 the operation and queue type. */
+#define trcEVENT_PRIORITY_INHERIT		( ( uint8_t ) 6U )	/* ulParameter1 holds the new priority of the task. */
+#define trcEVENT_PRIORITY_DISINHERIT	( ( uint8_t ) 7U )	/* ulParameter1 holds the new priority of the task. */
+
+/* Bits in the ucFlags member of an event. */
+#define trcFLAG_FROM_ISR				( ( uint8_t ) 1U )	/* The event was generated from an interrupt. */
+
+/* The operation held in the low byte of ulParameter2 of trcEVENT_QUEUE_BLOCK
+events.  The next byte holds the queueQUEUE_TYPE_... value of the queue. */
+#define trcQUEUE_OP_SEND				( 0U )
+#define trcQUEUE_OP_RECEIVE				( 1U )
+#define trcQUEUE_OP_PEEK				( 2U )
+
+/* A single event in the ring buffer.  All events are the same size. */
+typedef struct TraceRecorderEvent
+{
+	uint32_t ulTimestamp;			/* Value of configTRACE_RECORDER_TIMESTAMP() when the event occurred. */
+	uint8_t ucEventType;			/* One of the trcEVENT_... values. */
+	uint8_t ucFlags;				/* trcFLAG_... bits. */
+	uint16_t usTaskNumber;			/* The task number of the task the event relates to, or 0 for none. */
+	uint32_t ulParameter1;			/* Event specific. */
+	uint32_t ulParameter2;			/* Event specific. */
+} TraceRecorderEvent_t;
+
+/* The name and base priority of a task, so tasks can still be identified after
+their create events have been overwritten. */
+typedef struct TraceRecorderTask
+{
+	uint16_t usTaskNumber;
+	uint16_t usPriority;
+	char cName[ trcTASK_NAME_LENGTH ];
+} TraceRecorderTask_t;
+
+/* The complete buffer, as read by the decoder.  All members are little endian
+on little endian targets, and the decoder expects the header members in the
+order below. */
+typedef struct TraceRecorderBuffer
+{
+	uint32_t ulMagic;				/* trcBUFFER_MAGIC once the buffer has been initialised. */
+	uint16_t usVersion;				/* trcBUFFER_VERSION. */
+	uint16_t usEventSize;			/* sizeof( TraceRecorderEvent_t ). */
+	uint32_t ulEventCapacity;		/* configTRACE_RECORDER_BUFFER_EVENTS. */
+	uint32_t ulTaskCapacity;		/* configTRACE_RECORDER_MAX_TASKS. */
+	uint32_t ulTimestampHz;			/* configTRACE_RECORDER_TIMESTAMP_HZ. */
+	volatile uint32_t ulEventsWritten; /* The total number of events written.  The next event is written to xEvents[ ulEventsWritten % ulEventCapacity ]. */
+	TraceRecorderTask_t xTasks[ configTRACE_RECORDER_MAX_TASKS ];
+	TraceRecorderEvent_t xEvents[ configTRACE_RECORDER_BUFFER_EVENTS ];
+} TraceRecorderBuffer_t;
+
+extern TraceRecorderBuffer_t xTraceRecorderBuffer;
+
+/*
+ * Clears the ring buffer so recording restarts from empty.
+ */
+void vTraceRecorderReset( void );
+
+/*
+ * Writes an event to the ring buffer.  Can be called from tasks and
+ * interrupts.  Normally only called by the trace macros below.
+ */
+void vTraceRecorderEvent( uint8_t ucEventType, UBaseType_t uxTaskNumber, uint32_t ulParameter1, uint32_t ulParameter2 );
+
+/*
+ * Records the name and priority of a newly created task, then writes a
+ * trcEVENT_TASK_CREATE event.
+ */
+void vTraceRecorderTaskCreate( UBaseType_t uxTaskNumber, UBaseType_t uxPriority, const char *pcName );
+
+/*
+ * Writes a trcEVENT_TASK_SWITCHED_IN event and remembers the task, so events
+ * raised by code that does not have access to the TCB can be attributed to it.
+ */
+void vTraceRecorderTaskSwitchedIn( UBaseType_t uxTaskNumber );
+
+/*
+ * Writes a trcEVENT_QUEUE_BLOCK event for the running task.
+ */
+void vTraceRecorderQueueBlock( const void *pvQueue, uint32_t ulOperation );
+
+/* The trace macros.  Those that are passed a TCB are only used within tasks.c,
+so can access the members of the TCB directly.  Those that are passed a queue
+are only used within queue.c, so can access the members of the queue
+directly. */
+#define traceTASK_CREATE( pxNewTCB )															\
+	vTraceRecorderTaskCreate( ( pxNewTCB )->uxTCBNumber, ( pxNewTCB )->uxPriority, ( pxNewTCB )->pcTaskName )
+
+#define traceTASK_DELETE( pxTaskToDelete )														\
+	vTraceRecorderEvent( trcEVENT_TASK_DELETE, ( pxTaskToDelete )->uxTCBNumber, 0UL, 0UL )
+
+#define traceTASK_SWITCHED_IN()																	\
+	vTraceRecorderTaskSwitchedIn( pxCurrentTCB->uxTCBNumber )
+
+#define traceMOVED_TASK_TO_READY_STATE( pxTCB )													\
+	vTraceRecorderEvent( trcEVENT_TASK_READY, ( pxTCB )->uxTCBNumber, 0UL, 0UL )
+
+#define traceTASK_PRIORITY_INHERIT( pxTCBOfMutexHolder, uxInheritedPriority )					\
+	vTraceRecorderEvent( trcEVENT_PRIORITY_INHERIT, ( pxTCBOfMutexHolder )->uxTCBNumber, ( uint32_t ) ( uxInheritedPriority ), 0UL )
+
+#define traceTASK_PRIORITY_DISINHERIT( pxTCBOfMutexHolder, uxOriginalPriority )				\
+	vTraceRecorderEvent( trcEVENT_PRIORITY_DISINHERIT, ( pxTCBOfMutexHolder )->uxTCBNumber, ( uint32_t ) ( uxOriginalPriority ), 0UL )
+
+#define traceBLOCKING_ON_QUEUE_SEND( pxQueue )													\
+	vTraceRecorderQueueBlock( ( pxQueue ), ( uint32_t ) trcQUEUE_OP_SEND | ( ( uint32_t ) ( pxQueue )->ucQueueType << 8 ) )
+
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )												\
+	vTraceRecorderQueueBlock( ( pxQueue ), ( uint32_t ) trcQUEUE_OP_RECEIVE | ( ( uint32_t ) ( pxQueue )->ucQueueType << 8 ) )
+
+#define traceBLOCKING_ON_QUEUE_PEEK( pxQueue )													\
+	vTraceRecorderQueueBlock( ( pxQueue ), ( uint32_t ) trcQUEUE_OP_PEEK | ( ( uint32_t ) ( pxQueue )->ucQueueType << 8 ) )
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRACE_RECORDER_H */
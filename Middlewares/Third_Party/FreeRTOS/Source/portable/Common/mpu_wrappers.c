@@ -42,6 +42,8 @@ task.h is included from an application file. */
 #include "timers.h"
 #include "event_groups.h"
 #include "stream_buffer.h"
+#include "adaptive_mutex.h"
+#include "rw_lock.h"
 #include "mpu_prototypes.h"
 
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
@@ -158,6 +160,45 @@ BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 #endif
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TASK_POOLS == 1 )
+	TaskPoolHandle_t MPU_xTaskPoolCreate( UBaseType_t uxTaskCount, configSTACK_DEPTH_TYPE usStackDepth, BaseType_t xFillStackOnReuse ) /* FREERTOS_SYSTEM_CALL */
+	{
+	TaskPoolHandle_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xTaskPoolCreate( uxTaskCount, usStackDepth, xFillStackOnReuse );
+		vPortResetPrivilege( xRunningPrivileged );
+		return xReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TASK_POOLS == 1 )
+	BaseType_t MPU_xTaskCreateFromPool( TaskPoolHandle_t xTaskPool, TaskFunction_t pxTaskCode, const char * const pcName, void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask ) /* FREERTOS_SYSTEM_CALL */
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xTaskCreateFromPool( xTaskPool, pxTaskCode, pcName, pvParameters, uxPriority, pxCreatedTask );
+		vPortResetPrivilege( xRunningPrivileged );
+		return xReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TASK_POOLS == 1 )
+	UBaseType_t MPU_uxTaskPoolGetFreeCount( TaskPoolHandle_t xTaskPool ) /* FREERTOS_SYSTEM_CALL */
+	{
+	UBaseType_t uxReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		uxReturn = uxTaskPoolGetFreeCount( xTaskPool );
+		vPortResetPrivilege( xRunningPrivileged );
+		return uxReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
 #if ( INCLUDE_vTaskDelayUntil == 1 )
 	void MPU_vTaskDelayUntil( TickType_t * const pxPreviousWakeTime, TickType_t xTimeIncrement ) /* FREERTOS_SYSTEM_CALL */
 	{
@@ -169,6 +210,56 @@ BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 #endif
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_EDF_SCHEDULING == 1 )
+	void MPU_vTaskSetDeadline( TaskHandle_t xTask, TickType_t xRelativeDeadline ) /* FREERTOS_SYSTEM_CALL */
+	{
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		vTaskSetDeadline( xTask, xRelativeDeadline );
+		vPortResetPrivilege( xRunningPrivileged );
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EDF_SCHEDULING == 1 )
+	uint32_t MPU_ulTaskGetDeadlineMisses( TaskHandle_t xTask ) /* FREERTOS_SYSTEM_CALL */
+	{
+	uint32_t ulReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		ulReturn = ulTaskGetDeadlineMisses( xTask );
+		vPortResetPrivilege( xRunningPrivileged );
+		return ulReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STACK_WATERMARK_TRACKING == 1 )
+	configSTACK_DEPTH_TYPE MPU_uxTaskGetTrackedStackHighWaterMark( TaskHandle_t xTask ) /* FREERTOS_SYSTEM_CALL */
+	{
+	configSTACK_DEPTH_TYPE uxReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		uxReturn = uxTaskGetTrackedStackHighWaterMark( xTask );
+		vPortResetPrivilege( xRunningPrivileged );
+		return uxReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STACK_WATERMARK_TRACKING == 1 )
+	UBaseType_t MPU_uxTaskGetStackUsage( TaskStackUsage_t * const pxStackUsageArray, const UBaseType_t uxArraySize, const UBaseType_t uxMarginPercent ) /* FREERTOS_SYSTEM_CALL */
+	{
+	UBaseType_t uxReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		uxReturn = uxTaskGetStackUsage( pxStackUsageArray, uxArraySize, uxMarginPercent );
+		vPortResetPrivilege( xRunningPrivileged );
+		return uxReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
 #if ( INCLUDE_xTaskAbortDelay == 1 )
 	BaseType_t MPU_xTaskAbortDelay( TaskHandle_t xTask ) /* FREERTOS_SYSTEM_CALL */
 	{
@@ -535,12 +626,12 @@ BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 /*-----------------------------------------------------------*/
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
-	BaseType_t MPU_xTaskGenericNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue ) /* FREERTOS_SYSTEM_CALL */
+	BaseType_t MPU_xTaskGenericNotify( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue ) /* FREERTOS_SYSTEM_CALL */
 	{
 	BaseType_t xReturn;
 	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 
-		xReturn = xTaskGenericNotify( xTaskToNotify, ulValue, eAction, pulPreviousNotificationValue );
+		xReturn = xTaskGenericNotify( xTaskToNotify, uxIndexToNotify, ulValue, eAction, pulPreviousNotificationValue );
 		vPortResetPrivilege( xRunningPrivileged );
 		return xReturn;
 	}
@@ -548,12 +639,12 @@ BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 /*-----------------------------------------------------------*/
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
-	BaseType_t MPU_xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait ) /* FREERTOS_SYSTEM_CALL */
+	BaseType_t MPU_xTaskGenericNotifyWait( UBaseType_t uxIndexToWait, uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait ) /* FREERTOS_SYSTEM_CALL */
 	{
 	BaseType_t xReturn;
 	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 
-		xReturn = xTaskNotifyWait( ulBitsToClearOnEntry, ulBitsToClearOnExit, pulNotificationValue, xTicksToWait );
+		xReturn = xTaskGenericNotifyWait( uxIndexToWait, ulBitsToClearOnEntry, ulBitsToClearOnExit, pulNotificationValue, xTicksToWait );
 		vPortResetPrivilege( xRunningPrivileged );
 		return xReturn;
 	}
@@ -561,12 +652,12 @@ BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 /*-----------------------------------------------------------*/
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
-	uint32_t MPU_ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait ) /* FREERTOS_SYSTEM_CALL */
+	uint32_t MPU_ulTaskGenericNotifyTake( UBaseType_t uxIndexToWait, BaseType_t xClearCountOnExit, TickType_t xTicksToWait ) /* FREERTOS_SYSTEM_CALL */
 	{
 	uint32_t ulReturn;
 	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 
-		ulReturn = ulTaskNotifyTake( xClearCountOnExit, xTicksToWait );
+		ulReturn = ulTaskGenericNotifyTake( uxIndexToWait, xClearCountOnExit, xTicksToWait );
 		vPortResetPrivilege( xRunningPrivileged );
 		return ulReturn;
 	}
@@ -574,12 +665,12 @@ BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 /*-----------------------------------------------------------*/
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
-	BaseType_t MPU_xTaskNotifyStateClear( TaskHandle_t xTask ) /* FREERTOS_SYSTEM_CALL */
+	BaseType_t MPU_xTaskGenericNotifyStateClear( TaskHandle_t xTask, UBaseType_t uxIndexToClear ) /* FREERTOS_SYSTEM_CALL */
 	{
 	BaseType_t xReturn;
 	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 
-		xReturn = xTaskNotifyStateClear( xTask );
+		xReturn = xTaskGenericNotifyStateClear( xTask, uxIndexToClear );
 		vPortResetPrivilege( xRunningPrivileged );
 		return xReturn;
 	}
@@ -587,12 +678,12 @@ BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 /*-----------------------------------------------------------*/
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
-	uint32_t MPU_ulTaskNotifyValueClear( TaskHandle_t xTask, uint32_t ulBitsToClear ) /* FREERTOS_SYSTEM_CALL */
+	uint32_t MPU_ulTaskGenericNotifyValueClear( TaskHandle_t xTask, UBaseType_t uxIndexToClear, uint32_t ulBitsToClear ) /* FREERTOS_SYSTEM_CALL */
 	{
 	uint32_t ulReturn;
 	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 
-		ulReturn = ulTaskNotifyValueClear( xTask, ulBitsToClear );
+		ulReturn = ulTaskGenericNotifyValueClear( xTask, uxIndexToClear, ulBitsToClear );
 		vPortResetPrivilege( xRunningPrivileged );
 		return ulReturn;
 	}
@@ -680,6 +771,28 @@ BaseType_t xReturn;
 }
 /*-----------------------------------------------------------*/
 
+UBaseType_t MPU_xQueueSendMultiple( QueueHandle_t xQueue, const void * const pvItemsToQueue, const UBaseType_t uxItemCount, TickType_t xTicksToWait ) /* FREERTOS_SYSTEM_CALL */
+{
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+UBaseType_t uxReturn;
+
+	uxReturn = xQueueSendMultiple( xQueue, pvItemsToQueue, uxItemCount, xTicksToWait );
+	vPortResetPrivilege( xRunningPrivileged );
+	return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t MPU_xQueueReceiveMultiple( QueueHandle_t xQueue, void * const pvBuffer, const UBaseType_t uxMaxItems, TickType_t xTicksToWait ) /* FREERTOS_SYSTEM_CALL */
+{
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+UBaseType_t uxReturn;
+
+	uxReturn = xQueueReceiveMultiple( xQueue, pvBuffer, uxMaxItems, xTicksToWait );
+	vPortResetPrivilege( xRunningPrivileged );
+	return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
 BaseType_t MPU_xQueuePeek( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait ) /* FREERTOS_SYSTEM_CALL */
 {
 BaseType_t xRunningPrivileged = xPortRaisePrivilege();
@@ -846,6 +959,82 @@ BaseType_t xReturn;
 #endif
 /*-----------------------------------------------------------*/
 
+#if( ( configUSE_QUEUE_WAIT_SETS == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+	QueueWaitSetHandle_t MPU_xQueueCreateWaitSet( const UBaseType_t uxIndexToNotify ) /* FREERTOS_SYSTEM_CALL */
+	{
+	QueueWaitSetHandle_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xQueueCreateWaitSet( uxIndexToNotify );
+		vPortResetPrivilege( xRunningPrivileged );
+		return xReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_QUEUE_WAIT_SETS == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+	QueueWaitSetHandle_t MPU_xQueueCreateWaitSetStatic( const UBaseType_t uxIndexToNotify, StaticQueueWaitSet_t *pxWaitSetBuffer ) /* FREERTOS_SYSTEM_CALL */
+	{
+	QueueWaitSetHandle_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xQueueCreateWaitSetStatic( uxIndexToNotify, pxWaitSetBuffer );
+		vPortResetPrivilege( xRunningPrivileged );
+		return xReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+	BaseType_t MPU_xQueueAddToWaitSet( QueueSetMemberHandle_t xQueueOrSemaphore, QueueWaitSetHandle_t xWaitSet, const UBaseType_t uxBitNumber ) /* FREERTOS_SYSTEM_CALL */
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xQueueAddToWaitSet( xQueueOrSemaphore, xWaitSet, uxBitNumber );
+		vPortResetPrivilege( xRunningPrivileged );
+		return xReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+	BaseType_t MPU_xQueueRemoveFromWaitSet( QueueSetMemberHandle_t xQueueOrSemaphore, QueueWaitSetHandle_t xWaitSet ) /* FREERTOS_SYSTEM_CALL */
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xQueueRemoveFromWaitSet( xQueueOrSemaphore, xWaitSet );
+		vPortResetPrivilege( xRunningPrivileged );
+		return xReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+	uint32_t MPU_ulQueueWaitForAny( QueueWaitSetHandle_t xWaitSet, TickType_t xTicksToWait ) /* FREERTOS_SYSTEM_CALL */
+	{
+	uint32_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = ulQueueWaitForAny( xWaitSet, xTicksToWait );
+		vPortResetPrivilege( xRunningPrivileged );
+		return xReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+	void MPU_vQueueDeleteWaitSet( QueueWaitSetHandle_t xWaitSet ) /* FREERTOS_SYSTEM_CALL */
+	{
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		vQueueDeleteWaitSet( xWaitSet );
+		vPortResetPrivilege( xRunningPrivileged );
+	}
+#endif
+/*-----------------------------------------------------------*/
+
 #if configQUEUE_REGISTRY_SIZE > 0
 	void MPU_vQueueAddToRegistry( QueueHandle_t xQueue, const char *pcName ) /* FREERTOS_SYSTEM_CALL */
 	{
@@ -1208,6 +1397,182 @@ BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 }
 /*-----------------------------------------------------------*/
 
+#if( ( configUSE_ADAPTIVE_MUTEXES == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+	AdaptiveMutexHandle_t MPU_xAdaptiveMutexCreate( void ) /* FREERTOS_SYSTEM_CALL */
+	{
+	AdaptiveMutexHandle_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xAdaptiveMutexCreate();
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_ADAPTIVE_MUTEXES == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+	AdaptiveMutexHandle_t MPU_xAdaptiveMutexCreateStatic( StaticAdaptiveMutex_t *pxMutexBuffer ) /* FREERTOS_SYSTEM_CALL */
+	{
+	AdaptiveMutexHandle_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xAdaptiveMutexCreateStatic( pxMutexBuffer );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if( configUSE_ADAPTIVE_MUTEXES == 1 )
+	BaseType_t MPU_xAdaptiveMutexTake( AdaptiveMutexHandle_t xMutex, TickType_t xTicksToWait ) /* FREERTOS_SYSTEM_CALL */
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xAdaptiveMutexTake( xMutex, xTicksToWait );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if( configUSE_ADAPTIVE_MUTEXES == 1 )
+	BaseType_t MPU_xAdaptiveMutexGive( AdaptiveMutexHandle_t xMutex ) /* FREERTOS_SYSTEM_CALL */
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xAdaptiveMutexGive( xMutex );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if( configUSE_ADAPTIVE_MUTEXES == 1 )
+	TaskHandle_t MPU_xAdaptiveMutexGetMutexHolder( AdaptiveMutexHandle_t xMutex ) /* FREERTOS_SYSTEM_CALL */
+	{
+	TaskHandle_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xAdaptiveMutexGetMutexHolder( xMutex );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if( configUSE_ADAPTIVE_MUTEXES == 1 )
+	void MPU_vAdaptiveMutexDelete( AdaptiveMutexHandle_t xMutex ) /* FREERTOS_SYSTEM_CALL */
+	{
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		vAdaptiveMutexDelete( xMutex );
+		vPortResetPrivilege( xRunningPrivileged );
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_RW_LOCKS == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+	RWLockHandle_t MPU_xRWLockCreate( void ) /* FREERTOS_SYSTEM_CALL */
+	{
+	RWLockHandle_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xRWLockCreate();
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_RW_LOCKS == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+	RWLockHandle_t MPU_xRWLockCreateStatic( StaticRWLock_t *pxLockBuffer ) /* FREERTOS_SYSTEM_CALL */
+	{
+	RWLockHandle_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xRWLockCreateStatic( pxLockBuffer );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if( configUSE_RW_LOCKS == 1 )
+	BaseType_t MPU_xRWLockTakeRead( RWLockHandle_t xLock, TickType_t xTicksToWait ) /* FREERTOS_SYSTEM_CALL */
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xRWLockTakeRead( xLock, xTicksToWait );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if( configUSE_RW_LOCKS == 1 )
+	BaseType_t MPU_xRWLockGiveRead( RWLockHandle_t xLock ) /* FREERTOS_SYSTEM_CALL */
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xRWLockGiveRead( xLock );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if( configUSE_RW_LOCKS == 1 )
+	BaseType_t MPU_xRWLockTakeWrite( RWLockHandle_t xLock, TickType_t xTicksToWait ) /* FREERTOS_SYSTEM_CALL */
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xRWLockTakeWrite( xLock, xTicksToWait );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if( configUSE_RW_LOCKS == 1 )
+	BaseType_t MPU_xRWLockGiveWrite( RWLockHandle_t xLock ) /* FREERTOS_SYSTEM_CALL */
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xRWLockGiveWrite( xLock );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if( configUSE_RW_LOCKS == 1 )
+	void MPU_vRWLockDelete( RWLockHandle_t xLock ) /* FREERTOS_SYSTEM_CALL */
+	{
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		vRWLockDelete( xLock );
+		vPortResetPrivilege( xRunningPrivileged );
+	}
+#endif
+/*-----------------------------------------------------------*/
+
 size_t MPU_xStreamBufferSend( StreamBufferHandle_t xStreamBuffer, const void *pvTxData, size_t xDataLengthBytes, TickType_t xTicksToWait ) /* FREERTOS_SYSTEM_CALL */
 {
 size_t xReturn;
@@ -1244,6 +1609,54 @@ BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 }
 /*-----------------------------------------------------------*/
 
+size_t MPU_xStreamBufferSendReserve( StreamBufferHandle_t xStreamBuffer, size_t xDataLengthBytes, StreamBufferRegion_t * const pxRegion, TickType_t xTicksToWait ) /* FREERTOS_SYSTEM_CALL */
+{
+size_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xStreamBufferSendReserve( xStreamBuffer, xDataLengthBytes, pxRegion, xTicksToWait );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t MPU_xStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer, size_t xDataLengthBytes ) /* FREERTOS_SYSTEM_CALL */
+{
+size_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xStreamBufferSendCommit( xStreamBuffer, xDataLengthBytes );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t MPU_xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer, StreamBufferRegion_t * const pxRegion, TickType_t xTicksToWait ) /* FREERTOS_SYSTEM_CALL */
+{
+size_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xStreamBufferReceiveAcquire( xStreamBuffer, pxRegion, xTicksToWait );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t MPU_xStreamBufferReceiveRelease( StreamBufferHandle_t xStreamBuffer, size_t xDataLengthBytes ) /* FREERTOS_SYSTEM_CALL */
+{
+size_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xStreamBufferReceiveRelease( xStreamBuffer, xDataLengthBytes );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
 void MPU_vStreamBufferDelete( StreamBufferHandle_t xStreamBuffer ) /* FREERTOS_SYSTEM_CALL */
 {
 BaseType_t xRunningPrivileged = xPortRaisePrivilege();
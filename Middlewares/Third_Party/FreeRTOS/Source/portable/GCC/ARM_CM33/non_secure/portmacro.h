@@ -243,6 +243,13 @@ typedef struct MPU_SETTINGS
 #define portTASK_FUNCTION( vFunction, pvParameters )		void vFunction( void *pvParameters )
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Asserts if called from an interrupt, for functions that are not
+ * interrupt safe.
+ */
+#define portASSERT_IF_IN_ISR()								configASSERT( xPortIsInsideInterrupt() == pdFALSE )
+/*-----------------------------------------------------------*/
+
 #if( configENABLE_TRUSTZONE == 1 )
 	/**
 	 * @brief Allocate a secure context for the task.
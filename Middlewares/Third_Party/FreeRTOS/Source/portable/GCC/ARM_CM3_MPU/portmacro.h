@@ -245,6 +245,10 @@ BaseType_t xReturn;
 	return xReturn;
 }
 
+/* Asserts if called from an interrupt, for functions that are not interrupt
+safe. */
+#define portASSERT_IF_IN_ISR()	configASSERT( xPortIsInsideInterrupt() == pdFALSE )
+
 /*-----------------------------------------------------------*/
 
 portFORCE_INLINE static void vPortRaiseBASEPRI( void )
@@ -95,6 +95,11 @@ occurred while the SysTick counter is stopped during tickless idle
 calculations. */
 #define portMISSED_COUNTS_FACTOR			( 45UL )
 
+/* The minimum number of SysTick counts for which the one-shot timer is set
+when configUSE_DYNAMIC_TICK is 1, so a deadline that has already passed, or is
+about to pass, does not get missed while the timer is being reloaded. */
+#define portMIN_TICK_DEADLINE_COUNTS		( 1024UL )
+
 /* Let the user override the pre-loading of the initial LR with the address of
 prvTaskExitError() in case it messes up unwinding of the stack in the
 debugger. */
@@ -133,6 +138,15 @@ static void vPortEnableVFP( void ) __attribute__ (( naked ));
  */
 static void prvTaskExitError( void );
 
+/*
+ * Return the number of SysTick counts that have passed since the current
+ * period of the one-shot timer started.  Must be called with interrupts
+ * masked.
+ */
+#if( configUSE_DYNAMIC_TICK == 1 )
+	static uint32_t prvElapsedCycles( void );
+#endif /* configUSE_DYNAMIC_TICK */
+
 /*-----------------------------------------------------------*/
 
 /* Each task maintains its own interrupt status in the critical nesting
@@ -142,7 +156,7 @@ static UBaseType_t uxCriticalNesting = 0xaaaaaaaa;
 /*
  * The number of SysTick increments that make up one tick period.
  */
-#if( configUSE_TICKLESS_IDLE == 1 )
+#if( ( configUSE_TICKLESS_IDLE == 1 ) || ( configUSE_DYNAMIC_TICK == 1 ) )
 	static uint32_t ulTimerCountsForOneTick = 0;
 #endif /* configUSE_TICKLESS_IDLE */
 
@@ -150,10 +164,29 @@ static UBaseType_t uxCriticalNesting = 0xaaaaaaaa;
  * The maximum number of tick periods that can be suppressed is limited by the
  * 24 bit resolution of the SysTick timer.
  */
-#if( configUSE_TICKLESS_IDLE == 1 )
+#if( ( configUSE_TICKLESS_IDLE == 1 ) || ( configUSE_DYNAMIC_TICK == 1 ) )
 	static uint32_t xMaximumPossibleSuppressedTicks = 0;
 #endif /* configUSE_TICKLESS_IDLE */
 
+/*
+ * When configUSE_DYNAMIC_TICK is 1 the SysTick is used as a one-shot timer.
+ * ulLastLoad is the number of SysTick counts in the current period of the
+ * timer, ulCycleCount the number of counts that had passed when the current
+ * period started, ulOverflowCycles the counts in the periods that have
+ * completed since then, and ulAnnouncedCycles the number of counts that had
+ * passed at the last tick boundary announced to the kernel.  The announced
+ * count only ever moves in whole tick periods, so the tick count does not
+ * drift however often the timer is reloaded.  The counts wrap, which is fine
+ * as only differences between them are used.
+ */
+#if( configUSE_DYNAMIC_TICK == 1 )
+	static uint32_t ulLastLoad = 0;
+	static uint32_t ulCycleCount = 0;
+	static uint32_t ulOverflowCycles = 0;
+	static uint32_t ulAnnouncedCycles = 0;
+	static uint32_t ulDeadlineCycles = 0;
+#endif /* configUSE_DYNAMIC_TICK */
+
 /*
  * Compensate for the CPU cycles that pass while the SysTick is stopped (low
  * power functionality only.
@@ -483,18 +516,136 @@ void xPortSysTickHandler( void )
 	known. */
 	portDISABLE_INTERRUPTS();
 	{
-		/* Increment the RTOS tick. */
-		if( xTaskIncrementTick() != pdFALSE )
+		#if( configUSE_DYNAMIC_TICK == 1 )
+		{
+			/* Announce every tick period that has passed since the tick count
+			was last brought up to date.  This also reloads the SysTick with
+			the next deadline. */
+			if( xTaskAnnounceElapsedTicks() != pdFALSE )
+			{
+				/* A context switch is required.  Context switching is
+				performed in the PendSV interrupt.  Pend the PendSV
+				interrupt. */
+				portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+			}
+		}
+		#else
 		{
-			/* A context switch is required.  Context switching is performed in
-			the PendSV interrupt.  Pend the PendSV interrupt. */
-			portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+			/* Increment the RTOS tick. */
+			if( xTaskIncrementTick() != pdFALSE )
+			{
+				/* A context switch is required.  Context switching is
+				performed in the PendSV interrupt.  Pend the PendSV
+				interrupt. */
+				portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+			}
 		}
+		#endif /* configUSE_DYNAMIC_TICK */
 	}
 	portENABLE_INTERRUPTS();
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_DYNAMIC_TICK == 1 )
+
+	static uint32_t prvElapsedCycles( void )
+	{
+	uint32_t ulValue1, ulValue2, ulControl;
+
+		/* Read the current value either side of the control register so a
+		reload of the counter is seen whether it occurs before or after the
+		COUNTFLAG bit is read - the current value only increases when the
+		counter is reloaded. */
+		ulValue1 = portNVIC_SYSTICK_CURRENT_VALUE_REG;
+		ulControl = portNVIC_SYSTICK_CTRL_REG;
+		ulValue2 = portNVIC_SYSTICK_CURRENT_VALUE_REG;
+
+		if( ( ( ulControl & portNVIC_SYSTICK_COUNT_FLAG_BIT ) != 0UL ) || ( ulValue1 < ulValue2 ) )
+		{
+			ulOverflowCycles += ulLastLoad;
+
+			/* The reload might not have been seen in COUNTFLAG, which is
+			cleared by reading the control register. */
+			( void ) portNVIC_SYSTICK_CTRL_REG;
+		}
+
+		return ( ulLastLoad - ulValue2 ) + ulOverflowCycles;
+	}
+	/*-----------------------------------------------------------*/
+
+	TickType_t xPortGetUnannouncedTicks( void )
+	{
+	uint32_t ulUnannounced;
+
+		ulUnannounced = ( ulCycleCount + prvElapsedCycles() ) - ulAnnouncedCycles;
+		return ( TickType_t ) ( ulUnannounced / ulTimerCountsForOneTick );
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortAnnounceTicks( TickType_t xTicks )
+	{
+		ulAnnouncedCycles += ( uint32_t ) xTicks * ulTimerCountsForOneTick;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortSetTickDeadline( TickType_t xTicks )
+	{
+	uint32_t ulDeadline, ulPending, ulDelay, ulValue1, ulValue2, ulPreviousLoad;
+
+		/* The deadline is relative to the last announced tick boundary, so
+		the timer expires on a tick boundary. */
+		if( xTicks > xMaximumPossibleSuppressedTicks )
+		{
+			xTicks = xMaximumPossibleSuppressedTicks;
+		}
+
+		ulDeadline = ulAnnouncedCycles + ( ( uint32_t ) xTicks * ulTimerCountsForOneTick );
+		ulPending = prvElapsedCycles();
+
+		/* Only reload the SysTick if it is not already counting down to the
+		same deadline - reloading it is exact, but it is not free. */
+		if( ( ulDeadline != ulDeadlineCycles ) || ( ulOverflowCycles != 0UL ) )
+		{
+			ulValue1 = portNVIC_SYSTICK_CURRENT_VALUE_REG;
+			ulPreviousLoad = ulLastLoad;
+			ulCycleCount += ulPending;
+			ulOverflowCycles = 0UL;
+
+			/* The number of counts until the deadline, which might already
+			have passed. */
+			ulDelay = ulDeadline - ulCycleCount;
+
+			if( ( int32_t ) ulDelay < ( int32_t ) portMIN_TICK_DEADLINE_COUNTS )
+			{
+				ulDelay = portMIN_TICK_DEADLINE_COUNTS;
+			}
+
+			ulLastLoad = ulDelay;
+			ulValue2 = portNVIC_SYSTICK_CURRENT_VALUE_REG;
+			portNVIC_SYSTICK_LOAD_REG = ulLastLoad - 1UL;
+
+			/* Writing to the current value register restarts the counter from
+			the new reload value. */
+			portNVIC_SYSTICK_CURRENT_VALUE_REG = 0UL;
+
+			/* Account for the counts that passed while the new reload value
+			was being calculated. */
+			if( ulValue1 < ulValue2 )
+			{
+				ulCycleCount += ulValue1 + ( ulPreviousLoad - ulValue2 );
+			}
+			else
+			{
+				ulCycleCount += ulValue1 - ulValue2;
+			}
+
+			ulDeadlineCycles = ulDeadline;
+		}
+	}
+
+#endif /* configUSE_DYNAMIC_TICK */
+/*-----------------------------------------------------------*/
+
 #if( configUSE_TICKLESS_IDLE == 1 )
 
 	__attribute__((weak)) void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
@@ -677,6 +828,24 @@ __attribute__(( weak )) void vPortSetupTimerInterrupt( void )
 	}
 	#endif /* configUSE_TICKLESS_IDLE */
 
+	#if( configUSE_DYNAMIC_TICK == 1 )
+	{
+		/* The longest deadline is one tick period less than the 24 bit
+		counter can hold, as the deadline is measured from the last announced
+		tick boundary rather than from the time the SysTick is reloaded. */
+		ulTimerCountsForOneTick = ( configSYSTICK_CLOCK_HZ / configTICK_RATE_HZ );
+		xMaximumPossibleSuppressedTicks = ( portMAX_24_BIT_NUMBER / ulTimerCountsForOneTick ) - 1UL;
+
+		/* The first tick interrupt occurs after one tick period, from then on
+		the kernel sets the deadline. */
+		ulLastLoad = ulTimerCountsForOneTick;
+		ulCycleCount = 0UL;
+		ulOverflowCycles = 0UL;
+		ulAnnouncedCycles = 0UL;
+		ulDeadlineCycles = ulTimerCountsForOneTick;
+	}
+	#endif /* configUSE_DYNAMIC_TICK */
+
 	/* Stop and clear the SysTick. */
 	portNVIC_SYSTICK_CTRL_REG = 0UL;
 	portNVIC_SYSTICK_CURRENT_VALUE_REG = 0UL;
@@ -119,6 +119,16 @@ not necessary for to use this port.  They are defined so the common demo files
 #endif
 /*-----------------------------------------------------------*/
 
+/* Dynamic tick functionality.  The SysTick is used as a one-shot timer that is
+set to expire at the next time the kernel needs to run. */
+extern TickType_t xPortGetUnannouncedTicks( void );
+extern void vPortAnnounceTicks( TickType_t xTicks );
+extern void vPortSetTickDeadline( TickType_t xTicks );
+#define portGET_UNANNOUNCED_TICKS()		xPortGetUnannouncedTicks()
+#define portANNOUNCE_TICKS( xTicks )	vPortAnnounceTicks( xTicks )
+#define portSET_TICK_DEADLINE( xTicks )	vPortSetTickDeadline( xTicks )
+/*-----------------------------------------------------------*/
+
 /* Architecture specific optimisations. */
 #ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
 	#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
@@ -186,6 +196,10 @@ BaseType_t xReturn;
 	return xReturn;
 }
 
+/* Asserts if called from an interrupt, for functions that are not interrupt
+safe. */
+#define portASSERT_IF_IN_ISR()	configASSERT( xPortIsInsideInterrupt() == pdFALSE )
+
 /*-----------------------------------------------------------*/
 
 portFORCE_INLINE static void vPortRaiseBASEPRI( void )
@@ -0,0 +1,976 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*-----------------------------------------------------------
+ * Implementation of functions defined in portable.h for the POSIX simulator
+ * port.
+ *
+ * Each task runs in its own host thread, using the stack allocated for the
+ * task by the kernel.  Only the thread of the task referenced by pxCurrentTCB
+ * is ever allowed to run, so a context switch consists of resuming the thread
+ * of the new task then suspending the thread of the old task.
+ *
+ * The tick interrupt is simulated using a host signal that is raised by a
+ * separate tick thread.  Masking interrupts does not block the signal, it just
+ * sets a flag that causes the signal handler to hold the tick pending until
+ * the mask is cleared again - in the same way a real interrupt controller
+ * would.  This keeps the cost of critical sections close to that of a real
+ * target so the port can be used to profile the kernel on the host.
+ *
+ * When configUSE_DYNAMIC_TICK is 1 the tick thread models a one-shot timer
+ * instead of a periodic one - it only raises the tick signal when the deadline
+ * set by the kernel through portSET_TICK_DEADLINE() is reached.
+ *----------------------------------------------------------*/
+
+/* Standard includes. */
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* When configPOSIX_SIMULATED_TICK is 1 the tick is generated from simulated
+time rather than from the host's clock.  Simulated time only moves forward
+while the idle task is running, so code executed by the tasks takes no time
+at all as far as the kernel is concerned and the order in which events occur
+is the same on every run.  Tasks can use vPortGenerateSimulatedTicks() to
+model time spent processing.  When configPOSIX_SIMULATED_TICK is 0 the tick
+is generated at configTICK_RATE_HZ from the host's monotonic clock. */
+#ifndef configPOSIX_SIMULATED_TICK
+	#define configPOSIX_SIMULATED_TICK 1
+#endif
+
+#if( ( configPOSIX_SIMULATED_TICK == 1 ) && ( INCLUDE_xTaskGetIdleTaskHandle != 1 ) )
+	#error INCLUDE_xTaskGetIdleTaskHandle must be set to 1 in FreeRTOSConfig.h when configPOSIX_SIMULATED_TICK is set to 1.
+#endif
+
+/* The host signal used to simulate the tick interrupt.  Host threads that are
+not created by the kernel must keep this signal blocked. */
+#ifndef configPOSIX_TICK_SIGNAL
+	#define configPOSIX_TICK_SIGNAL		SIGALRM
+#endif
+
+#define portNANOSECONDS_PER_SECOND		( 1000000000ULL )
+#define portNANOSECONDS_PER_TICK		( portNANOSECONDS_PER_SECOND / ( uint64_t ) configTICK_RATE_HZ )
+
+/* The longest time, in ticks, for which the one-shot tick timer is armed when
+configUSE_DYNAMIC_TICK is 1, and the longest time the tick thread sleeps
+without checking whether the scheduler has been ended. */
+#define portMAX_TICK_DEADLINE			( ( TickType_t ) configTICK_RATE_HZ )
+#define portMAX_TICK_THREAD_SLEEP_NS	( portNANOSECONDS_PER_SECOND / 10ULL )
+
+/* The value of the one-shot deadline when the timer is not armed. */
+#define portDEADLINE_NOT_ARMED			( UINT64_MAX )
+
+/* The control data for the host thread that runs a task.  The structure is
+stored at the top of the task's stack. */
+typedef struct THREAD
+{
+	pthread_t xThread;
+	TaskFunction_t pxCode;
+	void *pvParameters;
+	pthread_mutex_t xMutex;
+	pthread_cond_t xResumeCondition;
+	BaseType_t xResumed;			/* Protected by xMutex. */
+	volatile BaseType_t xDying;
+} Thread_t;
+
+/* The kernel's record of the running task.  The first member of the TCB is
+the task's top of stack pointer, from which the thread's control data is
+obtained. */
+extern void * volatile pxCurrentTCB;
+
+/*
+ * Setup the signal used to simulate the tick interrupt.
+ */
+static void prvSetupSignals( void );
+
+/*
+ * Sets the time base of the run time counter.  Called once, on the first read
+ * of the counter.
+ */
+static void prvSetRunTimeBase( void );
+
+/*
+ * The entry point of all the task threads.  The thread waits until the task
+ * is scheduled for the first time, then calls the task's function.
+ */
+static void *prvWaitForStart( void *pvParameters );
+
+/*
+ * The entry point of the thread that generates the tick.
+ */
+static void *prvTickThread( void *pvParameters );
+
+/*
+ * The simulated tick interrupt handler, and the host signal handler that
+ * either calls it or holds it pending if interrupts are masked.
+ */
+static void prvTickInterrupt( void );
+static void prvTickSignalHandler( int iSignal );
+
+/*
+ * Clear the interrupt mask, then process any tick that was held pending while
+ * the mask was set.
+ */
+static void prvUnmaskInterrupts( void );
+
+/*
+ * Resume the thread of the task selected to run, then suspend the thread of
+ * the task that was running.  Called with interrupts masked.
+ */
+static void prvSwitchThread( Thread_t *pxThreadToResume, Thread_t *pxThreadToSuspend );
+static void prvSuspendSelf( Thread_t *pxThread );
+static void prvResumeThread( Thread_t *pxThread );
+
+/*
+ * Report a failed host call then abort the process.
+ */
+static void prvFatalError( const char *pcCall, int iError );
+
+/*
+ * Read the host's monotonic clock.
+ */
+static uint64_t prvGetTimeNs( void );
+
+#if( configUSE_DYNAMIC_TICK == 1 )
+
+	/*
+	 * The time, in nanoseconds since the scheduler was started, against which
+	 * the one-shot tick timer runs - simulated time if
+	 * configPOSIX_SIMULATED_TICK is 1, otherwise the host's monotonic clock.
+	 */
+	static uint64_t prvGetElapsedNs( void );
+
+#endif /* configUSE_DYNAMIC_TICK */
+
+/*-----------------------------------------------------------*/
+
+/* Each task maintains its own interrupt status in the critical nesting and
+interrupt mask variables.  Both are saved and restored across a context switch
+by prvSwitchThread(). */
+static volatile UBaseType_t uxCriticalNesting = 0;
+static volatile BaseType_t xInterruptsMasked = pdFALSE;
+
+/* Set by the signal handler if the tick occurs while interrupts are masked. */
+static volatile BaseType_t xTickPending = pdFALSE;
+
+/* The number of ticks processed, used to pace the simulated tick. */
+static volatile uint32_t ulTicksProcessed = 0;
+
+static pthread_once_t xSignalSetupOnce = PTHREAD_ONCE_INIT;
+static sigset_t xTickSignalSet;
+static sigset_t xSchedulerOriginalSignalMask;
+static pthread_t xTickThread;
+static pthread_mutex_t xEndMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t xEndCondition = PTHREAD_COND_INITIALIZER;
+static volatile BaseType_t xSchedulerEnd = pdFALSE;
+static uint64_t ullStartTimeNs = 0;
+
+/* The time base of the run time counter, set when the counter is first read
+so the counter starts from 0 and never goes backwards, even if it is read, for
+example by the trace recorder, before the scheduler is started. */
+static pthread_once_t xRunTimeBaseOnce = PTHREAD_ONCE_INIT;
+static uint64_t ullRunTimeBaseNs = 0;
+
+#if( configUSE_DYNAMIC_TICK == 1 )
+
+	/* The time of the last tick boundary announced to the kernel, and the time
+	at which the one-shot tick timer next expires.  Both are in nanoseconds
+	since the scheduler was started.  The announced time only ever moves in
+	whole tick periods, so the tick count cannot drift from the time base. */
+	static volatile uint64_t ullAnnouncedNs = 0;
+	static volatile uint64_t ullDeadlineNs = portDEADLINE_NOT_ARMED;
+
+	#if( configPOSIX_SIMULATED_TICK == 1 )
+		static volatile uint64_t ullSimulatedTimeNs = 0;
+	#else
+		/* Written to wake the tick thread when the deadline is moved earlier. */
+		static int iDeadlinePipe[ 2 ] = { -1, -1 };
+	#endif
+
+#endif /* configUSE_DYNAMIC_TICK */
+
+/*-----------------------------------------------------------*/
+
+static Thread_t *prvGetThreadFromTask( void *pvTask )
+{
+StackType_t *pxTopOfStack = *( StackType_t ** ) pvTask;
+
+	return ( Thread_t * ) ( pxTopOfStack + 1 );
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * See header file for description.
+ */
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, StackType_t *pxEndOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+Thread_t *pxThread;
+pthread_attr_t xThreadAttributes;
+sigset_t xSavedSignalMask;
+size_t xStackSize;
+int iReturn;
+
+	( void ) pthread_once( &xSignalSetupOnce, prvSetupSignals );
+
+	/* Store the thread's control data at the top of the task's stack, the
+	remainder of the stack is used by the thread itself. */
+	pxThread = ( ( Thread_t * ) ( pxTopOfStack + 1 ) ) - 1;
+	pxTopOfStack = ( ( StackType_t * ) pxThread ) - 1;
+	xStackSize = ( size_t ) ( ( pxTopOfStack + 1 ) - pxEndOfStack ) * sizeof( StackType_t );
+
+	pxThread->pxCode = pxCode;
+	pxThread->pvParameters = pvParameters;
+	pxThread->xResumed = pdFALSE;
+	pxThread->xDying = pdFALSE;
+	( void ) pthread_mutex_init( &( pxThread->xMutex ), NULL );
+	( void ) pthread_cond_init( &( pxThread->xResumeCondition ), NULL );
+
+	/* The host requires a minimum stack size - if this fails then increase
+	configMINIMAL_STACK_SIZE and the stack size of the created tasks. */
+	( void ) pthread_attr_init( &xThreadAttributes );
+	iReturn = pthread_attr_setstack( &xThreadAttributes, pxEndOfStack, xStackSize );
+	if( iReturn != 0 )
+	{
+		prvFatalError( "pthread_attr_setstack", iReturn );
+	}
+
+	/* New threads inherit the signal mask of the thread that creates them.
+	Don't allow the new thread to take the tick signal until it is scheduled
+	for the first time. */
+	( void ) pthread_sigmask( SIG_BLOCK, &xTickSignalSet, &xSavedSignalMask );
+	iReturn = pthread_create( &( pxThread->xThread ), &xThreadAttributes, prvWaitForStart, pxThread );
+	( void ) pthread_sigmask( SIG_SETMASK, &xSavedSignalMask, NULL );
+	( void ) pthread_attr_destroy( &xThreadAttributes );
+
+	if( iReturn != 0 )
+	{
+		prvFatalError( "pthread_create", iReturn );
+	}
+
+	return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+int iReturn;
+
+	( void ) pthread_once( &xSignalSetupOnce, prvSetupSignals );
+
+	/* The thread that starts the scheduler, and the tick thread that inherits
+	its signal mask, must never take the tick signal. */
+	( void ) pthread_sigmask( SIG_BLOCK, &xTickSignalSet, &xSchedulerOriginalSignalMask );
+
+	ullStartTimeNs = prvGetTimeNs();
+	xSchedulerEnd = pdFALSE;
+
+	#if( configUSE_DYNAMIC_TICK == 1 )
+	{
+		#if( configPOSIX_SIMULATED_TICK == 0 )
+		{
+			if( iDeadlinePipe[ 0 ] < 0 )
+			{
+				if( pipe( iDeadlinePipe ) != 0 )
+				{
+					prvFatalError( "pipe", errno );
+				}
+
+				( void ) fcntl( iDeadlinePipe[ 0 ], F_SETFL, O_NONBLOCK );
+				( void ) fcntl( iDeadlinePipe[ 1 ], F_SETFL, O_NONBLOCK );
+			}
+		}
+		#else
+		{
+			ullSimulatedTimeNs = 0;
+		}
+		#endif
+
+		/* The first tick interrupt occurs after one tick period, from then on
+		the kernel sets the deadline. */
+		ullAnnouncedNs = 0;
+		ullDeadlineNs = portNANOSECONDS_PER_TICK;
+	}
+	#endif /* configUSE_DYNAMIC_TICK */
+
+	iReturn = pthread_create( &xTickThread, NULL, prvTickThread, NULL );
+	if( iReturn != 0 )
+	{
+		prvFatalError( "pthread_create", iReturn );
+	}
+
+	/* Start the first task. */
+	prvResumeThread( prvGetThreadFromTask( pxCurrentTCB ) );
+
+	/* Wait until vPortEndScheduler() is called. */
+	( void ) pthread_mutex_lock( &xEndMutex );
+	while( xSchedulerEnd == pdFALSE )
+	{
+		( void ) pthread_cond_wait( &xEndCondition, &xEndMutex );
+	}
+	( void ) pthread_mutex_unlock( &xEndMutex );
+
+	( void ) pthread_join( xTickThread, NULL );
+	( void ) pthread_sigmask( SIG_SETMASK, &xSchedulerOriginalSignalMask, NULL );
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+Thread_t *pxThread = prvGetThreadFromTask( pxCurrentTCB );
+
+	/* Stop the tick thread and return control to the thread that started the
+	scheduler. */
+	( void ) pthread_mutex_lock( &xEndMutex );
+	xSchedulerEnd = pdTRUE;
+	( void ) pthread_cond_signal( &xEndCondition );
+	( void ) pthread_mutex_unlock( &xEndMutex );
+
+	/* The calling task never runs again. */
+	( void ) pthread_sigmask( SIG_BLOCK, &xTickSignalSet, NULL );
+	for( ;; )
+	{
+		prvSuspendSelf( pxThread );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+Thread_t *pxThreadToSuspend;
+
+	vPortEnterCritical();
+	{
+		pxThreadToSuspend = prvGetThreadFromTask( pxCurrentTCB );
+		vTaskSwitchContext();
+		prvSwitchThread( prvGetThreadFromTask( pxCurrentTCB ), pxThreadToSuspend );
+	}
+	vPortExitCritical();
+}
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts( void )
+{
+	xInterruptsMasked = pdTRUE;
+	__atomic_signal_fence( __ATOMIC_SEQ_CST );
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts( void )
+{
+	__atomic_signal_fence( __ATOMIC_SEQ_CST );
+	prvUnmaskInterrupts();
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxPortSetInterruptMask( void )
+{
+UBaseType_t uxWasMasked = ( UBaseType_t ) xInterruptsMasked;
+
+	vPortDisableInterrupts();
+	return uxWasMasked;
+}
+/*-----------------------------------------------------------*/
+
+void vPortClearInterruptMask( UBaseType_t uxMask )
+{
+	if( uxMask == ( UBaseType_t ) pdFALSE )
+	{
+		vPortEnableInterrupts();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+	vPortDisableInterrupts();
+	uxCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+	configASSERT( uxCriticalNesting );
+	uxCriticalNesting--;
+	if( uxCriticalNesting == 0 )
+	{
+		vPortEnableInterrupts();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortGenerateSimulatedTicks( TickType_t xTicks )
+{
+	/* Must be called from a task, outside of a critical section. */
+	configASSERT( uxCriticalNesting == 0 );
+
+	#if( ( configUSE_DYNAMIC_TICK == 1 ) && ( configPOSIX_SIMULATED_TICK == 1 ) )
+	{
+		/* The tick interrupt only occurs when simulated time reaches the
+		deadline set by the kernel. */
+		vPortAdvanceSimulatedTime( ( uint64_t ) xTicks * portNANOSECONDS_PER_TICK );
+	}
+	#else
+	{
+		while( xTicks > ( TickType_t ) 0 )
+		{
+			vPortDisableInterrupts();
+			prvTickInterrupt();
+			vPortEnableInterrupts();
+			xTicks--;
+		}
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_DYNAMIC_TICK == 1 ) && ( configPOSIX_SIMULATED_TICK == 1 ) )
+
+	void vPortAdvanceSimulatedTime( uint64_t ullNanoseconds )
+	{
+	uint64_t ullStep;
+
+		/* Must be called from a task, outside of a critical section. */
+		configASSERT( uxCriticalNesting == 0 );
+
+		while( ullNanoseconds > 0ULL )
+		{
+			vPortDisableInterrupts();
+			{
+				/* Move time forward no further than the deadline, so the tick
+				interrupt occurs at exactly the time a hardware one-shot timer
+				would generate it. */
+				if( ullDeadlineNs <= ullSimulatedTimeNs )
+				{
+					ullStep = 0ULL;
+				}
+				else if( ( ullDeadlineNs - ullSimulatedTimeNs ) < ullNanoseconds )
+				{
+					ullStep = ullDeadlineNs - ullSimulatedTimeNs;
+				}
+				else
+				{
+					ullStep = ullNanoseconds;
+				}
+
+				ullSimulatedTimeNs += ullStep;
+				ullNanoseconds -= ullStep;
+
+				if( ullSimulatedTimeNs >= ullDeadlineNs )
+				{
+					prvTickInterrupt();
+				}
+			}
+			vPortEnableInterrupts();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	uint64_t ullPortGetSimulatedTime( void )
+	{
+		return ullSimulatedTimeNs;
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* ( configUSE_DYNAMIC_TICK == 1 ) && ( configPOSIX_SIMULATED_TICK == 1 ) */
+
+#if( configUSE_DYNAMIC_TICK == 1 )
+
+	TickType_t xPortGetUnannouncedTicks( void )
+	{
+		/* Called with interrupts masked. */
+		return ( TickType_t ) ( ( prvGetElapsedNs() - ullAnnouncedNs ) / portNANOSECONDS_PER_TICK );
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortAnnounceTicks( TickType_t xTicks )
+	{
+		/* Called with interrupts masked.  Move the announced time forward by
+		whole tick periods only, so the part of a tick period that has passed
+		is carried into the next announcement. */
+		ullAnnouncedNs += ( uint64_t ) xTicks * portNANOSECONDS_PER_TICK;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortSetTickDeadline( TickType_t xTicks )
+	{
+	uint64_t ullDeadline;
+
+		/* Called with interrupts masked.  The deadline is relative to the last
+		announced tick boundary, not to the current time, so the timer expires
+		on a tick boundary. */
+		if( xTicks > portMAX_TICK_DEADLINE )
+		{
+			xTicks = portMAX_TICK_DEADLINE;
+		}
+
+		ullDeadline = ullAnnouncedNs + ( ( uint64_t ) xTicks * portNANOSECONDS_PER_TICK );
+
+		if( ullDeadline != ullDeadlineNs )
+		{
+			#if( configPOSIX_SIMULATED_TICK == 0 )
+			{
+				if( ( ullDeadline < ullDeadlineNs ) && ( ullDeadlineNs != portDEADLINE_NOT_ARMED ) )
+				{
+					ullDeadlineNs = ullDeadline;
+
+					/* The tick thread might be sleeping until the old
+					deadline.  write() is safe to call from a signal
+					handler. */
+					( void ) write( iDeadlinePipe[ 1 ], "", 1 );
+				}
+				else
+				{
+					/* The tick thread is waiting for the timer to be armed
+					again, or will expire the timer early then find the
+					deadline has moved. */
+					ullDeadlineNs = ullDeadline;
+				}
+			}
+			#else
+			{
+				ullDeadlineNs = ullDeadline;
+			}
+			#endif
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configUSE_DYNAMIC_TICK */
+
+void vPortThreadDying( void *pvTaskToDelete, volatile BaseType_t *pxPendYield )
+{
+	( void ) pxPendYield;
+
+	/* The task is deleting itself.  Its thread exits when it next switches
+	out, see prvSwitchThread(). */
+	prvGetThreadFromTask( pvTaskToDelete )->xDying = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortCancelThread( void *pvTaskToDelete )
+{
+Thread_t *pxThread = prvGetThreadFromTask( pvTaskToDelete );
+
+	/* A task that deleted itself has already exited its thread.  Any other
+	task is suspended, and exits its thread as soon as it is resumed.  Either
+	way the thread must have finished with its stack before the kernel frees
+	it. */
+	pxThread->xDying = pdTRUE;
+	prvResumeThread( pxThread );
+	( void ) pthread_join( pxThread->xThread, NULL );
+
+	( void ) pthread_cond_destroy( &( pxThread->xResumeCondition ) );
+	( void ) pthread_mutex_destroy( &( pxThread->xMutex ) );
+}
+/*-----------------------------------------------------------*/
+
+uint64_t ullPortGetCycleCounter( void )
+{
+uint64_t ullCount;
+
+	#if defined( __x86_64__ ) || defined( __i386__ )
+	{
+		ullCount = __builtin_ia32_rdtsc();
+	}
+	#elif defined( __aarch64__ )
+	{
+		__asm volatile( "isb; mrs %0, cntvct_el0" : "=r"( ullCount ) :: "memory" );
+	}
+	#else
+	{
+		ullCount = prvGetTimeNs();
+	}
+	#endif
+
+	return ullCount;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulPortGetRunTimeCounterValue( void )
+{
+	( void ) pthread_once( &xRunTimeBaseOnce, prvSetRunTimeBase );
+
+	/* Microseconds since the counter was first read. */
+	return ( uint32_t ) ( ( prvGetTimeNs() - ullRunTimeBaseNs ) / 1000ULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSetRunTimeBase( void )
+{
+	ullRunTimeBaseNs = prvGetTimeNs();
+}
+/*-----------------------------------------------------------*/
+
+static void prvSetupSignals( void )
+{
+struct sigaction xAction;
+
+	( void ) sigemptyset( &xTickSignalSet );
+	( void ) sigaddset( &xTickSignalSet, configPOSIX_TICK_SIGNAL );
+
+	/* Host threads created by the application after this point inherit a mask
+	that blocks the tick signal. */
+	( void ) pthread_sigmask( SIG_BLOCK, &xTickSignalSet, NULL );
+
+	memset( &xAction, 0x00, sizeof( xAction ) );
+	xAction.sa_handler = prvTickSignalHandler;
+	( void ) sigfillset( &xAction.sa_mask );
+
+	if( sigaction( configPOSIX_TICK_SIGNAL, &xAction, NULL ) != 0 )
+	{
+		prvFatalError( "sigaction", errno );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void *prvWaitForStart( void *pvParameters )
+{
+Thread_t *pxThread = ( Thread_t * ) pvParameters;
+
+	prvSuspendSelf( pxThread );
+
+	/* The task is running for the first time.  Tasks start with interrupts
+	enabled. */
+	uxCriticalNesting = 0;
+	( void ) pthread_sigmask( SIG_UNBLOCK, &xTickSignalSet, NULL );
+	vPortEnableInterrupts();
+
+	pxThread->pxCode( pxThread->pvParameters );
+
+	/* A function that implements a task must not exit or attempt to return to
+	its caller as there is nothing to return to.  If a task wants to exit it
+	should instead call vTaskDelete( NULL ). */
+	configASSERT( pdFALSE );
+	prvFatalError( "task function returned", 0 );
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvTickThread( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	#if( configPOSIX_SIMULATED_TICK == 1 )
+	{
+	TaskHandle_t xIdleTask = xTaskGetIdleTaskHandle();
+	uint32_t ulTicksBefore;
+
+		while( xSchedulerEnd == pdFALSE )
+		{
+			/* Simulated time only moves forward while the idle task is the
+			running task. */
+			if( pxCurrentTCB != ( void * ) xIdleTask )
+			{
+				( void ) sched_yield();
+				continue;
+			}
+
+			#if( configUSE_DYNAMIC_TICK == 1 )
+			{
+				/* Nothing happens while the idle task is running until the
+				one-shot timer expires, so move simulated time straight to the
+				deadline. */
+				if( ullSimulatedTimeNs < ullDeadlineNs )
+				{
+					ullSimulatedTimeNs = ullDeadlineNs;
+				}
+			}
+			#endif /* configUSE_DYNAMIC_TICK */
+
+			/* Raise the tick, then wait for it to be processed so ticks are
+			never coalesced. */
+			ulTicksBefore = ulTicksProcessed;
+			( void ) kill( getpid(), configPOSIX_TICK_SIGNAL );
+
+			while( ( ulTicksProcessed == ulTicksBefore ) && ( xSchedulerEnd == pdFALSE ) )
+			{
+				( void ) sched_yield();
+			}
+		}
+	}
+	#elif( configUSE_DYNAMIC_TICK == 1 )
+	{
+	uint64_t ullDeadline, ullWait;
+	struct timespec xTimeout;
+	fd_set xReadSet;
+	char cDrain[ 16 ];
+
+		while( xSchedulerEnd == pdFALSE )
+		{
+			ullDeadline = ullDeadlineNs;
+			ullWait = prvGetElapsedNs();
+
+			if( ullWait >= ullDeadline )
+			{
+				/* The one-shot timer has expired.  Disarm it, unless the
+				kernel has moved the deadline since it was read, then raise the
+				tick - the kernel arms the timer again from the tick interrupt. */
+				if( __atomic_compare_exchange_n( &ullDeadlineNs, &ullDeadline, portDEADLINE_NOT_ARMED, pdFALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ) != pdFALSE )
+				{
+					( void ) kill( getpid(), configPOSIX_TICK_SIGNAL );
+
+					/* Let the tick be processed, rather than being woken by
+					the new deadline being set. */
+					while( ( ullDeadlineNs == portDEADLINE_NOT_ARMED ) && ( xSchedulerEnd == pdFALSE ) )
+					{
+						( void ) sched_yield();
+					}
+				}
+			}
+			else
+			{
+				/* Sleep until the deadline, or until the kernel moves the
+				deadline earlier. */
+				ullWait = ullDeadline - ullWait;
+				if( ullWait > portMAX_TICK_THREAD_SLEEP_NS )
+				{
+					ullWait = portMAX_TICK_THREAD_SLEEP_NS;
+				}
+
+				xTimeout.tv_sec = ( time_t ) ( ullWait / portNANOSECONDS_PER_SECOND );
+				xTimeout.tv_nsec = ( long ) ( ullWait % portNANOSECONDS_PER_SECOND );
+
+				FD_ZERO( &xReadSet );
+				FD_SET( iDeadlinePipe[ 0 ], &xReadSet );
+
+				if( pselect( iDeadlinePipe[ 0 ] + 1, &xReadSet, NULL, NULL, &xTimeout, NULL ) > 0 )
+				{
+					while( read( iDeadlinePipe[ 0 ], cDrain, sizeof( cDrain ) ) > 0 )
+					{
+						/* Empty the pipe. */
+					}
+				}
+			}
+		}
+	}
+	#else
+	{
+	struct timespec xNextTick;
+
+		( void ) clock_gettime( CLOCK_MONOTONIC, &xNextTick );
+
+		while( xSchedulerEnd == pdFALSE )
+		{
+			xNextTick.tv_nsec += ( long ) portNANOSECONDS_PER_TICK;
+			while( xNextTick.tv_nsec >= ( long ) portNANOSECONDS_PER_SECOND )
+			{
+				xNextTick.tv_nsec -= ( long ) portNANOSECONDS_PER_SECOND;
+				xNextTick.tv_sec++;
+			}
+
+			while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xNextTick, NULL ) == EINTR )
+			{
+				/* Interrupted, keep waiting. */
+			}
+
+			/* If the tick is still pending from last time it is lost, as it
+			would be on real hardware. */
+			( void ) kill( getpid(), configPOSIX_TICK_SIGNAL );
+		}
+	}
+	#endif /* configPOSIX_SIMULATED_TICK */
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTickInterrupt( void )
+{
+Thread_t *pxThreadToSuspend;
+BaseType_t xSwitchRequired;
+
+	/* Called with interrupts masked. */
+	pxThreadToSuspend = prvGetThreadFromTask( pxCurrentTCB );
+
+	#if( configUSE_DYNAMIC_TICK == 1 )
+	{
+		/* Announces every tick period that has passed, and sets the next
+		deadline. */
+		xSwitchRequired = xTaskAnnounceElapsedTicks();
+	}
+	#else
+	{
+		xSwitchRequired = xTaskIncrementTick();
+	}
+	#endif
+
+	/* Must be incremented before the switch, as this thread might not run
+	again for some time. */
+	ulTicksProcessed++;
+
+	if( xSwitchRequired != pdFALSE )
+	{
+		vTaskSwitchContext();
+		prvSwitchThread( prvGetThreadFromTask( pxCurrentTCB ), pxThreadToSuspend );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTickSignalHandler( int iSignal )
+{
+	( void ) iSignal;
+
+	if( xInterruptsMasked != pdFALSE )
+	{
+		/* Hold the tick pending until interrupts are unmasked. */
+		xTickPending = pdTRUE;
+	}
+	else
+	{
+		vPortDisableInterrupts();
+		prvTickInterrupt();
+		vPortEnableInterrupts();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnmaskInterrupts( void )
+{
+	xInterruptsMasked = pdFALSE;
+	__atomic_signal_fence( __ATOMIC_SEQ_CST );
+
+	/* A tick that occurs after the mask is cleared is processed directly by the
+	signal handler, so only a tick that was already pending is processed here. */
+	while( __atomic_exchange_n( &xTickPending, pdFALSE, __ATOMIC_SEQ_CST ) != pdFALSE )
+	{
+		vPortDisableInterrupts();
+		prvTickInterrupt();
+		xInterruptsMasked = pdFALSE;
+		__atomic_signal_fence( __ATOMIC_SEQ_CST );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSwitchThread( Thread_t *pxThreadToResume, Thread_t *pxThreadToSuspend )
+{
+UBaseType_t uxSavedCriticalNesting;
+BaseType_t xSavedInterruptsMasked;
+sigset_t xSavedSignalMask;
+
+	if( pxThreadToResume != pxThreadToSuspend )
+	{
+		/* The interrupt status is per task, so save it on the stack of the
+		suspending thread and restore it when the task runs again. */
+		uxSavedCriticalNesting = uxCriticalNesting;
+		xSavedInterruptsMasked = xInterruptsMasked;
+
+		/* Only the running thread can take the tick signal. */
+		( void ) pthread_sigmask( SIG_BLOCK, &xTickSignalSet, &xSavedSignalMask );
+
+		prvResumeThread( pxThreadToResume );
+
+		if( pxThreadToSuspend->xDying != pdFALSE )
+		{
+			/* The task deleted itself. */
+			pthread_exit( NULL );
+		}
+
+		prvSuspendSelf( pxThreadToSuspend );
+
+		uxCriticalNesting = uxSavedCriticalNesting;
+		xInterruptsMasked = xSavedInterruptsMasked;
+		( void ) pthread_sigmask( SIG_SETMASK, &xSavedSignalMask, NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSuspendSelf( Thread_t *pxThread )
+{
+	( void ) pthread_mutex_lock( &( pxThread->xMutex ) );
+	while( pxThread->xResumed == pdFALSE )
+	{
+		( void ) pthread_cond_wait( &( pxThread->xResumeCondition ), &( pxThread->xMutex ) );
+	}
+	pxThread->xResumed = pdFALSE;
+	( void ) pthread_mutex_unlock( &( pxThread->xMutex ) );
+
+	if( pxThread->xDying != pdFALSE )
+	{
+		/* The task was deleted while it was not running. */
+		pthread_exit( NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvResumeThread( Thread_t *pxThread )
+{
+	( void ) pthread_mutex_lock( &( pxThread->xMutex ) );
+	pxThread->xResumed = pdTRUE;
+	( void ) pthread_cond_signal( &( pxThread->xResumeCondition ) );
+	( void ) pthread_mutex_unlock( &( pxThread->xMutex ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvFatalError( const char *pcCall, int iError )
+{
+	fprintf( stderr, "FreeRTOS POSIX port: %s failed: %s\n", pcCall, strerror( iError ) );
+	abort();
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTimeNs( void )
+{
+struct timespec xNow;
+
+	( void ) clock_gettime( CLOCK_MONOTONIC, &xNow );
+	return ( ( uint64_t ) xNow.tv_sec * portNANOSECONDS_PER_SECOND ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_DYNAMIC_TICK == 1 )
+
+	static uint64_t prvGetElapsedNs( void )
+	{
+		#if( configPOSIX_SIMULATED_TICK == 1 )
+		{
+			return ullSimulatedTimeNs;
+		}
+		#else
+		{
+			return prvGetTimeNs() - ullStartTimeNs;
+		}
+		#endif
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configUSE_DYNAMIC_TICK */
@@ -50,6 +50,10 @@ task.h is included from an application file. */
 	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
 #endif
 
+#if( configUSE_HEAP_TASK_CACHE == 1 )
+	#error configUSE_HEAP_TASK_CACHE is only supported by heap_4.c
+#endif
+
 /* A few bytes might be lost to byte aligning the heap start address. */
 #define configADJUSTED_HEAP_SIZE	( configTOTAL_HEAP_SIZE - portBYTE_ALIGNMENT )
 
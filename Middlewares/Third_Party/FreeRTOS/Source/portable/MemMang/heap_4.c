@@ -32,8 +32,23 @@
  *
  * See heap_1.c, heap_2.c and heap_3.c for alternative implementations, and the
  * memory management pages of http://www.FreeRTOS.org for more information.
+ *
+ * If configUSE_HEAP_TASK_CACHE is set to 1 in FreeRTOSConfig.h then each task
+ * also keeps a small cache of freed blocks of up to heapCACHE_MAX_SIZE bytes,
+ * held in one of its thread local storage pointers.  Once the scheduler has
+ * started small allocations are served from, and small frees returned to, the
+ * cache of the calling task without searching the list of free blocks.  A
+ * cached block remains allocated as far as the heap is concerned, so is not
+ * included in the free heap size, and the blocks in a task's cache are returned
+ * to the heap when the task is deleted.
+ *
+ * As the scheduler is suspended while the heap is updated, pvPortMalloc() and
+ * vPortFree() must not be called from an interrupt.  If
+ * configUSE_HEAP_TASK_CACHE is set to 1 then ports that define
+ * portASSERT_IF_IN_ISR() assert if they are.
  */
 #include <stdlib.h>
+#include <string.h>
 
 /* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
 all the API functions to use the MPU wrappers.  That should only be done when
@@ -49,12 +64,29 @@ task.h is included from an application file. */
 	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
 #endif
 
+#if( configUSE_HEAP_TASK_CACHE == 1 )
+	#if( ( configHEAP_TASK_CACHE_TLS_INDEX < 0 ) || ( configHEAP_TASK_CACHE_TLS_INDEX >= configNUM_THREAD_LOCAL_STORAGE_POINTERS ) )
+		#error configHEAP_TASK_CACHE_TLS_INDEX must be the index of a thread local storage pointer that is not used by the application
+	#endif
+
+	#if( ( INCLUDE_xTaskGetSchedulerState == 0 ) && ( configUSE_TIMERS == 0 ) )
+		#error INCLUDE_xTaskGetSchedulerState must be set to 1 in FreeRTOSConfig.h to use the task cache
+	#endif
+#endif
+
 /* Block sizes must not get too small. */
 #define heapMINIMUM_BLOCK_SIZE	( ( size_t ) ( xHeapStructSize << 1 ) )
 
 /* Assumes 8bit bytes! */
 #define heapBITS_PER_BYTE		( ( size_t ) 8 )
 
+/* The task cache holds blocks in heapCACHE_CLASSES size classes, of
+heapCACHE_MIN_SIZE bytes, twice that, and so on up to heapCACHE_MAX_SIZE
+bytes.  The sizes are the sizes available to the application. */
+#define heapCACHE_CLASSES		( 5 )
+#define heapCACHE_MIN_SIZE		( ( size_t ) 16 )
+#define heapCACHE_MAX_SIZE		( heapCACHE_MIN_SIZE << ( heapCACHE_CLASSES - 1 ) )
+
 /* Allocate the memory for the heap. */
 #if( configAPPLICATION_ALLOCATED_HEAP == 1 )
 	/* The application writer has already defined the array used for the RTOS
@@ -72,6 +104,24 @@ typedef struct A_BLOCK_LINK
 	size_t xBlockSize;						/*<< The size of the free block. */
 } BlockLink_t;
 
+#if( configUSE_HEAP_TASK_CACHE == 1 )
+
+	/* The cache of a single task.  Cached blocks are linked using the
+	pxNextFreeBlock member of their BlockLink_t structure, but keep the
+	allocated bit set in their xBlockSize member.  Only the owning task updates
+	its cache, but the task can be deleted, and its cache freed, while it is
+	preempted part way through an update.  The list heads are therefore
+	volatile, and each update adds or removes a block with a single write to a
+	list head, so the lists are complete at every point.  The block counts only
+	limit the size of the cache, so are not relied on when it is freed. */
+	typedef struct A_TASK_CACHE
+	{
+		BlockLink_t * volatile pxBlocks[ heapCACHE_CLASSES ];
+		UBaseType_t uxNumberOfBlocks[ heapCACHE_CLASSES ];
+	} TaskCache_t;
+
+#endif /* configUSE_HEAP_TASK_CACHE */
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -88,6 +138,30 @@ static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert );
  */
 static void prvHeapInit( void );
 
+/*
+ * Allocate a block from, and return a block to, the heap.
+ */
+static void *prvHeapMalloc( size_t xWantedSize );
+static void prvHeapFree( void *pv );
+
+#if( configUSE_HEAP_TASK_CACHE == 1 )
+
+	/*
+	 * Returns a block from the cache of the calling task, or NULL if there is
+	 * no suitable cached block.  If NULL is returned and the block could be
+	 * cached once it is freed then *pxWantedSize is rounded up to the size of
+	 * its cache class.
+	 */
+	static void *prvTaskCacheMalloc( size_t *pxWantedSize );
+
+	/*
+	 * Adds a block to the cache of the calling task, returning pdFALSE if the
+	 * block must be returned to the heap instead.
+	 */
+	static BaseType_t prvTaskCacheFree( void *pv );
+
+#endif /* configUSE_HEAP_TASK_CACHE */
+
 /*-----------------------------------------------------------*/
 
 /* The size of the structure placed at the beginning of each allocated memory
@@ -114,6 +188,65 @@ static size_t xBlockAllocatedBit = 0;
 
 void *pvPortMalloc( size_t xWantedSize )
 {
+void *pvReturn = NULL;
+
+	#if( configUSE_HEAP_TASK_CACHE == 1 )
+	{
+		pvReturn = prvTaskCacheMalloc( &xWantedSize );
+	}
+	#endif
+
+	if( pvReturn == NULL )
+	{
+		pvReturn = prvHeapMalloc( xWantedSize );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+	{
+		if( pvReturn == NULL )
+		{
+			extern void vApplicationMallocFailedHook( void );
+			vApplicationMallocFailedHook();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
+	configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+BaseType_t xCached = pdFALSE;
+
+	#if( configUSE_HEAP_TASK_CACHE == 1 )
+	{
+		xCached = prvTaskCacheFree( pv );
+	}
+	#endif
+
+	if( xCached == pdFALSE )
+	{
+		prvHeapFree( pv );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void *prvHeapMalloc( size_t xWantedSize )
+{
 BlockLink_t *pxBlock, *pxPreviousBlock, *pxNewBlockLink;
 void *pvReturn = NULL;
 
@@ -244,26 +377,11 @@ void *pvReturn = NULL;
 	}
 	( void ) xTaskResumeAll();
 
-	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
-	{
-		if( pvReturn == NULL )
-		{
-			extern void vApplicationMallocFailedHook( void );
-			vApplicationMallocFailedHook();
-		}
-		else
-		{
-			mtCOVERAGE_TEST_MARKER();
-		}
-	}
-	#endif
-
-	configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
 	return pvReturn;
 }
 /*-----------------------------------------------------------*/
 
-void vPortFree( void *pv )
+static void prvHeapFree( void *pv )
 {
 uint8_t *puc = ( uint8_t * ) pv;
 BlockLink_t *pxLink;
@@ -489,4 +607,218 @@ size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY use
 	}
 	taskEXIT_CRITICAL();
 }
+/*-----------------------------------------------------------*/
+
+#if( configUSE_HEAP_TASK_CACHE == 1 )
+
+	static void *prvTaskCacheMalloc( size_t *pxWantedSize )
+	{
+	TaskCache_t *pxCache;
+	BlockLink_t *pxBlock;
+	UBaseType_t uxClass;
+	void *pvReturn = NULL;
+
+		/* Only small blocks are cached, and the cache can only be used once
+		the scheduler has started, as until then there is no calling task. */
+		if( ( *pxWantedSize > 0 ) && ( *pxWantedSize <= heapCACHE_MAX_SIZE ) && ( xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED ) )
+		{
+			/* Find the smallest class that holds blocks of at least the wanted
+			size. */
+			for( uxClass = 0; ( heapCACHE_MIN_SIZE << uxClass ) < *pxWantedSize; uxClass++ )
+			{
+				/* Nothing to do here, just iterate to the right class. */
+			}
+
+			/* The cache is that of the calling task, so cannot be used from
+			an interrupt. */
+			portASSERT_IF_IN_ISR();
+
+			pxCache = ( TaskCache_t * ) pvTaskGetThreadLocalStoragePointer( NULL, configHEAP_TASK_CACHE_TLS_INDEX );
+
+			if( pxCache == NULL )
+			{
+				/* This is the first small allocation made by the calling task,
+				so create its cache.  The scheduler is suspended so the task
+				cannot be deleted before the cache is recorded in its thread
+				local storage pointer, which would leak the cache.  If the cache
+				cannot be created the block is simply allocated from the heap. */
+				vTaskSuspendAll();
+				{
+					pxCache = ( TaskCache_t * ) prvHeapMalloc( sizeof( TaskCache_t ) );
+
+					if( pxCache != NULL )
+					{
+						( void ) memset( ( void * ) pxCache, 0x00, sizeof( TaskCache_t ) );
+						vTaskSetThreadLocalStoragePointer( NULL, configHEAP_TASK_CACHE_TLS_INDEX, ( void * ) pxCache );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				( void ) xTaskResumeAll();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( pxCache != NULL )
+			{
+				/* The cache is only accessed by the task that owns it, so the
+				block can be removed without a critical section.  Writing the
+				list head removes the block from the cache in one step, so if
+				the task is deleted before then the block is still cached, and
+				if after then it is allocated to the task. */
+				pxBlock = pxCache->pxBlocks[ uxClass ];
+
+				if( pxBlock != NULL )
+				{
+					pxCache->pxBlocks[ uxClass ] = pxBlock->pxNextFreeBlock;
+					( pxCache->uxNumberOfBlocks[ uxClass ] )--;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				pxBlock = NULL;
+			}
+
+			if( pxBlock != NULL )
+			{
+				/* The block is still marked as allocated, and allocated blocks
+				have no "next" block.  The volatile write cannot be moved before
+				the block is removed from the cache, which would cut the rest
+				of the list off the cache. */
+				( ( volatile BlockLink_t * ) pxBlock )->pxNextFreeBlock = NULL;
+				pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+			}
+			else
+			{
+				/* Allocate a block from the heap that is large enough to be
+				reused for any allocation in the same class once it has been
+				freed into a cache. */
+				*pxWantedSize = heapCACHE_MIN_SIZE << uxClass;
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return pvReturn;
+	}
+
+#endif /* configUSE_HEAP_TASK_CACHE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_HEAP_TASK_CACHE == 1 )
+
+	static BaseType_t prvTaskCacheFree( void *pv )
+	{
+	TaskCache_t *pxCache;
+	BlockLink_t *pxLink;
+	size_t xSize;
+	UBaseType_t uxClass;
+	BaseType_t xReturn = pdFALSE;
+
+		if( ( pv != NULL ) && ( xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED ) )
+		{
+			/* The cache is that of the calling task, so cannot be used from
+			an interrupt. */
+			portASSERT_IF_IN_ISR();
+
+			/* The memory being freed will have an BlockLink_t structure
+			immediately before it. */
+			pxLink = ( void * ) ( ( ( uint8_t * ) pv ) - xHeapStructSize );
+
+			/* Check the block is actually allocated. */
+			configASSERT( ( pxLink->xBlockSize & xBlockAllocatedBit ) != 0 );
+			configASSERT( pxLink->pxNextFreeBlock == NULL );
+
+			/* The number of bytes in the block that are available to the
+			application.  Blocks that are much larger than the largest class are
+			returned to the heap rather than wasted. */
+			xSize = ( pxLink->xBlockSize & ~xBlockAllocatedBit ) - xHeapStructSize;
+
+			if( ( xSize >= heapCACHE_MIN_SIZE ) && ( xSize < ( heapCACHE_MAX_SIZE << 1 ) ) )
+			{
+				/* Find the largest class the block can be used for. */
+				for( uxClass = ( UBaseType_t ) heapCACHE_CLASSES - 1; ( heapCACHE_MIN_SIZE << uxClass ) > xSize; uxClass-- )
+				{
+					/* Nothing to do here, just iterate to the right class. */
+				}
+
+				pxCache = ( TaskCache_t * ) pvTaskGetThreadLocalStoragePointer( NULL, configHEAP_TASK_CACHE_TLS_INDEX );
+
+				if( ( pxCache != NULL ) && ( pxCache->uxNumberOfBlocks[ uxClass ] < ( UBaseType_t ) configHEAP_TASK_CACHE_DEPTH ) )
+				{
+					/* The block remains marked as allocated.  As per
+					prvTaskCacheMalloc(), writing the list head adds the block
+					to the cache in one step, so the block must be linked to the
+					rest of the list first.  The volatile write keeps the two
+					writes in order.  If the task is deleted before the list
+					head is written the block is still allocated to the task. */
+					( ( volatile BlockLink_t * ) pxLink )->pxNextFreeBlock = pxCache->pxBlocks[ uxClass ];
+					pxCache->pxBlocks[ uxClass ] = pxLink;
+					( pxCache->uxNumberOfBlocks[ uxClass ] )++;
+					xReturn = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_HEAP_TASK_CACHE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_HEAP_TASK_CACHE == 1 )
+
+	void vPortFreeTaskCache( void *pvTaskCache )
+	{
+	TaskCache_t *pxCache = ( TaskCache_t * ) pvTaskCache;
+	BlockLink_t *pxBlock;
+	UBaseType_t uxClass;
+
+		/* pvTaskCache is NULL if the task never made a small allocation. */
+		if( pxCache != NULL )
+		{
+			for( uxClass = 0; uxClass < ( UBaseType_t ) heapCACHE_CLASSES; uxClass++ )
+			{
+				while( pxCache->pxBlocks[ uxClass ] != NULL )
+				{
+					pxBlock = pxCache->pxBlocks[ uxClass ];
+					pxCache->pxBlocks[ uxClass ] = pxBlock->pxNextFreeBlock;
+
+					/* Allocated blocks have no "next" block. */
+					pxBlock->pxNextFreeBlock = NULL;
+					prvHeapFree( ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize ) );
+				}
+			}
+
+			prvHeapFree( pvTaskCache );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_HEAP_TASK_CACHE */
 
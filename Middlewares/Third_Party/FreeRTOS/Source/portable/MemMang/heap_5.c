@@ -66,6 +66,29 @@
  *
  * Note 0x80000000 is the lower address so appears in the array first.
  *
+ * Each region has its own list of free blocks, and a block is never split
+ * across regions.  Regions are searched in order of the number of capabilities
+ * they have, fewest first, then in address order, so allocations that do not
+ * need a capability are taken from the least capable memory first.
+ *
+ * If configUSE_HEAP_REGION_CAPABILITIES is set to 1 in FreeRTOSConfig.h then
+ * HeapRegion_t has a third member, ulCapabilities, that holds a bitmask of the
+ * portHEAP_CAPABILITY_... values describing the memory in the region, and
+ * pvPortMallocCaps() can be used to allocate memory from a region that has all
+ * the requested capabilities.  For example, on an STM32H7:
+ *
+ * HeapRegion_t xHeapRegions[] =
+ * {
+ * 	{ ( uint8_t * ) 0x20000000UL, 0x20000, portHEAP_CAPABILITY_FAST }, << DTCM.
+ * 	{ ( uint8_t * ) 0x24000000UL, 0x80000, portHEAP_CAPABILITY_DMA }, << AXI SRAM.
+ * 	{ ( uint8_t * ) 0x38000000UL, 0x10000, portHEAP_CAPABILITY_DMA | portHEAP_CAPABILITY_NON_CACHEABLE }, << SRAM4, configured as non-cacheable by the MPU.
+ * 	{ NULL, 0, 0 }
+ * };
+ *
+ * configTASK_STACK_HEAP_CAPABILITIES and configQUEUE_STORAGE_HEAP_CAPABILITIES
+ * can then be set to portHEAP_CAPABILITY_FAST to place the stacks of tasks, and
+ * the storage of queues, created using dynamically allocated memory in DTCM.
+ *
  */
 #include <stdlib.h>
 
@@ -83,6 +106,10 @@ task.h is included from an application file. */
 	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
 #endif
 
+#if( configUSE_HEAP_TASK_CACHE == 1 )
+	#error configUSE_HEAP_TASK_CACHE is only supported by heap_4.c
+#endif
+
 /* Block sizes must not get too small. */
 #define heapMINIMUM_BLOCK_SIZE	( ( size_t ) ( xHeapStructSize << 1 ) )
 
@@ -97,15 +124,48 @@ typedef struct A_BLOCK_LINK
 	size_t xBlockSize;						/*<< The size of the free block. */
 } BlockLink_t;
 
+/* Placed at the start of each region to hold the region's list of free blocks
+and its statistics. */
+typedef struct A_HEAP_REGION
+{
+	BlockLink_t xStart;						/*<< Marks the start of the list of free blocks in the region. */
+	BlockLink_t *pxEnd;						/*<< Marks the end of the list of free blocks in the region, and the end of the region. */
+	struct A_HEAP_REGION *pxNextRegion;		/*<< The next region to search when allocating memory. */
+	uint32_t ulCapabilities;				/*<< The portHEAP_CAPABILITY_... bits of the region. */
+	BaseType_t xRegionNumber;				/*<< The index of the region in the array passed to vPortDefineHeapRegions(). */
+	size_t xFreeBytesRemaining;
+	size_t xMinimumEverFreeBytesRemaining;
+	size_t xNumberOfSuccessfulAllocations;
+	size_t xNumberOfSuccessfulFrees;
+} HeapRegionControl_t;
+
 /*-----------------------------------------------------------*/
 
 /*
  * Inserts a block of memory that is being freed into the correct position in
- * the list of free memory blocks.  The block being freed will be merged with
- * the block in front it and/or the block behind it if the memory blocks are
- * adjacent to each other.
+ * the list of free memory blocks of its region.  The block being freed will be
+ * merged with the block in front it and/or the block behind it if the memory
+ * blocks are adjacent to each other.
+ */
+static void prvInsertBlockIntoFreeList( HeapRegionControl_t *pxRegion, BlockLink_t *pxBlockToInsert );
+
+/*
+ * Allocates a block of xWantedSize bytes, which already includes the
+ * BlockLink_t structure, from the first region that has all the capabilities
+ * in ulCapabilities and a large enough free block.
  */
-static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert );
+static void *prvMalloc( size_t xWantedSize, uint32_t ulCapabilities );
+
+/*
+ * Returns the region that contains pv, or NULL if pv is not within the heap.
+ */
+static HeapRegionControl_t *prvGetRegion( const void *pv );
+
+/*
+ * Adds the number and sizes of the free blocks in a region to the values
+ * pointed to by the parameters.
+ */
+static void prvGetFreeBlockStats( const HeapRegionControl_t *pxRegion, size_t *pxBlocks, size_t *pxMaxSize, size_t *pxMinSize );
 
 /*-----------------------------------------------------------*/
 
@@ -113,11 +173,17 @@ static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert );
 block must by correctly byte aligned. */
 static const size_t xHeapStructSize	= ( sizeof( BlockLink_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
 
-/* Create a couple of list links to mark the start and end of the list. */
-static BlockLink_t xStart, *pxEnd = NULL;
+/* The size of the structure placed at the beginning of each region, rounded up
+so the first block in the region is correctly byte aligned. */
+static const size_t xRegionStructSize = ( sizeof( HeapRegionControl_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* The regions, in the order in which they are searched.  NULL until
+vPortDefineHeapRegions() has been called. */
+static HeapRegionControl_t *pxFirstRegion = NULL;
 
 /* Keeps track of the number of calls to allocate and free memory as well as the
-number of free bytes remaining, but says nothing about fragmentation. */
+number of free bytes remaining, but says nothing about fragmentation.  These
+are totals for all the regions. */
 static size_t xFreeBytesRemaining = 0U;
 static size_t xMinimumEverFreeBytesRemaining = 0U;
 static size_t xNumberOfSuccessfulAllocations = 0;
@@ -133,12 +199,29 @@ static size_t xBlockAllocatedBit = 0;
 
 void *pvPortMalloc( size_t xWantedSize )
 {
+	return prvMalloc( xWantedSize, 0UL );
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_HEAP_REGION_CAPABILITIES == 1 )
+
+	void *pvPortMallocCaps( size_t xWantedSize, uint32_t ulCapabilities )
+	{
+		return prvMalloc( xWantedSize, ulCapabilities );
+	}
+
+#endif /* configUSE_HEAP_REGION_CAPABILITIES */
+/*-----------------------------------------------------------*/
+
+static void *prvMalloc( size_t xWantedSize, uint32_t ulCapabilities )
+{
+HeapRegionControl_t *pxRegion;
 BlockLink_t *pxBlock, *pxPreviousBlock, *pxNewBlockLink;
 void *pvReturn = NULL;
 
 	/* The heap must be initialised before the first call to
 	prvPortMalloc(). */
-	configASSERT( pxEnd );
+	configASSERT( pxFirstRegion );
 
 	vTaskSuspendAll();
 	{
@@ -171,79 +254,95 @@ void *pvReturn = NULL;
 				mtCOVERAGE_TEST_MARKER();
 			}
 
-			if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
+			for( pxRegion = pxFirstRegion; ( pxRegion != NULL ) && ( pvReturn == NULL ); pxRegion = pxRegion->pxNextRegion )
 			{
-				/* Traverse the list from the start	(lowest address) block until
-				one	of adequate size is found. */
-				pxPreviousBlock = &xStart;
-				pxBlock = xStart.pxNextFreeBlock;
-				while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != NULL ) )
+				/* Only search regions that have all the requested capabilities, and
+				enough free space. */
+				if( ( ( pxRegion->ulCapabilities & ulCapabilities ) == ulCapabilities ) && ( xWantedSize > 0 ) && ( xWantedSize <= pxRegion->xFreeBytesRemaining ) )
 				{
-					pxPreviousBlock = pxBlock;
-					pxBlock = pxBlock->pxNextFreeBlock;
-				}
-
-				/* If the end marker was reached then a block of adequate size
-				was	not found. */
-				if( pxBlock != pxEnd )
-				{
-					/* Return the memory space pointed to - jumping over the
-					BlockLink_t structure at its start. */
-					pvReturn = ( void * ) ( ( ( uint8_t * ) pxPreviousBlock->pxNextFreeBlock ) + xHeapStructSize );
-
-					/* This block is being returned for use so must be taken out
-					of the list of free blocks. */
-					pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
-
-					/* If the block is larger than required it can be split into
-					two. */
-					if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
+					/* Traverse the list from the start	(lowest address) block until
+					one	of adequate size is found. */
+					pxPreviousBlock = &( pxRegion->xStart );
+					pxBlock = pxRegion->xStart.pxNextFreeBlock;
+					while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != NULL ) )
 					{
-						/* This block is to be split into two.  Create a new
-						block following the number of bytes requested. The void
-						cast is used to prevent byte alignment warnings from the
-						compiler. */
-						pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
-
-						/* Calculate the sizes of two blocks split from the
-						single block. */
-						pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
-						pxBlock->xBlockSize = xWantedSize;
-
-						/* Insert the new block into the list of free blocks. */
-						prvInsertBlockIntoFreeList( ( pxNewBlockLink ) );
+						pxPreviousBlock = pxBlock;
+						pxBlock = pxBlock->pxNextFreeBlock;
 					}
-					else
-					{
-						mtCOVERAGE_TEST_MARKER();
-					}
-
-					xFreeBytesRemaining -= pxBlock->xBlockSize;
 
-					if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+					/* If the end marker was reached then a block of adequate size
+					was	not found. */
+					if( pxBlock != pxRegion->pxEnd )
 					{
-						xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+						/* Return the memory space pointed to - jumping over the
+						BlockLink_t structure at its start. */
+						pvReturn = ( void * ) ( ( ( uint8_t * ) pxPreviousBlock->pxNextFreeBlock ) + xHeapStructSize );
+
+						/* This block is being returned for use so must be taken out
+						of the list of free blocks. */
+						pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+
+						/* If the block is larger than required it can be split into
+						two. */
+						if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
+						{
+							/* This block is to be split into two.  Create a new
+							block following the number of bytes requested. The void
+							cast is used to prevent byte alignment warnings from the
+							compiler. */
+							pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+
+							/* Calculate the sizes of two blocks split from the
+							single block. */
+							pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+							pxBlock->xBlockSize = xWantedSize;
+
+							/* Insert the new block into the list of free blocks. */
+							prvInsertBlockIntoFreeList( pxRegion, ( pxNewBlockLink ) );
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+
+						xFreeBytesRemaining -= pxBlock->xBlockSize;
+						pxRegion->xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+						if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+						{
+							xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+
+						if( pxRegion->xFreeBytesRemaining < pxRegion->xMinimumEverFreeBytesRemaining )
+						{
+							pxRegion->xMinimumEverFreeBytesRemaining = pxRegion->xFreeBytesRemaining;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+
+						/* The block is being returned - it is allocated and owned
+						by the application and has no "next" block. */
+						pxBlock->xBlockSize |= xBlockAllocatedBit;
+						pxBlock->pxNextFreeBlock = NULL;
+						xNumberOfSuccessfulAllocations++;
+						pxRegion->xNumberOfSuccessfulAllocations++;
 					}
 					else
 					{
 						mtCOVERAGE_TEST_MARKER();
 					}
-
-					/* The block is being returned - it is allocated and owned
-					by the application and has no "next" block. */
-					pxBlock->xBlockSize |= xBlockAllocatedBit;
-					pxBlock->pxNextFreeBlock = NULL;
-					xNumberOfSuccessfulAllocations++;
 				}
 				else
 				{
 					mtCOVERAGE_TEST_MARKER();
 				}
 			}
-			else
-			{
-				mtCOVERAGE_TEST_MARKER();
-			}
 		}
 		else
 		{
@@ -276,6 +375,7 @@ void vPortFree( void *pv )
 {
 uint8_t *puc = ( uint8_t * ) pv;
 BlockLink_t *pxLink;
+HeapRegionControl_t *pxRegion;
 
 	if( pv != NULL )
 	{
@@ -290,9 +390,13 @@ BlockLink_t *pxLink;
 		configASSERT( ( pxLink->xBlockSize & xBlockAllocatedBit ) != 0 );
 		configASSERT( pxLink->pxNextFreeBlock == NULL );
 
+		/* The block is returned to the region it was allocated from. */
+		pxRegion = prvGetRegion( pv );
+		configASSERT( pxRegion );
+
 		if( ( pxLink->xBlockSize & xBlockAllocatedBit ) != 0 )
 		{
-			if( pxLink->pxNextFreeBlock == NULL )
+			if( ( pxLink->pxNextFreeBlock == NULL ) && ( pxRegion != NULL ) )
 			{
 				/* The block is being returned to the heap - it is no longer
 				allocated. */
@@ -302,9 +406,11 @@ BlockLink_t *pxLink;
 				{
 					/* Add this block to the list of free blocks. */
 					xFreeBytesRemaining += pxLink->xBlockSize;
+					pxRegion->xFreeBytesRemaining += pxLink->xBlockSize;
 					traceFREE( pv, pxLink->xBlockSize );
-					prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
+					prvInsertBlockIntoFreeList( pxRegion, ( ( BlockLink_t * ) pxLink ) );
 					xNumberOfSuccessfulFrees++;
+					pxRegion->xNumberOfSuccessfulFrees++;
 				}
 				( void ) xTaskResumeAll();
 			}
@@ -333,14 +439,34 @@ size_t xPortGetMinimumEverFreeHeapSize( void )
 }
 /*-----------------------------------------------------------*/
 
-static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert )
+static HeapRegionControl_t *prvGetRegion( const void *pv )
+{
+HeapRegionControl_t *pxRegion;
+
+	/* Blocks are only ever allocated between the region structure at the start
+	of a region and the end marker at the end of the region.  The regions do
+	not change once defined, so the scheduler does not need to be
+	suspended. */
+	for( pxRegion = pxFirstRegion; pxRegion != NULL; pxRegion = pxRegion->pxNextRegion )
+	{
+		if( ( ( const uint8_t * ) pv > ( const uint8_t * ) pxRegion ) && ( ( const uint8_t * ) pv < ( const uint8_t * ) pxRegion->pxEnd ) )
+		{
+			break;
+		}
+	}
+
+	return pxRegion;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertBlockIntoFreeList( HeapRegionControl_t *pxRegion, BlockLink_t *pxBlockToInsert )
 {
 BlockLink_t *pxIterator;
 uint8_t *puc;
 
 	/* Iterate through the list until a block is found that has a higher address
 	than the block being inserted. */
-	for( pxIterator = &xStart; pxIterator->pxNextFreeBlock < pxBlockToInsert; pxIterator = pxIterator->pxNextFreeBlock )
+	for( pxIterator = &( pxRegion->xStart ); pxIterator->pxNextFreeBlock < pxBlockToInsert; pxIterator = pxIterator->pxNextFreeBlock )
 	{
 		/* Nothing to do here, just iterate to the right position. */
 	}
@@ -363,7 +489,7 @@ uint8_t *puc;
 	puc = ( uint8_t * ) pxBlockToInsert;
 	if( ( puc + pxBlockToInsert->xBlockSize ) == ( uint8_t * ) pxIterator->pxNextFreeBlock )
 	{
-		if( pxIterator->pxNextFreeBlock != pxEnd )
+		if( pxIterator->pxNextFreeBlock != pxRegion->pxEnd )
 		{
 			/* Form one big block from the two blocks. */
 			pxBlockToInsert->xBlockSize += pxIterator->pxNextFreeBlock->xBlockSize;
@@ -371,7 +497,7 @@ uint8_t *puc;
 		}
 		else
 		{
-			pxBlockToInsert->pxNextFreeBlock = pxEnd;
+			pxBlockToInsert->pxNextFreeBlock = pxRegion->pxEnd;
 		}
 	}
 	else
@@ -396,15 +522,17 @@ uint8_t *puc;
 
 void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions )
 {
-BlockLink_t *pxFirstFreeBlockInRegion = NULL, *pxPreviousFreeBlock;
+HeapRegionControl_t *pxRegion, **ppxInsertPosition;
+BlockLink_t *pxFirstFreeBlockInRegion = NULL, *pxPreviousEnd = NULL;
 size_t xAlignedHeap;
 size_t xTotalRegionSize, xTotalHeapSize = 0;
 BaseType_t xDefinedRegions = 0;
 size_t xAddress;
 const HeapRegion_t *pxHeapRegion;
+uint32_t ulCapabilities, ulBits, ulOtherBits;
 
 	/* Can only call once! */
-	configASSERT( pxEnd == NULL );
+	configASSERT( pxFirstRegion == NULL );
 
 	pxHeapRegion = &( pxHeapRegions[ xDefinedRegions ] );
 
@@ -423,53 +551,81 @@ const HeapRegion_t *pxHeapRegion;
 			xTotalRegionSize -= xAddress - ( size_t ) pxHeapRegion->pucStartAddress;
 		}
 
-		xAlignedHeap = xAddress;
+		/* The region must be large enough to hold the region structure, the
+		end marker and at least one block. */
+		configASSERT( xTotalRegionSize > ( xRegionStructSize + xHeapStructSize + heapMINIMUM_BLOCK_SIZE ) );
+
+		/* Check blocks are passed in with increasing start addresses. */
+		configASSERT( ( pxPreviousEnd == NULL ) || ( xAddress > ( size_t ) pxPreviousEnd ) );
 
-		/* Set xStart if it has not already been set. */
-		if( xDefinedRegions == 0 )
+		/* The region structure is placed at the start of the region, and the
+		free space follows it. */
+		pxRegion = ( HeapRegionControl_t * ) xAddress;
+		xAlignedHeap = xAddress + xRegionStructSize;
+
+		#if( configUSE_HEAP_REGION_CAPABILITIES == 1 )
 		{
-			/* xStart is used to hold a pointer to the first item in the list of
-			free blocks.  The void cast is used to prevent compiler warnings. */
-			xStart.pxNextFreeBlock = ( BlockLink_t * ) xAlignedHeap;
-			xStart.xBlockSize = ( size_t ) 0;
+			ulCapabilities = pxHeapRegion->ulCapabilities;
 		}
-		else
+		#else
 		{
-			/* Should only get here if one region has already been added to the
-			heap. */
-			configASSERT( pxEnd != NULL );
-
-			/* Check blocks are passed in with increasing start addresses. */
-			configASSERT( xAddress > ( size_t ) pxEnd );
+			ulCapabilities = 0UL;
 		}
-
-		/* Remember the location of the end marker in the previous region, if
-		any. */
-		pxPreviousFreeBlock = pxEnd;
+		#endif
 
 		/* pxEnd is used to mark the end of the list of free blocks and is
 		inserted at the end of the region space. */
-		xAddress = xAlignedHeap + xTotalRegionSize;
+		xAddress += xTotalRegionSize;
 		xAddress -= xHeapStructSize;
 		xAddress &= ~portBYTE_ALIGNMENT_MASK;
-		pxEnd = ( BlockLink_t * ) xAddress;
-		pxEnd->xBlockSize = 0;
-		pxEnd->pxNextFreeBlock = NULL;
+		pxRegion->pxEnd = ( BlockLink_t * ) xAddress;
+		pxRegion->pxEnd->xBlockSize = 0;
+		pxRegion->pxEnd->pxNextFreeBlock = NULL;
+		pxPreviousEnd = pxRegion->pxEnd;
 
 		/* To start with there is a single free block in this region that is
 		sized to take up the entire heap region minus the space taken by the
-		free block structure. */
+		region structure and the end marker. */
 		pxFirstFreeBlockInRegion = ( BlockLink_t * ) xAlignedHeap;
 		pxFirstFreeBlockInRegion->xBlockSize = xAddress - ( size_t ) pxFirstFreeBlockInRegion;
-		pxFirstFreeBlockInRegion->pxNextFreeBlock = pxEnd;
+		pxFirstFreeBlockInRegion->pxNextFreeBlock = pxRegion->pxEnd;
+
+		/* xStart is used to hold a pointer to the first item in the list of
+		free blocks in the region. */
+		pxRegion->xStart.pxNextFreeBlock = pxFirstFreeBlockInRegion;
+		pxRegion->xStart.xBlockSize = ( size_t ) 0;
+		pxRegion->ulCapabilities = ulCapabilities;
+		pxRegion->xRegionNumber = xDefinedRegions;
+		pxRegion->xFreeBytesRemaining = pxFirstFreeBlockInRegion->xBlockSize;
+		pxRegion->xMinimumEverFreeBytesRemaining = pxFirstFreeBlockInRegion->xBlockSize;
+		pxRegion->xNumberOfSuccessfulAllocations = 0;
+		pxRegion->xNumberOfSuccessfulFrees = 0;
+
+		/* Regions are searched in order of the number of capabilities they
+		have, so memory that has capabilities is only used by allocations that
+		do not need them once the other memory has been used up.  Regions that
+		have the same number of capabilities are searched in address order. */
+		for( ulBits = 0; ulCapabilities != 0UL; ulCapabilities &= ( ulCapabilities - 1UL ) )
+		{
+			ulBits++;
+		}
 
-		/* If this is not the first region that makes up the entire heap space
-		then link the previous region to this region. */
-		if( pxPreviousFreeBlock != NULL )
+		for( ppxInsertPosition = &pxFirstRegion; *ppxInsertPosition != NULL; ppxInsertPosition = &( ( *ppxInsertPosition )->pxNextRegion ) )
 		{
-			pxPreviousFreeBlock->pxNextFreeBlock = pxFirstFreeBlockInRegion;
+			for( ulOtherBits = 0, ulCapabilities = ( *ppxInsertPosition )->ulCapabilities; ulCapabilities != 0UL; ulCapabilities &= ( ulCapabilities - 1UL ) )
+			{
+				ulOtherBits++;
+			}
+
+			if( ulOtherBits > ulBits )
+			{
+				break;
+			}
 		}
 
+		pxRegion->pxNextRegion = *ppxInsertPosition;
+		*ppxInsertPosition = pxRegion;
+
 		xTotalHeapSize += pxFirstFreeBlockInRegion->xBlockSize;
 
 		/* Move onto the next HeapRegion_t structure. */
@@ -488,45 +644,40 @@ const HeapRegion_t *pxHeapRegion;
 }
 /*-----------------------------------------------------------*/
 
-void vPortGetHeapStats( HeapStats_t *pxHeapStats )
+static void prvGetFreeBlockStats( const HeapRegionControl_t *pxRegion, size_t *pxBlocks, size_t *pxMaxSize, size_t *pxMinSize )
 {
-BlockLink_t *pxBlock;
-size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+const BlockLink_t *pxBlock;
 
-	vTaskSuspendAll();
+	for( pxBlock = pxRegion->xStart.pxNextFreeBlock; pxBlock != pxRegion->pxEnd; pxBlock = pxBlock->pxNextFreeBlock )
 	{
-		pxBlock = xStart.pxNextFreeBlock;
+		/* Increment the number of blocks and record the largest and smallest
+		blocks seen so far. */
+		( *pxBlocks )++;
 
-		/* pxBlock will be NULL if the heap has not been initialised.  The heap
-		is initialised automatically when the first allocation is made. */
-		if( pxBlock != NULL )
+		if( pxBlock->xBlockSize > *pxMaxSize )
 		{
-			do
-			{
-				/* Increment the number of blocks and record the largest block seen
-				so far. */
-				xBlocks++;
+			*pxMaxSize = pxBlock->xBlockSize;
+		}
 
-				if( pxBlock->xBlockSize > xMaxSize )
-				{
-					xMaxSize = pxBlock->xBlockSize;
-				}
+		if( pxBlock->xBlockSize < *pxMinSize )
+		{
+			*pxMinSize = pxBlock->xBlockSize;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
 
-				/* Heap five will have a zero sized block at the end of each
-				each region - the block is only used to link to the next
-				heap region so it not a real block. */
-				if( pxBlock->xBlockSize != 0 )
-				{
-					if( pxBlock->xBlockSize < xMinSize )
-					{
-						xMinSize = pxBlock->xBlockSize;
-					}
-				}
+void vPortGetHeapStats( HeapStats_t *pxHeapStats )
+{
+HeapRegionControl_t *pxRegion;
+size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
 
-				/* Move to the next block in the chain until the last block is
-				reached. */
-				pxBlock = pxBlock->pxNextFreeBlock;
-			} while( pxBlock != pxEnd );
+	vTaskSuspendAll();
+	{
+		/* There are no regions if the heap has not been initialised. */
+		for( pxRegion = pxFirstRegion; pxRegion != NULL; pxRegion = pxRegion->pxNextRegion )
+		{
+			prvGetFreeBlockStats( pxRegion, &xBlocks, &xMaxSize, &xMinSize );
 		}
 	}
 	xTaskResumeAll();
@@ -544,4 +695,42 @@ size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY use
 	}
 	taskEXIT_CRITICAL();
 }
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortGetHeapRegionStats( BaseType_t xRegion, HeapStats_t *pxHeapStats )
+{
+HeapRegionControl_t *pxRegion;
+size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+BaseType_t xReturn = pdFAIL;
+
+	vTaskSuspendAll();
+	{
+		for( pxRegion = pxFirstRegion; pxRegion != NULL; pxRegion = pxRegion->pxNextRegion )
+		{
+			if( pxRegion->xRegionNumber == xRegion )
+			{
+				prvGetFreeBlockStats( pxRegion, &xBlocks, &xMaxSize, &xMinSize );
+
+				pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+				pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+				pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+				taskENTER_CRITICAL();
+				{
+					pxHeapStats->xAvailableHeapSpaceInBytes = pxRegion->xFreeBytesRemaining;
+					pxHeapStats->xNumberOfSuccessfulAllocations = pxRegion->xNumberOfSuccessfulAllocations;
+					pxHeapStats->xNumberOfSuccessfulFrees = pxRegion->xNumberOfSuccessfulFrees;
+					pxHeapStats->xMinimumEverFreeBytesRemaining = pxRegion->xMinimumEverFreeBytesRemaining;
+				}
+				taskEXIT_CRITICAL();
+
+				xReturn = pdPASS;
+				break;
+			}
+		}
+	}
+	xTaskResumeAll();
+
+	return xReturn;
+}
 
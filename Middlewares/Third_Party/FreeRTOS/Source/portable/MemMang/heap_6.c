@@ -0,0 +1,745 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A sample implementation of pvPortMalloc() and vPortFree() that, like
+ * heap_4.c, combines adjacent memory blocks as they are freed, but that takes
+ * a constant time to allocate and free memory however fragmented the heap
+ * becomes.  It is intended for systems that allocate and free memory for long
+ * periods, where the time taken by heap_4.c to search its address ordered free
+ * list grows with the number of free blocks.
+ *
+ * Free blocks are held in segregated lists using the two level scheme of the
+ * TLSF (Two Level Segregated Fit) allocator.  The first level divides block
+ * sizes into powers of two, and the second level divides each power of two
+ * into heapSL_INDEX_COUNT equal ranges.  A bitmap for each level records which
+ * lists are not empty, so a list holding a block at least as large as the
+ * requested size is found using two find-first-set operations, without a
+ * search.  Each block also records the block immediately before it in memory
+ * (a boundary tag), so a block being freed is merged with its neighbours
+ * without a search.
+ *
+ * The lists are searched from the size class above that of the requested size,
+ * so any block found can be used.  The cost is that a block that is only
+ * slightly larger than the requested size might be missed, so heap_6.c can
+ * fail an allocation that heap_4.c would satisfy when the heap is almost full.
+ *
+ * See heap_1.c, heap_2.c, heap_3.c, heap_4.c and heap_5.c for alternative
+ * implementations, and the memory management pages of http://www.FreeRTOS.org
+ * for more information.
+ */
+#include <stdlib.h>
+#include <stddef.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+#if( configUSE_HEAP_TASK_CACHE == 1 )
+	#error configUSE_HEAP_TASK_CACHE is only supported by heap_4.c
+#endif
+
+/* Assumes 8bit bytes! */
+#define heapBITS_PER_BYTE		( ( size_t ) 8 )
+
+/* Evaluates to the index of the most significant set bit of a 32-bit
+constant, so can be used to size arrays. */
+#define heapLOG2_2( x )			( ( ( ( x ) & 0x2UL ) != 0UL ) ? 1 : 0 )
+#define heapLOG2_4( x )			( ( ( ( x ) & 0xCUL ) != 0UL ) ? ( 2 + heapLOG2_2( ( x ) >> 2 ) ) : heapLOG2_2( x ) )
+#define heapLOG2_8( x )			( ( ( ( x ) & 0xF0UL ) != 0UL ) ? ( 4 + heapLOG2_4( ( x ) >> 4 ) ) : heapLOG2_4( x ) )
+#define heapLOG2_16( x )		( ( ( ( x ) & 0xFF00UL ) != 0UL ) ? ( 8 + heapLOG2_8( ( x ) >> 8 ) ) : heapLOG2_8( x ) )
+#define heapLOG2( x )			( ( ( ( x ) & 0xFFFF0000UL ) != 0UL ) ? ( 16 + heapLOG2_16( ( x ) >> 16 ) ) : heapLOG2_16( x ) )
+
+/* Each power of two is divided into 2 ^ heapSL_INDEX_COUNT_LOG2 size classes.
+Blocks smaller than heapSMALL_BLOCK_SIZE are held in the first level 0 lists,
+with one list per multiple of portBYTE_ALIGNMENT. */
+#define heapSL_INDEX_COUNT_LOG2	( 4 )
+#define heapSL_INDEX_COUNT		( 1 << heapSL_INDEX_COUNT_LOG2 )
+#define heapALIGNMENT_LOG2		heapLOG2( portBYTE_ALIGNMENT )
+#define heapFL_INDEX_SHIFT		( heapSL_INDEX_COUNT_LOG2 + heapALIGNMENT_LOG2 )
+#define heapSMALL_BLOCK_SIZE	( ( size_t ) 1 << heapFL_INDEX_SHIFT )
+
+/* Enough first level lists to hold a block the size of the entire heap. */
+#define heapFL_INDEX_MAX		heapLOG2( ( uint32_t ) configTOTAL_HEAP_SIZE )
+#define heapFL_INDEX_COUNT		( ( heapFL_INDEX_MAX > heapFL_INDEX_SHIFT ) ? ( heapFL_INDEX_MAX - heapFL_INDEX_SHIFT + 1 ) : 1 )
+
+/* Allocate the memory for the heap. */
+#if( configAPPLICATION_ALLOCATED_HEAP == 1 )
+	/* The application writer has already defined the array used for the RTOS
+	heap - probably so it can be placed in a special segment or address. */
+	extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+	static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif /* configAPPLICATION_ALLOCATED_HEAP */
+
+/* The header placed at the start of every block.  The free list links are only
+used while the block is free, so are overwritten by the application's data
+while the block is allocated. */
+typedef struct A_BLOCK_HEADER
+{
+	struct A_BLOCK_HEADER *pxPreviousPhysicalBlock;	/*<< The block immediately before this block in memory, or NULL for the first block. */
+	size_t xBlockSize;								/*<< The size of the block, including the header. */
+	struct A_BLOCK_HEADER *pxNextFreeBlock;			/*<< The next block in the same free list.  Only valid while the block is free. */
+	struct A_BLOCK_HEADER *pxPreviousFreeBlock;		/*<< The previous block in the same free list.  Only valid while the block is free. */
+} BlockHeader_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the first and second level indexes of the list that holds free
+ * blocks of xBlockSize bytes.
+ */
+static void prvMappingInsert( size_t xBlockSize, UBaseType_t *puxFirstLevel, UBaseType_t *puxSecondLevel );
+
+/*
+ * Returns, without removing it, a free block of at least xWantedSize bytes, or
+ * NULL if there is no list that is guaranteed to hold a large enough block.
+ */
+static BlockHeader_t *prvFindSuitableBlock( size_t xWantedSize );
+
+/*
+ * Adds a free block to, or removes a free block from, the list for its size.
+ */
+static void prvInsertFreeBlock( BlockHeader_t *pxBlock );
+static void prvRemoveFreeBlock( BlockHeader_t *pxBlock );
+
+/*
+ * Returns the index of the most significant set bit in ulValue, which must not
+ * be zero.
+ */
+static UBaseType_t prvFindLastSet( uint32_t ulValue );
+
+/*
+ * Called automatically to setup the required heap structures the first time
+ * pvPortMalloc() is called.
+ */
+static void prvHeapInit( void );
+
+/*-----------------------------------------------------------*/
+
+/* The size of the part of the header that remains in front of each allocated
+block must be correctly byte aligned. */
+static const size_t xHeapStructSize	= ( offsetof( BlockHeader_t, pxNextFreeBlock ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* Block sizes must not get too small - a free block must be able to hold the
+complete header. */
+static const size_t xMinimumBlockSize = ( sizeof( BlockHeader_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* The free lists, and bitmaps recording which of the lists are not empty.  Bit
+n of uxFirstLevelBitmap is set if any bit of uxSecondLevelBitmap[ n ] is set,
+and bit m of uxSecondLevelBitmap[ n ] is set if pxFreeLists[ n ][ m ] is not
+NULL. */
+static BlockHeader_t *pxFreeLists[ heapFL_INDEX_COUNT ][ heapSL_INDEX_COUNT ];
+static uint32_t ulFirstLevelBitmap = 0;
+static uint32_t ulSecondLevelBitmap[ heapFL_INDEX_COUNT ];
+
+/* Marks the end of the heap.  Looks like an allocated block, so is never
+merged with the last real block. */
+static BlockHeader_t *pxEnd = NULL;
+
+/* Keeps track of the number of calls to allocate and free memory as well as the
+number of free bytes remaining, but says nothing about fragmentation. */
+static size_t xFreeBytesRemaining = 0U;
+static size_t xMinimumEverFreeBytesRemaining = 0U;
+static size_t xNumberOfSuccessfulAllocations = 0;
+static size_t xNumberOfSuccessfulFrees = 0;
+
+/* Gets set to the top bit of an size_t type.  When this bit in the xBlockSize
+member of an BlockHeader_t structure is set then the block belongs to the
+application.  When the bit is free the block is still part of the free heap
+space. */
+static size_t xBlockAllocatedBit = 0;
+
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+BlockHeader_t *pxBlock, *pxNewBlock, *pxNextBlock;
+void *pvReturn = NULL;
+
+	vTaskSuspendAll();
+	{
+		/* If this is the first call to malloc then the heap will require
+		initialisation to setup the free lists. */
+		if( pxEnd == NULL )
+		{
+			prvHeapInit();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* Check the requested block size is not so large that the top bit is
+		set.  The top bit of the block size member of the BlockHeader_t
+		structure is used to determine who owns the block - the application or
+		the kernel, so it must be free. */
+		if( ( xWantedSize & xBlockAllocatedBit ) == 0 )
+		{
+			/* The wanted size is increased so it can contain the header in
+			addition to the requested amount of bytes. */
+			if( xWantedSize > 0 )
+			{
+				xWantedSize += xHeapStructSize;
+
+				/* Ensure that blocks are always aligned to the required number
+				of bytes. */
+				if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+				{
+					/* Byte alignment required. */
+					xWantedSize += ( portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK ) );
+					configASSERT( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) == 0 );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* The block must be able to hold the free list links once it
+				is freed again. */
+				if( xWantedSize < xMinimumBlockSize )
+				{
+					xWantedSize = xMinimumBlockSize;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
+			{
+				pxBlock = prvFindSuitableBlock( xWantedSize );
+
+				if( pxBlock != NULL )
+				{
+					/* This block is being returned for use so must be taken out
+					of the free lists. */
+					prvRemoveFreeBlock( pxBlock );
+
+					/* If the block is larger than required it can be split into
+					two. */
+					if( ( pxBlock->xBlockSize - xWantedSize ) >= xMinimumBlockSize )
+					{
+						/* This block is to be split into two.  Create a new
+						block following the number of bytes requested. The void
+						cast is used to prevent byte alignment warnings from the
+						compiler. */
+						pxNewBlock = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+						configASSERT( ( ( ( size_t ) pxNewBlock ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+						/* Calculate the sizes of two blocks split from the
+						single block, and link the new block in to the chain of
+						blocks in memory order. */
+						pxNewBlock->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+						pxNewBlock->pxPreviousPhysicalBlock = pxBlock;
+						pxBlock->xBlockSize = xWantedSize;
+
+						pxNextBlock = ( void * ) ( ( ( uint8_t * ) pxNewBlock ) + pxNewBlock->xBlockSize );
+						pxNextBlock->pxPreviousPhysicalBlock = pxNewBlock;
+
+						/* The block after the new block cannot be free, as
+						free blocks are always merged, so the new block can be
+						added to the free lists as it is. */
+						prvInsertFreeBlock( pxNewBlock );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+					if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+					{
+						xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					/* The block is being returned - it is allocated and owned
+					by the application.  Return the memory space pointed to -
+					jumping over the header at its start. */
+					pxBlock->xBlockSize |= xBlockAllocatedBit;
+					pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+					xNumberOfSuccessfulAllocations++;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		traceMALLOC( pvReturn, xWantedSize );
+	}
+	( void ) xTaskResumeAll();
+
+	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+	{
+		if( pvReturn == NULL )
+		{
+			extern void vApplicationMallocFailedHook( void );
+			vApplicationMallocFailedHook();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
+	configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+uint8_t *puc = ( uint8_t * ) pv;
+BlockHeader_t *pxBlock, *pxNeighbour;
+
+	if( pv != NULL )
+	{
+		/* The memory being freed will have the header immediately before
+		it. */
+		puc -= xHeapStructSize;
+
+		/* This casting is to keep the compiler from issuing warnings. */
+		pxBlock = ( void * ) puc;
+
+		/* Check the block is actually allocated. */
+		configASSERT( ( pxBlock->xBlockSize & xBlockAllocatedBit ) != 0 );
+
+		if( ( pxBlock->xBlockSize & xBlockAllocatedBit ) != 0 )
+		{
+			vTaskSuspendAll();
+			{
+				/* The block is being returned to the heap - it is no longer
+				allocated. */
+				pxBlock->xBlockSize &= ~xBlockAllocatedBit;
+				xFreeBytesRemaining += pxBlock->xBlockSize;
+				traceFREE( pv, pxBlock->xBlockSize );
+
+				/* Merge with the block after this block if it is free. */
+				pxNeighbour = ( void * ) ( ( ( uint8_t * ) pxBlock ) + pxBlock->xBlockSize );
+
+				if( ( pxNeighbour->xBlockSize & xBlockAllocatedBit ) == 0 )
+				{
+					prvRemoveFreeBlock( pxNeighbour );
+					pxBlock->xBlockSize += pxNeighbour->xBlockSize;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Merge with the block before this block if it is free. */
+				pxNeighbour = pxBlock->pxPreviousPhysicalBlock;
+
+				if( ( pxNeighbour != NULL ) && ( ( pxNeighbour->xBlockSize & xBlockAllocatedBit ) == 0 ) )
+				{
+					prvRemoveFreeBlock( pxNeighbour );
+					pxNeighbour->xBlockSize += pxBlock->xBlockSize;
+					pxBlock = pxNeighbour;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* The block following the merged block must now point back to
+				it. */
+				pxNeighbour = ( void * ) ( ( ( uint8_t * ) pxBlock ) + pxBlock->xBlockSize );
+				pxNeighbour->pxPreviousPhysicalBlock = pxBlock;
+
+				prvInsertFreeBlock( pxBlock );
+				xNumberOfSuccessfulFrees++;
+			}
+			( void ) xTaskResumeAll();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+	return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+	return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+	/* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void )
+{
+BlockHeader_t *pxFirstFreeBlock;
+uint8_t *pucAlignedHeap;
+size_t uxAddress;
+size_t xTotalHeapSize = configTOTAL_HEAP_SIZE;
+
+	/* The first level bitmap has one bit per first level list. */
+	configASSERT( heapFL_INDEX_COUNT <= ( sizeof( ulFirstLevelBitmap ) * heapBITS_PER_BYTE ) );
+
+	/* Ensure the heap starts on a correctly aligned boundary. */
+	uxAddress = ( size_t ) ucHeap;
+
+	if( ( uxAddress & portBYTE_ALIGNMENT_MASK ) != 0 )
+	{
+		uxAddress += ( portBYTE_ALIGNMENT - 1 );
+		uxAddress &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+		xTotalHeapSize -= uxAddress - ( size_t ) ucHeap;
+	}
+
+	pucAlignedHeap = ( uint8_t * ) uxAddress;
+
+	/* Work out the position of the top bit in a size_t variable. */
+	xBlockAllocatedBit = ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 );
+
+	/* pxEnd is used to mark the end of the heap and is inserted at the end of
+	the heap space.  It is marked as allocated so the last free block is never
+	merged with it. */
+	uxAddress = ( ( size_t ) pucAlignedHeap ) + xTotalHeapSize;
+	uxAddress -= xHeapStructSize;
+	uxAddress &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+	pxEnd = ( void * ) uxAddress;
+
+	/* To start with there is a single free block that is sized to take up the
+	entire heap space, minus the space taken by pxEnd. */
+	pxFirstFreeBlock = ( void * ) pucAlignedHeap;
+	pxFirstFreeBlock->pxPreviousPhysicalBlock = NULL;
+	pxFirstFreeBlock->xBlockSize = uxAddress - ( size_t ) pxFirstFreeBlock;
+
+	pxEnd->pxPreviousPhysicalBlock = pxFirstFreeBlock;
+	pxEnd->xBlockSize = xBlockAllocatedBit;
+
+	prvInsertFreeBlock( pxFirstFreeBlock );
+
+	/* Only one block exists - and it covers the entire usable heap space. */
+	xMinimumEverFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
+	xFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvFindLastSet( uint32_t ulValue )
+{
+UBaseType_t uxBit;
+
+	#if defined( __GNUC__ )
+	{
+		uxBit = ( UBaseType_t ) 31 - ( UBaseType_t ) __builtin_clz( ulValue );
+	}
+	#else
+	{
+		/* Binary search, so the time taken does not depend on the value. */
+		uxBit = 0;
+
+		if( ( ulValue & 0xFFFF0000UL ) != 0UL )
+		{
+			ulValue >>= 16;
+			uxBit += 16;
+		}
+
+		if( ( ulValue & 0x0000FF00UL ) != 0UL )
+		{
+			ulValue >>= 8;
+			uxBit += 8;
+		}
+
+		if( ( ulValue & 0x000000F0UL ) != 0UL )
+		{
+			ulValue >>= 4;
+			uxBit += 4;
+		}
+
+		if( ( ulValue & 0x0000000CUL ) != 0UL )
+		{
+			ulValue >>= 2;
+			uxBit += 2;
+		}
+
+		if( ( ulValue & 0x00000002UL ) != 0UL )
+		{
+			uxBit += 1;
+		}
+	}
+	#endif
+
+	return uxBit;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMappingInsert( size_t xBlockSize, UBaseType_t *puxFirstLevel, UBaseType_t *puxSecondLevel )
+{
+UBaseType_t uxFirstLevel;
+
+	if( xBlockSize < heapSMALL_BLOCK_SIZE )
+	{
+		/* Small blocks are held in first level 0, with one second level list
+		per multiple of the alignment. */
+		*puxFirstLevel = 0;
+		*puxSecondLevel = ( UBaseType_t ) ( xBlockSize >> heapALIGNMENT_LOG2 );
+	}
+	else
+	{
+		/* The second level index is given by the heapSL_INDEX_COUNT_LOG2 bits
+		below the most significant set bit. */
+		uxFirstLevel = prvFindLastSet( ( uint32_t ) xBlockSize );
+		*puxSecondLevel = ( UBaseType_t ) ( xBlockSize >> ( uxFirstLevel - heapSL_INDEX_COUNT_LOG2 ) ) ^ ( UBaseType_t ) heapSL_INDEX_COUNT;
+		*puxFirstLevel = uxFirstLevel - ( heapFL_INDEX_SHIFT - 1 );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BlockHeader_t *prvFindSuitableBlock( size_t xWantedSize )
+{
+UBaseType_t uxFirstLevel, uxSecondLevel;
+uint32_t ulBitmap;
+BlockHeader_t *pxReturn = NULL;
+
+	/* Round the size up to the start of the next size class, so every block in
+	the list found is at least as large as the wanted size.  Sizes in first
+	level 0 are exact so do not need rounding. */
+	if( xWantedSize >= heapSMALL_BLOCK_SIZE )
+	{
+		xWantedSize += ( ( size_t ) 1 << ( prvFindLastSet( ( uint32_t ) xWantedSize ) - heapSL_INDEX_COUNT_LOG2 ) ) - ( size_t ) 1;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	prvMappingInsert( xWantedSize, &uxFirstLevel, &uxSecondLevel );
+
+	if( uxFirstLevel < ( UBaseType_t ) heapFL_INDEX_COUNT )
+	{
+		/* First look for a non-empty list in the same first level list, at or
+		above the wanted second level. */
+		ulBitmap = ulSecondLevelBitmap[ uxFirstLevel ] & ( ~0UL << uxSecondLevel );
+
+		if( ulBitmap == 0UL )
+		{
+			/* There is not one, so use the smallest non-empty list in any
+			higher first level. */
+			ulBitmap = ( uxFirstLevel < 31U ) ? ( ulFirstLevelBitmap & ( ~0UL << ( uxFirstLevel + 1U ) ) ) : 0UL;
+
+			if( ulBitmap != 0UL )
+			{
+				uxFirstLevel = prvFindLastSet( ulBitmap & ( ~ulBitmap + 1UL ) );
+				ulBitmap = ulSecondLevelBitmap[ uxFirstLevel ];
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( ulBitmap != 0UL )
+		{
+			/* Isolate the least significant set bit to find the smallest
+			suitable list. */
+			uxSecondLevel = prvFindLastSet( ulBitmap & ( ~ulBitmap + 1UL ) );
+			pxReturn = pxFreeLists[ uxFirstLevel ][ uxSecondLevel ];
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		/* Larger than any block the heap can hold. */
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertFreeBlock( BlockHeader_t *pxBlock )
+{
+UBaseType_t uxFirstLevel, uxSecondLevel;
+
+	prvMappingInsert( pxBlock->xBlockSize, &uxFirstLevel, &uxSecondLevel );
+
+	/* Add the block to the front of its list. */
+	pxBlock->pxPreviousFreeBlock = NULL;
+	pxBlock->pxNextFreeBlock = pxFreeLists[ uxFirstLevel ][ uxSecondLevel ];
+
+	if( pxBlock->pxNextFreeBlock != NULL )
+	{
+		pxBlock->pxNextFreeBlock->pxPreviousFreeBlock = pxBlock;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] = pxBlock;
+	ulFirstLevelBitmap |= ( 1UL << uxFirstLevel );
+	ulSecondLevelBitmap[ uxFirstLevel ] |= ( 1UL << uxSecondLevel );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveFreeBlock( BlockHeader_t *pxBlock )
+{
+UBaseType_t uxFirstLevel, uxSecondLevel;
+
+	prvMappingInsert( pxBlock->xBlockSize, &uxFirstLevel, &uxSecondLevel );
+
+	if( pxBlock->pxNextFreeBlock != NULL )
+	{
+		pxBlock->pxNextFreeBlock->pxPreviousFreeBlock = pxBlock->pxPreviousFreeBlock;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( pxBlock->pxPreviousFreeBlock != NULL )
+	{
+		pxBlock->pxPreviousFreeBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+	}
+	else
+	{
+		/* The block was at the front of its list. */
+		configASSERT( pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] == pxBlock );
+		pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] = pxBlock->pxNextFreeBlock;
+
+		if( pxBlock->pxNextFreeBlock == NULL )
+		{
+			/* The list is now empty. */
+			ulSecondLevelBitmap[ uxFirstLevel ] &= ~( 1UL << uxSecondLevel );
+
+			if( ulSecondLevelBitmap[ uxFirstLevel ] == 0UL )
+			{
+				ulFirstLevelBitmap &= ~( 1UL << uxFirstLevel );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t *pxHeapStats )
+{
+BlockHeader_t *pxBlock;
+UBaseType_t uxFirstLevel, uxSecondLevel;
+size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+
+	vTaskSuspendAll();
+	{
+		/* Unlike allocating and freeing memory, gathering the statistics
+		requires every free block to be visited.  The lists will be empty if
+		the heap has not been initialised.  The heap is initialised
+		automatically when the first allocation is made. */
+		for( uxFirstLevel = 0; uxFirstLevel < ( UBaseType_t ) heapFL_INDEX_COUNT; uxFirstLevel++ )
+		{
+			for( uxSecondLevel = 0; uxSecondLevel < ( UBaseType_t ) heapSL_INDEX_COUNT; uxSecondLevel++ )
+			{
+				for( pxBlock = pxFreeLists[ uxFirstLevel ][ uxSecondLevel ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
+				{
+					/* Increment the number of blocks and record the largest
+					and smallest blocks seen so far. */
+					xBlocks++;
+
+					if( pxBlock->xBlockSize > xMaxSize )
+					{
+						xMaxSize = pxBlock->xBlockSize;
+					}
+
+					if( pxBlock->xBlockSize < xMinSize )
+					{
+						xMinSize = pxBlock->xBlockSize;
+					}
+				}
+			}
+		}
+	}
+	xTaskResumeAll();
+
+	pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+	pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+	pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+	taskENTER_CRITICAL();
+	{
+		pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+		pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+		pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+		pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+	}
+	taskEXIT_CRITICAL();
+}
@@ -51,6 +51,7 @@ correct privileged Vs unprivileged linkage and placement. */
 /* Constants used with the cRxLock and cTxLock structure members. */
 #define queueUNLOCKED					( ( int8_t ) -1 )
 #define queueLOCKED_UNMODIFIED			( ( int8_t ) 0 )
+#define queueLOCK_COUNT_MAX				( ( int8_t ) 127 )
 
 /* When the Queue_t structure is used to represent a base queue its pcHead and
 pcTail members are used as pointers into the queue storage area.  When the
@@ -89,6 +90,15 @@ zero. */
 	#define queueYIELD_IF_USING_PREEMPTION() portYIELD_WITHIN_API()
 #endif
 
+/* Allocates a dynamically created queue, from a heap_5.c region with the
+capabilities set by configQUEUE_STORAGE_HEAP_CAPABILITIES if
+configUSE_HEAP_REGION_CAPABILITIES is set to 1. */
+#if( configUSE_HEAP_REGION_CAPABILITIES == 1 )
+	#define queueMALLOC_STORAGE( xSize )	pvPortMallocCaps( ( xSize ), ( uint32_t ) configQUEUE_STORAGE_HEAP_CAPABILITIES )
+#else
+	#define queueMALLOC_STORAGE( xSize )	pvPortMalloc( xSize )
+#endif
+
 /*
  * Definition of the queue used by the scheduler.
  * Items are queued by copy, not reference.  See the following link for the
@@ -123,6 +133,11 @@ typedef struct QueueDefinition 		/* The old naming convention is used to prevent
 		struct QueueDefinition *pxQueueSetContainer;
 	#endif
 
+	#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+		struct QueueWaitSetDefinition *pxWaitSet;	/*< The wait set the queue is a member of, or NULL. */
+		uint32_t ulWaitSetBit;						/*< The bit that represents the queue in the ready bitmap of pxWaitSet. */
+	#endif
+
 	#if ( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxQueueNumber;
 		uint8_t ucQueueType;
@@ -136,6 +151,29 @@ typedef xQUEUE Queue_t;
 
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+
+	/*
+	 * Definition of a queue wait set.  The ready bitmap has one bit for each
+	 * member, set while the member holds an item and cleared when the member
+	 * is emptied, so a send to a member never has to copy anything into the
+	 * wait set.
+	 */
+	typedef struct QueueWaitSetDefinition
+	{
+		volatile uint32_t ulReadyBits;		/*< The bits of the members that hold an item or can be taken. */
+		uint32_t ulMemberBits;				/*< The bits given to members of the wait set. */
+		TaskHandle_t xWaitingTask;			/*< The task blocked in ulQueueWaitForAny(), or NULL if no task is blocked. */
+		UBaseType_t uxIndexToNotify;		/*< The task notification index used to unblock the waiting task. */
+
+		#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+			uint8_t ucStaticallyAllocated;	/*< Set to pdTRUE if the wait set was statically allocated to ensure no attempt is made to free the memory. */
+		#endif
+	} QueueWaitSet_t;
+
+#endif /* configUSE_QUEUE_WAIT_SETS */
+/*-----------------------------------------------------------*/
+
 /*
  * The queue registry is just a means for kernel aware debuggers to locate
  * queue structures.  It has no other purpose so is an optional component.
@@ -198,6 +236,45 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue, const void *pvIte
  */
 static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer ) PRIVILEGED_FUNCTION;
 
+/*
+ * Copies uxItemCount items into the back of the queue using at most two
+ * memcpy() calls.  The queue must have space for the items.
+ */
+static void prvCopyMultipleToQueue( Queue_t * const pxQueue, const int8_t *pcItems, const UBaseType_t uxItemCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Copies uxItemCount items out of the queue using at most two memcpy() calls.
+ * The queue must hold at least that many items.
+ */
+static void prvCopyMultipleFromQueue( Queue_t * const pxQueue, int8_t *pcBuffer, const UBaseType_t uxItemCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock one task waiting to receive from the queue for each of the
+ * uxItemsAdded items just added to the queue, or notify the queue set the
+ * queue is a member of once for each item.  Must be called from a critical
+ * section with the queue unlocked.
+ *
+ * @return pdTRUE if a task with a priority above the calling task was
+ * unblocked, otherwise pdFALSE.
+ */
+static BaseType_t prvUnblockTasksWaitingToReceive( Queue_t * const pxQueue, UBaseType_t uxItemsAdded ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock one task waiting to send to the queue for each of the
+ * uxItemsRemoved items just removed from the queue.  Must be called from a
+ * critical section with the queue unlocked.
+ *
+ * @return pdTRUE if a task with a priority above the calling task was
+ * unblocked, otherwise pdFALSE.
+ */
+static BaseType_t prvUnblockTasksWaitingToSend( Queue_t * const pxQueue, UBaseType_t uxItemsRemoved ) PRIVILEGED_FUNCTION;
+
+/*
+ * Add uxCount to a queue lock count, saturating rather than overflowing the
+ * int8_t the count is held in.
+ */
+static int8_t prvAddToLockCount( const int8_t cLockCount, const UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+
 #if ( configUSE_QUEUE_SETS == 1 )
 	/*
 	 * Checks to see if a queue is a member of a queue set, and if so, notifies
@@ -206,6 +283,23 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer
 	static BaseType_t prvNotifyQueueSetContainer( const Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
 #endif
 
+#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+	/*
+	 * Sets the bit of a queue that is a member of a wait set after an item was
+	 * added to the queue, and unblocks the task waiting on the wait set if no
+	 * other member was ready.  Must be called from a critical section, or with
+	 * interrupts masked if xFromISR is pdTRUE.
+	 */
+	static void prvSetWaitSetReadyBit( const Queue_t * const pxQueue, const BaseType_t xFromISR, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Clears the bit of a queue that is a member of a wait set if the queue is
+	 * empty.  Must be called from a critical section, or with interrupts
+	 * masked.
+	 */
+	static void prvClearWaitSetReadyBit( const Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Called after a Queue_t structure has been allocated either statically or
  * dynamically to fill in the structure's members.
@@ -289,6 +383,12 @@ Queue_t * const pxQueue = xQueue;
 			{
 				mtCOVERAGE_TEST_MARKER();
 			}
+
+			#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+			{
+				prvClearWaitSetReadyBit( pxQueue );
+			}
+			#endif /* configUSE_QUEUE_WAIT_SETS */
 		}
 		else
 		{
@@ -387,7 +487,7 @@ Queue_t * const pxQueue = xQueue;
 		are greater than or equal to the pointer to char requirements the cast
 		is safe.  In other cases alignment requirements are not strict (one or
 		two bytes). */
-		pxNewQueue = ( Queue_t * ) pvPortMalloc( sizeof( Queue_t ) + xQueueSizeInBytes ); /*lint !e9087 !e9079 see comment above. */
+		pxNewQueue = ( Queue_t * ) queueMALLOC_STORAGE( sizeof( Queue_t ) + xQueueSizeInBytes ); /*lint !e9087 !e9079 see comment above. */
 
 		if( pxNewQueue != NULL )
 		{
@@ -457,6 +557,13 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 	}
 	#endif /* configUSE_QUEUE_SETS */
 
+	#if( configUSE_QUEUE_WAIT_SETS == 1 )
+	{
+		pxNewQueue->pxWaitSet = NULL;
+		pxNewQueue->ulWaitSetBit = 0UL;
+	}
+	#endif /* configUSE_QUEUE_WAIT_SETS */
+
 	traceQUEUE_CREATE( pxNewQueue );
 }
 /*-----------------------------------------------------------*/
@@ -864,6 +971,12 @@ Queue_t * const pxQueue = xQueue;
 				}
 				#endif /* configUSE_QUEUE_SETS */
 
+				#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+				{
+					prvSetWaitSetReadyBit( pxQueue, pdFALSE, NULL );
+				}
+				#endif /* configUSE_QUEUE_WAIT_SETS */
+
 				taskEXIT_CRITICAL();
 				return pdPASS;
 			}
@@ -947,6 +1060,143 @@ Queue_t * const pxQueue = xQueue;
 }
 /*-----------------------------------------------------------*/
 
+UBaseType_t xQueueSendMultiple( QueueHandle_t xQueue, const void * const pvItemsToQueue, const UBaseType_t uxItemCount, TickType_t xTicksToWait )
+{
+BaseType_t xEntryTimeSet = pdFALSE;
+TimeOut_t xTimeOut;
+Queue_t * const pxQueue = xQueue;
+const int8_t *pcNextItem = ( const int8_t * ) pvItemsToQueue; /*lint !e9079 !e9087 Cast to byte pointer so the items can be stepped through. */
+UBaseType_t uxItemsSent = 0, uxItemsToCopy;
+
+	configASSERT( pxQueue );
+	configASSERT( !( ( pvItemsToQueue == NULL ) && ( uxItemCount != ( UBaseType_t ) 0U ) ) );
+
+	/* Semaphores and mutexes do not hold items. */
+	configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+
+	/*lint -save -e904 This function relaxes the coding standard somewhat to
+	allow return statements within the function itself.  This is done in the
+	interest of execution time efficiency. */
+	for( ;; )
+	{
+		taskENTER_CRITICAL();
+		{
+			/* Post as many of the remaining items as there is space for. */
+			uxItemsToCopy = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+			if( uxItemsToCopy > ( uxItemCount - uxItemsSent ) )
+			{
+				uxItemsToCopy = uxItemCount - uxItemsSent;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( uxItemsToCopy > ( UBaseType_t ) 0 )
+			{
+				traceQUEUE_SEND( pxQueue );
+
+				prvCopyMultipleToQueue( pxQueue, pcNextItem, uxItemsToCopy );
+				pcNextItem += ( size_t ) uxItemsToCopy * ( size_t ) pxQueue->uxItemSize;
+				uxItemsSent += uxItemsToCopy;
+
+				/* Unblock the tasks waiting for the data, if any.  It is ok
+				to yield from within the critical section - the kernel takes
+				care of that. */
+				if( prvUnblockTasksWaitingToReceive( pxQueue, uxItemsToCopy ) != pdFALSE )
+				{
+					queueYIELD_IF_USING_PREEMPTION();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+				{
+					prvSetWaitSetReadyBit( pxQueue, pdFALSE, NULL );
+				}
+				#endif /* configUSE_QUEUE_WAIT_SETS */
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( uxItemsSent == uxItemCount )
+			{
+				taskEXIT_CRITICAL();
+				return uxItemsSent;
+			}
+			else if( xTicksToWait == ( TickType_t ) 0 )
+			{
+				/* The queue was full and no block time is specified (or the
+				block time has expired) so leave now. */
+				taskEXIT_CRITICAL();
+				traceQUEUE_SEND_FAILED( pxQueue );
+				return uxItemsSent;
+			}
+			else if( xEntryTimeSet == pdFALSE )
+			{
+				/* The queue was full and a block time was specified so
+				configure the timeout structure. */
+				vTaskInternalSetTimeOutState( &xTimeOut );
+				xEntryTimeSet = pdTRUE;
+			}
+			else
+			{
+				/* Entry time was already set. */
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		/* Interrupts and other tasks can send to and receive from the queue
+		now the critical section has been exited. */
+
+		vTaskSuspendAll();
+		prvLockQueue( pxQueue );
+
+		/* Update the timeout state to see if it has expired yet. */
+		if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+		{
+			if( prvIsQueueFull( pxQueue ) != pdFALSE )
+			{
+				traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+				vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+				prvUnlockQueue( pxQueue );
+
+				if( xTaskResumeAll() == pdFALSE )
+				{
+					portYIELD_WITHIN_API();
+				}
+			}
+			else
+			{
+				/* Try again. */
+				prvUnlockQueue( pxQueue );
+				( void ) xTaskResumeAll();
+			}
+		}
+		else
+		{
+			/* The timeout has expired.  Loop back once more to post anything
+			there is now space for before giving up. */
+			prvUnlockQueue( pxQueue );
+			( void ) xTaskResumeAll();
+			xTicksToWait = ( TickType_t ) 0;
+		}
+	} /*lint -restore */
+}
+/*-----------------------------------------------------------*/
+
 BaseType_t xQueueGenericSendFromISR( QueueHandle_t xQueue, const void * const pvItemToQueue, BaseType_t * const pxHigherPriorityTaskWoken, const BaseType_t xCopyPosition )
 {
 BaseType_t xReturn;
@@ -1095,6 +1345,14 @@ Queue_t * const pxQueue = xQueue;
 				pxQueue->cTxLock = ( int8_t ) ( cTxLock + 1 );
 			}
 
+			#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+			{
+				/* Unlike the event lists, the wait set can be updated while the
+				queue is locked. */
+				prvSetWaitSetReadyBit( pxQueue, pdTRUE, pxHigherPriorityTaskWoken );
+			}
+			#endif /* configUSE_QUEUE_WAIT_SETS */
+
 			xReturn = pdPASS;
 		}
 		else
@@ -1109,6 +1367,92 @@ Queue_t * const pxQueue = xQueue;
 }
 /*-----------------------------------------------------------*/
 
+UBaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue, const void * const pvItemsToQueue, const UBaseType_t uxItemCount, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+UBaseType_t uxItemsToCopy;
+UBaseType_t uxSavedInterruptStatus;
+Queue_t * const pxQueue = xQueue;
+
+	configASSERT( pxQueue );
+	configASSERT( !( ( pvItemsToQueue == NULL ) && ( uxItemCount != ( UBaseType_t ) 0U ) ) );
+	configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+	/* See the comment in xQueueGenericSendFromISR(). */
+	portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		uxItemsToCopy = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+		if( uxItemsToCopy > uxItemCount )
+		{
+			uxItemsToCopy = uxItemCount;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( uxItemsToCopy > ( UBaseType_t ) 0 )
+		{
+			const int8_t cTxLock = pxQueue->cTxLock;
+
+			traceQUEUE_SEND_FROM_ISR( pxQueue );
+
+			prvCopyMultipleToQueue( pxQueue, ( const int8_t * ) pvItemsToQueue, uxItemsToCopy ); /*lint !e9079 !e9087 Cast to byte pointer so the items can be stepped through. */
+
+			/* The event list is not altered if the queue is locked.  This will
+			be done when the queue is unlocked later. */
+			if( cTxLock == queueUNLOCKED )
+			{
+				if( prvUnblockTasksWaitingToReceive( pxQueue, uxItemsToCopy ) != pdFALSE )
+				{
+					if( pxHigherPriorityTaskWoken != NULL )
+					{
+						*pxHigherPriorityTaskWoken = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				/* Increment the lock count so the task that unlocks the queue
+				knows that data was posted while it was locked. */
+				pxQueue->cTxLock = prvAddToLockCount( cTxLock, uxItemsToCopy );
+			}
+
+			#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+			{
+				prvSetWaitSetReadyBit( pxQueue, pdTRUE, pxHigherPriorityTaskWoken );
+			}
+			#endif /* configUSE_QUEUE_WAIT_SETS */
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( uxItemsToCopy < uxItemCount )
+		{
+			traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	return uxItemsToCopy;
+}
+/*-----------------------------------------------------------*/
+
 BaseType_t xQueueGiveFromISR( QueueHandle_t xQueue, BaseType_t * const pxHigherPriorityTaskWoken )
 {
 BaseType_t xReturn;
@@ -1260,6 +1604,12 @@ Queue_t * const pxQueue = xQueue;
 				pxQueue->cTxLock = ( int8_t ) ( cTxLock + 1 );
 			}
 
+			#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+			{
+				prvSetWaitSetReadyBit( pxQueue, pdTRUE, pxHigherPriorityTaskWoken );
+			}
+			#endif /* configUSE_QUEUE_WAIT_SETS */
+
 			xReturn = pdPASS;
 		}
 		else
@@ -1313,6 +1663,12 @@ Queue_t * const pxQueue = xQueue;
 				traceQUEUE_RECEIVE( pxQueue );
 				pxQueue->uxMessagesWaiting = uxMessagesWaiting - ( UBaseType_t ) 1;
 
+				#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+				{
+					prvClearWaitSetReadyBit( pxQueue );
+				}
+				#endif /* configUSE_QUEUE_WAIT_SETS */
+
 				/* There is now space in the queue, were any tasks waiting to
 				post to the queue?  If so, unblock the highest priority waiting
 				task. */
@@ -1415,22 +1771,19 @@ Queue_t * const pxQueue = xQueue;
 }
 /*-----------------------------------------------------------*/
 
-BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue, TickType_t xTicksToWait )
+UBaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue, void * const pvBuffer, const UBaseType_t uxMaxItems, TickType_t xTicksToWait )
 {
 BaseType_t xEntryTimeSet = pdFALSE;
 TimeOut_t xTimeOut;
 Queue_t * const pxQueue = xQueue;
+UBaseType_t uxItemsToCopy;
 
-#if( configUSE_MUTEXES == 1 )
-	BaseType_t xInheritanceOccurred = pdFALSE;
-#endif
-
-	/* Check the queue pointer is not NULL. */
 	configASSERT( ( pxQueue ) );
+	configASSERT( pvBuffer );
+	configASSERT( uxMaxItems > ( UBaseType_t ) 0U );
 
-	/* Check this really is a semaphore, in which case the item size will be
-	0. */
-	configASSERT( pxQueue->uxItemSize == 0 );
+	/* Semaphores and mutexes do not hold items. */
+	configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
 
 	/* Cannot block if the scheduler is suspended. */
 	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
@@ -1440,28 +1793,186 @@ Queue_t * const pxQueue = xQueue;
 	#endif
 
 
-	/*lint -save -e904 This function relaxes the coding standard somewhat to allow return
-	statements within the function itself.  This is done in the interest
-	of execution time efficiency. */
+	/*lint -save -e904  This function relaxes the coding standard somewhat to
+	allow return statements within the function itself.  This is done in the
+	interest of execution time efficiency. */
 	for( ;; )
 	{
 		taskENTER_CRITICAL();
 		{
-			/* Semaphores are queues with an item size of 0, and where the
-			number of messages in the queue is the semaphore's count value. */
-			const UBaseType_t uxSemaphoreCount = pxQueue->uxMessagesWaiting;
+			const UBaseType_t uxMessagesWaiting = pxQueue->uxMessagesWaiting;
 
 			/* Is there data in the queue now?  To be running the calling task
 			must be the highest priority task wanting to access the queue. */
-			if( uxSemaphoreCount > ( UBaseType_t ) 0 )
+			if( uxMessagesWaiting > ( UBaseType_t ) 0 )
 			{
+				/* Data available, remove as many items as there is room for. */
+				if( uxMessagesWaiting < uxMaxItems )
+				{
+					uxItemsToCopy = uxMessagesWaiting;
+				}
+				else
+				{
+					uxItemsToCopy = uxMaxItems;
+				}
+
+				prvCopyMultipleFromQueue( pxQueue, ( int8_t * ) pvBuffer, uxItemsToCopy ); /*lint !e9079 !e9087 Cast to byte pointer so the buffer can be stepped through. */
 				traceQUEUE_RECEIVE( pxQueue );
+				pxQueue->uxMessagesWaiting = uxMessagesWaiting - uxItemsToCopy;
 
-				/* Semaphores are queues with a data size of zero and where the
-				messages waiting is the semaphore's count.  Reduce the count. */
-				pxQueue->uxMessagesWaiting = uxSemaphoreCount - ( UBaseType_t ) 1;
+				#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+				{
+					prvClearWaitSetReadyBit( pxQueue );
+				}
+				#endif /* configUSE_QUEUE_WAIT_SETS */
 
-				#if ( configUSE_MUTEXES == 1 )
+				/* There is now space in the queue, were any tasks waiting to
+				post to the queue?  If so, unblock them. */
+				if( prvUnblockTasksWaitingToSend( pxQueue, uxItemsToCopy ) != pdFALSE )
+				{
+					queueYIELD_IF_USING_PREEMPTION();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				taskEXIT_CRITICAL();
+				return uxItemsToCopy;
+			}
+			else
+			{
+				if( xTicksToWait == ( TickType_t ) 0 )
+				{
+					/* The queue was empty and no block time is specified (or
+					the block time has expired) so leave now. */
+					taskEXIT_CRITICAL();
+					traceQUEUE_RECEIVE_FAILED( pxQueue );
+					return ( UBaseType_t ) 0;
+				}
+				else if( xEntryTimeSet == pdFALSE )
+				{
+					/* The queue was empty and a block time was specified so
+					configure the timeout structure. */
+					vTaskInternalSetTimeOutState( &xTimeOut );
+					xEntryTimeSet = pdTRUE;
+				}
+				else
+				{
+					/* Entry time was already set. */
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		/* Interrupts and other tasks can send to and receive from the queue
+		now the critical section has been exited. */
+
+		vTaskSuspendAll();
+		prvLockQueue( pxQueue );
+
+		/* Update the timeout state to see if it has expired yet. */
+		if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+		{
+			/* The timeout has not expired.  If the queue is still empty place
+			the task on the list of tasks waiting to receive from the queue. */
+			if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+			{
+				traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+				vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+				prvUnlockQueue( pxQueue );
+				if( xTaskResumeAll() == pdFALSE )
+				{
+					portYIELD_WITHIN_API();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				/* The queue contains data again.  Loop back to try and read the
+				data. */
+				prvUnlockQueue( pxQueue );
+				( void ) xTaskResumeAll();
+			}
+		}
+		else
+		{
+			/* Timed out.  If there is no data in the queue exit, otherwise loop
+			back and attempt to read the data. */
+			prvUnlockQueue( pxQueue );
+			( void ) xTaskResumeAll();
+
+			if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+			{
+				traceQUEUE_RECEIVE_FAILED( pxQueue );
+				return ( UBaseType_t ) 0;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	} /*lint -restore */
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue, TickType_t xTicksToWait )
+{
+BaseType_t xEntryTimeSet = pdFALSE;
+TimeOut_t xTimeOut;
+Queue_t * const pxQueue = xQueue;
+
+#if( configUSE_MUTEXES == 1 )
+	BaseType_t xInheritanceOccurred = pdFALSE;
+#endif
+
+	/* Check the queue pointer is not NULL. */
+	configASSERT( ( pxQueue ) );
+
+	/* Check this really is a semaphore, in which case the item size will be
+	0. */
+	configASSERT( pxQueue->uxItemSize == 0 );
+
+	/* Cannot block if the scheduler is suspended. */
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+
+	/*lint -save -e904 This function relaxes the coding standard somewhat to allow return
+	statements within the function itself.  This is done in the interest
+	of execution time efficiency. */
+	for( ;; )
+	{
+		taskENTER_CRITICAL();
+		{
+			/* Semaphores are queues with an item size of 0, and where the
+			number of messages in the queue is the semaphore's count value. */
+			const UBaseType_t uxSemaphoreCount = pxQueue->uxMessagesWaiting;
+
+			/* Is there data in the queue now?  To be running the calling task
+			must be the highest priority task wanting to access the queue. */
+			if( uxSemaphoreCount > ( UBaseType_t ) 0 )
+			{
+				traceQUEUE_RECEIVE( pxQueue );
+
+				/* Semaphores are queues with a data size of zero and where the
+				messages waiting is the semaphore's count.  Reduce the count. */
+				pxQueue->uxMessagesWaiting = uxSemaphoreCount - ( UBaseType_t ) 1;
+
+				#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+				{
+					prvClearWaitSetReadyBit( pxQueue );
+				}
+				#endif /* configUSE_QUEUE_WAIT_SETS */
+
+				#if ( configUSE_MUTEXES == 1 )
 				{
 					if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
 					{
@@ -1821,6 +2332,12 @@ Queue_t * const pxQueue = xQueue;
 			prvCopyDataFromQueue( pxQueue, pvBuffer );
 			pxQueue->uxMessagesWaiting = uxMessagesWaiting - ( UBaseType_t ) 1;
 
+			#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+			{
+				prvClearWaitSetReadyBit( pxQueue );
+			}
+			#endif /* configUSE_QUEUE_WAIT_SETS */
+
 			/* If the queue is locked the event list will not be modified.
 			Instead update the lock count so the task that unlocks the queue
 			will know that an ISR has removed data while the queue was
@@ -1873,6 +2390,86 @@ Queue_t * const pxQueue = xQueue;
 }
 /*-----------------------------------------------------------*/
 
+UBaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue, void * const pvBuffer, const UBaseType_t uxMaxItems, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+UBaseType_t uxItemsToCopy;
+UBaseType_t uxSavedInterruptStatus;
+Queue_t * const pxQueue = xQueue;
+
+	configASSERT( pxQueue );
+	configASSERT( !( ( pvBuffer == NULL ) && ( uxMaxItems != ( UBaseType_t ) 0U ) ) );
+	configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+	/* See the comment in xQueueReceiveFromISR(). */
+	portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		const UBaseType_t uxMessagesWaiting = pxQueue->uxMessagesWaiting;
+
+		if( uxMessagesWaiting < uxMaxItems )
+		{
+			uxItemsToCopy = uxMessagesWaiting;
+		}
+		else
+		{
+			uxItemsToCopy = uxMaxItems;
+		}
+
+		/* Cannot block in an ISR, so check there is data available. */
+		if( uxItemsToCopy > ( UBaseType_t ) 0 )
+		{
+			const int8_t cRxLock = pxQueue->cRxLock;
+
+			traceQUEUE_RECEIVE_FROM_ISR( pxQueue );
+
+			prvCopyMultipleFromQueue( pxQueue, ( int8_t * ) pvBuffer, uxItemsToCopy ); /*lint !e9079 !e9087 Cast to byte pointer so the buffer can be stepped through. */
+			pxQueue->uxMessagesWaiting = uxMessagesWaiting - uxItemsToCopy;
+
+			#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+			{
+				prvClearWaitSetReadyBit( pxQueue );
+			}
+			#endif /* configUSE_QUEUE_WAIT_SETS */
+
+			/* If the queue is locked the event list will not be modified.
+			Instead update the lock count so the task that unlocks the queue
+			will know that an ISR has removed data while the queue was
+			locked. */
+			if( cRxLock == queueUNLOCKED )
+			{
+				if( prvUnblockTasksWaitingToSend( pxQueue, uxItemsToCopy ) != pdFALSE )
+				{
+					if( pxHigherPriorityTaskWoken != NULL )
+					{
+						*pxHigherPriorityTaskWoken = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				pxQueue->cRxLock = prvAddToLockCount( cRxLock, uxItemsToCopy );
+			}
+		}
+		else
+		{
+			traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue );
+		}
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	return uxItemsToCopy;
+}
+/*-----------------------------------------------------------*/
+
 BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue,  void * const pvBuffer )
 {
 BaseType_t xReturn;
@@ -1985,6 +2582,19 @@ Queue_t * const pxQueue = xQueue;
 	}
 	#endif
 
+	#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+	{
+		if( pxQueue->pxWaitSet != NULL )
+		{
+			( void ) xQueueRemoveFromWaitSet( pxQueue, pxQueue->pxWaitSet );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
 	#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
 	{
 		/* The queue can only have been allocated dynamically - free it
@@ -2142,29 +2752,219 @@ UBaseType_t uxMessagesWaiting;
 		{
 			mtCOVERAGE_TEST_MARKER();
 		}
-	}
+	}
+
+	pxQueue->uxMessagesWaiting = uxMessagesWaiting + ( UBaseType_t ) 1;
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer )
+{
+	if( pxQueue->uxItemSize != ( UBaseType_t ) 0 )
+	{
+		pxQueue->u.xQueue.pcReadFrom += pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+		if( pxQueue->u.xQueue.pcReadFrom >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as use of the relational operator is the cleanest solutions. */
+		{
+			pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+		( void ) memcpy( ( void * ) pvBuffer, ( void * ) pxQueue->u.xQueue.pcReadFrom, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports.  Also previous logic ensures a null pointer can only be passed to memcpy() when the count is 0.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCopyMultipleToQueue( Queue_t * const pxQueue, const int8_t *pcItems, const UBaseType_t uxItemCount )
+{
+const size_t xBytes = ( size_t ) uxItemCount * ( size_t ) pxQueue->uxItemSize;
+size_t xFirstBytes;
+
+	/* This function is called from a critical section. */
+
+	/* Copy up to the end of the storage area, then wrap to the start of it
+	for whatever is left. */
+	xFirstBytes = ( size_t ) ( pxQueue->u.xQueue.pcTail - pxQueue->pcWriteTo ); /*lint !e9016 !e946 Pointer arithmetic on char types ok. */
+	if( xFirstBytes > xBytes )
+	{
+		xFirstBytes = xBytes;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	( void ) memcpy( ( void * ) pxQueue->pcWriteTo, ( const void * ) pcItems, xFirstBytes ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+
+	if( xFirstBytes < xBytes )
+	{
+		( void ) memcpy( ( void * ) pxQueue->pcHead, ( const void * ) &( pcItems[ xFirstBytes ] ), xBytes - xFirstBytes ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+		pxQueue->pcWriteTo = pxQueue->pcHead + ( xBytes - xFirstBytes ); /*lint !e9016 Pointer arithmetic on char types ok. */
+	}
+	else
+	{
+		pxQueue->pcWriteTo += xFirstBytes; /*lint !e9016 Pointer arithmetic on char types ok. */
+		if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
+		{
+			pxQueue->pcWriteTo = pxQueue->pcHead;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	pxQueue->uxMessagesWaiting += uxItemCount;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCopyMultipleFromQueue( Queue_t * const pxQueue, int8_t *pcBuffer, const UBaseType_t uxItemCount )
+{
+const size_t xBytes = ( size_t ) uxItemCount * ( size_t ) pxQueue->uxItemSize;
+size_t xFirstBytes;
+int8_t *pcFirstItem;
+
+	/* pcReadFrom points to the last item read, so the first item to read is
+	the one after it. */
+	pcFirstItem = pxQueue->u.xQueue.pcReadFrom + pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok. */
+	if( pcFirstItem >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as use of the relational operator is the cleanest solutions. */
+	{
+		pcFirstItem = pxQueue->pcHead;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	xFirstBytes = ( size_t ) ( pxQueue->u.xQueue.pcTail - pcFirstItem ); /*lint !e9016 !e946 Pointer arithmetic on char types ok. */
+	if( xFirstBytes > xBytes )
+	{
+		xFirstBytes = xBytes;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	( void ) memcpy( ( void * ) pcBuffer, ( void * ) pcFirstItem, xFirstBytes ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+
+	if( xFirstBytes < xBytes )
+	{
+		( void ) memcpy( ( void * ) &( pcBuffer[ xFirstBytes ] ), ( void * ) pxQueue->pcHead, xBytes - xFirstBytes ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+		pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead + ( ( xBytes - xFirstBytes ) - pxQueue->uxItemSize ); /*lint !e9016 Pointer arithmetic on char types ok. */
+	}
+	else
+	{
+		pxQueue->u.xQueue.pcReadFrom = pcFirstItem + ( xFirstBytes - pxQueue->uxItemSize ); /*lint !e9016 Pointer arithmetic on char types ok. */
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvUnblockTasksWaitingToReceive( Queue_t * const pxQueue, UBaseType_t uxItemsAdded )
+{
+BaseType_t xReturn = pdFALSE;
+
+	#if ( configUSE_QUEUE_SETS == 1 )
+	{
+		if( pxQueue->pxQueueSetContainer != NULL )
+		{
+			/* A queue set holds one entry for each item in its member queues,
+			so is notified once per item. */
+			while( uxItemsAdded > ( UBaseType_t ) 0 )
+			{
+				if( prvNotifyQueueSetContainer( pxQueue ) != pdFALSE )
+				{
+					xReturn = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				uxItemsAdded--;
+			}
+		}
+		else
+		{
+			while( ( uxItemsAdded > ( UBaseType_t ) 0 ) && ( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE ) )
+			{
+				if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+				{
+					xReturn = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				uxItemsAdded--;
+			}
+		}
+	}
+	#else /* configUSE_QUEUE_SETS */
+	{
+		while( ( uxItemsAdded > ( UBaseType_t ) 0 ) && ( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE ) )
+		{
+			if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+			{
+				xReturn = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			uxItemsAdded--;
+		}
+	}
+	#endif /* configUSE_QUEUE_SETS */
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvUnblockTasksWaitingToSend( Queue_t * const pxQueue, UBaseType_t uxItemsRemoved )
+{
+BaseType_t xReturn = pdFALSE;
+
+	while( ( uxItemsRemoved > ( UBaseType_t ) 0 ) && ( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE ) )
+	{
+		if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+		{
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
 
-	pxQueue->uxMessagesWaiting = uxMessagesWaiting + ( UBaseType_t ) 1;
+		uxItemsRemoved--;
+	}
 
 	return xReturn;
 }
 /*-----------------------------------------------------------*/
 
-static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer )
+static int8_t prvAddToLockCount( const int8_t cLockCount, const UBaseType_t uxCount )
 {
-	if( pxQueue->uxItemSize != ( UBaseType_t ) 0 )
+int8_t cReturn;
+
+	/* prvUnlockQueue() unblocks at most one task per count, so a saturated
+	count still unblocks every waiting task unless more than 127 tasks are
+	waiting. */
+	if( uxCount >= ( UBaseType_t ) ( queueLOCK_COUNT_MAX - cLockCount ) )
 	{
-		pxQueue->u.xQueue.pcReadFrom += pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
-		if( pxQueue->u.xQueue.pcReadFrom >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as use of the relational operator is the cleanest solutions. */
-		{
-			pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead;
-		}
-		else
-		{
-			mtCOVERAGE_TEST_MARKER();
-		}
-		( void ) memcpy( ( void * ) pvBuffer, ( void * ) pxQueue->u.xQueue.pcReadFrom, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports.  Also previous logic ensures a null pointer can only be passed to memcpy() when the count is 0.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+		cReturn = queueLOCK_COUNT_MAX;
+	}
+	else
+	{
+		cReturn = ( int8_t ) ( cLockCount + ( int8_t ) uxCount );
 	}
+
+	return cReturn;
 }
 /*-----------------------------------------------------------*/
 
@@ -2795,6 +3595,14 @@ Queue_t * const pxQueue = xQueue;
 				/* Cannot add a queue/semaphore to more than one queue set. */
 				xReturn = pdFAIL;
 			}
+			#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+			else if( ( ( Queue_t * ) xQueueOrSemaphore )->pxWaitSet != NULL )
+			{
+				/* Cannot add a queue/semaphore that is a member of a wait set
+				to a queue set. */
+				xReturn = pdFAIL;
+			}
+			#endif
 			else if( ( ( Queue_t * ) xQueueOrSemaphore )->uxMessagesWaiting != ( UBaseType_t ) 0 )
 			{
 				/* Cannot add a queue/semaphore to a queue set if there are already
@@ -2931,6 +3739,405 @@ Queue_t * const pxQueue = xQueue;
 	}
 
 #endif /* configUSE_QUEUE_SETS */
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_QUEUE_WAIT_SETS == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+
+	QueueWaitSetHandle_t xQueueCreateWaitSet( const UBaseType_t uxIndexToNotify )
+	{
+	QueueWaitSet_t *pxNewWaitSet;
+
+		configASSERT( uxIndexToNotify < ( UBaseType_t ) configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
+		pxNewWaitSet = ( QueueWaitSet_t * ) pvPortMalloc( sizeof( QueueWaitSet_t ) );
+
+		if( pxNewWaitSet != NULL )
+		{
+			pxNewWaitSet->ulReadyBits = 0UL;
+			pxNewWaitSet->ulMemberBits = 0UL;
+			pxNewWaitSet->xWaitingTask = NULL;
+			pxNewWaitSet->uxIndexToNotify = uxIndexToNotify;
+
+			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+			{
+				/* Wait sets can be allocated either statically or dynamically,
+				so note this wait set was allocated dynamically in case it is
+				later deleted. */
+				pxNewWaitSet->ucStaticallyAllocated = pdFALSE;
+			}
+			#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+			traceQUEUE_WAIT_SET_CREATE( pxNewWaitSet );
+		}
+		else
+		{
+			traceQUEUE_WAIT_SET_CREATE_FAILED();
+		}
+
+		return pxNewWaitSet;
+	}
+
+#endif /* ( configUSE_QUEUE_WAIT_SETS == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_QUEUE_WAIT_SETS == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+
+	QueueWaitSetHandle_t xQueueCreateWaitSetStatic( const UBaseType_t uxIndexToNotify, StaticQueueWaitSet_t *pxWaitSetBuffer )
+	{
+	QueueWaitSet_t *pxNewWaitSet;
+
+		configASSERT( uxIndexToNotify < ( UBaseType_t ) configTASK_NOTIFICATION_ARRAY_ENTRIES );
+		configASSERT( pxWaitSetBuffer );
+
+		#if( configASSERT_DEFINED == 1 )
+		{
+			/* Sanity check that the size of the structure used to declare a
+			variable of type StaticQueueWaitSet_t equals the size of the real
+			wait set structure. */
+			volatile size_t xSize = sizeof( StaticQueueWaitSet_t );
+			configASSERT( xSize == sizeof( QueueWaitSet_t ) );
+			( void ) xSize; /* Keeps lint quiet when configASSERT() is not defined. */
+		}
+		#endif /* configASSERT_DEFINED */
+
+		/* The user has provided a statically allocated wait set - use it. */
+		pxNewWaitSet = ( QueueWaitSet_t * ) pxWaitSetBuffer; /*lint !e740 !e9087 Unusual cast is ok as the structures are designed to have the same alignment, and the size is checked by an assert. */
+
+		if( pxNewWaitSet != NULL )
+		{
+			pxNewWaitSet->ulReadyBits = 0UL;
+			pxNewWaitSet->ulMemberBits = 0UL;
+			pxNewWaitSet->xWaitingTask = NULL;
+			pxNewWaitSet->uxIndexToNotify = uxIndexToNotify;
+
+			#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+			{
+				/* Both static and dynamic allocation can be used, so note that
+				this wait set was created statically in case it is later
+				deleted. */
+				pxNewWaitSet->ucStaticallyAllocated = pdTRUE;
+			}
+			#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+
+			traceQUEUE_WAIT_SET_CREATE( pxNewWaitSet );
+		}
+		else
+		{
+			traceQUEUE_WAIT_SET_CREATE_FAILED();
+		}
+
+		return pxNewWaitSet;
+	}
+
+#endif /* ( configUSE_QUEUE_WAIT_SETS == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+
+	BaseType_t xQueueAddToWaitSet( QueueSetMemberHandle_t xQueueOrSemaphore, QueueWaitSetHandle_t xWaitSet, const UBaseType_t uxBitNumber )
+	{
+	BaseType_t xReturn;
+	Queue_t * const pxQueueOrSemaphore = ( Queue_t * ) xQueueOrSemaphore;
+	QueueWaitSet_t * const pxWaitSet = xWaitSet;
+	const uint32_t ulBit = ( uint32_t ) 1UL << uxBitNumber;
+
+		configASSERT( pxQueueOrSemaphore );
+		configASSERT( pxWaitSet );
+		configASSERT( uxBitNumber < ( UBaseType_t ) 32U );
+
+		taskENTER_CRITICAL();
+		{
+			if( pxQueueOrSemaphore->pxWaitSet != NULL )
+			{
+				/* Cannot add a queue/semaphore to more than one wait set. */
+				xReturn = pdFAIL;
+			}
+			else if( ( pxWaitSet->ulMemberBits & ulBit ) != 0UL )
+			{
+				/* Another member already uses the bit. */
+				xReturn = pdFAIL;
+			}
+			else
+			{
+				#if ( configUSE_QUEUE_SETS == 1 )
+				{
+					/* A queue/semaphore in a queue set does not unblock tasks
+					waiting to receive from it directly, so cannot also be a
+					member of a wait set. */
+					xReturn = ( pxQueueOrSemaphore->pxQueueSetContainer == NULL ) ? pdPASS : pdFAIL;
+				}
+				#else
+				{
+					xReturn = pdPASS;
+				}
+				#endif /* configUSE_QUEUE_SETS */
+			}
+
+			if( xReturn == pdPASS )
+			{
+				pxQueueOrSemaphore->pxWaitSet = pxWaitSet;
+				pxQueueOrSemaphore->ulWaitSetBit = ulBit;
+				pxWaitSet->ulMemberBits |= ulBit;
+
+				/* The queue/semaphore may already hold items, in which case
+				the task waiting on the wait set must know about them. */
+				if( pxQueueOrSemaphore->uxMessagesWaiting != ( UBaseType_t ) 0 )
+				{
+					prvSetWaitSetReadyBit( pxQueueOrSemaphore, pdFALSE, NULL );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		return xReturn;
+	}
+
+#endif /* configUSE_QUEUE_WAIT_SETS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+
+	BaseType_t xQueueRemoveFromWaitSet( QueueSetMemberHandle_t xQueueOrSemaphore, QueueWaitSetHandle_t xWaitSet )
+	{
+	BaseType_t xReturn;
+	Queue_t * const pxQueueOrSemaphore = ( Queue_t * ) xQueueOrSemaphore;
+	QueueWaitSet_t * const pxWaitSet = xWaitSet;
+
+		configASSERT( pxQueueOrSemaphore );
+		configASSERT( pxWaitSet );
+
+		taskENTER_CRITICAL();
+		{
+			if( pxQueueOrSemaphore->pxWaitSet != pxWaitSet )
+			{
+				/* The queue was not a member of the wait set. */
+				xReturn = pdFAIL;
+			}
+			else
+			{
+				/* The bits are cleared here, so, unlike a queue set, nothing
+				is left in the wait set for a queue that is not empty. */
+				pxWaitSet->ulReadyBits &= ~( pxQueueOrSemaphore->ulWaitSetBit );
+				pxWaitSet->ulMemberBits &= ~( pxQueueOrSemaphore->ulWaitSetBit );
+				pxQueueOrSemaphore->pxWaitSet = NULL;
+				pxQueueOrSemaphore->ulWaitSetBit = 0UL;
+				xReturn = pdPASS;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		return xReturn;
+	}
+
+#endif /* configUSE_QUEUE_WAIT_SETS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+
+	uint32_t ulQueueWaitForAny( QueueWaitSetHandle_t xWaitSet, TickType_t xTicksToWait )
+	{
+	QueueWaitSet_t * const pxWaitSet = xWaitSet;
+	BaseType_t xEntryTimeSet = pdFALSE;
+	TimeOut_t xTimeOut;
+	uint32_t ulReadyBits;
+
+		configASSERT( pxWaitSet );
+		#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+		{
+			configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+		}
+		#endif
+
+		for( ;; )
+		{
+			taskENTER_CRITICAL();
+			{
+				ulReadyBits = pxWaitSet->ulReadyBits;
+
+				if( ( ulReadyBits != 0UL ) || ( xTicksToWait == ( TickType_t ) 0 ) )
+				{
+					/* A member is ready, or the block time has expired, so the
+					task will not wait again. */
+					pxWaitSet->xWaitingTask = NULL;
+				}
+				else
+				{
+					/* Only one task can block on a wait set at a time. */
+					configASSERT( ( pxWaitSet->xWaitingTask == NULL ) || ( pxWaitSet->xWaitingTask == xTaskGetCurrentTaskHandle() ) );
+
+					/* From now on a send to any member that finds no member
+					ready notifies this task. */
+					pxWaitSet->xWaitingTask = xTaskGetCurrentTaskHandle();
+
+					if( xEntryTimeSet == pdFALSE )
+					{
+						vTaskInternalSetTimeOutState( &xTimeOut );
+						xEntryTimeSet = pdTRUE;
+					}
+					else
+					{
+						/* Entry time was already set. */
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			if( ( ulReadyBits != 0UL ) || ( xTicksToWait == ( TickType_t ) 0 ) )
+			{
+				break;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* A notification left pending by an earlier call, after the task
+			timed out but before it cleared xWaitingTask, only results in the
+			ready bits being read again. */
+			traceBLOCKING_ON_QUEUE_WAIT_SET( pxWaitSet );
+			( void ) ulTaskNotifyTakeIndexed( pxWaitSet->uxIndexToNotify, pdTRUE, xTicksToWait );
+
+			if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+			{
+				/* Read the ready bits one last time before returning. */
+				xTicksToWait = ( TickType_t ) 0;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		traceQUEUE_WAIT_FOR_ANY( pxWaitSet, ulReadyBits );
+
+		return ulReadyBits;
+	}
+
+#endif /* configUSE_QUEUE_WAIT_SETS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+
+	uint32_t ulQueueWaitSetGetReadyFromISR( QueueWaitSetHandle_t xWaitSet )
+	{
+	const QueueWaitSet_t * const pxWaitSet = xWaitSet;
+
+		configASSERT( pxWaitSet );
+
+		return pxWaitSet->ulReadyBits;
+	}
+
+#endif /* configUSE_QUEUE_WAIT_SETS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+
+	void vQueueDeleteWaitSet( QueueWaitSetHandle_t xWaitSet )
+	{
+	QueueWaitSet_t * const pxWaitSet = xWaitSet;
+
+		configASSERT( pxWaitSet );
+		configASSERT( pxWaitSet->ulMemberBits == 0UL );
+		configASSERT( pxWaitSet->xWaitingTask == NULL );
+
+		traceQUEUE_WAIT_SET_DELETE( pxWaitSet );
+
+		#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
+		{
+			/* The wait set can only have been allocated dynamically - free it
+			again. */
+			vPortFree( pxWaitSet );
+		}
+		#elif( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+		{
+			/* The wait set could have been allocated statically or
+			dynamically, so check before attempting to free the memory. */
+			if( pxWaitSet->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+			{
+				vPortFree( pxWaitSet );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#else
+		{
+			/* The wait set must have been statically allocated, so is not
+			going to be deleted.  Avoid compiler warnings about the unused
+			parameter. */
+			( void ) pxWaitSet;
+		}
+		#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+	}
+
+#endif /* configUSE_QUEUE_WAIT_SETS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+
+	static void prvSetWaitSetReadyBit( const Queue_t * const pxQueue, const BaseType_t xFromISR, BaseType_t * const pxHigherPriorityTaskWoken )
+	{
+	QueueWaitSet_t * const pxWaitSet = pxQueue->pxWaitSet;
+
+		if( pxWaitSet != NULL )
+		{
+			if( ( pxWaitSet->ulReadyBits == 0UL ) && ( pxWaitSet->xWaitingTask != NULL ) )
+			{
+				/* No member was ready, so the waiting task may be blocked.
+				If another member was ready the task has already been
+				notified, or will see the bits before it blocks. */
+				pxWaitSet->ulReadyBits = pxQueue->ulWaitSetBit;
+
+				if( xFromISR != pdFALSE )
+				{
+					vTaskNotifyGiveIndexedFromISR( pxWaitSet->xWaitingTask, pxWaitSet->uxIndexToNotify, pxHigherPriorityTaskWoken );
+				}
+				else
+				{
+					/* It is ok to yield from within the critical section - the
+					kernel takes care of that. */
+					( void ) xTaskNotifyGiveIndexed( pxWaitSet->xWaitingTask, pxWaitSet->uxIndexToNotify );
+				}
+			}
+			else
+			{
+				pxWaitSet->ulReadyBits |= pxQueue->ulWaitSetBit;
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_QUEUE_WAIT_SETS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_WAIT_SETS == 1 )
+
+	static void prvClearWaitSetReadyBit( const Queue_t * const pxQueue )
+	{
+		if( ( pxQueue->pxWaitSet != NULL ) && ( pxQueue->uxMessagesWaiting == ( UBaseType_t ) 0 ) )
+		{
+			pxQueue->pxWaitSet->ulReadyBits &= ~( pxQueue->ulWaitSetBit );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_QUEUE_WAIT_SETS */
 
 
 
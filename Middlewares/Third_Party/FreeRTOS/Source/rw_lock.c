@@ -0,0 +1,799 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "atomic.h"
+#include "rw_lock.h"
+
+/* Lint e961, e750 and e9021 are suppressed as a MISRA exception justified
+because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+for the header files above, but not in this file, in order to generate the
+correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021 See comment above. */
+
+/* This entire source file will be skipped if the application is not configured
+to include reader-writer lock functionality.  This #if is closed at the very
+bottom of this file.  If you want to include reader-writer locks then ensure
+configUSE_RW_LOCKS is set to 1 in FreeRTOSConfig.h. */
+#if( configUSE_RW_LOCKS == 1 )
+
+#if( configUSE_PREEMPTION == 0 )
+	/* If the cooperative scheduler is being used then a yield should not be
+	performed just because a higher priority task has been woken. */
+	#define rwYIELD_IF_USING_PREEMPTION()
+#else
+	#define rwYIELD_IF_USING_PREEMPTION() portYIELD_WITHIN_API()
+#endif
+
+/* Bit definitions used in the ulState member of a lock structure.  The low
+bits hold the number of tasks holding the lock for reading. */
+#define rwWRITE_LOCKED_BIT			( ( uint32_t ) 0x80000000UL )
+#define rwWRITERS_WAITING_BIT		( ( uint32_t ) 0x40000000UL )
+#define rwREADER_COUNT_MASK			( ( uint32_t ) 0x3fffffffUL )
+
+typedef struct RWLockDef_t
+{
+	volatile uint32_t ulState;		/*< The reader count and the rw*_BIT flags.  Changed by compare-and-swap, or inside a critical section. */
+	void * volatile pvWriter;		/*< The handle of the task holding the lock for writing, or NULL. */
+	UBaseType_t uxWritersWaiting;	/*< The number of tasks trying to take the lock for writing that have had to wait.  rwWRITERS_WAITING_BIT is set while this is not 0. */
+	List_t xTasksWaitingToRead;		/*< List of tasks blocked waiting to take the lock for reading.  Stored in priority order. */
+	List_t xTasksWaitingToWrite;	/*< List of tasks blocked waiting to take the lock for writing.  Stored in priority order. */
+
+	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+		uint8_t ucStaticallyAllocated; /*< Set to pdTRUE if the lock is statically allocated to ensure no attempt is made to free the memory. */
+	#endif
+} RWLock_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Block the calling task on the list of readers or writers, unless the state
+ * of the lock changed such that the task can now take the lock, and make the
+ * task holding the lock for writing, if any, inherit the priority of the
+ * calling task.  Returns pdTRUE if a priority was inherited.
+ */
+static BaseType_t prvWaitForLock( RWLock_t * const pxLock, const BaseType_t xIsWrite, TimeOut_t * const pxTimeOut, TickType_t * const pxTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock every task waiting to take the lock for reading.  Must be called from
+ * a critical section.  Returns pdTRUE if a task of higher priority than the
+ * calling task was unblocked.
+ */
+static BaseType_t prvUnblockReaders( RWLock_t * const pxLock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called after a task that caused the writer to inherit its priority times
+ * out.  Returns the priority of the highest priority task still waiting for
+ * the lock, or tskIDLE_PRIORITY if no tasks are waiting.
+ */
+static UBaseType_t prvGetDisinheritPriorityAfterTimeout( const RWLock_t * const pxLock ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+	RWLockHandle_t xRWLockCreateStatic( StaticRWLock_t *pxLockBuffer )
+	{
+	RWLock_t *pxLock;
+
+		/* A StaticRWLock_t object must be provided. */
+		configASSERT( pxLockBuffer );
+
+		#if( configASSERT_DEFINED == 1 )
+		{
+			/* Sanity check that the size of the structure used to declare a
+			variable of type StaticRWLock_t equals the size of the real lock
+			structure. */
+			volatile size_t xSize = sizeof( StaticRWLock_t );
+			configASSERT( xSize == sizeof( RWLock_t ) );
+		} /*lint !e529 xSize is referenced if configASSERT() is defined. */
+		#endif /* configASSERT_DEFINED */
+
+		/* The user has provided a statically allocated lock - use it. */
+		pxLock = ( RWLock_t * ) pxLockBuffer; /*lint !e740 !e9087 RWLock_t and StaticRWLock_t are deliberately aliased for data hiding purposes and guaranteed to have the same size and alignment requirement - checked by configASSERT(). */
+
+		if( pxLock != NULL )
+		{
+			pxLock->ulState = 0;
+			pxLock->pvWriter = NULL;
+			pxLock->uxWritersWaiting = 0;
+			vListInitialise( &( pxLock->xTasksWaitingToRead ) );
+			vListInitialise( &( pxLock->xTasksWaitingToWrite ) );
+
+			#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+			{
+				/* Both static and dynamic allocation can be used, so note that
+				this lock was created statically in case the lock is later
+				deleted. */
+				pxLock->ucStaticallyAllocated = pdTRUE;
+			}
+			#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+
+			traceRW_LOCK_CREATE( pxLock );
+		}
+		else
+		{
+			traceRW_LOCK_CREATE_FAILED();
+		}
+
+		return pxLock;
+	}
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	RWLockHandle_t xRWLockCreate( void )
+	{
+	RWLock_t *pxLock;
+
+		/* pvPortMalloc() always returns memory aligned to the requirements of
+		the stack, which is sufficient for the members of the RWLock_t
+		structure. */
+		pxLock = ( RWLock_t * ) pvPortMalloc( sizeof( RWLock_t ) ); /*lint !e9087 !e9079 see comment above. */
+
+		if( pxLock != NULL )
+		{
+			pxLock->ulState = 0;
+			pxLock->pvWriter = NULL;
+			pxLock->uxWritersWaiting = 0;
+			vListInitialise( &( pxLock->xTasksWaitingToRead ) );
+			vListInitialise( &( pxLock->xTasksWaitingToWrite ) );
+
+			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+			{
+				/* Both static and dynamic allocation can be used, so note this
+				lock was allocated dynamically in case the lock is later
+				deleted. */
+				pxLock->ucStaticallyAllocated = pdFALSE;
+			}
+			#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+			traceRW_LOCK_CREATE( pxLock );
+		}
+		else
+		{
+			traceRW_LOCK_CREATE_FAILED(); /*lint !e9063 Else branch only exists to allow tracing and does not generate code if trace macros are not defined. */
+		}
+
+		return pxLock;
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+BaseType_t xRWLockTakeRead( RWLockHandle_t xLock, TickType_t xTicksToWait )
+{
+RWLock_t * const pxLock = xLock;
+BaseType_t xReturn = pdFAIL, xEntryTimeSet = pdFALSE, xInheritanceOccurred = pdFALSE;
+uint32_t ulState;
+TimeOut_t xTimeOut;
+
+	configASSERT( pxLock );
+
+	/* Cannot block if the scheduler is suspended. */
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	for( ;; )
+	{
+		ulState = pxLock->ulState;
+
+		if( ( ulState & ( rwWRITE_LOCKED_BIT | rwWRITERS_WAITING_BIT ) ) == 0UL )
+		{
+			/* No task holds or is waiting for the lock for writing, so
+			increment the reader count.  If another task changed the state
+			since it was read then go round again. */
+			configASSERT( ( ulState & rwREADER_COUNT_MASK ) != rwREADER_COUNT_MASK );
+
+			if( Atomic_CompareAndSwap_u32_AcqRel( &( pxLock->ulState ), ulState + 1UL, ulState ) == ATOMIC_COMPARE_AND_SWAP_SUCCESS )
+			{
+				traceRW_LOCK_TAKE( pxLock, pdFALSE );
+				xReturn = pdPASS;
+				break;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else if( xTicksToWait == ( TickType_t ) 0 )
+		{
+			/* The lock cannot be taken for reading and no block time is
+			specified (or the block time has expired) so exit now. */
+			break;
+		}
+		else
+		{
+			if( xEntryTimeSet == pdFALSE )
+			{
+				vTaskSetTimeOutState( &xTimeOut );
+				xEntryTimeSet = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( prvWaitForLock( pxLock, pdFALSE, &xTimeOut, &xTicksToWait ) != pdFALSE )
+			{
+				xInheritanceOccurred = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+
+	if( xReturn == pdFAIL )
+	{
+		if( xInheritanceOccurred != pdFALSE )
+		{
+			taskENTER_CRITICAL();
+			{
+				/* This task blocking on the lock caused the writer to inherit
+				this task's priority.  Now this task has timed out the priority
+				should be disinherited again, but only as low as the next
+				highest priority task that is waiting for the lock. */
+				vTaskPriorityDisinheritAfterTimeout( pxLock->pvWriter, prvGetDisinheritPriorityAfterTimeout( pxLock ) );
+			}
+			taskEXIT_CRITICAL();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		traceRW_LOCK_TAKE_FAILED( pxLock, pdFALSE );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRWLockGiveRead( RWLockHandle_t xLock )
+{
+RWLock_t * const pxLock = xLock;
+BaseType_t xReturn, xYieldRequired = pdFALSE;
+uint32_t ulState;
+
+	configASSERT( pxLock );
+
+	for( ;; )
+	{
+		ulState = pxLock->ulState;
+
+		if( ( ulState & rwREADER_COUNT_MASK ) == 0UL )
+		{
+			/* The lock is not held for reading. */
+			xReturn = pdFAIL;
+			break;
+		}
+		else if( ( ( ulState & rwREADER_COUNT_MASK ) == 1UL ) && ( ( ulState & rwWRITERS_WAITING_BIT ) != 0UL ) )
+		{
+			/* This is the last reader and a writer is waiting, so the writer
+			must be unblocked.  The state is read again inside the critical
+			section as the waiting writer might have timed out, letting other
+			tasks take the lock for reading, since it was last read. */
+			taskENTER_CRITICAL();
+			{
+				traceRW_LOCK_GIVE( pxLock, pdFALSE );
+				pxLock->ulState--;
+
+				if( ( ( pxLock->ulState & rwREADER_COUNT_MASK ) == 0UL ) && ( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToWrite ) ) == pdFALSE ) )
+				{
+					xYieldRequired = xTaskRemoveFromEventList( &( pxLock->xTasksWaitingToWrite ) );
+				}
+				else
+				{
+					/* Either other tasks still hold the lock for reading, or
+					the writer has not blocked yet and will find the lock free
+					when it tries to. */
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			xReturn = pdPASS;
+			break;
+		}
+		else
+		{
+			/* Decrement the reader count.  If another task changed the state
+			since it was read then go round again. */
+			if( Atomic_CompareAndSwap_u32_AcqRel( &( pxLock->ulState ), ulState - 1UL, ulState ) == ATOMIC_COMPARE_AND_SWAP_SUCCESS )
+			{
+				traceRW_LOCK_GIVE( pxLock, pdFALSE );
+				xReturn = pdPASS;
+				break;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+
+	if( xYieldRequired != pdFALSE )
+	{
+		rwYIELD_IF_USING_PREEMPTION();
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRWLockTakeWrite( RWLockHandle_t xLock, TickType_t xTicksToWait )
+{
+RWLock_t * const pxLock = xLock;
+TaskHandle_t const xCurrentTask = xTaskGetCurrentTaskHandle();
+BaseType_t xReturn = pdFAIL, xEntryTimeSet = pdFALSE, xInheritanceOccurred = pdFALSE, xWaiting = pdFALSE, xYieldRequired = pdFALSE;
+uint32_t ulState;
+TimeOut_t xTimeOut;
+
+	configASSERT( pxLock );
+
+	/* Cannot block if the scheduler is suspended. */
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	for( ;; )
+	{
+		ulState = pxLock->ulState;
+
+		if( ( ulState & ( rwWRITE_LOCKED_BIT | rwREADER_COUNT_MASK ) ) == 0UL )
+		{
+			/* No task holds the lock, so set the write locked bit.  The bit is
+			set in a critical section, together with pvWriter and the count of
+			locks held by this task, as a task that finds the bit set passes
+			its priority to pvWriter, and a task that then times out uses the
+			count to decide whether to disinherit it again.  If another task
+			changed the state since it was read then go round again. */
+			taskENTER_CRITICAL();
+			{
+				if( pxLock->ulState == ulState )
+				{
+					pxLock->ulState = ulState | rwWRITE_LOCKED_BIT;
+					pxLock->pvWriter = xCurrentTask;
+
+					/* Record the lock as held so any priority inherited while
+					it is held is disinherited again when it is given back. */
+					( void ) pvTaskIncrementMutexHeldCount();
+					xReturn = pdPASS;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			if( xReturn != pdFAIL )
+			{
+				traceRW_LOCK_TAKE( pxLock, pdTRUE );
+				break;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else if( xTicksToWait == ( TickType_t ) 0 )
+		{
+			/* The lock is held and no block time is specified (or the block
+			time has expired) so exit now. */
+			break;
+		}
+		else
+		{
+			/* Reader-writer locks cannot be taken recursively. */
+			configASSERT( pxLock->pvWriter != xCurrentTask );
+
+			if( xEntryTimeSet == pdFALSE )
+			{
+				vTaskSetTimeOutState( &xTimeOut );
+				xEntryTimeSet = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( xWaiting == pdFALSE )
+			{
+				/* Stop further tasks taking the lock for reading until this
+				task has taken the lock or given up waiting for it. */
+				taskENTER_CRITICAL();
+				{
+					( pxLock->uxWritersWaiting )++;
+					pxLock->ulState |= rwWRITERS_WAITING_BIT;
+				}
+				taskEXIT_CRITICAL();
+				xWaiting = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( prvWaitForLock( pxLock, pdTRUE, &xTimeOut, &xTicksToWait ) != pdFALSE )
+			{
+				xInheritanceOccurred = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+
+	if( ( xWaiting != pdFALSE ) || ( xInheritanceOccurred != pdFALSE ) )
+	{
+		taskENTER_CRITICAL();
+		{
+			if( xWaiting != pdFALSE )
+			{
+				( pxLock->uxWritersWaiting )--;
+
+				if( pxLock->uxWritersWaiting == ( UBaseType_t ) 0 )
+				{
+					pxLock->ulState &= ~rwWRITERS_WAITING_BIT;
+
+					/* If this task gave up waiting, and no other task holds
+					the lock for writing, then the tasks that were only waiting
+					because this task was waiting can take it for reading. */
+					if( ( pxLock->ulState & rwWRITE_LOCKED_BIT ) == 0UL )
+					{
+						xYieldRequired = prvUnblockReaders( pxLock );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( ( xReturn == pdFAIL ) && ( xInheritanceOccurred != pdFALSE ) )
+			{
+				/* This task blocking on the lock caused the writer to inherit
+				this task's priority.  Now this task has timed out the priority
+				should be disinherited again, but only as low as the next
+				highest priority task that is waiting for the lock. */
+				vTaskPriorityDisinheritAfterTimeout( pxLock->pvWriter, prvGetDisinheritPriorityAfterTimeout( pxLock ) );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( xYieldRequired != pdFALSE )
+		{
+			rwYIELD_IF_USING_PREEMPTION();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( xReturn == pdFAIL )
+	{
+		traceRW_LOCK_TAKE_FAILED( pxLock, pdTRUE );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRWLockGiveWrite( RWLockHandle_t xLock )
+{
+RWLock_t * const pxLock = xLock;
+TaskHandle_t const xCurrentTask = xTaskGetCurrentTaskHandle();
+BaseType_t xReturn, xYieldRequired = pdFALSE;
+
+	configASSERT( pxLock );
+
+	taskENTER_CRITICAL();
+	{
+		if( pxLock->pvWriter == xCurrentTask )
+		{
+			traceRW_LOCK_GIVE( pxLock, pdTRUE );
+
+			pxLock->pvWriter = NULL;
+			pxLock->ulState &= ~rwWRITE_LOCKED_BIT;
+
+			/* Restore the priority of this task if it inherited a priority
+			while holding the lock. */
+			xYieldRequired = xTaskPriorityDisinherit( xCurrentTask );
+
+			if( pxLock->uxWritersWaiting != ( UBaseType_t ) 0 )
+			{
+				/* Writers take preference, so unblock the highest priority
+				waiting writer.  If the list is empty then every waiting writer
+				has already been unblocked and will try to take the lock when it
+				runs. */
+				if( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToWrite ) ) == pdFALSE )
+				{
+					if( xTaskRemoveFromEventList( &( pxLock->xTasksWaitingToWrite ) ) != pdFALSE )
+					{
+						xYieldRequired = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				if( prvUnblockReaders( pxLock ) != pdFALSE )
+				{
+					xYieldRequired = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+
+			xReturn = pdPASS;
+		}
+		else
+		{
+			/* Only the writer can give the lock for writing. */
+			xReturn = pdFAIL;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	if( xYieldRequired != pdFALSE )
+	{
+		rwYIELD_IF_USING_PREEMPTION();
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vRWLockDelete( RWLockHandle_t xLock )
+{
+RWLock_t * const pxLock = xLock;
+
+	configASSERT( pxLock );
+
+	/* A lock cannot be deleted while it is held or waited for. */
+	configASSERT( pxLock->ulState == 0UL );
+	configASSERT( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToRead ) ) != pdFALSE );
+	configASSERT( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToWrite ) ) != pdFALSE );
+
+	traceRW_LOCK_DELETE( pxLock );
+
+	#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
+	{
+		/* The lock can only have been allocated dynamically - free it
+		again. */
+		vPortFree( pxLock );
+	}
+	#elif( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+	{
+		/* The lock could have been allocated statically or dynamically, so
+		check before attempting to free the memory. */
+		if( pxLock->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+		{
+			vPortFree( pxLock );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvWaitForLock( RWLock_t * const pxLock, const BaseType_t xIsWrite, TimeOut_t * const pxTimeOut, TickType_t * const pxTicksToWait )
+{
+BaseType_t xInheritanceOccurred = pdFALSE, xBlocked = pdFALSE;
+uint32_t ulBlockingBits;
+List_t *pxWaitingList;
+
+	if( xIsWrite != pdFALSE )
+	{
+		ulBlockingBits = rwWRITE_LOCKED_BIT | rwREADER_COUNT_MASK;
+		pxWaitingList = &( pxLock->xTasksWaitingToWrite );
+	}
+	else
+	{
+		ulBlockingBits = rwWRITE_LOCKED_BIT | rwWRITERS_WAITING_BIT;
+		pxWaitingList = &( pxLock->xTasksWaitingToRead );
+	}
+
+	/* The lock is only given by tasks, so its state cannot change while the
+	scheduler is suspended. */
+	vTaskSuspendAll();
+
+	if( xTaskCheckForTimeOut( pxTimeOut, pxTicksToWait ) == pdFALSE )
+	{
+		if( ( pxLock->ulState & ulBlockingBits ) != 0UL )
+		{
+			/* The write locked bit and pvWriter are only changed together,
+			in a critical section. */
+			configASSERT( ( ( pxLock->ulState & rwWRITE_LOCKED_BIT ) == 0UL ) || ( pxLock->pvWriter != NULL ) );
+
+			traceBLOCKING_ON_RW_LOCK_TAKE( pxLock, xIsWrite );
+
+			taskENTER_CRITICAL();
+			{
+				xInheritanceOccurred = xTaskPriorityInherit( pxLock->pvWriter );
+			}
+			taskEXIT_CRITICAL();
+
+			vTaskPlaceOnEventList( pxWaitingList, *pxTicksToWait );
+			xBlocked = pdTRUE;
+		}
+		else
+		{
+			/* The lock was given since the last attempt, so try to take it
+			again. */
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		/* Timed out.  *pxTicksToWait is now 0, so the caller exits after one
+		more attempt to take the lock. */
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( ( xTaskResumeAll() == pdFALSE ) && ( xBlocked != pdFALSE ) )
+	{
+		portYIELD_WITHIN_API();
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xInheritanceOccurred;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvUnblockReaders( RWLock_t * const pxLock )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	while( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToRead ) ) == pdFALSE )
+	{
+		if( xTaskRemoveFromEventList( &( pxLock->xTasksWaitingToRead ) ) != pdFALSE )
+		{
+			xHigherPriorityTaskWoken = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	return xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvGetDisinheritPriorityAfterTimeout( const RWLock_t * const pxLock )
+{
+UBaseType_t uxHighestPriorityOfWaitingTasks = tskIDLE_PRIORITY, uxPriority;
+
+	/* As in queue.c, the waiting tasks are held in priority order, with the
+	event list item value of each set to configMAX_PRIORITIES minus the
+	task's priority, so only the head of each list needs to be checked. */
+	if( listCURRENT_LIST_LENGTH( &( pxLock->xTasksWaitingToRead ) ) > 0U )
+	{
+		uxHighestPriorityOfWaitingTasks = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxLock->xTasksWaitingToRead ) );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( listCURRENT_LIST_LENGTH( &( pxLock->xTasksWaitingToWrite ) ) > 0U )
+	{
+		uxPriority = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxLock->xTasksWaitingToWrite ) );
+
+		if( uxPriority > uxHighestPriorityOfWaitingTasks )
+		{
+			uxHighestPriorityOfWaitingTasks = uxPriority;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return uxHighestPriorityOfWaitingTasks;
+}
+/*-----------------------------------------------------------*/
+
+/* This entire source file will be skipped if the application is not configured
+to include reader-writer lock functionality.  If you want to include
+reader-writer locks then ensure configUSE_RW_LOCKS is set to 1 in
+FreeRTOSConfig.h. */
+#endif /* configUSE_RW_LOCKS == 1 */
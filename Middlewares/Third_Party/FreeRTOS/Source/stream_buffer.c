@@ -39,6 +39,14 @@ task.h is included from an application file. */
 #include "task.h"
 #include "stream_buffer.h"
 
+#if( configUSE_LOCK_FREE_STREAM_BUFFERS == 1 )
+	#include "atomic.h"
+#endif
+
+#if( configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS == 1 )
+	#include "croutine.h"
+#endif
+
 #if( configUSE_TASK_NOTIFICATIONS != 1 )
 	#error configUSE_TASK_NOTIFICATIONS must be set to 1 to build stream_buffer.c
 #endif
@@ -49,43 +57,71 @@ for the header files above, but not in this file, in order to generate the
 correct privileged Vs unprivileged linkage and placement. */
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
 
+/* The head and tail indexes are each written by only one side of the buffer -
+the head by the writer and the tail by the reader.  When
+configUSE_LOCK_FREE_STREAM_BUFFERS is 1 the writer publishes the head with
+release semantics after copying data in, and the reader publishes the tail with
+release semantics after copying data out.  Each side reads the other's index
+with acquire semantics, so the data is never accessed before the index that
+covers it. */
+#if( configUSE_LOCK_FREE_STREAM_BUFFERS == 1 )
+	#define sbLOAD_INDEX( xIndex )				Atomic_LoadAcquire_size( &( xIndex ) )
+	#define sbSTORE_INDEX( xIndex, xValue )		Atomic_StoreRelease_size( &( xIndex ), ( xValue ) )
+
+	/* A task only sets xTaskWaitingToReceive or xTaskWaitingToSend inside a
+	critical section, after finding the buffer empty or full, so the
+	notification macros below can skip the interrupt mask, or the scheduler
+	suspension, when no task is waiting. */
+	#define sbTASK_MAY_BE_WAITING( xTask )		( ( xTask ) != NULL )
+#else
+	#define sbLOAD_INDEX( xIndex )				( xIndex )
+	#define sbSTORE_INDEX( xIndex, xValue )		( xIndex ) = ( xValue )
+	#define sbTASK_MAY_BE_WAITING( xTask )		( pdTRUE )
+#endif
+
 /* If the user has not provided application specific Rx notification macros,
 or #defined the notification macros away, them provide default implementations
 that uses task notifications. */
 /*lint -save -e9026 Function like macros allowed and needed here so they can be overidden. */
 #ifndef sbRECEIVE_COMPLETED
-	#define sbRECEIVE_COMPLETED( pxStreamBuffer )										\
-		vTaskSuspendAll();																\
-		{																				\
-			if( ( pxStreamBuffer )->xTaskWaitingToSend != NULL )						\
-			{																			\
-				( void ) xTaskNotify( ( pxStreamBuffer )->xTaskWaitingToSend,			\
-									  ( uint32_t ) 0,									\
-									  eNoAction );										\
-				( pxStreamBuffer )->xTaskWaitingToSend = NULL;							\
-			}																			\
-		}																				\
-		( void ) xTaskResumeAll();
+	#define sbRECEIVE_COMPLETED( pxStreamBuffer )									\
+		if( sbTASK_MAY_BE_WAITING( ( pxStreamBuffer )->xTaskWaitingToSend ) )		\
+		{																			\
+			vTaskSuspendAll();														\
+			{																		\
+				if( ( pxStreamBuffer )->xTaskWaitingToSend != NULL )				\
+				{																	\
+					( void ) xTaskNotify( ( pxStreamBuffer )->xTaskWaitingToSend,	\
+										  ( uint32_t ) 0,							\
+										  eNoAction );								\
+					( pxStreamBuffer )->xTaskWaitingToSend = NULL;					\
+				}																	\
+			}																		\
+			( void ) xTaskResumeAll();												\
+		}
 #endif /* sbRECEIVE_COMPLETED */
 
 #ifndef sbRECEIVE_COMPLETED_FROM_ISR
-	#define sbRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer,								\
-										  pxHigherPriorityTaskWoken )					\
-	{																					\
-	UBaseType_t uxSavedInterruptStatus;													\
-																						\
-		uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();		\
-		{																				\
-			if( ( pxStreamBuffer )->xTaskWaitingToSend != NULL )						\
-			{																			\
-				( void ) xTaskNotifyFromISR( ( pxStreamBuffer )->xTaskWaitingToSend,	\
-											 ( uint32_t ) 0,							\
-											 eNoAction,									\
-											 pxHigherPriorityTaskWoken );				\
-				( pxStreamBuffer )->xTaskWaitingToSend = NULL;							\
-			}																			\
-		}																				\
-		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );					\
+	#define sbRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer,									\
+										  pxHigherPriorityTaskWoken )						\
+	{																						\
+	UBaseType_t uxSavedInterruptStatus;														\
+																							\
+		if( sbTASK_MAY_BE_WAITING( ( pxStreamBuffer )->xTaskWaitingToSend ) )				\
+		{																					\
+			uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();		\
+			{																				\
+				if( ( pxStreamBuffer )->xTaskWaitingToSend != NULL )						\
+				{																			\
+					( void ) xTaskNotifyFromISR( ( pxStreamBuffer )->xTaskWaitingToSend,	\
+												 ( uint32_t ) 0,							\
+												 eNoAction,									\
+												 pxHigherPriorityTaskWoken );				\
+					( pxStreamBuffer )->xTaskWaitingToSend = NULL;							\
+				}																			\
+			}																				\
+			portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );					\
+		}																					\
 	}
 #endif /* sbRECEIVE_COMPLETED_FROM_ISR */
 
@@ -94,40 +130,63 @@ or #defined the notification macro away, them provide a default implementation
 that uses task notifications. */
 #ifndef sbSEND_COMPLETED
 	#define sbSEND_COMPLETED( pxStreamBuffer )											\
-		vTaskSuspendAll();																\
+		if( sbTASK_MAY_BE_WAITING( ( pxStreamBuffer )->xTaskWaitingToReceive ) )		\
 		{																				\
-			if( ( pxStreamBuffer )->xTaskWaitingToReceive != NULL )						\
+			vTaskSuspendAll();															\
 			{																			\
-				( void ) xTaskNotify( ( pxStreamBuffer )->xTaskWaitingToReceive,		\
-									  ( uint32_t ) 0,									\
-									  eNoAction );										\
-				( pxStreamBuffer )->xTaskWaitingToReceive = NULL;						\
+				if( ( pxStreamBuffer )->xTaskWaitingToReceive != NULL )					\
+				{																		\
+					( void ) xTaskNotify( ( pxStreamBuffer )->xTaskWaitingToReceive,	\
+										  ( uint32_t ) 0,								\
+										  eNoAction );									\
+					( pxStreamBuffer )->xTaskWaitingToReceive = NULL;					\
+				}																		\
 			}																			\
-		}																				\
-		( void ) xTaskResumeAll();
+			( void ) xTaskResumeAll();													\
+		}
 #endif /* sbSEND_COMPLETED */
 
 #ifndef sbSEND_COMPLETE_FROM_ISR
-	#define sbSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken )		\
-	{																					\
-	UBaseType_t uxSavedInterruptStatus;													\
-																						\
-		uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();		\
-		{																				\
-			if( ( pxStreamBuffer )->xTaskWaitingToReceive != NULL )						\
-			{																			\
-				( void ) xTaskNotifyFromISR( ( pxStreamBuffer )->xTaskWaitingToReceive,	\
-											 ( uint32_t ) 0,							\
-											 eNoAction,									\
-											 pxHigherPriorityTaskWoken );				\
-				( pxStreamBuffer )->xTaskWaitingToReceive = NULL;						\
-			}																			\
-		}																				\
-		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );					\
+	#define sbSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken )			\
+	{																						\
+	UBaseType_t uxSavedInterruptStatus;														\
+																							\
+		if( sbTASK_MAY_BE_WAITING( ( pxStreamBuffer )->xTaskWaitingToReceive ) )			\
+		{																					\
+			uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();		\
+			{																				\
+				if( ( pxStreamBuffer )->xTaskWaitingToReceive != NULL )						\
+				{																			\
+					( void ) xTaskNotifyFromISR( ( pxStreamBuffer )->xTaskWaitingToReceive,	\
+												 ( uint32_t ) 0,							\
+												 eNoAction,									\
+												 pxHigherPriorityTaskWoken );				\
+					( pxStreamBuffer )->xTaskWaitingToReceive = NULL;						\
+				}																			\
+			}																				\
+			portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );					\
+		}																					\
 	}
 #endif /* sbSEND_COMPLETE_FROM_ISR */
 /*lint -restore (9026) */
 
+/* Co-routines waiting on the stream buffer are unblocked alongside the task
+notification macros above rather than from within them, so they are still
+unblocked when the application provides its own notification macros. */
+#if( configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS == 1 )
+	#define sbCO_ROUTINE_SEND_COMPLETED( pxStreamBuffer )				( void ) prvUnblockCoRoutine( &( ( pxStreamBuffer )->xCoRoutinesWaitingToReceive ) )
+	#define sbCO_ROUTINE_SEND_COMPLETE_FROM_ISR( pxStreamBuffer )		prvUnblockCoRoutineFromISR( &( ( pxStreamBuffer )->xCoRoutinesWaitingToReceive ) )
+	#define sbCO_ROUTINE_RECEIVE_COMPLETED( pxStreamBuffer )			( void ) prvUnblockCoRoutine( &( ( pxStreamBuffer )->xCoRoutinesWaitingToSend ) )
+	#define sbCO_ROUTINE_RECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer )	prvUnblockCoRoutineFromISR( &( ( pxStreamBuffer )->xCoRoutinesWaitingToSend ) )
+	#define sbCO_ROUTINES_ARE_WAITING( pxStreamBuffer )					( ( listLIST_IS_EMPTY( &( ( pxStreamBuffer )->xCoRoutinesWaitingToReceive ) ) == pdFALSE ) || ( listLIST_IS_EMPTY( &( ( pxStreamBuffer )->xCoRoutinesWaitingToSend ) ) == pdFALSE ) )
+#else
+	#define sbCO_ROUTINE_SEND_COMPLETED( pxStreamBuffer )
+	#define sbCO_ROUTINE_SEND_COMPLETE_FROM_ISR( pxStreamBuffer )
+	#define sbCO_ROUTINE_RECEIVE_COMPLETED( pxStreamBuffer )
+	#define sbCO_ROUTINE_RECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer )
+	#define sbCO_ROUTINES_ARE_WAITING( pxStreamBuffer )					( pdFALSE )
+#endif
+
 /* The number of bytes used to hold the length of a message in the buffer. */
 #define sbBYTES_TO_STORE_MESSAGE_LENGTH ( sizeof( configMESSAGE_BUFFER_LENGTH_TYPE ) )
 
@@ -152,6 +211,11 @@ typedef struct StreamBufferDef_t /*lint !e9058 Style convention uses tag. */
 	#if ( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxStreamBufferNumber;		/* Used for tracing purposes. */
 	#endif
+
+	#if ( configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS == 1 )
+		List_t xCoRoutinesWaitingToReceive;		/* Co-routines blocked waiting for data. */
+		List_t xCoRoutinesWaitingToSend;		/* Co-routines blocked waiting for space. */
+	#endif
 } StreamBuffer_t;
 
 /*
@@ -160,12 +224,12 @@ typedef struct StreamBufferDef_t /*lint !e9058 Style convention uses tag. */
 static size_t prvBytesInBuffer( const StreamBuffer_t * const pxStreamBuffer ) PRIVILEGED_FUNCTION;
 
 /*
- * Add xCount bytes from pucData into the pxStreamBuffer message buffer.
- * Returns the number of bytes written, which will either equal xCount in the
- * success case, or 0 if there was not enough space in the buffer (in which case
- * no data is written into the buffer).
+ * Copy xCount bytes from pucData into the pxStreamBuffer message buffer,
+ * starting at index xHead.  Returns the index that follows the bytes written.
+ * The head itself is not updated, so the caller can make everything it has
+ * written visible to the reader in one go.
  */
-static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer, const uint8_t *pucData, size_t xCount ) PRIVILEGED_FUNCTION;
+static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer, const uint8_t *pucData, size_t xCount, size_t xHead ) PRIVILEGED_FUNCTION;
 
 /*
  * If the stream buffer is being used as a message buffer, then reads an entire
@@ -202,6 +266,67 @@ static size_t prvReadBytesFromBuffer( StreamBuffer_t *pxStreamBuffer,
 									  size_t xMaxCount,
 									  size_t xBytesAvailable ) PRIVILEGED_FUNCTION;
 
+/*
+ * If the stream buffer is being used as a message buffer, then reserves space
+ * for an entire message, leaving room in front of it for the message length.
+ * If the stream buffer is being used as a stream buffer then reserves as many
+ * bytes as possible.  The reserved bytes are described by pxRegion.
+ */
+static size_t prvReserveMessageInBuffer( const StreamBuffer_t * const pxStreamBuffer,
+										 StreamBufferRegion_t * const pxRegion,
+										 size_t xDataLengthBytes,
+										 size_t xSpace,
+										 size_t xRequiredSpace ) PRIVILEGED_FUNCTION;
+
+/*
+ * Makes xDataLengthBytes bytes previously reserved by
+ * prvReserveMessageInBuffer() available to the reader, writing the message
+ * length first if the stream buffer is being used as a message buffer.
+ */
+static size_t prvCommitMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
+										size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
+
+/*
+ * If the stream buffer is being used as a message buffer, then describes the
+ * next message in pxRegion.  If the stream buffer is being used as a stream
+ * buffer then describes all the bytes in the buffer.  Nothing is removed from
+ * the buffer.
+ */
+static size_t prvAcquireMessageFromBuffer( StreamBuffer_t * const pxStreamBuffer,
+										   StreamBufferRegion_t * const pxRegion,
+										   size_t xBytesAvailable,
+										   size_t xBytesToStoreMessageLength ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes xDataLengthBytes bytes previously acquired by
+ * prvAcquireMessageFromBuffer() from the buffer, along with the message length
+ * if the stream buffer is being used as a message buffer.
+ */
+static size_t prvReleaseMessageFromBuffer( StreamBuffer_t * const pxStreamBuffer,
+										   size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the length of the next message in a message buffer, without removing
+ * it.  There must be a message in the buffer.
+ */
+static size_t prvPeekMessageLength( const StreamBuffer_t * const pxStreamBuffer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes xCount bytes from the pxStreamBuffer stream buffer without reading
+ * them.
+ */
+static void prvSkipBytesInBuffer( StreamBuffer_t * const pxStreamBuffer, size_t xCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Describes the xCount bytes starting at index xIndex of the buffer's data
+ * storage area as up to two spans, the second of which is only used if the
+ * bytes wrap around to the start of the storage area.
+ */
+static void prvGetBufferRegion( const StreamBuffer_t * const pxStreamBuffer,
+								StreamBufferRegion_t * const pxRegion,
+								size_t xIndex,
+								size_t xCount ) PRIVILEGED_FUNCTION;
+
 /*
  * Called by both pxStreamBufferCreate() and pxStreamBufferCreateStatic() to
  * initialise the members of the newly created stream buffer structure.
@@ -212,6 +337,20 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 										  size_t xTriggerLevelBytes,
 										  uint8_t ucFlags ) PRIVILEGED_FUNCTION;
 
+#if( configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS == 1 )
+
+	/*
+	 * Move the highest priority co-routine waiting in pxEventList, if there is
+	 * one, to the co-routine pending ready list.  Returns pdTRUE if that
+	 * co-routine has a priority equal to or higher than the calling co-routine.
+	 * Called from tasks and co-routines, and from interrupts using the FromISR
+	 * version.
+	 */
+	static BaseType_t prvUnblockCoRoutine( List_t * const pxEventList ) PRIVILEGED_FUNCTION;
+	static void prvUnblockCoRoutineFromISR( List_t * const pxEventList ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /*-----------------------------------------------------------*/
 
 #if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
@@ -413,7 +552,7 @@ BaseType_t xReturn = pdFAIL;
 	{
 		if( pxStreamBuffer->xTaskWaitingToReceive == NULL )
 		{
-			if( pxStreamBuffer->xTaskWaitingToSend == NULL )
+			if( ( pxStreamBuffer->xTaskWaitingToSend == NULL ) && ( sbCO_ROUTINES_ARE_WAITING( pxStreamBuffer ) == pdFALSE ) )
 			{
 				prvInitialiseNewStreamBuffer( pxStreamBuffer,
 											  pxStreamBuffer->pucBuffer,
@@ -474,8 +613,8 @@ size_t xSpace;
 
 	configASSERT( pxStreamBuffer );
 
-	xSpace = pxStreamBuffer->xLength + pxStreamBuffer->xTail;
-	xSpace -= pxStreamBuffer->xHead;
+	xSpace = pxStreamBuffer->xLength + sbLOAD_INDEX( pxStreamBuffer->xTail );
+	xSpace -= sbLOAD_INDEX( pxStreamBuffer->xHead );
 	xSpace -= ( size_t ) 1;
 
 	if( xSpace >= pxStreamBuffer->xLength )
@@ -532,7 +671,15 @@ TimeOut_t xTimeOut;
 		mtCOVERAGE_TEST_MARKER();
 	}
 
-	if( xTicksToWait != ( TickType_t ) 0 )
+	#if( configUSE_LOCK_FREE_STREAM_BUFFERS == 1 )
+	{
+		/* The space can be checked without a critical section, so one is only
+		entered below if the task might have to wait. */
+		xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+	}
+	#endif
+
+	if( ( xTicksToWait != ( TickType_t ) 0 ) && ( xSpace < xRequiredSpace ) )
 	{
 		vTaskSetTimeOutState( &xTimeOut );
 
@@ -591,6 +738,7 @@ TimeOut_t xTimeOut;
 		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
 		{
 			sbSEND_COMPLETED( pxStreamBuffer );
+			sbCO_ROUTINE_SEND_COMPLETED( pxStreamBuffer );
 		}
 		else
 		{
@@ -641,6 +789,7 @@ size_t xRequiredSpace = xDataLengthBytes;
 		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
 		{
 			sbSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+			sbCO_ROUTINE_SEND_COMPLETE_FROM_ISR( pxStreamBuffer );
 		}
 		else
 		{
@@ -665,7 +814,7 @@ static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
 									   size_t xRequiredSpace )
 {
 	BaseType_t xShouldWrite;
-	size_t xReturn;
+	size_t xReturn, xNextHead = pxStreamBuffer->xHead;
 
 	if( xSpace == ( size_t ) 0 )
 	{
@@ -688,7 +837,7 @@ static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
 		into the buffer.  Start by writing the length of the data, the data
 		itself will be written later in this function. */
 		xShouldWrite = pdTRUE;
-		( void ) prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) &( xDataLengthBytes ), sbBYTES_TO_STORE_MESSAGE_LENGTH );
+		xNextHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) &( xDataLengthBytes ), sbBYTES_TO_STORE_MESSAGE_LENGTH, xNextHead );
 	}
 	else
 	{
@@ -698,8 +847,11 @@ static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
 
 	if( xShouldWrite != pdFALSE )
 	{
-		/* Writes the data itself. */
-		xReturn = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) pvTxData, xDataLengthBytes ); /*lint !e9079 Storage buffer is implemented as uint8_t for ease of sizing, alighment and access. */
+		/* Writes the data itself, then moves the head so the reader sees the
+		whole message at once. */
+		xNextHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) pvTxData, xDataLengthBytes, xNextHead ); /*lint !e9079 Storage buffer is implemented as uint8_t for ease of sizing, alighment and access. */
+		sbSTORE_INDEX( pxStreamBuffer->xHead, xNextHead );
+		xReturn = xDataLengthBytes;
 	}
 	else
 	{
@@ -710,194 +862,140 @@ static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
 }
 /*-----------------------------------------------------------*/
 
-size_t xStreamBufferReceive( StreamBufferHandle_t xStreamBuffer,
-							 void *pvRxData,
-							 size_t xBufferLengthBytes,
-							 TickType_t xTicksToWait )
+size_t xStreamBufferSendReserve( StreamBufferHandle_t xStreamBuffer,
+								 size_t xDataLengthBytes,
+								 StreamBufferRegion_t * const pxRegion,
+								 TickType_t xTicksToWait )
 {
 StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
-size_t xReceivedLength = 0, xBytesAvailable, xBytesToStoreMessageLength;
+size_t xSpace = 0;
+size_t xRequiredSpace = xDataLengthBytes;
+TimeOut_t xTimeOut;
 
-	configASSERT( pvRxData );
+	configASSERT( pxRegion );
 	configASSERT( pxStreamBuffer );
 
-	/* This receive function is used by both message buffers, which store
-	discrete messages, and stream buffers, which store a continuous stream of
-	bytes.  Discrete messages include an additional
-	sbBYTES_TO_STORE_MESSAGE_LENGTH bytes that hold the length of the
-	message. */
+	/* As per xStreamBufferSend(), a message buffer also needs space to hold
+	the length of the message, which is written when the message is
+	committed. */
 	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
 	{
-		xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+		xRequiredSpace += sbBYTES_TO_STORE_MESSAGE_LENGTH;
+
+		/* Overflow? */
+		configASSERT( xRequiredSpace > xDataLengthBytes );
 	}
 	else
 	{
-		xBytesToStoreMessageLength = 0;
+		mtCOVERAGE_TEST_MARKER();
 	}
 
-	if( xTicksToWait != ( TickType_t ) 0 )
+	#if( configUSE_LOCK_FREE_STREAM_BUFFERS == 1 )
 	{
-		/* Checking if there is data and clearing the notification state must be
-		performed atomically. */
-		taskENTER_CRITICAL();
-		{
-			xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+		/* The space can be checked without a critical section, so one is only
+		entered below if the task might have to wait. */
+		xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+	}
+	#endif
 
-			/* If this function was invoked by a message buffer read then
-			xBytesToStoreMessageLength holds the number of bytes used to hold
-			the length of the next discrete message.  If this function was
-			invoked by a stream buffer read then xBytesToStoreMessageLength will
-			be 0. */
-			if( xBytesAvailable <= xBytesToStoreMessageLength )
-			{
-				/* Clear notification state as going to wait for data. */
-				( void ) xTaskNotifyStateClear( NULL );
+	if( ( xTicksToWait != ( TickType_t ) 0 ) && ( xSpace < xRequiredSpace ) )
+	{
+		vTaskSetTimeOutState( &xTimeOut );
 
-				/* Should only be one reader. */
-				configASSERT( pxStreamBuffer->xTaskWaitingToReceive == NULL );
-				pxStreamBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
-			}
-			else
+		do
+		{
+			/* Wait until the required number of bytes are free in the
+			buffer. */
+			taskENTER_CRITICAL();
 			{
-				mtCOVERAGE_TEST_MARKER();
+				xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+
+				if( xSpace < xRequiredSpace )
+				{
+					/* Clear notification state as going to wait for space. */
+					( void ) xTaskNotifyStateClear( NULL );
+
+					/* Should only be one writer. */
+					configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
+					pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
+				}
+				else
+				{
+					taskEXIT_CRITICAL();
+					break;
+				}
 			}
-		}
-		taskEXIT_CRITICAL();
+			taskEXIT_CRITICAL();
 
-		if( xBytesAvailable <= xBytesToStoreMessageLength )
-		{
-			/* Wait for data to be available. */
-			traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer );
+			traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer );
 			( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
-			pxStreamBuffer->xTaskWaitingToReceive = NULL;
+			pxStreamBuffer->xTaskWaitingToSend = NULL;
 
-			/* Recheck the data available after blocking. */
-			xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
-		}
-		else
-		{
-			mtCOVERAGE_TEST_MARKER();
-		}
+		} while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
 	}
 	else
 	{
-		xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+		mtCOVERAGE_TEST_MARKER();
 	}
 
-	/* Whether receiving a discrete message (where xBytesToStoreMessageLength
-	holds the number of bytes used to store the message length) or a stream of
-	bytes (where xBytesToStoreMessageLength is zero), the number of bytes
-	available must be greater than xBytesToStoreMessageLength to be able to
-	read bytes from the buffer. */
-	if( xBytesAvailable > xBytesToStoreMessageLength )
+	if( xSpace == ( size_t ) 0 )
 	{
-		xReceivedLength = prvReadMessageFromBuffer( pxStreamBuffer, pvRxData, xBufferLengthBytes, xBytesAvailable, xBytesToStoreMessageLength );
-
-		/* Was a task waiting for space in the buffer? */
-		if( xReceivedLength != ( size_t ) 0 )
-		{
-			traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReceivedLength );
-			sbRECEIVE_COMPLETED( pxStreamBuffer );
-		}
-		else
-		{
-			mtCOVERAGE_TEST_MARKER();
-		}
+		xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
 	}
 	else
 	{
-		traceSTREAM_BUFFER_RECEIVE_FAILED( xStreamBuffer );
 		mtCOVERAGE_TEST_MARKER();
 	}
 
-	return xReceivedLength;
+	return prvReserveMessageInBuffer( pxStreamBuffer, pxRegion, xDataLengthBytes, xSpace, xRequiredSpace );
 }
 /*-----------------------------------------------------------*/
 
-size_t xStreamBufferNextMessageLengthBytes( StreamBufferHandle_t xStreamBuffer )
+size_t xStreamBufferSendReserveFromISR( StreamBufferHandle_t xStreamBuffer,
+										size_t xDataLengthBytes,
+										StreamBufferRegion_t * const pxRegion )
 {
 StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
-size_t xReturn, xBytesAvailable, xOriginalTail;
-configMESSAGE_BUFFER_LENGTH_TYPE xTempReturn;
+size_t xSpace;
+size_t xRequiredSpace = xDataLengthBytes;
 
+	configASSERT( pxRegion );
 	configASSERT( pxStreamBuffer );
 
-	/* Ensure the stream buffer is being used as a message buffer. */
 	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
 	{
-		xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
-		if( xBytesAvailable > sbBYTES_TO_STORE_MESSAGE_LENGTH )
-		{
-			/* The number of bytes available is greater than the number of bytes
-			required to hold the length of the next message, so another message
-			is available.  Return its length without removing the length bytes
-			from the buffer.  A copy of the tail is stored so the buffer can be
-			returned to its prior state as the message is not actually being
-			removed from the buffer. */
-			xOriginalTail = pxStreamBuffer->xTail;
-			( void ) prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempReturn, sbBYTES_TO_STORE_MESSAGE_LENGTH, xBytesAvailable );
-			xReturn = ( size_t ) xTempReturn;
-			pxStreamBuffer->xTail = xOriginalTail;
-		}
-		else
-		{
-			/* The minimum amount of bytes in a message buffer is
-			( sbBYTES_TO_STORE_MESSAGE_LENGTH + 1 ), so if xBytesAvailable is
-			less than sbBYTES_TO_STORE_MESSAGE_LENGTH the only other valid
-			value is 0. */
-			configASSERT( xBytesAvailable == 0 );
-			xReturn = 0;
-		}
+		xRequiredSpace += sbBYTES_TO_STORE_MESSAGE_LENGTH;
 	}
 	else
 	{
-		xReturn = 0;
+		mtCOVERAGE_TEST_MARKER();
 	}
 
-	return xReturn;
+	xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+
+	return prvReserveMessageInBuffer( pxStreamBuffer, pxRegion, xDataLengthBytes, xSpace, xRequiredSpace );
 }
 /*-----------------------------------------------------------*/
 
-size_t xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer,
-									void *pvRxData,
-									size_t xBufferLengthBytes,
-									BaseType_t * const pxHigherPriorityTaskWoken )
+size_t xStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer,
+								size_t xDataLengthBytes )
 {
 StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
-size_t xReceivedLength = 0, xBytesAvailable, xBytesToStoreMessageLength;
+size_t xReturn;
 
-	configASSERT( pvRxData );
 	configASSERT( pxStreamBuffer );
 
-	/* This receive function is used by both message buffers, which store
-	discrete messages, and stream buffers, which store a continuous stream of
-	bytes.  Discrete messages include an additional
-	sbBYTES_TO_STORE_MESSAGE_LENGTH bytes that hold the length of the
-	message. */
-	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
-	{
-		xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
-	}
-	else
-	{
-		xBytesToStoreMessageLength = 0;
-	}
-
-	xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+	xReturn = prvCommitMessageToBuffer( pxStreamBuffer, xDataLengthBytes );
 
-	/* Whether receiving a discrete message (where xBytesToStoreMessageLength
-	holds the number of bytes used to store the message length) or a stream of
-	bytes (where xBytesToStoreMessageLength is zero), the number of bytes
-	available must be greater than xBytesToStoreMessageLength to be able to
-	read bytes from the buffer. */
-	if( xBytesAvailable > xBytesToStoreMessageLength )
+	if( xReturn > ( size_t ) 0 )
 	{
-		xReceivedLength = prvReadMessageFromBuffer( pxStreamBuffer, pvRxData, xBufferLengthBytes, xBytesAvailable, xBytesToStoreMessageLength );
+		traceSTREAM_BUFFER_SEND( xStreamBuffer, xReturn );
 
-		/* Was a task waiting for space in the buffer? */
-		if( xReceivedLength != ( size_t ) 0 )
+		/* Was a task waiting for the data? */
+		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
 		{
-			sbRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+			sbSEND_COMPLETED( pxStreamBuffer );
+			sbCO_ROUTINE_SEND_COMPLETED( pxStreamBuffer );
 		}
 		else
 		{
@@ -909,44 +1007,28 @@ size_t xReceivedLength = 0, xBytesAvailable, xBytesToStoreMessageLength;
 		mtCOVERAGE_TEST_MARKER();
 	}
 
-	traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength );
-
-	return xReceivedLength;
+	return xReturn;
 }
 /*-----------------------------------------------------------*/
 
-static size_t prvReadMessageFromBuffer( StreamBuffer_t *pxStreamBuffer,
-										void *pvRxData,
-										size_t xBufferLengthBytes,
-										size_t xBytesAvailable,
-										size_t xBytesToStoreMessageLength )
+size_t xStreamBufferSendCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+									   size_t xDataLengthBytes,
+									   BaseType_t * const pxHigherPriorityTaskWoken )
 {
-size_t xOriginalTail, xReceivedLength, xNextMessageLength;
-configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReturn;
 
-	if( xBytesToStoreMessageLength != ( size_t ) 0 )
-	{
-		/* A discrete message is being received.  First receive the length
-		of the message.  A copy of the tail is stored so the buffer can be
-		returned to its prior state if the length of the message is too
-		large for the provided buffer. */
-		xOriginalTail = pxStreamBuffer->xTail;
-		( void ) prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempNextMessageLength, xBytesToStoreMessageLength, xBytesAvailable );
-		xNextMessageLength = ( size_t ) xTempNextMessageLength;
+	configASSERT( pxStreamBuffer );
 
-		/* Reduce the number of bytes available by the number of bytes just
-		read out. */
-		xBytesAvailable -= xBytesToStoreMessageLength;
+	xReturn = prvCommitMessageToBuffer( pxStreamBuffer, xDataLengthBytes );
 
-		/* Check there is enough space in the buffer provided by the
-		user. */
-		if( xNextMessageLength > xBufferLengthBytes )
+	if( xReturn > ( size_t ) 0 )
+	{
+		/* Was a task waiting for the data? */
+		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
 		{
-			/* The user has provided insufficient space to read the message
-			so return the buffer to its previous state (so the length of
-			the message is in the buffer again). */
-			pxStreamBuffer->xTail = xOriginalTail;
-			xNextMessageLength = 0;
+			sbSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+			sbCO_ROUTINE_SEND_COMPLETE_FROM_ISR( pxStreamBuffer );
 		}
 		else
 		{
@@ -955,15 +1037,578 @@ configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
 	}
 	else
 	{
-		/* A stream of bytes is being received (as opposed to a discrete
-		message), so read as many bytes as possible. */
-		xNextMessageLength = xBufferLengthBytes;
+		mtCOVERAGE_TEST_MARKER();
 	}
 
-	/* Read the actual data. */
-	xReceivedLength = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) pvRxData, xNextMessageLength, xBytesAvailable ); /*lint !e9079 Data storage area is implemented as uint8_t array for ease of sizing, indexing and alignment. */
+	traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xReturn );
 
-	return xReceivedLength;
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvReserveMessageInBuffer( const StreamBuffer_t * const pxStreamBuffer,
+										 StreamBufferRegion_t * const pxRegion,
+										 size_t xDataLengthBytes,
+										 size_t xSpace,
+										 size_t xRequiredSpace )
+{
+size_t xReturn;
+
+	if( xSpace == ( size_t ) 0 )
+	{
+		/* Doesn't matter if this is a stream buffer or a message buffer, there
+		is no space to reserve. */
+		xReturn = 0;
+	}
+	else if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 )
+	{
+		/* This is a stream buffer so reserve as many bytes as possible,
+		starting at the head. */
+		xReturn = configMIN( xDataLengthBytes, xSpace );
+		prvGetBufferRegion( pxStreamBuffer, pxRegion, pxStreamBuffer->xHead, xReturn );
+	}
+	else if( xSpace >= xRequiredSpace )
+	{
+		/* This is a message buffer with enough space for both the length and
+		the message.  The length is not known until the message is committed,
+		so leave room for it at the head and reserve the bytes that follow. */
+		xReturn = xDataLengthBytes;
+		prvGetBufferRegion( pxStreamBuffer, pxRegion, pxStreamBuffer->xHead + sbBYTES_TO_STORE_MESSAGE_LENGTH, xReturn );
+	}
+	else
+	{
+		/* There is space available, but not enough space. */
+		xReturn = 0;
+	}
+
+	if( xReturn == ( size_t ) 0 )
+	{
+		prvGetBufferRegion( pxStreamBuffer, pxRegion, pxStreamBuffer->xHead, 0 );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvCommitMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
+										size_t xDataLengthBytes )
+{
+size_t xNextHead = pxStreamBuffer->xHead;
+
+	if( xDataLengthBytes > ( size_t ) 0 )
+	{
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+		{
+			/* The message itself was written in place by the caller, so only
+			the length remains to be written in front of it. */
+			configASSERT( xStreamBufferSpacesAvailable( pxStreamBuffer ) >= ( xDataLengthBytes + sbBYTES_TO_STORE_MESSAGE_LENGTH ) );
+			xNextHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) &( xDataLengthBytes ), sbBYTES_TO_STORE_MESSAGE_LENGTH, xNextHead );
+		}
+		else
+		{
+			configASSERT( xStreamBufferSpacesAvailable( pxStreamBuffer ) >= xDataLengthBytes );
+		}
+
+		/* Move the head past the bytes written in place to make them
+		available to the reader. */
+		xNextHead += xDataLengthBytes;
+		if( xNextHead >= pxStreamBuffer->xLength )
+		{
+			xNextHead -= pxStreamBuffer->xLength;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		sbSTORE_INDEX( pxStreamBuffer->xHead, xNextHead );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xDataLengthBytes;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceive( StreamBufferHandle_t xStreamBuffer,
+							 void *pvRxData,
+							 size_t xBufferLengthBytes,
+							 TickType_t xTicksToWait )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReceivedLength = 0, xBytesAvailable, xBytesToStoreMessageLength;
+
+	configASSERT( pvRxData );
+	configASSERT( pxStreamBuffer );
+
+	/* This receive function is used by both message buffers, which store
+	discrete messages, and stream buffers, which store a continuous stream of
+	bytes.  Discrete messages include an additional
+	sbBYTES_TO_STORE_MESSAGE_LENGTH bytes that hold the length of the
+	message. */
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+	}
+	else
+	{
+		xBytesToStoreMessageLength = 0;
+	}
+
+	#if( configUSE_LOCK_FREE_STREAM_BUFFERS == 1 )
+	{
+		/* The data can be checked without a critical section, so one is only
+		entered below if the task might have to wait. */
+		xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+	}
+	#else
+	{
+		xBytesAvailable = 0;
+	}
+	#endif
+
+	if( ( xTicksToWait != ( TickType_t ) 0 ) && ( xBytesAvailable <= xBytesToStoreMessageLength ) )
+	{
+		/* Checking if there is data and clearing the notification state must be
+		performed atomically. */
+		taskENTER_CRITICAL();
+		{
+			xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+			/* If this function was invoked by a message buffer read then
+			xBytesToStoreMessageLength holds the number of bytes used to hold
+			the length of the next discrete message.  If this function was
+			invoked by a stream buffer read then xBytesToStoreMessageLength will
+			be 0. */
+			if( xBytesAvailable <= xBytesToStoreMessageLength )
+			{
+				/* Clear notification state as going to wait for data. */
+				( void ) xTaskNotifyStateClear( NULL );
+
+				/* Should only be one reader. */
+				configASSERT( pxStreamBuffer->xTaskWaitingToReceive == NULL );
+				pxStreamBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( xBytesAvailable <= xBytesToStoreMessageLength )
+		{
+			/* Wait for data to be available. */
+			traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer );
+			( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+			pxStreamBuffer->xTaskWaitingToReceive = NULL;
+
+			/* Recheck the data available after blocking. */
+			xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+	}
+
+	/* Whether receiving a discrete message (where xBytesToStoreMessageLength
+	holds the number of bytes used to store the message length) or a stream of
+	bytes (where xBytesToStoreMessageLength is zero), the number of bytes
+	available must be greater than xBytesToStoreMessageLength to be able to
+	read bytes from the buffer. */
+	if( xBytesAvailable > xBytesToStoreMessageLength )
+	{
+		xReceivedLength = prvReadMessageFromBuffer( pxStreamBuffer, pvRxData, xBufferLengthBytes, xBytesAvailable, xBytesToStoreMessageLength );
+
+		/* Was a task waiting for space in the buffer? */
+		if( xReceivedLength != ( size_t ) 0 )
+		{
+			traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReceivedLength );
+			sbRECEIVE_COMPLETED( pxStreamBuffer );
+			sbCO_ROUTINE_RECEIVE_COMPLETED( pxStreamBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		traceSTREAM_BUFFER_RECEIVE_FAILED( xStreamBuffer );
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReceivedLength;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferNextMessageLengthBytes( StreamBufferHandle_t xStreamBuffer )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReturn, xBytesAvailable;
+
+	configASSERT( pxStreamBuffer );
+
+	/* Ensure the stream buffer is being used as a message buffer. */
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+		if( xBytesAvailable > sbBYTES_TO_STORE_MESSAGE_LENGTH )
+		{
+			/* The number of bytes available is greater than the number of bytes
+			required to hold the length of the next message, so another message
+			is available.  Return its length without removing the length bytes
+			from the buffer. */
+			xReturn = prvPeekMessageLength( pxStreamBuffer );
+		}
+		else
+		{
+			/* The minimum amount of bytes in a message buffer is
+			( sbBYTES_TO_STORE_MESSAGE_LENGTH + 1 ), so if xBytesAvailable is
+			less than sbBYTES_TO_STORE_MESSAGE_LENGTH the only other valid
+			value is 0. */
+			configASSERT( xBytesAvailable == 0 );
+			xReturn = 0;
+		}
+	}
+	else
+	{
+		xReturn = 0;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer,
+									void *pvRxData,
+									size_t xBufferLengthBytes,
+									BaseType_t * const pxHigherPriorityTaskWoken )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReceivedLength = 0, xBytesAvailable, xBytesToStoreMessageLength;
+
+	configASSERT( pvRxData );
+	configASSERT( pxStreamBuffer );
+
+	/* This receive function is used by both message buffers, which store
+	discrete messages, and stream buffers, which store a continuous stream of
+	bytes.  Discrete messages include an additional
+	sbBYTES_TO_STORE_MESSAGE_LENGTH bytes that hold the length of the
+	message. */
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+	}
+	else
+	{
+		xBytesToStoreMessageLength = 0;
+	}
+
+	xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+	/* Whether receiving a discrete message (where xBytesToStoreMessageLength
+	holds the number of bytes used to store the message length) or a stream of
+	bytes (where xBytesToStoreMessageLength is zero), the number of bytes
+	available must be greater than xBytesToStoreMessageLength to be able to
+	read bytes from the buffer. */
+	if( xBytesAvailable > xBytesToStoreMessageLength )
+	{
+		xReceivedLength = prvReadMessageFromBuffer( pxStreamBuffer, pvRxData, xBufferLengthBytes, xBytesAvailable, xBytesToStoreMessageLength );
+
+		/* Was a task waiting for space in the buffer? */
+		if( xReceivedLength != ( size_t ) 0 )
+		{
+			sbRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+			sbCO_ROUTINE_RECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength );
+
+	return xReceivedLength;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvReadMessageFromBuffer( StreamBuffer_t *pxStreamBuffer,
+										void *pvRxData,
+										size_t xBufferLengthBytes,
+										size_t xBytesAvailable,
+										size_t xBytesToStoreMessageLength )
+{
+size_t xReceivedLength, xNextMessageLength;
+
+	if( xBytesToStoreMessageLength != ( size_t ) 0 )
+	{
+		/* A discrete message is being received.  First obtain the length of
+		the message.  The length is only removed from the buffer once it is
+		known the message will fit in the buffer provided by the user, as
+		moving the tail makes the space available to the writer. */
+		xNextMessageLength = prvPeekMessageLength( pxStreamBuffer );
+
+		/* Check there is enough space in the buffer provided by the
+		user. */
+		if( xNextMessageLength > xBufferLengthBytes )
+		{
+			/* The user has provided insufficient space to read the message,
+			so leave the message in the buffer. */
+			xNextMessageLength = 0;
+		}
+		else
+		{
+			/* Remove the length, then reduce the number of bytes available
+			by the number of bytes just removed. */
+			prvSkipBytesInBuffer( pxStreamBuffer, xBytesToStoreMessageLength );
+			xBytesAvailable -= xBytesToStoreMessageLength;
+		}
+	}
+	else
+	{
+		/* A stream of bytes is being received (as opposed to a discrete
+		message), so read as many bytes as possible. */
+		xNextMessageLength = xBufferLengthBytes;
+	}
+
+	/* Read the actual data. */
+	xReceivedLength = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) pvRxData, xNextMessageLength, xBytesAvailable ); /*lint !e9079 Data storage area is implemented as uint8_t array for ease of sizing, indexing and alignment. */
+
+	return xReceivedLength;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer,
+									StreamBufferRegion_t * const pxRegion,
+									TickType_t xTicksToWait )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xBytesAvailable, xBytesToStoreMessageLength;
+
+	configASSERT( pxRegion );
+	configASSERT( pxStreamBuffer );
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+	}
+	else
+	{
+		xBytesToStoreMessageLength = 0;
+	}
+
+	#if( configUSE_LOCK_FREE_STREAM_BUFFERS == 1 )
+	{
+		/* The data can be checked without a critical section, so one is only
+		entered below if the task might have to wait. */
+		xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+	}
+	#else
+	{
+		xBytesAvailable = 0;
+	}
+	#endif
+
+	if( ( xTicksToWait != ( TickType_t ) 0 ) && ( xBytesAvailable <= xBytesToStoreMessageLength ) )
+	{
+		/* Checking if there is data and clearing the notification state must be
+		performed atomically. */
+		taskENTER_CRITICAL();
+		{
+			xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+			if( xBytesAvailable <= xBytesToStoreMessageLength )
+			{
+				/* Clear notification state as going to wait for data. */
+				( void ) xTaskNotifyStateClear( NULL );
+
+				/* Should only be one reader. */
+				configASSERT( pxStreamBuffer->xTaskWaitingToReceive == NULL );
+				pxStreamBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( xBytesAvailable <= xBytesToStoreMessageLength )
+		{
+			/* Wait for data to be available. */
+			traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer );
+			( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+			pxStreamBuffer->xTaskWaitingToReceive = NULL;
+
+			/* Recheck the data available after blocking. */
+			xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+	}
+
+	return prvAcquireMessageFromBuffer( pxStreamBuffer, pxRegion, xBytesAvailable, xBytesToStoreMessageLength );
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceiveAcquireFromISR( StreamBufferHandle_t xStreamBuffer,
+										   StreamBufferRegion_t * const pxRegion )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xBytesToStoreMessageLength;
+
+	configASSERT( pxRegion );
+	configASSERT( pxStreamBuffer );
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+	}
+	else
+	{
+		xBytesToStoreMessageLength = 0;
+	}
+
+	return prvAcquireMessageFromBuffer( pxStreamBuffer, pxRegion, prvBytesInBuffer( pxStreamBuffer ), xBytesToStoreMessageLength );
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceiveRelease( StreamBufferHandle_t xStreamBuffer,
+									size_t xDataLengthBytes )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReceivedLength;
+
+	configASSERT( pxStreamBuffer );
+
+	xReceivedLength = prvReleaseMessageFromBuffer( pxStreamBuffer, xDataLengthBytes );
+
+	/* Was a task waiting for space in the buffer? */
+	if( xReceivedLength != ( size_t ) 0 )
+	{
+		traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReceivedLength );
+		sbRECEIVE_COMPLETED( pxStreamBuffer );
+		sbCO_ROUTINE_RECEIVE_COMPLETED( pxStreamBuffer );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReceivedLength;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceiveReleaseFromISR( StreamBufferHandle_t xStreamBuffer,
+										   size_t xDataLengthBytes,
+										   BaseType_t * const pxHigherPriorityTaskWoken )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReceivedLength;
+
+	configASSERT( pxStreamBuffer );
+
+	xReceivedLength = prvReleaseMessageFromBuffer( pxStreamBuffer, xDataLengthBytes );
+
+	/* Was a task waiting for space in the buffer? */
+	if( xReceivedLength != ( size_t ) 0 )
+	{
+		sbRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+		sbCO_ROUTINE_RECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength );
+
+	return xReceivedLength;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvAcquireMessageFromBuffer( StreamBuffer_t * const pxStreamBuffer,
+										   StreamBufferRegion_t * const pxRegion,
+										   size_t xBytesAvailable,
+										   size_t xBytesToStoreMessageLength )
+{
+size_t xNextMessageLength;
+
+	if( xBytesAvailable <= xBytesToStoreMessageLength )
+	{
+		/* Nothing to acquire. */
+		xNextMessageLength = 0;
+		prvGetBufferRegion( pxStreamBuffer, pxRegion, pxStreamBuffer->xTail, 0 );
+	}
+	else if( xBytesToStoreMessageLength != ( size_t ) 0 )
+	{
+		/* A discrete message is being acquired.  Return the bytes that follow
+		its length.  Nothing is removed until the message is released. */
+		xNextMessageLength = prvPeekMessageLength( pxStreamBuffer );
+		prvGetBufferRegion( pxStreamBuffer, pxRegion, pxStreamBuffer->xTail + xBytesToStoreMessageLength, xNextMessageLength );
+	}
+	else
+	{
+		/* A stream of bytes is being acquired, so return everything that is
+		in the buffer. */
+		xNextMessageLength = xBytesAvailable;
+		prvGetBufferRegion( pxStreamBuffer, pxRegion, pxStreamBuffer->xTail, xNextMessageLength );
+	}
+
+	return xNextMessageLength;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvReleaseMessageFromBuffer( StreamBuffer_t * const pxStreamBuffer,
+										   size_t xDataLengthBytes )
+{
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		/* A message can only be released as a whole, so xDataLengthBytes must
+		be the length returned when the message was acquired.  The stored
+		length is removed along with the message. */
+		configASSERT( xDataLengthBytes == xStreamBufferNextMessageLengthBytes( pxStreamBuffer ) );
+
+		if( xDataLengthBytes != ( size_t ) 0 )
+		{
+			prvSkipBytesInBuffer( pxStreamBuffer, xDataLengthBytes + sbBYTES_TO_STORE_MESSAGE_LENGTH );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		/* Any number of the acquired bytes can be released. */
+		xDataLengthBytes = configMIN( xDataLengthBytes, prvBytesInBuffer( pxStreamBuffer ) );
+		prvSkipBytesInBuffer( pxStreamBuffer, xDataLengthBytes );
+	}
+
+	return xDataLengthBytes;
 }
 /*-----------------------------------------------------------*/
 
@@ -1085,13 +1730,212 @@ UBaseType_t uxSavedInterruptStatus;
 }
 /*-----------------------------------------------------------*/
 
-static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer, const uint8_t *pucData, size_t xCount )
+#if( configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS == 1 )
+
+	BaseType_t xStreamBufferCRSend( StreamBufferHandle_t xStreamBuffer,
+									const void *pvTxData,
+									size_t xDataLengthBytes,
+									size_t *pxBytesSent,
+									TickType_t xTicksToWait )
+	{
+	StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+	BaseType_t xReturn;
+	size_t xSpace, xRequiredSpace = xDataLengthBytes;
+
+		configASSERT( pvTxData );
+		configASSERT( pxStreamBuffer );
+		configASSERT( pxBytesSent );
+
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+		{
+			xRequiredSpace += sbBYTES_TO_STORE_MESSAGE_LENGTH;
+			configASSERT( xRequiredSpace < pxStreamBuffer->xLength );
+		}
+		else if( xRequiredSpace >= pxStreamBuffer->xLength )
+		{
+			/* The data can never fit in one go, so only wait for the buffer to
+			be empty, then write as much as fits. */
+			xRequiredSpace = pxStreamBuffer->xLength - ( size_t ) 1;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		*pxBytesSent = 0;
+
+		/* If there is not enough space we may have to block.  Interrupts are
+		disabled so space cannot be made by an interrupt between the check and
+		the co-routine being placed in the event list. */
+		portDISABLE_INTERRUPTS();
+		{
+			xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+
+			if( ( xSpace < xRequiredSpace ) && ( xTicksToWait > ( TickType_t ) 0 ) )
+			{
+				/* As this is a co-routine we cannot block directly, but return
+				indicating that we need to block. */
+				vCoRoutineAddToDelayedList( xTicksToWait, &( pxStreamBuffer->xCoRoutinesWaitingToSend ) );
+				xReturn = errQUEUE_BLOCKED;
+			}
+			else
+			{
+				xReturn = pdPASS;
+			}
+		}
+		portENABLE_INTERRUPTS();
+
+		if( xReturn == pdPASS )
+		{
+			/* Write as much as fits, as xStreamBufferSend() does once its
+			block time has expired.  There is only one writer, so the space
+			cannot have reduced since it was checked. */
+			*pxBytesSent = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
+
+			if( *pxBytesSent > ( size_t ) 0 )
+			{
+				traceSTREAM_BUFFER_SEND( xStreamBuffer, *pxBytesSent );
+
+				/* Was a task or co-routine waiting for the data? */
+				if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+				{
+					sbSEND_COMPLETED( pxStreamBuffer );
+
+					if( prvUnblockCoRoutine( &( pxStreamBuffer->xCoRoutinesWaitingToReceive ) ) != pdFALSE )
+					{
+						xReturn = errQUEUE_YIELD;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				traceSTREAM_BUFFER_SEND_FAILED( xStreamBuffer );
+				xReturn = errQUEUE_FULL;
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS == 1 )
+
+	BaseType_t xStreamBufferCRReceive( StreamBufferHandle_t xStreamBuffer,
+									   void *pvRxData,
+									   size_t xBufferLengthBytes,
+									   size_t *pxBytesReceived,
+									   TickType_t xTicksToWait )
+	{
+	StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+	BaseType_t xReturn;
+	size_t xBytesAvailable, xBytesToStoreMessageLength;
+
+		configASSERT( pvRxData );
+		configASSERT( pxStreamBuffer );
+		configASSERT( pxBytesReceived );
+
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+		{
+			xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+		}
+		else
+		{
+			xBytesToStoreMessageLength = 0;
+		}
+
+		*pxBytesReceived = 0;
+
+		/* If the buffer is empty we may have to block.  Interrupts are disabled
+		so data cannot be written by an interrupt between the check and the
+		co-routine being placed in the event list. */
+		portDISABLE_INTERRUPTS();
+		{
+			xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+			if( xBytesAvailable > xBytesToStoreMessageLength )
+			{
+				xReturn = pdPASS;
+			}
+			else if( xTicksToWait > ( TickType_t ) 0 )
+			{
+				/* As this is a co-routine we cannot block directly, but return
+				indicating that we need to block. */
+				vCoRoutineAddToDelayedList( xTicksToWait, &( pxStreamBuffer->xCoRoutinesWaitingToReceive ) );
+				xReturn = errQUEUE_BLOCKED;
+			}
+			else
+			{
+				xReturn = errQUEUE_EMPTY;
+			}
+		}
+		portENABLE_INTERRUPTS();
+
+		if( xReturn == pdPASS )
+		{
+			*pxBytesReceived = prvReadMessageFromBuffer( pxStreamBuffer, pvRxData, xBufferLengthBytes, xBytesAvailable, xBytesToStoreMessageLength );
+
+			/* Was a task or co-routine waiting for space in the buffer? */
+			if( *pxBytesReceived != ( size_t ) 0 )
+			{
+				traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, *pxBytesReceived );
+				sbRECEIVE_COMPLETED( pxStreamBuffer );
+
+				if( prvUnblockCoRoutine( &( pxStreamBuffer->xCoRoutinesWaitingToSend ) ) != pdFALSE )
+				{
+					xReturn = errQUEUE_YIELD;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				/* The next message did not fit in pvRxData. */
+				xReturn = errQUEUE_EMPTY;
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( xReturn == errQUEUE_EMPTY )
+		{
+			traceSTREAM_BUFFER_RECEIVE_FAILED( xStreamBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS */
+/*-----------------------------------------------------------*/
+
+static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer, const uint8_t *pucData, size_t xCount, size_t xHead )
 {
 size_t xNextHead, xFirstLength;
 
 	configASSERT( xCount > ( size_t ) 0 );
 
-	xNextHead = pxStreamBuffer->xHead;
+	xNextHead = xHead;
 
 	/* Calculate the number of bytes that can be added in the first write -
 	which may be less than the total number of bytes that need to be added if
@@ -1125,9 +1969,7 @@ size_t xNextHead, xFirstLength;
 		mtCOVERAGE_TEST_MARKER();
 	}
 
-	pxStreamBuffer->xHead = xNextHead;
-
-	return xCount;
+	return xNextHead;
 }
 /*-----------------------------------------------------------*/
 
@@ -1175,7 +2017,7 @@ size_t xCount, xFirstLength, xNextTail;
 			xNextTail -= pxStreamBuffer->xLength;
 		}
 
-		pxStreamBuffer->xTail = xNextTail;
+		sbSTORE_INDEX( pxStreamBuffer->xTail, xNextTail );
 	}
 	else
 	{
@@ -1186,13 +2028,58 @@ size_t xCount, xFirstLength, xNextTail;
 }
 /*-----------------------------------------------------------*/
 
+static size_t prvPeekMessageLength( const StreamBuffer_t * const pxStreamBuffer )
+{
+configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
+size_t xTail, xFirstLength;
+
+	/* The tail is not moved, so the writer cannot reuse the space that holds
+	the length while it is being read. */
+	xTail = pxStreamBuffer->xTail;
+	xFirstLength = configMIN( pxStreamBuffer->xLength - xTail, sbBYTES_TO_STORE_MESSAGE_LENGTH );
+	( void ) memcpy( ( void * ) &xTempNextMessageLength, ( const void * ) &( pxStreamBuffer->pucBuffer[ xTail ] ), xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+
+	/* Is the length split across the end and the start of the buffer? */
+	if( xFirstLength < sbBYTES_TO_STORE_MESSAGE_LENGTH )
+	{
+		( void ) memcpy( ( void * ) &( ( ( uint8_t * ) &xTempNextMessageLength )[ xFirstLength ] ), ( const void * ) pxStreamBuffer->pucBuffer, sbBYTES_TO_STORE_MESSAGE_LENGTH - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return ( size_t ) xTempNextMessageLength;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSkipBytesInBuffer( StreamBuffer_t * const pxStreamBuffer, size_t xCount )
+{
+size_t xNextTail;
+
+	configASSERT( xCount <= prvBytesInBuffer( pxStreamBuffer ) );
+
+	xNextTail = pxStreamBuffer->xTail + xCount;
+	if( xNextTail >= pxStreamBuffer->xLength )
+	{
+		xNextTail -= pxStreamBuffer->xLength;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	sbSTORE_INDEX( pxStreamBuffer->xTail, xNextTail );
+}
+/*-----------------------------------------------------------*/
+
 static size_t prvBytesInBuffer( const StreamBuffer_t * const pxStreamBuffer )
 {
 /* Returns the distance between xTail and xHead. */
 size_t xCount;
 
-	xCount = pxStreamBuffer->xLength + pxStreamBuffer->xHead;
-	xCount -= pxStreamBuffer->xTail;
+	xCount = pxStreamBuffer->xLength + sbLOAD_INDEX( pxStreamBuffer->xHead );
+	xCount -= sbLOAD_INDEX( pxStreamBuffer->xTail );
 	if ( xCount >= pxStreamBuffer->xLength )
 	{
 		xCount -= pxStreamBuffer->xLength;
@@ -1206,6 +2093,46 @@ size_t xCount;
 }
 /*-----------------------------------------------------------*/
 
+static void prvGetBufferRegion( const StreamBuffer_t * const pxStreamBuffer,
+								StreamBufferRegion_t * const pxRegion,
+								size_t xIndex,
+								size_t xCount )
+{
+size_t xFirstLength;
+
+	/* xIndex may be up to sbBYTES_TO_STORE_MESSAGE_LENGTH past the end of the
+	buffer when skipping over the length of a message. */
+	if( xIndex >= pxStreamBuffer->xLength )
+	{
+		xIndex -= pxStreamBuffer->xLength;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	configASSERT( xCount < pxStreamBuffer->xLength );
+
+	/* The first span runs from xIndex up to, at most, the end of the buffer.
+	Anything left over wraps around to the start of the buffer. */
+	xFirstLength = configMIN( pxStreamBuffer->xLength - xIndex, xCount );
+
+	pxRegion->pucFirst = &( pxStreamBuffer->pucBuffer[ xIndex ] );
+	pxRegion->xFirstLengthBytes = xFirstLength;
+
+	if( xCount > xFirstLength )
+	{
+		pxRegion->pucSecond = pxStreamBuffer->pucBuffer;
+		pxRegion->xSecondLengthBytes = xCount - xFirstLength;
+	}
+	else
+	{
+		pxRegion->pucSecond = NULL;
+		pxRegion->xSecondLengthBytes = 0;
+	}
+}
+/*-----------------------------------------------------------*/
+
 static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 										  uint8_t * const pucBuffer,
 										  size_t xBufferSizeBytes,
@@ -1230,7 +2157,84 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 	pxStreamBuffer->xLength = xBufferSizeBytes;
 	pxStreamBuffer->xTriggerLevelBytes = xTriggerLevelBytes;
 	pxStreamBuffer->ucFlags = ucFlags;
+
+	#if( configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS == 1 )
+	{
+		vListInitialise( &( pxStreamBuffer->xCoRoutinesWaitingToReceive ) );
+		vListInitialise( &( pxStreamBuffer->xCoRoutinesWaitingToSend ) );
+	}
+	#endif
 }
+/*-----------------------------------------------------------*/
+
+#if( configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS == 1 )
+
+	static BaseType_t prvUnblockCoRoutine( List_t * const pxEventList )
+	{
+	BaseType_t xReturn = pdFALSE;
+
+		/* A co-routine is only placed in the event list with interrupts
+		disabled, after finding the stream buffer empty or full, so the list
+		can be tested before entering the critical section in the same way as
+		sbTASK_MAY_BE_WAITING() tests the waiting task. */
+		if( listLIST_IS_EMPTY( pxEventList ) == pdFALSE )
+		{
+			taskENTER_CRITICAL();
+			{
+				/* The co-routine may have timed out since the list was tested. */
+				if( listLIST_IS_EMPTY( pxEventList ) == pdFALSE )
+				{
+					xReturn = xCoRoutineRemoveFromEventList( pxEventList );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS == 1 )
+
+	static void prvUnblockCoRoutineFromISR( List_t * const pxEventList )
+	{
+	UBaseType_t uxSavedInterruptStatus;
+
+		if( listLIST_IS_EMPTY( pxEventList ) == pdFALSE )
+		{
+			uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+			{
+				if( listLIST_IS_EMPTY( pxEventList ) == pdFALSE )
+				{
+					/* Co-routines run from a task, so there is no context
+					switch to request here whatever the priority of the
+					co-routine. */
+					( void ) xCoRoutineRemoveFromEventList( pxEventList );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS */
 
 #if ( configUSE_TRACE_FACILITY == 1 )
 
@@ -38,6 +38,7 @@ task.h is included from an application file. */
 #include "FreeRTOS.h"
 #include "task.h"
 #include "timers.h"
+#include "event_groups.h"
 #include "stack_macros.h"
 
 /* Lint e9021, e961 and e750 are suppressed as a MISRA exception justified
@@ -64,7 +65,7 @@ functions but without including stdio.h here. */
 	#define taskYIELD_IF_USING_PREEMPTION() portYIELD_WITHIN_API()
 #endif
 
-/* Values that can be assigned to the ucNotifyState member of the TCB. */
+/* Values that can be assigned to the ucNotifyState members of the TCB. */
 #define taskNOT_WAITING_NOTIFICATION	( ( uint8_t ) 0 )
 #define taskWAITING_NOTIFICATION		( ( uint8_t ) 1 )
 #define taskNOTIFICATION_RECEIVED		( ( uint8_t ) 2 )
@@ -83,12 +84,21 @@ functions but without including stdio.h here. */
 /* If any of the following are set then task stacks are filled with a known
 value so the high water mark can be determined.  If none of the following are
 set then don't fill the stack so there is no unnecessary dependency on memset. */
-#if( ( configCHECK_FOR_STACK_OVERFLOW > 1 ) || ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) )
+#if( ( configCHECK_FOR_STACK_OVERFLOW > 1 ) || ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) || ( configUSE_STACK_WATERMARK_TRACKING == 1 ) )
 	#define tskSET_NEW_STACKS_TO_KNOWN_VALUE	1
 #else
 	#define tskSET_NEW_STACKS_TO_KNOWN_VALUE	0
 #endif
 
+/* Allocates the stack of a task created using xTaskCreate(), from a heap_5.c
+region with the capabilities set by configTASK_STACK_HEAP_CAPABILITIES if
+configUSE_HEAP_REGION_CAPABILITIES is set to 1. */
+#if( configUSE_HEAP_REGION_CAPABILITIES == 1 )
+	#define tskMALLOC_STACK( xSize )	pvPortMallocCaps( ( xSize ), ( uint32_t ) configTASK_STACK_HEAP_CAPABILITIES )
+#else
+	#define tskMALLOC_STACK( xSize )	pvPortMalloc( xSize )
+#endif
+
 /*
  * Macros used by vListTask to indicate which state a task is in.
  */
@@ -112,7 +122,75 @@ configIDLE_TASK_NAME in FreeRTOSConfig.h. */
 	#define configIDLE_TASK_NAME "IDLE"
 #endif
 
-#if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+#if ( configUSE_PRIORITY_BITMAP_TASK_SELECTION == 1 )
+
+	/* If configUSE_PRIORITY_BITMAP_TASK_SELECTION is 1 then task selection is
+	performed using a two level bitmap of the priorities that have Ready state
+	tasks, which takes the same time however many priorities there are without
+	relying on an instruction particular to any microcontroller architecture.
+	Bit n of ulReadyPriorityGroups is set if any of the priorities
+	( n * 32 ) to ( ( n * 32 ) + 31 ) have Ready state tasks, and
+	ulReadyPriorities[ n ] has a bit set for each of those priorities that
+	does. */
+	#define taskPRIORITY_GROUP_BITS		( 32U )
+	#define taskPRIORITY_GROUPS			( ( configMAX_PRIORITIES + taskPRIORITY_GROUP_BITS - 1U ) / taskPRIORITY_GROUP_BITS )
+
+	/* Obtain the position of the most significant set bit of a non-zero 32
+	bit value, using the compiler's count leading zeros builtin where one is
+	known to be available. */
+	#if defined( __GNUC__ )
+		#define taskHIGHEST_SET_BIT( ulBits )	( ( UBaseType_t ) ( ( ( sizeof( unsigned long ) * 8U ) - 1U ) - ( UBaseType_t ) __builtin_clzl( ( unsigned long ) ( ulBits ) ) ) )
+	#else
+		#define taskHIGHEST_SET_BIT( ulBits )	prvHighestSetBit( ulBits )
+	#endif
+
+	#define taskRECORD_READY_PRIORITY( uxPriority )																		\
+	{																													\
+		ulReadyPriorities[ ( uxPriority ) / taskPRIORITY_GROUP_BITS ] |= ( 1UL << ( ( uxPriority ) % taskPRIORITY_GROUP_BITS ) );	\
+		ulReadyPriorityGroups |= ( 1UL << ( ( uxPriority ) / taskPRIORITY_GROUP_BITS ) );								\
+	} /* taskRECORD_READY_PRIORITY */
+
+	/*-----------------------------------------------------------*/
+
+	#define taskSELECT_HIGHEST_PRIORITY_TASK()																		\
+	{																												\
+	UBaseType_t uxTopGroup, uxTopPriority;																			\
+																													\
+		/* Find the highest priority list that contains ready tasks. */												\
+		uxTopGroup = taskHIGHEST_SET_BIT( ulReadyPriorityGroups );													\
+		uxTopPriority = ( uxTopGroup * taskPRIORITY_GROUP_BITS ) + taskHIGHEST_SET_BIT( ulReadyPriorities[ uxTopGroup ] );	\
+		configASSERT( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ uxTopPriority ] ) ) > 0 );						\
+		listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );						\
+	} /* taskSELECT_HIGHEST_PRIORITY_TASK() */
+
+	/*-----------------------------------------------------------*/
+
+	/* Clear the bit of a priority, and the bit of its group if no other
+	priority in the group has Ready state tasks.  Named as the port macro
+	because the kernel calls it directly where it knows the ready list of the
+	priority is empty, the second parameter is not used. */
+	#define portRESET_READY_PRIORITY( uxPriority, uxTopReadyPriority )												\
+	{																												\
+		ulReadyPriorities[ ( uxPriority ) / taskPRIORITY_GROUP_BITS ] &= ~( 1UL << ( ( uxPriority ) % taskPRIORITY_GROUP_BITS ) );	\
+																													\
+		if( ulReadyPriorities[ ( uxPriority ) / taskPRIORITY_GROUP_BITS ] == 0UL )									\
+		{																											\
+			ulReadyPriorityGroups &= ~( 1UL << ( ( uxPriority ) / taskPRIORITY_GROUP_BITS ) );						\
+		}																											\
+	}
+
+	/* Only clear the bit if the TCB being reset was the last task referenced
+	from the ready list of its priority.  If it is referenced from a delayed or
+	suspended list then it won't be in a ready list. */
+	#define taskRESET_READY_PRIORITY( uxPriority )														\
+	{																									\
+		if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ ( uxPriority ) ] ) ) == ( UBaseType_t ) 0 )	\
+		{																								\
+			portRESET_READY_PRIORITY( ( uxPriority ), ( uxTopReadyPriority ) );							\
+		}																								\
+	}
+
+#elif ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
 
 	/* If configUSE_PORT_OPTIMISED_TASK_SELECTION is 0 then task selection is
 	performed in a generic way that is not optimised to any particular
@@ -193,6 +271,53 @@ configIDLE_TASK_NAME in FreeRTOSConfig.h. */
 
 /*-----------------------------------------------------------*/
 
+#if( configUSE_EDF_SCHEDULING == 1 )
+
+	/* Tasks of priority configEDF_TASK_PRIORITY are run in order of their
+	absolute deadlines rather than in turn, so a task entering the Ready state
+	at that priority must also preempt a running task of that priority that has
+	a later deadline. */
+	#define taskPREEMPTS_CURRENT_TASK( pxTCB )																	\
+		( ( ( pxTCB )->uxPriority > pxCurrentTCB->uxPriority ) ||													\
+		  ( ( ( pxTCB )->uxPriority == ( UBaseType_t ) configEDF_TASK_PRIORITY ) &&								\
+			( pxCurrentTCB->uxPriority == ( UBaseType_t ) configEDF_TASK_PRIORITY ) &&							\
+			( prvIsDeadlineEarlier( ( pxTCB ), pxCurrentTCB ) != pdFALSE ) ) )
+
+	/* True if tick count xA is later than tick count xB, allowing for the tick
+	count overflowing between the two.  Only valid while the two are less than
+	half the range of TickType_t apart. */
+	#define taskTICK_IS_AFTER( xA, xB )	( ( TickType_t ) ( ( xB ) - ( xA ) ) > ( portMAX_DELAY >> 1 ) )
+
+#else
+
+	#define taskPREEMPTS_CURRENT_TASK( pxTCB )	( ( pxTCB )->uxPriority > pxCurrentTCB->uxPriority )
+
+#endif /* configUSE_EDF_SCHEDULING */
+
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STACK_WATERMARK_TRACKING == 1 )
+
+	/* A stack word that has never been written still holds tskSTACK_FILL_BYTE
+	in each of its bytes. */
+	#define taskSTACK_FILL_WORD		( ( StackType_t ) ( ( ( StackType_t ) ~( StackType_t ) 0 / ( StackType_t ) 0xffU ) * ( StackType_t ) tskSTACK_FILL_BYTE ) )
+
+	#if( portSTACK_GROWTH < 0 )
+		#define taskTRACKED_FREE_STACK_SPACE( pxTCB )	( ( configSTACK_DEPTH_TYPE ) ( ( pxTCB )->pxStackWatermark - ( pxTCB )->pxStack ) )
+	#else
+		#define taskTRACKED_FREE_STACK_SPACE( pxTCB )	( ( configSTACK_DEPTH_TYPE ) ( ( pxTCB )->pxEndOfStack - ( pxTCB )->pxStackWatermark ) )
+	#endif
+
+	#define taskUPDATE_STACK_WATERMARK( pxTCB )	prvUpdateStackWatermark( pxTCB )
+
+#else
+
+	#define taskUPDATE_STACK_WATERMARK( pxTCB )
+
+#endif /* configUSE_STACK_WATERMARK_TRACKING */
+
+/*-----------------------------------------------------------*/
+
 /* pxDelayedTaskList and pxOverflowDelayedTaskList are switched when the tick
 count overflows. */
 #define taskSWITCH_DELAYED_LISTS()																	\
@@ -211,6 +336,36 @@ count overflows. */
 
 /*-----------------------------------------------------------*/
 
+/* When configUSE_DELAYED_TASK_HEAP is set to 1 the delayed task lists are not
+held in wake time order.  Instead the tasks in each delayed list are also linked
+into a pairing heap, ordered by wake time, that is used to find the next task to
+unblock.  Adding a task to a delayed list is then O(1), rather than O(n) in the
+number of blocked tasks, and removing a task is O(log n) amortised.  The delayed
+lists are still used to record the state of each task, so a task that might be
+in a delayed list must be removed from its state list using
+taskREMOVE_STATE_LIST_ITEM() to ensure it is also removed from the heap. */
+#if( configUSE_DELAYED_TASK_HEAP == 1 )
+
+	#define taskDELAYED_TASK_HEAP( pxList ) ( ( ( pxList ) == &xDelayedTaskList1 ) ? &pxDelayedTaskHeap1 : &pxDelayedTaskHeap2 )
+
+	#define taskINSERT_DELAYED_TASK( pxList, pxTCB )												\
+	{																							\
+		vListInsertEnd( ( pxList ), &( ( pxTCB )->xStateListItem ) );							\
+		prvDelayedTaskHeapInsert( taskDELAYED_TASK_HEAP( pxList ), ( pxTCB ) );					\
+	}
+
+	#define taskGET_NEXT_DELAYED_TASK()			( *taskDELAYED_TASK_HEAP( pxDelayedTaskList ) )
+	#define taskREMOVE_STATE_LIST_ITEM( pxTCB )	prvRemoveStateListItem( pxTCB )
+
+#else
+
+	#define taskINSERT_DELAYED_TASK( pxList, pxTCB )	vListInsert( ( pxList ), &( ( pxTCB )->xStateListItem ) )
+	#define taskGET_NEXT_DELAYED_TASK()					listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList ) /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+	#define taskREMOVE_STATE_LIST_ITEM( pxTCB )			uxListRemove( &( ( pxTCB )->xStateListItem ) )
+
+#endif /* configUSE_DELAYED_TASK_HEAP */
+/*-----------------------------------------------------------*/
+
 /*
  * Place the task represented by pxTCB into the appropriate ready list for
  * the task.  It is inserted at the end of the list.
@@ -219,9 +374,45 @@ count overflows. */
 	traceMOVED_TASK_TO_READY_STATE( pxTCB );														\
 	taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );												\
 	vListInsertEnd( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) ); \
+	taskCHECK_TIME_SLICE_DEADLINE( pxTCB );															\
 	tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB )
 /*-----------------------------------------------------------*/
 
+#if( configUSE_DYNAMIC_TICK == 1 )
+
+	/* The tick count is only moved forward when the one-shot tick timer
+	expires, so bring it up to date with the time that has actually passed
+	before it is used as the reference for a timeout or block time. */
+	#define taskGET_TICK_COUNT()	prvCatchUpTicks()
+
+	#if( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
+
+		/* A task that enters the Ready state at the priority of the running
+		task shares processing time with it, so the tick timer must expire at
+		the end of the current time slice rather than at the next unblock
+		time.  If the scheduler is suspended the deadline is re-calculated
+		when the scheduler is resumed. */
+		#define taskCHECK_TIME_SLICE_DEADLINE( pxTCB )																	\
+		{																												\
+			if( ( xSchedulerRunning != pdFALSE ) && ( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE ) && ( ( pxTCB )->uxPriority == pxCurrentTCB->uxPriority ) )	\
+			{																											\
+				portSET_TICK_DEADLINE( ( TickType_t ) 1 );																\
+			}																											\
+		}
+
+	#endif
+
+#else
+
+	#define taskGET_TICK_COUNT()	xTickCount
+
+#endif /* configUSE_DYNAMIC_TICK */
+
+#ifndef taskCHECK_TIME_SLICE_DEADLINE
+	#define taskCHECK_TIME_SLICE_DEADLINE( pxTCB )
+#endif
+/*-----------------------------------------------------------*/
+
 /*
  * Several functions take an TaskHandle_t parameter that can optionally be NULL,
  * where NULL is used to indicate that the handle of the currently executing
@@ -263,7 +454,7 @@ typedef struct tskTaskControlBlock 			/* The old naming convention is used to pr
 	StackType_t			*pxStack;			/*< Points to the start of the stack. */
 	char				pcTaskName[ configMAX_TASK_NAME_LEN ];/*< Descriptive name given to the task when created.  Facilitates debugging only. */ /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
 
-	#if ( ( portSTACK_GROWTH > 0 ) || ( configRECORD_STACK_HIGH_ADDRESS == 1 ) )
+	#if ( ( portSTACK_GROWTH > 0 ) || ( configRECORD_STACK_HIGH_ADDRESS == 1 ) || ( configUSE_STACK_WATERMARK_TRACKING == 1 ) )
 		StackType_t		*pxEndOfStack;		/*< Points to the highest valid address for the stack. */
 	#endif
 
@@ -308,8 +499,8 @@ typedef struct tskTaskControlBlock 			/* The old naming convention is used to pr
 	#endif
 
 	#if( configUSE_TASK_NOTIFICATIONS == 1 )
-		volatile uint32_t ulNotifiedValue;
-		volatile uint8_t ucNotifyState;
+		volatile uint32_t ulNotifiedValue[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
+		volatile uint8_t ucNotifyState[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
 	#endif
 
 	/* See the comments in FreeRTOS.h with the definition of
@@ -326,12 +517,53 @@ typedef struct tskTaskControlBlock 			/* The old naming convention is used to pr
 		int iTaskErrno;
 	#endif
 
+	#if( configUSE_DELAYED_TASK_HEAP == 1 )
+		struct tskTaskControlBlock *pxDelayedHeapChild;		/*< The first child of the task in the delayed task heap. */
+		struct tskTaskControlBlock *pxDelayedHeapSibling;	/*< The next sibling of the task in the delayed task heap. */
+		struct tskTaskControlBlock *pxDelayedHeapPrevious;	/*< The parent of the task if it is a first child, otherwise its previous sibling. */
+	#endif
+
+	#if( configUSE_EDF_SCHEDULING == 1 )
+		TickType_t		xRelativeDeadline;	/*< The time from the release of each job of the task to its deadline, or 0 if the task does not have a deadline. */
+		TickType_t		xAbsoluteDeadline;	/*< The tick count by which the current job of the task must complete. */
+		uint32_t		ulDeadlineMisses;	/*< The number of jobs of the task that completed after their deadline. */
+	#endif
+
+	#if( configUSE_STACK_WATERMARK_TRACKING == 1 )
+		StackType_t		*pxStackWatermark;	/*< The deepest stack word the task is known to have used, updated each time the task is switched out. */
+	#endif
+
+	#if( configUSE_TASK_POOLS == 1 )
+		struct tskTaskPool	*pxTaskPool;	/*< The pool to which the TCB and stack are returned when the task is deleted, or NULL if the task was not created from a pool. */
+	#endif
+
 } tskTCB;
 
 /* The old tskTCB name is maintained above then typedefed to the new TCB_t name
 below to enable the use of older kernel aware debuggers. */
 typedef tskTCB TCB_t;
 
+#if( configUSE_TASK_POOLS == 1 )
+
+	/* A pool of TCBs, each with its stack, from which tasks are created
+	without allocating memory.  See xTaskPoolCreate(). */
+	typedef struct tskTaskPool
+	{
+		List_t					xFreeTasks;			/*< The TCBs that are not in use, each referenced by its xStateListItem. */
+		configSTACK_DEPTH_TYPE	usStackDepth;		/*< The size of each stack in the pool, in words. */
+		BaseType_t				xFillStackOnReuse;	/*< pdTRUE if a stack is filled with tskSTACK_FILL_BYTE each time it is reused. */
+	} TaskPool_t;
+
+	/* A stack taken from a pool that does not refill its stacks was filled
+	when the pool was created. */
+	#define taskSTACK_FILL_REQUIRED( pxTCB )	( ( ( pxTCB )->pxTaskPool == NULL ) || ( ( pxTCB )->pxTaskPool->xFillStackOnReuse != pdFALSE ) )
+
+#else
+
+	#define taskSTACK_FILL_REQUIRED( pxTCB )	( pdTRUE )
+
+#endif /* configUSE_TASK_POOLS */
+
 /*lint -save -e956 A manual analysis and inspection has been used to determine
 which static variables must be declared volatile. */
 PRIVILEGED_DATA TCB_t * volatile pxCurrentTCB = NULL;
@@ -347,6 +579,13 @@ PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;				/*< Points to the
 PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;		/*< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
 PRIVILEGED_DATA static List_t xPendingReadyList;						/*< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
 
+#if( configUSE_DELAYED_TASK_HEAP == 1 )
+
+	PRIVILEGED_DATA static TCB_t *pxDelayedTaskHeap1 = NULL;			/*< Root of the heap that orders the tasks in xDelayedTaskList1 by wake time. */
+	PRIVILEGED_DATA static TCB_t *pxDelayedTaskHeap2 = NULL;			/*< Root of the heap that orders the tasks in xDelayedTaskList2 by wake time. */
+
+#endif
+
 #if( INCLUDE_vTaskDelete == 1 )
 
 	PRIVILEGED_DATA static List_t xTasksWaitingTermination;				/*< Tasks that have been deleted - but their memory not yet freed. */
@@ -367,9 +606,14 @@ the errno of the currently running task. */
 #endif
 
 /* Other file private variables. --------------------------------*/
+#if( configUSE_PRIORITY_BITMAP_TASK_SELECTION == 1 )
+	PRIVILEGED_DATA static volatile uint32_t ulReadyPriorityGroups 		= 0UL;
+	PRIVILEGED_DATA static volatile uint32_t ulReadyPriorities[ taskPRIORITY_GROUPS ] = { 0UL };
+#else
+	PRIVILEGED_DATA static volatile UBaseType_t uxTopReadyPriority 		= tskIDLE_PRIORITY;
+#endif
 PRIVILEGED_DATA static volatile UBaseType_t uxCurrentNumberOfTasks 	= ( UBaseType_t ) 0U;
 PRIVILEGED_DATA static volatile TickType_t xTickCount 				= ( TickType_t ) configINITIAL_TICK_COUNT;
-PRIVILEGED_DATA static volatile UBaseType_t uxTopReadyPriority 		= tskIDLE_PRIORITY;
 PRIVILEGED_DATA static volatile BaseType_t xSchedulerRunning 		= pdFALSE;
 PRIVILEGED_DATA static volatile TickType_t xPendedTicks 			= ( TickType_t ) 0U;
 PRIVILEGED_DATA static volatile BaseType_t xYieldPending 			= pdFALSE;
@@ -472,12 +716,52 @@ static portTASK_FUNCTION_PROTO( prvIdleTask, pvParameters );
  */
 static void prvCheckTasksWaitingTermination( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * Used by xTaskCreateFromPool() when the pool is empty.  Looks for a task from
+ * the pool that deleted itself and is waiting for the idle task to clean it
+ * up.  If one is found it is cleaned up now, which returns its TCB and stack
+ * to the pool.  Tasks from other pools, and tasks that were not created from a
+ * pool, are left for the idle task.
+ */
+#if( configUSE_TASK_POOLS == 1 )
+
+	static void prvReclaimTaskFromPool( TaskPool_t *pxTaskPool ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /*
  * The currently executing task is entering the Blocked state.  Add the task to
  * either the current or the overflow delayed task list.
  */
 static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait, const BaseType_t xCanBlockIndefinitely ) PRIVILEGED_FUNCTION;
 
+#if( configUSE_DELAYED_TASK_HEAP == 1 )
+
+	/*
+	 * Add a task to, or remove a task from, the pairing heap rooted at
+	 * *ppxRoot.  The task's state list item value holds its wake time.
+	 */
+	static void prvDelayedTaskHeapInsert( TCB_t **ppxRoot, TCB_t *pxTCB ) PRIVILEGED_FUNCTION;
+	static void prvDelayedTaskHeapRemove( TCB_t **ppxRoot, TCB_t *pxTCB ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Helpers for the above.  prvDelayedTaskHeapLink() makes the root with the
+	 * later wake time the first child of the other root, and returns the new
+	 * root.  prvDelayedTaskHeapMergePairs() combines a list of siblings into a
+	 * single heap.
+	 */
+	static TCB_t *prvDelayedTaskHeapLink( TCB_t *pxFirst, TCB_t *pxSecond ) PRIVILEGED_FUNCTION;
+	static TCB_t *prvDelayedTaskHeapMergePairs( TCB_t *pxFirstSibling ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Remove pxTCB from whichever list its state list item is in, first
+	 * removing it from the delayed task heap if that list is a delayed list.
+	 * Returns the number of items that remain in the list, as uxListRemove().
+	 */
+	static UBaseType_t prvRemoveStateListItem( TCB_t *pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /*
  * Fills an TaskStatus_t structure with information on each task that is
  * referenced from the pxList list (which may be a ready list, a delayed list,
@@ -534,6 +818,82 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait, const BaseT
  */
 static void prvResetNextTaskUnblockTime( void );
 
+#if( configUSE_STACK_WATERMARK_TRACKING == 1 )
+
+	/*
+	 * Called when a task is switched out to move its stack watermark, the
+	 * deepest stack word it is known to have written, past any stack it has
+	 * used since it was last switched out.
+	 */
+	static void prvUpdateStackWatermark( TCB_t *pxTCB ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Fill in a TaskStackUsage_t structure for each task referenced from pxList.
+	 * Used by uxTaskGetStackUsage().
+	 */
+	static UBaseType_t prvListStackUsageWithinSingleList( TaskStackUsage_t *pxStackUsageArray, List_t *pxList, UBaseType_t uxMarginPercent ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if( configUSE_EDF_SCHEDULING == 1 )
+
+	/*
+	 * Return pdTRUE if the current job of the task pointed to by pxTCB should
+	 * run before the current job of the task pointed to by pxOtherTCB.  Tasks
+	 * without a deadline, which are only normally at configEDF_TASK_PRIORITY
+	 * because they have inherited it, run before tasks that have one.
+	 */
+	static BaseType_t prvIsDeadlineEarlier( const TCB_t * const pxTCB, const TCB_t * const pxOtherTCB ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Called by vTaskSwitchContext() when the highest priority Ready state
+	 * tasks are of priority configEDF_TASK_PRIORITY, to select the one with
+	 * the earliest deadline.
+	 */
+	static void prvSelectEarliestDeadlineTask( void ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if( ( configUSE_PRIORITY_BITMAP_TASK_SELECTION == 1 ) && !defined( __GNUC__ ) )
+
+	/*
+	 * Return the position of the most significant set bit in ulBits, which
+	 * must not be zero.  Used to search the ready priority bitmap when the
+	 * compiler does not provide a count leading zeros builtin.
+	 */
+	static UBaseType_t prvHighestSetBit( uint32_t ulBits ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if( configUSE_DYNAMIC_TICK == 1 )
+
+	/*
+	 * Move the tick count forward by up to xTicks without processing any
+	 * ticks.  The tick count is never moved as far as xNextTaskUnblockTime, or
+	 * past the point at which it overflows, as those ticks must be processed
+	 * by xTaskIncrementTick().  Returns the number of ticks by which the tick
+	 * count was moved.  Must be called with interrupts masked and the
+	 * scheduler not suspended.
+	 */
+	static TickType_t prvStepTickCount( TickType_t xTicks ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Move the tick count forward to account for the whole tick periods that
+	 * have passed since the tick timer last expired, as far as is possible
+	 * without processing a tick, then return the tick count.
+	 */
+	static TickType_t prvCatchUpTicks( void ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Arm the port's one-shot tick timer to expire at the next time the
+	 * kernel has work to do - either the next time a task leaves the Blocked
+	 * state or the end of the running task's time slice.  Must be called with
+	 * interrupts masked.
+	 */
+	static void prvSetTickDeadline( void ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_DYNAMIC_TICK */
+
 #if ( ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
 
 	/*
@@ -563,6 +923,17 @@ static void prvInitialiseNewTask( 	TaskFunction_t pxTaskCode,
  */
 static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	/*
+	 * Allocate a TCB and a stack of usStackDepth words, in the order that stops
+	 * the stack growing into the TCB.  Returns NULL if either could not be
+	 * allocated.
+	 */
+	static TCB_t *prvAllocateTCBAndStack( const configSTACK_DEPTH_TYPE usStackDepth ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /*
  * freertos_tasks_c_additions_init() should only be called if the user definable
  * macro FREERTOS_TASKS_C_ADDITIONS_INIT() is defined, as that is the only macro
@@ -619,6 +990,13 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 			}
 			#endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
 
+			#if( configUSE_TASK_POOLS == 1 )
+			{
+				/* The task was not created from a task pool. */
+				pxNewTCB->pxTaskPool = NULL;
+			}
+			#endif /* configUSE_TASK_POOLS */
+
 			prvInitialiseNewTask( pxTaskCode, pcName, ulStackDepth, pvParameters, uxPriority, &xReturn, pxNewTCB, NULL );
 			prvAddNewTaskToReadyList( pxNewTCB );
 		}
@@ -661,6 +1039,13 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 			}
 			#endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
 
+			#if( configUSE_TASK_POOLS == 1 )
+			{
+				/* The task was not created from a task pool. */
+				pxNewTCB->pxTaskPool = NULL;
+			}
+			#endif /* configUSE_TASK_POOLS */
+
 			prvInitialiseNewTask(	pxTaskDefinition->pvTaskCode,
 									pxTaskDefinition->pcName,
 									( uint32_t ) pxTaskDefinition->usStackDepth,
@@ -709,6 +1094,13 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 				}
 				#endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
 
+				#if( configUSE_TASK_POOLS == 1 )
+				{
+					/* The task was not created from a task pool. */
+					pxNewTCB->pxTaskPool = NULL;
+				}
+				#endif /* configUSE_TASK_POOLS */
+
 				prvInitialiseNewTask(	pxTaskDefinition->pvTaskCode,
 										pxTaskDefinition->pcName,
 										( uint32_t ) pxTaskDefinition->usStackDepth,
@@ -730,15 +1122,9 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 
 #if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
 
-	BaseType_t xTaskCreate(	TaskFunction_t pxTaskCode,
-							const char * const pcName,		/*lint !e971 Unqualified char types are allowed for strings and single characters only. */
-							const configSTACK_DEPTH_TYPE usStackDepth,
-							void * const pvParameters,
-							UBaseType_t uxPriority,
-							TaskHandle_t * const pxCreatedTask )
+	static TCB_t *prvAllocateTCBAndStack( const configSTACK_DEPTH_TYPE usStackDepth )
 	{
 	TCB_t *pxNewTCB;
-	BaseType_t xReturn;
 
 		/* If the stack grows down then allocate the stack then the TCB so the stack
 		does not grow into the TCB.  Likewise if the stack grows up then allocate
@@ -755,7 +1141,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 				/* Allocate space for the stack used by the task being created.
 				The base of the stack memory stored in the TCB so the task can
 				be deleted later if required. */
-				pxNewTCB->pxStack = ( StackType_t * ) pvPortMalloc( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+				pxNewTCB->pxStack = ( StackType_t * ) tskMALLOC_STACK( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 
 				if( pxNewTCB->pxStack == NULL )
 				{
@@ -770,7 +1156,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 		StackType_t *pxStack;
 
 			/* Allocate space for the stack used by the task being created. */
-			pxStack = pvPortMalloc( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack and this allocation is the stack. */
+			pxStack = tskMALLOC_STACK( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack and this allocation is the stack. */
 
 			if( pxStack != NULL )
 			{
@@ -796,6 +1182,26 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 		}
 		#endif /* portSTACK_GROWTH */
 
+		return pxNewTCB;
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	BaseType_t xTaskCreate(	TaskFunction_t pxTaskCode,
+							const char * const pcName,		/*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+							const configSTACK_DEPTH_TYPE usStackDepth,
+							void * const pvParameters,
+							UBaseType_t uxPriority,
+							TaskHandle_t * const pxCreatedTask )
+	{
+	TCB_t *pxNewTCB;
+	BaseType_t xReturn;
+
+		pxNewTCB = prvAllocateTCBAndStack( usStackDepth );
+
 		if( pxNewTCB != NULL )
 		{
 			#if( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e9029 !e731 Macro has been consolidated for readability reasons. */
@@ -806,6 +1212,13 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 			}
 			#endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
 
+			#if( configUSE_TASK_POOLS == 1 )
+			{
+				/* The task was not created from a task pool. */
+				pxNewTCB->pxTaskPool = NULL;
+			}
+			#endif /* configUSE_TASK_POOLS */
+
 			prvInitialiseNewTask( pxTaskCode, pcName, ( uint32_t ) usStackDepth, pvParameters, uxPriority, pxCreatedTask, pxNewTCB, NULL );
 			prvAddNewTaskToReadyList( pxNewTCB );
 			xReturn = pdPASS;
@@ -821,56 +1234,263 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
 /*-----------------------------------------------------------*/
 
-static void prvInitialiseNewTask( 	TaskFunction_t pxTaskCode,
-									const char * const pcName,		/*lint !e971 Unqualified char types are allowed for strings and single characters only. */
-									const uint32_t ulStackDepth,
-									void * const pvParameters,
-									UBaseType_t uxPriority,
-									TaskHandle_t * const pxCreatedTask,
-									TCB_t *pxNewTCB,
-									const MemoryRegion_t * const xRegions )
-{
-StackType_t *pxTopOfStack;
-UBaseType_t x;
+#if( configUSE_TASK_POOLS == 1 )
 
-	#if( portUSING_MPU_WRAPPERS == 1 )
-		/* Should the task be created in privileged mode? */
-		BaseType_t xRunPrivileged;
-		if( ( uxPriority & portPRIVILEGE_BIT ) != 0U )
+	TaskPoolHandle_t xTaskPoolCreate( UBaseType_t uxTaskCount, configSTACK_DEPTH_TYPE usStackDepth, BaseType_t xFillStackOnReuse )
+	{
+	TaskPool_t *pxNewTaskPool;
+	TCB_t *pxTCB;
+	UBaseType_t x;
+
+		configASSERT( uxTaskCount > ( UBaseType_t ) 0 );
+
+		pxNewTaskPool = ( TaskPool_t * ) pvPortMalloc( sizeof( TaskPool_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack. */
+
+		if( pxNewTaskPool != NULL )
 		{
-			xRunPrivileged = pdTRUE;
+			vListInitialise( &( pxNewTaskPool->xFreeTasks ) );
+			pxNewTaskPool->usStackDepth = usStackDepth;
+			pxNewTaskPool->xFillStackOnReuse = xFillStackOnReuse;
+
+			for( x = ( UBaseType_t ) 0; x < uxTaskCount; x++ )
+			{
+				pxTCB = prvAllocateTCBAndStack( usStackDepth );
+
+				if( pxTCB == NULL )
+				{
+					break;
+				}
+
+				#if( tskSET_NEW_STACKS_TO_KNOWN_VALUE == 1 )
+				{
+					/* prvInitialiseNewTask() does not fill the stacks of a pool
+					that does not refill them when they are reused, so fill
+					them once now. */
+					if( xFillStackOnReuse == pdFALSE )
+					{
+						( void ) memset( pxTCB->pxStack, ( int ) tskSTACK_FILL_BYTE, ( size_t ) usStackDepth * sizeof( StackType_t ) );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif /* tskSET_NEW_STACKS_TO_KNOWN_VALUE */
+
+				pxTCB->pxTaskPool = pxNewTaskPool;
+				vListInitialiseItem( &( pxTCB->xStateListItem ) );
+				listSET_LIST_ITEM_OWNER( &( pxTCB->xStateListItem ), pxTCB );
+				vListInsertEnd( &( pxNewTaskPool->xFreeTasks ), &( pxTCB->xStateListItem ) );
+			}
+
+			if( x < uxTaskCount )
+			{
+				/* There was not enough heap for the whole pool, so free the
+				part that was allocated. */
+				while( listLIST_IS_EMPTY( &( pxNewTaskPool->xFreeTasks ) ) == pdFALSE )
+				{
+					pxTCB = listGET_OWNER_OF_HEAD_ENTRY( &( pxNewTaskPool->xFreeTasks ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					vPortFree( pxTCB->pxStack );
+					vPortFree( pxTCB );
+				}
+
+				vPortFree( pxNewTaskPool );
+				pxNewTaskPool = NULL;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
 		}
 		else
 		{
-			xRunPrivileged = pdFALSE;
+			mtCOVERAGE_TEST_MARKER();
 		}
-		uxPriority &= ~portPRIVILEGE_BIT;
-	#endif /* portUSING_MPU_WRAPPERS == 1 */
 
-	/* Avoid dependency on memset() if it is not required. */
-	#if( tskSET_NEW_STACKS_TO_KNOWN_VALUE == 1 )
-	{
-		/* Fill the stack with a known value to assist debugging. */
-		( void ) memset( pxNewTCB->pxStack, ( int ) tskSTACK_FILL_BYTE, ( size_t ) ulStackDepth * sizeof( StackType_t ) );
+		return pxNewTaskPool;
 	}
-	#endif /* tskSET_NEW_STACKS_TO_KNOWN_VALUE */
 
-	/* Calculate the top of stack address.  This depends on whether the stack
-	grows from high memory to low (as per the 80x86) or vice versa.
-	portSTACK_GROWTH is used to make the result positive or negative as required
-	by the port. */
-	#if( portSTACK_GROWTH < 0 )
-	{
-		pxTopOfStack = &( pxNewTCB->pxStack[ ulStackDepth - ( uint32_t ) 1 ] );
-		pxTopOfStack = ( StackType_t * ) ( ( ( portPOINTER_SIZE_TYPE ) pxTopOfStack ) & ( ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) ) ); /*lint !e923 !e9033 !e9078 MISRA exception.  Avoiding casts between pointers and integers is not practical.  Size differences accounted for using portPOINTER_SIZE_TYPE type.  Checked by assert(). */
+#endif /* configUSE_TASK_POOLS */
+/*-----------------------------------------------------------*/
 
-		/* Check the alignment of the calculated top of stack is correct. */
+#if( configUSE_TASK_POOLS == 1 )
+
+	BaseType_t xTaskCreateFromPool(	TaskPoolHandle_t xTaskPool,
+									TaskFunction_t pxTaskCode,
+									const char * const pcName,		/*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+									void * const pvParameters,
+									UBaseType_t uxPriority,
+									TaskHandle_t * const pxCreatedTask )
+	{
+	TaskPool_t * const pxTaskPool = xTaskPool;
+	TCB_t *pxNewTCB = NULL;
+	BaseType_t xReturn;
+
+		configASSERT( pxTaskPool );
+
+		/* Tasks from the pool that deleted themselves wait on the termination
+		list until the idle task cleans them up.  If the pool is empty then
+		clean one up now, returning it to the pool, rather than waiting for the
+		idle task to run. */
+		if( listLIST_IS_EMPTY( &( pxTaskPool->xFreeTasks ) ) != pdFALSE )
+		{
+			prvReclaimTaskFromPool( pxTaskPool );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		taskENTER_CRITICAL();
+		{
+			if( listLIST_IS_EMPTY( &( pxTaskPool->xFreeTasks ) ) == pdFALSE )
+			{
+				pxNewTCB = listGET_OWNER_OF_HEAD_ENTRY( &( pxTaskPool->xFreeTasks ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+				( void ) uxListRemove( &( pxNewTCB->xStateListItem ) );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( pxNewTCB != NULL )
+		{
+			prvInitialiseNewTask( pxTaskCode, pcName, ( uint32_t ) pxTaskPool->usStackDepth, pvParameters, uxPriority, pxCreatedTask, pxNewTCB, NULL );
+			prvAddNewTaskToReadyList( pxNewTCB );
+			xReturn = pdPASS;
+		}
+		else
+		{
+			xReturn = errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_TASK_POOLS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TASK_POOLS == 1 )
+
+	static void prvReclaimTaskFromPool( TaskPool_t *pxTaskPool )
+	{
+	const ListItem_t *pxEndMarker = listGET_END_MARKER( &xTasksWaitingTermination );
+	ListItem_t *pxIterator;
+	TCB_t *pxTCB = NULL;
+
+		/* Other tasks can create tasks from the same pool, and the idle task
+		can clean up the same list, so the task is found and removed from the
+		list in one critical section.  Whoever removes a task cleans it up. */
+		taskENTER_CRITICAL();
+		{
+			for( pxIterator = listGET_HEAD_ENTRY( &xTasksWaitingTermination ); pxIterator != pxEndMarker; pxIterator = listGET_NEXT( pxIterator ) )
+			{
+				if( ( ( TCB_t * ) listGET_LIST_ITEM_OWNER( pxIterator ) )->pxTaskPool == pxTaskPool ) /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+				{
+					pxTCB = listGET_LIST_ITEM_OWNER( pxIterator ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					--uxCurrentNumberOfTasks;
+					--uxDeletedTasksWaitingCleanUp;
+					break;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( pxTCB != NULL )
+		{
+			/* Returns the TCB and stack to the pool. */
+			prvDeleteTCB( pxTCB );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_TASK_POOLS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TASK_POOLS == 1 )
+
+	UBaseType_t uxTaskPoolGetFreeCount( TaskPoolHandle_t xTaskPool )
+	{
+	TaskPool_t * const pxTaskPool = xTaskPool;
+
+		configASSERT( pxTaskPool );
+
+		return listCURRENT_LIST_LENGTH( &( pxTaskPool->xFreeTasks ) );
+	}
+
+#endif /* configUSE_TASK_POOLS */
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseNewTask( 	TaskFunction_t pxTaskCode,
+									const char * const pcName,		/*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+									const uint32_t ulStackDepth,
+									void * const pvParameters,
+									UBaseType_t uxPriority,
+									TaskHandle_t * const pxCreatedTask,
+									TCB_t *pxNewTCB,
+									const MemoryRegion_t * const xRegions )
+{
+StackType_t *pxTopOfStack;
+UBaseType_t x;
+
+	#if( portUSING_MPU_WRAPPERS == 1 )
+		/* Should the task be created in privileged mode? */
+		BaseType_t xRunPrivileged;
+		if( ( uxPriority & portPRIVILEGE_BIT ) != 0U )
+		{
+			xRunPrivileged = pdTRUE;
+		}
+		else
+		{
+			xRunPrivileged = pdFALSE;
+		}
+		uxPriority &= ~portPRIVILEGE_BIT;
+	#endif /* portUSING_MPU_WRAPPERS == 1 */
+
+	/* Avoid dependency on memset() if it is not required. */
+	#if( tskSET_NEW_STACKS_TO_KNOWN_VALUE == 1 )
+	{
+		/* Fill the stack with a known value to assist debugging, unless it is
+		reused from a task pool that skips the fill. */
+		if( taskSTACK_FILL_REQUIRED( pxNewTCB ) )
+		{
+			( void ) memset( pxNewTCB->pxStack, ( int ) tskSTACK_FILL_BYTE, ( size_t ) ulStackDepth * sizeof( StackType_t ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* tskSET_NEW_STACKS_TO_KNOWN_VALUE */
+
+	/* Calculate the top of stack address.  This depends on whether the stack
+	grows from high memory to low (as per the 80x86) or vice versa.
+	portSTACK_GROWTH is used to make the result positive or negative as required
+	by the port. */
+	#if( portSTACK_GROWTH < 0 )
+	{
+		pxTopOfStack = &( pxNewTCB->pxStack[ ulStackDepth - ( uint32_t ) 1 ] );
+		pxTopOfStack = ( StackType_t * ) ( ( ( portPOINTER_SIZE_TYPE ) pxTopOfStack ) & ( ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) ) ); /*lint !e923 !e9033 !e9078 MISRA exception.  Avoiding casts between pointers and integers is not practical.  Size differences accounted for using portPOINTER_SIZE_TYPE type.  Checked by assert(). */
+
+		/* Check the alignment of the calculated top of stack is correct. */
 		configASSERT( ( ( ( portPOINTER_SIZE_TYPE ) pxTopOfStack & ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) == 0UL ) );
 
-		#if( configRECORD_STACK_HIGH_ADDRESS == 1 )
+		#if( ( configRECORD_STACK_HIGH_ADDRESS == 1 ) || ( configUSE_STACK_WATERMARK_TRACKING == 1 ) )
 		{
 			/* Also record the stack's high address, which may assist
-			debugging. */
+			debugging, and is needed to know the size of the stack when its
+			watermark is tracked. */
 			pxNewTCB->pxEndOfStack = pxTopOfStack;
 		}
 		#endif /* configRECORD_STACK_HIGH_ADDRESS */
@@ -989,8 +1609,8 @@ UBaseType_t x;
 
 	#if ( configUSE_TASK_NOTIFICATIONS == 1 )
 	{
-		pxNewTCB->ulNotifiedValue = 0;
-		pxNewTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+		memset( ( void * ) &( pxNewTCB->ulNotifiedValue[ 0 ] ), 0x00, sizeof( pxNewTCB->ulNotifiedValue ) );
+		memset( ( void * ) &( pxNewTCB->ucNotifyState[ 0 ] ), taskNOT_WAITING_NOTIFICATION, sizeof( pxNewTCB->ucNotifyState ) );
 	}
 	#endif
 
@@ -1009,6 +1629,14 @@ UBaseType_t x;
 	}
 	#endif
 
+	#if( configUSE_EDF_SCHEDULING == 1 )
+	{
+		pxNewTCB->xRelativeDeadline = ( TickType_t ) 0U;
+		pxNewTCB->xAbsoluteDeadline = ( TickType_t ) 0U;
+		pxNewTCB->ulDeadlineMisses = 0UL;
+	}
+	#endif
+
 	/* Initialize the TCB stack to look as if the task was already running,
 	but had been interrupted by the scheduler.  The return address is set
 	to the start of the task function. Once the stack has been initialised
@@ -1061,6 +1689,13 @@ UBaseType_t x;
 	}
 	#endif /* portUSING_MPU_WRAPPERS */
 
+	#if( configUSE_STACK_WATERMARK_TRACKING == 1 )
+	{
+		/* The initial context is the first stack the task uses. */
+		pxNewTCB->pxStackWatermark = ( StackType_t * ) pxNewTCB->pxTopOfStack;
+	}
+	#endif
+
 	if( pxCreatedTask != NULL )
 	{
 		/* Pass the handle out in an anonymous way.  The handle can be used to
@@ -1170,7 +1805,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			pxTCB = prvGetTCBFromHandle( xTaskToDelete );
 
 			/* Remove task from the ready/delayed list. */
-			if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+			if( taskREMOVE_STATE_LIST_ITEM( pxTCB ) == ( UBaseType_t ) 0 )
 			{
 				taskRESET_READY_PRIORITY( pxTCB->uxPriority );
 			}
@@ -1306,6 +1941,31 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			/* Update the wake time ready for the next call. */
 			*pxPreviousWakeTime = xTimeToWake;
 
+			#if( configUSE_EDF_SCHEDULING == 1 )
+			{
+				/* Calling this function completes the current job of the task,
+				and the next job is released at the time to wake. */
+				if( pxCurrentTCB->xRelativeDeadline != ( TickType_t ) 0U )
+				{
+					if( taskTICK_IS_AFTER( xConstTickCount, pxCurrentTCB->xAbsoluteDeadline ) )
+					{
+						traceTASK_DEADLINE_MISSED( pxCurrentTCB );
+						( pxCurrentTCB->ulDeadlineMisses )++;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					pxCurrentTCB->xAbsoluteDeadline = xTimeToWake + pxCurrentTCB->xRelativeDeadline;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configUSE_EDF_SCHEDULING */
+
 			if( xShouldDelay != pdFALSE )
 			{
 				traceTASK_DELAY_UNTIL( xTimeToWake );
@@ -1336,6 +1996,62 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 #endif /* INCLUDE_vTaskDelayUntil */
 /*-----------------------------------------------------------*/
 
+#if( configUSE_EDF_SCHEDULING == 1 )
+
+	void vTaskSetDeadline( TaskHandle_t xTask, TickType_t xRelativeDeadline )
+	{
+	TCB_t *pxTCB;
+	const TickType_t xConstTickCount = xTaskGetTickCount();
+
+		configASSERT( xRelativeDeadline <= ( portMAX_DELAY >> 1 ) );
+
+		taskENTER_CRITICAL();
+		{
+			/* If null is passed in here then it is the deadline of the calling
+			task that is being set. */
+			pxTCB = prvGetTCBFromHandle( xTask );
+
+			/* The current job of the task is taken to be released now. */
+			pxTCB->xRelativeDeadline = xRelativeDeadline;
+			pxTCB->xAbsoluteDeadline = xConstTickCount + xRelativeDeadline;
+
+			/* Changing a deadline can change which task of priority
+			configEDF_TASK_PRIORITY should be running. */
+			if( ( xSchedulerRunning != pdFALSE ) && ( pxTCB->uxPriority == ( UBaseType_t ) configEDF_TASK_PRIORITY ) && ( pxCurrentTCB->uxPriority == ( UBaseType_t ) configEDF_TASK_PRIORITY ) )
+			{
+				taskYIELD_IF_USING_PREEMPTION();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_EDF_SCHEDULING == 1 )
+
+	uint32_t ulTaskGetDeadlineMisses( TaskHandle_t xTask )
+	{
+	TCB_t const *pxTCB;
+	uint32_t ulReturn;
+
+		taskENTER_CRITICAL();
+		{
+			pxTCB = prvGetTCBFromHandle( xTask );
+			ulReturn = pxTCB->ulDeadlineMisses;
+		}
+		taskEXIT_CRITICAL();
+
+		return ulReturn;
+	}
+
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
 #if ( INCLUDE_vTaskDelay == 1 )
 
 	void vTaskDelay( const TickType_t xTicksToDelay )
@@ -1423,17 +2139,21 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 					{
 						#if( configUSE_TASK_NOTIFICATIONS == 1 )
 						{
+						BaseType_t x;
+
 							/* The task does not appear on the event list item of
 							and of the RTOS objects, but could still be in the
-							blocked state if it is waiting on its notification
-							rather than waiting on an object. */
-							if( pxTCB->ucNotifyState == taskWAITING_NOTIFICATION )
-							{
-								eReturn = eBlocked;
-							}
-							else
+							blocked state if it is waiting on one of its
+							notifications rather than waiting on an object. */
+							eReturn = eSuspended;
+
+							for( x = 0; x < configTASK_NOTIFICATION_ARRAY_ENTRIES; x++ )
 							{
-								eReturn = eSuspended;
+								if( pxTCB->ucNotifyState[ x ] == taskWAITING_NOTIFICATION )
+								{
+									eReturn = eBlocked;
+									break;
+								}
 							}
 						}
 						#else
@@ -1715,7 +2435,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 
 			/* Remove task from the ready/delayed list and place in the
 			suspended list. */
-			if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+			if( taskREMOVE_STATE_LIST_ITEM( pxTCB ) == ( UBaseType_t ) 0 )
 			{
 				taskRESET_READY_PRIORITY( pxTCB->uxPriority );
 			}
@@ -1738,11 +2458,16 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 
 			#if( configUSE_TASK_NOTIFICATIONS == 1 )
 			{
-				if( pxTCB->ucNotifyState == taskWAITING_NOTIFICATION )
+			BaseType_t x;
+
+				for( x = 0; x < configTASK_NOTIFICATION_ARRAY_ENTRIES; x++ )
 				{
-					/* The task was blocked to wait for a notification, but is
-					now suspended, so no notification was received. */
-					pxTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+					if( pxTCB->ucNotifyState[ x ] == taskWAITING_NOTIFICATION )
+					{
+						/* The task was blocked to wait for a notification, but is
+						now suspended, so no notification was received. */
+						pxTCB->ucNotifyState[ x ] = taskNOT_WAITING_NOTIFICATION;
+					}
 				}
 			}
 			#endif
@@ -2118,6 +2843,22 @@ void vTaskSuspendAll( void )
 	do not otherwise exhibit real time behaviour. */
 	portSOFTWARE_BARRIER();
 
+	#if( configUSE_DYNAMIC_TICK == 1 )
+	{
+		/* The tick count cannot be brought up to date while the scheduler is
+		suspended, so do it now to ensure code that runs with the scheduler
+		suspended sees the current time. */
+		if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+		{
+			( void ) prvCatchUpTicks();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configUSE_DYNAMIC_TICK */
+
 	/* The scheduler is suspended if uxSchedulerSuspended is non-zero.  An increment
 	is used to allow calls to vTaskSuspendAll() to nest. */
 	++uxSchedulerSuspended;
@@ -2139,7 +2880,15 @@ void vTaskSuspendAll( void )
 		configUSE_PREEMPTION is 0, so there may be tasks above the idle priority
 		task that are in the Ready state, even though the idle task is
 		running. */
-		#if( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+		#if( configUSE_PRIORITY_BITMAP_TASK_SELECTION == 1 )
+		{
+			/* The idle priority is bit 0 of the first group. */
+			if( ( ulReadyPriorityGroups > 1UL ) || ( ulReadyPriorities[ 0 ] > 1UL ) )
+			{
+				uxHigherPriorityReadyTasks = pdTRUE;
+			}
+		}
+		#elif( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
 		{
 			if( uxTopReadyPriority > tskIDLE_PRIORITY )
 			{
@@ -2219,7 +2968,7 @@ BaseType_t xAlreadyYielded = pdFALSE;
 				{
 					pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xPendingReadyList ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
 					( void ) uxListRemove( &( pxTCB->xEventListItem ) );
-					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					( void ) taskREMOVE_STATE_LIST_ITEM( pxTCB );
 					prvAddTaskToReadyList( pxTCB );
 
 					/* If the moved task has a priority higher than the current
@@ -2234,6 +2983,16 @@ BaseType_t xAlreadyYielded = pdFALSE;
 					}
 				}
 
+				#if( configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR == 1 )
+				{
+					/* Set any event group bits that were set from interrupts
+					while the scheduler was suspended.  Tasks unblocked by the
+					bits are placed directly in their ready lists, setting
+					xYieldPending if a context switch is required. */
+					vEventGroupSetBitsPendedFromISR();
+				}
+				#endif
+
 				if( pxTCB != NULL )
 				{
 					/* A task was unblocked while the scheduler was suspended,
@@ -2275,6 +3034,23 @@ BaseType_t xAlreadyYielded = pdFALSE;
 					}
 				}
 
+				#if( configUSE_DYNAMIC_TICK == 1 )
+				{
+					/* Tasks may have been readied, and the next unblock time
+					changed, while the scheduler was suspended.  The scheduler
+					is also suspended before it is started, by the memory
+					allocator, when the tick timer is not yet running. */
+					if( xSchedulerRunning != pdFALSE )
+					{
+						prvSetTickDeadline();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif /* configUSE_DYNAMIC_TICK */
+
 				if( xYieldPending != pdFALSE )
 				{
 					#if( configUSE_PREEMPTION != 0 )
@@ -2308,7 +3084,7 @@ TickType_t xTicks;
 	/* Critical section required if running on a 16 bit processor. */
 	portTICK_TYPE_ENTER_CRITICAL();
 	{
-		xTicks = xTickCount;
+		xTicks = taskGET_TICK_COUNT();
 	}
 	portTICK_TYPE_EXIT_CRITICAL();
 
@@ -2339,7 +3115,7 @@ UBaseType_t uxSavedInterruptStatus;
 
 	uxSavedInterruptStatus = portTICK_TYPE_SET_INTERRUPT_MASK_FROM_ISR();
 	{
-		xReturn = xTickCount;
+		xReturn = taskGET_TICK_COUNT();
 	}
 	portTICK_TYPE_CLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
 
@@ -2624,44 +3400,123 @@ BaseType_t xYieldRequired = pdFALSE;
 }
 /*----------------------------------------------------------*/
 
-#if ( INCLUDE_xTaskAbortDelay == 1 )
+#if( configUSE_DYNAMIC_TICK == 1 )
 
-	BaseType_t xTaskAbortDelay( TaskHandle_t xTask )
+	BaseType_t xTaskAnnounceElapsedTicks( void )
 	{
-	TCB_t *pxTCB = xTask;
-	BaseType_t xReturn;
+	TickType_t xTicks, xStepped;
+	BaseType_t xSwitchRequired = pdFALSE;
 
-		configASSERT( pxTCB );
+		/* Called from the tick timer interrupt with interrupts masked.  Claim
+		every whole tick period that has elapsed since the tick count was last
+		brought up to date. */
+		xTicks = portGET_UNANNOUNCED_TICKS();
+		portANNOUNCE_TICKS( xTicks );
 
-		vTaskSuspendAll();
+		if( xTicks > ( TickType_t ) 0U )
 		{
-			/* A task can only be prematurely removed from the Blocked state if
-			it is actually in the Blocked state. */
-			if( eTaskGetState( xTask ) == eBlocked )
+			if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
 			{
-				xReturn = pdPASS;
-
-				/* Remove the reference to the task from the blocked list.  An
-				interrupt won't touch the xStateListItem because the
-				scheduler is suspended. */
-				( void ) uxListRemove( &( pxTCB->xStateListItem ) );
-
-				/* Is the task waiting on an event also?  If so remove it from
-				the event list too.  Interrupts can touch the event list item,
-				even though the scheduler is suspended, so a critical section
-				is used. */
-				taskENTER_CRITICAL();
+				/* Move the tick count forward in as few steps as possible,
+				only processing individual ticks that unblock a task or
+				overflow the tick count.  The last elapsed tick is always
+				processed below. */
+				while( xTicks > ( TickType_t ) 1U )
 				{
-					if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
-					{
-						( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+					xStepped = prvStepTickCount( xTicks - ( TickType_t ) 1U );
 
-						/* This lets the task know it was forcibly removed from the
-						blocked state so it should not re-evaluate its block time and
-						then block again. */
-						pxTCB->ucDelayAborted = pdTRUE;
-					}
-					else
+					if( xStepped == ( TickType_t ) 0U )
+					{
+						if( xTaskIncrementTick() != pdFALSE )
+						{
+							xSwitchRequired = pdTRUE;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+
+						xStepped = ( TickType_t ) 1U;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					xTicks -= xStepped;
+				}
+			}
+			else
+			{
+				/* Ticks cannot be processed while the scheduler is suspended.
+				Use xPendedTicks so they are processed in xTaskResumeAll(), as
+				xTaskCatchUpTicks() does - xTaskIncrementTick() pends the last
+				one. */
+				xPendedTicks += ( xTicks - ( TickType_t ) 1U );
+			}
+
+			/* Process the tick that ended the elapsed period so the tick hook
+			and time slicing still run. */
+			if( xTaskIncrementTick() != pdFALSE )
+			{
+				xSwitchRequired = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		prvSetTickDeadline();
+
+		return xSwitchRequired;
+	}
+
+#endif /* configUSE_DYNAMIC_TICK */
+/*----------------------------------------------------------*/
+
+#if ( INCLUDE_xTaskAbortDelay == 1 )
+
+	BaseType_t xTaskAbortDelay( TaskHandle_t xTask )
+	{
+	TCB_t *pxTCB = xTask;
+	BaseType_t xReturn;
+
+		configASSERT( pxTCB );
+
+		vTaskSuspendAll();
+		{
+			/* A task can only be prematurely removed from the Blocked state if
+			it is actually in the Blocked state. */
+			if( eTaskGetState( xTask ) == eBlocked )
+			{
+				xReturn = pdPASS;
+
+				/* Remove the reference to the task from the blocked list.  An
+				interrupt won't touch the xStateListItem because the
+				scheduler is suspended. */
+				( void ) taskREMOVE_STATE_LIST_ITEM( pxTCB );
+
+				/* Is the task waiting on an event also?  If so remove it from
+				the event list too.  Interrupts can touch the event list item,
+				even though the scheduler is suspended, so a critical section
+				is used. */
+				taskENTER_CRITICAL();
+				{
+					if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+					{
+						( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+
+						/* This lets the task know it was forcibly removed from the
+						blocked state so it should not re-evaluate its block time and
+						then block again. */
+						pxTCB->ucDelayAborted = pdTRUE;
+					}
+					else
 					{
 						mtCOVERAGE_TEST_MARKER();
 					}
@@ -2678,7 +3533,7 @@ BaseType_t xYieldRequired = pdFALSE;
 					/* Preemption is on, but a context switch should only be
 					performed if the unblocked task has a priority that is
 					equal to or higher than the currently executing task. */
-					if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+					if( taskPREEMPTS_CURRENT_TASK( pxTCB ) )
 					{
 						/* Pend the yield to be performed when the scheduler
 						is unsuspended. */
@@ -2757,7 +3612,7 @@ BaseType_t xSwitchRequired = pdFALSE;
 					item at the head of the delayed list.  This is the time
 					at which the task at the head of the delayed list must
 					be removed from the Blocked state. */
-					pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+					pxTCB = taskGET_NEXT_DELAYED_TASK();
 					xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
 
 					if( xConstTickCount < xItemValue )
@@ -2776,7 +3631,7 @@ BaseType_t xSwitchRequired = pdFALSE;
 					}
 
 					/* It is time to remove the item from the Blocked state. */
-					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					( void ) taskREMOVE_STATE_LIST_ITEM( pxTCB );
 
 					/* Is the task waiting on an event also?  If so remove
 					it from the event list. */
@@ -3029,6 +3884,9 @@ void vTaskSwitchContext( void )
 		/* Check for stack overflow, if configured. */
 		taskCHECK_FOR_STACK_OVERFLOW();
 
+		/* Record how much stack the task has used, if configured. */
+		taskUPDATE_STACK_WATERMARK( pxCurrentTCB );
+
 		/* Before the currently running task is switched out, save its errno. */
 		#if( configUSE_POSIX_ERRNO == 1 )
 		{
@@ -3039,6 +3897,20 @@ void vTaskSwitchContext( void )
 		/* Select a new task to run using either the generic C or port
 		optimised asm code. */
 		taskSELECT_HIGHEST_PRIORITY_TASK(); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+		#if( configUSE_EDF_SCHEDULING == 1 )
+		{
+			if( pxCurrentTCB->uxPriority == ( UBaseType_t ) configEDF_TASK_PRIORITY )
+			{
+				prvSelectEarliestDeadlineTask();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif
+
 		traceTASK_SWITCHED_IN();
 
 		/* After the new task is switched in, update the global errno. */
@@ -3057,6 +3929,14 @@ void vTaskSwitchContext( void )
 			_impure_ptr = &( pxCurrentTCB->xNewLib_reent );
 		}
 		#endif /* configUSE_NEWLIB_REENTRANT */
+
+		#if( configUSE_DYNAMIC_TICK == 1 )
+		{
+			/* The task switched in may share its priority with other Ready
+			state tasks, in which case it only runs for one time slice. */
+			prvSetTickDeadline();
+		}
+		#endif /* configUSE_DYNAMIC_TICK */
 	}
 }
 /*-----------------------------------------------------------*/
@@ -3159,7 +4039,7 @@ BaseType_t xReturn;
 
 	if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
 	{
-		( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
+		( void ) taskREMOVE_STATE_LIST_ITEM( pxUnblockedTCB );
 		prvAddTaskToReadyList( pxUnblockedTCB );
 
 		#if( configUSE_TICKLESS_IDLE != 0 )
@@ -3183,7 +4063,7 @@ BaseType_t xReturn;
 		vListInsertEnd( &( xPendingReadyList ), &( pxUnblockedTCB->xEventListItem ) );
 	}
 
-	if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+	if( taskPREEMPTS_CURRENT_TASK( pxUnblockedTCB ) )
 	{
 		/* Return true if the task removed from the event list has a higher
 		priority than the calling task.  This allows the calling task to know if
@@ -3237,10 +4117,10 @@ TCB_t *pxUnblockedTCB;
 	/* Remove the task from the delayed list and add it to the ready list.  The
 	scheduler is suspended so interrupts will not be accessing the ready
 	lists. */
-	( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
+	( void ) taskREMOVE_STATE_LIST_ITEM( pxUnblockedTCB );
 	prvAddTaskToReadyList( pxUnblockedTCB );
 
-	if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+	if( taskPREEMPTS_CURRENT_TASK( pxUnblockedTCB ) )
 	{
 		/* The unblocked task has a priority above that of the calling task, so
 		a context switch is required.  This function is called with the
@@ -3251,13 +4131,61 @@ TCB_t *pxUnblockedTCB;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR == 1 )
+
+	BaseType_t xTaskRemoveFromUnorderedEventListFromISR( ListItem_t * pxEventListItem, const TickType_t xItemValue )
+	{
+	TCB_t *pxUnblockedTCB;
+	BaseType_t xReturn;
+
+		/* THIS FUNCTION MUST BE CALLED WITH INTERRUPTS MASKED AND THE SCHEDULER
+		NOT SUSPENDED.  No task can then be accessing the event or ready
+		lists. */
+		configASSERT( uxSchedulerSuspended == pdFALSE );
+
+		/* Store the new item value in the event list. */
+		listSET_LIST_ITEM_VALUE( pxEventListItem, xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE );
+
+		pxUnblockedTCB = listGET_LIST_ITEM_OWNER( pxEventListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+		configASSERT( pxUnblockedTCB );
+		( void ) uxListRemove( pxEventListItem );
+
+		#if( configUSE_TICKLESS_IDLE != 0 )
+		{
+			/* See the comment in vTaskRemoveFromUnorderedEventList(). */
+			prvResetNextTaskUnblockTime();
+		}
+		#endif
+
+		( void ) taskREMOVE_STATE_LIST_ITEM( pxUnblockedTCB );
+		prvAddTaskToReadyList( pxUnblockedTCB );
+
+		if( taskPREEMPTS_CURRENT_TASK( pxUnblockedTCB ) )
+		{
+			/* Return true so the calling interrupt can request a context
+			switch, and mark a yield as pending in case the interrupt does not
+			use the xHigherPriorityTaskWoken parameter. */
+			xReturn = pdTRUE;
+			xYieldPending = pdTRUE;
+		}
+		else
+		{
+			xReturn = pdFALSE;
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR */
+/*-----------------------------------------------------------*/
+
 void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
 {
 	configASSERT( pxTimeOut );
 	taskENTER_CRITICAL();
 	{
 		pxTimeOut->xOverflowCount = xNumOfOverflows;
-		pxTimeOut->xTimeOnEntering = xTickCount;
+		pxTimeOut->xTimeOnEntering = taskGET_TICK_COUNT();
 	}
 	taskEXIT_CRITICAL();
 }
@@ -3267,7 +4195,7 @@ void vTaskInternalSetTimeOutState( TimeOut_t * const pxTimeOut )
 {
 	/* For internal use only as it does not use a critical section. */
 	pxTimeOut->xOverflowCount = xNumOfOverflows;
-	pxTimeOut->xTimeOnEntering = xTickCount;
+	pxTimeOut->xTimeOnEntering = taskGET_TICK_COUNT();
 }
 /*-----------------------------------------------------------*/
 
@@ -3281,7 +4209,7 @@ BaseType_t xReturn;
 	taskENTER_CRITICAL();
 	{
 		/* Minor optimisation.  The tick count cannot change in this block. */
-		const TickType_t xConstTickCount = xTickCount;
+		const TickType_t xConstTickCount = taskGET_TICK_COUNT();
 		const TickType_t xElapsedTime = xConstTickCount - pxTimeOut->xTimeOnEntering;
 
 		#if( INCLUDE_xTaskAbortDelay == 1 )
@@ -3633,6 +4561,13 @@ UBaseType_t uxPriority;
 	using list2. */
 	pxDelayedTaskList = &xDelayedTaskList1;
 	pxOverflowDelayedTaskList = &xDelayedTaskList2;
+
+	#if( configUSE_DELAYED_TASK_HEAP == 1 )
+	{
+		pxDelayedTaskHeap1 = NULL;
+		pxDelayedTaskHeap2 = NULL;
+	}
+	#endif
 }
 /*-----------------------------------------------------------*/
 
@@ -3651,13 +4586,27 @@ static void prvCheckTasksWaitingTermination( void )
 		{
 			taskENTER_CRITICAL();
 			{
-				pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xTasksWaitingTermination ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-				( void ) uxListRemove( &( pxTCB->xStateListItem ) );
-				--uxCurrentNumberOfTasks;
-				--uxDeletedTasksWaitingCleanUp;
+				/* xTaskCreateFromPool() may have cleaned up the remaining tasks
+				since uxDeletedTasksWaitingCleanUp was checked. */
+				if( listLIST_IS_EMPTY( &xTasksWaitingTermination ) == pdFALSE )
+				{
+					pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xTasksWaitingTermination ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					--uxCurrentNumberOfTasks;
+					--uxDeletedTasksWaitingCleanUp;
+				}
+				else
+				{
+					pxTCB = NULL;
+				}
 			}
 			taskEXIT_CRITICAL();
 
+			if( pxTCB == NULL )
+			{
+				break;
+			}
+
 			prvDeleteTCB( pxTCB );
 		}
 	}
@@ -3846,122 +4795,553 @@ static void prvCheckTasksWaitingTermination( void )
 		}
 		#endif
 
-		uxReturn = prvTaskCheckFreeStackSpace( pucEndOfStack );
+		uxReturn = prvTaskCheckFreeStackSpace( pucEndOfStack );
+
+		return uxReturn;
+	}
+
+#endif /* INCLUDE_uxTaskGetStackHighWaterMark2 */
+/*-----------------------------------------------------------*/
+
+#if ( INCLUDE_uxTaskGetStackHighWaterMark == 1 )
+
+	UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask )
+	{
+	TCB_t *pxTCB;
+	uint8_t *pucEndOfStack;
+	UBaseType_t uxReturn;
+
+		pxTCB = prvGetTCBFromHandle( xTask );
+
+		#if portSTACK_GROWTH < 0
+		{
+			pucEndOfStack = ( uint8_t * ) pxTCB->pxStack;
+		}
+		#else
+		{
+			pucEndOfStack = ( uint8_t * ) pxTCB->pxEndOfStack;
+		}
+		#endif
+
+		uxReturn = ( UBaseType_t ) prvTaskCheckFreeStackSpace( pucEndOfStack );
+
+		return uxReturn;
+	}
+
+#endif /* INCLUDE_uxTaskGetStackHighWaterMark */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STACK_WATERMARK_TRACKING == 1 )
+
+	static void prvUpdateStackWatermark( TCB_t *pxTCB )
+	{
+	StackType_t *pxWatermark = pxTCB->pxStackWatermark, *pxProbe;
+	UBaseType_t uxUnwritten = 0;
+
+		/* The stack pointer saved when the task was switched out is known to
+		have been used.  Then check the words beyond the watermark until
+		configSTACK_WATERMARK_GAP_WORDS words in a row are found to still hold
+		the fill value, so the watermark can move past stack that was reserved
+		but not written, such as the unused end of a local array, and unless
+		the task used more stack the cost is that many comparisons.  A larger
+		unwritten gap can hide deeper use until the stack pointer is saved
+		beyond it, prvTaskCheckFreeStackSpace() remains the definitive check. */
+		#if( portSTACK_GROWTH < 0 )
+		{
+			if( ( pxTCB->pxTopOfStack < pxWatermark ) && ( pxTCB->pxTopOfStack >= pxTCB->pxStack ) )
+			{
+				pxWatermark = ( StackType_t * ) pxTCB->pxTopOfStack;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			pxProbe = pxWatermark;
+
+			while( ( pxProbe > pxTCB->pxStack ) && ( uxUnwritten < ( UBaseType_t ) configSTACK_WATERMARK_GAP_WORDS ) )
+			{
+				pxProbe--;
+
+				if( *pxProbe != taskSTACK_FILL_WORD )
+				{
+					pxWatermark = pxProbe;
+					uxUnwritten = 0;
+				}
+				else
+				{
+					uxUnwritten++;
+				}
+			}
+		}
+		#else /* portSTACK_GROWTH */
+		{
+			if( ( pxTCB->pxTopOfStack > pxWatermark ) && ( pxTCB->pxTopOfStack <= pxTCB->pxEndOfStack ) )
+			{
+				pxWatermark = ( StackType_t * ) pxTCB->pxTopOfStack;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			pxProbe = pxWatermark;
+
+			while( ( pxProbe < pxTCB->pxEndOfStack ) && ( uxUnwritten < ( UBaseType_t ) configSTACK_WATERMARK_GAP_WORDS ) )
+			{
+				pxProbe++;
+
+				if( *pxProbe != taskSTACK_FILL_WORD )
+				{
+					pxWatermark = pxProbe;
+					uxUnwritten = 0;
+				}
+				else
+				{
+					uxUnwritten++;
+				}
+			}
+		}
+		#endif /* portSTACK_GROWTH */
+
+		pxTCB->pxStackWatermark = pxWatermark;
+	}
+
+#endif /* configUSE_STACK_WATERMARK_TRACKING */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STACK_WATERMARK_TRACKING == 1 )
+
+	configSTACK_DEPTH_TYPE uxTaskGetTrackedStackHighWaterMark( TaskHandle_t xTask )
+	{
+	TCB_t *pxTCB;
+	configSTACK_DEPTH_TYPE uxReturn;
+
+		taskENTER_CRITICAL();
+		{
+			pxTCB = prvGetTCBFromHandle( xTask );
+
+			/* The watermark of the running task is only updated when it is
+			switched out, so bring it up to date. */
+			if( pxTCB == pxCurrentTCB )
+			{
+				taskUPDATE_STACK_WATERMARK( pxTCB );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			uxReturn = taskTRACKED_FREE_STACK_SPACE( pxTCB );
+		}
+		taskEXIT_CRITICAL();
+
+		return uxReturn;
+	}
+
+#endif /* configUSE_STACK_WATERMARK_TRACKING */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STACK_WATERMARK_TRACKING == 1 )
+
+	UBaseType_t uxTaskGetStackUsage( TaskStackUsage_t * const pxStackUsageArray, const UBaseType_t uxArraySize, const UBaseType_t uxMarginPercent )
+	{
+	UBaseType_t uxTask = 0, uxQueue = configMAX_PRIORITIES;
+
+		vTaskSuspendAll();
+		{
+			/* Is there a space in the array for each task in the system? */
+			if( uxArraySize >= uxCurrentNumberOfTasks )
+			{
+				/* The calling task cannot be switched out while the scheduler
+				is suspended, so its watermark can be brought up to date
+				without a critical section. */
+				taskUPDATE_STACK_WATERMARK( pxCurrentTCB );
+
+				do
+				{
+					uxQueue--;
+					uxTask += prvListStackUsageWithinSingleList( &( pxStackUsageArray[ uxTask ] ), &( pxReadyTasksLists[ uxQueue ] ), uxMarginPercent );
+
+				} while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+
+				uxTask += prvListStackUsageWithinSingleList( &( pxStackUsageArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, uxMarginPercent );
+				uxTask += prvListStackUsageWithinSingleList( &( pxStackUsageArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, uxMarginPercent );
+
+				#if( INCLUDE_vTaskDelete == 1 )
+				{
+					uxTask += prvListStackUsageWithinSingleList( &( pxStackUsageArray[ uxTask ] ), &xTasksWaitingTermination, uxMarginPercent );
+				}
+				#endif
+
+				#if ( INCLUDE_vTaskSuspend == 1 )
+				{
+					uxTask += prvListStackUsageWithinSingleList( &( pxStackUsageArray[ uxTask ] ), &xSuspendedTaskList, uxMarginPercent );
+				}
+				#endif
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		( void ) xTaskResumeAll();
+
+		return uxTask;
+	}
+
+#endif /* configUSE_STACK_WATERMARK_TRACKING */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STACK_WATERMARK_TRACKING == 1 )
+
+	static UBaseType_t prvListStackUsageWithinSingleList( TaskStackUsage_t *pxStackUsageArray, List_t *pxList, UBaseType_t uxMarginPercent )
+	{
+	configLIST_VOLATILE TCB_t *pxNextTCB, *pxFirstTCB;
+	UBaseType_t uxTask = 0;
+	uint32_t ulUsed;
+
+		if( listCURRENT_LIST_LENGTH( pxList ) > ( UBaseType_t ) 0 )
+		{
+			listGET_OWNER_OF_NEXT_ENTRY( pxFirstTCB, pxList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+			do
+			{
+				listGET_OWNER_OF_NEXT_ENTRY( pxNextTCB, pxList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+				pxStackUsageArray[ uxTask ].xHandle = ( TaskHandle_t ) pxNextTCB;
+				pxStackUsageArray[ uxTask ].pcTaskName = ( const char * ) &( pxNextTCB->pcTaskName[ 0 ] );
+				pxStackUsageArray[ uxTask ].usStackDepth = ( configSTACK_DEPTH_TYPE ) ( ( pxNextTCB->pxEndOfStack - pxNextTCB->pxStack ) + 1 );
+				pxStackUsageArray[ uxTask ].usStackHighWaterMark = taskTRACKED_FREE_STACK_SPACE( pxNextTCB );
+
+				/* Suggest the deepest use seen plus the margin, rounded up. */
+				ulUsed = ( uint32_t ) pxStackUsageArray[ uxTask ].usStackDepth - ( uint32_t ) pxStackUsageArray[ uxTask ].usStackHighWaterMark;
+				pxStackUsageArray[ uxTask ].usSuggestedStackDepth = ( configSTACK_DEPTH_TYPE ) ( ulUsed + ( ( ( ulUsed * ( uint32_t ) uxMarginPercent ) + 99UL ) / 100UL ) );
+
+				uxTask++;
+			} while( pxNextTCB != pxFirstTCB );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return uxTask;
+	}
+
+#endif /* configUSE_STACK_WATERMARK_TRACKING */
+/*-----------------------------------------------------------*/
+
+#if ( INCLUDE_vTaskDelete == 1 )
+
+	static void prvDeleteTCB( TCB_t *pxTCB )
+	{
+		/* This call is required specifically for the TriCore port.  It must be
+		above the vPortFree() calls.  The call is also used by ports/demos that
+		want to allocate and clean RAM statically. */
+		portCLEAN_UP_TCB( pxTCB );
+
+		/* Free up the memory allocated by the scheduler for the task.  It is up
+		to the task to free any memory allocated at the application level.
+		See the third party link http://www.nadler.com/embedded/newlibAndFreeRTOS.html
+		for additional information. */
+		#if ( configUSE_NEWLIB_REENTRANT == 1 )
+		{
+			_reclaim_reent( &( pxTCB->xNewLib_reent ) );
+		}
+		#endif /* configUSE_NEWLIB_REENTRANT */
+
+		#if ( configUSE_HEAP_TASK_CACHE == 1 )
+		{
+			/* Return the blocks held in the task's heap cache to the heap. */
+			vPortFreeTaskCache( pxTCB->pvThreadLocalStoragePointers[ configHEAP_TASK_CACHE_TLS_INDEX ] );
+		}
+		#endif /* configUSE_HEAP_TASK_CACHE */
+
+		#if( configUSE_TASK_POOLS == 1 )
+			if( pxTCB->pxTaskPool != NULL )
+			{
+				/* The TCB and stack belong to a task pool, so return them to the
+				pool to be reused rather than freeing them. */
+				taskENTER_CRITICAL();
+				{
+					vListInsertEnd( &( pxTCB->pxTaskPool->xFreeTasks ), &( pxTCB->xStateListItem ) );
+				}
+				taskEXIT_CRITICAL();
+			}
+			else
+		#endif /* configUSE_TASK_POOLS */
+		{
+			#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( portUSING_MPU_WRAPPERS == 0 ) )
+			{
+				/* The task can only have been allocated dynamically - free both
+				the stack and TCB. */
+				vPortFree( pxTCB->pxStack );
+				vPortFree( pxTCB );
+			}
+			#elif( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
+			{
+				/* The task could have been allocated statically or dynamically, so
+				check what was statically allocated before trying to free the
+				memory. */
+				if( pxTCB->ucStaticallyAllocated == tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB )
+				{
+					/* Both the stack and TCB were allocated dynamically, so both
+					must be freed. */
+					vPortFree( pxTCB->pxStack );
+					vPortFree( pxTCB );
+				}
+				else if( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_ONLY )
+				{
+					/* Only the stack was statically allocated, so the TCB is the
+					only memory that must be freed. */
+					vPortFree( pxTCB );
+				}
+				else
+				{
+					/* Neither the stack nor the TCB were allocated dynamically, so
+					nothing needs to be freed. */
+					configASSERT( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_AND_TCB	);
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+		}
+	}
+
+#endif /* INCLUDE_vTaskDelete */
+/*-----------------------------------------------------------*/
+
+static void prvResetNextTaskUnblockTime( void )
+{
+TCB_t *pxTCB;
+
+	if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+	{
+		/* The new current delayed list is empty.  Set xNextTaskUnblockTime to
+		the maximum possible value so it is	extremely unlikely that the
+		if( xTickCount >= xNextTaskUnblockTime ) test will pass until
+		there is an item in the delayed list. */
+		xNextTaskUnblockTime = portMAX_DELAY;
+	}
+	else
+	{
+		/* The new current delayed list is not empty, get the value of
+		the item at the head of the delayed list.  This is the time at
+		which the task at the head of the delayed list should be removed
+		from the Blocked state. */
+		( pxTCB ) = taskGET_NEXT_DELAYED_TASK();
+		xNextTaskUnblockTime = listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_EDF_SCHEDULING == 1 )
+
+	static BaseType_t prvIsDeadlineEarlier( const TCB_t * const pxTCB, const TCB_t * const pxOtherTCB )
+	{
+	BaseType_t xReturn;
+
+		if( pxTCB->xRelativeDeadline == ( TickType_t ) 0U )
+		{
+			xReturn = ( pxOtherTCB->xRelativeDeadline != ( TickType_t ) 0U ) ? pdTRUE : pdFALSE;
+		}
+		else if( pxOtherTCB->xRelativeDeadline == ( TickType_t ) 0U )
+		{
+			xReturn = pdFALSE;
+		}
+		else
+		{
+			xReturn = taskTICK_IS_AFTER( pxOtherTCB->xAbsoluteDeadline, pxTCB->xAbsoluteDeadline ) ? pdTRUE : pdFALSE;
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_EDF_SCHEDULING == 1 )
+
+	static void prvSelectEarliestDeadlineTask( void )
+	{
+	List_t * const pxReadyList = &( pxReadyTasksLists[ configEDF_TASK_PRIORITY ] );
+	ListItem_t const * const pxEndMarker = listGET_END_MARKER( pxReadyList );
+	ListItem_t *pxIterator;
+	TCB_t *pxTCB, *pxEarliestTCB;
+
+		/* The ready list is not kept in deadline order, as deadlines are
+		compared relative to each other to allow for the tick count
+		overflowing, so search it.  The search starts from the task already
+		selected in turn, so tasks with equal deadlines share the processing
+		time as tasks of equal priority do. */
+		pxEarliestTCB = pxCurrentTCB;
+
+		for( pxIterator = listGET_HEAD_ENTRY( pxReadyList ); pxIterator != pxEndMarker; pxIterator = listGET_NEXT( pxIterator ) )
+		{
+			pxTCB = listGET_LIST_ITEM_OWNER( pxIterator ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+			if( prvIsDeadlineEarlier( pxTCB, pxEarliestTCB ) != pdFALSE )
+			{
+				pxEarliestTCB = pxTCB;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
 
-		return uxReturn;
+		pxCurrentTCB = pxEarliestTCB;
 	}
 
-#endif /* INCLUDE_uxTaskGetStackHighWaterMark2 */
+#endif /* configUSE_EDF_SCHEDULING */
 /*-----------------------------------------------------------*/
 
-#if ( INCLUDE_uxTaskGetStackHighWaterMark == 1 )
+#if( ( configUSE_PRIORITY_BITMAP_TASK_SELECTION == 1 ) && !defined( __GNUC__ ) )
 
-	UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask )
+	static UBaseType_t prvHighestSetBit( uint32_t ulBits )
 	{
-	TCB_t *pxTCB;
-	uint8_t *pucEndOfStack;
-	UBaseType_t uxReturn;
+	UBaseType_t uxBit = 0;
 
-		pxTCB = prvGetTCBFromHandle( xTask );
+		/* Binary search for the most significant set bit. */
+		if( ( ulBits & 0xFFFF0000UL ) != 0UL )
+		{
+			ulBits >>= 16U;
+			uxBit += 16U;
+		}
 
-		#if portSTACK_GROWTH < 0
+		if( ( ulBits & 0x0000FF00UL ) != 0UL )
 		{
-			pucEndOfStack = ( uint8_t * ) pxTCB->pxStack;
+			ulBits >>= 8U;
+			uxBit += 8U;
 		}
-		#else
+
+		if( ( ulBits & 0x000000F0UL ) != 0UL )
 		{
-			pucEndOfStack = ( uint8_t * ) pxTCB->pxEndOfStack;
+			ulBits >>= 4U;
+			uxBit += 4U;
 		}
-		#endif
 
-		uxReturn = ( UBaseType_t ) prvTaskCheckFreeStackSpace( pucEndOfStack );
+		if( ( ulBits & 0x0000000CUL ) != 0UL )
+		{
+			ulBits >>= 2U;
+			uxBit += 2U;
+		}
 
-		return uxReturn;
+		if( ( ulBits & 0x00000002UL ) != 0UL )
+		{
+			uxBit += 1U;
+		}
+
+		return uxBit;
 	}
 
-#endif /* INCLUDE_uxTaskGetStackHighWaterMark */
+#endif /* ( configUSE_PRIORITY_BITMAP_TASK_SELECTION == 1 ) && !defined( __GNUC__ ) */
 /*-----------------------------------------------------------*/
 
-#if ( INCLUDE_vTaskDelete == 1 )
+#if( configUSE_DYNAMIC_TICK == 1 )
 
-	static void prvDeleteTCB( TCB_t *pxTCB )
+	static TickType_t prvStepTickCount( TickType_t xTicks )
 	{
-		/* This call is required specifically for the TriCore port.  It must be
-		above the vPortFree() calls.  The call is also used by ports/demos that
-		want to allocate and clean RAM statically. */
-		portCLEAN_UP_TCB( pxTCB );
+	TickType_t xLimit;
 
-		/* Free up the memory allocated by the scheduler for the task.  It is up
-		to the task to free any memory allocated at the application level.
-		See the third party link http://www.nadler.com/embedded/newlibAndFreeRTOS.html
-		for additional information. */
-		#if ( configUSE_NEWLIB_REENTRANT == 1 )
+		/* xNextTaskUnblockTime is portMAX_DELAY when no task is due to leave
+		the Blocked state before the tick count overflows, so stopping one tick
+		short of it also stops the tick count overflowing. */
+		if( xNextTaskUnblockTime > xTickCount )
 		{
-			_reclaim_reent( &( pxTCB->xNewLib_reent ) );
+			xLimit = ( xNextTaskUnblockTime - xTickCount ) - ( TickType_t ) 1U;
+
+			if( xTicks > xLimit )
+			{
+				xTicks = xLimit;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			xTicks = ( TickType_t ) 0U;
 		}
-		#endif /* configUSE_NEWLIB_REENTRANT */
 
-		#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( portUSING_MPU_WRAPPERS == 0 ) )
+		if( xTicks > ( TickType_t ) 0U )
 		{
-			/* The task can only have been allocated dynamically - free both
-			the stack and TCB. */
-			vPortFree( pxTCB->pxStack );
-			vPortFree( pxTCB );
+			xTickCount += xTicks;
+			traceINCREASE_TICK_COUNT( xTicks );
 		}
-		#elif( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
+		else
 		{
-			/* The task could have been allocated statically or dynamically, so
-			check what was statically allocated before trying to free the
-			memory. */
-			if( pxTCB->ucStaticallyAllocated == tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB )
-			{
-				/* Both the stack and TCB were allocated dynamically, so both
-				must be freed. */
-				vPortFree( pxTCB->pxStack );
-				vPortFree( pxTCB );
-			}
-			else if( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_ONLY )
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xTicks;
+	}
+	/*-----------------------------------------------------------*/
+
+	static TickType_t prvCatchUpTicks( void )
+	{
+	TickType_t xTicks;
+	UBaseType_t uxSavedInterruptStatus;
+
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			/* Ticks that pass while the scheduler is suspended are pended by
+			the tick timer interrupt instead. */
+			if( ( xSchedulerRunning != pdFALSE ) && ( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE ) )
 			{
-				/* Only the stack was statically allocated, so the TCB is the
-				only memory that must be freed. */
-				vPortFree( pxTCB );
+				xTicks = prvStepTickCount( portGET_UNANNOUNCED_TICKS() );
+				portANNOUNCE_TICKS( xTicks );
 			}
 			else
 			{
-				/* Neither the stack nor the TCB were allocated dynamically, so
-				nothing needs to be freed. */
-				configASSERT( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_AND_TCB	);
 				mtCOVERAGE_TEST_MARKER();
 			}
+
+			xTicks = xTickCount;
 		}
-		#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		return xTicks;
 	}
+	/*-----------------------------------------------------------*/
 
-#endif /* INCLUDE_vTaskDelete */
-/*-----------------------------------------------------------*/
+	static void prvSetTickDeadline( void )
+	{
+	TickType_t xNow, xTicks = ( TickType_t ) 1U;
 
-static void prvResetNextTaskUnblockTime( void )
-{
-TCB_t *pxTCB;
+		/* Ticks that have been pended have already been announced. */
+		xNow = xTickCount + xPendedTicks;
 
-	if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
-	{
-		/* The new current delayed list is empty.  Set xNextTaskUnblockTime to
-		the maximum possible value so it is	extremely unlikely that the
-		if( xTickCount >= xNextTaskUnblockTime ) test will pass until
-		there is an item in the delayed list. */
-		xNextTaskUnblockTime = portMAX_DELAY;
-	}
-	else
-	{
-		/* The new current delayed list is not empty, get the value of
-		the item at the head of the delayed list.  This is the time at
-		which the task at the head of the delayed list should be removed
-		from the Blocked state. */
-		( pxTCB ) = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-		xNextTaskUnblockTime = listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ) );
+		if( xNextTaskUnblockTime > xNow )
+		{
+			xTicks = xNextTaskUnblockTime - xNow;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		#if( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
+		{
+			/* Other tasks at the priority of the running task must get their
+			share of processing time. */
+			if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) ) > ( UBaseType_t ) 1 )
+			{
+				xTicks = ( TickType_t ) 1U;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) ) */
+
+		portSET_TICK_DEADLINE( xTicks );
 	}
-}
+
+#endif /* configUSE_DYNAMIC_TICK */
 /*-----------------------------------------------------------*/
 
 #if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) )
@@ -4284,6 +5664,42 @@ TCB_t *pxTCB;
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_MUTEXES == 1 )
+
+	BaseType_t xTaskMutexHolderCanRun( TaskHandle_t const pxMutexHolder )
+	{
+	TCB_t * const pxMutexHolderTCB = pxMutexHolder;
+	BaseType_t xReturn = pdFALSE;
+
+		/* The holder can only make progress towards releasing the mutex if
+		yielding would let it run, which is the case if it is in the Ready
+		state at a priority at or above that of the calling task.  If it is
+		Blocked, Suspended or of lower priority then the calling task has to
+		block and let priority inheritance do the rest.  Called from a critical
+		section so the holder cannot change state while it is inspected. */
+		if( pxMutexHolderTCB != NULL )
+		{
+			if( ( pxMutexHolderTCB->uxPriority >= pxCurrentTCB->uxPriority ) &&
+				( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxMutexHolderTCB->uxPriority ] ), &( pxMutexHolderTCB->xStateListItem ) ) != pdFALSE ) )
+			{
+				xReturn = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_MUTEXES */
+/*-----------------------------------------------------------*/
+
 #if ( portCRITICAL_NESTING_IN_TCB == 1 )
 
 	void vTaskEnterCritical( void )
@@ -4632,17 +6048,19 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
+	uint32_t ulTaskGenericNotifyTake( UBaseType_t uxIndexToWait, BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
 	{
 	uint32_t ulReturn;
 
+		configASSERT( uxIndexToWait < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		taskENTER_CRITICAL();
 		{
 			/* Only block if the notification count is not already non-zero. */
-			if( pxCurrentTCB->ulNotifiedValue == 0UL )
+			if( pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] == 0UL )
 			{
 				/* Mark this task as waiting for a notification. */
-				pxCurrentTCB->ucNotifyState = taskWAITING_NOTIFICATION;
+				pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskWAITING_NOTIFICATION;
 
 				if( xTicksToWait > ( TickType_t ) 0 )
 				{
@@ -4670,17 +6088,17 @@ TickType_t uxReturn;
 		taskENTER_CRITICAL();
 		{
 			traceTASK_NOTIFY_TAKE();
-			ulReturn = pxCurrentTCB->ulNotifiedValue;
+			ulReturn = pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ];
 
 			if( ulReturn != 0UL )
 			{
 				if( xClearCountOnExit != pdFALSE )
 				{
-					pxCurrentTCB->ulNotifiedValue = 0UL;
+					pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] = 0UL;
 				}
 				else
 				{
-					pxCurrentTCB->ulNotifiedValue = ulReturn - ( uint32_t ) 1;
+					pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] = ulReturn - ( uint32_t ) 1;
 				}
 			}
 			else
@@ -4688,7 +6106,7 @@ TickType_t uxReturn;
 				mtCOVERAGE_TEST_MARKER();
 			}
 
-			pxCurrentTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+			pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskNOT_WAITING_NOTIFICATION;
 		}
 		taskEXIT_CRITICAL();
 
@@ -4700,22 +6118,24 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait )
+	BaseType_t xTaskGenericNotifyWait( UBaseType_t uxIndexToWait, uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait )
 	{
 	BaseType_t xReturn;
 
+		configASSERT( uxIndexToWait < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		taskENTER_CRITICAL();
 		{
 			/* Only block if a notification is not already pending. */
-			if( pxCurrentTCB->ucNotifyState != taskNOTIFICATION_RECEIVED )
+			if( pxCurrentTCB->ucNotifyState[ uxIndexToWait ] != taskNOTIFICATION_RECEIVED )
 			{
 				/* Clear bits in the task's notification value as bits may get
 				set	by the notifying task or interrupt.  This can be used to
 				clear the value to zero. */
-				pxCurrentTCB->ulNotifiedValue &= ~ulBitsToClearOnEntry;
+				pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] &= ~ulBitsToClearOnEntry;
 
 				/* Mark this task as waiting for a notification. */
-				pxCurrentTCB->ucNotifyState = taskWAITING_NOTIFICATION;
+				pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskWAITING_NOTIFICATION;
 
 				if( xTicksToWait > ( TickType_t ) 0 )
 				{
@@ -4748,14 +6168,14 @@ TickType_t uxReturn;
 			{
 				/* Output the current notification value, which may or may not
 				have changed. */
-				*pulNotificationValue = pxCurrentTCB->ulNotifiedValue;
+				*pulNotificationValue = pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ];
 			}
 
 			/* If ucNotifyValue is set then either the task never entered the
 			blocked state (because a notification was already pending) or the
 			task unblocked because of a notification.  Otherwise the task
 			unblocked because of a timeout. */
-			if( pxCurrentTCB->ucNotifyState != taskNOTIFICATION_RECEIVED )
+			if( pxCurrentTCB->ucNotifyState[ uxIndexToWait ] != taskNOTIFICATION_RECEIVED )
 			{
 				/* A notification was not received. */
 				xReturn = pdFALSE;
@@ -4764,11 +6184,11 @@ TickType_t uxReturn;
 			{
 				/* A notification was already pending or a notification was
 				received while the task was waiting. */
-				pxCurrentTCB->ulNotifiedValue &= ~ulBitsToClearOnExit;
+				pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] &= ~ulBitsToClearOnExit;
 				xReturn = pdTRUE;
 			}
 
-			pxCurrentTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+			pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskNOT_WAITING_NOTIFICATION;
 		}
 		taskEXIT_CRITICAL();
 
@@ -4780,44 +6200,45 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue )
+	BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue )
 	{
 	TCB_t * pxTCB;
 	BaseType_t xReturn = pdPASS;
 	uint8_t ucOriginalNotifyState;
 
 		configASSERT( xTaskToNotify );
+		configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
 		pxTCB = xTaskToNotify;
 
 		taskENTER_CRITICAL();
 		{
 			if( pulPreviousNotificationValue != NULL )
 			{
-				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue;
+				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue[ uxIndexToNotify ];
 			}
 
-			ucOriginalNotifyState = pxTCB->ucNotifyState;
+			ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
 
-			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+			pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
 
 			switch( eAction )
 			{
 				case eSetBits	:
-					pxTCB->ulNotifiedValue |= ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] |= ulValue;
 					break;
 
 				case eIncrement	:
-					( pxTCB->ulNotifiedValue )++;
+					( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
 					break;
 
 				case eSetValueWithOverwrite	:
-					pxTCB->ulNotifiedValue = ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					break;
 
 				case eSetValueWithoutOverwrite :
 					if( ucOriginalNotifyState != taskNOTIFICATION_RECEIVED )
 					{
-						pxTCB->ulNotifiedValue = ulValue;
+						pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					}
 					else
 					{
@@ -4835,7 +6256,7 @@ TickType_t uxReturn;
 					/* Should not get here if all enums are handled.
 					Artificially force an assert by testing a value the
 					compiler can't assume is const. */
-					configASSERT( pxTCB->ulNotifiedValue == ~0UL );
+					configASSERT( pxTCB->ulNotifiedValue[ uxIndexToNotify ] == ~0UL );
 
 					break;
 			}
@@ -4846,7 +6267,7 @@ TickType_t uxReturn;
 			notification then unblock it now. */
 			if( ucOriginalNotifyState == taskWAITING_NOTIFICATION )
 			{
-				( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+				( void ) taskREMOVE_STATE_LIST_ITEM( pxTCB );
 				prvAddTaskToReadyList( pxTCB );
 
 				/* The task should not have been on an event list. */
@@ -4868,7 +6289,7 @@ TickType_t uxReturn;
 				}
 				#endif
 
-				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				if( taskPREEMPTS_CURRENT_TASK( pxTCB ) )
 				{
 					/* The notified task has a priority above the currently
 					executing task so a yield is required. */
@@ -4894,7 +6315,7 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue, BaseType_t *pxHigherPriorityTaskWoken )
+	BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue, BaseType_t *pxHigherPriorityTaskWoken )
 	{
 	TCB_t * pxTCB;
 	uint8_t ucOriginalNotifyState;
@@ -4902,6 +6323,7 @@ TickType_t uxReturn;
 	UBaseType_t uxSavedInterruptStatus;
 
 		configASSERT( xTaskToNotify );
+		configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
 
 		/* RTOS ports that support interrupt nesting have the concept of a
 		maximum	system call (or maximum API call) interrupt priority.
@@ -4927,30 +6349,30 @@ TickType_t uxReturn;
 		{
 			if( pulPreviousNotificationValue != NULL )
 			{
-				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue;
+				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue[ uxIndexToNotify ];
 			}
 
-			ucOriginalNotifyState = pxTCB->ucNotifyState;
-			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+			ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
+			pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
 
 			switch( eAction )
 			{
 				case eSetBits	:
-					pxTCB->ulNotifiedValue |= ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] |= ulValue;
 					break;
 
 				case eIncrement	:
-					( pxTCB->ulNotifiedValue )++;
+					( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
 					break;
 
 				case eSetValueWithOverwrite	:
-					pxTCB->ulNotifiedValue = ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					break;
 
 				case eSetValueWithoutOverwrite :
 					if( ucOriginalNotifyState != taskNOTIFICATION_RECEIVED )
 					{
-						pxTCB->ulNotifiedValue = ulValue;
+						pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					}
 					else
 					{
@@ -4968,7 +6390,7 @@ TickType_t uxReturn;
 					/* Should not get here if all enums are handled.
 					Artificially force an assert by testing a value the
 					compiler can't assume is const. */
-					configASSERT( pxTCB->ulNotifiedValue == ~0UL );
+					configASSERT( pxTCB->ulNotifiedValue[ uxIndexToNotify ] == ~0UL );
 					break;
 			}
 
@@ -4983,7 +6405,7 @@ TickType_t uxReturn;
 
 				if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
 				{
-					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					( void ) taskREMOVE_STATE_LIST_ITEM( pxTCB );
 					prvAddTaskToReadyList( pxTCB );
 				}
 				else
@@ -4993,7 +6415,7 @@ TickType_t uxReturn;
 					vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
 				}
 
-				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				if( taskPREEMPTS_CURRENT_TASK( pxTCB ) )
 				{
 					/* The notified task has a priority above the currently
 					executing task so a yield is required. */
@@ -5023,13 +6445,14 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	void vTaskNotifyGiveFromISR( TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken )
+	void vTaskGenericNotifyGiveFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, BaseType_t *pxHigherPriorityTaskWoken )
 	{
 	TCB_t * pxTCB;
 	uint8_t ucOriginalNotifyState;
 	UBaseType_t uxSavedInterruptStatus;
 
 		configASSERT( xTaskToNotify );
+		configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
 
 		/* RTOS ports that support interrupt nesting have the concept of a
 		maximum	system call (or maximum API call) interrupt priority.
@@ -5053,12 +6476,12 @@ TickType_t uxReturn;
 
 		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
 		{
-			ucOriginalNotifyState = pxTCB->ucNotifyState;
-			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+			ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
+			pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
 
 			/* 'Giving' is equivalent to incrementing a count in a counting
 			semaphore. */
-			( pxTCB->ulNotifiedValue )++;
+			( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
 
 			traceTASK_NOTIFY_GIVE_FROM_ISR();
 
@@ -5071,7 +6494,7 @@ TickType_t uxReturn;
 
 				if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
 				{
-					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					( void ) taskREMOVE_STATE_LIST_ITEM( pxTCB );
 					prvAddTaskToReadyList( pxTCB );
 				}
 				else
@@ -5081,7 +6504,7 @@ TickType_t uxReturn;
 					vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
 				}
 
-				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				if( taskPREEMPTS_CURRENT_TASK( pxTCB ) )
 				{
 					/* The notified task has a priority above the currently
 					executing task so a yield is required. */
@@ -5109,20 +6532,22 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskNotifyStateClear( TaskHandle_t xTask )
+	BaseType_t xTaskGenericNotifyStateClear( TaskHandle_t xTask, UBaseType_t uxIndexToClear )
 	{
 	TCB_t *pxTCB;
 	BaseType_t xReturn;
 
+		configASSERT( uxIndexToClear < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		/* If null is passed in here then it is the calling task that is having
 		its notification state cleared. */
 		pxTCB = prvGetTCBFromHandle( xTask );
 
 		taskENTER_CRITICAL();
 		{
-			if( pxTCB->ucNotifyState == taskNOTIFICATION_RECEIVED )
+			if( pxTCB->ucNotifyState[ uxIndexToClear ] == taskNOTIFICATION_RECEIVED )
 			{
-				pxTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+				pxTCB->ucNotifyState[ uxIndexToClear ] = taskNOT_WAITING_NOTIFICATION;
 				xReturn = pdPASS;
 			}
 			else
@@ -5140,11 +6565,13 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	uint32_t ulTaskNotifyValueClear( TaskHandle_t xTask, uint32_t ulBitsToClear )
+	uint32_t ulTaskGenericNotifyValueClear( TaskHandle_t xTask, UBaseType_t uxIndexToClear, uint32_t ulBitsToClear )
 	{
 	TCB_t *pxTCB;
 	uint32_t ulReturn;
 
+		configASSERT( uxIndexToClear < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		/* If null is passed in here then it is the calling task that is having
 		its notification state cleared. */
 		pxTCB = prvGetTCBFromHandle( xTask );
@@ -5153,8 +6580,8 @@ TickType_t uxReturn;
 		{
 			/* Return the notification as it was before the bits were cleared,
 			then clear the bit mask. */
-			ulReturn = pxCurrentTCB->ulNotifiedValue;
-			pxTCB->ulNotifiedValue &= ~ulBitsToClear;
+			ulReturn = pxTCB->ulNotifiedValue[ uxIndexToClear ];
+			pxTCB->ulNotifiedValue[ uxIndexToClear ] &= ~ulBitsToClear;
 		}
 		taskEXIT_CRITICAL();
 
@@ -5177,7 +6604,7 @@ TickType_t uxReturn;
 static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait, const BaseType_t xCanBlockIndefinitely )
 {
 TickType_t xTimeToWake;
-const TickType_t xConstTickCount = xTickCount;
+const TickType_t xConstTickCount = taskGET_TICK_COUNT();
 
 	#if( INCLUDE_xTaskAbortDelay == 1 )
 	{
@@ -5217,20 +6644,20 @@ const TickType_t xConstTickCount = xTickCount;
 			kernel will manage it correctly. */
 			xTimeToWake = xConstTickCount + xTicksToWait;
 
-			/* The list item will be inserted in wake time order. */
+			/* The wake time is held in the list item value. */
 			listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
 			if( xTimeToWake < xConstTickCount )
 			{
 				/* Wake time has overflowed.  Place this item in the overflow
 				list. */
-				vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+				taskINSERT_DELAYED_TASK( pxOverflowDelayedTaskList, pxCurrentTCB );
 			}
 			else
 			{
 				/* The wake time has not overflowed, so the current block list
 				is used. */
-				vListInsert( pxDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+				taskINSERT_DELAYED_TASK( pxDelayedTaskList, pxCurrentTCB );
 
 				/* If the task entering the blocked state was placed at the
 				head of the list of blocked tasks then xNextTaskUnblockTime
@@ -5253,18 +6680,18 @@ const TickType_t xConstTickCount = xTickCount;
 		will manage it correctly. */
 		xTimeToWake = xConstTickCount + xTicksToWait;
 
-		/* The list item will be inserted in wake time order. */
+		/* The wake time is held in the list item value. */
 		listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
 		if( xTimeToWake < xConstTickCount )
 		{
 			/* Wake time has overflowed.  Place this item in the overflow list. */
-			vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+			taskINSERT_DELAYED_TASK( pxOverflowDelayedTaskList, pxCurrentTCB );
 		}
 		else
 		{
 			/* The wake time has not overflowed, so the current block list is used. */
-			vListInsert( pxDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+			taskINSERT_DELAYED_TASK( pxDelayedTaskList, pxCurrentTCB );
 
 			/* If the task entering the blocked state was placed at the head of the
 			list of blocked tasks then xNextTaskUnblockTime needs to be updated
@@ -5284,6 +6711,194 @@ const TickType_t xConstTickCount = xTickCount;
 	}
 	#endif /* INCLUDE_vTaskSuspend */
 }
+/*-----------------------------------------------------------*/
+
+#if( configUSE_DELAYED_TASK_HEAP == 1 )
+
+	static TCB_t *prvDelayedTaskHeapLink( TCB_t *pxFirst, TCB_t *pxSecond )
+	{
+	TCB_t *pxParent, *pxChild;
+
+		/* Where the wake times are equal pxFirst remains the root, so a task
+		that is inserted into the heap does not overtake a task that is already
+		in the heap and due to wake at the same time. */
+		if( listGET_LIST_ITEM_VALUE( &( pxSecond->xStateListItem ) ) < listGET_LIST_ITEM_VALUE( &( pxFirst->xStateListItem ) ) )
+		{
+			pxParent = pxSecond;
+			pxChild = pxFirst;
+		}
+		else
+		{
+			pxParent = pxFirst;
+			pxChild = pxSecond;
+		}
+
+		pxChild->pxDelayedHeapPrevious = pxParent;
+		pxChild->pxDelayedHeapSibling = pxParent->pxDelayedHeapChild;
+
+		if( pxParent->pxDelayedHeapChild != NULL )
+		{
+			pxParent->pxDelayedHeapChild->pxDelayedHeapPrevious = pxChild;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxParent->pxDelayedHeapChild = pxChild;
+		pxParent->pxDelayedHeapSibling = NULL;
+		pxParent->pxDelayedHeapPrevious = NULL;
+
+		return pxParent;
+	}
+
+#endif /* configUSE_DELAYED_TASK_HEAP */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_DELAYED_TASK_HEAP == 1 )
+
+	static TCB_t *prvDelayedTaskHeapMergePairs( TCB_t *pxFirstSibling )
+	{
+	TCB_t *pxFirst, *pxSecond, *pxNext, *pxPairs = NULL, *pxRoot = NULL;
+
+		/* First pass - link the siblings together in pairs from left to
+		right.  The resulting heaps are pushed onto a stack, using the sibling
+		pointer, so the second pass sees them in right to left order. */
+		while( pxFirstSibling != NULL )
+		{
+			pxFirst = pxFirstSibling;
+			pxSecond = pxFirst->pxDelayedHeapSibling;
+
+			if( pxSecond != NULL )
+			{
+				pxNext = pxSecond->pxDelayedHeapSibling;
+				pxFirst = prvDelayedTaskHeapLink( pxFirst, pxSecond );
+			}
+			else
+			{
+				pxNext = NULL;
+			}
+
+			pxFirst->pxDelayedHeapSibling = pxPairs;
+			pxPairs = pxFirst;
+			pxFirstSibling = pxNext;
+		}
+
+		/* Second pass - link the heaps into a single heap from right to left. */
+		while( pxPairs != NULL )
+		{
+			pxNext = pxPairs->pxDelayedHeapSibling;
+
+			if( pxRoot == NULL )
+			{
+				pxRoot = pxPairs;
+				pxRoot->pxDelayedHeapSibling = NULL;
+				pxRoot->pxDelayedHeapPrevious = NULL;
+			}
+			else
+			{
+				pxRoot = prvDelayedTaskHeapLink( pxPairs, pxRoot );
+			}
+
+			pxPairs = pxNext;
+		}
+
+		return pxRoot;
+	}
+
+#endif /* configUSE_DELAYED_TASK_HEAP */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_DELAYED_TASK_HEAP == 1 )
+
+	static void prvDelayedTaskHeapInsert( TCB_t **ppxRoot, TCB_t *pxTCB )
+	{
+		pxTCB->pxDelayedHeapChild = NULL;
+		pxTCB->pxDelayedHeapSibling = NULL;
+		pxTCB->pxDelayedHeapPrevious = NULL;
+
+		if( *ppxRoot == NULL )
+		{
+			*ppxRoot = pxTCB;
+		}
+		else
+		{
+			*ppxRoot = prvDelayedTaskHeapLink( *ppxRoot, pxTCB );
+		}
+	}
+
+#endif /* configUSE_DELAYED_TASK_HEAP */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_DELAYED_TASK_HEAP == 1 )
+
+	static void prvDelayedTaskHeapRemove( TCB_t **ppxRoot, TCB_t *pxTCB )
+	{
+	TCB_t *pxSubHeap;
+
+		pxSubHeap = prvDelayedTaskHeapMergePairs( pxTCB->pxDelayedHeapChild );
+
+		if( pxTCB == *ppxRoot )
+		{
+			/* This is the path taken when the tick interrupt unblocks the task
+			with the earliest wake time. */
+			*ppxRoot = pxSubHeap;
+		}
+		else
+		{
+			/* Unlink the task from its parent or previous sibling, then merge
+			its children back into the heap. */
+			if( pxTCB->pxDelayedHeapPrevious->pxDelayedHeapChild == pxTCB )
+			{
+				pxTCB->pxDelayedHeapPrevious->pxDelayedHeapChild = pxTCB->pxDelayedHeapSibling;
+			}
+			else
+			{
+				pxTCB->pxDelayedHeapPrevious->pxDelayedHeapSibling = pxTCB->pxDelayedHeapSibling;
+			}
+
+			if( pxTCB->pxDelayedHeapSibling != NULL )
+			{
+				pxTCB->pxDelayedHeapSibling->pxDelayedHeapPrevious = pxTCB->pxDelayedHeapPrevious;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( pxSubHeap != NULL )
+			{
+				*ppxRoot = prvDelayedTaskHeapLink( *ppxRoot, pxSubHeap );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+
+#endif /* configUSE_DELAYED_TASK_HEAP */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_DELAYED_TASK_HEAP == 1 )
+
+	static UBaseType_t prvRemoveStateListItem( TCB_t *pxTCB )
+	{
+	const List_t * const pxList = listLIST_ITEM_CONTAINER( &( pxTCB->xStateListItem ) );
+
+		if( ( pxList == &xDelayedTaskList1 ) || ( pxList == &xDelayedTaskList2 ) )
+		{
+			prvDelayedTaskHeapRemove( taskDELAYED_TASK_HEAP( pxList ), pxTCB );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return uxListRemove( &( pxTCB->xStateListItem ) );
+	}
+
+#endif /* configUSE_DELAYED_TASK_HEAP */
 
 /* Code below here allows additional code to be inserted into this source file,
 especially where access to file scope functions and data is needed (for example
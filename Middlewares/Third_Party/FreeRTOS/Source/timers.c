@@ -69,6 +69,49 @@ defining trmTIMER_SERVICE_TASK_NAME in FreeRTOSConfig.h. */
 #define tmrSTATUS_IS_STATICALLY_ALLOCATED	( ( uint8_t ) 0x02 )
 #define tmrSTATUS_IS_AUTORELOAD				( ( uint8_t ) 0x04 )
 
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	/* When configUSE_TIMER_WHEEL is 1 active timers are held in a hierarchical
+	timing wheel instead of in sorted lists.  Each level of the wheel has
+	tmrWHEEL_SLOTS slots.  A slot in level 0 holds the timers that expire on
+	one particular tick, and a slot in each higher level spans tmrWHEEL_SLOTS
+	slots of the level below.  A timer is placed in the lowest level that can
+	hold its expiry time, then moved down (cascaded) when the wheel time reaches
+	the start of the slot it is in - so starting, stopping and expiring a timer
+	never has to search a list. */
+	#define tmrWHEEL_SLOT_BITS		( 5U )
+	#define tmrWHEEL_SLOTS			( ( UBaseType_t ) 1U << tmrWHEEL_SLOT_BITS )
+	#define tmrWHEEL_SLOT_MASK		( tmrWHEEL_SLOTS - ( UBaseType_t ) 1U )
+
+	/* Enough levels are needed to span the whole tick count range.  The top
+	level only needs as many slots as there are tick count bits left over. */
+	#if( configUSE_16_BIT_TICKS == 1 )
+		#define tmrWHEEL_LEVELS		( 4U )
+		#define tmrWHEEL_TOP_SLOTS	( 2U )
+	#else
+		#define tmrWHEEL_LEVELS		( 7U )
+		#define tmrWHEEL_TOP_SLOTS	( 4U )
+	#endif
+
+	#define tmrWHEEL_LISTS			( ( ( tmrWHEEL_LEVELS - 1U ) * tmrWHEEL_SLOTS ) + tmrWHEEL_TOP_SLOTS )
+
+	/* Expiry times are measured relative to the wheel time, which is never
+	ahead of the tick count by more than one, so are compared in a way that
+	works when they wrap past the end of the tick count range. */
+	#define tmrTIMER_IS_DUE( xExpireTime, xTimeNow )	( ( TickType_t ) ( ( xExpireTime ) - xTimerWheelTime ) < ( TickType_t ) ( ( ( xTimeNow ) + ( TickType_t ) 1U ) - xTimerWheelTime ) )
+
+	/* The timers that expire on the current wheel tick. */
+	#define tmrEXPIRED_TIMER_LIST()						( &( xTimerWheel[ xTimerWheelTime & tmrWHEEL_SLOT_MASK ] ) )
+	#define tmrREMOVE_FROM_ACTIVE_LIST( pxTimer )		prvTimerWheelRemove( pxTimer )
+
+#else
+
+	#define tmrTIMER_IS_DUE( xExpireTime, xTimeNow )	( ( xExpireTime ) <= ( xTimeNow ) )
+	#define tmrEXPIRED_TIMER_LIST()						( pxCurrentTimerList )
+	#define tmrREMOVE_FROM_ACTIVE_LIST( pxTimer )		( void ) uxListRemove( &( ( pxTimer )->xTimerListItem ) )
+
+#endif /* configUSE_TIMER_WHEEL */
+
 /* The definition of the timers themselves. */
 typedef struct tmrTimerControl /* The old naming convention is used to prevent breaking kernel aware debuggers. */
 {
@@ -137,6 +180,18 @@ PRIVILEGED_DATA static List_t xActiveTimerList2;
 PRIVILEGED_DATA static List_t *pxCurrentTimerList;
 PRIVILEGED_DATA static List_t *pxOverflowTimerList;
 
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	/* The slots of the timing wheel, level 0 first.  A bit is set in
+	ulTimerWheelSlotsInUse[] for each slot that is not empty, and
+	xTimerWheelTime is the next tick the wheel has still to process.  As with
+	the lists above, only the timer service task accesses these. */
+	PRIVILEGED_DATA static List_t xTimerWheel[ tmrWHEEL_LISTS ];
+	PRIVILEGED_DATA static uint32_t ulTimerWheelSlotsInUse[ tmrWHEEL_LEVELS ];
+	PRIVILEGED_DATA static TickType_t xTimerWheelTime;
+
+#endif /* configUSE_TIMER_WHEEL */
+
 /* A queue that is used to send commands to the timer service task. */
 PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
 PRIVILEGED_DATA static TaskHandle_t xTimerTaskHandle = NULL;
@@ -190,7 +245,60 @@ static void prvProcessExpiredTimer( const TickType_t xNextExpireTime, const Tick
  * The tick count has overflowed.  Switch the timer lists after ensuring the
  * current timer list does not still reference some timers.
  */
-static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+#if( configUSE_TIMER_WHEEL == 0 )
+	static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+#endif
+
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	/*
+	 * Move the wheel time to xNextEventTime, cascade any slots that start at
+	 * that time, then process one timer if any expire at that time.
+	 */
+	static void prvProcessTimerWheel( const TickType_t xNextEventTime, const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Place a timer in the wheel slot that holds its expiry time, first moving
+	 * the wheel time up to xTimeNow if nothing is due before then.
+	 */
+	static void prvTimerWheelInsert( Timer_t * const pxTimer, const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Place a timer in the wheel slot that holds its expiry time relative to
+	 * the current wheel time.
+	 */
+	static void prvTimerWheelAddTimer( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Remove a timer from the wheel slot it is in.
+	 */
+	static void prvTimerWheelRemove( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Move the timers out of each slot that starts at the current wheel time
+	 * into the levels below.
+	 */
+	static void prvTimerWheelCascade( void ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Return the number of ticks from the current wheel time to the next tick
+	 * at which either a timer expires or a slot must be cascaded.  Must not be
+	 * called if the wheel is empty.
+	 */
+	static TickType_t prvTimerWheelTicksToNextEvent( void ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Return the number of slots from uxFirstSlot to the first slot that has
+	 * its bit set in ulSlotsInUse, wrapping after uxNumberOfSlots slots.
+	 */
+	static UBaseType_t prvTimerWheelNextSlotInUse( const uint32_t ulSlotsInUse, const UBaseType_t uxFirstSlot, const UBaseType_t uxNumberOfSlots ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Return pdTRUE if there are no timers in the wheel.
+	 */
+	static BaseType_t prvTimerWheelIsEmpty( void ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TIMER_WHEEL */
 
 /*
  * Obtain the current tick count, setting *pxTimerListsWereSwitched to pdTRUE
@@ -507,11 +615,11 @@ Timer_t *pxTimer = xTimer;
 static void prvProcessExpiredTimer( const TickType_t xNextExpireTime, const TickType_t xTimeNow )
 {
 BaseType_t xResult;
-Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( tmrEXPIRED_TIMER_LIST() ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
 
 	/* Remove the timer from the list of active timers.  A check has already
 	been performed to ensure the list is not empty. */
-	( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+	tmrREMOVE_FROM_ACTIVE_LIST( pxTimer );
 	traceTIMER_EXPIRED( pxTimer );
 
 	/* If the timer is an auto-reload timer then calculate the next
@@ -597,10 +705,19 @@ BaseType_t xTimerListsWereSwitched;
 		if( xTimerListsWereSwitched == pdFALSE )
 		{
 			/* The tick count has not overflowed, has the timer expired? */
-			if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
+			if( ( xListWasEmpty == pdFALSE ) && ( tmrTIMER_IS_DUE( xNextExpireTime, xTimeNow ) ) )
 			{
 				( void ) xTaskResumeAll();
-				prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
+
+				#if( configUSE_TIMER_WHEEL == 1 )
+				{
+					prvProcessTimerWheel( xNextExpireTime, xTimeNow );
+				}
+				#else
+				{
+					prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
+				}
+				#endif
 			}
 			else
 			{
@@ -652,16 +769,35 @@ TickType_t xNextExpireTime;
 	this task to unblock when the tick count overflows, at which point the
 	timer lists will be switched and the next expiry time can be
 	re-assessed.  */
-	*pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
-	if( *pxListWasEmpty == pdFALSE )
+	#if( configUSE_TIMER_WHEEL == 1 )
 	{
-		xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+		/* When the timing wheel is used the time returned is the next tick at
+		which the wheel needs processing, which is either the time at which a
+		timer expires or the time at which a slot has to be cascaded. */
+		*pxListWasEmpty = prvTimerWheelIsEmpty();
+		if( *pxListWasEmpty == pdFALSE )
+		{
+			xNextExpireTime = xTimerWheelTime + prvTimerWheelTicksToNextEvent();
+		}
+		else
+		{
+			xNextExpireTime = ( TickType_t ) 0U;
+		}
 	}
-	else
+	#else
 	{
-		/* Ensure the task unblocks when the tick count rolls over. */
-		xNextExpireTime = ( TickType_t ) 0U;
+		*pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
+		if( *pxListWasEmpty == pdFALSE )
+		{
+			xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+		}
+		else
+		{
+			/* Ensure the task unblocks when the tick count rolls over. */
+			xNextExpireTime = ( TickType_t ) 0U;
+		}
 	}
+	#endif /* configUSE_TIMER_WHEEL */
 
 	return xNextExpireTime;
 }
@@ -670,21 +806,33 @@ TickType_t xNextExpireTime;
 static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
 {
 TickType_t xTimeNow;
-PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Variable is only accessible to one task. */
 
 	xTimeNow = xTaskGetTickCount();
 
-	if( xTimeNow < xLastTime )
-	{
-		prvSwitchTimerLists();
-		*pxTimerListsWereSwitched = pdTRUE;
-	}
-	else
+	#if( configUSE_TIMER_WHEEL == 1 )
 	{
+		/* The position of a timer in the wheel is relative to the wheel time,
+		not to the start of the tick count range, so there are no lists to
+		switch when the tick count overflows. */
 		*pxTimerListsWereSwitched = pdFALSE;
 	}
+	#else
+	{
+		PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Variable is only accessible to one task. */
 
-	xLastTime = xTimeNow;
+		if( xTimeNow < xLastTime )
+		{
+			prvSwitchTimerLists();
+			*pxTimerListsWereSwitched = pdTRUE;
+		}
+		else
+		{
+			*pxTimerListsWereSwitched = pdFALSE;
+		}
+
+		xLastTime = xTimeNow;
+	}
+	#endif /* configUSE_TIMER_WHEEL */
 
 	return xTimeNow;
 }
@@ -709,7 +857,15 @@ BaseType_t xProcessTimerNow = pdFALSE;
 		}
 		else
 		{
-			vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+			#if( configUSE_TIMER_WHEEL == 1 )
+			{
+				prvTimerWheelInsert( pxTimer, xTimeNow );
+			}
+			#else
+			{
+				vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+			}
+			#endif
 		}
 	}
 	else
@@ -723,7 +879,15 @@ BaseType_t xProcessTimerNow = pdFALSE;
 		}
 		else
 		{
-			vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+			#if( configUSE_TIMER_WHEEL == 1 )
+			{
+				prvTimerWheelInsert( pxTimer, xTimeNow );
+			}
+			#else
+			{
+				vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+			}
+			#endif
 		}
 	}
 
@@ -773,7 +937,7 @@ TickType_t xTimeNow;
 			if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
 			{
 				/* The timer is in a list, remove it. */
-				( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+				tmrREMOVE_FROM_ACTIVE_LIST( pxTimer );
 			}
 			else
 			{
@@ -879,6 +1043,8 @@ TickType_t xTimeNow;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TIMER_WHEEL == 0 )
+
 static void prvSwitchTimerLists( void )
 {
 TickType_t xNextExpireTime, xReloadTime;
@@ -936,8 +1102,224 @@ BaseType_t xResult;
 	pxCurrentTimerList = pxOverflowTimerList;
 	pxOverflowTimerList = pxTemp;
 }
+
+#endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	static void prvProcessTimerWheel( const TickType_t xNextEventTime, const TickType_t xTimeNow )
+	{
+		/* No timer expires, and no slot needs cascading, before
+		xNextEventTime, so the wheel can move straight to it. */
+		xTimerWheelTime = xNextEventTime;
+		prvTimerWheelCascade();
+
+		/* The event may only have been a cascade, in which case no timer has
+		expired yet. */
+		if( listLIST_IS_EMPTY( tmrEXPIRED_TIMER_LIST() ) == pdFALSE )
+		{
+			prvProcessExpiredTimer( xTimerWheelTime, xTimeNow );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvTimerWheelInsert( Timer_t * const pxTimer, const TickType_t xTimeNow )
+	{
+		/* The slot a timer is placed in depends on how far its expiry time is
+		from the wheel time.  The wheel time only moves when there is something
+		to process, so bring it up to date first if nothing is due - otherwise
+		it could fall far enough behind for that distance to overflow. */
+		if( prvTimerWheelIsEmpty() != pdFALSE )
+		{
+			xTimerWheelTime = xTimeNow + ( TickType_t ) 1U;
+		}
+		else if( tmrTIMER_IS_DUE( xTimerWheelTime + prvTimerWheelTicksToNextEvent(), xTimeNow ) == pdFALSE )
+		{
+			xTimerWheelTime = xTimeNow + ( TickType_t ) 1U;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		prvTimerWheelAddTimer( pxTimer );
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvTimerWheelAddTimer( Timer_t * const pxTimer )
+	{
+	const TickType_t xExpiryTime = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
+	const TickType_t xTicksToExpiry = xExpiryTime - xTimerWheelTime;
+	UBaseType_t uxLevel = 0U, uxSlot;
+
+		/* Use the lowest level that spans the time to expiry. */
+		while( ( uxLevel < ( tmrWHEEL_LEVELS - 1U ) ) && ( xTicksToExpiry >= ( TickType_t ) ( ( TickType_t ) 1U << ( ( uxLevel + 1U ) * tmrWHEEL_SLOT_BITS ) ) ) )
+		{
+			uxLevel++;
+		}
+
+		uxSlot = ( UBaseType_t ) ( xExpiryTime >> ( uxLevel * tmrWHEEL_SLOT_BITS ) ) & tmrWHEEL_SLOT_MASK;
+
+		vListInsertEnd( &( xTimerWheel[ ( uxLevel * tmrWHEEL_SLOTS ) + uxSlot ] ), &( pxTimer->xTimerListItem ) );
+		ulTimerWheelSlotsInUse[ uxLevel ] |= ( 1UL << uxSlot );
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvTimerWheelRemove( Timer_t * const pxTimer )
+	{
+	const UBaseType_t uxList = ( UBaseType_t ) ( listLIST_ITEM_CONTAINER( &( pxTimer->xTimerListItem ) ) - xTimerWheel );
+
+		if( uxListRemove( &( pxTimer->xTimerListItem ) ) == ( UBaseType_t ) 0 )
+		{
+			ulTimerWheelSlotsInUse[ uxList / tmrWHEEL_SLOTS ] &= ~( 1UL << ( uxList & tmrWHEEL_SLOT_MASK ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvTimerWheelCascade( void )
+	{
+	UBaseType_t uxLevel, uxSlot, uxShift;
+	List_t *pxList;
+	Timer_t *pxTimer;
+
+		for( uxLevel = 1U; uxLevel < tmrWHEEL_LEVELS; uxLevel++ )
+		{
+			uxShift = uxLevel * tmrWHEEL_SLOT_BITS;
+
+			/* A slot in this level only starts when the wheel time is at the
+			start of a slot in every level below. */
+			if( ( xTimerWheelTime & ( TickType_t ) ( ( ( TickType_t ) 1U << uxShift ) - ( TickType_t ) 1U ) ) != ( TickType_t ) 0U )
+			{
+				break;
+			}
+
+			uxSlot = ( UBaseType_t ) ( xTimerWheelTime >> uxShift ) & tmrWHEEL_SLOT_MASK;
+			pxList = &( xTimerWheel[ ( uxLevel * tmrWHEEL_SLOTS ) + uxSlot ] );
+
+			/* Every timer in the slot now expires within the span of one slot
+			of this level, so is re-inserted into a lower level. */
+			while( listLIST_IS_EMPTY( pxList ) == pdFALSE )
+			{
+				pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+				( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+				prvTimerWheelAddTimer( pxTimer );
+			}
+
+			ulTimerWheelSlotsInUse[ uxLevel ] &= ~( 1UL << uxSlot );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static TickType_t prvTimerWheelTicksToNextEvent( void )
+	{
+	TickType_t xTicksToNextEvent = portMAX_DELAY, xTicks, xSlotStart;
+	UBaseType_t uxLevel, uxShift, uxNumberOfSlots;
+
+		for( uxLevel = 0U; uxLevel < tmrWHEEL_LEVELS; uxLevel++ )
+		{
+			if( ulTimerWheelSlotsInUse[ uxLevel ] != 0UL )
+			{
+				uxShift = uxLevel * tmrWHEEL_SLOT_BITS;
+
+				if( uxLevel == ( tmrWHEEL_LEVELS - 1U ) )
+				{
+					uxNumberOfSlots = tmrWHEEL_TOP_SLOTS;
+				}
+				else
+				{
+					uxNumberOfSlots = tmrWHEEL_SLOTS;
+				}
+
+				/* Timers in level 0 expire at the start of their slot, and
+				slots in higher levels are cascaded at the start of the slot.
+				If the wheel time is part way through a slot then the first
+				slot that can next start is the one after it. */
+				xSlotStart = xTimerWheelTime >> uxShift;
+
+				if( ( xTimerWheelTime & ( TickType_t ) ( ( ( TickType_t ) 1U << uxShift ) - ( TickType_t ) 1U ) ) != ( TickType_t ) 0U )
+				{
+					xSlotStart++;
+				}
+
+				xSlotStart += ( TickType_t ) prvTimerWheelNextSlotInUse( ulTimerWheelSlotsInUse[ uxLevel ], ( UBaseType_t ) xSlotStart & ( uxNumberOfSlots - 1U ), uxNumberOfSlots );
+				xTicks = ( TickType_t ) ( xSlotStart << uxShift ) - xTimerWheelTime;
+
+				if( xTicks < xTicksToNextEvent )
+				{
+					xTicksToNextEvent = xTicks;
+				}
+			}
+		}
+
+		return xTicksToNextEvent;
+	}
+	/*-----------------------------------------------------------*/
+
+	static UBaseType_t prvTimerWheelNextSlotInUse( const uint32_t ulSlotsInUse, const UBaseType_t uxFirstSlot, const UBaseType_t uxNumberOfSlots )
+	{
+	uint32_t ulSlots;
+	UBaseType_t uxSlots;
+
+		/* Rotate the bits so the bit for uxFirstSlot is bit 0. */
+		ulSlots = ulSlotsInUse >> uxFirstSlot;
+
+		if( uxFirstSlot != 0U )
+		{
+			ulSlots |= ulSlotsInUse << ( uxNumberOfSlots - uxFirstSlot );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		configASSERT( ulSlots );
+
+		#if defined( __GNUC__ )
+		{
+			uxSlots = ( UBaseType_t ) __builtin_ctz( ulSlots );
+		}
+		#else
+		{
+			for( uxSlots = 0U; ( ulSlots & 1UL ) == 0UL; uxSlots++ )
+			{
+				ulSlots >>= 1;
+			}
+		}
+		#endif
+
+		return uxSlots;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvTimerWheelIsEmpty( void )
+	{
+	UBaseType_t uxLevel;
+	BaseType_t xReturn = pdTRUE;
+
+		for( uxLevel = 0U; uxLevel < tmrWHEEL_LEVELS; uxLevel++ )
+		{
+			if( ulTimerWheelSlotsInUse[ uxLevel ] != 0UL )
+			{
+				xReturn = pdFALSE;
+				break;
+			}
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configUSE_TIMER_WHEEL */
+
 static void prvCheckForValidListAndQueue( void )
 {
 	/* Check that the list from which active timers are referenced, and the
@@ -952,6 +1334,24 @@ static void prvCheckForValidListAndQueue( void )
 			pxCurrentTimerList = &xActiveTimerList1;
 			pxOverflowTimerList = &xActiveTimerList2;
 
+			#if( configUSE_TIMER_WHEEL == 1 )
+			{
+				UBaseType_t uxList;
+
+				for( uxList = 0U; uxList < tmrWHEEL_LISTS; uxList++ )
+				{
+					vListInitialise( &( xTimerWheel[ uxList ] ) );
+				}
+
+				for( uxList = 0U; uxList < tmrWHEEL_LEVELS; uxList++ )
+				{
+					ulTimerWheelSlotsInUse[ uxList ] = 0UL;
+				}
+
+				xTimerWheelTime = xTaskGetTickCount();
+			}
+			#endif /* configUSE_TIMER_WHEEL */
+
 			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
 			{
 				/* The timer queue is allocated statically in case
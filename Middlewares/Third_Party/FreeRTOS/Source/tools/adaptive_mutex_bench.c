@@ -0,0 +1,316 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side benchmark of adaptive mutexes against the mutex type semaphores
+ * created by xSemaphoreCreateMutex().  It reports the median number of cycles
+ * taken to take and give a mutex that no other task holds, then the average
+ * number of cycles per take and give when two tasks of equal priority compete
+ * for the mutex, each yielding while it holds it so the other always finds it
+ * held.  It then checks that the holder of an adaptive mutex inherits the
+ * priority of a higher priority task blocked on the mutex, and disinherits it
+ * both when the mutex is given and when the higher priority task times out,
+ * and that the mutex provides mutual exclusion throughout.
+ *
+ * Build with the POSIX port, adaptive_mutex.c and heap_4, using a
+ * FreeRTOSConfig.h that sets configUSE_ADAPTIVE_MUTEXES, configUSE_MUTEXES,
+ * INCLUDE_vTaskDelete and INCLUDE_uxTaskPriorityGet to 1.  On the POSIX port a
+ * context switch signals a host thread, so the contended figures are dominated
+ * by the number of context switches each mutex causes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "adaptive_mutex.h"
+
+#define benchSAMPLES				100000UL
+#define benchCONTENDED_LOOPS		2000UL
+#define benchLOW_PRIORITY			( tskIDLE_PRIORITY + 1 )
+#define benchWORKER_PRIORITY		( tskIDLE_PRIORITY + 2 )
+#define benchCONTROL_PRIORITY		( tskIDLE_PRIORITY + 3 )
+
+/* The stack size of every task, which must be at least PTHREAD_STACK_MIN
+bytes. */
+#define benchSTACK_SIZE				( ( configSTACK_DEPTH_TYPE ) ( 65536 / sizeof( StackType_t ) ) )
+
+/* The mutex being used by the contended test, only one of which is not
+NULL. */
+static SemaphoreHandle_t xQueueMutex = NULL;
+static AdaptiveMutexHandle_t xAdaptiveMutex = NULL;
+
+static TaskHandle_t xControlTask = NULL;
+static volatile uint32_t ulInside = 0, ulErrors = 0;
+static volatile UBaseType_t uxPriorityWhileHeld, uxPriorityAfterGive;
+static uint64_t ullCycles[ benchSAMPLES ];
+
+/*-----------------------------------------------------------*/
+
+static int prvCompareCycles( const void *pv1, const void *pv2 )
+{
+uint64_t ull1 = *( const uint64_t * ) pv1, ull2 = *( const uint64_t * ) pv2;
+
+	return ( ull1 > ull2 ) - ( ull1 < ull2 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTake( void )
+{
+BaseType_t xResult;
+
+	if( xAdaptiveMutex != NULL )
+	{
+		xResult = xAdaptiveMutexTake( xAdaptiveMutex, portMAX_DELAY );
+	}
+	else
+	{
+		xResult = xSemaphoreTake( xQueueMutex, portMAX_DELAY );
+	}
+
+	if( xResult != pdPASS )
+	{
+		ulErrors++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvGive( void )
+{
+BaseType_t xResult;
+
+	if( xAdaptiveMutex != NULL )
+	{
+		xResult = xAdaptiveMutexGive( xAdaptiveMutex );
+	}
+	else
+	{
+		xResult = xSemaphoreGive( xQueueMutex );
+	}
+
+	if( xResult != pdPASS )
+	{
+		ulErrors++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvTimeUncontended( void )
+{
+uint32_t ulSample;
+uint64_t ullStart;
+
+	for( ulSample = 0; ulSample < benchSAMPLES; ulSample++ )
+	{
+		ullStart = ullPortGetCycleCounter();
+		prvTake();
+		prvGive();
+		ullCycles[ ulSample ] = ullPortGetCycleCounter() - ullStart;
+	}
+
+	qsort( ullCycles, benchSAMPLES, sizeof( ullCycles[ 0 ] ), prvCompareCycles );
+
+	return ullCycles[ benchSAMPLES / 2 ];
+}
+/*-----------------------------------------------------------*/
+
+static void prvContendingTask( void *pvParameters )
+{
+uint32_t ulLoop;
+
+	( void ) pvParameters;
+
+	for( ulLoop = 0; ulLoop < benchCONTENDED_LOOPS; ulLoop++ )
+	{
+		prvTake();
+
+		if( ulInside++ != 0UL )
+		{
+			ulErrors++;
+		}
+
+		/* Let the other task run while the mutex is held. */
+		taskYIELD();
+		ulInside--;
+
+		prvGive();
+	}
+
+	xTaskNotifyGive( xControlTask );
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvTimeContended( void )
+{
+uint64_t ullStart;
+
+	ullStart = ullPortGetCycleCounter();
+	xTaskCreate( prvContendingTask, "Contend1", benchSTACK_SIZE, NULL, benchWORKER_PRIORITY, NULL );
+	xTaskCreate( prvContendingTask, "Contend2", benchSTACK_SIZE, NULL, benchWORKER_PRIORITY, NULL );
+	( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+	( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+
+	return ( ullPortGetCycleCounter() - ullStart ) / ( 2ULL * benchCONTENDED_LOOPS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvLowPriorityHolderTask( void *pvParameters )
+{
+TickType_t xHoldTime = ( TickType_t ) ( uintptr_t ) pvParameters;
+
+	if( xAdaptiveMutexTake( xAdaptiveMutex, 0 ) != pdPASS )
+	{
+		ulErrors++;
+	}
+
+	/* Let the control task try to take the mutex, then hold on to it either
+	until the control task times out or without blocking. */
+	xTaskNotifyGive( xControlTask );
+
+	if( xHoldTime != 0 )
+	{
+		vTaskDelay( xHoldTime );
+	}
+
+	uxPriorityWhileHeld = uxTaskPriorityGet( NULL );
+	( void ) xAdaptiveMutexGive( xAdaptiveMutex );
+	uxPriorityAfterGive = uxTaskPriorityGet( NULL );
+
+	xTaskNotifyGive( xControlTask );
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvControlTask( void *pvParameters )
+{
+uint64_t ullQueueUncontended, ullAdaptiveUncontended, ullQueueContended, ullAdaptiveContended;
+TaskHandle_t xHolder;
+
+	( void ) pvParameters;
+
+	xQueueMutex = xSemaphoreCreateMutex();
+	configASSERT( xQueueMutex );
+	ullQueueUncontended = prvTimeUncontended();
+	ullQueueContended = prvTimeContended();
+	vSemaphoreDelete( xQueueMutex );
+	xQueueMutex = NULL;
+
+	xAdaptiveMutex = xAdaptiveMutexCreate();
+	configASSERT( xAdaptiveMutex );
+	ullAdaptiveUncontended = prvTimeUncontended();
+	ullAdaptiveContended = prvTimeContended();
+
+	printf( "uncontended take and give:  mutex semaphore median %lu cycles, adaptive mutex median %lu cycles\n", ( unsigned long ) ullQueueUncontended, ( unsigned long ) ullAdaptiveUncontended );
+	printf( "contended take and give:    mutex semaphore %lu cycles, adaptive mutex %lu cycles\n", ( unsigned long ) ullQueueContended, ( unsigned long ) ullAdaptiveContended );
+
+	/* Only the holder can give the mutex, and a held mutex cannot be taken
+	without blocking. */
+	if( xAdaptiveMutexGive( xAdaptiveMutex ) != pdFAIL )
+	{
+		printf( "a mutex that was not held was given\n" );
+		ulErrors++;
+	}
+
+	/* A low priority holder inherits the priority of the control task while
+	the control task is blocked on the mutex, and disinherits it when it gives
+	the mutex. */
+	xTaskCreate( prvLowPriorityHolderTask, "Holder", benchSTACK_SIZE, ( void * ) 0, benchLOW_PRIORITY, &xHolder );
+	( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+	if( xAdaptiveMutexTake( xAdaptiveMutex, 0 ) != pdFAIL )
+	{
+		printf( "a held mutex was taken\n" );
+		ulErrors++;
+	}
+
+	if( xAdaptiveMutexTake( xAdaptiveMutex, portMAX_DELAY ) != pdPASS )
+	{
+		ulErrors++;
+	}
+
+	( void ) xAdaptiveMutexGive( xAdaptiveMutex );
+	( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+	if( ( uxPriorityWhileHeld != benchCONTROL_PRIORITY ) || ( uxPriorityAfterGive != benchLOW_PRIORITY ) )
+	{
+		printf( "holder priority %lu while held and %lu after the give, expected %lu and %lu\n", ( unsigned long ) uxPriorityWhileHeld, ( unsigned long ) uxPriorityAfterGive, ( unsigned long ) benchCONTROL_PRIORITY, ( unsigned long ) benchLOW_PRIORITY );
+		ulErrors++;
+	}
+
+	/* The holder blocks while holding the mutex, so the control task times
+	out, at which point the holder disinherits the priority again. */
+	xTaskCreate( prvLowPriorityHolderTask, "Holder", benchSTACK_SIZE, ( void * ) 20, benchLOW_PRIORITY, &xHolder );
+	( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+	if( xAdaptiveMutexTake( xAdaptiveMutex, 5 ) != pdFAIL )
+	{
+		printf( "the mutex was taken while the holder was blocked\n" );
+		ulErrors++;
+	}
+
+	if( ( uxTaskPriorityGet( xHolder ) != benchLOW_PRIORITY ) || ( xAdaptiveMutexGetMutexHolder( xAdaptiveMutex ) != xHolder ) )
+	{
+		printf( "holder priority %lu after the timeout, expected %lu\n", ( unsigned long ) uxTaskPriorityGet( xHolder ), ( unsigned long ) benchLOW_PRIORITY );
+		ulErrors++;
+	}
+
+	( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+	if( uxPriorityWhileHeld != benchLOW_PRIORITY )
+	{
+		ulErrors++;
+	}
+
+	vAdaptiveMutexDelete( xAdaptiveMutex );
+
+	taskENTER_CRITICAL();
+	{
+		if( ulErrors == 0 )
+		{
+			printf( "PASS\n" );
+		}
+		else
+		{
+			printf( "FAIL: %lu errors\n", ( unsigned long ) ulErrors );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	xTaskCreate( prvControlTask, "Control", benchSTACK_SIZE, NULL, benchCONTROL_PRIORITY, &xControlTask );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
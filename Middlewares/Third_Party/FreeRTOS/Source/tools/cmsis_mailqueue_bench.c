@@ -0,0 +1,444 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side benchmark and test of the CMSIS-RTOS2 mail queues, which pass
+ * pointers to messages held in a memory pool, against message queues, which
+ * copy each message into the queue and out again.  For message sizes from 64
+ * bytes to 4 KB it reports the median number of cycles taken by a single
+ * thread to fill in a message, send it, receive it and check it, which is the
+ * cost of the copies without any context switch.  It then reports the average
+ * number of cycles per message when a producer thread fills in messages and a
+ * consumer thread of the same priority checks them.  Each is measured first
+ * through a message queue and then through a mail queue of the same depth.  It then checks that a mail queue rejects messages that
+ * are not from its pool, that a get times out on an empty queue, that messages
+ * can be put and got from an interrupt, and, when static allocation is
+ * supported, that a mail queue can be created in memory provided by the
+ * application.
+ *
+ * cmsis_os2.c is built as part of this file, with the Arm only functions of
+ * the CMSIS core header replaced by host stubs, and __get_IPSR() returning
+ * ulHostIPSR so interrupts can be simulated.  Build this file alone with the
+ * POSIX port and heap_4, with the CMSIS_RTOS_V2 directory and
+ * Drivers/CMSIS/Include on the include path, using a FreeRTOSConfig.h that
+ * meets the requirements of freertos_os2.h (in particular configMAX_PRIORITIES
+ * set to 56).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/* Skip the body of the Arm only CMSIS core header, and provide the parts that
+cmsis_os2.c uses. */
+#define __CMSIS_GCC_H
+#define CMSIS_device_header		"cmsis_compiler.h"
+#define __WEAK					__attribute__( ( weak ) )
+#define __NO_RETURN				__attribute__( ( __noreturn__ ) )
+#define __STATIC_INLINE			static inline
+
+typedef int IRQn_Type;
+
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t LOAD;
+	volatile uint32_t VAL;
+} SysTick_Type;
+
+static SysTick_Type xHostSysTick;
+#define SysTick					( &xHostSysTick )
+
+static volatile uint32_t ulHostIPSR = 0;
+
+static inline uint32_t __get_IPSR( void ) { return ulHostIPSR; }
+static inline uint32_t __get_PRIMASK( void ) { return 0; }
+static inline void __disable_irq( void ) { }
+static inline void __enable_irq( void ) { }
+static inline void NVIC_SetPriority( IRQn_Type xIRQ, uint32_t ulPriority ) { ( void ) xIRQ; ( void ) ulPriority; }
+
+#include "cmsis_os2.c"
+
+#define benchSAMPLES			20000UL
+#define benchMESSAGES			20000UL
+#define benchQUEUE_DEPTH		16UL
+#define benchMIN_MESSAGE_SIZE	64UL
+#define benchMAX_MESSAGE_SIZE	4096UL
+
+/* The stack size, which must be at least PTHREAD_STACK_MIN bytes and hold a
+message of the largest size. */
+#define benchSTACK_SIZE			65536UL
+
+static osMessageQueueId_t xMessageQueue;
+static osMailQueueId_t xMailQueue;
+static uint32_t ulMessageSize;
+static osThreadId_t xControlThread;
+static volatile uint32_t ulErrors = 0;
+static uint64_t ullCycles[ benchSAMPLES ];
+
+/*-----------------------------------------------------------*/
+
+/* cmsis_os2.c refers to the tick handler of the Arm ports. */
+void xPortSysTickHandler( void )
+{
+}
+/*-----------------------------------------------------------*/
+
+static void prvError( const char *pcMessage )
+{
+	taskENTER_CRITICAL();
+	{
+		printf( "%s\n", pcMessage );
+		ulErrors++;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static osThreadId_t prvCreateThread( osThreadFunc_t xFunction, void *pvArgument, osPriority_t xPriority )
+{
+osThreadAttr_t xAttributes = { 0 };
+
+	xAttributes.stack_size = benchSTACK_SIZE;
+	xAttributes.priority = xPriority;
+
+	return osThreadNew( xFunction, pvArgument, &xAttributes );
+}
+/*-----------------------------------------------------------*/
+
+/* Fill in a message, as a driver would, with its sequence number in the first
+and last words. */
+static void prvFillMessage( uint8_t *pucMessage, uint32_t ulSequence )
+{
+	memset( pucMessage, ( int ) ( ulSequence & 0xffUL ), ulMessageSize );
+	memcpy( pucMessage, &ulSequence, sizeof( ulSequence ) );
+	memcpy( pucMessage + ulMessageSize - sizeof( ulSequence ), &ulSequence, sizeof( ulSequence ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckMessage( const uint8_t *pucMessage, uint32_t ulSequence )
+{
+uint32_t ulFirst, ulLast;
+
+	memcpy( &ulFirst, pucMessage, sizeof( ulFirst ) );
+	memcpy( &ulLast, pucMessage + ulMessageSize - sizeof( ulLast ), sizeof( ulLast ) );
+
+	if( ( ulFirst != ulSequence ) || ( ulLast != ulSequence ) || ( pucMessage[ ulMessageSize / 2 ] != ( uint8_t ) ulSequence ) )
+	{
+		prvError( "a message was received out of order or corrupted" );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareCycles( const void *pv1, const void *pv2 )
+{
+uint64_t ull1 = *( const uint64_t * ) pv1, ull2 = *( const uint64_t * ) pv2;
+
+	return ( ull1 > ull2 ) - ( ull1 < ull2 );
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvTimeOneThread( void )
+{
+uint8_t ucSent[ benchMAX_MESSAGE_SIZE ], ucReceived[ benchMAX_MESSAGE_SIZE ];
+uint8_t *pucMail;
+uint32_t ulSample;
+uint64_t ullStart;
+
+	for( ulSample = 0; ulSample < benchSAMPLES; ulSample++ )
+	{
+		ullStart = ullPortGetCycleCounter();
+
+		if( xMailQueue == NULL )
+		{
+			prvFillMessage( ucSent, ulSample );
+			( void ) osMessageQueuePut( xMessageQueue, ucSent, 0U, 0U );
+			( void ) osMessageQueueGet( xMessageQueue, ucReceived, NULL, 0U );
+			prvCheckMessage( ucReceived, ulSample );
+		}
+		else
+		{
+			pucMail = osMailQueueAlloc( xMailQueue, 0U );
+			prvFillMessage( pucMail, ulSample );
+			( void ) osMailQueuePut( xMailQueue, pucMail );
+			pucMail = osMailQueueGet( xMailQueue, 0U );
+			prvCheckMessage( pucMail, ulSample );
+			( void ) osMailQueueFree( xMailQueue, pucMail );
+		}
+
+		ullCycles[ ulSample ] = ullPortGetCycleCounter() - ullStart;
+	}
+
+	qsort( ullCycles, benchSAMPLES, sizeof( ullCycles[ 0 ] ), prvCompareCycles );
+
+	return ullCycles[ benchSAMPLES / 2 ];
+}
+/*-----------------------------------------------------------*/
+
+static void prvProducerThread( void *pvArgument )
+{
+uint8_t ucMessage[ benchMAX_MESSAGE_SIZE ];
+uint8_t *pucMail;
+uint32_t ulSequence;
+
+	( void ) pvArgument;
+
+	for( ulSequence = 0; ulSequence < benchMESSAGES; ulSequence++ )
+	{
+		if( xMailQueue == NULL )
+		{
+			prvFillMessage( ucMessage, ulSequence );
+
+			if( osMessageQueuePut( xMessageQueue, ucMessage, 0U, osWaitForever ) != osOK )
+			{
+				prvError( "a message could not be put" );
+			}
+		}
+		else
+		{
+			/* Fill in the message in place, then publish it. */
+			pucMail = osMailQueueAlloc( xMailQueue, osWaitForever );
+
+			if( pucMail == NULL )
+			{
+				prvError( "a message could not be allocated" );
+				break;
+			}
+
+			prvFillMessage( pucMail, ulSequence );
+
+			if( osMailQueuePut( xMailQueue, pucMail ) != osOK )
+			{
+				prvError( "a message could not be put" );
+			}
+		}
+	}
+
+	osThreadExit();
+}
+/*-----------------------------------------------------------*/
+
+static void prvConsumerThread( void *pvArgument )
+{
+uint8_t ucMessage[ benchMAX_MESSAGE_SIZE ];
+uint8_t *pucMail;
+uint32_t ulSequence;
+
+	( void ) pvArgument;
+
+	for( ulSequence = 0; ulSequence < benchMESSAGES; ulSequence++ )
+	{
+		if( xMailQueue == NULL )
+		{
+			if( osMessageQueueGet( xMessageQueue, ucMessage, NULL, osWaitForever ) != osOK )
+			{
+				prvError( "a message could not be got" );
+			}
+
+			prvCheckMessage( ucMessage, ulSequence );
+		}
+		else
+		{
+			/* Read the message in place, then release it. */
+			pucMail = osMailQueueGet( xMailQueue, osWaitForever );
+
+			if( pucMail == NULL )
+			{
+				prvError( "a message could not be got" );
+				break;
+			}
+
+			prvCheckMessage( pucMail, ulSequence );
+
+			if( osMailQueueFree( xMailQueue, pucMail ) != osOK )
+			{
+				prvError( "a message could not be freed" );
+			}
+		}
+	}
+
+	( void ) osThreadFlagsSet( xControlThread, 1U );
+	osThreadExit();
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvTimeMessages( void )
+{
+uint64_t ullStart;
+
+	ullStart = ullPortGetCycleCounter();
+
+	configASSERT( prvCreateThread( prvProducerThread, NULL, osPriorityBelowNormal ) );
+	configASSERT( prvCreateThread( prvConsumerThread, NULL, osPriorityBelowNormal ) );
+	( void ) osThreadFlagsWait( 1U, osFlagsWaitAny, osWaitForever );
+
+	return ( ullPortGetCycleCounter() - ullStart ) / benchMESSAGES;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckMailQueue( osMailQueueId_t xQueue )
+{
+uint8_t *pucMail, *pucOther;
+TickType_t xStart;
+
+	/* A get on an empty queue times out. */
+	xStart = xTaskGetTickCount();
+
+	if( ( osMailQueueGet( xQueue, 5U ) != NULL ) || ( ( xTaskGetTickCount() - xStart ) < 5U ) )
+	{
+		prvError( "a get on an empty mail queue did not time out" );
+	}
+
+	/* Only messages from the pool of the queue can be put. */
+	if( ( osMailQueuePut( xQueue, &xStart ) != osErrorParameter ) || ( osMailQueuePut( NULL, &xStart ) != osErrorParameter ) )
+	{
+		prvError( "a message that is not from the pool was put" );
+	}
+
+	/* Messages are got in the order they were put, with their contents, and
+	can be put and got from an interrupt. */
+	pucMail = osMailQueueAlloc( xQueue, 0U );
+	pucOther = osMailQueueAlloc( xQueue, 0U );
+	configASSERT( ( pucMail != NULL ) && ( pucOther != NULL ) );
+	pucMail[ 0 ] = 1;
+	pucOther[ 0 ] = 2;
+
+	ulHostIPSR = 1;
+	if( ( osMailQueuePut( xQueue, pucMail ) != osOK ) || ( osMailQueueGet( xQueue, 5U ) != NULL ) )
+	{
+		prvError( "a put or get from an interrupt did not behave as expected" );
+	}
+	ulHostIPSR = 0;
+
+	if( ( osMailQueuePut( xQueue, pucOther ) != osOK ) || ( osMailQueueGetCount( xQueue ) != 2U ) )
+	{
+		prvError( "messages were not counted" );
+	}
+
+	ulHostIPSR = 1;
+	pucMail = osMailQueueGet( xQueue, 0U );
+	ulHostIPSR = 0;
+	pucOther = osMailQueueGet( xQueue, 0U );
+
+	if( ( pucMail == NULL ) || ( pucOther == NULL ) || ( pucMail[ 0 ] != 1 ) || ( pucOther[ 0 ] != 2 ) || ( osMailQueueGetCount( xQueue ) != 0U ) )
+	{
+		prvError( "messages were not got in order" );
+	}
+	else if( ( osMailQueueFree( xQueue, pucMail ) != osOK ) || ( osMailQueueFree( xQueue, pucOther ) != osOK ) )
+	{
+		prvError( "a message could not be freed" );
+	}
+
+	if( osMailQueueDelete( xQueue ) != osOK )
+	{
+		prvError( "a mail queue could not be deleted" );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvControlThread( void *pvArgument )
+{
+uint64_t ullCopied, ullZeroCopy, ullCopiedThreads, ullZeroCopyThreads;
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	static StaticMailQueue_t xStaticMailQueue;
+	static uint32_t ulStaticArray[ MAILQUEUE_ARR_SIZE( 4, 10 ) / sizeof( uint32_t ) ];
+	osMessageQueueAttr_t xStaticAttributes = { 0 };
+#endif
+
+	( void ) pvArgument;
+
+	for( ulMessageSize = benchMIN_MESSAGE_SIZE; ulMessageSize <= benchMAX_MESSAGE_SIZE; ulMessageSize *= 2 )
+	{
+		xMessageQueue = osMessageQueueNew( benchQUEUE_DEPTH, ulMessageSize, NULL );
+		configASSERT( xMessageQueue );
+		ullCopied = prvTimeOneThread();
+		ullCopiedThreads = prvTimeMessages();
+		( void ) osMessageQueueDelete( xMessageQueue );
+
+		xMailQueue = osMailQueueNew( benchQUEUE_DEPTH, ulMessageSize, NULL );
+		configASSERT( xMailQueue );
+		ullZeroCopy = prvTimeOneThread();
+		ullZeroCopyThreads = prvTimeMessages();
+		( void ) osMailQueueDelete( xMailQueue );
+		xMailQueue = NULL;
+
+		printf( "%4lu byte messages: one thread: message queue %lu, mail queue %lu cycles; two threads: message queue %lu, mail queue %lu cycles per message\n", ( unsigned long ) ulMessageSize, ( unsigned long ) ullCopied, ( unsigned long ) ullZeroCopy, ( unsigned long ) ullCopiedThreads, ( unsigned long ) ullZeroCopyThreads );
+
+		/* Let the idle task free the threads that exited. */
+		( void ) osDelay( 2U );
+	}
+
+	prvCheckMailQueue( osMailQueueNew( 4U, 10U, NULL ) );
+
+	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	{
+		xStaticAttributes.cb_mem = &xStaticMailQueue;
+		xStaticAttributes.cb_size = sizeof( xStaticMailQueue );
+		xStaticAttributes.mq_mem = ulStaticArray;
+		xStaticAttributes.mq_size = sizeof( ulStaticArray ) - 1U;
+
+		if( osMailQueueNew( 4U, 10U, &xStaticAttributes ) != NULL )
+		{
+			prvError( "a mail queue was created in an array that is too small" );
+		}
+
+		xStaticAttributes.mq_size = sizeof( ulStaticArray );
+
+		if( osMailQueueNew( 4U, 10U, &xStaticAttributes ) != &xStaticMailQueue )
+		{
+			prvError( "a mail queue could not be created in static memory" );
+		}
+
+		prvCheckMailQueue( &xStaticMailQueue );
+	}
+	#endif
+
+	taskENTER_CRITICAL();
+	{
+		if( ulErrors == 0 )
+		{
+			printf( "PASS\n" );
+		}
+		else
+		{
+			printf( "FAIL: %lu errors\n", ( unsigned long ) ulErrors );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	( void ) osKernelInitialize();
+	xControlThread = prvCreateThread( prvControlThread, NULL, osPriorityNormal );
+	( void ) osKernelStart();
+
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,376 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side benchmark and test of the CMSIS-RTOS2 memory pools.  It reports
+ * the median number of cycles taken to allocate and free a block when a block
+ * is free, then the throughput of four worker threads of equal priority that
+ * each allocate and free blocks of a shared pool, filling in each block they
+ * own and checking it is unchanged when they free it.  It then checks the
+ * counts and statistics of the pool, that invalid blocks are rejected by
+ * osMemoryPoolFree(), that a thread waiting on an empty pool gets the next
+ * block freed, including from an interrupt, and that a wait times out.
+ *
+ * cmsis_os2.c is built as part of this file, with the Arm only functions of
+ * the CMSIS core header replaced by host stubs, and __get_IPSR() returning
+ * ulHostIPSR so interrupts can be simulated.  Build this file alone with the
+ * POSIX port and heap_4, with the CMSIS_RTOS_V2 directory and
+ * Drivers/CMSIS/Include on the include path, using a FreeRTOSConfig.h that
+ * meets the requirements of freertos_os2.h (in particular configMAX_PRIORITIES
+ * set to 56) and sets configPOSIX_SIMULATED_TICK to 0, so the worker threads
+ * are preempted by the tick part way through pool operations.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/* Skip the body of the Arm only CMSIS core header, and provide the parts that
+cmsis_os2.c uses. */
+#define __CMSIS_GCC_H
+#define CMSIS_device_header		"cmsis_compiler.h"
+#define __WEAK					__attribute__( ( weak ) )
+#define __NO_RETURN				__attribute__( ( __noreturn__ ) )
+#define __STATIC_INLINE			static inline
+
+typedef int IRQn_Type;
+
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t LOAD;
+	volatile uint32_t VAL;
+} SysTick_Type;
+
+static SysTick_Type xHostSysTick;
+#define SysTick					( &xHostSysTick )
+
+static volatile uint32_t ulHostIPSR = 0;
+
+static inline uint32_t __get_IPSR( void ) { return ulHostIPSR; }
+static inline uint32_t __get_PRIMASK( void ) { return 0; }
+static inline void __disable_irq( void ) { }
+static inline void __enable_irq( void ) { }
+static inline void NVIC_SetPriority( IRQn_Type xIRQ, uint32_t ulPriority ) { ( void ) xIRQ; ( void ) ulPriority; }
+
+#include "cmsis_os2.c"
+
+#define benchSAMPLES			100000UL
+#define benchBLOCKS				64UL
+#define benchWORKERS			4UL
+#define benchWORKER_BLOCKS		8UL
+#define benchWORKER_LOOPS		200000UL
+
+/* The stack size, which must be at least PTHREAD_STACK_MIN bytes. */
+#define benchSTACK_SIZE			65536UL
+
+/* A CAN frame, as carried by the pools this benchmark models. */
+typedef struct
+{
+	uint32_t ulIdentifier;
+	uint8_t ucLength;
+	uint8_t ucData[ 8 ];
+} CANFrame_t;
+
+static osMemoryPoolId_t xPool;
+static osThreadId_t xControlThread;
+static volatile uint32_t ulErrors = 0;
+static void * volatile pvWaiterBlock;
+static uint64_t ullCycles[ benchSAMPLES ];
+
+/*-----------------------------------------------------------*/
+
+/* cmsis_os2.c refers to the tick handler of the Arm ports. */
+void xPortSysTickHandler( void )
+{
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareCycles( const void *pv1, const void *pv2 )
+{
+uint64_t ull1 = *( const uint64_t * ) pv1, ull2 = *( const uint64_t * ) pv2;
+
+	return ( ull1 > ull2 ) - ( ull1 < ull2 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvError( const char *pcMessage )
+{
+	taskENTER_CRITICAL();
+	{
+		printf( "%s\n", pcMessage );
+		ulErrors++;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static osThreadId_t prvCreateThread( osThreadFunc_t xFunction, void *pvArgument, osPriority_t xPriority )
+{
+osThreadAttr_t xAttributes = { 0 };
+
+	xAttributes.stack_size = benchSTACK_SIZE;
+	xAttributes.priority = xPriority;
+
+	return osThreadNew( xFunction, pvArgument, &xAttributes );
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvTimeUncontended( void )
+{
+uint32_t ulSample;
+uint64_t ullStart;
+void *pvBlock;
+
+	for( ulSample = 0; ulSample < benchSAMPLES; ulSample++ )
+	{
+		ullStart = ullPortGetCycleCounter();
+		pvBlock = osMemoryPoolAlloc( xPool, 0 );
+		( void ) osMemoryPoolFree( xPool, pvBlock );
+		ullCycles[ ulSample ] = ullPortGetCycleCounter() - ullStart;
+	}
+
+	qsort( ullCycles, benchSAMPLES, sizeof( ullCycles[ 0 ] ), prvCompareCycles );
+
+	return ullCycles[ benchSAMPLES / 2 ];
+}
+/*-----------------------------------------------------------*/
+
+static void prvWorkerThread( void *pvArgument )
+{
+uint32_t ulWorker = ( uint32_t ) ( uintptr_t ) pvArgument;
+CANFrame_t *pxFrames[ benchWORKER_BLOCKS ] = { NULL };
+uint32_t ulLoop, ulSlot;
+
+	for( ulLoop = 0; ulLoop < benchWORKER_LOOPS; ulLoop++ )
+	{
+		ulSlot = ulLoop % benchWORKER_BLOCKS;
+
+		if( pxFrames[ ulSlot ] != NULL )
+		{
+			/* No other thread wrote to the block while this thread owned it. */
+			if( ( pxFrames[ ulSlot ]->ulIdentifier != ( ( ulWorker << 24 ) | ( ulLoop - benchWORKER_BLOCKS ) ) ) || ( pxFrames[ ulSlot ]->ucData[ 7 ] != ( uint8_t ) ulWorker ) )
+			{
+				prvError( "a block was changed by another thread" );
+			}
+
+			if( osMemoryPoolFree( xPool, pxFrames[ ulSlot ] ) != osOK )
+			{
+				prvError( "a block could not be freed" );
+			}
+		}
+
+		/* The pool holds enough blocks for every worker. */
+		pxFrames[ ulSlot ] = osMemoryPoolAlloc( xPool, 0 );
+
+		if( pxFrames[ ulSlot ] == NULL )
+		{
+			prvError( "a block could not be allocated" );
+			break;
+		}
+
+		pxFrames[ ulSlot ]->ulIdentifier = ( ulWorker << 24 ) | ulLoop;
+		pxFrames[ ulSlot ]->ucData[ 7 ] = ( uint8_t ) ulWorker;
+	}
+
+	for( ulSlot = 0; ulSlot < benchWORKER_BLOCKS; ulSlot++ )
+	{
+		if( pxFrames[ ulSlot ] != NULL )
+		{
+			( void ) osMemoryPoolFree( xPool, pxFrames[ ulSlot ] );
+		}
+	}
+
+	( void ) osThreadFlagsSet( xControlThread, 1U );
+	osThreadExit();
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvTimeWorkers( void )
+{
+uint64_t ullStart;
+uint32_t ulWorker;
+
+	ullStart = ullPortGetCycleCounter();
+
+	for( ulWorker = 0; ulWorker < benchWORKERS; ulWorker++ )
+	{
+		configASSERT( prvCreateThread( prvWorkerThread, ( void * ) ( uintptr_t ) ulWorker, osPriorityBelowNormal ) );
+	}
+
+	for( ulWorker = 0; ulWorker < benchWORKERS; ulWorker++ )
+	{
+		( void ) osThreadFlagsWait( 1U, osFlagsWaitAny, osWaitForever );
+	}
+
+	return ( ullPortGetCycleCounter() - ullStart ) / ( benchWORKERS * benchWORKER_LOOPS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWaiterThread( void *pvArgument )
+{
+	pvWaiterBlock = osMemoryPoolAlloc( xPool, ( uint32_t ) ( uintptr_t ) pvArgument );
+	( void ) osThreadFlagsSet( xControlThread, 1U );
+	osThreadExit();
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckWaiting( void *pvBlock, BaseType_t xFreeFromISR )
+{
+	/* The waiter has a higher priority, so it blocks on the empty pool as
+	soon as it is created, and runs as soon as the block is freed. */
+	pvWaiterBlock = NULL;
+	configASSERT( prvCreateThread( prvWaiterThread, ( void * ) ( uintptr_t ) osWaitForever, osPriorityAboveNormal ) );
+
+	ulHostIPSR = ( xFreeFromISR != pdFALSE ) ? 1U : 0U;
+	if( osMemoryPoolFree( xPool, pvBlock ) != osOK )
+	{
+		prvError( "a block could not be freed" );
+	}
+	ulHostIPSR = 0;
+
+	( void ) osThreadFlagsWait( 1U, osFlagsWaitAny, osWaitForever );
+
+	if( pvWaiterBlock != pvBlock )
+	{
+		prvError( "a waiting thread did not get the freed block" );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvControlThread( void *pvArgument )
+{
+void *pvBlocks[ benchBLOCKS ];
+uint32_t ulBlock, ulFailCount;
+uint64_t ullUncontended, ullWorkers;
+TickType_t xStart;
+
+	( void ) pvArgument;
+
+	xPool = osMemoryPoolNew( benchBLOCKS, sizeof( CANFrame_t ), NULL );
+	configASSERT( xPool );
+
+	ullUncontended = prvTimeUncontended();
+	ullWorkers = prvTimeWorkers();
+
+	printf( "allocate and free a block: median %lu cycles\n", ( unsigned long ) ullUncontended );
+	printf( "%lu worker threads: %lu cycles per allocate and free\n", ( unsigned long ) benchWORKERS, ( unsigned long ) ullWorkers );
+
+	if( ( osMemoryPoolGetCount( xPool ) != 0 ) || ( osMemoryPoolGetSpace( xPool ) != benchBLOCKS ) || ( osMemoryPoolGetFailCount( xPool ) != 0 ) )
+	{
+		prvError( "blocks were lost by the worker threads" );
+	}
+
+	if( ( osMemoryPoolGetMaxCount( xPool ) < benchWORKER_BLOCKS ) || ( osMemoryPoolGetMaxCount( xPool ) > ( benchWORKERS * benchWORKER_BLOCKS ) ) )
+	{
+		prvError( "wrong maximum count after the worker threads" );
+	}
+
+	/* Every block is handed out once, then the pool is empty. */
+	for( ulBlock = 0; ulBlock < benchBLOCKS; ulBlock++ )
+	{
+		pvBlocks[ ulBlock ] = osMemoryPoolAlloc( xPool, 0 );
+
+		if( ( pvBlocks[ ulBlock ] == NULL ) || ( ( ulBlock > 0 ) && ( pvBlocks[ ulBlock ] == pvBlocks[ ulBlock - 1 ] ) ) )
+		{
+			prvError( "a block was not allocated from a pool with free blocks" );
+		}
+	}
+
+	if( ( osMemoryPoolAlloc( xPool, 0 ) != NULL ) || ( osMemoryPoolGetCount( xPool ) != benchBLOCKS ) || ( osMemoryPoolGetSpace( xPool ) != 0 ) )
+	{
+		prvError( "a block was allocated from an empty pool" );
+	}
+
+	/* A wait for a block times out, and both failures are counted. */
+	xStart = xTaskGetTickCount();
+
+	if( ( osMemoryPoolAlloc( xPool, 5 ) != NULL ) || ( ( xTaskGetTickCount() - xStart ) < 5 ) )
+	{
+		prvError( "a wait on an empty pool did not time out" );
+	}
+
+	ulFailCount = osMemoryPoolGetFailCount( xPool );
+
+	if( ( ulFailCount != 2 ) || ( osMemoryPoolGetMaxCount( xPool ) != benchBLOCKS ) )
+	{
+		printf( "fail count %lu, maximum count %lu\n", ( unsigned long ) ulFailCount, ( unsigned long ) osMemoryPoolGetMaxCount( xPool ) );
+		prvError( "wrong statistics of an empty pool" );
+	}
+
+	/* Pointers that are not blocks of the pool are rejected. */
+	if( ( osMemoryPoolFree( xPool, ( uint8_t * ) pvBlocks[ 0 ] + 1 ) != osErrorParameter ) || ( osMemoryPoolFree( xPool, &ulBlock ) != osErrorParameter ) )
+	{
+		prvError( "a pointer that is not a block was freed" );
+	}
+
+	/* Threads waiting on the empty pool get the block freed by a thread or
+	an interrupt. */
+	prvCheckWaiting( pvBlocks[ 0 ], pdFALSE );
+	prvCheckWaiting( pvBlocks[ 0 ], pdTRUE );
+
+	for( ulBlock = 0; ulBlock < benchBLOCKS; ulBlock++ )
+	{
+		if( osMemoryPoolFree( xPool, pvBlocks[ ulBlock ] ) != osOK )
+		{
+			prvError( "a block could not be freed" );
+		}
+	}
+
+	/* All blocks are now free, so one more free is rejected. */
+	if( ( osMemoryPoolGetCount( xPool ) != 0 ) || ( osMemoryPoolFree( xPool, pvBlocks[ 0 ] ) != osErrorResource ) )
+	{
+		prvError( "a block was freed to a pool with no used blocks" );
+	}
+
+	( void ) osMemoryPoolDelete( xPool );
+
+	taskENTER_CRITICAL();
+	{
+		if( ulErrors == 0 )
+		{
+			printf( "PASS\n" );
+		}
+		else
+		{
+			printf( "FAIL: %lu errors\n", ( unsigned long ) ulErrors );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	( void ) osKernelInitialize();
+	xControlThread = prvCreateThread( prvControlThread, NULL, osPriorityNormal );
+	( void ) osKernelStart();
+
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,305 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side benchmark of the CMSIS-RTOS v1 memory pools, which also back the
+ * mail queues.  For each pool size from 8 to 4096 blocks it fills the pool,
+ * then repeatedly frees a block from one quarter or the other of the pool and
+ * allocates a block again, so each allocation finds a single free block that is
+ * far from the previous one, and reports the median number of cycles taken by
+ * osPoolFree() and osPoolAlloc().  It then checks that a pool hands out every
+ * block exactly once, that osPoolCAlloc() clears the whole block, that blocks
+ * that are not allocated from the pool are rejected by osPoolFree(), and that
+ * osMailAlloc() and osMailFree() behave the same when called from an
+ * interrupt.
+ *
+ * cmsis_os.c is built as part of this file, with __get_IPSR() replaced by a
+ * function that returns ulHostIPSR, as the CMSIS core header only assembles
+ * for Arm targets.  Build this file alone with the POSIX port and heap_4, with
+ * the CMSIS_RTOS directory and Drivers/CMSIS/Include on the include path,
+ * using a FreeRTOSConfig.h that sets configSUPPORT_DYNAMIC_ALLOCATION to 1.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/* Skip the body of the Arm only CMSIS core header included by cmsis_os.c. */
+#define __CMSIS_GCC_H
+
+static volatile uint32_t ulHostIPSR = 0;
+
+static inline uint32_t __get_IPSR( void )
+{
+	return ulHostIPSR;
+}
+
+#include "cmsis_os.c"
+
+#define benchSAMPLES			20000UL
+#define benchMIN_POOL_SIZE		8UL
+#define benchMAX_POOL_SIZE		4096UL
+#define benchMAIL_QUEUE_SIZE	64UL
+
+/* The stack size, which must be at least PTHREAD_STACK_MIN bytes. */
+#define benchSTACK_SIZE			( ( configSTACK_DEPTH_TYPE ) ( 65536 / sizeof( StackType_t ) ) )
+
+/* A CAN frame, as carried by the mail queues this benchmark models. */
+typedef struct
+{
+	uint32_t ulIdentifier;
+	uint8_t ucLength;
+	uint8_t ucData[ 8 ];
+} CANFrame_t;
+
+static uint32_t ulErrors = 0;
+static uint64_t ullAllocCycles[ benchSAMPLES ], ullFreeCycles[ benchSAMPLES ];
+static void *pvBlocks[ benchMAX_POOL_SIZE ];
+
+/*-----------------------------------------------------------*/
+
+/* cmsis_os.c refers to the tick handler of the Arm ports. */
+void xPortSysTickHandler( void )
+{
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareCycles( const void *pv1, const void *pv2 )
+{
+uint64_t ull1 = *( const uint64_t * ) pv1, ull2 = *( const uint64_t * ) pv2;
+
+	return ( ull1 > ull2 ) - ( ull1 < ull2 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimePool( uint32_t ulPoolSize )
+{
+osPoolDef_t xPoolDef = { ulPoolSize, sizeof( CANFrame_t ), NULL };
+osPoolId xPool;
+uint32_t ulBlock, ulSample;
+uint64_t ullStart;
+
+	xPool = osPoolCreate( &xPoolDef );
+	configASSERT( xPool );
+
+	for( ulBlock = 0; ulBlock < ulPoolSize; ulBlock++ )
+	{
+		pvBlocks[ ulBlock ] = osPoolAlloc( xPool );
+
+		if( pvBlocks[ ulBlock ] == NULL )
+		{
+			ulErrors++;
+		}
+	}
+
+	for( ulSample = 0; ulSample < benchSAMPLES; ulSample++ )
+	{
+		/* Alternate between a block in the first quarter and a block in the
+		last quarter of the pool. */
+		ulBlock = ( ( ulSample & 1UL ) == 0 ) ? ( ulPoolSize / 4 ) : ( ( 3 * ulPoolSize ) / 4 );
+
+		ullStart = ullPortGetCycleCounter();
+		if( osPoolFree( xPool, pvBlocks[ ulBlock ] ) != osOK )
+		{
+			ulErrors++;
+		}
+		ullFreeCycles[ ulSample ] = ullPortGetCycleCounter() - ullStart;
+
+		ullStart = ullPortGetCycleCounter();
+		pvBlocks[ ulBlock ] = osPoolAlloc( xPool );
+		ullAllocCycles[ ulSample ] = ullPortGetCycleCounter() - ullStart;
+
+		if( pvBlocks[ ulBlock ] == NULL )
+		{
+			ulErrors++;
+		}
+	}
+
+	qsort( ullAllocCycles, benchSAMPLES, sizeof( ullAllocCycles[ 0 ] ), prvCompareCycles );
+	qsort( ullFreeCycles, benchSAMPLES, sizeof( ullFreeCycles[ 0 ] ), prvCompareCycles );
+
+	printf( "%4lu blocks: osPoolAlloc median %lu cycles, osPoolFree median %lu cycles\n", ( unsigned long ) ulPoolSize, ( unsigned long ) ullAllocCycles[ benchSAMPLES / 2 ], ( unsigned long ) ullFreeCycles[ benchSAMPLES / 2 ] );
+
+	/* There is no osPoolDelete(), so the pool is left allocated. */
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckPool( void )
+{
+osPoolDef_t xPoolDef = { benchMIN_POOL_SIZE, sizeof( CANFrame_t ), NULL };
+osPoolId xPool;
+uint32_t ulBlock, ulOther, ulByte;
+uint8_t *pucBlock;
+
+	xPool = osPoolCreate( &xPoolDef );
+	configASSERT( xPool );
+
+	/* Every block is handed out once, and then the pool is empty. */
+	for( ulBlock = 0; ulBlock < benchMIN_POOL_SIZE; ulBlock++ )
+	{
+		pvBlocks[ ulBlock ] = osPoolAlloc( xPool );
+
+		for( ulOther = 0; ulOther < ulBlock; ulOther++ )
+		{
+			if( pvBlocks[ ulOther ] == pvBlocks[ ulBlock ] )
+			{
+				printf( "block %lu was handed out twice\n", ( unsigned long ) ulBlock );
+				ulErrors++;
+			}
+		}
+
+		memset( pvBlocks[ ulBlock ], 0xa5, sizeof( CANFrame_t ) );
+	}
+
+	if( osPoolAlloc( xPool ) != NULL )
+	{
+		printf( "a block was allocated from an empty pool\n" );
+		ulErrors++;
+	}
+
+	/* Blocks that were not allocated from the pool are rejected. */
+	pucBlock = ( uint8_t * ) pvBlocks[ 0 ];
+
+	if( ( osPoolFree( xPool, pucBlock + 1 ) != osErrorParameter ) || ( osPoolFree( NULL, pucBlock ) != osErrorParameter ) )
+	{
+		printf( "a pointer that is not a block was freed\n" );
+		ulErrors++;
+	}
+
+	if( ( osPoolFree( xPool, pucBlock ) != osOK ) || ( osPoolFree( xPool, pucBlock ) != osErrorParameter ) )
+	{
+		printf( "a block was freed twice\n" );
+		ulErrors++;
+	}
+
+	/* The freed block is the only one available, and is cleared in full. */
+	pucBlock = ( uint8_t * ) osPoolCAlloc( xPool );
+
+	if( ( pucBlock != pvBlocks[ 0 ] ) || ( osPoolAlloc( xPool ) != NULL ) )
+	{
+		printf( "the freed block was not reused\n" );
+		ulErrors++;
+	}
+	else
+	{
+		for( ulByte = 0; ulByte < sizeof( CANFrame_t ); ulByte++ )
+		{
+			if( pucBlock[ ulByte ] != 0 )
+			{
+				printf( "byte %lu of a block from osPoolCAlloc() was not cleared\n", ( unsigned long ) ulByte );
+				ulErrors++;
+				break;
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckMailFromISR( void )
+{
+osMailQDef( xMailQueue, benchMAIL_QUEUE_SIZE, CANFrame_t );
+osMailQId xMail;
+uint32_t ulBlock, ulPass;
+
+	xMail = osMailCreate( osMailQ( xMailQueue ), NULL );
+	configASSERT( xMail );
+
+	/* Pretend to be in an interrupt, so the pool uses the interrupt mask
+	rather than a critical section. */
+	ulHostIPSR = 1;
+
+	for( ulPass = 0; ulPass < 2; ulPass++ )
+	{
+		for( ulBlock = 0; ulBlock < benchMAIL_QUEUE_SIZE; ulBlock++ )
+		{
+			pvBlocks[ ulBlock ] = osMailAlloc( xMail, 0 );
+
+			if( pvBlocks[ ulBlock ] == NULL )
+			{
+				printf( "mail %lu could not be allocated\n", ( unsigned long ) ulBlock );
+				ulErrors++;
+			}
+		}
+
+		if( osMailAlloc( xMail, 0 ) != NULL )
+		{
+			printf( "mail was allocated from a full queue\n" );
+			ulErrors++;
+		}
+
+		/* Free the blocks in the reverse order on the second pass. */
+		for( ulBlock = 0; ulBlock < benchMAIL_QUEUE_SIZE; ulBlock++ )
+		{
+			if( osMailFree( xMail, pvBlocks[ ( ulPass == 0 ) ? ulBlock : ( benchMAIL_QUEUE_SIZE - 1 - ulBlock ) ] ) != osOK )
+			{
+				ulErrors++;
+			}
+		}
+	}
+
+	ulHostIPSR = 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvControlTask( void *pvParameters )
+{
+uint32_t ulPoolSize;
+
+	( void ) pvParameters;
+
+	for( ulPoolSize = benchMIN_POOL_SIZE; ulPoolSize <= benchMAX_POOL_SIZE; ulPoolSize *= 2 )
+	{
+		prvTimePool( ulPoolSize );
+	}
+
+	prvCheckPool();
+	prvCheckMailFromISR();
+
+	taskENTER_CRITICAL();
+	{
+		if( ulErrors == 0 )
+		{
+			printf( "PASS\n" );
+		}
+		else
+		{
+			printf( "FAIL: %lu errors\n", ( unsigned long ) ulErrors );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	xTaskCreate( prvControlTask, "Control", benchSTACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,346 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side benchmark that compares state machines implemented as co-routines
+ * with the same state machines implemented as one task each.  The heap used by
+ * each co-routine and by each task is reported first.  Each set of state
+ * machines then passes a token around a ring of message buffers, and the
+ * median number of cycles per hop, taken over a lap of the ring, is reported.
+ * The co-routines are run by vCoRoutineSchedule() from the idle hook, so their
+ * figure includes the idle task, as it would in an application.
+ *
+ * The last phase releases a second set of co-routines, waiting on an event
+ * group bit, that each delay for a different number of ticks in a loop, and
+ * reports the median number of cycles taken by a call to vCoRoutineSchedule()
+ * that runs one of them.  Without configUSE_CO_ROUTINE_PRIORITY_BITMAP and
+ * configUSE_CO_ROUTINE_DELAY_WHEEL that time grows with the number of
+ * co-routine priorities and with the number of delayed co-routines.  The test
+ * passes if every token reached the expected state machine and no delay was
+ * shorter than requested.
+ *
+ * Build twice with the POSIX port, any heap implementation, croutine.c, and a
+ * FreeRTOSConfig.h that sets configUSE_CO_ROUTINES, configUSE_IDLE_HOOK,
+ * configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS and configUSE_CO_ROUTINE_EVENT_GROUP_WAITS
+ * to 1, configMAX_CO_ROUTINE_PRIORITIES to a large value such as 256, and
+ * configUSE_CO_ROUTINE_PRIORITY_BITMAP and configUSE_CO_ROUTINE_DELAY_WHEEL to
+ * 0 and then to 1, and compare the results.  configTOTAL_HEAP_SIZE must be
+ * large enough for the stacks of 64 tasks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "croutine.h"
+#include "message_buffer.h"
+#include "event_groups.h"
+
+#if( ( configUSE_CO_ROUTINE_STREAM_BUFFER_WAITS != 1 ) || ( configUSE_CO_ROUTINE_EVENT_GROUP_WAITS != 1 ) )
+	#error This benchmark needs co-routines to wait on message buffers and event groups.
+#endif
+
+#define benchMACHINES			64
+#define benchLAPS				200
+#define benchDELAY_SAMPLES		1000UL
+#define benchMAX_DELAY			200
+#define benchBUFFER_SIZE		( sizeof( uint32_t ) + sizeof( size_t ) )
+#define benchDELAY_BIT			( ( EventBits_t ) 1 << 0 )
+
+/* The stack size, which must be at least PTHREAD_STACK_MIN bytes. */
+#define benchSTACK_SIZE			( ( configSTACK_DEPTH_TYPE ) ( 32768 / sizeof( StackType_t ) ) )
+
+/* The ring of each set of state machines, and the cycle counter value each
+time the token reached the first state machine of the ring. */
+typedef struct Ring
+{
+	MessageBufferHandle_t xBuffers[ benchMACHINES ];
+	uint64_t ullLapTimes[ benchLAPS + 1 ];
+	volatile BaseType_t xDone;
+} Ring_t;
+
+static Ring_t xCoRoutineRing, xTaskRing;
+static EventGroupHandle_t xDelayEventGroup = NULL;
+static volatile uint32_t ulTokenErrors = 0, ulDelayErrors = 0, ulDelaySamples = 0;
+static volatile BaseType_t xDelayCoRoutineRan = pdFALSE;
+static uint64_t ullDelayCycles[ benchDELAY_SAMPLES ];
+
+/*-----------------------------------------------------------*/
+
+/* Checks the token received by state machine uxIndex, records the time if the
+token completed a lap, and returns pdFALSE once the last lap is complete. */
+static BaseType_t prvTokenReceived( Ring_t *pxRing, UBaseType_t uxIndex, uint32_t *pulToken )
+{
+BaseType_t xReturn = pdTRUE;
+
+	if( ( *pulToken % benchMACHINES ) != uxIndex )
+	{
+		ulTokenErrors++;
+	}
+
+	if( uxIndex == 0 )
+	{
+		pxRing->ullLapTimes[ *pulToken / benchMACHINES ] = ullPortGetCycleCounter();
+
+		if( *pulToken == ( uint32_t ) ( benchMACHINES * benchLAPS ) )
+		{
+			pxRing->xDone = pdTRUE;
+			xReturn = pdFALSE;
+		}
+	}
+
+	( *pulToken )++;
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRingCoRoutine( CoRoutineHandle_t xHandle, UBaseType_t uxIndex )
+{
+/* Variables that must keep their value while the co-routine is blocked must
+be static, so there is one of each per co-routine. */
+static uint32_t ulTokens[ benchMACHINES ];
+static size_t xBytes[ benchMACHINES ];
+static BaseType_t xResults[ benchMACHINES ];
+
+	crSTART( xHandle );
+
+	for( ;; )
+	{
+		crSTREAM_BUFFER_RECEIVE( xHandle, xCoRoutineRing.xBuffers[ uxIndex ], &( ulTokens[ uxIndex ] ), sizeof( uint32_t ), portMAX_DELAY, &( xBytes[ uxIndex ] ), &( xResults[ uxIndex ] ) );
+
+		if( ( xResults[ uxIndex ] == pdPASS ) && ( prvTokenReceived( &xCoRoutineRing, uxIndex, &( ulTokens[ uxIndex ] ) ) != pdFALSE ) )
+		{
+			crSTREAM_BUFFER_SEND( xHandle, xCoRoutineRing.xBuffers[ ( uxIndex + 1 ) % benchMACHINES ], &( ulTokens[ uxIndex ] ), sizeof( uint32_t ), portMAX_DELAY, &( xBytes[ uxIndex ] ), &( xResults[ uxIndex ] ) );
+
+			if( xResults[ uxIndex ] != pdPASS )
+			{
+				ulTokenErrors++;
+			}
+		}
+	}
+
+	crEND();
+}
+/*-----------------------------------------------------------*/
+
+static void prvRingTask( void *pvParameters )
+{
+UBaseType_t uxIndex = ( UBaseType_t ) pvParameters;
+uint32_t ulToken;
+
+	for( ;; )
+	{
+		if( xMessageBufferReceive( xTaskRing.xBuffers[ uxIndex ], &ulToken, sizeof( ulToken ), portMAX_DELAY ) == sizeof( ulToken ) )
+		{
+			if( prvTokenReceived( &xTaskRing, uxIndex, &ulToken ) != pdFALSE )
+			{
+				( void ) xMessageBufferSend( xTaskRing.xBuffers[ ( uxIndex + 1 ) % benchMACHINES ], &ulToken, sizeof( ulToken ), portMAX_DELAY );
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvDelayCoRoutine( CoRoutineHandle_t xHandle, UBaseType_t uxIndex )
+{
+static TickType_t xDelayStart[ benchMACHINES ];
+static EventBits_t uxBits[ benchMACHINES ];
+static BaseType_t xResults[ benchMACHINES ];
+TickType_t xTicksToDelay = ( TickType_t ) ( 1 + ( ( uxIndex * 37 ) % benchMAX_DELAY ) );
+
+	crSTART( xHandle );
+
+	/* Wait for the benchmark task to start the last phase. */
+	do
+	{
+		crEVENT_GROUP_WAIT_BITS( xHandle, xDelayEventGroup, benchDELAY_BIT, pdFALSE, pdFALSE, portMAX_DELAY, &( uxBits[ uxIndex ] ), &( xResults[ uxIndex ] ) );
+	} while( xResults[ uxIndex ] != pdPASS );
+
+	for( ;; )
+	{
+		xDelayCoRoutineRan = pdTRUE;
+		xDelayStart[ uxIndex ] = xTaskGetTickCount();
+		crDELAY( xHandle, xTicksToDelay );
+
+		if( ( xTaskGetTickCount() - xDelayStart[ uxIndex ] ) < xTicksToDelay )
+		{
+			ulDelayErrors++;
+		}
+	}
+
+	crEND();
+}
+/*-----------------------------------------------------------*/
+
+void vApplicationIdleHook( void )
+{
+uint64_t ullStart, ullEnd;
+
+	xDelayCoRoutineRan = pdFALSE;
+	ullStart = ullPortGetCycleCounter();
+	vCoRoutineSchedule();
+	ullEnd = ullPortGetCycleCounter();
+
+	if( ( xDelayCoRoutineRan != pdFALSE ) && ( ulDelaySamples < benchDELAY_SAMPLES ) )
+	{
+		ullDelayCycles[ ulDelaySamples ] = ullEnd - ullStart;
+		ulDelaySamples++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareCycles( const void *pv1, const void *pv2 )
+{
+uint64_t ull1 = *( const uint64_t * ) pv1, ull2 = *( const uint64_t * ) pv2;
+
+	return ( ull1 > ull2 ) - ( ull1 < ull2 );
+}
+/*-----------------------------------------------------------*/
+
+/* Passes the token around the ring, then returns the median cycles per hop. */
+static uint64_t prvRunRing( Ring_t *pxRing )
+{
+uint32_t ulToken = 0;
+UBaseType_t uxLap;
+
+	( void ) xMessageBufferSend( pxRing->xBuffers[ 0 ], &ulToken, sizeof( ulToken ), portMAX_DELAY );
+
+	while( pxRing->xDone == pdFALSE )
+	{
+		vTaskDelay( pdMS_TO_TICKS( 10 ) );
+	}
+
+	/* The median is reported as the host occasionally interrupts the
+	simulation for far longer than a lap takes. */
+	for( uxLap = 0; uxLap < benchLAPS; uxLap++ )
+	{
+		pxRing->ullLapTimes[ uxLap ] = pxRing->ullLapTimes[ uxLap + 1 ] - pxRing->ullLapTimes[ uxLap ];
+	}
+
+	qsort( pxRing->ullLapTimes, benchLAPS, sizeof( pxRing->ullLapTimes[ 0 ] ), prvCompareCycles );
+
+	return pxRing->ullLapTimes[ benchLAPS / 2 ] / benchMACHINES;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void *pvParameters )
+{
+uint64_t ullCoRoutineHop, ullTaskHop;
+
+	( void ) pvParameters;
+
+	/* Phase one - the co-routine ring, run from the idle task while this task
+	is delayed. */
+	ullCoRoutineHop = prvRunRing( &xCoRoutineRing );
+	printf( "co-routines: median %lu cycles per hop\n", ( unsigned long ) ullCoRoutineHop );
+
+	/* Phase two - the task ring.  The tasks have a higher priority than this
+	task so the token goes around without this task running. */
+	ullTaskHop = prvRunRing( &xTaskRing );
+	printf( "tasks: median %lu cycles per hop\n", ( unsigned long ) ullTaskHop );
+
+	/* Phase three - the delayed co-routines. */
+	( void ) xEventGroupSetBits( xDelayEventGroup, benchDELAY_BIT );
+
+	while( ulDelaySamples < benchDELAY_SAMPLES )
+	{
+		vTaskDelay( pdMS_TO_TICKS( 10 ) );
+	}
+
+	qsort( ullDelayCycles, benchDELAY_SAMPLES, sizeof( ullDelayCycles[ 0 ] ), prvCompareCycles );
+	printf( "%d delayed co-routines: median %lu cycles per vCoRoutineSchedule() call\n", benchMACHINES, ( unsigned long ) ullDelayCycles[ benchDELAY_SAMPLES / 2 ] );
+
+	taskENTER_CRITICAL();
+	{
+		if( ( ulTokenErrors == 0 ) && ( ulDelayErrors == 0 ) )
+		{
+			printf( "PASS\n" );
+		}
+		else
+		{
+			printf( "FAIL: %lu token errors, %lu delay errors\n", ( unsigned long ) ulTokenErrors, ( unsigned long ) ulDelayErrors );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+UBaseType_t uxIndex;
+size_t xFreeBefore, xCoRoutineBytes, xTaskBytes;
+BaseType_t xCreated;
+
+	for( uxIndex = 0; uxIndex < benchMACHINES; uxIndex++ )
+	{
+		xCoRoutineRing.xBuffers[ uxIndex ] = xMessageBufferCreate( benchBUFFER_SIZE );
+		xTaskRing.xBuffers[ uxIndex ] = xMessageBufferCreate( benchBUFFER_SIZE );
+		configASSERT( xCoRoutineRing.xBuffers[ uxIndex ] );
+		configASSERT( xTaskRing.xBuffers[ uxIndex ] );
+	}
+
+	xDelayEventGroup = xEventGroupCreate();
+	configASSERT( xDelayEventGroup );
+
+	/* Spread the state machines over the co-routine priorities. */
+	xFreeBefore = xPortGetFreeHeapSize();
+
+	for( uxIndex = 0; uxIndex < benchMACHINES; uxIndex++ )
+	{
+		xCreated = xCoRoutineCreate( prvRingCoRoutine, ( uxIndex * 7 ) % configMAX_CO_ROUTINE_PRIORITIES, uxIndex );
+		configASSERT( xCreated == pdPASS );
+	}
+
+	xCoRoutineBytes = ( xFreeBefore - xPortGetFreeHeapSize() ) / benchMACHINES;
+	xFreeBefore = xPortGetFreeHeapSize();
+
+	for( uxIndex = 0; uxIndex < benchMACHINES; uxIndex++ )
+	{
+		xCreated = xTaskCreate( prvRingTask, "Ring", benchSTACK_SIZE, ( void * ) uxIndex, tskIDLE_PRIORITY + 2, NULL );
+		configASSERT( xCreated == pdPASS );
+	}
+
+	xTaskBytes = ( xFreeBefore - xPortGetFreeHeapSize() ) / benchMACHINES;
+
+	for( uxIndex = 0; uxIndex < benchMACHINES; uxIndex++ )
+	{
+		xCreated = xCoRoutineCreate( prvDelayCoRoutine, configMAX_CO_ROUTINE_PRIORITIES - 1 - ( ( uxIndex * 11 ) % configMAX_CO_ROUTINE_PRIORITIES ), uxIndex );
+		configASSERT( xCreated == pdPASS );
+	}
+
+	printf( "Priority bitmap %s, delay wheel %s, %d co-routine priorities\n", ( configUSE_CO_ROUTINE_PRIORITY_BITMAP == 1 ) ? "on" : "off", ( configUSE_CO_ROUTINE_DELAY_WHEEL == 1 ) ? "on" : "off", ( int ) configMAX_CO_ROUTINE_PRIORITIES );
+	printf( "heap per state machine: co-routine %lu bytes, task %lu bytes of which %lu are stack\n", ( unsigned long ) xCoRoutineBytes, ( unsigned long ) xTaskBytes, ( unsigned long ) ( benchSTACK_SIZE * sizeof( StackType_t ) ) );
+
+	xTaskCreate( prvBenchmarkTask, "Bench", benchSTACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
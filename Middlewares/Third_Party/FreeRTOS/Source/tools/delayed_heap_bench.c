@@ -0,0 +1,251 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side benchmark for the delayed task lists, with a growing number of
+ * sleeper tasks delayed until random times far in the future.  A blocker task
+ * of the highest priority repeatedly delays itself, and the median number of
+ * cycles is reported for:
+ *
+ * + Inserting - from the blocker task calling vTaskDelay() with a random
+ *   delay in the same range as the sleeper tasks, to the benchmark task
+ *   running.  The sorted delayed list is walked to find the insertion point.
+ * + Removing - from the benchmark task calling xTaskAbortDelay() on the
+ *   blocker task, to the blocker task running.
+ * + Unblocking - xTaskIncrementTick(), called with interrupts masked as the
+ *   tick interrupt does, when the blocker task delayed for one tick, so it is
+ *   the first task to wake.
+ *
+ * The first two include a context switch, which takes the same time whatever
+ * the delayed task container.  Without configUSE_DELAYED_TASK_HEAP inserting
+ * grows with the number of delayed tasks, while removing and unblocking do not.
+ * With it, inserting does not grow, and removing and unblocking grow with the
+ * logarithm of the number of delayed tasks.  The test passes if the blocker
+ * task ran exactly once for each xTaskAbortDelay() and each unblocking tick.
+ *
+ * Build twice with the POSIX port and any heap implementation, using a
+ * FreeRTOSConfig.h that sets configUSE_DYNAMIC_TICK to 0, INCLUDE_xTaskAbortDelay
+ * to 1, and configUSE_DELAYED_TASK_HEAP to 0 and then to 1, and compare the
+ * results.  configTOTAL_HEAP_SIZE must be large enough for the stacks of the
+ * largest task count plus two.  The timer task, if used, must have a priority
+ * below configMAX_PRIORITIES - 2.  Other task counts can be given on the
+ * command line, for example with -DbenchTASK_COUNTS=100,2000.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if( configUSE_DYNAMIC_TICK != 0 )
+	#error This benchmark calls xTaskIncrementTick() directly, so needs configUSE_DYNAMIC_TICK set to 0.
+#endif
+
+#ifndef benchTASK_COUNTS
+	#define benchTASK_COUNTS		16, 256, 1024
+#endif
+
+#define benchSAMPLES			2000UL
+
+/* The sleeper tasks, and the blocker task when it is measuring inserts, delay
+for a random time in this range.  The start of the range is beyond the number
+of ticks the measurements use, so the sleeper tasks stay delayed. */
+#define benchMIN_DELAY			( ( TickType_t ) ( 4 * benchSAMPLES ) )
+#define benchDELAY_RANGE		( ( TickType_t ) 100000 )
+
+/* The stack size, which must be at least PTHREAD_STACK_MIN bytes. */
+#define benchSTACK_SIZE			( ( configSTACK_DEPTH_TYPE ) ( 32768 / sizeof( StackType_t ) ) )
+
+#define benchBLOCKER_PRIORITY	( configMAX_PRIORITIES - 1 )
+#define benchBENCH_PRIORITY		( configMAX_PRIORITIES - 2 )
+#define benchSLEEPER_PRIORITY	( tskIDLE_PRIORITY + 1 )
+
+static const UBaseType_t uxTaskCounts[] = { benchTASK_COUNTS };
+
+#define benchTASK_COUNT_STEPS	( sizeof( uxTaskCounts ) / sizeof( uxTaskCounts[ 0 ] ) )
+
+static TaskHandle_t xBlockerTask = NULL;
+static volatile TickType_t xBlockerDelay = 1;
+static volatile uint64_t ullBlockTime = 0, ullAbortTime = 0, ullAbortCycles = 0;
+static volatile uint32_t ulBlockerRuns = 0;
+static uint32_t ulSeed = 1;
+static uint64_t ullInsertCycles[ benchSAMPLES ], ullRemoveCycles[ benchSAMPLES ], ullUnblockCycles[ benchSAMPLES ];
+
+/*-----------------------------------------------------------*/
+
+static TickType_t prvRandomDelay( void )
+{
+	ulSeed = ( ulSeed * 1103515245UL ) + 12345UL;
+	return benchMIN_DELAY + ( ( TickType_t ) ( ulSeed >> 8 ) % benchDELAY_RANGE );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSleeperTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		vTaskDelay( prvRandomDelay() );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvBlockerTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		ullAbortCycles = ullPortGetCycleCounter() - ullAbortTime;
+		ulBlockerRuns++;
+		ullBlockTime = ullPortGetCycleCounter();
+		vTaskDelay( xBlockerDelay );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareCycles( const void *pv1, const void *pv2 )
+{
+uint64_t ull1 = *( const uint64_t * ) pv1, ull2 = *( const uint64_t * ) pv2;
+
+	return ( ull1 > ull2 ) - ( ull1 < ull2 );
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvMedian( uint64_t *pullCycles )
+{
+	/* The median is reported as the host occasionally interrupts the
+	measurement for far longer than it takes. */
+	qsort( pullCycles, benchSAMPLES, sizeof( pullCycles[ 0 ] ), prvCompareCycles );
+	return pullCycles[ benchSAMPLES / 2 ];
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void *pvParameters )
+{
+UBaseType_t uxStep, uxCreated = 0;
+uint32_t ulSample, ulRuns, ulErrors = 0;
+
+	( void ) pvParameters;
+
+	for( uxStep = 0; uxStep < benchTASK_COUNT_STEPS; uxStep++ )
+	{
+		while( uxCreated < uxTaskCounts[ uxStep ] )
+		{
+			if( xTaskCreate( prvSleeperTask, "Sleeper", benchSTACK_SIZE, NULL, benchSLEEPER_PRIORITY, NULL ) != pdPASS )
+			{
+				ulErrors++;
+				break;
+			}
+
+			uxCreated++;
+		}
+
+		/* Let the new sleeper tasks delay.  The blocker task delays far in the
+		future too if it runs. */
+		xBlockerDelay = prvRandomDelay();
+		vTaskDelay( 1 );
+
+		/* Inserting and removing.  The blocker task preempts this task as soon
+		as its delay is aborted, then delays again, which returns here. */
+		for( ulSample = 0; ulSample < benchSAMPLES; ulSample++ )
+		{
+			xBlockerDelay = prvRandomDelay();
+			ulRuns = ulBlockerRuns;
+			ullAbortTime = ullPortGetCycleCounter();
+
+			if( ( xTaskAbortDelay( xBlockerTask ) != pdPASS ) || ( ulBlockerRuns != ( ulRuns + 1 ) ) )
+			{
+				ulErrors++;
+			}
+
+			ullInsertCycles[ ulSample ] = ullPortGetCycleCounter() - ullBlockTime;
+			ullRemoveCycles[ ulSample ] = ullAbortCycles;
+		}
+
+		/* Unblocking.  The blocker task delays for one tick, so the next tick
+		moves it to the ready list ahead of every sleeper task. */
+		xBlockerDelay = 1;
+		( void ) xTaskAbortDelay( xBlockerTask );
+
+		for( ulSample = 0; ulSample < benchSAMPLES; ulSample++ )
+		{
+			ulRuns = ulBlockerRuns;
+
+			portDISABLE_INTERRUPTS();
+			{
+				ullUnblockCycles[ ulSample ] = ullPortGetCycleCounter();
+				( void ) xTaskIncrementTick();
+				ullUnblockCycles[ ulSample ] = ullPortGetCycleCounter() - ullUnblockCycles[ ulSample ];
+			}
+			portENABLE_INTERRUPTS();
+
+			/* Let the blocker task run and delay again. */
+			taskYIELD();
+
+			if( ulBlockerRuns != ( ulRuns + 1 ) )
+			{
+				ulErrors++;
+			}
+		}
+
+		printf( "%4lu delayed tasks: median insert %lu, remove %lu, unblock %lu cycles\n", ( unsigned long ) uxCreated, ( unsigned long ) prvMedian( ullInsertCycles ), ( unsigned long ) prvMedian( ullRemoveCycles ), ( unsigned long ) prvMedian( ullUnblockCycles ) );
+
+		/* Park the blocker task far in the future again before the next step. */
+		xBlockerDelay = prvRandomDelay();
+		( void ) xTaskAbortDelay( xBlockerTask );
+	}
+
+	taskENTER_CRITICAL();
+	{
+		if( ulErrors == 0 )
+		{
+			printf( "PASS\n" );
+		}
+		else
+		{
+			printf( "FAIL: %lu errors\n", ( unsigned long ) ulErrors );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	printf( "Delayed task heap %s\n", ( configUSE_DELAYED_TASK_HEAP == 1 ) ? "on" : "off" );
+
+	xTaskCreate( prvBlockerTask, "Blocker", benchSTACK_SIZE, NULL, benchBLOCKER_PRIORITY, &xBlockerTask );
+	xTaskCreate( prvBenchmarkTask, "Bench", benchSTACK_SIZE, NULL, benchBENCH_PRIORITY, NULL );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
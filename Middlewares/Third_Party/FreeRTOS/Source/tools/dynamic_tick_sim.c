@@ -0,0 +1,248 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side test of configUSE_DYNAMIC_TICK, using the simulated one-shot tick
+ * timer of the POSIX port.  Tasks of a higher priority than a worker task wake
+ * periodically, and check they run at exactly the tick they were due to run,
+ * while the worker models processing by moving simulated time forward in
+ * steps that are not a whole number of tick periods.  The worker checks that
+ * the tick count never drifts from simulated time - it must always equal the
+ * number of whole tick periods that have passed - whether the tick count was
+ * moved by the tick interrupt or brought up to date by xTaskGetTickCount().
+ * The number of tick interrupts is counted by the tick hook and reported
+ * against the number of ticks.
+ *
+ * Build with the POSIX port and any heap implementation, using a
+ * FreeRTOSConfig.h that sets configUSE_TICK_HOOK to 1, configUSE_TIMERS to 1,
+ * INCLUDE_vTaskDelayUntil to 1 and configPOSIX_SIMULATED_TICK to 1, and
+ * configUSE_DYNAMIC_TICK to 0 and then to 1 to compare the number of tick
+ * interrupts.  The drift checks are only performed when configUSE_DYNAMIC_TICK
+ * is 1, as simulated time is only kept to less than one tick period by the
+ * one-shot timer.  Setting configINITIAL_TICK_COUNT to a value just below
+ * portMAX_DELAY also tests the tick count overflowing.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+/* How long the test runs for. */
+#define simRUN_TICKS			( ( TickType_t ) 5000 )
+
+/* The periods of the tasks that check they wake on time, and of the timer. */
+#define simSLEEPERS				4
+#define simTIMER_PERIOD			( ( TickType_t ) 13 )
+
+/* The stack size, which must be at least PTHREAD_STACK_MIN bytes. */
+#define simSTACK_SIZE			( ( configSTACK_DEPTH_TYPE ) ( 32768 / sizeof( StackType_t ) ) )
+
+#define simNANOSECONDS_PER_TICK	( 1000000000ULL / ( uint64_t ) configTICK_RATE_HZ )
+
+static const TickType_t xSleeperPeriods[ simSLEEPERS ] = { 7, 11, 50, 101 };
+
+static volatile uint32_t ulTickInterrupts = 0;
+static volatile uint32_t ulWakes = 0, ulLateWakes = 0;
+static volatile uint32_t ulTimerCallbacks = 0, ulLateCallbacks = 0;
+static volatile uint32_t ulDriftChecks = 0, ulDriftErrors = 0;
+
+/*-----------------------------------------------------------*/
+
+void vApplicationTickHook( void )
+{
+	/* Called once per tick interrupt, which is once per tick unless
+	configUSE_DYNAMIC_TICK is 1. */
+	ulTickInterrupts++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckTime( TickType_t xExpected, volatile uint32_t *pulLate )
+{
+TickType_t xNow = xTaskGetTickCount();
+
+	if( xNow != xExpected )
+	{
+		( *pulLate )++;
+	}
+
+	#if( configUSE_DYNAMIC_TICK == 1 )
+	{
+	uint64_t ullElapsed = ullPortGetSimulatedTime();
+
+		/* The tick interrupt that made the task ready occurred on the tick
+		boundary. */
+		if( ( ullElapsed % simNANOSECONDS_PER_TICK ) != 0ULL )
+		{
+			( *pulLate )++;
+		}
+	}
+	#endif /* configUSE_DYNAMIC_TICK */
+}
+/*-----------------------------------------------------------*/
+
+static void prvSleeperTask( void *pvParameters )
+{
+TickType_t xPeriod = *( const TickType_t * ) pvParameters;
+TickType_t xLastWakeTime = xTaskGetTickCount();
+
+	for( ;; )
+	{
+		vTaskDelayUntil( &xLastWakeTime, xPeriod );
+		prvCheckTime( xLastWakeTime, &ulLateWakes );
+		ulWakes++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimerCallback( TimerHandle_t xTimer )
+{
+static TickType_t xExpected = configINITIAL_TICK_COUNT;
+
+	( void ) xTimer;
+
+	xExpected += simTIMER_PERIOD;
+	prvCheckTime( xExpected, &ulLateCallbacks );
+	ulTimerCallbacks++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckDrift( void )
+{
+	#if( configUSE_DYNAMIC_TICK == 1 )
+	{
+	TickType_t xTicks, xExpected;
+
+		taskENTER_CRITICAL();
+		{
+			xTicks = xTaskGetTickCount();
+			xExpected = ( TickType_t ) configINITIAL_TICK_COUNT + ( TickType_t ) ( ullPortGetSimulatedTime() / simNANOSECONDS_PER_TICK );
+		}
+		taskEXIT_CRITICAL();
+
+		if( xTicks != xExpected )
+		{
+			ulDriftErrors++;
+		}
+
+		ulDriftChecks++;
+	}
+	#endif /* configUSE_DYNAMIC_TICK */
+}
+/*-----------------------------------------------------------*/
+
+static void prvWorkerTask( void *pvParameters )
+{
+uint32_t ulRandom = 0x12345678UL, ulSteps;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		/* Process for a pseudo random number of steps, each of which takes
+		part of a tick period. */
+		ulRandom = ( ulRandom * 1103515245UL ) + 12345UL;
+		ulSteps = ( ulRandom >> 16 ) % 20UL;
+
+		while( ulSteps > 0UL )
+		{
+			#if( configUSE_DYNAMIC_TICK == 1 )
+			{
+				vPortAdvanceSimulatedTime( ( simNANOSECONDS_PER_TICK * 37ULL ) / 100ULL );
+			}
+			#else
+			{
+				vPortGenerateSimulatedTicks( 1 );
+			}
+			#endif
+
+			prvCheckDrift();
+			ulSteps--;
+		}
+
+		/* Then block for a pseudo random time so the idle task runs. */
+		ulRandom = ( ulRandom * 1103515245UL ) + 12345UL;
+		vTaskDelay( ( TickType_t ) ( ( ulRandom >> 16 ) % 30UL ) );
+		prvCheckDrift();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvControlTask( void *pvParameters )
+{
+TickType_t xTicks;
+
+	( void ) pvParameters;
+
+	vTaskDelay( simRUN_TICKS );
+
+	taskENTER_CRITICAL();
+	{
+		xTicks = xTaskGetTickCount() - ( TickType_t ) configINITIAL_TICK_COUNT;
+
+		printf( "%lu ticks, %lu tick interrupts\n", ( unsigned long ) xTicks, ( unsigned long ) ulTickInterrupts );
+		printf( "%lu wakes, %lu timer callbacks, %lu drift checks\n", ( unsigned long ) ulWakes, ( unsigned long ) ulTimerCallbacks, ( unsigned long ) ulDriftChecks );
+
+		if( ( ulLateWakes == 0 ) && ( ulLateCallbacks == 0 ) && ( ulDriftErrors == 0 ) && ( ulWakes > 0 ) && ( ulTimerCallbacks > 0 ) )
+		{
+			printf( "PASS\n" );
+		}
+		else
+		{
+			printf( "FAIL: %lu late wakes, %lu late callbacks, %lu drift errors\n", ( unsigned long ) ulLateWakes, ( unsigned long ) ulLateCallbacks, ( unsigned long ) ulDriftErrors );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+TimerHandle_t xTimer;
+BaseType_t x;
+
+	printf( "Dynamic tick %s\n", ( configUSE_DYNAMIC_TICK == 1 ) ? "on" : "off" );
+
+	for( x = 0; x < simSLEEPERS; x++ )
+	{
+		xTaskCreate( prvSleeperTask, "Sleep", simSTACK_SIZE, ( void * ) &( xSleeperPeriods[ x ] ), tskIDLE_PRIORITY + 2, NULL );
+	}
+
+	xTimer = xTimerCreate( "Timer", simTIMER_PERIOD, pdTRUE, NULL, prvTimerCallback );
+	configASSERT( xTimer );
+	( void ) xTimerStart( xTimer, 0 );
+
+	xTaskCreate( prvWorkerTask, "Work", simSTACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL );
+	xTaskCreate( prvControlTask, "Ctrl", simSTACK_SIZE, NULL, configMAX_PRIORITIES - 1, NULL );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,232 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side simulation of configUSE_EDF_SCHEDULING, using the simulated tick
+ * of the POSIX port so every run is the same.  Periodic tasks are released by
+ * vTaskDelayUntil() and model the processing time of each job by moving
+ * simulated time forward with vPortGenerateSimulatedTicks(), and each task
+ * counts the jobs that complete after their deadline, which is the end of
+ * their period.
+ *
+ * The first task set uses 96% of the processor time.  When
+ * configUSE_EDF_SCHEDULING is 0 the tasks are given rate monotonic priorities
+ * - the shorter the period the higher the priority - and the task with the
+ * longest period misses deadlines.  When configUSE_EDF_SCHEDULING is 1 the
+ * tasks are scheduled earliest deadline first, which meets every deadline of
+ * any task set that uses no more than all the processor time.  The second task
+ * set uses more than all the processor time, so deadlines are missed whichever
+ * way the tasks are scheduled, and is used to check the deadline miss counts
+ * kept by the kernel against those counted by the tasks.
+ *
+ * Build with the POSIX port and any heap implementation, using a
+ * FreeRTOSConfig.h that sets configPOSIX_SIMULATED_TICK to 1,
+ * INCLUDE_vTaskDelayUntil and INCLUDE_vTaskDelete to 1, configMAX_PRIORITIES to
+ * at least 6, and configUSE_EDF_SCHEDULING to 0 and then to 1 with
+ * configEDF_TASK_PRIORITY set to 3, and compare the results.  Any timer task
+ * must have a priority below configMAX_PRIORITIES - 1.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* How long each task set runs for. */
+#define simRUN_TICKS			( ( TickType_t ) 4800 )
+
+#define simTASKS				3
+
+/* The priority of the task with the longest period when the tasks are given
+rate monotonic priorities. */
+#define simRATE_MONOTONIC_BASE	( ( UBaseType_t ) 2 )
+
+/* The stack size, which must be at least PTHREAD_STACK_MIN bytes. */
+#define simSTACK_SIZE			( ( configSTACK_DEPTH_TYPE ) ( 32768 / sizeof( StackType_t ) ) )
+
+typedef struct SIM_TASK
+{
+	TickType_t xPeriod;				/* Also the relative deadline. */
+	TickType_t xExecutionTime;		/* The processing time of each job. */
+	TaskHandle_t xHandle;
+	volatile uint32_t ulJobs;
+	volatile uint32_t ulMisses;
+	volatile TickType_t xWorstResponse;
+} SimTask_t;
+
+/* Ordered by period, shortest first. */
+static SimTask_t xSchedulableSet[ simTASKS ] = { { 4, 1, NULL, 0, 0, 0 }, { 6, 2, NULL, 0, 0, 0 }, { 8, 3, NULL, 0, 0, 0 } };
+static SimTask_t xOverloadedSet[ simTASKS ] = { { 4, 1, NULL, 0, 0, 0 }, { 6, 2, NULL, 0, 0, 0 }, { 8, 4, NULL, 0, 0, 0 } };
+
+/*-----------------------------------------------------------*/
+
+static void prvPeriodicTask( void *pvParameters )
+{
+SimTask_t * const pxSimTask = ( SimTask_t * ) pvParameters;
+TickType_t xLastWakeTime, xResponse, xTick;
+
+	#if( configUSE_EDF_SCHEDULING == 1 )
+	{
+		vTaskSetDeadline( NULL, pxSimTask->xPeriod );
+	}
+	#endif
+
+	xLastWakeTime = xTaskGetTickCount();
+
+	for( ;; )
+	{
+		/* The job was released at xLastWakeTime. */
+		for( xTick = 0; xTick < pxSimTask->xExecutionTime; xTick++ )
+		{
+			vPortGenerateSimulatedTicks( 1 );
+		}
+
+		xResponse = xTaskGetTickCount() - xLastWakeTime;
+		pxSimTask->ulJobs++;
+
+		if( xResponse > pxSimTask->xPeriod )
+		{
+			pxSimTask->ulMisses++;
+		}
+
+		if( xResponse > pxSimTask->xWorstResponse )
+		{
+			pxSimTask->xWorstResponse = xResponse;
+		}
+
+		vTaskDelayUntil( &xLastWakeTime, pxSimTask->xPeriod );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvRunTaskSet( const char *pcName, SimTask_t *pxSet )
+{
+UBaseType_t uxTask, uxPriority;
+uint32_t ulUse = 0, ulTotalMisses = 0;
+BaseType_t xCountsMatch = pdTRUE;
+
+	for( uxTask = 0; uxTask < simTASKS; uxTask++ )
+	{
+		#if( configUSE_EDF_SCHEDULING == 1 )
+		{
+			uxPriority = configEDF_TASK_PRIORITY;
+		}
+		#else
+		{
+			uxPriority = simRATE_MONOTONIC_BASE + ( simTASKS - 1 - uxTask );
+		}
+		#endif
+
+		ulUse += ( uint32_t ) ( ( pxSet[ uxTask ].xExecutionTime * 1000UL ) / pxSet[ uxTask ].xPeriod );
+		xTaskCreate( prvPeriodicTask, "Periodic", simSTACK_SIZE, &( pxSet[ uxTask ] ), uxPriority, &( pxSet[ uxTask ].xHandle ) );
+	}
+
+	/* This task has the highest priority, so nothing else runs while the
+	results are read and the tasks deleted. */
+	vTaskDelay( simRUN_TICKS );
+
+	printf( "%s task set, %lu.%lu%% processor use\n", pcName, ( unsigned long ) ( ulUse / 10UL ), ( unsigned long ) ( ulUse % 10UL ) );
+
+	for( uxTask = 0; uxTask < simTASKS; uxTask++ )
+	{
+		printf( "  period %lu, execution time %lu: %lu jobs, %lu deadline misses, worst response %lu ticks\n",
+				( unsigned long ) pxSet[ uxTask ].xPeriod,
+				( unsigned long ) pxSet[ uxTask ].xExecutionTime,
+				( unsigned long ) pxSet[ uxTask ].ulJobs,
+				( unsigned long ) pxSet[ uxTask ].ulMisses,
+				( unsigned long ) pxSet[ uxTask ].xWorstResponse );
+
+		#if( configUSE_EDF_SCHEDULING == 1 )
+		{
+			if( ulTaskGetDeadlineMisses( pxSet[ uxTask ].xHandle ) != pxSet[ uxTask ].ulMisses )
+			{
+				printf( "  kernel counted %lu deadline misses\n", ( unsigned long ) ulTaskGetDeadlineMisses( pxSet[ uxTask ].xHandle ) );
+				xCountsMatch = pdFALSE;
+			}
+		}
+		#endif
+
+		ulTotalMisses += pxSet[ uxTask ].ulMisses;
+		vTaskDelete( pxSet[ uxTask ].xHandle );
+	}
+
+	/* Let the idle task free the deleted tasks. */
+	vTaskDelay( 1 );
+
+	return ( xCountsMatch != pdFALSE ) ? ( BaseType_t ) ulTotalMisses : ( BaseType_t ) -1;
+}
+/*-----------------------------------------------------------*/
+
+static void prvControlTask( void *pvParameters )
+{
+BaseType_t xSchedulableMisses, xOverloadedMisses, xPass;
+
+	( void ) pvParameters;
+
+	xSchedulableMisses = prvRunTaskSet( "Schedulable", xSchedulableSet );
+	xOverloadedMisses = prvRunTaskSet( "Overloaded", xOverloadedSet );
+
+	#if( configUSE_EDF_SCHEDULING == 1 )
+	{
+		/* Every deadline of the first set must be met, the second set must
+		miss deadlines, and the kernel must agree with the tasks. */
+		xPass = ( ( xSchedulableMisses == 0 ) && ( xOverloadedMisses > 0 ) ) ? pdTRUE : pdFALSE;
+	}
+	#else
+	{
+		/* Only check the tasks ran, rate monotonic priorities are expected to
+		miss deadlines in both sets. */
+		xPass = ( ( xSchedulableSet[ simTASKS - 1 ].ulJobs > 0UL ) && ( xOverloadedSet[ simTASKS - 1 ].ulJobs > 0UL ) ) ? pdTRUE : pdFALSE;
+	}
+	#endif
+
+	taskENTER_CRITICAL();
+	{
+		if( xPass != pdFALSE )
+		{
+			printf( "PASS: %ld and %ld deadline misses\n", ( long ) xSchedulableMisses, ( long ) xOverloadedMisses );
+		}
+		else
+		{
+			printf( "FAIL: %ld and %ld deadline misses, -1 if the kernel counted a different number\n", ( long ) xSchedulableMisses, ( long ) xOverloadedMisses );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	printf( "EDF scheduling %s\n", ( configUSE_EDF_SCHEDULING == 1 ) ? "on" : "off" );
+	xTaskCreate( prvControlTask, "Control", simSTACK_SIZE, NULL, configMAX_PRIORITIES - 1, NULL );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
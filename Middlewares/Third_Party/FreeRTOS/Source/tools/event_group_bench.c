@@ -0,0 +1,258 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side benchmark for xEventGroupSetBits() with a growing number of tasks
+ * blocked on the same event group.  A third of the tasks wait for all of two
+ * bits, a third for a single bit, and a third for any one of two bits.  The
+ * median time taken to set a bit that no task is waiting for is then measured
+ * using the cycle counter of the POSIX port.  Without configUSE_EVENT_GROUP_WAITER_INDEX
+ * that time grows with the number of waiting tasks.
+ *
+ * Each step also sets random bits and checks that exactly the tasks whose wait
+ * condition is met are unblocked.
+ *
+ * Build twice with the POSIX port and any heap implementation, using a
+ * FreeRTOSConfig.h that sets configUSE_EVENT_GROUP_WAITER_INDEX to 0 and then
+ * to 1, and compare the results.  configTOTAL_HEAP_SIZE must be large enough
+ * for the stacks of 64 tasks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_groups.h"
+
+#define benchMAX_WAITERS		64
+#define benchSET_BITS_CALLS		20000UL
+#define benchCHECK_ROUNDS		200
+
+/* Bits 0 to 19 are waited for individually, bit 20 by every task that waits
+for all of its bits, bit 21 by every task that waits for any of its bits, and
+bit 23 by no task. */
+#define benchSHARED_BITS		20
+#define benchALL_BIT			( ( EventBits_t ) 1 << 20 )
+#define benchANY_BIT			( ( EventBits_t ) 1 << 21 )
+#define benchUNUSED_BIT			( ( EventBits_t ) 1 << 23 )
+
+/* The stack size, which must be at least PTHREAD_STACK_MIN bytes. */
+#define benchSTACK_SIZE			( ( configSTACK_DEPTH_TYPE ) ( 32768 / sizeof( StackType_t ) ) )
+
+typedef struct WaiterDefinition
+{
+	EventBits_t uxBitsToWaitFor;
+	BaseType_t xWaitForAllBits;
+	TaskHandle_t xTask;
+	volatile BaseType_t xArmed;
+	volatile BaseType_t xWoken;
+} Waiter_t;
+
+static Waiter_t xWaiters[ benchMAX_WAITERS ];
+static uint64_t ullCycles[ benchSET_BITS_CALLS ];
+static EventGroupHandle_t xEventGroup = NULL;
+
+/*-----------------------------------------------------------*/
+
+static void prvWaiterTask( void *pvParameters )
+{
+Waiter_t *pxWaiter = ( Waiter_t * ) pvParameters;
+EventBits_t uxBits;
+
+	for( ;; )
+	{
+		pxWaiter->xArmed = pdTRUE;
+		uxBits = xEventGroupWaitBits( xEventGroup, pxWaiter->uxBitsToWaitFor, pdFALSE, pxWaiter->xWaitForAllBits, portMAX_DELAY );
+		if( ( uxBits & pxWaiter->uxBitsToWaitFor ) == 0 )
+		{
+			/* The event group was deleted. */
+			vTaskDelete( NULL );
+		}
+
+		pxWaiter->xArmed = pdFALSE;
+		pxWaiter->xWoken = pdTRUE;
+
+		/* Wait to be re-armed by the benchmark task. */
+		( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareCycles( const void *pv1, const void *pv2 )
+{
+uint64_t ull1 = *( const uint64_t * ) pv1, ull2 = *( const uint64_t * ) pv2;
+
+	return ( ull1 > ull2 ) - ( ull1 < ull2 );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvConditionMet( const Waiter_t *pxWaiter, EventBits_t uxBits )
+{
+BaseType_t xReturn;
+
+	if( pxWaiter->xWaitForAllBits != pdFALSE )
+	{
+		xReturn = ( ( uxBits & pxWaiter->uxBitsToWaitFor ) == pxWaiter->uxBitsToWaitFor ) ? pdTRUE : pdFALSE;
+	}
+	else
+	{
+		xReturn = ( ( uxBits & pxWaiter->uxBitsToWaitFor ) != 0 ) ? pdTRUE : pdFALSE;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckWakes( UBaseType_t uxNumberOfWaiters, EventBits_t uxBits, BaseType_t *pxExpectedWoken )
+{
+UBaseType_t ux;
+
+	for( ux = 0; ux < uxNumberOfWaiters; ux++ )
+	{
+		if( ( pxExpectedWoken[ ux ] == pdFALSE ) && ( prvConditionMet( &( xWaiters[ ux ] ), uxBits ) != pdFALSE ) )
+		{
+			pxExpectedWoken[ ux ] = pdTRUE;
+		}
+
+		if( xWaiters[ ux ].xWoken != pxExpectedWoken[ ux ] )
+		{
+			printf( "FAIL: task %lu waiting for 0x%lx (%s) with bits 0x%lx\n", ( unsigned long ) ux, ( unsigned long ) xWaiters[ ux ].uxBitsToWaitFor, ( xWaiters[ ux ].xWaitForAllBits != pdFALSE ) ? "all" : "any", ( unsigned long ) uxBits );
+			exit( EXIT_FAILURE );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void *pvParameters )
+{
+UBaseType_t uxNumberOfWaiters = 0, ux, uxStep, uxNumberOfTasks;
+BaseType_t xExpectedWoken[ benchMAX_WAITERS ];
+EventBits_t uxBits, uxBit;
+uint64_t ullStart;
+uint32_t ul, ulRandom = 1UL;
+int iRound;
+
+	( void ) pvParameters;
+
+	uxNumberOfTasks = uxTaskGetNumberOfTasks();
+
+	for( uxStep = 4; uxStep <= benchMAX_WAITERS; uxStep *= 2 )
+	{
+		/* Add waiting tasks up to the number for this step. */
+		for( ; uxNumberOfWaiters < uxStep; uxNumberOfWaiters++ )
+		{
+			uxBit = ( EventBits_t ) 1 << ( uxNumberOfWaiters % benchSHARED_BITS );
+
+			switch( uxNumberOfWaiters % 3 )
+			{
+				case 0 :
+					xWaiters[ uxNumberOfWaiters ].uxBitsToWaitFor = uxBit | benchALL_BIT;
+					xWaiters[ uxNumberOfWaiters ].xWaitForAllBits = pdTRUE;
+					break;
+
+				case 1 :
+					xWaiters[ uxNumberOfWaiters ].uxBitsToWaitFor = uxBit;
+					xWaiters[ uxNumberOfWaiters ].xWaitForAllBits = pdFALSE;
+					break;
+
+				default :
+					xWaiters[ uxNumberOfWaiters ].uxBitsToWaitFor = uxBit | benchANY_BIT;
+					xWaiters[ uxNumberOfWaiters ].xWaitForAllBits = pdFALSE;
+					break;
+			}
+
+			xTaskCreate( prvWaiterTask, "Waiter", benchSTACK_SIZE, &( xWaiters[ uxNumberOfWaiters ] ), tskIDLE_PRIORITY + 2, &( xWaiters[ uxNumberOfWaiters ].xTask ) );
+			configASSERT( xWaiters[ uxNumberOfWaiters ].xTask );
+		}
+
+		/* Set a bit no task is waiting for. */
+		for( ul = 0; ul < benchSET_BITS_CALLS; ul++ )
+		{
+			ullStart = ullPortGetCycleCounter();
+			( void ) xEventGroupSetBits( xEventGroup, benchUNUSED_BIT );
+			ullCycles[ ul ] = ullPortGetCycleCounter() - ullStart;
+			( void ) xEventGroupClearBits( xEventGroup, benchUNUSED_BIT );
+		}
+
+		/* Set random bits one at a time, checking exactly the right tasks
+		are unblocked, then clear the bits and re-arm the unblocked tasks. */
+		for( iRound = 0; iRound < benchCHECK_ROUNDS; iRound++ )
+		{
+			for( ux = 0; ux < uxNumberOfWaiters; ux++ )
+			{
+				configASSERT( xWaiters[ ux ].xArmed != pdFALSE );
+				xExpectedWoken[ ux ] = pdFALSE;
+			}
+
+			uxBits = 0;
+
+			for( ul = 0; ul < 6UL; ul++ )
+			{
+				ulRandom = ( ulRandom * 1103515245UL ) + 12345UL;
+				uxBit = ( EventBits_t ) 1 << ( ( ulRandom >> 16 ) % ( benchSHARED_BITS + 2 ) );
+				uxBits |= uxBit;
+				( void ) xEventGroupSetBits( xEventGroup, uxBit );
+				prvCheckWakes( uxNumberOfWaiters, uxBits, xExpectedWoken );
+			}
+
+			( void ) xEventGroupClearBits( xEventGroup, uxBits );
+
+			for( ux = 0; ux < uxNumberOfWaiters; ux++ )
+			{
+				if( xWaiters[ ux ].xWoken != pdFALSE )
+				{
+					xWaiters[ ux ].xWoken = pdFALSE;
+					xTaskNotifyGive( xWaiters[ ux ].xTask );
+				}
+			}
+		}
+
+		/* The median is reported as the host occasionally interrupts a call
+		for far longer than the call itself takes. */
+		qsort( ullCycles, benchSET_BITS_CALLS, sizeof( ullCycles[ 0 ] ), prvCompareCycles );
+		printf( "%3lu waiting tasks: median %lu cycles per xEventGroupSetBits()\n", ( unsigned long ) uxNumberOfWaiters, ( unsigned long ) ullCycles[ benchSET_BITS_CALLS / 2 ] );
+	}
+
+	vEventGroupDelete( xEventGroup );
+	vTaskDelay( pdMS_TO_TICKS( 100 ) );
+	printf( "%s\n", ( uxTaskGetNumberOfTasks() == uxNumberOfTasks ) ? "PASS" : "FAIL: tasks remain blocked on the deleted event group" );
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	xEventGroup = xEventGroupCreate();
+	configASSERT( xEventGroup );
+
+	printf( "Waiter index %s\n", ( configUSE_EVENT_GROUP_WAITER_INDEX == 1 ) ? "on" : "off" );
+	xTaskCreate( prvBenchmarkTask, "Bench", benchSTACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
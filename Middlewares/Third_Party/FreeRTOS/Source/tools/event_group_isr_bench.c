@@ -0,0 +1,194 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side benchmark for xEventGroupSetBitsFromISR().  The tick hook, which
+ * the POSIX port calls from its tick interrupt, sets a bit that a task of the
+ * highest priority is waiting for, and the median number of cycles from the
+ * call to xEventGroupSetBitsFromISR() to the task running again is reported.
+ * Without configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR the bit is set by the timer
+ * task, so the time includes a context switch to and from the timer task.
+ *
+ * A second phase sets the bit while a low priority task holds the scheduler
+ * suspended most of the time, so with configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR
+ * the bits are mostly held until xTaskResumeAll() is called, and checks that
+ * every set unblocks the task exactly once.
+ *
+ * Build twice with the POSIX port and any heap implementation, using a
+ * FreeRTOSConfig.h that sets configUSE_TICK_HOOK to 1, configUSE_TIMERS and
+ * INCLUDE_xTimerPendFunctionCall to 1, and configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR
+ * to 0 and then to 1, and compare the results.  The timer task must have a
+ * priority below configMAX_PRIORITIES - 1.  configPOSIX_SIMULATED_TICK must be
+ * set to 0, as simulated time does not move while a task holds the scheduler
+ * suspended.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_groups.h"
+
+#define benchSAMPLES			500UL
+#define benchBIT				( ( EventBits_t ) 1 << 0 )
+
+/* How long the scheduler is held suspended at a time in the second phase. */
+#define benchSUSPENDED_CYCLES	200000ULL
+
+/* The stack size, which must be at least PTHREAD_STACK_MIN bytes. */
+#define benchSTACK_SIZE			( ( configSTACK_DEPTH_TYPE ) ( 32768 / sizeof( StackType_t ) ) )
+
+static EventGroupHandle_t xEventGroup = NULL;
+static volatile BaseType_t xWaiterArmed = pdFALSE;
+static volatile uint64_t ullSetTime = 0;
+static volatile uint32_t ulSets = 0, ulSetFailures = 0, ulWakes = 0;
+static uint64_t ullLatency[ benchSAMPLES ];
+
+/*-----------------------------------------------------------*/
+
+void vApplicationTickHook( void )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	/* Only set the bit once the waiting task has consumed the last one, so
+	every set must result in exactly one wake. */
+	if( xWaiterArmed != pdFALSE )
+	{
+		xWaiterArmed = pdFALSE;
+		ulSets++;
+		ullSetTime = ullPortGetCycleCounter();
+
+		if( xEventGroupSetBitsFromISR( xEventGroup, benchBIT, &xHigherPriorityTaskWoken ) != pdPASS )
+		{
+			ulSetFailures++;
+		}
+
+		/* The tick interrupt performs the context switch if one is needed. */
+		( void ) xHigherPriorityTaskWoken;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvWaiterTask( void *pvParameters )
+{
+uint64_t ullNow;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		xWaiterArmed = pdTRUE;
+		( void ) xEventGroupWaitBits( xEventGroup, benchBIT, pdTRUE, pdFALSE, portMAX_DELAY );
+		ullNow = ullPortGetCycleCounter();
+
+		if( ulWakes < benchSAMPLES )
+		{
+			ullLatency[ ulWakes ] = ullNow - ullSetTime;
+		}
+
+		ulWakes++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareCycles( const void *pv1, const void *pv2 )
+{
+uint64_t ull1 = *( const uint64_t * ) pv1, ull2 = *( const uint64_t * ) pv2;
+
+	return ( ull1 > ull2 ) - ( ull1 < ull2 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void *pvParameters )
+{
+uint64_t ullStart;
+uint32_t ulFirstSet;
+
+	( void ) pvParameters;
+
+	xTaskCreate( prvWaiterTask, "Waiter", benchSTACK_SIZE, NULL, configMAX_PRIORITIES - 1, NULL );
+
+	/* Phase one - the bit is set while the scheduler is running. */
+	while( ulWakes < benchSAMPLES )
+	{
+		vTaskDelay( pdMS_TO_TICKS( 10 ) );
+	}
+
+	/* The median is reported as the host occasionally interrupts the
+	simulated interrupt for far longer than it takes. */
+	qsort( ullLatency, benchSAMPLES, sizeof( ullLatency[ 0 ] ), prvCompareCycles );
+	printf( "median %lu cycles from xEventGroupSetBitsFromISR() to the waiting task running\n", ( unsigned long ) ullLatency[ benchSAMPLES / 2 ] );
+
+	/* Phase two - the bit is mostly set while the scheduler is suspended. */
+	ulFirstSet = ulSets;
+
+	while( ( ulSets - ulFirstSet ) < benchSAMPLES )
+	{
+		vTaskSuspendAll();
+		{
+			ullStart = ullPortGetCycleCounter();
+
+			while( ( ullPortGetCycleCounter() - ullStart ) < benchSUSPENDED_CYCLES )
+			{
+				/* Nothing to do here, just hold the scheduler suspended. */
+			}
+		}
+		( void ) xTaskResumeAll();
+	}
+
+	/* Let the last set be consumed. */
+	vTaskDelay( pdMS_TO_TICKS( 10 ) );
+
+	taskENTER_CRITICAL();
+	{
+		if( ( ulSetFailures == 0 ) && ( ulSets == ulWakes ) )
+		{
+			printf( "PASS: %lu sets, %lu wakes\n", ( unsigned long ) ulSets, ( unsigned long ) ulWakes );
+		}
+		else
+		{
+			printf( "FAIL: %lu sets, %lu failed, %lu wakes\n", ( unsigned long ) ulSets, ( unsigned long ) ulSetFailures, ( unsigned long ) ulWakes );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	xEventGroup = xEventGroupCreate();
+	configASSERT( xEventGroup );
+
+	printf( "Direct set from ISR %s\n", ( configUSE_EVENT_GROUP_DIRECT_SET_FROM_ISR == 1 ) ? "on" : "off" );
+	xTaskCreate( prvBenchmarkTask, "Bench", benchSTACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
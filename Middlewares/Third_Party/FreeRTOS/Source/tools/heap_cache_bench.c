@@ -0,0 +1,271 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side benchmark for the task cache of heap_4.c.  Eight tasks of equal
+ * priority repeatedly allocate batches of 16 to 256 byte blocks and free them
+ * in a different order, yielding to each other between batches, and the time
+ * taken by pvPortMalloc() and vPortFree() is measured using the cycle counter
+ * of the POSIX port.  The tasks are then deleted, and the number of blocks
+ * that remain allocated is reported, so blocks lost from a task's cache show as
+ * a number that grows from one round to the next.
+ *
+ * Finally a higher priority task repeatedly deletes tasks that allocate and
+ * free in a tight loop, so many are deleted part way through pvPortMalloc() or
+ * vPortFree().  A deleted task may leak the blocks it had allocated, but no
+ * more than that, and a cache left inconsistent by a deletion would free a
+ * block twice, which heap_4.c asserts against.  The test passes if the number
+ * of leaked blocks is within that limit.
+ *
+ * Build twice with the POSIX port and heap_4.c, using a FreeRTOSConfig.h that
+ * sets configUSE_HEAP_TASK_CACHE to 0 and then to 1, and compare the results.
+ * The configuration must also set configNUM_THREAD_LOCAL_STORAGE_POINTERS to
+ * at least 1, INCLUDE_vTaskDelete and INCLUDE_xTaskGetSchedulerState to 1,
+ * configASSERT(), configPOSIX_SIMULATED_TICK to 0, so tasks are preempted by
+ * the tick at any point, and configTOTAL_HEAP_SIZE large enough for the task
+ * stacks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define benchNUMBER_OF_TASKS	8
+#define benchBATCH_SIZE			16
+#define benchBATCHES			20000
+#define benchROUNDS				3
+#define benchDELETIONS			2000
+#define benchHELD_BLOCKS		4
+
+#if !defined( configPOSIX_SIMULATED_TICK ) || ( configPOSIX_SIMULATED_TICK != 0 )
+	#error configPOSIX_SIMULATED_TICK must be set to 0 so tasks are deleted at arbitrary points.
+#endif
+
+/* The stack size, which must be at least PTHREAD_STACK_MIN bytes. */
+#define benchSTACK_SIZE			( ( configSTACK_DEPTH_TYPE ) ( 32768 / sizeof( StackType_t ) ) )
+
+static TaskHandle_t xMonitorTask = NULL;
+
+/* Cycles spent in pvPortMalloc() and vPortFree(), per task. */
+static uint64_t ullMallocCycles[ benchNUMBER_OF_TASKS ], ullFreeCycles[ benchNUMBER_OF_TASKS ];
+
+/* pdTRUE while a task of the deletion test is inside pvPortMalloc() or
+vPortFree(). */
+static volatile BaseType_t xInHeap[ benchNUMBER_OF_TASKS ];
+
+/*-----------------------------------------------------------*/
+
+static void prvWorkerTask( void *pvParameters )
+{
+UBaseType_t uxTask = ( UBaseType_t ) ( size_t ) pvParameters;
+void *pvBlocks[ benchBATCH_SIZE ];
+uint32_t ulRandom = ( uint32_t ) uxTask + 1UL;
+uint64_t ullStart;
+size_t x, xBatch;
+
+	for( xBatch = 0; xBatch < benchBATCHES; xBatch++ )
+	{
+		for( x = 0; x < benchBATCH_SIZE; x++ )
+		{
+			/* Sizes from 16 to 256 bytes. */
+			ulRandom = ( ulRandom * 1103515245UL ) + 12345UL;
+
+			ullStart = ullPortGetCycleCounter();
+			pvBlocks[ x ] = pvPortMalloc( ( size_t ) 16 + ( ( ulRandom >> 16 ) % 241UL ) );
+			ullMallocCycles[ uxTask ] += ullPortGetCycleCounter() - ullStart;
+
+			configASSERT( pvBlocks[ x ] );
+		}
+
+		/* Free every other block, then the rest, so blocks are not freed in
+		the order in which they were allocated. */
+		for( x = 0; x < benchBATCH_SIZE; x++ )
+		{
+			ullStart = ullPortGetCycleCounter();
+			vPortFree( pvBlocks[ ( ( x * 2U ) + ( x / ( benchBATCH_SIZE / 2U ) ) ) % benchBATCH_SIZE ] );
+			ullFreeCycles[ uxTask ] += ullPortGetCycleCounter() - ullStart;
+		}
+
+		taskYIELD();
+	}
+
+	xTaskNotifyGive( xMonitorTask );
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvDeletedTask( void *pvParameters )
+{
+UBaseType_t uxTask = ( UBaseType_t ) ( size_t ) pvParameters;
+void *pvBlocks[ benchHELD_BLOCKS ];
+uint32_t ulRandom = ( uint32_t ) uxTask + 1UL;
+size_t x;
+
+	for( ;; )
+	{
+		for( x = 0; x < benchHELD_BLOCKS; x++ )
+		{
+			ulRandom = ( ulRandom * 1103515245UL ) + 12345UL;
+
+			xInHeap[ uxTask ] = pdTRUE;
+			pvBlocks[ x ] = pvPortMalloc( ( size_t ) 16 + ( ( ulRandom >> 16 ) % 241UL ) );
+			xInHeap[ uxTask ] = pdFALSE;
+
+			configASSERT( pvBlocks[ x ] );
+		}
+
+		for( x = 0; x < benchHELD_BLOCKS; x++ )
+		{
+			xInHeap[ uxTask ] = pdTRUE;
+			vPortFree( pvBlocks[ x ] );
+			xInHeap[ uxTask ] = pdFALSE;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvDeletionTest( void )
+{
+TaskHandle_t xTasks[ benchNUMBER_OF_TASKS ];
+HeapStats_t xStats;
+size_t xAllocatedBefore, xLeaked;
+UBaseType_t uxTask;
+uint32_t ulDeletion, ulInHeap = 0;
+
+	vPortGetHeapStats( &xStats );
+	xAllocatedBefore = xStats.xNumberOfSuccessfulAllocations - xStats.xNumberOfSuccessfulFrees;
+
+	for( uxTask = 0; uxTask < benchNUMBER_OF_TASKS; uxTask++ )
+	{
+		xTaskCreate( prvDeletedTask, "Deleted", benchSTACK_SIZE, ( void * ) ( size_t ) uxTask, tskIDLE_PRIORITY + 1, &( xTasks[ uxTask ] ) );
+	}
+
+	/* Each tick preempts the running task at an arbitrary point, and the
+	other tasks were preempted by earlier ticks. */
+	for( ulDeletion = 0; ulDeletion < benchDELETIONS; ulDeletion++ )
+	{
+		vTaskDelay( 1 );
+
+		uxTask = ( UBaseType_t ) ( ulDeletion % benchNUMBER_OF_TASKS );
+
+		if( xInHeap[ uxTask ] != pdFALSE )
+		{
+			ulInHeap++;
+		}
+
+		vTaskDelete( xTasks[ uxTask ] );
+		xInHeap[ uxTask ] = pdFALSE;
+		xTaskCreate( prvDeletedTask, "Deleted", benchSTACK_SIZE, ( void * ) ( size_t ) uxTask, tskIDLE_PRIORITY + 1, &( xTasks[ uxTask ] ) );
+	}
+
+	for( uxTask = 0; uxTask < benchNUMBER_OF_TASKS; uxTask++ )
+	{
+		vTaskDelete( xTasks[ uxTask ] );
+	}
+
+	/* Give the idle task time to free the deleted tasks. */
+	vTaskDelay( pdMS_TO_TICKS( 100 ) );
+
+	vPortGetHeapStats( &xStats );
+	xLeaked = ( xStats.xNumberOfSuccessfulAllocations - xStats.xNumberOfSuccessfulFrees ) - xAllocatedBefore;
+
+	/* Each deleted task can leak the blocks it held, and the one it was
+	allocating or freeing. */
+	printf( "deleted %lu tasks, %lu inside pvPortMalloc() or vPortFree(), %lu blocks leaked\n",
+			( unsigned long ) ( benchDELETIONS + benchNUMBER_OF_TASKS ), ( unsigned long ) ulInHeap, ( unsigned long ) xLeaked );
+
+	if( xLeaked <= ( ( size_t ) benchHELD_BLOCKS * ( benchDELETIONS + benchNUMBER_OF_TASKS ) ) )
+	{
+		printf( "PASS\n" );
+	}
+	else
+	{
+		printf( "FAIL\n" );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvMonitorTask( void *pvParameters )
+{
+HeapStats_t xStats;
+uint64_t ullMalloc, ullFree;
+UBaseType_t uxTask, uxRound;
+
+	( void ) pvParameters;
+
+	for( uxRound = 0; uxRound < benchROUNDS; uxRound++ )
+	{
+		for( uxTask = 0; uxTask < benchNUMBER_OF_TASKS; uxTask++ )
+		{
+			ullMallocCycles[ uxTask ] = 0;
+			ullFreeCycles[ uxTask ] = 0;
+			xTaskCreate( prvWorkerTask, "Worker", benchSTACK_SIZE, ( void * ) ( size_t ) uxTask, tskIDLE_PRIORITY + 1, NULL );
+		}
+
+		for( uxTask = 0; uxTask < benchNUMBER_OF_TASKS; uxTask++ )
+		{
+			ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+		}
+
+		/* Give the idle task time to free the deleted tasks. */
+		vTaskDelay( pdMS_TO_TICKS( 100 ) );
+
+		ullMalloc = 0;
+		ullFree = 0;
+
+		for( uxTask = 0; uxTask < benchNUMBER_OF_TASKS; uxTask++ )
+		{
+			ullMalloc += ullMallocCycles[ uxTask ];
+			ullFree += ullFreeCycles[ uxTask ];
+		}
+
+		vPortGetHeapStats( &xStats );
+
+		printf( "round %lu: task cache %s, malloc %.1f cycles, free %.1f cycles, %lu blocks still allocated, %lu free blocks\n",
+				( unsigned long ) uxRound,
+				( configUSE_HEAP_TASK_CACHE == 1 ) ? "on" : "off",
+				( double ) ullMalloc / ( double ) ( benchNUMBER_OF_TASKS * benchBATCHES * benchBATCH_SIZE ),
+				( double ) ullFree / ( double ) ( benchNUMBER_OF_TASKS * benchBATCHES * benchBATCH_SIZE ),
+				( unsigned long ) ( xStats.xNumberOfSuccessfulAllocations - xStats.xNumberOfSuccessfulFrees ),
+				( unsigned long ) xStats.xNumberOfFreeBlocks );
+	}
+
+	prvDeletionTest();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	xTaskCreate( prvMonitorTask, "Monitor", benchSTACK_SIZE, NULL, tskIDLE_PRIORITY + 2, &xMonitorTask );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
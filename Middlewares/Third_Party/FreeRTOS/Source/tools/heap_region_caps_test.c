@@ -0,0 +1,421 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side test of the heap_5.c regions.  Three array-backed regions are
+ * defined, laid out as on an STM32H7:
+ *
+ * + Region 0 - fast memory, standing in for DTCM.
+ * + Region 1 - plain memory with no capabilities.
+ * + Region 2 - DMA capable, non-cacheable memory, standing in for SRAM4.
+ *
+ * When configUSE_HEAP_REGION_CAPABILITIES is 1 the test checks that:
+ *
+ * + pvPortMalloc(), and pvPortMallocCaps() with no capabilities, take memory
+ *   from the plain region first.
+ * + pvPortMallocCaps() with each capability mask takes memory from the only
+ *   region that has all the requested capabilities, and returns NULL if no
+ *   region has them all, or the regions that do have too little free memory.
+ * + Once the plain region is full, plain allocations fall back to the fast
+ *   region (one capability), then to the DMA region (two capabilities), and
+ *   fail once every region is full.  A capability request never falls back to
+ *   a region without the capability.
+ *
+ * When configUSE_HEAP_REGION_CAPABILITIES is 0 the regions have no
+ * capabilities, and the test checks that:
+ *
+ * + pvPortMalloc() takes memory from the lowest address region first, and
+ *   within a region from the lowest address free block that is large enough,
+ *   so a freed block is reused before the space that follows it.
+ * + Once a region is full, allocations fall through to the next region in
+ *   address order, fail once every region is full, and use the lowest region
+ *   again once it has room.
+ * + A freed block is merged with the free blocks on either side of it, so a
+ *   region that has one free block still has one after each free.
+ *
+ * In both cases, after every allocation and free, xPortGetHeapRegionStats()
+ * reports the expected free bytes for every region, and the regions add up to
+ * the totals reported by vPortGetHeapStats().  Once everything is freed each
+ * region is back to its initial free bytes, in a single free block.
+ *
+ * Build with the POSIX port and heap_5.c, once using a FreeRTOSConfig.h that
+ * sets configUSE_HEAP_REGION_CAPABILITIES to 1 and once with it set to 0.  The
+ * scheduler is not started.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define testREGIONS				3
+#define testFAST_REGION			0
+#define testPLAIN_REGION		1
+#define testDMA_REGION			2
+
+#define testFAST_SIZE			( 16 * 1024 )
+#define testPLAIN_SIZE			( 64 * 1024 )
+#define testDMA_SIZE			( 8 * 1024 )
+
+/* Each block is preceded by a header of two words, rounded up to the byte
+alignment, and its size is rounded up to the byte alignment. */
+#define testALIGN( x )			( ( ( x ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+#define testHEADER_SIZE			testALIGN( sizeof( void * ) + sizeof( size_t ) )
+#define testBLOCK_SIZE( x )		testALIGN( ( x ) + testHEADER_SIZE )
+
+/* The regions are in one structure so they appear in address order. */
+static struct
+{
+	uint8_t ucFast[ testFAST_SIZE ];
+	uint8_t ucPlain[ testPLAIN_SIZE ];
+	uint8_t ucDMA[ testDMA_SIZE ];
+} xMemory __attribute__( ( aligned( portBYTE_ALIGNMENT ) ) );
+
+#if( configUSE_HEAP_REGION_CAPABILITIES == 1 )
+
+	static const HeapRegion_t xHeapRegions[] =
+	{
+		{ xMemory.ucFast, sizeof( xMemory.ucFast ), portHEAP_CAPABILITY_FAST },
+		{ xMemory.ucPlain, sizeof( xMemory.ucPlain ), 0 },
+		{ xMemory.ucDMA, sizeof( xMemory.ucDMA ), portHEAP_CAPABILITY_DMA | portHEAP_CAPABILITY_NON_CACHEABLE },
+		{ NULL, 0, 0 }
+	};
+
+#else
+
+	static const HeapRegion_t xHeapRegions[] =
+	{
+		{ xMemory.ucFast, sizeof( xMemory.ucFast ) },
+		{ xMemory.ucPlain, sizeof( xMemory.ucPlain ) },
+		{ xMemory.ucDMA, sizeof( xMemory.ucDMA ) },
+		{ NULL, 0 }
+	};
+
+#endif /* configUSE_HEAP_REGION_CAPABILITIES */
+
+/* The free bytes each region should have. */
+static size_t xExpectedFree[ testREGIONS ];
+static size_t xInitialFree[ testREGIONS ];
+static uint32_t ulChecks = 0, ulErrors = 0;
+
+/*-----------------------------------------------------------*/
+
+static void prvCheck( BaseType_t xPassed, const char *pcWhat )
+{
+	ulChecks++;
+
+	if( xPassed == pdFALSE )
+	{
+		ulErrors++;
+		printf( "failed: %s\n", pcWhat );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvRegionOf( const void *pv )
+{
+BaseType_t xRegion;
+
+	for( xRegion = 0; xRegion < testREGIONS; xRegion++ )
+	{
+		if( ( ( const uint8_t * ) pv >= xHeapRegions[ xRegion ].pucStartAddress ) &&
+			( ( const uint8_t * ) pv < ( xHeapRegions[ xRegion ].pucStartAddress + xHeapRegions[ xRegion ].xSizeInBytes ) ) )
+		{
+			return xRegion;
+		}
+	}
+
+	return -1;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckFreeBytes( const char *pcWhat )
+{
+HeapStats_t xRegionStats, xTotalStats;
+BaseType_t xRegion;
+size_t xTotal = 0;
+BaseType_t xPassed = pdTRUE;
+
+	for( xRegion = 0; xRegion < testREGIONS; xRegion++ )
+	{
+		if( ( xPortGetHeapRegionStats( xRegion, &xRegionStats ) != pdPASS ) || ( xRegionStats.xAvailableHeapSpaceInBytes != xExpectedFree[ xRegion ] ) )
+		{
+			printf( "region %ld has %lu free bytes, expected %lu\n", ( long ) xRegion, ( unsigned long ) xRegionStats.xAvailableHeapSpaceInBytes, ( unsigned long ) xExpectedFree[ xRegion ] );
+			xPassed = pdFALSE;
+		}
+
+		xTotal += xRegionStats.xAvailableHeapSpaceInBytes;
+	}
+
+	vPortGetHeapStats( &xTotalStats );
+
+	if( ( xTotalStats.xAvailableHeapSpaceInBytes != xTotal ) || ( xPortGetFreeHeapSize() != xTotal ) )
+	{
+		xPassed = pdFALSE;
+	}
+
+	prvCheck( xPassed, pcWhat );
+}
+/*-----------------------------------------------------------*/
+
+static void *prvAllocate( size_t xSize, uint32_t ulCapabilities, BaseType_t xExpectedRegion, const char *pcWhat )
+{
+void *pv;
+
+	#if( configUSE_HEAP_REGION_CAPABILITIES == 1 )
+	{
+		pv = pvPortMallocCaps( xSize, ulCapabilities );
+	}
+	#else
+	{
+		configASSERT( ulCapabilities == 0UL );
+		pv = pvPortMalloc( xSize );
+	}
+	#endif
+
+	if( xExpectedRegion < 0 )
+	{
+		prvCheck( pv == NULL, pcWhat );
+	}
+	else
+	{
+		prvCheck( ( pv != NULL ) && ( prvRegionOf( pv ) == xExpectedRegion ), pcWhat );
+
+		if( pv != NULL )
+		{
+			xExpectedFree[ prvRegionOf( pv ) ] -= testBLOCK_SIZE( xSize );
+		}
+	}
+
+	prvCheckFreeBytes( pcWhat );
+
+	return pv;
+}
+/*-----------------------------------------------------------*/
+
+static void prvFree( void *pv, size_t xSize )
+{
+	if( pv != NULL )
+	{
+		xExpectedFree[ prvRegionOf( pv ) ] += testBLOCK_SIZE( xSize );
+		vPortFree( pv );
+		prvCheckFreeBytes( "free bytes after vPortFree()" );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvLargestFree( BaseType_t xRegion )
+{
+HeapStats_t xStats;
+
+	( void ) xPortGetHeapRegionStats( xRegion, &xStats );
+
+	return xStats.xSizeOfLargestFreeBlockInBytes - testHEADER_SIZE;
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_HEAP_REGION_CAPABILITIES == 1 )
+
+	static void prvCapabilitiesTest( void )
+	{
+	void *pvPlain, *pvPlainCaps, *pvFast, *pvDMA, *pvNonCacheable, *pvDMANonCacheable;
+	void *pvFillPlain, *pvFallbackFast, *pvFillFast, *pvFallbackDMA, *pvFillDMA;
+	size_t xFillPlain, xFillFast, xFillDMA;
+
+		/* Allocating from each capability mask. */
+		pvPlain = pvPortMalloc( 100 );
+		prvCheck( ( pvPlain != NULL ) && ( prvRegionOf( pvPlain ) == testPLAIN_REGION ), "pvPortMalloc() takes memory from the plain region" );
+		xExpectedFree[ testPLAIN_REGION ] -= testBLOCK_SIZE( 100 );
+		prvCheckFreeBytes( "free bytes after pvPortMalloc()" );
+
+		pvPlainCaps = prvAllocate( 200, 0, testPLAIN_REGION, "no capabilities takes memory from the plain region" );
+		pvFast = prvAllocate( 300, portHEAP_CAPABILITY_FAST, testFAST_REGION, "FAST takes memory from the fast region" );
+		pvDMA = prvAllocate( 400, portHEAP_CAPABILITY_DMA, testDMA_REGION, "DMA takes memory from the DMA region" );
+		pvNonCacheable = prvAllocate( 500, portHEAP_CAPABILITY_NON_CACHEABLE, testDMA_REGION, "NON_CACHEABLE takes memory from the DMA region" );
+		pvDMANonCacheable = prvAllocate( 600, portHEAP_CAPABILITY_DMA | portHEAP_CAPABILITY_NON_CACHEABLE, testDMA_REGION, "DMA | NON_CACHEABLE takes memory from the DMA region" );
+
+		/* Failing. */
+		( void ) prvAllocate( 100, portHEAP_CAPABILITY_FAST | portHEAP_CAPABILITY_DMA, -1, "FAST | DMA fails as no region has both" );
+		( void ) prvAllocate( 100, ( uint32_t ) 0x80000000UL, -1, "a capability no region has fails" );
+		( void ) prvAllocate( testDMA_SIZE, portHEAP_CAPABILITY_DMA, -1, "DMA larger than the DMA region fails" );
+
+		/* Falling back.  Once the plain region is full, plain allocations come
+		from the fast region, which has fewer capabilities than the DMA region. */
+		xFillPlain = prvLargestFree( testPLAIN_REGION );
+		pvFillPlain = prvAllocate( xFillPlain, 0, testPLAIN_REGION, "filling the plain region" );
+		prvCheck( xExpectedFree[ testPLAIN_REGION ] == 0, "the plain region is full" );
+		pvFallbackFast = prvAllocate( 700, 0, testFAST_REGION, "a plain allocation falls back to the fast region" );
+
+		xFillFast = prvLargestFree( testFAST_REGION );
+		pvFillFast = prvAllocate( xFillFast, portHEAP_CAPABILITY_FAST, testFAST_REGION, "filling the fast region" );
+		( void ) prvAllocate( 100, portHEAP_CAPABILITY_FAST, -1, "FAST fails once the fast region is full, although the DMA region has room" );
+		pvFallbackDMA = prvAllocate( 800, 0, testDMA_REGION, "a plain allocation falls back to the DMA region" );
+
+		xFillDMA = prvLargestFree( testDMA_REGION );
+		pvFillDMA = prvAllocate( xFillDMA, portHEAP_CAPABILITY_DMA, testDMA_REGION, "filling the DMA region" );
+		( void ) prvAllocate( 100, 0, -1, "a plain allocation fails once every region is full" );
+
+		/* Freeing a block in the plain region makes it the first choice again. */
+		prvFree( pvPlain, 100 );
+		pvPlain = prvAllocate( 100, 0, testPLAIN_REGION, "a plain allocation uses the plain region again once it has room" );
+
+		prvFree( pvFillDMA, xFillDMA );
+		prvFree( pvFallbackDMA, 800 );
+		prvFree( pvFillFast, xFillFast );
+		prvFree( pvFallbackFast, 700 );
+		prvFree( pvFillPlain, xFillPlain );
+		prvFree( pvDMANonCacheable, 600 );
+		prvFree( pvNonCacheable, 500 );
+		prvFree( pvDMA, 400 );
+		prvFree( pvFast, 300 );
+		prvFree( pvPlainCaps, 200 );
+		prvFree( pvPlain, 100 );
+	}
+
+#endif /* configUSE_HEAP_REGION_CAPABILITIES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_HEAP_REGION_CAPABILITIES == 0 )
+
+	static size_t prvFreeBlocks( BaseType_t xRegion )
+	{
+	HeapStats_t xStats;
+
+		( void ) xPortGetHeapRegionStats( xRegion, &xStats );
+
+		return xStats.xNumberOfFreeBlocks;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvFirstFitTest( void )
+	{
+	void *pvFirst, *pvSecond, *pvThird, *pvReused;
+	void *pvFill0, *pvFallback1, *pvFill1, *pvFallback2, *pvFill2;
+	size_t xFill0, xFill1, xFill2;
+
+		/* First fit.  Blocks are taken from the start of the lowest address
+		region, and a freed block is reused before the free space that follows
+		it. */
+		pvFirst = prvAllocate( 100, 0, 0, "pvPortMalloc() takes memory from the lowest address region" );
+		pvSecond = prvAllocate( 200, 0, 0, "a second allocation takes memory from the same region" );
+		pvThird = prvAllocate( 300, 0, 0, "a third allocation takes memory from the same region" );
+		prvCheck( ( pvFirst < pvSecond ) && ( pvSecond < pvThird ), "blocks are taken from the lowest free address" );
+
+		prvFree( pvSecond, 200 );
+		prvCheck( prvFreeBlocks( 0 ) == 2, "freeing a block between two allocated blocks leaves two free blocks" );
+		pvReused = prvAllocate( 200, 0, 0, "an allocation the size of the freed block" );
+		prvCheck( pvReused == pvSecond, "the lowest address free block that fits is used" );
+		prvCheck( prvFreeBlocks( 0 ) == 1, "reusing the freed block leaves one free block" );
+
+		/* Falling through.  Once a region is full, allocations come from the
+		next region in address order. */
+		xFill0 = prvLargestFree( 0 );
+		pvFill0 = prvAllocate( xFill0, 0, 0, "filling region 0" );
+		prvCheck( xExpectedFree[ 0 ] == 0, "region 0 is full" );
+		pvFallback1 = prvAllocate( 700, 0, 1, "an allocation falls through to region 1" );
+
+		xFill1 = prvLargestFree( 1 );
+		pvFill1 = prvAllocate( xFill1, 0, 1, "filling region 1" );
+		pvFallback2 = prvAllocate( 800, 0, 2, "an allocation falls through to region 2" );
+
+		xFill2 = prvLargestFree( 2 );
+		pvFill2 = prvAllocate( xFill2, 0, 2, "filling region 2" );
+		( void ) prvAllocate( 100, 0, -1, "an allocation fails once every region is full" );
+
+		/* Freeing a block in region 0 makes it the first choice again. */
+		prvFree( pvFirst, 100 );
+		pvFirst = prvAllocate( 100, 0, 0, "an allocation uses region 0 again once it has room" );
+
+		/* Coalescing.  Region 0 is full, so the first block freed is its only
+		free block, and later blocks are only counted once if they are merged
+		with the free blocks next to them. */
+		prvFree( pvFirst, 100 );
+		prvCheck( prvFreeBlocks( 0 ) == 1, "a block freed in a full region is the only free block" );
+		prvFree( pvThird, 300 );
+		prvCheck( prvFreeBlocks( 0 ) == 2, "a block freed away from the other free block is not merged" );
+		prvFree( pvReused, 200 );
+		prvCheck( prvFreeBlocks( 0 ) == 1, "a freed block is merged with the free blocks on both sides" );
+		prvFree( pvFill0, xFill0 );
+		prvCheck( prvFreeBlocks( 0 ) == 1, "a freed block is merged with the free block below it" );
+
+		prvFree( pvFill2, xFill2 );
+		prvFree( pvFallback2, 800 );
+		prvCheck( prvFreeBlocks( 2 ) == 1, "a freed block is merged with the free block above it" );
+		prvFree( pvFallback1, 700 );
+		prvFree( pvFill1, xFill1 );
+	}
+
+#endif /* configUSE_HEAP_REGION_CAPABILITIES */
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+HeapStats_t xStats;
+BaseType_t xRegion;
+
+	vPortDefineHeapRegions( xHeapRegions );
+
+	for( xRegion = 0; xRegion < testREGIONS; xRegion++ )
+	{
+		( void ) xPortGetHeapRegionStats( xRegion, &xStats );
+		xInitialFree[ xRegion ] = xStats.xAvailableHeapSpaceInBytes;
+		xExpectedFree[ xRegion ] = xStats.xAvailableHeapSpaceInBytes;
+		prvCheck( ( xStats.xNumberOfFreeBlocks == 1 ) && ( xStats.xAvailableHeapSpaceInBytes < xHeapRegions[ xRegion ].xSizeInBytes ), "each region starts as one free block" );
+	}
+
+	prvCheck( xPortGetHeapRegionStats( testREGIONS, &xStats ) == pdFAIL, "stats for a region that does not exist fail" );
+
+	#if( configUSE_HEAP_REGION_CAPABILITIES == 1 )
+	{
+		prvCapabilitiesTest();
+	}
+	#else
+	{
+		prvFirstFitTest();
+	}
+	#endif
+
+	for( xRegion = 0; xRegion < testREGIONS; xRegion++ )
+	{
+		( void ) xPortGetHeapRegionStats( xRegion, &xStats );
+		printf( "region %ld: %lu of %lu bytes free, %lu allocations, %lu frees\n", ( long ) xRegion, ( unsigned long ) xStats.xAvailableHeapSpaceInBytes, ( unsigned long ) xInitialFree[ xRegion ], ( unsigned long ) xStats.xNumberOfSuccessfulAllocations, ( unsigned long ) xStats.xNumberOfSuccessfulFrees );
+		prvCheck( ( xStats.xAvailableHeapSpaceInBytes == xInitialFree[ xRegion ] ) && ( xStats.xNumberOfFreeBlocks == 1 ) && ( xStats.xNumberOfSuccessfulAllocations == xStats.xNumberOfSuccessfulFrees ), "each region is back to one free block" );
+		prvCheck( xStats.xMinimumEverFreeBytesRemaining == 0, "each region was filled" );
+	}
+
+	if( ulErrors == 0 )
+	{
+		printf( "PASS: %lu checks\n", ( unsigned long ) ulChecks );
+	}
+	else
+	{
+		printf( "FAIL: %lu of %lu checks\n", ( unsigned long ) ulErrors, ( unsigned long ) ulChecks );
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,423 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side benchmark that replays an allocation trace against one of the
+ * heap implementations in portable/MemMang, and reports the time taken by
+ * pvPortMalloc() and vPortFree() and the fragmentation of the heap.  Build one
+ * executable per heap implementation using the POSIX port, for example:
+ *
+ * cc -O2 -I<dir> -I../include -I../portable/GCC/Posix -o heap_replay_4 heap_replay.c ../portable/MemMang/heap_4.c
+ * cc -O2 -I<dir> -I../include -I../portable/GCC/Posix -o heap_replay_6 heap_replay.c ../portable/MemMang/heap_6.c
+ *
+ * where <dir> holds the FreeRTOSConfig.h used by the simulation, which sets the
+ * heap size.  The scheduler is never started, so this file provides the few
+ * kernel functions the heap implementations call.
+ *
+ * A trace is a text file with one operation per line:
+ *
+ * a <id> <size>  Allocate size bytes and remember the block as id.
+ * f <id>         Free the block remembered as id.
+ *
+ * Allocations that fail are counted, and freeing their id is ignored.  Run
+ * with -r <operations> [seed] instead of a file name to replay a random
+ * workload of mostly small, short lived blocks mixed with larger, longer lived
+ * blocks, which fragments a first fit heap over time.  Use -w <file> with -r
+ * to also write the random workload out as a trace.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* The number of operations between samples of the heap statistics. */
+#define replaySAMPLE_INTERVAL	1024UL
+
+/* Operation times are counted in a histogram of replayBUCKET_NS wide buckets.
+Longer times, which on a host are normally caused by the process being
+preempted, are counted in the last bucket. */
+#define replayBUCKET_NS			8U
+#define replayBUCKETS			8192U
+
+/* Blocks currently allocated, indexed by trace id. */
+static void **ppvBlocks = NULL;
+static size_t xBlockCapacity = 0;
+
+/* Results. */
+static unsigned long ulAllocations = 0, ulFailedAllocations = 0, ulFrees = 0;
+static uint64_t ullMallocTime = 0, ullFreeTime = 0;
+static unsigned long ulMallocHistogram[ replayBUCKETS ], ulFreeHistogram[ replayBUCKETS ];
+static double dWorstFragmentation = 0.0;
+
+/*-----------------------------------------------------------*/
+
+/* Stand ins for the kernel functions used by the heap implementations.  The
+scheduler is not running, so there is nothing to protect against. */
+void vTaskSuspendAll( void )
+{
+}
+
+BaseType_t xTaskResumeAll( void )
+{
+	return pdFALSE;
+}
+
+void vPortEnterCritical( void )
+{
+}
+
+void vPortExitCritical( void )
+{
+}
+
+#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+	void vApplicationMallocFailedHook( void )
+	{
+		/* Failures are counted by the caller. */
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+static uint64_t prvNow( void )
+{
+struct timespec xTime;
+
+	clock_gettime( CLOCK_MONOTONIC, &xTime );
+	return ( ( uint64_t ) xTime.tv_sec * 1000000000ULL ) + ( uint64_t ) xTime.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddToHistogram( unsigned long *pulHistogram, uint64_t ullTime )
+{
+uint64_t ullBucket = ullTime / replayBUCKET_NS;
+
+	if( ullBucket >= replayBUCKETS )
+	{
+		ullBucket = replayBUCKETS - 1U;
+	}
+
+	pulHistogram[ ullBucket ]++;
+}
+/*-----------------------------------------------------------*/
+
+/* Prints the mean, and the upper bound of the bucket holding each of the
+50th, 99th and 99.9th percentiles. */
+static void prvPrintTimes( const char *pcName, const unsigned long *pulHistogram, uint64_t ullTotalTime )
+{
+static const double dPercentiles[] = { 50.0, 99.0, 99.9 };
+unsigned long ulCount = 0, ulSeen;
+size_t x, xBucket;
+
+	for( xBucket = 0; xBucket < replayBUCKETS; xBucket++ )
+	{
+		ulCount += pulHistogram[ xBucket ];
+	}
+
+	printf( "%-6s ns mean %7.1f", pcName, ( ulCount != 0 ) ? ( double ) ullTotalTime / ( double ) ulCount : 0.0 );
+
+	for( x = 0; x < sizeof( dPercentiles ) / sizeof( dPercentiles[ 0 ] ); x++ )
+	{
+		ulSeen = 0;
+
+		for( xBucket = 0; xBucket < replayBUCKETS; xBucket++ )
+		{
+			ulSeen += pulHistogram[ xBucket ];
+
+			if( ( double ) ulSeen >= ( ( double ) ulCount * dPercentiles[ x ] ) / 100.0 )
+			{
+				break;
+			}
+		}
+
+		if( xBucket >= ( replayBUCKETS - 1U ) )
+		{
+			printf( ", p%g >%u", dPercentiles[ x ], ( replayBUCKETS - 1U ) * replayBUCKET_NS );
+		}
+		else
+		{
+			printf( ", p%g %u", dPercentiles[ x ], ( unsigned ) ( ( xBucket + 1U ) * replayBUCKET_NS ) );
+		}
+	}
+
+	printf( "\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSampleFragmentation( void )
+{
+HeapStats_t xStats;
+double dFragmentation;
+
+	vPortGetHeapStats( &xStats );
+
+	/* The proportion of the free space that cannot be used by a single
+	allocation. */
+	if( xStats.xAvailableHeapSpaceInBytes != 0 )
+	{
+		dFragmentation = 1.0 - ( ( double ) xStats.xSizeOfLargestFreeBlockInBytes / ( double ) xStats.xAvailableHeapSpaceInBytes );
+
+		if( dFragmentation > dWorstFragmentation )
+		{
+			dWorstFragmentation = dFragmentation;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvAllocate( size_t xId, size_t xSize )
+{
+uint64_t ullStart, ullTime;
+void *pv;
+
+	if( xId >= xBlockCapacity )
+	{
+		xBlockCapacity = ( xId + 1 ) * 2;
+		ppvBlocks = realloc( ppvBlocks, xBlockCapacity * sizeof( void * ) );
+
+		if( ppvBlocks == NULL )
+		{
+			fprintf( stderr, "out of memory\n" );
+			exit( EXIT_FAILURE );
+		}
+
+		memset( &( ppvBlocks[ xId ] ), 0, ( xBlockCapacity - xId ) * sizeof( void * ) );
+	}
+
+	if( ppvBlocks[ xId ] != NULL )
+	{
+		fprintf( stderr, "id %lu allocated twice\n", ( unsigned long ) xId );
+		exit( EXIT_FAILURE );
+	}
+
+	ullStart = prvNow();
+	pv = pvPortMalloc( xSize );
+	ullTime = prvNow() - ullStart;
+
+	ullMallocTime += ullTime;
+	prvAddToHistogram( ulMallocHistogram, ullTime );
+
+	if( pv != NULL )
+	{
+		/* Touch the memory so overlapping blocks corrupt the heap. */
+		memset( pv, 0xA5, xSize );
+		ppvBlocks[ xId ] = pv;
+		ulAllocations++;
+	}
+	else
+	{
+		ulFailedAllocations++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvFree( size_t xId )
+{
+uint64_t ullStart, ullTime;
+
+	if( ( xId < xBlockCapacity ) && ( ppvBlocks[ xId ] != NULL ) )
+	{
+		ullStart = prvNow();
+		vPortFree( ppvBlocks[ xId ] );
+		ullTime = prvNow() - ullStart;
+
+		ullFreeTime += ullTime;
+		prvAddToHistogram( ulFreeHistogram, ullTime );
+
+		ppvBlocks[ xId ] = NULL;
+		ulFrees++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvReplayFile( const char *pcFileName )
+{
+FILE *pxFile;
+char cLine[ 128 ], cOperation;
+unsigned long ulId, ulSize, ulOperations = 0;
+int iFields;
+
+	pxFile = fopen( pcFileName, "r" );
+
+	if( pxFile == NULL )
+	{
+		perror( pcFileName );
+		exit( EXIT_FAILURE );
+	}
+
+	while( fgets( cLine, sizeof( cLine ), pxFile ) != NULL )
+	{
+		iFields = sscanf( cLine, " %c %lu %lu", &cOperation, &ulId, &ulSize );
+
+		if( ( cOperation == 'a' ) && ( iFields == 3 ) )
+		{
+			prvAllocate( ( size_t ) ulId, ( size_t ) ulSize );
+		}
+		else if( ( cOperation == 'f' ) && ( iFields >= 2 ) )
+		{
+			prvFree( ( size_t ) ulId );
+		}
+		else
+		{
+			/* Blank lines and comments are skipped. */
+			continue;
+		}
+
+		if( ( ++ulOperations % replaySAMPLE_INTERVAL ) == 0 )
+		{
+			prvSampleFragmentation();
+		}
+	}
+
+	fclose( pxFile );
+}
+/*-----------------------------------------------------------*/
+
+static void prvReplayRandom( unsigned long ulOperations, unsigned int uSeed, FILE *pxTraceFile )
+{
+unsigned long ul, ulNextId = 0, ulLive = 0;
+unsigned long *pulLive;
+size_t xSize, xIndex;
+
+	/* Ids of the blocks that are currently allocated. */
+	pulLive = malloc( ulOperations * sizeof( unsigned long ) );
+
+	if( pulLive == NULL )
+	{
+		fprintf( stderr, "out of memory\n" );
+		exit( EXIT_FAILURE );
+	}
+
+	srand( uSeed );
+
+	for( ul = 0; ul < ulOperations; ul++ )
+	{
+		/* Allocate more often than free until a quarter of the heap is in use,
+		then keep the amount in use about level. */
+		if( ( ulLive == 0 ) || ( ( rand() % 100 ) < ( ( xPortGetFreeHeapSize() > ( ( configTOTAL_HEAP_SIZE * 3 ) / 4 ) ) ? 70 : 50 ) ) )
+		{
+			/* Mostly small blocks, with an occasional large one. */
+			if( ( rand() % 16 ) == 0 )
+			{
+				xSize = 512 + ( size_t ) ( rand() % 4096 );
+			}
+			else
+			{
+				xSize = 8 + ( size_t ) ( rand() % 200 );
+			}
+
+			if( pxTraceFile != NULL )
+			{
+				fprintf( pxTraceFile, "a %lu %lu\n", ulNextId, ( unsigned long ) xSize );
+			}
+
+			prvAllocate( ulNextId, xSize );
+			pulLive[ ulLive ] = ulNextId;
+			ulLive++;
+			ulNextId++;
+		}
+		else
+		{
+			/* Free a random block, so lifetimes vary. */
+			xIndex = ( size_t ) rand() % ulLive;
+
+			if( pxTraceFile != NULL )
+			{
+				fprintf( pxTraceFile, "f %lu\n", pulLive[ xIndex ] );
+			}
+
+			prvFree( pulLive[ xIndex ] );
+			ulLive--;
+			pulLive[ xIndex ] = pulLive[ ulLive ];
+		}
+
+		if( ( ( ul + 1 ) % replaySAMPLE_INTERVAL ) == 0 )
+		{
+			prvSampleFragmentation();
+		}
+	}
+
+	free( pulLive );
+}
+/*-----------------------------------------------------------*/
+
+int main( int argc, char *argv[] )
+{
+HeapStats_t xStats;
+FILE *pxTraceFile = NULL;
+unsigned long ulOperations;
+
+	if( ( argc >= 3 ) && ( strcmp( argv[ 1 ], "-r" ) == 0 ) )
+	{
+		ulOperations = strtoul( argv[ 2 ], NULL, 0 );
+
+		if( ( argc >= 5 ) && ( strcmp( argv[ argc - 2 ], "-w" ) == 0 ) )
+		{
+			pxTraceFile = fopen( argv[ argc - 1 ], "w" );
+
+			if( pxTraceFile == NULL )
+			{
+				perror( argv[ argc - 1 ] );
+				return EXIT_FAILURE;
+			}
+
+			argc -= 2;
+		}
+
+		prvReplayRandom( ulOperations, ( argc >= 4 ) ? ( unsigned int ) strtoul( argv[ 3 ], NULL, 0 ) : 1U, pxTraceFile );
+
+		if( pxTraceFile != NULL )
+		{
+			fclose( pxTraceFile );
+		}
+	}
+	else if( argc == 2 )
+	{
+		prvReplayFile( argv[ 1 ] );
+	}
+	else
+	{
+		fprintf( stderr, "usage: %s trace.txt\n       %s -r operations [seed] [-w trace.txt]\n", argv[ 0 ], argv[ 0 ] );
+		return EXIT_FAILURE;
+	}
+
+	prvSampleFragmentation();
+	vPortGetHeapStats( &xStats );
+
+	printf( "allocations          %lu (%lu failed)\n", ulAllocations, ulFailedAllocations );
+	printf( "frees                %lu\n", ulFrees );
+	prvPrintTimes( "malloc", ulMallocHistogram, ullMallocTime );
+	prvPrintTimes( "free", ulFreeHistogram, ullFreeTime );
+	printf( "free bytes           %lu (minimum ever %lu)\n", ( unsigned long ) xStats.xAvailableHeapSpaceInBytes, ( unsigned long ) xStats.xMinimumEverFreeBytesRemaining );
+	printf( "free blocks          %lu (largest %lu, smallest %lu)\n", ( unsigned long ) xStats.xNumberOfFreeBlocks, ( unsigned long ) xStats.xSizeOfLargestFreeBlockInBytes, ( unsigned long ) xStats.xSizeOfSmallestFreeBlockInBytes );
+	printf( "fragmentation        %.1f%% now, %.1f%% worst\n", ( xStats.xAvailableHeapSpaceInBytes != 0 ) ? 100.0 * ( 1.0 - ( ( double ) xStats.xSizeOfLargestFreeBlockInBytes / ( double ) xStats.xAvailableHeapSpaceInBytes ) ) : 0.0, 100.0 * dWorstFragmentation );
+
+	return EXIT_SUCCESS;
+}
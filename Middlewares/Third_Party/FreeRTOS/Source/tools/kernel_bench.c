@@ -0,0 +1,395 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side benchmark suite for the core kernel paths, intended to be run on a
+ * build server to catch performance regressions.  For each number of
+ * background tasks in benchTASK_COUNTS it times:
+ *
+ * + xQueueGenericSend() to a queue that has space, and xQueueReceive() from a
+ *   queue that holds an item, neither of which blocks.
+ * + xQueueGenericSend() to a queue a higher priority task is blocked on, up to
+ *   that task running, which includes vTaskSwitchContext() and the switch to
+ *   the thread of the task.
+ * + xTaskIncrementTick(), called with interrupts masked as the tick interrupt
+ *   does, while the background tasks delay for between 1 and 32 ticks.
+ * + vTaskSwitchContext(), called with interrupts masked by the highest
+ *   priority ready task, so it selects the same task again.
+ * + xStreamBufferSend() of 16 bytes to a stream buffer that has space.
+ *
+ * The background tasks all delay in a loop, so they fill the delayed task
+ * lists and the ready list of their priority.  Each result is printed as the
+ * operations per second at the median time, the 50th and 99th percentile and
+ * maximum in cycles of ullPortGetCycleCounter(), and a histogram of the
+ * samples in power of two buckets.  The test passes if every operation
+ * returned the expected result.
+ *
+ * Build with the POSIX port and any heap implementation, using a
+ * FreeRTOSConfig.h that sets configUSE_DYNAMIC_TICK to 0,
+ * INCLUDE_xTaskGetCurrentTaskHandle and INCLUDE_vTaskPrioritySet to 1, and
+ * configTOTAL_HEAP_SIZE large enough for the stacks of the largest task count
+ * plus three.
+ * The timer task, if used, must have a priority below configMAX_PRIORITIES - 2.
+ * Other task counts can be given on the command line, for example with
+ * -DbenchTASK_COUNTS=0,100,500.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "stream_buffer.h"
+
+#if( configUSE_DYNAMIC_TICK != 0 )
+	#error This benchmark calls xTaskIncrementTick() directly, so needs configUSE_DYNAMIC_TICK set to 0.
+#endif
+
+#ifndef benchTASK_COUNTS
+	#define benchTASK_COUNTS		0, 16, 64
+#endif
+
+#define benchSAMPLES			5000UL
+#define benchDELAY_PERIODS		32
+#define benchSTREAM_BYTES		16
+#define benchHISTOGRAM_BUCKETS	24
+
+/* The stack size, which must be at least PTHREAD_STACK_MIN bytes. */
+#define benchSTACK_SIZE			( ( configSTACK_DEPTH_TYPE ) ( 32768 / sizeof( StackType_t ) ) )
+
+/* The benchmark task runs below the receiver task, which must preempt it. */
+#define benchBENCH_PRIORITY		( configMAX_PRIORITIES - 2 )
+#define benchRECEIVER_PRIORITY	( configMAX_PRIORITIES - 1 )
+#define benchBACKGROUND_PRIORITY	( tskIDLE_PRIORITY + 1 )
+
+static const UBaseType_t uxTaskCounts[] = { benchTASK_COUNTS };
+
+#define benchTASK_COUNT_STEPS	( sizeof( uxTaskCounts ) / sizeof( uxTaskCounts[ 0 ] ) )
+
+static QueueHandle_t xQueue = NULL, xWakeQueue = NULL;
+static StreamBufferHandle_t xStreamBuffer = NULL;
+static volatile uint64_t ullSendTime = 0, ullWakeCycles = 0;
+static volatile uint32_t ulReceived = 0, ulErrors = 0;
+static uint64_t ullCycles[ benchSAMPLES ];
+static uint64_t ullCyclesPerSecond = 0;
+
+/*-----------------------------------------------------------*/
+
+static void prvBackgroundTask( void *pvParameters )
+{
+TickType_t xTicksToDelay = ( TickType_t ) ( 1 + ( ( UBaseType_t ) pvParameters % benchDELAY_PERIODS ) );
+
+	for( ;; )
+	{
+		vTaskDelay( xTicksToDelay );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvReceiverTask( void *pvParameters )
+{
+uint32_t ulItem;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		if( xQueueReceive( xWakeQueue, &ulItem, portMAX_DELAY ) == pdPASS )
+		{
+			ullWakeCycles = ullPortGetCycleCounter() - ullSendTime;
+
+			if( ulItem != ulReceived )
+			{
+				ulErrors++;
+			}
+
+			ulReceived++;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareCycles( const void *pv1, const void *pv2 )
+{
+uint64_t ull1 = *( const uint64_t * ) pv1, ull2 = *( const uint64_t * ) pv2;
+
+	return ( ull1 > ull2 ) - ( ull1 < ull2 );
+}
+/*-----------------------------------------------------------*/
+
+/* Sorts the samples in ullCycles[], then prints the result line and the
+histogram for one operation. */
+static void prvReport( const char *pcOperation, UBaseType_t uxTasks )
+{
+uint32_t ulBuckets[ benchHISTOGRAM_BUCKETS ] = { 0 };
+uint32_t ulSample, ulBucket;
+uint64_t ullMedian;
+
+	qsort( ullCycles, benchSAMPLES, sizeof( ullCycles[ 0 ] ), prvCompareCycles );
+	ullMedian = ullCycles[ benchSAMPLES / 2 ];
+
+	for( ulSample = 0; ulSample < benchSAMPLES; ulSample++ )
+	{
+		/* Bucket n holds the samples of 2^n to 2^(n+1) - 1 cycles, and the
+		last bucket everything longer. */
+		for( ulBucket = 0; ( ulBucket < ( benchHISTOGRAM_BUCKETS - 1 ) ) && ( ( ullCycles[ ulSample ] >> ( ulBucket + 1 ) ) != 0 ); ulBucket++ )
+		{
+		}
+
+		ulBuckets[ ulBucket ]++;
+	}
+
+	printf( "%-24s %4lu tasks: %10lu ops/s, p50 %lu, p99 %lu, max %lu cycles\n", pcOperation, ( unsigned long ) uxTasks, ( unsigned long ) ( ullCyclesPerSecond / ( ( ullMedian != 0 ) ? ullMedian : 1 ) ), ( unsigned long ) ullMedian, ( unsigned long ) ullCycles[ ( benchSAMPLES * 99 ) / 100 ], ( unsigned long ) ullCycles[ benchSAMPLES - 1 ] );
+	printf( "   " );
+
+	for( ulBucket = 0; ulBucket < benchHISTOGRAM_BUCKETS; ulBucket++ )
+	{
+		if( ulBuckets[ ulBucket ] != 0 )
+		{
+			printf( " %lu+:%lu", 1UL << ulBucket, ( unsigned long ) ulBuckets[ ulBucket ] );
+		}
+	}
+
+	printf( "\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimeOperations( UBaseType_t uxTasks )
+{
+uint64_t ullStart;
+uint32_t ulSample, ulItem = 0, ulFirstReceived;
+uint8_t ucData[ benchSTREAM_BYTES ] = { 0 };
+TaskHandle_t xThisTask = xTaskGetCurrentTaskHandle();
+
+	/* xQueueGenericSend() to a queue with space. */
+	for( ulSample = 0; ulSample < benchSAMPLES; ulSample++ )
+	{
+		ullStart = ullPortGetCycleCounter();
+
+		if( xQueueSend( xQueue, &ulItem, 0 ) != pdPASS )
+		{
+			ulErrors++;
+		}
+
+		ullCycles[ ulSample ] = ullPortGetCycleCounter() - ullStart;
+
+		if( xQueueReceive( xQueue, &ulItem, 0 ) != pdPASS )
+		{
+			ulErrors++;
+		}
+	}
+
+	prvReport( "xQueueGenericSend", uxTasks );
+
+	/* xQueueReceive() from a queue holding an item. */
+	for( ulSample = 0; ulSample < benchSAMPLES; ulSample++ )
+	{
+		if( xQueueSend( xQueue, &ulItem, 0 ) != pdPASS )
+		{
+			ulErrors++;
+		}
+
+		ullStart = ullPortGetCycleCounter();
+
+		if( xQueueReceive( xQueue, &ulItem, 0 ) != pdPASS )
+		{
+			ulErrors++;
+		}
+
+		ullCycles[ ulSample ] = ullPortGetCycleCounter() - ullStart;
+	}
+
+	prvReport( "xQueueReceive", uxTasks );
+
+	/* xQueueGenericSend() waking the higher priority receiver task, which
+	runs before the send returns. */
+	ulFirstReceived = ulReceived;
+
+	for( ulSample = 0; ulSample < benchSAMPLES; ulSample++ )
+	{
+		ulItem = ulReceived;
+		ullSendTime = ullPortGetCycleCounter();
+
+		if( xQueueSend( xWakeQueue, &ulItem, 0 ) != pdPASS )
+		{
+			ulErrors++;
+		}
+
+		ullCycles[ ulSample ] = ullWakeCycles;
+	}
+
+	if( ( ulReceived - ulFirstReceived ) != benchSAMPLES )
+	{
+		ulErrors++;
+	}
+
+	prvReport( "xQueueGenericSend+switch", uxTasks );
+
+	/* xTaskIncrementTick().  Dropping to the priority of the background
+	tasks and yielding after each sample lets the tasks that were unblocked run
+	and delay again, without waiting for a tick. */
+	for( ulSample = 0; ulSample < benchSAMPLES; ulSample++ )
+	{
+		portDISABLE_INTERRUPTS();
+		{
+			ullStart = ullPortGetCycleCounter();
+			( void ) xTaskIncrementTick();
+			ullCycles[ ulSample ] = ullPortGetCycleCounter() - ullStart;
+		}
+		portENABLE_INTERRUPTS();
+
+		vTaskPrioritySet( NULL, benchBACKGROUND_PRIORITY );
+		taskYIELD();
+		vTaskPrioritySet( NULL, benchBENCH_PRIORITY );
+	}
+
+	prvReport( "xTaskIncrementTick", uxTasks );
+
+	/* vTaskSwitchContext().  This is the highest priority ready task, so it
+	is selected again and no switch to another thread is needed. */
+	for( ulSample = 0; ulSample < benchSAMPLES; ulSample++ )
+	{
+		portDISABLE_INTERRUPTS();
+		{
+			ullStart = ullPortGetCycleCounter();
+			vTaskSwitchContext();
+			ullCycles[ ulSample ] = ullPortGetCycleCounter() - ullStart;
+
+			if( xTaskGetCurrentTaskHandle() != xThisTask )
+			{
+				ulErrors++;
+			}
+		}
+		portENABLE_INTERRUPTS();
+	}
+
+	prvReport( "vTaskSwitchContext", uxTasks );
+
+	/* xStreamBufferSend() to a stream buffer with space. */
+	for( ulSample = 0; ulSample < benchSAMPLES; ulSample++ )
+	{
+		ullStart = ullPortGetCycleCounter();
+
+		if( xStreamBufferSend( xStreamBuffer, ucData, sizeof( ucData ), 0 ) != sizeof( ucData ) )
+		{
+			ulErrors++;
+		}
+
+		ullCycles[ ulSample ] = ullPortGetCycleCounter() - ullStart;
+
+		if( xStreamBufferReceive( xStreamBuffer, ucData, sizeof( ucData ), 0 ) != sizeof( ucData ) )
+		{
+			ulErrors++;
+		}
+	}
+
+	prvReport( "xStreamBufferSend", uxTasks );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void *pvParameters )
+{
+UBaseType_t uxStep, uxCreated = 0;
+
+	( void ) pvParameters;
+
+	xTaskCreate( prvReceiverTask, "Receiver", benchSTACK_SIZE, NULL, benchRECEIVER_PRIORITY, NULL );
+
+	for( uxStep = 0; uxStep < benchTASK_COUNT_STEPS; uxStep++ )
+	{
+		while( uxCreated < uxTaskCounts[ uxStep ] )
+		{
+			if( xTaskCreate( prvBackgroundTask, "Bg", benchSTACK_SIZE, ( void * ) uxCreated, benchBACKGROUND_PRIORITY, NULL ) != pdPASS )
+			{
+				ulErrors++;
+				break;
+			}
+
+			uxCreated++;
+		}
+
+		/* Let the new tasks start delaying. */
+		vTaskDelay( benchDELAY_PERIODS );
+		prvTimeOperations( uxCreated );
+	}
+
+	taskENTER_CRITICAL();
+	{
+		if( ulErrors == 0 )
+		{
+			printf( "PASS\n" );
+		}
+		else
+		{
+			printf( "FAIL: %lu errors\n", ( unsigned long ) ulErrors );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+/* Returns the rate of ullPortGetCycleCounter(), measured against the host's
+monotonic clock over 100ms. */
+static uint64_t prvMeasureCyclesPerSecond( void )
+{
+struct timespec xStart, xNow;
+uint64_t ullStart, ullElapsedNs;
+
+	clock_gettime( CLOCK_MONOTONIC, &xStart );
+	ullStart = ullPortGetCycleCounter();
+
+	do
+	{
+		clock_gettime( CLOCK_MONOTONIC, &xNow );
+		ullElapsedNs = ( ( uint64_t ) ( xNow.tv_sec - xStart.tv_sec ) * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec - ( uint64_t ) xStart.tv_nsec;
+	} while( ullElapsedNs < 100000000ULL );
+
+	return ( ( ullPortGetCycleCounter() - ullStart ) * 1000000000ULL ) / ullElapsedNs;
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	xQueue = xQueueCreate( 1, sizeof( uint32_t ) );
+	xWakeQueue = xQueueCreate( 1, sizeof( uint32_t ) );
+	xStreamBuffer = xStreamBufferCreate( 4 * benchSTREAM_BYTES, 1 );
+	configASSERT( xQueue );
+	configASSERT( xWakeQueue );
+	configASSERT( xStreamBuffer );
+
+	ullCyclesPerSecond = prvMeasureCyclesPerSecond();
+	printf( "%lu cycles per second, %lu priorities\n", ( unsigned long ) ullCyclesPerSecond, ( unsigned long ) configMAX_PRIORITIES );
+
+	xTaskCreate( prvBenchmarkTask, "Bench", benchSTACK_SIZE, NULL, benchBENCH_PRIORITY, NULL );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,303 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side benchmark that compares indexed task notifications with binary
+ * semaphores, which are taken using xQueueSemaphoreTake().  Notification
+ * indexes 1 and 2 are used, as index 0 is left for stream buffers and the
+ * CMSIS-RTOS signals.  The median number of cycles, measured using the cycle
+ * counter of the POSIX port, is reported for:
+ *
+ * + A task giving to itself, then taking without blocking, with the give and
+ *   the take timed separately.  No task is woken, so this is the cost of the
+ *   notification or semaphore path alone.
+ * + A simulated interrupt, a task that masks interrupts as an interrupt service
+ *   routine would run, giving to a higher priority task that is blocked
+ *   waiting, timed at the give side.  This includes removing the waiting task
+ *   from the event and delayed lists, but not the context switch to it, which
+ *   happens after the time is taken.
+ * + A round trip in which a lower priority task wakes a higher priority task,
+ *   then blocks until the higher priority task wakes it back.  On the POSIX
+ *   port each round trip includes two host thread switches, which take far
+ *   longer than the kernel code, so this shows the two paths add the same
+ *   cost to a context switch rather than the difference between them.
+ *
+ * Build with the POSIX port, any heap implementation, and a FreeRTOSConfig.h
+ * that sets configTASK_NOTIFICATION_ARRAY_ENTRIES to at least 3.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+#if( configTASK_NOTIFICATION_ARRAY_ENTRIES < 3 )
+	#error This benchmark uses notification indexes 1 and 2.
+#endif
+
+#define benchSAMPLES			100000UL
+
+/* The notification indexes used to signal each way. */
+#define benchPING_INDEX			1
+#define benchPONG_INDEX			2
+
+/* The stack size, which must be at least PTHREAD_STACK_MIN bytes. */
+#define benchSTACK_SIZE			( ( configSTACK_DEPTH_TYPE ) ( 32768 / sizeof( StackType_t ) ) )
+
+static TaskHandle_t xPingTask = NULL, xPongTask = NULL;
+static SemaphoreHandle_t xPingSemaphore = NULL, xPongSemaphore = NULL;
+
+/* Set when the pong task should use the semaphores instead of notifications. */
+static volatile BaseType_t xUseSemaphores = pdFALSE;
+
+/* Set when the pong task should only take, as in the simulated interrupt
+phase, instead of giving back. */
+static volatile BaseType_t xTakeOnly = pdFALSE;
+
+static uint64_t ullGiveCycles[ benchSAMPLES ], ullTakeCycles[ benchSAMPLES ];
+
+/*-----------------------------------------------------------*/
+
+static void prvPongTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		if( xUseSemaphores == pdFALSE )
+		{
+			( void ) ulTaskNotifyTakeIndexed( benchPING_INDEX, pdTRUE, portMAX_DELAY );
+
+			if( xTakeOnly == pdFALSE )
+			{
+				( void ) xTaskNotifyGiveIndexed( xPingTask, benchPONG_INDEX );
+			}
+		}
+		else
+		{
+			( void ) xSemaphoreTake( xPingSemaphore, portMAX_DELAY );
+
+			if( xTakeOnly == pdFALSE )
+			{
+				( void ) xSemaphoreGive( xPongSemaphore );
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareCycles( const void *pv1, const void *pv2 )
+{
+uint64_t ull1 = *( const uint64_t * ) pv1, ull2 = *( const uint64_t * ) pv2;
+
+	return ( ull1 > ull2 ) - ( ull1 < ull2 );
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvMedian( uint64_t *pullCycles )
+{
+	/* The median is reported as the host occasionally preempts the thread
+	running the task for far longer than the operation takes. */
+	qsort( pullCycles, benchSAMPLES, sizeof( pullCycles[ 0 ] ), prvCompareCycles );
+
+	return pullCycles[ benchSAMPLES / 2 ];
+}
+/*-----------------------------------------------------------*/
+
+static void prvSameTask( BaseType_t xSemaphores )
+{
+uint64_t ullStart;
+uint32_t ul;
+BaseType_t xTaken;
+
+	for( ul = 0; ul < benchSAMPLES; ul++ )
+	{
+		if( xSemaphores == pdFALSE )
+		{
+			ullStart = ullPortGetCycleCounter();
+			( void ) xTaskNotifyGiveIndexed( xPingTask, benchPING_INDEX );
+			ullGiveCycles[ ul ] = ullPortGetCycleCounter() - ullStart;
+
+			ullStart = ullPortGetCycleCounter();
+			xTaken = ( BaseType_t ) ulTaskNotifyTakeIndexed( benchPING_INDEX, pdTRUE, 0 );
+			ullTakeCycles[ ul ] = ullPortGetCycleCounter() - ullStart;
+		}
+		else
+		{
+			ullStart = ullPortGetCycleCounter();
+			( void ) xSemaphoreGive( xPingSemaphore );
+			ullGiveCycles[ ul ] = ullPortGetCycleCounter() - ullStart;
+
+			ullStart = ullPortGetCycleCounter();
+			xTaken = xSemaphoreTake( xPingSemaphore, 0 );
+			ullTakeCycles[ ul ] = ullPortGetCycleCounter() - ullStart;
+		}
+
+		configASSERT( xTaken == 1 );
+	}
+
+	printf( "%-14s same task:          give %4lu cycles, take %4lu cycles\n",
+			( xSemaphores == pdFALSE ) ? "notifications" : "semaphores",
+			( unsigned long ) prvMedian( ullGiveCycles ),
+			( unsigned long ) prvMedian( ullTakeCycles ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvFromISR( BaseType_t xSemaphores )
+{
+uint64_t ullStart;
+uint32_t ul;
+BaseType_t xHigherPriorityTaskWoken;
+
+	/* The pong task has the higher priority, so it is blocked on its
+	notification or semaphore each time this task runs. */
+	for( ul = 0; ul < benchSAMPLES; ul++ )
+	{
+		xHigherPriorityTaskWoken = pdFALSE;
+
+		portDISABLE_INTERRUPTS();
+		{
+			if( xSemaphores == pdFALSE )
+			{
+				ullStart = ullPortGetCycleCounter();
+				vTaskNotifyGiveIndexedFromISR( xPongTask, benchPING_INDEX, &xHigherPriorityTaskWoken );
+				ullGiveCycles[ ul ] = ullPortGetCycleCounter() - ullStart;
+			}
+			else
+			{
+				ullStart = ullPortGetCycleCounter();
+				( void ) xSemaphoreGiveFromISR( xPingSemaphore, &xHigherPriorityTaskWoken );
+				ullGiveCycles[ ul ] = ullPortGetCycleCounter() - ullStart;
+			}
+		}
+		portENABLE_INTERRUPTS();
+
+		configASSERT( xHigherPriorityTaskWoken != pdFALSE );
+		portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+	}
+
+	printf( "%-14s from ISR, waking:   give %4lu cycles\n",
+			( xSemaphores == pdFALSE ) ? "notifications" : "semaphores",
+			( unsigned long ) prvMedian( ullGiveCycles ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRoundTrip( BaseType_t xSemaphores )
+{
+uint64_t ullStart;
+uint32_t ul;
+
+	for( ul = 0; ul < benchSAMPLES; ul++ )
+	{
+		ullStart = ullPortGetCycleCounter();
+
+		if( xSemaphores == pdFALSE )
+		{
+			( void ) xTaskNotifyGiveIndexed( xPongTask, benchPING_INDEX );
+			( void ) ulTaskNotifyTakeIndexed( benchPONG_INDEX, pdTRUE, portMAX_DELAY );
+		}
+		else
+		{
+			( void ) xSemaphoreGive( xPingSemaphore );
+			( void ) xSemaphoreTake( xPongSemaphore, portMAX_DELAY );
+		}
+
+		ullGiveCycles[ ul ] = ullPortGetCycleCounter() - ullStart;
+	}
+
+	printf( "%-14s round trip:         %lu cycles\n",
+			( xSemaphores == pdFALSE ) ? "notifications" : "semaphores",
+			( unsigned long ) prvMedian( ullGiveCycles ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSetPongMode( BaseType_t xSemaphores, BaseType_t xNewTakeOnly )
+{
+BaseType_t xWasUsingSemaphores = xUseSemaphores;
+
+	/* The pong task is blocked, and only checks the flags again once it is
+	woken, so wake it once with nothing to give back.  It has the higher
+	priority, so it runs and blocks again in the new mode before the give
+	returns. */
+	xTakeOnly = pdTRUE;
+	xUseSemaphores = xSemaphores;
+
+	if( xWasUsingSemaphores == pdFALSE )
+	{
+		( void ) xTaskNotifyGiveIndexed( xPongTask, benchPING_INDEX );
+	}
+	else
+	{
+		( void ) xSemaphoreGive( xPingSemaphore );
+	}
+
+	xTakeOnly = xNewTakeOnly;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPingTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	/* The pong task is blocked on its notification throughout, and neither
+	of these gives to it. */
+	prvSameTask( pdFALSE );
+	prvSameTask( pdTRUE );
+
+	xTakeOnly = pdTRUE;
+	prvFromISR( pdFALSE );
+	prvSetPongMode( pdTRUE, pdTRUE );
+	prvFromISR( pdTRUE );
+
+	prvSetPongMode( pdFALSE, pdFALSE );
+	prvRoundTrip( pdFALSE );
+	prvSetPongMode( pdTRUE, pdFALSE );
+	prvRoundTrip( pdTRUE );
+
+	/* Nothing should be left pending on the index that was not used. */
+	configASSERT( ulTaskNotifyValueClearIndexed( NULL, 0, 0 ) == 0 );
+	configASSERT( xTaskNotifyStateClearIndexed( NULL, 0 ) == pdFAIL );
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	xPingSemaphore = xSemaphoreCreateBinary();
+	xPongSemaphore = xSemaphoreCreateBinary();
+	configASSERT( xPingSemaphore );
+	configASSERT( xPongSemaphore );
+
+	xTaskCreate( prvPingTask, "Ping", benchSTACK_SIZE, NULL, tskIDLE_PRIORITY + 1, &xPingTask );
+	xTaskCreate( prvPongTask, "Pong", benchSTACK_SIZE, NULL, tskIDLE_PRIORITY + 2, &xPongTask );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
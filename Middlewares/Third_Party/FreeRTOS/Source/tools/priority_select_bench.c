@@ -0,0 +1,202 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side benchmark for the selection of the highest priority Ready state
+ * task.  The benchmark task raises itself to the highest priority then lowers
+ * itself back to priority one, which yields, and the median number of cycles
+ * taken to lower the priority is reported.  Lowering the priority leaves the
+ * generic task selection walking down every empty ready list from the highest
+ * priority, whereas the priority bitmap finds priority one directly.  It then
+ * checks that tasks spread over the range of priorities are always run highest
+ * priority first, including priorities either side of each 32 priority group.
+ *
+ * Build with the POSIX port and any heap implementation, using a
+ * FreeRTOSConfig.h that sets configMAX_PRIORITIES to 256 (or any value of at
+ * least 70), configUSE_PORT_OPTIMISED_TASK_SELECTION to 0, and
+ * configUSE_PRIORITY_BITMAP_TASK_SELECTION to 0 and then to 1, and compare the
+ * results.  The timer task, if used, must have a priority below
+ * configMAX_PRIORITIES - 1.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define benchSAMPLES			2000UL
+#define benchROUNDS				100UL
+
+/* The stack size, which must be at least PTHREAD_STACK_MIN bytes. */
+#define benchSTACK_SIZE			( ( configSTACK_DEPTH_TYPE ) ( 32768 / sizeof( StackType_t ) ) )
+
+/* Priorities of the tasks used to check the order tasks are selected in, all
+of which must be below configMAX_PRIORITIES - 1. */
+static const UBaseType_t uxPriorities[] =
+{
+	1, 2, 30, 31, 32, 33, 63, 64, 65, configMAX_PRIORITIES - 3, configMAX_PRIORITIES - 2
+};
+
+#if( configMAX_PRIORITIES < 70 )
+	#error configMAX_PRIORITIES must be at least 70 for this benchmark
+#endif
+
+#define benchORDER_TASKS		( sizeof( uxPriorities ) / sizeof( uxPriorities[ 0 ] ) )
+
+static TaskHandle_t xOrderTasks[ benchORDER_TASKS ];
+static UBaseType_t uxRunOrder[ benchORDER_TASKS ];
+static volatile UBaseType_t uxRuns = 0;
+static uint64_t ullCycles[ benchSAMPLES ];
+
+/*-----------------------------------------------------------*/
+
+static void prvOrderTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		/* Record the priority this task ran at, then wait to be resumed
+		again. */
+		if( uxRuns < benchORDER_TASKS )
+		{
+			uxRunOrder[ uxRuns ] = uxTaskPriorityGet( NULL );
+		}
+
+		uxRuns++;
+		vTaskSuspend( NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareCycles( const void *pv1, const void *pv2 )
+{
+uint64_t ull1 = *( const uint64_t * ) pv1, ull2 = *( const uint64_t * ) pv2;
+
+	return ( ull1 > ull2 ) - ( ull1 < ull2 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void *pvParameters )
+{
+uint64_t ullStart;
+uint32_t ulSample, ulRound, ulErrors = 0, ulSeed = 1;
+UBaseType_t uxTask, uxOther;
+TaskHandle_t xSwap;
+
+	( void ) pvParameters;
+
+	/* Phase one - time lowering the priority from the top of the range, which
+	selects this task again after the search for the highest priority ready
+	list. */
+	for( ulSample = 0; ulSample < benchSAMPLES; ulSample++ )
+	{
+		vTaskPrioritySet( NULL, configMAX_PRIORITIES - 1 );
+		ullStart = ullPortGetCycleCounter();
+		vTaskPrioritySet( NULL, tskIDLE_PRIORITY + 1 );
+		ullCycles[ ulSample ] = ullPortGetCycleCounter() - ullStart;
+	}
+
+	/* The median is reported as the host occasionally interrupts the
+	measurement for far longer than it takes. */
+	qsort( ullCycles, benchSAMPLES, sizeof( ullCycles[ 0 ] ), prvCompareCycles );
+	printf( "median %lu cycles to lower the priority from %lu to %lu\n", ( unsigned long ) ullCycles[ benchSAMPLES / 2 ], ( unsigned long ) ( configMAX_PRIORITIES - 1 ), ( unsigned long ) ( tskIDLE_PRIORITY + 1 ) );
+
+	/* Phase two - resume the order tasks in a shuffled order while this task
+	has the highest priority, then block so they run, which they must do in
+	descending priority order. */
+	vTaskPrioritySet( NULL, configMAX_PRIORITIES - 1 );
+
+	for( uxTask = 0; uxTask < benchORDER_TASKS; uxTask++ )
+	{
+		xTaskCreate( prvOrderTask, "Order", benchSTACK_SIZE, NULL, uxPriorities[ uxTask ], &( xOrderTasks[ uxTask ] ) );
+	}
+
+	/* Let the order tasks run for the first time and suspend themselves. */
+	vTaskDelay( 1 );
+
+	for( ulRound = 0; ulRound < benchROUNDS; ulRound++ )
+	{
+		for( uxTask = benchORDER_TASKS - 1; uxTask > 0; uxTask-- )
+		{
+			ulSeed = ( ulSeed * 1103515245UL ) + 12345UL;
+			uxOther = ( UBaseType_t ) ( ( ulSeed >> 16 ) % ( uxTask + 1 ) );
+			xSwap = xOrderTasks[ uxTask ];
+			xOrderTasks[ uxTask ] = xOrderTasks[ uxOther ];
+			xOrderTasks[ uxOther ] = xSwap;
+		}
+
+		uxRuns = 0;
+
+		for( uxTask = 0; uxTask < benchORDER_TASKS; uxTask++ )
+		{
+			vTaskResume( xOrderTasks[ uxTask ] );
+		}
+
+		vTaskDelay( 1 );
+
+		if( uxRuns != benchORDER_TASKS )
+		{
+			ulErrors++;
+			continue;
+		}
+
+		for( uxTask = 0; uxTask < benchORDER_TASKS; uxTask++ )
+		{
+			if( uxRunOrder[ uxTask ] != uxPriorities[ benchORDER_TASKS - 1 - uxTask ] )
+			{
+				ulErrors++;
+			}
+		}
+	}
+
+	taskENTER_CRITICAL();
+	{
+		if( ulErrors == 0 )
+		{
+			printf( "PASS: %lu rounds of %lu tasks run in priority order\n", ( unsigned long ) benchROUNDS, ( unsigned long ) benchORDER_TASKS );
+		}
+		else
+		{
+			printf( "FAIL: %lu tasks run out of order\n", ( unsigned long ) ulErrors );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	printf( "Priority bitmap task selection %s, %lu priorities\n", ( configUSE_PRIORITY_BITMAP_TASK_SELECTION == 1 ) ? "on" : "off", ( unsigned long ) configMAX_PRIORITIES );
+	xTaskCreate( prvBenchmarkTask, "Bench", benchSTACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,303 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side benchmark for xQueueSendMultiple(), xQueueReceiveMultiple() and
+ * their FromISR versions against a loop that sends or receives the same burst
+ * of items one at a time.  The median number of cycles to send a burst to an
+ * empty queue, then to receive it again, is reported for:
+ *
+ * + The task level functions, and the FromISR functions called with interrupts
+ *   masked as an interrupt service routine would call them.
+ * + A burst that fits between the queue's write position and the end of its
+ *   storage area, and a burst that wraps around to the start of the storage
+ *   area, so the batch functions copy it with two memcpy() calls.
+ *
+ * Each item carries a sequence number, and the test passes if every burst was
+ * sent and received in full and in order.
+ *
+ * Build with the POSIX port and any heap implementation.  Other burst sizes,
+ * up to the queue length, can be given on the command line, for example with
+ * -DbenchBURST=8.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#ifndef benchBURST
+	#define benchBURST			40
+#endif
+
+#define benchQUEUE_LENGTH		64
+#define benchSAMPLES			2000UL
+
+/* The stack size, which must be at least PTHREAD_STACK_MIN bytes. */
+#define benchSTACK_SIZE			( ( configSTACK_DEPTH_TYPE ) ( 32768 / sizeof( StackType_t ) ) )
+
+#if( benchBURST > benchQUEUE_LENGTH )
+	#error benchBURST must not be greater than benchQUEUE_LENGTH.
+#endif
+
+/* An item of the size of a CAN frame, as would typically be queued in bursts. */
+typedef struct BenchItem
+{
+	uint32_t ulSequence;
+	uint32_t ulPayload[ 3 ];
+} BenchItem_t;
+
+static QueueHandle_t xQueue = NULL;
+static BenchItem_t xSendItems[ benchBURST ], xReceiveItems[ benchBURST ];
+static uint64_t ullSendCycles[ benchSAMPLES ], ullReceiveCycles[ benchSAMPLES ];
+static uint32_t ulSequence = 0;
+
+/*-----------------------------------------------------------*/
+
+static int prvCompareCycles( const void *pv1, const void *pv2 )
+{
+uint64_t ull1 = *( const uint64_t * ) pv1, ull2 = *( const uint64_t * ) pv2;
+
+	return ( ull1 > ull2 ) - ( ull1 < ull2 );
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvMedian( uint64_t *pullCycles )
+{
+	/* The median is reported as the host occasionally interrupts the
+	measurement for far longer than it takes. */
+	qsort( pullCycles, benchSAMPLES, sizeof( pullCycles[ 0 ] ), prvCompareCycles );
+	return pullCycles[ benchSAMPLES / 2 ];
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvSend( BaseType_t xFromISR, BaseType_t xBatch )
+{
+UBaseType_t uxSent = 0;
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	if( xFromISR == pdFALSE )
+	{
+		if( xBatch != pdFALSE )
+		{
+			uxSent = xQueueSendMultiple( xQueue, xSendItems, benchBURST, 0 );
+		}
+		else
+		{
+			while( ( uxSent < benchBURST ) && ( xQueueSend( xQueue, &( xSendItems[ uxSent ] ), 0 ) == pdPASS ) )
+			{
+				uxSent++;
+			}
+		}
+	}
+	else
+	{
+		portDISABLE_INTERRUPTS();
+		{
+			if( xBatch != pdFALSE )
+			{
+				uxSent = xQueueSendMultipleFromISR( xQueue, xSendItems, benchBURST, &xHigherPriorityTaskWoken );
+			}
+			else
+			{
+				while( ( uxSent < benchBURST ) && ( xQueueSendFromISR( xQueue, &( xSendItems[ uxSent ] ), &xHigherPriorityTaskWoken ) == pdPASS ) )
+				{
+					uxSent++;
+				}
+			}
+		}
+		portENABLE_INTERRUPTS();
+	}
+
+	/* No task is waiting on the queue. */
+	configASSERT( xHigherPriorityTaskWoken == pdFALSE );
+
+	return uxSent;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvReceive( BaseType_t xFromISR, BaseType_t xBatch )
+{
+UBaseType_t uxReceived = 0;
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	if( xFromISR == pdFALSE )
+	{
+		if( xBatch != pdFALSE )
+		{
+			uxReceived = xQueueReceiveMultiple( xQueue, xReceiveItems, benchBURST, 0 );
+		}
+		else
+		{
+			while( ( uxReceived < benchBURST ) && ( xQueueReceive( xQueue, &( xReceiveItems[ uxReceived ] ), 0 ) == pdPASS ) )
+			{
+				uxReceived++;
+			}
+		}
+	}
+	else
+	{
+		portDISABLE_INTERRUPTS();
+		{
+			if( xBatch != pdFALSE )
+			{
+				uxReceived = xQueueReceiveMultipleFromISR( xQueue, xReceiveItems, benchBURST, &xHigherPriorityTaskWoken );
+			}
+			else
+			{
+				while( ( uxReceived < benchBURST ) && ( xQueueReceiveFromISR( xQueue, &( xReceiveItems[ uxReceived ] ), &xHigherPriorityTaskWoken ) == pdPASS ) )
+				{
+					uxReceived++;
+				}
+			}
+		}
+		portENABLE_INTERRUPTS();
+	}
+
+	configASSERT( xHigherPriorityTaskWoken == pdFALSE );
+
+	return uxReceived;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvMeasure( BaseType_t xWrap, BaseType_t xFromISR, BaseType_t xBatch )
+{
+uint32_t ulSample, ulErrors = 0;
+UBaseType_t uxItem, uxOffset;
+uint64_t ullStart;
+
+	for( ulSample = 0; ulSample < benchSAMPLES; ulSample++ )
+	{
+		( void ) xQueueReset( xQueue );
+
+		/* Move the queue's read and write positions on, so the burst starts
+		in the middle of the storage area and runs off the end of it. */
+		if( xWrap != pdFALSE )
+		{
+			for( uxOffset = 0; uxOffset < ( benchQUEUE_LENGTH - ( benchBURST / 2 ) ); uxOffset++ )
+			{
+				( void ) xQueueSend( xQueue, &( xSendItems[ 0 ] ), 0 );
+				( void ) xQueueReceive( xQueue, &( xReceiveItems[ 0 ] ), 0 );
+			}
+		}
+
+		for( uxItem = 0; uxItem < benchBURST; uxItem++ )
+		{
+			xSendItems[ uxItem ].ulSequence = ulSequence++;
+			xReceiveItems[ uxItem ].ulSequence = 0;
+		}
+
+		ullStart = ullPortGetCycleCounter();
+
+		if( prvSend( xFromISR, xBatch ) != benchBURST )
+		{
+			ulErrors++;
+		}
+
+		ullSendCycles[ ulSample ] = ullPortGetCycleCounter() - ullStart;
+		ullStart = ullPortGetCycleCounter();
+
+		if( prvReceive( xFromISR, xBatch ) != benchBURST )
+		{
+			ulErrors++;
+		}
+
+		ullReceiveCycles[ ulSample ] = ullPortGetCycleCounter() - ullStart;
+
+		for( uxItem = 0; uxItem < benchBURST; uxItem++ )
+		{
+			if( xReceiveItems[ uxItem ].ulSequence != xSendItems[ uxItem ].ulSequence )
+			{
+				ulErrors++;
+				break;
+			}
+		}
+	}
+
+	return ulErrors;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void *pvParameters )
+{
+BaseType_t xWrap, xFromISR;
+uint64_t ullLoopSend, ullLoopReceive;
+uint32_t ulErrors = 0;
+
+	( void ) pvParameters;
+
+	printf( "%d item bursts to a %d item queue\n", benchBURST, benchQUEUE_LENGTH );
+
+	for( xWrap = pdFALSE; xWrap <= pdTRUE; xWrap++ )
+	{
+		for( xFromISR = pdFALSE; xFromISR <= pdTRUE; xFromISR++ )
+		{
+			ulErrors += prvMeasure( xWrap, xFromISR, pdFALSE );
+			ullLoopSend = prvMedian( ullSendCycles );
+			ullLoopReceive = prvMedian( ullReceiveCycles );
+
+			ulErrors += prvMeasure( xWrap, xFromISR, pdTRUE );
+
+			printf( "%-10s %-4s median send loop %lu, batch %lu, receive loop %lu, batch %lu cycles\n",
+					( xWrap != pdFALSE ) ? "wrapping" : "contiguous",
+					( xFromISR != pdFALSE ) ? "ISR" : "task",
+					( unsigned long ) ullLoopSend,
+					( unsigned long ) prvMedian( ullSendCycles ),
+					( unsigned long ) ullLoopReceive,
+					( unsigned long ) prvMedian( ullReceiveCycles ) );
+		}
+	}
+
+	taskENTER_CRITICAL();
+	{
+		if( ulErrors == 0 )
+		{
+			printf( "PASS\n" );
+		}
+		else
+		{
+			printf( "FAIL: %lu errors\n", ( unsigned long ) ulErrors );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	xQueue = xQueueCreate( benchQUEUE_LENGTH, sizeof( BenchItem_t ) );
+	configASSERT( xQueue );
+
+	xTaskCreate( prvBenchmarkTask, "Bench", benchSTACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,395 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side benchmark that compares a queue wait set with a queue set, using
+ * the members of a gateway task that waits on twelve queues and three binary
+ * semaphores.  Each mechanism has its own fifteen members and its own gateway
+ * task, of the highest priority, that reads whichever member is ready.
+ *
+ * Phase one sends one item at a time to the members in turn, so the gateway is
+ * blocked each time, and reports the median number of cycles from the start of
+ * the send (or give) to the gateway holding the item, which on the POSIX port
+ * is mostly the cost of the context switch.  Phase two sends a burst of four
+ * items to every queue and gives every semaphore with the scheduler suspended,
+ * and reports the median cycles per item spent sending, then the median cycles
+ * per item from the gateway running until it has read everything.  The RAM
+ * used by each mechanism, beyond that of the members, is also reported.
+ * The test passes if each gateway read exactly the items sent to its members.
+ *
+ * Build with the POSIX port, any heap implementation, and a FreeRTOSConfig.h
+ * that sets configUSE_QUEUE_SETS and configUSE_QUEUE_WAIT_SETS to 1,
+ * configTASK_NOTIFICATION_ARRAY_ENTRIES to at least 2, and
+ * INCLUDE_xTaskGetSchedulerState to 1.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+#if( ( configUSE_QUEUE_SETS != 1 ) || ( configUSE_QUEUE_WAIT_SETS != 1 ) )
+	#error This benchmark compares queue sets with queue wait sets.
+#endif
+
+#if( configTASK_NOTIFICATION_ARRAY_ENTRIES < 2 )
+	#error This benchmark uses notification index 1 for the wait set.
+#endif
+
+#define benchQUEUES				12U
+#define benchSEMAPHORES			3U
+#define benchMEMBERS			( benchQUEUES + benchSEMAPHORES )
+#define benchQUEUE_LENGTH		8U
+#define benchBURST_LENGTH		4U
+#define benchBURST_ITEMS		( ( benchQUEUES * benchBURST_LENGTH ) + benchSEMAPHORES )
+#define benchSAMPLES			3000UL
+#define benchBURSTS				500UL
+
+/* The notification index used to unblock the wait set gateway. */
+#define benchWAIT_SET_INDEX		1
+
+/* A queue set must have space for every item its members can hold. */
+#define benchQUEUE_SET_LENGTH	( ( benchQUEUES * benchQUEUE_LENGTH ) + benchSEMAPHORES )
+
+/* The stack size, which must be at least PTHREAD_STACK_MIN bytes. */
+#define benchSTACK_SIZE			( ( configSTACK_DEPTH_TYPE ) ( 32768 / sizeof( StackType_t ) ) )
+
+typedef enum
+{
+	eQueueSet = 0,
+	eWaitSet,
+	eMechanisms
+} Mechanism_t;
+
+static const char * const pcMechanismNames[ eMechanisms ] = { "queue set", "wait set" };
+
+/* The members of each mechanism.  The queues come first, then the
+semaphores, and the position of a member is its bit number in the wait set. */
+static QueueSetMemberHandle_t xMembers[ eMechanisms ][ benchMEMBERS ];
+
+static QueueSetHandle_t xQueueSet = NULL;
+static QueueWaitSetHandle_t xWaitSet = NULL;
+
+static volatile uint64_t ullSendTime = 0, ullReadTime = 0, ullWakeTime = 0;
+static volatile uint32_t ulSent[ eMechanisms ], ulRead[ eMechanisms ], ulBadItems = 0;
+static volatile BaseType_t xBurstSent = pdFALSE;
+static uint64_t ullLatency[ benchSAMPLES ], ullSendCycles[ benchBURSTS ], ullReadCycles[ benchBURSTS ];
+
+/*-----------------------------------------------------------*/
+
+static void prvNoteWake( void )
+{
+	/* Note when the gateway first runs after a burst was sent. */
+	if( xBurstSent != pdFALSE )
+	{
+		ullWakeTime = ullPortGetCycleCounter();
+		xBurstSent = pdFALSE;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvReadItem( Mechanism_t eMechanism, UBaseType_t uxMember, uint32_t ulItem )
+{
+	ullReadTime = ullPortGetCycleCounter();
+
+	/* Each item sent to a queue holds the number of the queue. */
+	if( ( uxMember < benchQUEUES ) && ( ulItem != ( uint32_t ) uxMember ) )
+	{
+		ulBadItems++;
+	}
+
+	ulRead[ eMechanism ]++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvQueueSetGatewayTask( void *pvParameters )
+{
+QueueSetMemberHandle_t xReady;
+UBaseType_t uxMember;
+uint32_t ulItem = 0;
+BaseType_t xResult;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		xReady = xQueueSelectFromSet( xQueueSet, portMAX_DELAY );
+		prvNoteWake();
+
+		/* A queue set only returns the handle, so the gateway has to find out
+		which member it is. */
+		for( uxMember = 0; uxMember < benchMEMBERS; uxMember++ )
+		{
+			if( xMembers[ eQueueSet ][ uxMember ] == xReady )
+			{
+				break;
+			}
+		}
+
+		configASSERT( uxMember < benchMEMBERS );
+
+		if( uxMember < benchQUEUES )
+		{
+			xResult = xQueueReceive( xReady, &ulItem, 0 );
+		}
+		else
+		{
+			xResult = xSemaphoreTake( xReady, 0 );
+		}
+
+		configASSERT( xResult == pdPASS );
+		( void ) xResult;
+		prvReadItem( eQueueSet, uxMember, ulItem );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvWaitSetGatewayTask( void *pvParameters )
+{
+uint32_t ulReadyBits, ulItem = 0;
+UBaseType_t uxMember;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		ulReadyBits = ulQueueWaitForAny( xWaitSet, portMAX_DELAY );
+		prvNoteWake();
+		configASSERT( ulReadyBits != 0 );
+
+		/* Read every member that is ready until it is empty. */
+		for( uxMember = 0; uxMember < benchMEMBERS; uxMember++ )
+		{
+			if( ( ulReadyBits & ( 1UL << uxMember ) ) != 0 )
+			{
+				if( uxMember < benchQUEUES )
+				{
+					while( xQueueReceive( xMembers[ eWaitSet ][ uxMember ], &ulItem, 0 ) == pdPASS )
+					{
+						prvReadItem( eWaitSet, uxMember, ulItem );
+					}
+				}
+				else
+				{
+					while( xSemaphoreTake( xMembers[ eWaitSet ][ uxMember ], 0 ) == pdPASS )
+					{
+						prvReadItem( eWaitSet, uxMember, ulItem );
+					}
+				}
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSend( Mechanism_t eMechanism, UBaseType_t uxMember )
+{
+BaseType_t xReturn;
+uint32_t ulItem = ( uint32_t ) uxMember;
+
+	if( uxMember < benchQUEUES )
+	{
+		xReturn = xQueueSend( xMembers[ eMechanism ][ uxMember ], &ulItem, 0 );
+	}
+	else
+	{
+		xReturn = xSemaphoreGive( xMembers[ eMechanism ][ uxMember ] );
+	}
+
+	if( xReturn == pdPASS )
+	{
+		ulSent[ eMechanism ]++;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareCycles( const void *pv1, const void *pv2 )
+{
+uint64_t ull1 = *( const uint64_t * ) pv1, ull2 = *( const uint64_t * ) pv2;
+
+	return ( ull1 > ull2 ) - ( ull1 < ull2 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvMeasure( Mechanism_t eMechanism )
+{
+uint32_t ulSample, ulBurst, ulFirstRead;
+UBaseType_t uxMember, uxItem;
+uint64_t ullStart;
+BaseType_t xResult;
+
+	/* Phase one - the gateway is blocked each time an item is sent.  As the
+	gateway has the higher priority it has read the item by the time the send
+	returns. */
+	for( ulSample = 0; ulSample < benchSAMPLES; ulSample++ )
+	{
+		ulFirstRead = ulRead[ eMechanism ];
+		ullSendTime = ullPortGetCycleCounter();
+		xResult = prvSend( eMechanism, ( UBaseType_t ) ( ulSample % benchMEMBERS ) );
+		configASSERT( xResult == pdPASS );
+		configASSERT( ulRead[ eMechanism ] == ( ulFirstRead + 1 ) );
+		ullLatency[ ulSample ] = ullReadTime - ullSendTime;
+	}
+
+	/* Phase two - bursts sent with the scheduler suspended, so the gateway
+	only runs once the whole burst has been sent. */
+	for( ulBurst = 0; ulBurst < benchBURSTS; ulBurst++ )
+	{
+		ulFirstRead = ulRead[ eMechanism ];
+
+		vTaskSuspendAll();
+		{
+			ullStart = ullPortGetCycleCounter();
+
+			for( uxItem = 0; uxItem < benchBURST_LENGTH; uxItem++ )
+			{
+				for( uxMember = 0; uxMember < benchQUEUES; uxMember++ )
+				{
+					xResult = prvSend( eMechanism, uxMember );
+					configASSERT( xResult == pdPASS );
+				}
+			}
+
+			for( uxMember = benchQUEUES; uxMember < benchMEMBERS; uxMember++ )
+			{
+				xResult = prvSend( eMechanism, uxMember );
+				configASSERT( xResult == pdPASS );
+			}
+
+			ullSendCycles[ ulBurst ] = ullPortGetCycleCounter() - ullStart;
+			xBurstSent = pdTRUE;
+		}
+		( void ) xTaskResumeAll();
+
+		/* The gateway has read the whole burst before this task runs again. */
+		configASSERT( ulRead[ eMechanism ] == ( ulFirstRead + benchBURST_ITEMS ) );
+		ullReadCycles[ ulBurst ] = ullReadTime - ullWakeTime;
+	}
+
+	( void ) xResult;
+
+	/* Medians are reported as the host occasionally interrupts a thread for
+	far longer than the operation takes. */
+	qsort( ullLatency, benchSAMPLES, sizeof( ullLatency[ 0 ] ), prvCompareCycles );
+	qsort( ullSendCycles, benchBURSTS, sizeof( ullSendCycles[ 0 ] ), prvCompareCycles );
+	qsort( ullReadCycles, benchBURSTS, sizeof( ullReadCycles[ 0 ] ), prvCompareCycles );
+
+	printf( "%-10s %8lu %14.1f %14.1f\n", pcMechanismNames[ eMechanism ], ( unsigned long ) ullLatency[ benchSAMPLES / 2 ], ( double ) ullSendCycles[ benchBURSTS / 2 ] / ( double ) benchBURST_ITEMS, ( double ) ullReadCycles[ benchBURSTS / 2 ] / ( double ) benchBURST_ITEMS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void *pvParameters )
+{
+Mechanism_t eMechanism;
+
+	( void ) pvParameters;
+
+	printf( "%u queues of %u items and %u binary semaphores\n", benchQUEUES, benchQUEUE_LENGTH, benchSEMAPHORES );
+	printf( "queue set RAM %lu bytes, wait set RAM %lu bytes\n", ( unsigned long ) ( sizeof( StaticQueue_t ) + ( benchQUEUE_SET_LENGTH * sizeof( void * ) ) ), ( unsigned long ) sizeof( StaticQueueWaitSet_t ) );
+	printf( "           latency  burst send/item  burst read/item (median cycles)\n" );
+
+	for( eMechanism = eQueueSet; eMechanism < eMechanisms; eMechanism++ )
+	{
+		prvMeasure( eMechanism );
+	}
+
+	taskENTER_CRITICAL();
+	{
+		if( ( ulSent[ eQueueSet ] == ulRead[ eQueueSet ] ) && ( ulSent[ eWaitSet ] == ulRead[ eWaitSet ] ) && ( ulBadItems == 0 ) && ( ulQueueWaitForAny( xWaitSet, 0 ) == 0 ) )
+		{
+			printf( "PASS: %lu and %lu items read\n", ( unsigned long ) ulRead[ eQueueSet ], ( unsigned long ) ulRead[ eWaitSet ] );
+		}
+		else
+		{
+			printf( "FAIL: queue set %lu/%lu, wait set %lu/%lu read/sent, %lu bad items\n", ( unsigned long ) ulRead[ eQueueSet ], ( unsigned long ) ulSent[ eQueueSet ], ( unsigned long ) ulRead[ eWaitSet ], ( unsigned long ) ulSent[ eWaitSet ], ( unsigned long ) ulBadItems );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+Mechanism_t eMechanism;
+UBaseType_t uxMember;
+
+BaseType_t xResult;
+
+	xQueueSet = xQueueCreateSet( benchQUEUE_SET_LENGTH );
+	xWaitSet = xQueueCreateWaitSet( benchWAIT_SET_INDEX );
+	configASSERT( xQueueSet );
+	configASSERT( xWaitSet );
+
+	for( eMechanism = eQueueSet; eMechanism < eMechanisms; eMechanism++ )
+	{
+		for( uxMember = 0; uxMember < benchMEMBERS; uxMember++ )
+		{
+			if( uxMember < benchQUEUES )
+			{
+				xMembers[ eMechanism ][ uxMember ] = xQueueCreate( benchQUEUE_LENGTH, sizeof( uint32_t ) );
+			}
+			else
+			{
+				xMembers[ eMechanism ][ uxMember ] = xSemaphoreCreateBinary();
+			}
+
+			configASSERT( xMembers[ eMechanism ][ uxMember ] );
+
+			if( eMechanism == eQueueSet )
+			{
+				xResult = xQueueAddToSet( xMembers[ eMechanism ][ uxMember ], xQueueSet );
+			}
+			else
+			{
+				xResult = xQueueAddToWaitSet( xMembers[ eMechanism ][ uxMember ], xWaitSet, uxMember );
+			}
+
+			configASSERT( xResult == pdPASS );
+		}
+	}
+
+	/* A member of one cannot be added to the other. */
+	xResult = xQueueAddToWaitSet( xMembers[ eQueueSet ][ 0 ], xWaitSet, benchMEMBERS );
+	configASSERT( xResult == pdFAIL );
+	xResult = xQueueAddToSet( xMembers[ eWaitSet ][ 0 ], xQueueSet );
+	configASSERT( xResult == pdFAIL );
+	( void ) xResult;
+
+	xTaskCreate( prvQueueSetGatewayTask, "QSGate", benchSTACK_SIZE, NULL, configMAX_PRIORITIES - 1, NULL );
+	xTaskCreate( prvWaitSetGatewayTask, "WSGate", benchSTACK_SIZE, NULL, configMAX_PRIORITIES - 1, NULL );
+	xTaskCreate( prvBenchmarkTask, "Bench", benchSTACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,415 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side throughput benchmark of reader-writer locks against the mutex type
+ * semaphores created by xSemaphoreCreateMutex(), for a table that is read by
+ * twelve tasks and written by one.  Every fourth read, and every write, yields
+ * while the lock is held to model a time slice ending inside the critical
+ * region.  The average number of cycles per read or write is reported for 1,
+ * 10 and 50 writes per 100 reads, and the readers check that they never see a
+ * partly written table.  It then checks that readers share the lock, that a
+ * waiting writer takes preference over new readers, and that the writer
+ * inherits the priority of a reader blocked on the lock, and disinherits it
+ * both when it gives the lock and when the reader times out.
+ *
+ * Build with the POSIX port, rw_lock.c and heap_4, using a FreeRTOSConfig.h
+ * that sets configUSE_RW_LOCKS, configUSE_MUTEXES, INCLUDE_vTaskDelete and
+ * INCLUDE_uxTaskPriorityGet to 1.  The lock used by the checks is created
+ * statically if configSUPPORT_STATIC_ALLOCATION is also 1.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "rw_lock.h"
+
+#define benchREADERS				12UL
+#define benchREADS					500UL
+#define benchTABLE_WORDS			16UL
+#define benchLOW_PRIORITY			( tskIDLE_PRIORITY + 1 )
+#define benchWORKER_PRIORITY		( tskIDLE_PRIORITY + 2 )
+#define benchCONTROL_PRIORITY		( tskIDLE_PRIORITY + 3 )
+#define benchHIGH_PRIORITY			( tskIDLE_PRIORITY + 4 )
+
+/* The stack size of every task, which must be at least PTHREAD_STACK_MIN
+bytes. */
+#define benchSTACK_SIZE				( ( configSTACK_DEPTH_TYPE ) ( 65536 / sizeof( StackType_t ) ) )
+
+/* The lock guarding the table during the throughput test, only one of which
+is not NULL. */
+static SemaphoreHandle_t xMutex = NULL;
+static RWLockHandle_t xRWLock = NULL;
+
+static TaskHandle_t xControlTask = NULL;
+static volatile uint32_t ulTable[ benchTABLE_WORDS ];
+static volatile uint32_t ulErrors = 0;
+static uint32_t ulWrites;
+static volatile BaseType_t xWriterResult;
+static volatile UBaseType_t uxPriorityWhileHeld, uxPriorityAfterGive;
+
+/*-----------------------------------------------------------*/
+
+static void prvReadTable( uint32_t ulRead )
+{
+uint32_t ulWord;
+BaseType_t xResult;
+
+	if( xRWLock != NULL )
+	{
+		xResult = xRWLockTakeRead( xRWLock, portMAX_DELAY );
+	}
+	else
+	{
+		xResult = xSemaphoreTake( xMutex, portMAX_DELAY );
+	}
+
+	if( ( ulRead & 3UL ) == 0UL )
+	{
+		taskYIELD();
+	}
+
+	for( ulWord = 1; ulWord < benchTABLE_WORDS; ulWord++ )
+	{
+		if( ulTable[ ulWord ] != ulTable[ 0 ] )
+		{
+			ulErrors++;
+		}
+	}
+
+	if( xRWLock != NULL )
+	{
+		xResult &= xRWLockGiveRead( xRWLock );
+	}
+	else
+	{
+		xResult &= xSemaphoreGive( xMutex );
+	}
+
+	if( xResult != pdPASS )
+	{
+		ulErrors++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteTable( void )
+{
+uint32_t ulWord;
+BaseType_t xResult;
+
+	if( xRWLock != NULL )
+	{
+		xResult = xRWLockTakeWrite( xRWLock, portMAX_DELAY );
+	}
+	else
+	{
+		xResult = xSemaphoreTake( xMutex, portMAX_DELAY );
+	}
+
+	/* Yield half way through the update, when a reader would see a partly
+	written table. */
+	for( ulWord = 0; ulWord < benchTABLE_WORDS; ulWord++ )
+	{
+		ulTable[ ulWord ]++;
+
+		if( ulWord == ( benchTABLE_WORDS / 2UL ) )
+		{
+			taskYIELD();
+		}
+	}
+
+	if( xRWLock != NULL )
+	{
+		xResult &= xRWLockGiveWrite( xRWLock );
+	}
+	else
+	{
+		xResult &= xSemaphoreGive( xMutex );
+	}
+
+	if( xResult != pdPASS )
+	{
+		ulErrors++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvReaderTask( void *pvParameters )
+{
+uint32_t ulRead;
+
+	( void ) pvParameters;
+
+	for( ulRead = 0; ulRead < benchREADS; ulRead++ )
+	{
+		prvReadTable( ulRead );
+	}
+
+	xTaskNotifyGive( xControlTask );
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriterTask( void *pvParameters )
+{
+uint32_t ulWrite;
+
+	( void ) pvParameters;
+
+	for( ulWrite = 0; ulWrite < ulWrites; ulWrite++ )
+	{
+		prvWriteTable();
+
+		/* Let the readers run between writes. */
+		taskYIELD();
+	}
+
+	xTaskNotifyGive( xControlTask );
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvTimeTable( uint32_t ulWritesPerHundredReads )
+{
+uint64_t ullStart, ullCycles;
+uint32_t ulTask;
+BaseType_t xResult;
+
+	ulWrites = ( benchREADERS * benchREADS * ulWritesPerHundredReads ) / 100UL;
+	ullStart = ullPortGetCycleCounter();
+
+	for( ulTask = 0; ulTask < benchREADERS; ulTask++ )
+	{
+		xResult = xTaskCreate( prvReaderTask, "Reader", benchSTACK_SIZE, NULL, benchWORKER_PRIORITY, NULL );
+		configASSERT( xResult == pdPASS );
+	}
+
+	xResult = xTaskCreate( prvWriterTask, "Writer", benchSTACK_SIZE, NULL, benchWORKER_PRIORITY, NULL );
+	configASSERT( xResult == pdPASS );
+	( void ) xResult;
+
+	for( ulTask = 0; ulTask < ( benchREADERS + 1UL ); ulTask++ )
+	{
+		( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+	}
+
+	ullCycles = ullPortGetCycleCounter() - ullStart;
+
+	/* Let the idle task free the tasks, which delete themselves. */
+	vTaskDelay( 2 );
+
+	return ullCycles / ( ( benchREADERS * benchREADS ) + ulWrites );
+}
+/*-----------------------------------------------------------*/
+
+static void prvHighPriorityWriterTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	xWriterResult = xRWLockTakeWrite( xRWLock, portMAX_DELAY );
+
+	if( xWriterResult == pdPASS )
+	{
+		( void ) xRWLockGiveWrite( xRWLock );
+	}
+
+	xTaskNotifyGive( xControlTask );
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvLowPriorityWriterTask( void *pvParameters )
+{
+TickType_t xHoldTime = ( TickType_t ) ( uintptr_t ) pvParameters;
+
+	if( xRWLockTakeWrite( xRWLock, 0 ) != pdPASS )
+	{
+		ulErrors++;
+	}
+
+	/* Let the control task try to take the lock for reading, then hold on to
+	it either until the control task times out or without blocking. */
+	xTaskNotifyGive( xControlTask );
+
+	if( xHoldTime != 0 )
+	{
+		vTaskDelay( xHoldTime );
+	}
+
+	uxPriorityWhileHeld = uxTaskPriorityGet( NULL );
+	( void ) xRWLockGiveWrite( xRWLock );
+	uxPriorityAfterGive = uxTaskPriorityGet( NULL );
+
+	xTaskNotifyGive( xControlTask );
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvControlTask( void *pvParameters )
+{
+static const uint32_t ulRatios[] = { 1, 10, 50 };
+uint64_t ullMutex, ullRWLock;
+TaskHandle_t xWriter;
+size_t x;
+
+	( void ) pvParameters;
+
+	xMutex = xSemaphoreCreateMutex();
+	xRWLock = NULL;
+	configASSERT( xMutex );
+
+	for( x = 0; x < ( sizeof( ulRatios ) / sizeof( ulRatios[ 0 ] ) ); x++ )
+	{
+		ullMutex = prvTimeTable( ulRatios[ x ] );
+
+		xRWLock = xRWLockCreate();
+		configASSERT( xRWLock );
+		ullRWLock = prvTimeTable( ulRatios[ x ] );
+		vRWLockDelete( xRWLock );
+		xRWLock = NULL;
+
+		printf( "%2lu writes per 100 reads:  mutex semaphore %lu cycles per access, reader-writer lock %lu cycles per access\n", ( unsigned long ) ulRatios[ x ], ( unsigned long ) ullMutex, ( unsigned long ) ullRWLock );
+	}
+
+	vSemaphoreDelete( xMutex );
+
+	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	{
+	static StaticRWLock_t xLockBuffer;
+
+		xRWLock = xRWLockCreateStatic( &xLockBuffer );
+	}
+	#else
+	{
+		xRWLock = xRWLockCreate();
+	}
+	#endif
+	configASSERT( xRWLock );
+
+	/* Readers share the lock, and only the holder can give it. */
+	if( ( xRWLockGiveRead( xRWLock ) != pdFAIL ) || ( xRWLockGiveWrite( xRWLock ) != pdFAIL ) )
+	{
+		printf( "a lock that was not held was given\n" );
+		ulErrors++;
+	}
+
+	if( ( xRWLockTakeRead( xRWLock, 0 ) != pdPASS ) || ( xRWLockTakeRead( xRWLock, 0 ) != pdPASS ) || ( xRWLockTakeWrite( xRWLock, 0 ) != pdFAIL ) )
+	{
+		printf( "the lock was not shared by readers\n" );
+		ulErrors++;
+	}
+
+	( void ) xRWLockGiveRead( xRWLock );
+
+	/* A writer waiting for the lock stops new readers taking it, and takes it
+	as soon as the last reader gives it. */
+	xWriterResult = pdFAIL;
+	xTaskCreate( prvHighPriorityWriterTask, "Writer", benchSTACK_SIZE, NULL, benchHIGH_PRIORITY, NULL );
+
+	if( xRWLockTakeRead( xRWLock, 0 ) != pdFAIL )
+	{
+		printf( "a reader took the lock while a writer was waiting\n" );
+		ulErrors++;
+	}
+
+	( void ) xRWLockGiveRead( xRWLock );
+	( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+	if( xWriterResult != pdPASS )
+	{
+		printf( "the waiting writer did not take the lock\n" );
+		ulErrors++;
+	}
+
+	/* A low priority writer inherits the priority of the control task while
+	the control task is blocked on the lock, and disinherits it when it gives
+	the lock. */
+	xTaskCreate( prvLowPriorityWriterTask, "Writer", benchSTACK_SIZE, ( void * ) 0, benchLOW_PRIORITY, &xWriter );
+	( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+	if( xRWLockTakeRead( xRWLock, portMAX_DELAY ) != pdPASS )
+	{
+		ulErrors++;
+	}
+
+	( void ) xRWLockGiveRead( xRWLock );
+	( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+	if( ( uxPriorityWhileHeld != benchCONTROL_PRIORITY ) || ( uxPriorityAfterGive != benchLOW_PRIORITY ) )
+	{
+		printf( "writer priority %lu while held and %lu after the give, expected %lu and %lu\n", ( unsigned long ) uxPriorityWhileHeld, ( unsigned long ) uxPriorityAfterGive, ( unsigned long ) benchCONTROL_PRIORITY, ( unsigned long ) benchLOW_PRIORITY );
+		ulErrors++;
+	}
+
+	/* The writer blocks while holding the lock, so the control task times
+	out, at which point the writer disinherits the priority again. */
+	xTaskCreate( prvLowPriorityWriterTask, "Writer", benchSTACK_SIZE, ( void * ) 20, benchLOW_PRIORITY, &xWriter );
+	( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+	if( xRWLockTakeRead( xRWLock, 5 ) != pdFAIL )
+	{
+		printf( "the lock was taken for reading while held for writing\n" );
+		ulErrors++;
+	}
+
+	if( uxTaskPriorityGet( xWriter ) != benchLOW_PRIORITY )
+	{
+		printf( "writer priority %lu after the timeout, expected %lu\n", ( unsigned long ) uxTaskPriorityGet( xWriter ), ( unsigned long ) benchLOW_PRIORITY );
+		ulErrors++;
+	}
+
+	( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+	vRWLockDelete( xRWLock );
+
+	taskENTER_CRITICAL();
+	{
+		if( ulErrors == 0 )
+		{
+			printf( "PASS\n" );
+		}
+		else
+		{
+			printf( "FAIL: %lu errors\n", ( unsigned long ) ulErrors );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	xTaskCreate( prvControlTask, "Control", benchSTACK_SIZE, NULL, benchCONTROL_PRIORITY, &xControlTask );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
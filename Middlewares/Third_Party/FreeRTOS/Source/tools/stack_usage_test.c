@@ -0,0 +1,230 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side test of configUSE_STACK_WATERMARK_TRACKING.  Each worker task
+ * calls a function that writes a local buffer of a known size, so the tasks
+ * differ in stack use by known amounts, then blocks.  The stack use reported
+ * by uxTaskGetStackUsage() is checked against the size of each buffer, the
+ * tracked high water mark of each task is checked against the one found by
+ * uxTaskGetStackHighWaterMark2() searching the stack, and the suggested stack
+ * sizes are checked against the margin.  The median number of cycles taken by
+ * uxTaskGetTrackedStackHighWaterMark() and by uxTaskGetStackHighWaterMark2()
+ * is also reported.
+ *
+ * Build with the POSIX port and any heap implementation, using a
+ * FreeRTOSConfig.h that sets configUSE_STACK_WATERMARK_TRACKING and
+ * INCLUDE_uxTaskGetStackHighWaterMark2 to 1.  configSTACK_DEPTH_TYPE must be
+ * able to hold testSTACK_SIZE.  Also set configSTACK_WATERMARK_GAP_WORDS to
+ * 256, as the host C library reserves over 200 words near the top of each
+ * thread's stack that it does not write.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define testWORKERS				4
+#define testMARGIN_PERCENT		25U
+#define testSAMPLES				1000UL
+
+/* The value the worker buffers are filled with, which must differ from the
+value the kernel fills stacks with. */
+#define testBUFFER_FILL_BYTE	0x5aU
+
+/* The number of words by which the difference in stack use of two workers
+may differ from the difference in the sizes of their buffers, to allow for the
+alignment of the buffers and for the stack used by the host when the tick
+interrupts a worker. */
+#define testSLACK_WORDS			( ( configSTACK_DEPTH_TYPE ) 16 )
+
+/* The stack size, which must be at least PTHREAD_STACK_MIN bytes plus the
+largest buffer. */
+#define testSTACK_SIZE			( ( configSTACK_DEPTH_TYPE ) ( 65536 / sizeof( StackType_t ) ) )
+
+static const size_t xBufferSizes[ testWORKERS ] = { 1024, 2048, 6144, 12288 };
+static TaskHandle_t xWorkers[ testWORKERS ];
+static uint64_t ullTrackedCycles[ testSAMPLES ], ullSearchCycles[ testSAMPLES ];
+
+/*-----------------------------------------------------------*/
+
+static void __attribute__( ( noinline ) ) prvUseStack( size_t xBytes )
+{
+/* One extra byte so the array is never zero length.  The buffer is volatile
+and written a byte at a time so the writes cannot be optimised away. */
+volatile uint8_t ucBuffer[ xBytes + 1U ];
+size_t x;
+
+	for( x = 0; x < sizeof( ucBuffer ); x++ )
+	{
+		ucBuffer[ x ] = testBUFFER_FILL_BYTE;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvWorkerTask( void *pvParameters )
+{
+const size_t xBytes = *( const size_t * ) pvParameters;
+
+	for( ;; )
+	{
+		prvUseStack( xBytes );
+		vTaskDelay( 1 );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareCycles( const void *pv1, const void *pv2 )
+{
+uint64_t ull1 = *( const uint64_t * ) pv1, ull2 = *( const uint64_t * ) pv2;
+
+	return ( ull1 > ull2 ) - ( ull1 < ull2 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestTask( void *pvParameters )
+{
+TaskStackUsage_t xUsage[ testWORKERS + 4 ];
+configSTACK_DEPTH_TYPE uxUsed[ testWORKERS ], uxExpected, uxSearched;
+UBaseType_t uxTasks, uxTask, uxWorker;
+uint32_t ulErrors = 0, ulSample, ulSuggested;
+uint64_t ullStart;
+
+	( void ) pvParameters;
+
+	for( uxWorker = 0; uxWorker < testWORKERS; uxWorker++ )
+	{
+		xTaskCreate( prvWorkerTask, "Worker", testSTACK_SIZE, ( void * ) &( xBufferSizes[ uxWorker ] ), tskIDLE_PRIORITY + 1, &( xWorkers[ uxWorker ] ) );
+	}
+
+	/* Let each worker use its stack and be switched out a few times. */
+	vTaskDelay( 10 );
+
+	configASSERT( uxTaskGetNumberOfTasks() <= ( sizeof( xUsage ) / sizeof( xUsage[ 0 ] ) ) );
+	uxTasks = uxTaskGetStackUsage( xUsage, sizeof( xUsage ) / sizeof( xUsage[ 0 ] ), testMARGIN_PERCENT );
+
+	for( uxTask = 0; uxTask < uxTasks; uxTask++ )
+	{
+		/* The suggestion must be the stack used plus the margin, rounded up. */
+		ulSuggested = ( uint32_t ) xUsage[ uxTask ].usStackDepth - ( uint32_t ) xUsage[ uxTask ].usStackHighWaterMark;
+		ulSuggested += ( ( ulSuggested * testMARGIN_PERCENT ) + 99UL ) / 100UL;
+
+		if( xUsage[ uxTask ].usSuggestedStackDepth != ( configSTACK_DEPTH_TYPE ) ulSuggested )
+		{
+			printf( "%s suggested %lu words, expected %lu\n", xUsage[ uxTask ].pcTaskName, ( unsigned long ) xUsage[ uxTask ].usSuggestedStackDepth, ( unsigned long ) ulSuggested );
+			ulErrors++;
+		}
+
+		for( uxWorker = 0; uxWorker < testWORKERS; uxWorker++ )
+		{
+			if( xUsage[ uxTask ].xHandle == xWorkers[ uxWorker ] )
+			{
+				uxUsed[ uxWorker ] = xUsage[ uxTask ].usStackDepth - xUsage[ uxTask ].usStackHighWaterMark;
+
+				/* The workers write every byte of their buffers, so tracking
+				must find the same high water mark as searching the stack. */
+				uxSearched = uxTaskGetStackHighWaterMark2( xWorkers[ uxWorker ] );
+
+				if( uxSearched != xUsage[ uxTask ].usStackHighWaterMark )
+				{
+					printf( "worker %lu tracked high water mark %lu words, searched %lu\n", ( unsigned long ) uxWorker, ( unsigned long ) xUsage[ uxTask ].usStackHighWaterMark, ( unsigned long ) uxSearched );
+					ulErrors++;
+				}
+
+				printf( "worker %lu, %5lu byte buffer: stack %lu words, used %lu, suggested %lu\n",
+						( unsigned long ) uxWorker,
+						( unsigned long ) xBufferSizes[ uxWorker ],
+						( unsigned long ) xUsage[ uxTask ].usStackDepth,
+						( unsigned long ) uxUsed[ uxWorker ],
+						( unsigned long ) xUsage[ uxTask ].usSuggestedStackDepth );
+			}
+		}
+	}
+
+	if( uxTasks != uxTaskGetNumberOfTasks() )
+	{
+		ulErrors++;
+	}
+
+	/* Each worker must use more stack than the first by the difference in
+	the sizes of their buffers.  The smallest buffer is large enough that the
+	deepest stack use of every worker is within its buffer, not in the host
+	code that blocks the worker. */
+	for( uxWorker = 1; uxWorker < testWORKERS; uxWorker++ )
+	{
+		uxExpected = ( configSTACK_DEPTH_TYPE ) ( ( xBufferSizes[ uxWorker ] - xBufferSizes[ 0 ] ) / sizeof( StackType_t ) );
+
+		if( ( ( uxUsed[ uxWorker ] - uxUsed[ 0 ] ) + testSLACK_WORDS < uxExpected ) || ( ( uxUsed[ uxWorker ] - uxUsed[ 0 ] ) > ( uxExpected + testSLACK_WORDS ) ) )
+		{
+			printf( "worker %lu used %lu more words than worker 0, expected %lu\n", ( unsigned long ) uxWorker, ( unsigned long ) ( uxUsed[ uxWorker ] - uxUsed[ 0 ] ), ( unsigned long ) uxExpected );
+			ulErrors++;
+		}
+	}
+
+	/* Time both ways of obtaining the high water mark of the worker with the
+	most free stack, which takes longest to search. */
+	for( ulSample = 0; ulSample < testSAMPLES; ulSample++ )
+	{
+		ullStart = ullPortGetCycleCounter();
+		( void ) uxTaskGetTrackedStackHighWaterMark( xWorkers[ 0 ] );
+		ullTrackedCycles[ ulSample ] = ullPortGetCycleCounter() - ullStart;
+
+		ullStart = ullPortGetCycleCounter();
+		( void ) uxTaskGetStackHighWaterMark2( xWorkers[ 0 ] );
+		ullSearchCycles[ ulSample ] = ullPortGetCycleCounter() - ullStart;
+	}
+
+	qsort( ullTrackedCycles, testSAMPLES, sizeof( ullTrackedCycles[ 0 ] ), prvCompareCycles );
+	qsort( ullSearchCycles, testSAMPLES, sizeof( ullSearchCycles[ 0 ] ), prvCompareCycles );
+	printf( "median %lu cycles tracked, %lu cycles searching the stack\n", ( unsigned long ) ullTrackedCycles[ testSAMPLES / 2 ], ( unsigned long ) ullSearchCycles[ testSAMPLES / 2 ] );
+
+	taskENTER_CRITICAL();
+	{
+		if( ulErrors == 0 )
+		{
+			printf( "PASS: stack use of %lu tasks\n", ( unsigned long ) uxTasks );
+		}
+		else
+		{
+			printf( "FAIL: %lu errors\n", ( unsigned long ) ulErrors );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	xTaskCreate( prvTestTask, "Test", testSTACK_SIZE, NULL, configMAX_PRIORITIES - 1, NULL );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
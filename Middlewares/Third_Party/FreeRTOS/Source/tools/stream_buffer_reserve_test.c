@@ -0,0 +1,360 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side test of the stream and message buffer reserve/commit and
+ * acquire/release functions.  The start of each buffer's storage area is found
+ * by reserving space in the empty buffer, so the spans handed out can be
+ * checked against the exact positions in the storage area.  Before each check the buffer's read and write positions are moved to a known
+ * index by sending and receiving data, then the test checks that:
+ *
+ * + A reservation that crosses the end of the storage area is returned as two
+ *   spans, the second at the start of the storage area, and the bytes written
+ *   to both spans are received in order by xStreamBufferReceive().
+ * + Committing fewer bytes than were reserved only makes those bytes
+ *   available, and a stream buffer reserves no more than the free space.
+ * + Data sent by xStreamBufferSend() across the end of the storage area is
+ *   acquired as two spans, and releasing part of it leaves the rest.
+ * + The length of a message written through reserve/commit is read back by
+ *   xMessageBufferReceive(), both when the length itself and when only the
+ *   message crosses the end of the storage area, and committing 0 bytes
+ *   discards the message.
+ * + A message buffer reserves space for the whole message or nothing, and
+ *   acquiring a message skips its length.
+ * + The FromISR versions behave as the task versions.
+ *
+ * Build with the POSIX port and any heap implementation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+
+#define testSTREAM_BUFFER_SIZE		37
+#define testMESSAGE_BUFFER_SIZE		61
+
+/* The storage area holds one more byte than the buffer size, so a full buffer
+can be told apart from an empty one. */
+#define testSTREAM_STORAGE_SIZE		( testSTREAM_BUFFER_SIZE + 1 )
+#define testMESSAGE_STORAGE_SIZE	( testMESSAGE_BUFFER_SIZE + 1 )
+
+/* The number of bytes a message buffer uses to hold the length of each
+message. */
+#define testLENGTH_BYTES			( sizeof( configMESSAGE_BUFFER_LENGTH_TYPE ) )
+
+/* The stack size, which must be at least PTHREAD_STACK_MIN bytes. */
+#define testSTACK_SIZE				( ( configSTACK_DEPTH_TYPE ) ( 32768 / sizeof( StackType_t ) ) )
+
+static uint8_t *ucStreamStorage = NULL, *ucMessageStorage = NULL;
+static StreamBufferHandle_t xStreamBuffer = NULL;
+static MessageBufferHandle_t xMessageBuffer = NULL;
+static uint8_t ucPattern = 0, ucData[ testMESSAGE_BUFFER_SIZE ], ucReceived[ testMESSAGE_BUFFER_SIZE ];
+static uint32_t ulChecks = 0, ulErrors = 0;
+
+/*-----------------------------------------------------------*/
+
+static void prvCheck( BaseType_t xPassed, const char *pcWhat )
+{
+	ulChecks++;
+
+	if( xPassed == pdFALSE )
+	{
+		ulErrors++;
+		printf( "failed: %s\n", pcWhat );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckRegion( const StreamBufferRegion_t *pxRegion, uint8_t *pucFirst, size_t xFirstLength, uint8_t *pucSecond, size_t xSecondLength, const char *pcWhat )
+{
+	prvCheck( ( pxRegion->pucFirst == pucFirst ) &&
+			  ( pxRegion->xFirstLengthBytes == xFirstLength ) &&
+			  ( pxRegion->pucSecond == pucSecond ) &&
+			  ( pxRegion->xSecondLengthBytes == xSecondLength ), pcWhat );
+}
+/*-----------------------------------------------------------*/
+
+static void prvFillData( size_t xLength )
+{
+size_t x;
+
+	for( x = 0; x < xLength; x++ )
+	{
+		ucData[ x ] = ucPattern++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteRegion( const StreamBufferRegion_t *pxRegion, size_t xLength )
+{
+size_t xFirst = configMIN( xLength, pxRegion->xFirstLengthBytes );
+
+	memcpy( pxRegion->pucFirst, ucData, xFirst );
+
+	if( xLength > xFirst )
+	{
+		memcpy( pxRegion->pucSecond, &( ucData[ xFirst ] ), xLength - xFirst );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvRegionMatches( const StreamBufferRegion_t *pxRegion )
+{
+	return ( ( memcmp( pxRegion->pucFirst, ucData, pxRegion->xFirstLengthBytes ) == 0 ) &&
+			 ( ( pxRegion->pucSecond == NULL ) ||
+			   ( memcmp( pxRegion->pucSecond, &( ucData[ pxRegion->xFirstLengthBytes ] ), pxRegion->xSecondLengthBytes ) == 0 ) ) ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMoveTo( StreamBufferHandle_t xBuffer, size_t xIndex )
+{
+	/* Sending then receiving xIndex bytes leaves an empty buffer with its
+	read and write positions at xIndex.  A message buffer also stores the
+	length of the message. */
+	( void ) xStreamBufferReset( xBuffer );
+
+	if( xIndex > 0 )
+	{
+		if( xBuffer == xMessageBuffer )
+		{
+			configASSERT( xIndex >= testLENGTH_BYTES );
+			( void ) xMessageBufferSend( xBuffer, ucData, xIndex - testLENGTH_BYTES, 0 );
+			( void ) xMessageBufferReceive( xBuffer, ucReceived, sizeof( ucReceived ), 0 );
+		}
+		else
+		{
+			( void ) xStreamBufferSend( xBuffer, ucData, xIndex, 0 );
+			( void ) xStreamBufferReceive( xBuffer, ucReceived, xIndex, 0 );
+		}
+	}
+
+	configASSERT( xStreamBufferIsEmpty( xBuffer ) != pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestStreamBuffer( void )
+{
+StreamBufferRegion_t xRegion;
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+size_t xBytes;
+
+	/* A reservation that crosses the end of the storage area. */
+	prvMoveTo( xStreamBuffer, 30 );
+	prvFillData( 20 );
+	xBytes = xStreamBufferSendReserve( xStreamBuffer, 20, &xRegion, 0 );
+	prvCheck( xBytes == 20, "stream reserve across the end returns all the bytes" );
+	prvCheckRegion( &xRegion, &( ucStreamStorage[ 30 ] ), 8, ucStreamStorage, 12, "stream reserve across the end returns two spans" );
+	prvCheck( xStreamBufferBytesAvailable( xStreamBuffer ) == 0, "reserved bytes are not available before commit" );
+	prvWriteRegion( &xRegion, 20 );
+	prvCheck( xStreamBufferSendCommit( xStreamBuffer, 20 ) == 20, "stream commit across the end" );
+	prvCheck( xStreamBufferReceive( xStreamBuffer, ucReceived, sizeof( ucReceived ), 0 ) == 20, "bytes committed across the end are received" );
+	prvCheck( memcmp( ucReceived, ucData, 20 ) == 0, "bytes committed across the end are received in order" );
+
+	/* Committing fewer bytes than were reserved. */
+	prvMoveTo( xStreamBuffer, 34 );
+	prvFillData( 10 );
+	xBytes = xStreamBufferSendReserve( xStreamBuffer, 10, &xRegion, 0 );
+	prvCheckRegion( &xRegion, &( ucStreamStorage[ 34 ] ), 4, ucStreamStorage, 6, "stream reserve of 10 bytes at index 34" );
+	prvWriteRegion( &xRegion, 6 );
+	prvCheck( ( xBytes == 10 ) && ( xStreamBufferSendCommit( xStreamBuffer, 6 ) == 6 ), "stream partial commit" );
+	prvCheck( xStreamBufferBytesAvailable( xStreamBuffer ) == 6, "only the committed bytes are available" );
+	prvCheck( ( xStreamBufferReceive( xStreamBuffer, ucReceived, sizeof( ucReceived ), 0 ) == 6 ) && ( memcmp( ucReceived, ucData, 6 ) == 0 ), "partially committed bytes are received in order" );
+
+	/* A stream buffer reserves as much as is free. */
+	prvMoveTo( xStreamBuffer, 10 );
+	( void ) xStreamBufferSend( xStreamBuffer, ucData, 30, 0 );
+	xBytes = xStreamBufferSendReserve( xStreamBuffer, 20, &xRegion, 0 );
+	prvCheckRegion( &xRegion, &( ucStreamStorage[ 2 ] ), 7, NULL, 0, "stream reserve is limited to the free space" );
+	prvCheck( ( xBytes == 7 ) && ( xStreamBufferSendCommit( xStreamBuffer, 0 ) == 0 ), "stream reserve of the free space" );
+	prvCheck( xStreamBufferBytesAvailable( xStreamBuffer ) == 30, "committing nothing leaves the buffer unchanged" );
+
+	/* Acquiring data that crosses the end of the storage area, then releasing
+	it in two parts. */
+	prvMoveTo( xStreamBuffer, 25 );
+	prvFillData( 25 );
+	( void ) xStreamBufferSend( xStreamBuffer, ucData, 25, 0 );
+	xBytes = xStreamBufferReceiveAcquire( xStreamBuffer, &xRegion, 0 );
+	prvCheckRegion( &xRegion, &( ucStreamStorage[ 25 ] ), 13, ucStreamStorage, 12, "stream acquire across the end returns two spans" );
+	prvCheck( ( xBytes == 25 ) && ( prvRegionMatches( &xRegion ) != pdFALSE ), "stream acquire across the end returns the bytes in order" );
+	prvCheck( xStreamBufferReceiveRelease( xStreamBuffer, 15 ) == 15, "stream partial release" );
+	xBytes = xStreamBufferReceiveAcquire( xStreamBuffer, &xRegion, 0 );
+	prvCheckRegion( &xRegion, &( ucStreamStorage[ 2 ] ), 10, NULL, 0, "stream acquire after a partial release" );
+	prvCheck( ( xBytes == 10 ) && ( memcmp( xRegion.pucFirst, &( ucData[ 15 ] ), 10 ) == 0 ), "stream acquire after a partial release returns the rest" );
+	prvCheck( ( xStreamBufferReceiveRelease( xStreamBuffer, 10 ) == 10 ) && ( xStreamBufferIsEmpty( xStreamBuffer ) != pdFALSE ), "stream release of the rest" );
+
+	/* The FromISR versions across the end. */
+	prvMoveTo( xStreamBuffer, 35 );
+	prvFillData( 9 );
+	xBytes = xStreamBufferSendReserveFromISR( xStreamBuffer, 9, &xRegion );
+	prvCheckRegion( &xRegion, &( ucStreamStorage[ 35 ] ), 3, ucStreamStorage, 6, "stream reserve from ISR across the end" );
+	prvWriteRegion( &xRegion, 9 );
+	prvCheck( ( xBytes == 9 ) && ( xStreamBufferSendCommitFromISR( xStreamBuffer, 9, &xHigherPriorityTaskWoken ) == 9 ), "stream commit from ISR" );
+	xBytes = xStreamBufferReceiveAcquireFromISR( xStreamBuffer, &xRegion );
+	prvCheck( ( xBytes == 9 ) && ( prvRegionMatches( &xRegion ) != pdFALSE ), "stream acquire from ISR returns the committed bytes" );
+	prvCheck( xStreamBufferReceiveReleaseFromISR( xStreamBuffer, 9, &xHigherPriorityTaskWoken ) == 9, "stream release from ISR" );
+	prvCheck( xHigherPriorityTaskWoken == pdFALSE, "no task is woken when no task is waiting" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestMessageBuffer( void )
+{
+StreamBufferRegion_t xRegion;
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+configMESSAGE_BUFFER_LENGTH_TYPE xLength;
+size_t xBytes, xIndex;
+
+	/* The length of the message crosses the end of the storage area, so the
+	message itself starts part way into the storage area. */
+	xIndex = testMESSAGE_STORAGE_SIZE - ( testLENGTH_BYTES / 2 );
+	prvMoveTo( xMessageBuffer, xIndex );
+	prvFillData( 10 );
+	xBytes = xMessageBufferSendReserve( xMessageBuffer, 10, &xRegion, 0 );
+	prvCheckRegion( &xRegion, &( ucMessageStorage[ testLENGTH_BYTES / 2 ] ), 10, NULL, 0, "message reserve leaves room for a length that crosses the end" );
+	prvWriteRegion( &xRegion, 10 );
+	prvCheck( ( xBytes == 10 ) && ( xMessageBufferSendCommit( xMessageBuffer, 10 ) == 10 ), "message commit with a length that crosses the end" );
+
+	/* The length is stored in the byte order of the host, split across the
+	end of the storage area. */
+	memcpy( &xLength, &( ucMessageStorage[ xIndex ] ), testLENGTH_BYTES - ( testLENGTH_BYTES / 2 ) );
+	memcpy( ( ( uint8_t * ) &xLength ) + ( testLENGTH_BYTES - ( testLENGTH_BYTES / 2 ) ), ucMessageStorage, testLENGTH_BYTES / 2 );
+	prvCheck( xLength == 10, "commit writes the message length across the end" );
+	prvCheck( xStreamBufferNextMessageLengthBytes( xMessageBuffer ) == 10, "the committed length is the next message length" );
+	prvCheck( ( xMessageBufferReceive( xMessageBuffer, ucReceived, sizeof( ucReceived ), 0 ) == 10 ) && ( memcmp( ucReceived, ucData, 10 ) == 0 ), "message committed with a wrapped length is received" );
+
+	/* The length fits before the end of the storage area, but the message
+	crosses it.  Fewer bytes are committed than were reserved. */
+	xIndex = testMESSAGE_STORAGE_SIZE - testLENGTH_BYTES - 4;
+	prvMoveTo( xMessageBuffer, xIndex );
+	prvFillData( 20 );
+	xBytes = xMessageBufferSendReserve( xMessageBuffer, 20, &xRegion, 0 );
+	prvCheckRegion( &xRegion, &( ucMessageStorage[ xIndex + testLENGTH_BYTES ] ), 4, ucMessageStorage, 16, "message reserve across the end returns two spans" );
+	prvWriteRegion( &xRegion, 12 );
+	prvCheck( ( xBytes == 20 ) && ( xMessageBufferSendCommit( xMessageBuffer, 12 ) == 12 ), "message partial commit across the end" );
+	memcpy( &xLength, &( ucMessageStorage[ xIndex ] ), testLENGTH_BYTES );
+	prvCheck( xLength == 12, "commit writes the committed length, not the reserved length" );
+	prvCheck( xStreamBufferBytesAvailable( xMessageBuffer ) == ( 12 + testLENGTH_BYTES ), "only the committed message is available" );
+	prvCheck( ( xMessageBufferReceive( xMessageBuffer, ucReceived, sizeof( ucReceived ), 0 ) == 12 ) && ( memcmp( ucReceived, ucData, 12 ) == 0 ), "message committed across the end is received in order" );
+
+	/* Committing 0 bytes discards the message. */
+	prvMoveTo( xMessageBuffer, 20 );
+	xBytes = xMessageBufferSendReserve( xMessageBuffer, 8, &xRegion, 0 );
+	prvCheck( ( xBytes == 8 ) && ( xMessageBufferSendCommit( xMessageBuffer, 0 ) == 0 ), "message commit of 0 bytes" );
+	prvCheck( xMessageBufferIsEmpty( xMessageBuffer ) != pdFALSE, "committing 0 bytes discards the message" );
+
+	/* A message buffer reserves space for the whole message or nothing. */
+	prvMoveTo( xMessageBuffer, 0 );
+	( void ) xMessageBufferSend( xMessageBuffer, ucData, 30, 0 );
+	xBytes = xMessageBufferSendReserve( xMessageBuffer, testMESSAGE_BUFFER_SIZE - ( 30 + ( 2 * testLENGTH_BYTES ) ) + 1, &xRegion, 0 );
+	prvCheckRegion( &xRegion, &( ucMessageStorage[ 30 + testLENGTH_BYTES ] ), 0, NULL, 0, "message reserve of more than the free space returns zero length spans" );
+	prvCheck( xBytes == 0, "message reserve of more than the free space reserves nothing" );
+	xBytes = xMessageBufferSendReserve( xMessageBuffer, testMESSAGE_BUFFER_SIZE - ( 30 + ( 2 * testLENGTH_BYTES ) ), &xRegion, 0 );
+	prvCheck( xBytes == ( testMESSAGE_BUFFER_SIZE - ( 30 + ( 2 * testLENGTH_BYTES ) ) ), "message reserve of exactly the free space" );
+	( void ) xMessageBufferSendCommit( xMessageBuffer, 0 );
+
+	/* Acquiring a message sent across the end skips its length. */
+	xIndex = testMESSAGE_STORAGE_SIZE - testLENGTH_BYTES - 6;
+	prvMoveTo( xMessageBuffer, xIndex );
+	prvFillData( 15 );
+	( void ) xMessageBufferSend( xMessageBuffer, ucData, 15, 0 );
+	xBytes = xMessageBufferReceiveAcquire( xMessageBuffer, &xRegion, 0 );
+	prvCheckRegion( &xRegion, &( ucMessageStorage[ xIndex + testLENGTH_BYTES ] ), 6, ucMessageStorage, 9, "message acquire skips the length" );
+	prvCheck( ( xBytes == 15 ) && ( prvRegionMatches( &xRegion ) != pdFALSE ), "message acquire across the end returns the message in order" );
+	prvCheck( ( xMessageBufferReceiveRelease( xMessageBuffer, 15 ) == 15 ) && ( xMessageBufferIsEmpty( xMessageBuffer ) != pdFALSE ), "message release removes the length and the message" );
+
+	/* The FromISR versions, with the length crossing the end. */
+	xIndex = testMESSAGE_STORAGE_SIZE - 1;
+	prvMoveTo( xMessageBuffer, xIndex );
+	prvFillData( 5 );
+	xBytes = xMessageBufferSendReserveFromISR( xMessageBuffer, 5, &xRegion );
+	prvCheckRegion( &xRegion, &( ucMessageStorage[ testLENGTH_BYTES - 1 ] ), 5, NULL, 0, "message reserve from ISR" );
+	prvWriteRegion( &xRegion, 5 );
+	prvCheck( ( xBytes == 5 ) && ( xMessageBufferSendCommitFromISR( xMessageBuffer, 5, &xHigherPriorityTaskWoken ) == 5 ), "message commit from ISR" );
+	xBytes = xMessageBufferReceiveAcquireFromISR( xMessageBuffer, &xRegion );
+	prvCheck( ( xBytes == 5 ) && ( prvRegionMatches( &xRegion ) != pdFALSE ), "message acquire from ISR returns the committed message" );
+	prvCheck( xMessageBufferReceiveReleaseFromISR( xMessageBuffer, 5, &xHigherPriorityTaskWoken ) == 5, "message release from ISR" );
+	prvCheck( xHigherPriorityTaskWoken == pdFALSE, "no task is woken when no task is waiting" );
+}
+/*-----------------------------------------------------------*/
+
+static uint8_t *prvFindStorage( StreamBufferHandle_t xBuffer, size_t xOffset )
+{
+StreamBufferRegion_t xRegion;
+
+	/* The space reserved in a reset buffer starts at the start of its storage
+	area, after the length of the message in the case of a message buffer. */
+	( void ) xStreamBufferReset( xBuffer );
+	( void ) xStreamBufferSendReserve( xBuffer, 1, &xRegion, 0 );
+	( void ) xStreamBufferSendCommit( xBuffer, 0 );
+
+	return xRegion.pucFirst - xOffset;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	ucStreamStorage = prvFindStorage( xStreamBuffer, 0 );
+	ucMessageStorage = prvFindStorage( xMessageBuffer, testLENGTH_BYTES );
+
+	prvTestStreamBuffer();
+	prvTestMessageBuffer();
+
+	taskENTER_CRITICAL();
+	{
+		if( ulErrors == 0 )
+		{
+			printf( "PASS: %lu checks\n", ( unsigned long ) ulChecks );
+		}
+		else
+		{
+			printf( "FAIL: %lu of %lu checks\n", ( unsigned long ) ulErrors, ( unsigned long ) ulChecks );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	xStreamBuffer = xStreamBufferCreate( testSTREAM_BUFFER_SIZE, 1 );
+	xMessageBuffer = xMessageBufferCreate( testMESSAGE_BUFFER_SIZE );
+	configASSERT( xStreamBuffer );
+	configASSERT( xMessageBuffer );
+
+	xTaskCreate( prvTestTask, "Test", testSTACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
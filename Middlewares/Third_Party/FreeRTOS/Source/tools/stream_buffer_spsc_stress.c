@@ -0,0 +1,314 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side stress test for configUSE_LOCK_FREE_STREAM_BUFFERS.  The scheduler
+ * is not started.  Instead a producer thread and a consumer thread share each
+ * of a stream buffer and a message buffer, and run truly in parallel on the
+ * host's cores, so the only thing keeping them apart is the ordering of the
+ * head and tail updates.  The buffers are small and have sizes that are not a
+ * power of two, so the data wraps around the end of the storage area millions
+ * of times, at every possible offset.
+ *
+ * + The stream producer writes a running byte count, in chunks of random
+ *   length, using xStreamBufferSendFromISR() or reserve/commit.  The stream
+ *   consumer reads chunks of random length, using xStreamBufferReceiveFromISR()
+ *   or acquire/release, and checks every byte is the next in the sequence.
+ * + The message producer writes messages whose length and contents follow
+ *   from a running message count.  The message consumer checks the length and
+ *   every byte of each message it receives.
+ *
+ * Only the FromISR functions are used, as the others may block, and no task
+ * ever waits on either buffer.  The test passes if every byte and every
+ * message arrived intact and in order.
+ *
+ * Build with the POSIX port and any heap implementation, using a
+ * FreeRTOSConfig.h that sets configUSE_LOCK_FREE_STREAM_BUFFERS to 1.  Other
+ * lengths can be given on the command line, for example with
+ * -DtestSTREAM_BYTES=1000000000UL.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+
+#if( configUSE_LOCK_FREE_STREAM_BUFFERS != 1 )
+	#error This test runs the writer and reader truly in parallel, so needs configUSE_LOCK_FREE_STREAM_BUFFERS set to 1.
+#endif
+
+#ifndef testSTREAM_BYTES
+	#define testSTREAM_BYTES		100000000UL
+#endif
+
+#ifndef testMESSAGES
+	#define testMESSAGES			10000000UL
+#endif
+
+#define testSTREAM_BUFFER_SIZE		61
+#define testMESSAGE_BUFFER_SIZE		77
+#define testMAX_CHUNK				50
+#define testMAX_MESSAGE				29
+
+static StreamBufferHandle_t xStreamBuffer = NULL;
+static MessageBufferHandle_t xMessageBuffer = NULL;
+
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRandom( uint32_t *pulSeed )
+{
+	*pulSeed = ( *pulSeed * 1103515245UL ) + 12345UL;
+	return *pulSeed >> 8;
+}
+/*-----------------------------------------------------------*/
+
+static uint8_t *prvRegionByte( const StreamBufferRegion_t *pxRegion, size_t xIndex )
+{
+	if( xIndex < pxRegion->xFirstLengthBytes )
+	{
+		return &( pxRegion->pucFirst[ xIndex ] );
+	}
+	else
+	{
+		return &( pxRegion->pucSecond[ xIndex - pxRegion->xFirstLengthBytes ] );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvFail( const char *pcWhat, unsigned long ulWhere )
+{
+	printf( "FAIL: %s at %lu\n", pcWhat, ulWhere );
+	exit( EXIT_FAILURE );
+}
+/*-----------------------------------------------------------*/
+
+static void *prvStreamProducer( void *pvParameters )
+{
+uint32_t ulSent = 0, ulSeed = 1;
+uint8_t ucChunk[ testMAX_CHUNK ];
+StreamBufferRegion_t xRegion;
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+size_t xLength, xSent, x;
+
+	( void ) pvParameters;
+
+	while( ulSent < testSTREAM_BYTES )
+	{
+		xLength = 1 + ( prvRandom( &ulSeed ) % testMAX_CHUNK );
+
+		if( xLength > ( testSTREAM_BYTES - ulSent ) )
+		{
+			xLength = testSTREAM_BYTES - ulSent;
+		}
+
+		if( ( prvRandom( &ulSeed ) & 1UL ) != 0 )
+		{
+			/* Write in place. */
+			xSent = xStreamBufferSendReserveFromISR( xStreamBuffer, xLength, &xRegion );
+
+			for( x = 0; x < xSent; x++ )
+			{
+				*prvRegionByte( &xRegion, x ) = ( uint8_t ) ( ulSent + x );
+			}
+
+			xSent = xStreamBufferSendCommitFromISR( xStreamBuffer, xSent, &xHigherPriorityTaskWoken );
+		}
+		else
+		{
+			for( x = 0; x < xLength; x++ )
+			{
+				ucChunk[ x ] = ( uint8_t ) ( ulSent + x );
+			}
+
+			xSent = xStreamBufferSendFromISR( xStreamBuffer, ucChunk, xLength, &xHigherPriorityTaskWoken );
+		}
+
+		ulSent += ( uint32_t ) xSent;
+
+		if( xSent == 0 )
+		{
+			/* Full, so let the consumer run if it shares the core. */
+			sched_yield();
+		}
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvStreamConsumer( void *pvParameters )
+{
+uint32_t ulReceived = 0, ulSeed = 2;
+uint8_t ucChunk[ testMAX_CHUNK ];
+StreamBufferRegion_t xRegion;
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+size_t xReceived, x;
+
+	( void ) pvParameters;
+
+	while( ulReceived < testSTREAM_BYTES )
+	{
+		if( ( prvRandom( &ulSeed ) & 1UL ) != 0 )
+		{
+			/* Read in place. */
+			xReceived = xStreamBufferReceiveAcquireFromISR( xStreamBuffer, &xRegion );
+
+			for( x = 0; x < xReceived; x++ )
+			{
+				if( *prvRegionByte( &xRegion, x ) != ( uint8_t ) ( ulReceived + x ) )
+				{
+					prvFail( "acquired stream byte out of order", ( unsigned long ) ( ulReceived + x ) );
+				}
+			}
+
+			xReceived = xStreamBufferReceiveReleaseFromISR( xStreamBuffer, xReceived, &xHigherPriorityTaskWoken );
+		}
+		else
+		{
+			xReceived = xStreamBufferReceiveFromISR( xStreamBuffer, ucChunk, 1 + ( prvRandom( &ulSeed ) % testMAX_CHUNK ), &xHigherPriorityTaskWoken );
+
+			for( x = 0; x < xReceived; x++ )
+			{
+				if( ucChunk[ x ] != ( uint8_t ) ( ulReceived + x ) )
+				{
+					prvFail( "received stream byte out of order", ( unsigned long ) ( ulReceived + x ) );
+				}
+			}
+		}
+
+		ulReceived += ( uint32_t ) xReceived;
+
+		if( xReceived == 0 )
+		{
+			sched_yield();
+		}
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvMessageProducer( void *pvParameters )
+{
+uint32_t ulSent = 0;
+uint8_t ucMessage[ testMAX_MESSAGE ];
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+size_t xLength, x;
+
+	( void ) pvParameters;
+
+	while( ulSent < testMESSAGES )
+	{
+		xLength = 1 + ( ulSent % testMAX_MESSAGE );
+
+		for( x = 0; x < xLength; x++ )
+		{
+			ucMessage[ x ] = ( uint8_t ) ( ( ulSent * 7UL ) + x );
+		}
+
+		if( xMessageBufferSendFromISR( xMessageBuffer, ucMessage, xLength, &xHigherPriorityTaskWoken ) == xLength )
+		{
+			ulSent++;
+		}
+		else
+		{
+			sched_yield();
+		}
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvMessageConsumer( void *pvParameters )
+{
+uint32_t ulReceived = 0;
+uint8_t ucMessage[ testMAX_MESSAGE ];
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+size_t xLength, x;
+
+	( void ) pvParameters;
+
+	while( ulReceived < testMESSAGES )
+	{
+		xLength = xMessageBufferReceiveFromISR( xMessageBuffer, ucMessage, sizeof( ucMessage ), &xHigherPriorityTaskWoken );
+
+		if( xLength == 0 )
+		{
+			sched_yield();
+			continue;
+		}
+
+		if( xLength != ( 1 + ( ulReceived % testMAX_MESSAGE ) ) )
+		{
+			prvFail( "wrong message length", ( unsigned long ) ulReceived );
+		}
+
+		for( x = 0; x < xLength; x++ )
+		{
+			if( ucMessage[ x ] != ( uint8_t ) ( ( ulReceived * 7UL ) + x ) )
+			{
+				prvFail( "wrong message contents", ( unsigned long ) ulReceived );
+			}
+		}
+
+		ulReceived++;
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+pthread_t xThreads[ 4 ];
+size_t x;
+
+	xStreamBuffer = xStreamBufferCreate( testSTREAM_BUFFER_SIZE, 1 );
+	xMessageBuffer = xMessageBufferCreate( testMESSAGE_BUFFER_SIZE );
+	configASSERT( xStreamBuffer );
+	configASSERT( xMessageBuffer );
+
+	pthread_create( &( xThreads[ 0 ] ), NULL, prvStreamProducer, NULL );
+	pthread_create( &( xThreads[ 1 ] ), NULL, prvStreamConsumer, NULL );
+	pthread_create( &( xThreads[ 2 ] ), NULL, prvMessageProducer, NULL );
+	pthread_create( &( xThreads[ 3 ] ), NULL, prvMessageConsumer, NULL );
+
+	for( x = 0; x < ( sizeof( xThreads ) / sizeof( xThreads[ 0 ] ) ); x++ )
+	{
+		pthread_join( xThreads[ x ], NULL );
+	}
+
+	printf( "PASS: %lu stream bytes, %lu messages\n", ( unsigned long ) testSTREAM_BYTES, ( unsigned long ) testMESSAGES );
+
+	return EXIT_SUCCESS;
+}
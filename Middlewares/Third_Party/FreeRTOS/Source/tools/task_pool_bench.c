@@ -0,0 +1,273 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side benchmark of task pools, for a design in which a task is created
+ * to handle each request and deleted when the request is complete.  The
+ * dispatcher task creates a higher priority worker, which runs immediately,
+ * then deletes it, and the median number of cycles taken to create, run and
+ * delete a worker is reported for workers created by xTaskCreate(), and by
+ * xTaskCreateFromPool() from a pool that refills its stacks and from one that
+ * does not.  It then checks that a pool recycles workers that delete
+ * themselves without the idle task running, leaving other tasks that deleted
+ * themselves for the idle task, that a pool that is in use does not allocate
+ * any heap, and that a pool with every task in use refuses to create another.
+ *
+ * Build with the POSIX port and heap_4, using a FreeRTOSConfig.h that sets
+ * configUSE_TASK_POOLS and INCLUDE_vTaskDelete to 1.  Stacks are only filled if
+ * configUSE_TRACE_FACILITY, configCHECK_FOR_STACK_OVERFLOW > 1 or one of the
+ * INCLUDE_uxTaskGetStackHighWaterMark options is also set.  On the POSIX port
+ * the cost of each task includes creating and joining a host thread, which is
+ * the same whichever way the task is created.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define benchSAMPLES				2000UL
+#define benchPOOL_SIZE				4U
+#define benchDISPATCHER_PRIORITY	( tskIDLE_PRIORITY + 2 )
+#define benchWORKER_PRIORITY		( tskIDLE_PRIORITY + 3 )
+
+/* The stack size of every task, which must be at least PTHREAD_STACK_MIN
+bytes. */
+#define benchSTACK_SIZE				( ( configSTACK_DEPTH_TYPE ) ( 65536 / sizeof( StackType_t ) ) )
+
+static volatile uint32_t ulRequestsServed = 0;
+static uint64_t ullCycles[ benchSAMPLES ];
+
+/*-----------------------------------------------------------*/
+
+static void prvBlockingWorkerTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	ulRequestsServed++;
+
+	/* Wait to be deleted by the dispatcher. */
+	for( ;; )
+	{
+		( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSelfDeletingWorkerTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	ulRequestsServed++;
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareCycles( const void *pv1, const void *pv2 )
+{
+uint64_t ull1 = *( const uint64_t * ) pv1, ull2 = *( const uint64_t * ) pv2;
+
+	return ( ull1 > ull2 ) - ( ull1 < ull2 );
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvTimeWorkers( TaskPoolHandle_t xPool, uint32_t *pulErrors )
+{
+TaskHandle_t xWorker = NULL;
+BaseType_t xResult;
+uint32_t ulSample, ulServed;
+uint64_t ullStart;
+
+	for( ulSample = 0; ulSample < benchSAMPLES; ulSample++ )
+	{
+		ulServed = ulRequestsServed;
+		ullStart = ullPortGetCycleCounter();
+
+		if( xPool == NULL )
+		{
+			xResult = xTaskCreate( prvBlockingWorkerTask, "Worker", benchSTACK_SIZE, NULL, benchWORKER_PRIORITY, &xWorker );
+		}
+		else
+		{
+			xResult = xTaskCreateFromPool( xPool, prvBlockingWorkerTask, "Worker", NULL, benchWORKER_PRIORITY, &xWorker );
+		}
+
+		if( ( xResult != pdPASS ) || ( ulRequestsServed != ( ulServed + 1UL ) ) )
+		{
+			( *pulErrors )++;
+			break;
+		}
+
+		vTaskDelete( xWorker );
+		ullCycles[ ulSample ] = ullPortGetCycleCounter() - ullStart;
+	}
+
+	qsort( ullCycles, benchSAMPLES, sizeof( ullCycles[ 0 ] ), prvCompareCycles );
+
+	return ullCycles[ benchSAMPLES / 2 ];
+}
+/*-----------------------------------------------------------*/
+
+static void prvDispatcherTask( void *pvParameters )
+{
+TaskPoolHandle_t xFilledPool, xUnfilledPool;
+TaskHandle_t xWorkers[ benchPOOL_SIZE ];
+uint64_t ullCreate, ullFilledPool, ullUnfilledPool;
+uint32_t ulErrors = 0, ulRequest, ulServed;
+size_t xFreeHeap;
+UBaseType_t x;
+
+	( void ) pvParameters;
+
+	xFilledPool = xTaskPoolCreate( benchPOOL_SIZE, benchSTACK_SIZE, pdTRUE );
+	xUnfilledPool = xTaskPoolCreate( benchPOOL_SIZE, benchSTACK_SIZE, pdFALSE );
+	configASSERT( xFilledPool );
+	configASSERT( xUnfilledPool );
+
+	ullCreate = prvTimeWorkers( NULL, &ulErrors );
+
+	/* Once the pools exist, using them must not allocate any heap. */
+	xFreeHeap = xPortGetFreeHeapSize();
+	ullFilledPool = prvTimeWorkers( xFilledPool, &ulErrors );
+	ullUnfilledPool = prvTimeWorkers( xUnfilledPool, &ulErrors );
+
+	printf( "xTaskCreate():                     median %lu cycles to create, run and delete a worker\n", ( unsigned long ) ullCreate );
+	printf( "pool that refills stacks:          median %lu cycles\n", ( unsigned long ) ullFilledPool );
+	printf( "pool that does not refill stacks:  median %lu cycles\n", ( unsigned long ) ullUnfilledPool );
+
+	/* Workers that delete themselves are recycled by xTaskCreateFromPool()
+	when the pool is empty.  The dispatcher never blocks, so the idle task
+	cannot run to clean up the deleted workers. */
+	ulServed = ulRequestsServed;
+
+	for( ulRequest = 0; ulRequest < benchSAMPLES; ulRequest++ )
+	{
+		if( xTaskCreateFromPool( xUnfilledPool, prvSelfDeletingWorkerTask, "Worker", NULL, benchWORKER_PRIORITY, NULL ) != pdPASS )
+		{
+			printf( "self deleting worker %lu could not be created\n", ( unsigned long ) ulRequest );
+			ulErrors++;
+			break;
+		}
+	}
+
+	if( ulRequestsServed != ( ulServed + benchSAMPLES ) )
+	{
+		printf( "%lu of %lu self deleting workers ran\n", ( unsigned long ) ( ulRequestsServed - ulServed ), ( unsigned long ) benchSAMPLES );
+		ulErrors++;
+	}
+
+	/* A worker is only recycled when the pool is empty, so every worker from
+	the pool is now waiting for the idle task.  A pool only recycles its own
+	workers, so emptying the other pool, and deleting a task that was not
+	created from a pool, must leave them waiting. */
+	if( xTaskCreate( prvSelfDeletingWorkerTask, "Worker", benchSTACK_SIZE, NULL, benchWORKER_PRIORITY, NULL ) != pdPASS )
+	{
+		ulErrors++;
+	}
+
+	for( ulRequest = 0; ulRequest < ( 2U * benchPOOL_SIZE ); ulRequest++ )
+	{
+		if( xTaskCreateFromPool( xFilledPool, prvSelfDeletingWorkerTask, "Worker", NULL, benchWORKER_PRIORITY, NULL ) != pdPASS )
+		{
+			printf( "self deleting worker %lu could not be created from the other pool\n", ( unsigned long ) ulRequest );
+			ulErrors++;
+			break;
+		}
+	}
+
+	if( uxTaskPoolGetFreeCount( xUnfilledPool ) != 0U )
+	{
+		printf( "%lu tasks free in the pool before the idle task ran, expected 0\n", ( unsigned long ) uxTaskPoolGetFreeCount( xUnfilledPool ) );
+		ulErrors++;
+	}
+
+	/* Let the idle task clean up the workers that are still waiting. */
+	vTaskDelay( 2 );
+
+	if( ( uxTaskPoolGetFreeCount( xUnfilledPool ) != benchPOOL_SIZE ) || ( uxTaskPoolGetFreeCount( xFilledPool ) != benchPOOL_SIZE ) )
+	{
+		printf( "%lu and %lu tasks free in the pools, expected %lu\n", ( unsigned long ) uxTaskPoolGetFreeCount( xFilledPool ), ( unsigned long ) uxTaskPoolGetFreeCount( xUnfilledPool ), ( unsigned long ) benchPOOL_SIZE );
+		ulErrors++;
+	}
+
+	if( xPortGetFreeHeapSize() != xFreeHeap )
+	{
+		printf( "the free heap changed from %lu to %lu bytes while using the pools\n", ( unsigned long ) xFreeHeap, ( unsigned long ) xPortGetFreeHeapSize() );
+		ulErrors++;
+	}
+
+	/* A pool with every task in use cannot create another. */
+	for( x = 0; x < benchPOOL_SIZE; x++ )
+	{
+		if( xTaskCreateFromPool( xFilledPool, prvBlockingWorkerTask, "Worker", NULL, benchWORKER_PRIORITY, &( xWorkers[ x ] ) ) != pdPASS )
+		{
+			ulErrors++;
+		}
+	}
+
+	if( xTaskCreateFromPool( xFilledPool, prvBlockingWorkerTask, "Worker", NULL, benchWORKER_PRIORITY, NULL ) != errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY )
+	{
+		printf( "a task was created from an empty pool\n" );
+		ulErrors++;
+	}
+
+	/* Tasks deleted by another task are returned to the pool at once. */
+	for( x = 0; x < benchPOOL_SIZE; x++ )
+	{
+		vTaskDelete( xWorkers[ x ] );
+
+		if( uxTaskPoolGetFreeCount( xFilledPool ) != ( x + 1U ) )
+		{
+			ulErrors++;
+		}
+	}
+
+	taskENTER_CRITICAL();
+	{
+		if( ulErrors == 0 )
+		{
+			printf( "PASS: %lu requests served\n", ( unsigned long ) ulRequestsServed );
+		}
+		else
+		{
+			printf( "FAIL: %lu errors\n", ( unsigned long ) ulErrors );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	xTaskCreate( prvDispatcherTask, "Dispatcher", benchSTACK_SIZE, NULL, benchDISPATCHER_PRIORITY, NULL );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
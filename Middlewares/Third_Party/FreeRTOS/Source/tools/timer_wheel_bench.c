@@ -0,0 +1,194 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side benchmark for the timer service task with 10, 100 and 1000 active
+ * auto-reload timers, each with a random period of 1 to 100 ticks.  The
+ * benchmark task, which runs just below the timer service task, generates each
+ * tick itself by calling xTaskIncrementTick() with interrupts masked, as the
+ * tick interrupt does, then yields so the timer service task processes the
+ * timers that expired and re-inserts them in the active timers.  The time from
+ * the tick to the benchmark task running again is taken as the CPU used by
+ * the timer service task for that tick, and the mean over all ticks, leaving
+ * out the 1% longest that the host interrupted, is reported.  The figure
+ * includes the tick itself and the two context switches on ticks that woke the
+ * timer service task.
+ *
+ * Without configUSE_TIMER_WHEEL each expired timer is re-inserted into a list
+ * sorted by expiry time, so the time per tick grows with the square of the
+ * number of timers.  The test passes if every timer expired the expected
+ * number of times.
+ *
+ * Build twice with the POSIX port and any heap implementation, using a
+ * FreeRTOSConfig.h that sets configUSE_TIMERS to 1, configUSE_DYNAMIC_TICK to
+ * 0, configTIMER_TASK_PRIORITY to configMAX_PRIORITIES - 1, and
+ * configUSE_TIMER_WHEEL to 0 and then to 1, and compare the results.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+#if( configUSE_DYNAMIC_TICK != 0 )
+	#error This benchmark calls xTaskIncrementTick() directly, so needs configUSE_DYNAMIC_TICK set to 0.
+#endif
+
+#if( configTIMER_TASK_PRIORITY != ( configMAX_PRIORITIES - 1 ) )
+	#error configTIMER_TASK_PRIORITY must be configMAX_PRIORITIES - 1 for this benchmark.
+#endif
+
+#define benchMAX_TIMERS			1000
+#define benchTICKS				5000UL
+#define benchMAX_PERIOD			100UL
+
+/* The stack size, which must be at least PTHREAD_STACK_MIN bytes. */
+#define benchSTACK_SIZE			( ( configSTACK_DEPTH_TYPE ) ( 32768 / sizeof( StackType_t ) ) )
+
+static const UBaseType_t uxTimerCounts[] = { 10, 100, benchMAX_TIMERS };
+
+#define benchTIMER_COUNT_STEPS	( sizeof( uxTimerCounts ) / sizeof( uxTimerCounts[ 0 ] ) )
+
+static TickType_t xPeriods[ benchMAX_TIMERS ];
+static volatile uint32_t ulExpiries[ benchMAX_TIMERS ];
+static uint64_t ullTickCycles[ benchTICKS ];
+
+/*-----------------------------------------------------------*/
+
+static void prvTimerCallback( TimerHandle_t xTimer )
+{
+	ulExpiries[ ( UBaseType_t ) pvTimerGetTimerID( xTimer ) ]++;
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareCycles( const void *pv1, const void *pv2 )
+{
+uint64_t ull1 = *( const uint64_t * ) pv1, ull2 = *( const uint64_t * ) pv2;
+
+	return ( ull1 > ull2 ) - ( ull1 < ull2 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void *pvParameters )
+{
+UBaseType_t uxStep, uxTimer, uxCreated = 0;
+uint32_t ulTick, ulErrors = 0, ulSeed = 1, ulExpected;
+uint64_t ullStart, ullTotal;
+TimerHandle_t xTimer;
+
+	( void ) pvParameters;
+
+	for( uxStep = 0; uxStep < benchTIMER_COUNT_STEPS; uxStep++ )
+	{
+		/* The timer service task has the higher priority, so it processes
+		each start command before xTimerStart() returns. */
+		while( uxCreated < uxTimerCounts[ uxStep ] )
+		{
+			ulSeed = ( ulSeed * 1103515245UL ) + 12345UL;
+			xPeriods[ uxCreated ] = ( TickType_t ) ( 1 + ( ( ulSeed >> 16 ) % benchMAX_PERIOD ) );
+			xTimer = xTimerCreate( "Bench", xPeriods[ uxCreated ], pdTRUE, ( void * ) uxCreated, prvTimerCallback );
+
+			if( ( xTimer == NULL ) || ( xTimerStart( xTimer, portMAX_DELAY ) != pdPASS ) )
+			{
+				ulErrors++;
+				break;
+			}
+
+			uxCreated++;
+		}
+
+		for( uxTimer = 0; uxTimer < uxCreated; uxTimer++ )
+		{
+			ulExpiries[ uxTimer ] = 0;
+		}
+
+		for( ulTick = 0; ulTick < benchTICKS; ulTick++ )
+		{
+			ullStart = ullPortGetCycleCounter();
+
+			portDISABLE_INTERRUPTS();
+			{
+				( void ) xTaskIncrementTick();
+			}
+			portENABLE_INTERRUPTS();
+
+			/* Let the timer service task run if the tick unblocked it. */
+			taskYIELD();
+
+			ullTickCycles[ ulTick ] = ullPortGetCycleCounter() - ullStart;
+		}
+
+		/* Each timer expires once per period, give or take one expiry for
+		where in its period the measurement started and ended. */
+		for( uxTimer = 0; uxTimer < uxCreated; uxTimer++ )
+		{
+			ulExpected = benchTICKS / ( uint32_t ) xPeriods[ uxTimer ];
+
+			if( ( ulExpiries[ uxTimer ] + 1 < ulExpected ) || ( ulExpiries[ uxTimer ] > ulExpected + 1 ) )
+			{
+				ulErrors++;
+			}
+		}
+
+		qsort( ullTickCycles, benchTICKS, sizeof( ullTickCycles[ 0 ] ), prvCompareCycles );
+		ullTotal = 0;
+
+		for( ulTick = 0; ulTick < ( benchTICKS * 99 ) / 100; ulTick++ )
+		{
+			ullTotal += ullTickCycles[ ulTick ];
+		}
+
+		printf( "%4lu active timers: mean %lu cycles per tick\n", ( unsigned long ) uxCreated, ( unsigned long ) ( ullTotal / ( ( benchTICKS * 99 ) / 100 ) ) );
+	}
+
+	taskENTER_CRITICAL();
+	{
+		if( ulErrors == 0 )
+		{
+			printf( "PASS\n" );
+		}
+		else
+		{
+			printf( "FAIL: %lu errors\n", ( unsigned long ) ulErrors );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	printf( "Timer wheel %s\n", ( configUSE_TIMER_WHEEL == 1 ) ? "on" : "off" );
+	xTaskCreate( prvBenchmarkTask, "Bench", benchSTACK_SIZE, NULL, configMAX_PRIORITIES - 2, NULL );
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,478 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host side decoder for the ring buffer written by trace_recorder.c.  Build
+ * with any hosted C compiler, for example:
+ *
+ * cc -O2 -o trace_decode trace_decode.c
+ *
+ * then run it on a binary copy of xTraceRecorderBuffer taken from the target:
+ *
+ * trace_decode trace.bin
+ *
+ * For each task the decoder prints:
+ *
+ * + The share of the traced time the task was running, and the number of
+ *   times it was switched in.
+ * + The wake latency - the time from the task being made ready to run to it
+ *   running.  Wakes caused by interrupts are also reported separately.
+ * + The time the task spent blocked on queues, semaphores and mutexes before
+ *   being made ready again.
+ * + The number of times the task inherited a priority.  A task with a high wake
+ *   latency whose mutex holder frequently inherits its priority is a good
+ *   candidate for a priority inversion.
+ *
+ * The buffer is read as little endian, and is not dependent on the host having
+ * the same structure packing as the target.
+ *
+ * Timestamps must never go backwards.  The decoder stops with an error if a
+ * timestamp is less than half the counter's range before the one before it.
+ * Larger steps back cannot be told apart from the 32-bit counter wrapping, so
+ * the number of wraps is reported instead, and should be checked against the
+ * traced time and the counter frequency.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/* Must match trace_recorder.h. */
+#define trcBUFFER_MAGIC					0x52545246UL
+#define trcBUFFER_VERSION				1U
+#define trcTASK_NAME_LENGTH				12U
+#define trcHEADER_SIZE					24U
+#define trcTASK_SIZE					( 4U + trcTASK_NAME_LENGTH )
+
+#define trcEVENT_TASK_CREATE			1U
+#define trcEVENT_TASK_DELETE			2U
+#define trcEVENT_TASK_SWITCHED_IN		3U
+#define trcEVENT_TASK_READY				4U
+#define trcEVENT_QUEUE_BLOCK			5U
+#define trcEVENT_PRIORITY_INHERIT		6U
+#define trcEVENT_PRIORITY_DISINHERIT	7U
+
+#define trcFLAG_FROM_ISR				1U
+
+/* A growable list of durations. */
+typedef struct Samples
+{
+	uint32_t *pulValues;
+	size_t xCount;
+	size_t xCapacity;
+} Samples_t;
+
+/* Everything known about one task. */
+typedef struct TaskStats
+{
+	uint32_t ulTaskNumber;
+	uint32_t ulPriority;
+	char cName[ trcTASK_NAME_LENGTH + 1 ];
+	uint64_t ullRunTime;
+	uint32_t ulSwitches;
+	uint32_t ulInherits;
+	int iReadyPending;
+	int iReadyFromISR;
+	uint32_t ulReadyTime;
+	int iBlockPending;
+	uint32_t ulBlockTime;
+	Samples_t xWake;
+	Samples_t xISRWake;
+	Samples_t xBlocked;
+} TaskStats_t;
+
+static TaskStats_t *pxTasks = NULL;
+static size_t xNumberOfTasks = 0;
+static double dTimestampHz = 0.0;
+
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRead16( const uint8_t *pucBytes )
+{
+	return ( uint32_t ) pucBytes[ 0 ] | ( ( uint32_t ) pucBytes[ 1 ] << 8 );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRead32( const uint8_t *pucBytes )
+{
+	return prvRead16( pucBytes ) | ( prvRead16( &( pucBytes[ 2 ] ) ) << 16 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddSample( Samples_t *pxSamples, uint32_t ulValue )
+{
+	if( pxSamples->xCount == pxSamples->xCapacity )
+	{
+		pxSamples->xCapacity = ( pxSamples->xCapacity == 0 ) ? 64 : pxSamples->xCapacity * 2;
+		pxSamples->pulValues = realloc( pxSamples->pulValues, pxSamples->xCapacity * sizeof( uint32_t ) );
+
+		if( pxSamples->pulValues == NULL )
+		{
+			fprintf( stderr, "out of memory\n" );
+			exit( EXIT_FAILURE );
+		}
+	}
+
+	pxSamples->pulValues[ pxSamples->xCount ] = ulValue;
+	pxSamples->xCount++;
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompare( const void *pv1, const void *pv2 )
+{
+uint32_t ul1 = *( const uint32_t * ) pv1, ul2 = *( const uint32_t * ) pv2;
+
+	return ( ul1 > ul2 ) - ( ul1 < ul2 );
+}
+/*-----------------------------------------------------------*/
+
+static TaskStats_t *prvGetTask( uint32_t ulTaskNumber )
+{
+size_t x;
+
+	for( x = 0; x < xNumberOfTasks; x++ )
+	{
+		if( pxTasks[ x ].ulTaskNumber == ulTaskNumber )
+		{
+			return &( pxTasks[ x ] );
+		}
+	}
+
+	pxTasks = realloc( pxTasks, ( xNumberOfTasks + 1 ) * sizeof( TaskStats_t ) );
+
+	if( pxTasks == NULL )
+	{
+		fprintf( stderr, "out of memory\n" );
+		exit( EXIT_FAILURE );
+	}
+
+	memset( &( pxTasks[ xNumberOfTasks ] ), 0, sizeof( TaskStats_t ) );
+	pxTasks[ xNumberOfTasks ].ulTaskNumber = ulTaskNumber;
+	snprintf( pxTasks[ xNumberOfTasks ].cName, sizeof( pxTasks[ xNumberOfTasks ].cName ), "#%lu", ( unsigned long ) ulTaskNumber );
+	xNumberOfTasks++;
+
+	return &( pxTasks[ xNumberOfTasks - 1 ] );
+}
+/*-----------------------------------------------------------*/
+
+/* Prints a duration, in microseconds if the timestamp frequency is known,
+otherwise in timestamp counts. */
+static void prvPrintDuration( uint64_t ullCounts )
+{
+	if( dTimestampHz > 0.0 )
+	{
+		printf( " %10.1f", ( double ) ullCounts * 1000000.0 / dTimestampHz );
+	}
+	else
+	{
+		printf( " %10llu", ( unsigned long long ) ullCounts );
+	}
+}
+/*-----------------------------------------------------------*/
+
+/* Prints the count, then the 50th, 90th and 99th percentiles and the maximum
+of a set of samples. */
+static void prvPrintPercentiles( Samples_t *pxSamples )
+{
+static const unsigned uPercentiles[] = { 50, 90, 99, 100 };
+size_t x, xRank;
+
+	printf( " %7lu", ( unsigned long ) pxSamples->xCount );
+
+	if( pxSamples->xCount == 0 )
+	{
+		printf( " %10s %10s %10s %10s", "-", "-", "-", "-" );
+		return;
+	}
+
+	qsort( pxSamples->pulValues, pxSamples->xCount, sizeof( uint32_t ), prvCompare );
+
+	for( x = 0; x < sizeof( uPercentiles ) / sizeof( uPercentiles[ 0 ] ); x++ )
+	{
+		/* Nearest rank. */
+		xRank = ( ( pxSamples->xCount * uPercentiles[ x ] ) + 99 ) / 100;
+		prvPrintDuration( pxSamples->pulValues[ ( xRank == 0 ) ? 0 : xRank - 1 ] );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintHeading( const char *pcTitle )
+{
+	printf( "\n%s (%s)\n", pcTitle, ( dTimestampHz > 0.0 ) ? "us" : "counts" );
+	printf( "%-12s %7s %10s %10s %10s %10s\n", "task", "count", "p50", "p90", "p99", "max" );
+}
+/*-----------------------------------------------------------*/
+
+int main( int argc, char *argv[] )
+{
+FILE *pxFile;
+uint8_t *pucBuffer;
+long lLength;
+uint32_t ulEventSize, ulEventCapacity, ulTaskCapacity, ulEventsWritten, ulFirst, ulCount, x;
+uint32_t ulTimestamp, ulFirstTimestamp = 0, ulLastTimestamp = 0, ulLastSwitch = 0, ulWraps = 0;
+uint64_t ullTotalTime;
+const uint8_t *pucEvent, *pucTask;
+TaskStats_t *pxTask, *pxRunning = NULL;
+size_t xTask;
+
+	if( argc != 2 )
+	{
+		fprintf( stderr, "usage: %s trace.bin\n", argv[ 0 ] );
+		return EXIT_FAILURE;
+	}
+
+	pxFile = fopen( argv[ 1 ], "rb" );
+
+	if( pxFile == NULL )
+	{
+		perror( argv[ 1 ] );
+		return EXIT_FAILURE;
+	}
+
+	fseek( pxFile, 0, SEEK_END );
+	lLength = ftell( pxFile );
+	fseek( pxFile, 0, SEEK_SET );
+
+	pucBuffer = malloc( ( lLength > 0 ) ? ( size_t ) lLength : 1U );
+
+	if( ( pucBuffer == NULL ) || ( lLength < ( long ) trcHEADER_SIZE ) || ( fread( pucBuffer, 1, ( size_t ) lLength, pxFile ) != ( size_t ) lLength ) )
+	{
+		fprintf( stderr, "%s: could not read the trace buffer\n", argv[ 1 ] );
+		return EXIT_FAILURE;
+	}
+
+	fclose( pxFile );
+
+	if( ( prvRead32( pucBuffer ) != trcBUFFER_MAGIC ) || ( prvRead16( &( pucBuffer[ 4 ] ) ) != trcBUFFER_VERSION ) )
+	{
+		fprintf( stderr, "%s: not a trace buffer, or no events have been recorded\n", argv[ 1 ] );
+		return EXIT_FAILURE;
+	}
+
+	ulEventSize = prvRead16( &( pucBuffer[ 6 ] ) );
+	ulEventCapacity = prvRead32( &( pucBuffer[ 8 ] ) );
+	ulTaskCapacity = prvRead32( &( pucBuffer[ 12 ] ) );
+	dTimestampHz = ( double ) prvRead32( &( pucBuffer[ 16 ] ) );
+	ulEventsWritten = prvRead32( &( pucBuffer[ 20 ] ) );
+
+	if( ( ulEventSize < 16U ) || ( ( uint64_t ) lLength < trcHEADER_SIZE + ( ( uint64_t ) ulTaskCapacity * trcTASK_SIZE ) + ( ( uint64_t ) ulEventCapacity * ulEventSize ) ) )
+	{
+		fprintf( stderr, "%s: trace buffer is truncated\n", argv[ 1 ] );
+		return EXIT_FAILURE;
+	}
+
+	/* Pick up the names and priorities of the tasks first, as the create
+	events may have been overwritten. */
+	for( x = 0; x < ulTaskCapacity; x++ )
+	{
+		pucTask = &( pucBuffer[ trcHEADER_SIZE + ( x * trcTASK_SIZE ) ] );
+
+		if( prvRead16( pucTask ) != 0U )
+		{
+			pxTask = prvGetTask( prvRead16( pucTask ) );
+			pxTask->ulPriority = prvRead16( &( pucTask[ 2 ] ) );
+			memcpy( pxTask->cName, &( pucTask[ 4 ] ), trcTASK_NAME_LENGTH );
+			pxTask->cName[ trcTASK_NAME_LENGTH ] = '\0';
+		}
+	}
+
+	/* If the buffer has wrapped the oldest event is the one that would be
+	overwritten next. */
+	if( ulEventsWritten > ulEventCapacity )
+	{
+		ulFirst = ulEventsWritten % ulEventCapacity;
+		ulCount = ulEventCapacity;
+	}
+	else
+	{
+		ulFirst = 0;
+		ulCount = ulEventsWritten;
+	}
+
+	for( x = 0; x < ulCount; x++ )
+	{
+		pucEvent = &( pucBuffer[ trcHEADER_SIZE + ( ulTaskCapacity * trcTASK_SIZE ) + ( ( ( ulFirst + x ) % ulEventCapacity ) * ulEventSize ) ] );
+		ulTimestamp = prvRead32( pucEvent );
+		pxTask = prvGetTask( prvRead16( &( pucEvent[ 6 ] ) ) );
+
+		if( x == 0 )
+		{
+			ulFirstTimestamp = ulTimestamp;
+		}
+		else if( ( uint32_t ) ( ulTimestamp - ulLastTimestamp ) >= 0x80000000UL )
+		{
+			/* Taken as a wrap, the counter would have moved on by more than
+			half its range between two events, so the timestamp went
+			backwards, and every duration that spans it would be wrong. */
+			fprintf( stderr, "%s: timestamp of event %lu is %lu counts before that of the event before it, configTRACE_RECORDER_TIMESTAMP() must not go backwards\n",
+					 argv[ 1 ], ( unsigned long ) x, ( unsigned long ) ( ulLastTimestamp - ulTimestamp ) );
+			return EXIT_FAILURE;
+		}
+		else if( ulTimestamp < ulLastTimestamp )
+		{
+			ulWraps++;
+		}
+		else
+		{
+			/* Timestamps are in order. */
+		}
+
+		ulLastTimestamp = ulTimestamp;
+
+		/* Timestamps are subtracted as unsigned 32-bit values so the
+		durations are correct even if the counter wraps. */
+		switch( pucEvent[ 4 ] )
+		{
+			case trcEVENT_TASK_SWITCHED_IN :
+				if( pxRunning != NULL )
+				{
+					pxRunning->ullRunTime += ( uint32_t ) ( ulTimestamp - ulLastSwitch );
+				}
+
+				if( pxTask->iReadyPending != 0 )
+				{
+					prvAddSample( &( pxTask->xWake ), ulTimestamp - pxTask->ulReadyTime );
+
+					if( pxTask->iReadyFromISR != 0 )
+					{
+						prvAddSample( &( pxTask->xISRWake ), ulTimestamp - pxTask->ulReadyTime );
+					}
+
+					pxTask->iReadyPending = 0;
+				}
+
+				pxTask->ulSwitches++;
+				pxRunning = pxTask;
+				ulLastSwitch = ulTimestamp;
+				break;
+
+			case trcEVENT_TASK_READY :
+				/* Only the first time a task that is not running is made
+				ready counts, as a task can be moved between ready lists
+				while it is waiting to run, for example by priority
+				inheritance. */
+				if( ( pxTask != pxRunning ) && ( pxTask->iReadyPending == 0 ) )
+				{
+					pxTask->iReadyPending = 1;
+					pxTask->iReadyFromISR = ( ( pucEvent[ 5 ] & trcFLAG_FROM_ISR ) != 0 );
+					pxTask->ulReadyTime = ulTimestamp;
+				}
+
+				if( pxTask->iBlockPending != 0 )
+				{
+					prvAddSample( &( pxTask->xBlocked ), ulTimestamp - pxTask->ulBlockTime );
+					pxTask->iBlockPending = 0;
+				}
+				break;
+
+			case trcEVENT_QUEUE_BLOCK :
+				pxTask->iBlockPending = 1;
+				pxTask->ulBlockTime = ulTimestamp;
+				break;
+
+			case trcEVENT_PRIORITY_INHERIT :
+				pxTask->ulInherits++;
+				break;
+
+			case trcEVENT_TASK_CREATE :
+				pxTask->ulPriority = prvRead32( &( pucEvent[ 8 ] ) );
+				break;
+
+			case trcEVENT_TASK_DELETE :
+				pxTask->iReadyPending = 0;
+				pxTask->iBlockPending = 0;
+				break;
+
+			default :
+				/* Not used by the decoder. */
+				break;
+		}
+	}
+
+	if( pxRunning != NULL )
+	{
+		pxRunning->ullRunTime += ( uint32_t ) ( ulLastTimestamp - ulLastSwitch );
+	}
+
+	ullTotalTime = ( uint32_t ) ( ulLastTimestamp - ulFirstTimestamp );
+
+	printf( "%lu events", ( unsigned long ) ulCount );
+	if( ulEventsWritten > ulEventCapacity )
+	{
+		printf( " (%lu older events overwritten)", ( unsigned long ) ( ulEventsWritten - ulEventCapacity ) );
+	}
+	printf( ", traced time" );
+	prvPrintDuration( ullTotalTime );
+	printf( " %s", ( dTimestampHz > 0.0 ) ? "us" : "counts" );
+	if( ulWraps != 0U )
+	{
+		printf( ", timestamp counter wrapped %lu times", ( unsigned long ) ulWraps );
+
+		/* A counter that is reset looks the same as one that wraps. */
+		fprintf( stderr, "%s: the timestamp counter wrapped %lu times in the trace, if that is more than expected for the traced time then configTRACE_RECORDER_TIMESTAMP() went backwards\n",
+				 argv[ 1 ], ( unsigned long ) ulWraps );
+	}
+	printf( "\n" );
+
+	printf( "\n%-12s %5s %7s %10s %10s\n", "task", "prio", "cpu%", "switches", "inherits" );
+	for( xTask = 0; xTask < xNumberOfTasks; xTask++ )
+	{
+		pxTask = &( pxTasks[ xTask ] );
+		printf( "%-12s %5lu %7.2f %10lu %10lu\n", pxTask->cName, ( unsigned long ) pxTask->ulPriority,
+				( ullTotalTime != 0 ) ? ( ( double ) pxTask->ullRunTime * 100.0 ) / ( double ) ullTotalTime : 0.0,
+				( unsigned long ) pxTask->ulSwitches, ( unsigned long ) pxTask->ulInherits );
+	}
+
+	prvPrintHeading( "Wake latency, ready to running" );
+	for( xTask = 0; xTask < xNumberOfTasks; xTask++ )
+	{
+		printf( "%-12s", pxTasks[ xTask ].cName );
+		prvPrintPercentiles( &( pxTasks[ xTask ].xWake ) );
+		printf( "\n" );
+	}
+
+	prvPrintHeading( "Wake latency, made ready from an interrupt" );
+	for( xTask = 0; xTask < xNumberOfTasks; xTask++ )
+	{
+		printf( "%-12s", pxTasks[ xTask ].cName );
+		prvPrintPercentiles( &( pxTasks[ xTask ].xISRWake ) );
+		printf( "\n" );
+	}
+
+	prvPrintHeading( "Time blocked on queues, semaphores and mutexes" );
+	for( xTask = 0; xTask < xNumberOfTasks; xTask++ )
+	{
+		printf( "%-12s", pxTasks[ xTask ].cName );
+		prvPrintPercentiles( &( pxTasks[ xTask ].xBlocked ) );
+		printf( "\n" );
+	}
+
+	free( pucBuffer );
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,181 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+/* This entire source file will be skipped if the application is not configured
+to include the trace recorder.  This #if is closed at the very bottom of this
+file. */
+#if( configUSE_TRACE_RECORDER == 1 )
+
+/* The ring buffer.  Its header is initialised by the first event written,
+rather than statically, so the buffer does not take up space in the
+initialised data section. */
+TraceRecorderBuffer_t xTraceRecorderBuffer;
+
+/* The task number of the task that was most recently switched in. */
+static UBaseType_t uxTraceCurrentTaskNumber = 0;
+
+/*
+ * Writes an event.  Must be called with interrupts masked.
+ */
+static void prvWriteEvent( uint8_t ucEventType, UBaseType_t uxTaskNumber, uint32_t ulParameter1, uint32_t ulParameter2 );
+
+/*-----------------------------------------------------------*/
+
+void vTraceRecorderReset( void )
+{
+UBaseType_t uxSavedInterruptStatus;
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		xTraceRecorderBuffer.ulEventsWritten = 0;
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+void vTraceRecorderEvent( uint8_t ucEventType, UBaseType_t uxTaskNumber, uint32_t ulParameter1, uint32_t ulParameter2 )
+{
+UBaseType_t uxSavedInterruptStatus;
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		prvWriteEvent( ucEventType, uxTaskNumber, ulParameter1, ulParameter2 );
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+void vTraceRecorderTaskCreate( UBaseType_t uxTaskNumber, UBaseType_t uxPriority, const char *pcName )
+{
+TraceRecorderTask_t *pxTask;
+UBaseType_t uxSavedInterruptStatus, x;
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		pxTask = &( xTraceRecorderBuffer.xTasks[ uxTaskNumber % ( UBaseType_t ) configTRACE_RECORDER_MAX_TASKS ] );
+		pxTask->usTaskNumber = ( uint16_t ) uxTaskNumber;
+		pxTask->usPriority = ( uint16_t ) uxPriority;
+
+		/* Copy as much of the name as fits.  The name is only NULL terminated
+		if it is shorter than the space available. */
+		for( x = ( UBaseType_t ) 0; x < ( UBaseType_t ) trcTASK_NAME_LENGTH; x++ )
+		{
+			pxTask->cName[ x ] = pcName[ x ];
+
+			if( pcName[ x ] == ( char ) 0x00 )
+			{
+				break;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		prvWriteEvent( trcEVENT_TASK_CREATE, uxTaskNumber, ( uint32_t ) uxPriority, 0UL );
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+void vTraceRecorderTaskSwitchedIn( UBaseType_t uxTaskNumber )
+{
+UBaseType_t uxSavedInterruptStatus;
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		uxTraceCurrentTaskNumber = uxTaskNumber;
+		prvWriteEvent( trcEVENT_TASK_SWITCHED_IN, uxTaskNumber, 0UL, 0UL );
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+void vTraceRecorderQueueBlock( const void *pvQueue, uint32_t ulOperation )
+{
+UBaseType_t uxSavedInterruptStatus;
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		/* Only tasks block, so the event relates to the running task. */
+		prvWriteEvent( trcEVENT_QUEUE_BLOCK, uxTraceCurrentTaskNumber, ( uint32_t ) ( portPOINTER_SIZE_TYPE ) pvQueue, ulOperation );
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteEvent( uint8_t ucEventType, UBaseType_t uxTaskNumber, uint32_t ulParameter1, uint32_t ulParameter2 )
+{
+TraceRecorderEvent_t *pxEvent;
+uint32_t ulEventsWritten;
+
+	if( xTraceRecorderBuffer.ulMagic != trcBUFFER_MAGIC )
+	{
+		/* First event, so fill in the header the decoder uses to interpret
+		the rest of the buffer. */
+		xTraceRecorderBuffer.usVersion = trcBUFFER_VERSION;
+		xTraceRecorderBuffer.usEventSize = ( uint16_t ) sizeof( TraceRecorderEvent_t );
+		xTraceRecorderBuffer.ulEventCapacity = ( uint32_t ) configTRACE_RECORDER_BUFFER_EVENTS;
+		xTraceRecorderBuffer.ulTaskCapacity = ( uint32_t ) configTRACE_RECORDER_MAX_TASKS;
+		xTraceRecorderBuffer.ulTimestampHz = ( uint32_t ) configTRACE_RECORDER_TIMESTAMP_HZ;
+		xTraceRecorderBuffer.ulMagic = trcBUFFER_MAGIC;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	/* The buffer size is a power of 2, so the oldest event is overwritten
+	once the buffer is full. */
+	ulEventsWritten = xTraceRecorderBuffer.ulEventsWritten;
+	pxEvent = &( xTraceRecorderBuffer.xEvents[ ulEventsWritten & ( ( uint32_t ) configTRACE_RECORDER_BUFFER_EVENTS - 1UL ) ] );
+
+	pxEvent->ulTimestamp = ( uint32_t ) configTRACE_RECORDER_TIMESTAMP();
+	pxEvent->ucEventType = ucEventType;
+	pxEvent->usTaskNumber = ( uint16_t ) uxTaskNumber;
+	pxEvent->ulParameter1 = ulParameter1;
+	pxEvent->ulParameter2 = ulParameter2;
+
+	if( configTRACE_RECORDER_IS_INSIDE_INTERRUPT() != pdFALSE )
+	{
+		pxEvent->ucFlags = trcFLAG_FROM_ISR;
+	}
+	else
+	{
+		pxEvent->ucFlags = 0;
+	}
+
+	xTraceRecorderBuffer.ulEventsWritten = ulEventsWritten + 1UL;
+}
+
+/* This entire source file will be skipped if the application is not configured
+to include the trace recorder.  This #if is closed at the very bottom of this
+file. */
+#endif /* configUSE_TRACE_RECORDER == 1 */